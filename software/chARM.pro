@@ -48,8 +48,15 @@ SOURCES += $$PWD/main.cpp \
            $$PWD/dialog_exp.cpp \
            $$PWD/charmwidget.cpp \
            $$PWD/expwidget.cpp \
+           $$PWD/expfsm.cpp \
+           $$PWD/expscene.cpp \
+           $$PWD/stairtracker.cpp \
            $$PWD/motorcontrol.cpp \
            $$PWD/exo.cpp \
+           $$PWD/exoreadout.cpp \
+           $$PWD/exodevice.cpp \
+           $$PWD/exoscheduler.cpp \
+           $$PWD/ffwdtable.cpp \
            $$PWD/subject.cpp
 
 HEADERS += $$PWD/mainwindow.h \
@@ -59,8 +66,18 @@ HEADERS += $$PWD/mainwindow.h \
            $$PWD/dialog_exp.h \
            $$PWD/charmwidget.h \
            $$PWD/expwidget.h \
+           $$PWD/expfsm.h \
+           $$PWD/expscene.h \
+           $$PWD/expparams.h \
+           $$PWD/stairtracker.h \
            $$PWD/motorcontrol.h \
            $$PWD/exo.h \
+           $$PWD/exoreadout.h \
+           $$PWD/exodevice.h \
+           $$PWD/exoscheduler.h \
+           $$PWD/exomath.h \
+           $$PWD/exochain.h \
+           $$PWD/ffwdtable.h \
            $$PWD/subject.h
 
 FORMS += $$PWD/mainwindow.ui \
@@ -2,11 +2,21 @@
 #include <QDebug>
 
 #define T_GRAPHICS 50        // update every 50 ms (20 Hz)
+#define T_SERVO    0.001     // nominal servo period [sec]
+#define T_VIRTUAL  0.0005    // budget for virtual-world collisions & forces, half of (1 ms) servo period [sec]
+#define R_TOOL     0.01      // radius of hand cursor for virtual-world collisions [m]
+#define K_OBJECT   0.5       // stiffness of virtual objects, as fraction of exo's maximum stiffness
 #define R_JOINT    0.04      // radius of spheres representing joints [m]
 #define R_SEGMENT  0.02      // radius of cylinders representing upper/forearm [m]
 #define H_SEGMENT  0.5       // default height of cylinders representing upper/forearm [m]
 #define ALPH_GHOST 0.2       // alpha value for "ghost" exoskeleton components
 #define FRAMES     0         // 0 = hide joint frames, 1 = show joint frames (for ghost)
+#define SCOPE_SPAN 2.0       // time span of gain-tuning scopes [sec]
+#define T_MAX      12        // maximum motor torque to command, same as 'exo' [N*m]
+#define RATIO_S    16.98     // gear ratio between shoulder motor and capstan, same as 'exo'
+#define RATIO_E    16.59     // gear ratio between elbow motor and capstan, same as 'exo'
+#define SCOPE_ERR  0.1       // joint-angle error range of scopes, +/- [rad]
+#define SCOPE_VEL  1.0       // joint velocity range of scopes, +/- [rad/s]
 #define JNTSPACE   0         // joint-space control
 #define TASKSPACE  1         // task-space control
 #define PI         3.141592
@@ -26,14 +36,23 @@ chARMWidget::chARMWidget(QWidget *parent) :
     // initialize variables for graphic/haptic rendering
     m_timer = new QBasicTimer;
     m_running = false;
+    m_virtual = false;
+    m_toolOn = false;
+    m_object = NULL;
+    m_overruns = 0;
 
     // reset frequency counters
     m_graphicRate.reset();
     m_hapticRate.reset();
 
+    // count servo periods & virtual-world steps exceeding their budgets
+    m_hapticPeriod.setOverrunThreshold(T_SERVO);
+    m_virtualCost.setOverrunThreshold(T_VIRTUAL);
+
     // create new CHAI world
     m_world = new cWorld();
     m_world->m_backgroundColor.setBlack();
+    m_world->setUseRenderQueue(true);        // skip objects outside the view, group draws by render state
 
     // create camera to view world
     // NOTE: In orthographic (non-perspective) mode, 'camera->set()' functions slightly differently.
@@ -117,8 +136,37 @@ chARMWidget::chARMWidget(QWidget *parent) :
     cFont* font = NEW_CFONTCALIBRI40();
     m_OOB = new cLabel(font);
     m_OOB->m_fontColor.setRed();
+    m_camera->m_backLayer->setUseTextBatching(true);  // draw labels from cached vertex buffer
     m_camera->m_backLayer->addChild(m_OOB);
     m_OOB->setText("OUT OF BOUNDS");
+
+    // add scopes of servo-rate joint signals to foreground (torque = red, error = yellow, velocity = cyan)
+    // NOTE: torque range is joint-space saturation, i.e., motor-space T_MAX through gearing
+    const double scopeT[NUM_JNT] = {T_MAX*RATIO_S, T_MAX*RATIO_E};
+    for (int i = 0; i < NUM_JNT; i++) {
+        m_scope[i] = new cSignalScope(3);
+        m_scope[i]->setSize(400, 120);
+        m_scope[i]->setTimeSpan(SCOPE_SPAN);
+        m_scope[i]->setChannelRange(0, -scopeT[i], scopeT[i]);
+        m_scope[i]->setChannelRange(1, -SCOPE_ERR, SCOPE_ERR);
+        m_scope[i]->setChannelRange(2, -SCOPE_VEL, SCOPE_VEL);
+        m_scope[i]->setChannelColor(0, cColorf(1.0f, 0.3f, 0.3f));
+        m_scope[i]->setChannelColor(1, cColorf(1.0f, 1.0f, 0.4f));
+        m_scope[i]->setChannelColor(2, cColorf(0.4f, 1.0f, 1.0f));
+        m_scope[i]->setShowEnabled(false);
+        m_camera->m_frontLayer->addChild(m_scope[i]);
+    }
+
+    // exoskeleton is only drawn, never touched by hand cursor
+    for (unsigned int i = 0; i < m_world->getNumChildren(); i++)
+        m_world->getChild(i)->setHapticEnabled(false);
+
+    // add hand cursor (exo attached as device on start)
+    m_tool = new cToolCursor(m_world);
+    m_tool->setRadius(R_TOOL);
+    m_tool->setWaitForSmallForce(true);  // ramp in forces if hand starts inside an object
+    m_tool->setShowEnabled(false);
+    m_world->addChild(m_tool);
 }
 
 chARMWidget::~chARMWidget()
@@ -132,10 +180,27 @@ bool chARMWidget::start()
     // start graphic rendering at specified frequency
     m_timer->start(T_GRAPHICS, this);
 
-    // connect to exo & start haptic thread running
-    // NOTE: this should be the only haptic thread running
-    if (m_parent->m_exo->connect()) {
+    // attach exo to hand cursor, in exo task space (device & tool workspaces equal, so no scaling)
+    if (m_device == nullptr) {
+        m_device = exoDevice::create(m_parent->m_exo);
+        m_tool->setHapticDevice(m_device);
+        m_tool->setWorkspaceRadius(m_device->getSpecifications().m_workspaceRadius);
+    }
+
+    // connect to exo(s) & start haptic thread running
+    // NOTE: this should be the only haptic thread running; further exos
+    // ----  (e.g. second arm) are served by its scheduler, not extra threads
+    if (m_sched.numExos() == 0) m_sched.add(m_parent->m_exo);
+    if (m_sched.connect()) {
         m_thread.start(_hapticThread, CTHREAD_PRIORITY_HAPTICS, this);
+        m_thread.setName("chARM haptics");
+        if (!m_thread.getPriorityApplied())
+            qDebug() << "haptic thread: real-time priority not granted (check rtprio limits)";
+
+        // run alone on first core isolated from the OS scheduler, if any (e.g. isolcpus=2,3)
+        std::vector<int> cores = cThread::getIsolatedCores();
+        if (!cores.empty() && !m_thread.setAffinity(cores[0]))
+            qDebug() << "haptic thread: could not pin to isolated core" << cores[0];
     } else
         return(C_ERROR);
 
@@ -148,8 +213,10 @@ void chARMWidget::stop()
     m_running = false;
 
     // disable exoskeleton control once haptics thread is done with it
+    // NOTE: scheduler zeroes all motors and closes 826 system once for all exos
     m_runLock.acquire();
-    m_parent->m_exo->setCtrl(none);
+    for (int i = 0; i < m_sched.numExos(); i++) m_sched.getExo(i)->setCtrl(none);
+    m_sched.disconnect();
     m_runLock.release();
 
     // stop graphic rendering
@@ -162,29 +229,122 @@ void* chARMWidget::hapticThread()
     m_runLock.acquire();
     m_running = true;
 
+    // keep servo loop free of page faults (fails quietly without memlock permission;
+    // pages mapped later, e.g. by the GUI, are only locked if memlock is unlimited)
+    if (!cThread::lockMemory() && DEBUG)  qDebug() << "haptic thread: memory not locked";
+    cThread::prefaultStack();
+    cPrecisionClock clk;
+    clk.start();
+
     while (m_running)
     {
-        // update exoskeleton configuration
-        m_parent->m_exo->getState();
-        drawExo();
-
-        // command exoskeleton via designated control paradigm
-        bool inWorkspace = m_parent->m_exo->sendCommand();
-        if (!inWorkspace) {
-            m_OOB->setLocalPos(10,(int)(m_height-m_OOB->getHeight()),0);
-            m_OOB->setShowEnabled(true);
-        } else
-            m_OOB->setShowEnabled(false);
+        // update exoskeleton configuration(s), reading all encoders at once
+        m_sched.read();
+        m_sched.update();
+
+        // only touch world while GUI is not rendering it (never block servo loop)
+        bool worldFree = m_worldLock.tryAcquire();
+        if (worldFree) {
+            drawExo();
+
+            // start/stop hand cursor from this thread, so tool is only touched at servo rate
+            if (m_virtual && !m_toolOn) {
+                m_toolOn = m_tool->start();
+                m_tool->setShowEnabled(m_toolOn);
+            } else if (!m_virtual && m_toolOn) {
+                m_tool->stop();
+                m_tool->setShowEnabled(false);
+                m_toolOn = false;
+            }
+        }
+
+        // render forces of virtual world at hand (applied by 'sendCommand' below)
+        // NOTE: while world is being rendered, last force is held
+        if (m_toolOn) {
+            if (worldFree) {
+                double t0 = clk.getCurrentTimeSeconds();
+                m_tool->updateFromDevice();
+                m_tool->computeInteractionForces();
+                double dt = clk.getCurrentTimeSeconds() - t0;
+                m_virtualCost.recordSeconds(dt);
+                if (dt > T_VIRTUAL) {
+                    m_overruns++;
+                    if (DEBUG)  qDebug() << "virtual world over budget:" << dt*1000 << "ms";
+                }
+            }
+            m_tool->applyToDevice();
+        }
+
+        // command exoskeleton(s) via designated control paradigm, writing all motors at once
+        bool inWorkspace = m_sched.command();
+        m_sched.write();
+        if (worldFree) {
+            if (!inWorkspace) {
+                m_OOB->setLocalPos(10,(int)(m_height-m_OOB->getHeight()),0);
+                m_OOB->setShowEnabled(true);
+            } else
+                m_OOB->setShowEnabled(false);
+            m_worldLock.release();
+        }
+
+        // hand state of this servo step to GUI (never blocks)
+        exo_sample sample;
+        m_parent->m_exo->getSample(sample);
+        m_readout.push(sample);
+        for (int i = 0; i < NUM_JNT; i++) {
+            double signals[3] = {sample.d_T[i], sample.d_thErr[i], sample.d_thdot[i]};
+            m_scope[i]->addSample(sample.d_time, signals);
+        }
 
         // update haptics counter
         m_hapticRate.signal(1);
+        m_hapticPeriod.recordPeriod();
     }
 
+    // leave exo transparent if hand cursor still active
+    m_worldLock.acquire();
+    if (m_toolOn) {
+        m_tool->stop();
+        m_tool->setShowEnabled(false);
+        m_toolOn = false;
+    }
+    m_worldLock.release();
+
     m_running = false;
     m_runLock.release();
     return(NULL);
 }
 
+bool chARMWidget::loadVirtualObject(std::string a_filename)
+{
+    // only swap objects while hand cursor is stopped (no contacts left pointing into old object)
+    if (m_virtual || m_device == nullptr) return(C_ERROR);
+
+    // load & build collision tree before touching world (may take a while for large models)
+    // NOTE: model coordinates are taken as exo task space [m], hand moving in plane z = 0
+    cMultiMesh* object = new cMultiMesh();
+    if (!object->loadFromFile(a_filename)) {
+        delete object;
+        return(C_ERROR);
+    }
+    object->createAABBCollisionDetector(R_TOOL);
+    object->setStiffness(K_OBJECT*m_device->getSpecifications().m_maxLinearStiffness, true);
+    object->setUseDisplayList(true);
+
+    m_worldLock.acquire();
+    if (m_toolOn) {
+        m_worldLock.release();
+        delete object;
+        return(C_ERROR);
+    }
+    if (m_object != NULL) m_world->deleteChild(m_object);
+    m_object = object;
+    m_world->addChild(m_object);
+    m_worldLock.release();
+
+    return(C_SUCCESS);
+}
+
 void chARMWidget::initializeGL()
 {
 #ifdef GLEW_VERSION
@@ -201,6 +361,14 @@ void chARMWidget::paintGL()
 
     m_worldLock.acquire();
 
+    // show joint scopes (shoulder on top) while tuning gains
+    bool tuning = (m_parent->m_tuner != NULL) && m_parent->m_tuner->isVisible();
+    for (int i = 0; i < NUM_JNT; i++) {
+        m_scope[i]->setLocalPos(10, 10 + (NUM_JNT-1-i)*(m_scope[i]->getHeight()+10), 0);
+        m_scope[i]->setShowEnabled(tuning);
+        if (!tuning) m_scope[i]->updateSamples();  // keep draining so scope is current when shown
+    }
+
     // render world
     m_camera->renderView(m_width, m_height);
     glFinish();
@@ -306,6 +474,12 @@ void chARMWidget::resizeGL(int a_width, int a_height)
 
 void chARMWidget::mousePressEvent(QMouseEvent *event)
 {
+    // right click freezes/resumes joint scopes, if shown
+    if ((event->button() == Qt::RightButton) && m_scope[0]->getShowEnabled()) {
+        for (int i = 0; i < NUM_JNT; i++) m_scope[i]->setFrozen(!m_scope[i]->getFrozen());
+        return;
+    }
+
     if (m_parent->m_demo) {
 
         m_parent->m_exo->m_ctrlLock.acquire();
@@ -4,7 +4,11 @@
 #include "chai3d.h"
 #include "mainwindow.h"
 #include "expwidget.h"
+#include "exodevice.h"
+#include "exoscheduler.h"
 #include <cmath>
+#include <atomic>
+#include <string>
 #include <QBasicTimer>
 #include <QMouseEvent>
 
@@ -20,6 +24,10 @@ public:
     chai3d::cMutex m_runLock;                 // mutex for haptics updates
     chai3d::cFrequencyCounter m_graphicRate;  // counter for graphics updates
     chai3d::cFrequencyCounter m_hapticRate;   // counter for haptics updates
+    chai3d::cLatencyHistogram m_hapticPeriod; // servo period distribution (jitter & tail latency)
+    chai3d::cLatencyHistogram m_virtualCost;  // time spent rendering forces of virtual world per servo step
+    exoReadout m_readout;                     // servo-rate samples for GUI readouts & demo recording
+    exoScheduler m_sched;                     // servo cycle for all exos (main window's exo first, others added before 'start')
 
     chai3d::cWorld* m_world;                  // CHAI world
     chai3d::cCamera* m_camera;                // camera to render the world
@@ -40,9 +48,16 @@ public:
     chai3d::cShapeCylinder* m_upperarmT;      // "ghost" cylinder representing target configuration of upperarm
     chai3d::cShapeCylinder* m_forearmT;       // "ghost" cylinder representing target configuration of forearm
     chai3d::cLabel* m_OOB;                    // warning to display when desired position is outside subject's & robot's workspace
+    chai3d::cSignalScope* m_scope[NUM_JNT];   // servo-rate torque, error & velocity of each joint (shown while gain tuner is open)
+    std::shared_ptr<exoDevice> m_device;      // exo as CHAI haptic device
+    chai3d::cToolCursor* m_tool;              // hand cursor interacting with (haptic) objects added to world
+    chai3d::cMultiMesh* m_object;             // virtual object touched by hand cursor (loaded from file, NULL if none)
 
     QBasicTimer* m_timer;                     // timer for graphics updates
     bool m_running;                           // TRUE = haptics thread is running
+    std::atomic<bool> m_virtual;              // TRUE = render forces of virtual world at hand (holds exo in task-space force control)
+    bool m_toolOn;                            // TRUE = hand cursor started by haptics thread (guarded by 'm_worldLock')
+    int m_overruns;                           // servo steps in which virtual-world forces exceeded their time budget
     int m_width;                              // width of view
     int m_height;                             // height of view
     int m_mouseX;                             // cursor X-position
@@ -54,6 +69,8 @@ public:
     bool start();
     void stop();
     void* hapticThread();
+    bool loadVirtualObject(std::string a_filename);
+    void setVirtual(bool a_virtual) { m_virtual = a_virtual; }
 
 protected:
     // map from GUI to CHAI coordinates (scaling + shift)
@@ -37,7 +37,28 @@
 using namespace std;
 using namespace chai3d;
 
-exo::exo(subject *a_subj)
+// conversions between (public) 3-vectors & fixed-size chain vectors
+// NOTE: only kinematics & PID effort are DOF-generic; exo state, gains, controllers
+// ----  and public API are 'cVector3d' sized for the 2-DOF exo, converted here
+static_assert(NUM_ENC <= 3 && TASK_DIM <= 3, "exo state is stored in 'cVector3d'");
+
+template<int N>
+static jntVector<N> toJnt(const cVector3d &a_v)
+{
+    jntVector<N> v;
+    for (int i = 0; i < N; i++) v(i) = a_v(i);
+    return v;
+}
+
+template<int N>
+static cVector3d toVec(const jntVector<N> &a_v)
+{
+    cVector3d v(0.0,0.0,0.0);
+    for (int i = 0; i < N; i++) v(i) = a_v(i);
+    return v;
+}
+
+exo::exo(subject *a_subj, channel_map a_map)
 {
     // exoskeleton available for connection
     m_exoAvailable = true;
@@ -45,8 +66,10 @@ exo::exo(subject *a_subj)
     m_error = false;
     m_errMessage = "";
 
-    // associate exo with provided subject
+    // associate exo with provided subject & 826 channels
     m_subj = a_subj;
+    m_map = a_map;
+    m_scheduled = false;
 
     // initialize kinematic variables
     m_t          = 0;
@@ -61,6 +84,7 @@ exo::exo(subject *a_subj)
     m_thErr      = cVector3d(0.0,0.0,0.0);
     m_thdot      = cVector3d(0.0,0.0,0.0);
     m_thdotDes   = cVector3d(0.0,0.0,0.0);
+    m_thddotDes  = cVector3d(0.0,0.0,0.0);
     m_thdotErr   = cVector3d(0.0,0.0,0.0);
     m_thErrInt   = cVector3d(0.0,0.0,0.0);
     m_pos        = cVector3d(0.0,0.0,0.0);
@@ -71,6 +95,14 @@ exo::exo(subject *a_subj)
     m_velDes     = cVector3d(0.0,0.0,0.0);
     m_velErr     = cVector3d(0.0,0.0,0.0);
     m_posErrInt  = cVector3d(0.0,0.0,0.0);
+    for (int i = 0; i < NUM_ENC; i++) { m_counts[i] = 0;  m_encOk[i] = true; }
+    m_Tmtr       = cVector3d(0.0,0.0,0.0);
+    m_tLast      = 0;
+    m_thLast     = cVector3d(0.0,0.0,0.0);
+    m_thdotLast  = cVector3d(0.0,0.0,0.0);
+    m_thErrIntLast  = cVector3d(0.0,0.0,0.0);
+    m_posErrIntLast = cVector3d(0.0,0.0,0.0);
+    m_stopCount  = 0;
 
     // initialize control variables
     m_mode       = position;
@@ -79,6 +111,7 @@ exo::exo(subject *a_subj)
     m_bumpers    = false;
     m_negDamp    = false;
     m_dither     = false;
+    m_feedforward = false;
     m_activeJnts = {false, false};
     m_lockedJnts = {false, false};
     m_KpJnt      = cVector3d(6.0,3.0,0.0);
@@ -91,37 +124,38 @@ exo::exo(subject *a_subj)
     m_Adith      = cVector3d(0.2,0.2,0.0);
     m_fdith      = cVector3d(100,100,0.0);
     m_T          = cVector3d(0.0,0.0,0.0);
+    m_Tcmd       = cVector3d(0.0,0.0,0.0);
     m_F          = cVector3d(0.0,0.0,0.0);
 }
 
 exo::~exo()
 {
-    // disconnect from S826 and free dynamically allocated memory
-    if (disconnect()) {
-        delete m_clk;
-    }
+    // disconnect (leaving S826 to scheduler, if scheduled) and free dynamically allocated memory
+    disconnect(!m_scheduled);
+    delete m_clk;
 }
 
 
-bool exo::connect()
+bool exo::connect(bool a_openBoard)
 {
     // check if exoskeleton is available/has been opened already
     if (!m_exoAvailable) return(C_ERROR);
     if (m_exoReady)      return(C_ERROR);
 
-    // connect to S826
-    bool success = connectToS826();
+    // connect to S826 (unless already opened for several exos, see 'exoScheduler')
+    bool success = true;
+    if (a_openBoard) success = connectToS826();
     if (!success) return(C_ERROR);
 
     // initialize encoders
     for (int i = 0; i < NUM_ENC; i++) {
-        success = initEncod((uint)i);
+        success = initEncod(m_map, (uint)i);
         if (!success) return(C_ERROR);
     }
 
     // initialize motors
     for (int i = 0; i < NUM_MTR; i++) {
-        success = initMotor((uint)i);
+        success = initMotor(m_map, (uint)i);
         if (!success) return(C_ERROR);
     }
 
@@ -130,14 +164,15 @@ bool exo::connect()
     return(C_SUCCESS);
 }
 
-bool exo::disconnect()
+bool exo::disconnect(bool a_closeBoard)
 {
     // check that exoskeleton is open
     if (!m_exoReady) return(C_ERROR);
 
-    // set motor torques to zero and disconnect from S826
+    // set motor torques to zero (immediately, even if scheduled) and disconnect from S826
     disableCtrl();
-    disconnectFromS826();
+    writeMotors();
+    if (a_closeBoard) disconnectFromS826();
 
     m_clk->stop();
     m_exoReady = false;
@@ -158,7 +193,7 @@ void exo::calibrate()
 
     // save encoder counts at calibration position
     for (int i = 0; i < NUM_ENC; i++) {
-        m_thZero[i] = getCounts((uint)i);
+        m_thZero[i] = getCounts(m_map, (uint)i);
     }
 
     // set linkage limits based on handedness
@@ -166,22 +201,27 @@ void exo::calibrate()
     m_thLinkNom = m_thLinkLim;
 }
 
+void exo::readEncoders()
+{
+    // sample encoder counts (checking for encoder failure), converted in 'getState'
+    for (int i = 0; i < NUM_ENC; i++) {
+        m_encOk[i] = checkEncod(m_map, (uint)i);
+        if (m_encOk[i])  m_counts[i] = getCounts(m_map, (uint)i);
+    }
+}
+
 void exo::getState()
 {
-    // declare "memory" variables for calculations
-    static double tLast = m_t;
-    static cVector3d thLast = m_th;
-    static cVector3d thdotLast = m_thdot;
-    static cVector3d thErrIntLast = m_thErrInt;
-    static cVector3d posErrIntLast = m_posErrInt;
+    // read encoders here, unless batched with other exos
+    if (!m_scheduled) readEncoders();
 
     // update from trajectory (or reset control variables)
     if (!isOutOfBounds(m_thTarg, JNTSPACE) && m_onTraj) {
         updateDesiredState(m_t - m_traj.tInit);
     } else {
         syncStates(false);
-        thErrIntLast = cVector3d(0.0,0.0,0.0);
-        posErrIntLast = cVector3d(0.0,0.0,0.0);
+        m_thErrIntLast = cVector3d(0.0,0.0,0.0);
+        m_posErrIntLast = cVector3d(0.0,0.0,0.0);
     }
 
     // get current joint & task-space positions/errors
@@ -192,14 +232,14 @@ void exo::getState()
 
     // calculate velocities/errors
     m_t = m_clk->getCurrentTimeSeconds();
-    m_thdot = A_FILT*(m_th - thLast)/(m_t - tLast) + (1-A_FILT)*thdotLast;
+    m_thdot = A_FILT*(m_th - m_thLast)/(m_t - m_tLast) + (1-A_FILT)*m_thdotLast;
     m_thdotErr = m_thdotDes - m_thdot;
-    m_vel = Jacobian(m_th)*m_thdot;
+    m_vel = toVec(Jacobian(m_th)*toJnt<NUM_ENC>(m_thdot));
     m_velErr = m_velDes - m_vel;
 
     // integrate position error
-    m_thErrInt = thErrIntLast + m_thErr*(m_t - tLast);
-    m_posErrInt = posErrIntLast + m_posErr*(m_t - tLast);
+    m_thErrInt = m_thErrIntLast + m_thErr*(m_t - m_tLast);
+    m_posErrInt = m_posErrIntLast + m_posErr*(m_t - m_tLast);
 
     // clamp integrated error
     for (int i = 0; i < NUM_ENC; i++) {
@@ -212,11 +252,11 @@ void exo::getState()
     }
 
     // save last values
-    tLast = m_t;
-    thLast = m_th;
-    thdotLast = m_thdot;
-    thErrIntLast = m_thErrInt;
-    posErrIntLast = m_posErrInt;
+    m_tLast = m_t;
+    m_thLast = m_th;
+    m_thdotLast = m_thdot;
+    m_thErrIntLast = m_thErrInt;
+    m_posErrIntLast = m_posErrInt;
 }
 
 bool exo::sendCommand()
@@ -257,11 +297,29 @@ bool exo::sendCommand()
     }
 }
 
-bool exo::reachedTarg()
+void exo::getSample(exo_sample &a_sample)
 {
-    // create variable to track velocity
-    static int count = 0;
+    // copy state of current servo step (after 'getState' & 'sendCommand')
+    a_sample.d_time = m_t;
+    for (int i = 0; i < NUM_JNT; i++) {
+        a_sample.d_th[i] = m_th(i);
+        a_sample.d_thdot[i] = m_thdot(i);
+        a_sample.d_pos[i] = m_pos(i);
+        a_sample.d_vel[i] = m_vel(i);
+        a_sample.d_thErr[i] = m_thErr(i);
+        a_sample.d_thdotErr[i] = m_thdotErr(i);
+        a_sample.d_thErrInt[i] = m_thErrInt(i);
+        a_sample.d_posErr[i] = m_posErr(i);
+        a_sample.d_velErr[i] = m_velErr(i);
+        a_sample.d_posErrInt[i] = m_posErrInt(i);
+        a_sample.d_T[i] = m_T(i);
+        a_sample.d_Tcmd[i] = m_Tcmd(i);
+        a_sample.d_F[i] = m_F(i);
+    }
+}
 
+bool exo::reachedTarg()
+{
     // if controlling in task space or both joints in joint space
     if (m_ctrl == task || m_ctrl == joint) {
 
@@ -279,21 +337,21 @@ bool exo::reachedTarg()
         }
 
         // check that exo has reached desired configuration & is stopped
-        if (posErr.length() <= thresh) {      // at target position
-            if (velErr.length() <= thresh) {  // stopped currently
-                count++;
-                if (count > CNT_TO_STOP) {    // been stopped long enough
-                    count = 0;
+        if (posErr.length() <= thresh) {          // at target position
+            if (velErr.length() <= thresh) {      // stopped currently
+                m_stopCount++;
+                if (m_stopCount > CNT_TO_STOP) {  // been stopped long enough
+                    m_stopCount = 0;
                     return true;
-                } else {                      // not yet stopped long enough
+                } else {                          // not yet stopped long enough
                     return false;
                 }
-            } else {                          // not stopped currently
-                count = 0;
+            } else {                              // not stopped currently
+                m_stopCount = 0;
                 return false;
             }
-        } else {                              // not at position
-            count = 0;
+        } else {                                  // not at position
+            m_stopCount = 0;
             return false;
         }
     }
@@ -314,19 +372,19 @@ bool exo::reachedTarg()
         // check that joint has reached desired angle & is stopped
         if (fabs(currAng - desAng) <= THRESH_JNT*(PI/180)) {
             if (m_thdot.length() <= THRESH_JNT*(PI/180)) {
-                count++;
-                if (count > CNT_TO_STOP) {
-                    count = 0;
+                m_stopCount++;
+                if (m_stopCount > CNT_TO_STOP) {
+                    m_stopCount = 0;
                     return true;
                 } else {
                     return false;
                 }
             } else {
-                count = 0;
+                m_stopCount = 0;
                 return false;
             }
         } else {
-            count = 0;
+            m_stopCount = 0;
             return false;
         }
     }
@@ -394,15 +452,40 @@ void exo::setForce(chai3d::cVector3d a_force, ctrl_states a_ctrl)
     setCtrl(a_ctrl);
 
     // update desired "force"
-    cMatrix3d J = Jacobian(m_th);
-    J.trans();
+    jntVector<NUM_ENC> th = toJnt<NUM_ENC>(m_th);
     if (a_ctrl == task) {
         m_F = a_force;
-        m_T = J*m_F;
+        m_T = toVec(chain().forceToTorque(th, toJnt<TASK_DIM>(m_F)));
     } else {
         m_T = a_force;
-        if (J.invert()) m_F = J*m_T;
+        jntVector<TASK_DIM> F;
+        if (chain().torqueToForce(th, toJnt<NUM_ENC>(m_T), F)) m_F = toVec(F);
+    }
+}
+
+void exo::follow(chai3d::cVector3d a_targ, chai3d::cVector3d a_vel, ctrl_states a_ctrl)
+{
+    // update control paradigm for position control
+    setMode(position);
+    setCtrl(a_ctrl);
+
+    // target is reached immediately (zero-length trajectory) and
+    // moving with given velocity, e.g. to track another exo every servo cycle
+    moveTraj traj;
+    traj.posInit = a_targ;
+    traj.tInit = m_t;
+    traj.velFinal = a_vel;
+    if (a_ctrl == task) {
+        m_posTarg = a_targ;
+        m_thTarg = inverseKin(a_targ);
+    } else {
+        m_thTarg = a_targ;
+        m_posTarg = forwardKin(a_targ);
     }
+    m_traj = traj;
+
+    // send onto trajectory
+    m_onTraj = true;
 }
 
 void exo::syncStates(bool resetTarg)
@@ -411,6 +494,7 @@ void exo::syncStates(bool resetTarg)
     m_thDes = m_th;
     m_posDes = m_pos;
     m_thdotDes = cVector3d(0.0,0.0,0.0);
+    m_thddotDes = cVector3d(0.0,0.0,0.0);
     m_velDes = cVector3d(0.0,0.0,0.0);
 
     // reset trajectory parameters
@@ -426,25 +510,35 @@ void exo::syncStates(bool resetTarg)
     }
 }
 
-cVector3d exo::forwardKin(cVector3d a_th)
+bool exo::loadFeedforward(std::string a_filename)
 {
-    // extract subject parameters
-    double L1 = m_subj->m_Lupper;
-    double L2 = m_subj->m_LtoEE;
-    double th1 = a_th(0);
-    double th2 = a_th(1);
+    // read identified joint models & build lookup table
+    if (!m_ffwd.load(a_filename)) {
+        m_feedforward = false;
+        return(C_ERROR);
+    }
+
+    // deadbands are not identified, but carried over (in motor space) from the table in use while logging
+    for (int i = 0; i < NUM_MTR; i++)
+        setDeadband(m_map, (uint)i, m_ffwd.m_model[i].p_dbLo, m_ffwd.m_model[i].p_dbHi);
+    m_feedforward = true;
+    return(C_SUCCESS);
+}
 
+void exo::clearFeedforward()
+{
+    // stop adding feedforward torques & restore default deadbands
+    m_feedforward = false;
+    channel_map defaults;
+    for (int i = 0; i < NUM_MTR; i++)
+        setDeadband(m_map, (uint)i, defaults.p_dbLo[i], defaults.p_dbHi[i]);
+}
+
+cVector3d exo::forwardKin(cVector3d a_th)
+{
     // compute task-space position via forward kinematics
     // NOTE: this assumes reachability
-    double x, y;
-    if (m_subj->m_rightHanded) {
-        x = L1*cos(th1) + L2*cos(th1+th2);
-        y = L1*sin(th1) + L2*sin(th1+th2);
-    } else {
-        x = L1*cos(PI-th1) + L2*cos(PI-th1-th2);
-        y = L1*sin(PI-th1) + L2*sin(PI-th1-th2);
-    }
-    return cVector3d(x, y, 0.0);
+    return toVec(chain().forwardKin(toJnt<NUM_ENC>(a_th)));
 }
 
 cVector3d exo::inverseKin(cVector3d a_pos)
@@ -502,8 +596,8 @@ cVector3d exo::getAngles()
     // get angular offsets from motor zeros (checking for encoder failure)
     cVector3d th = cVector3d(0.0,0.0,0.0);
     for (int i = 0; i < NUM_ENC; i++) {
-        if (checkEncod((uint)i)) {
-            th(i) = getAngle((uint)i, m_thZero[i]);
+        if (m_encOk[i]) {
+            th(i) = countsToAngle(m_counts[i], m_thZero[i]);
             if (DEBUG) {
                 qDebug() << "Mtr #" << i << " = " << th(i)*(180/PI) << " deg";
                 qDebug() << " ";
@@ -556,29 +650,20 @@ cVector3d exo::getAngles()
     return thJnt;
 }
 
-cMatrix3d exo::Jacobian(cVector3d a_th)
+const exoChain<NUM_ENC>& exo::chain()
 {
-    // extract subject parameters
-    double L1 = m_subj->m_Lupper;
-    double L2 = m_subj->m_LtoEE;
-    double th1 = a_th(0);
-    double th2 = a_th(1);
+    // sync chain with subject parameters (may change between sessions)
+    m_chain.m_L[0] = m_subj->m_Lupper;
+    m_chain.m_L[1] = m_subj->m_LtoEE;
+    m_chain.m_side = m_subj->m_rightHanded ? 1.0 : -1.0;  // left arm mirrored about y-axis
+    return m_chain;
+}
 
-    // compute entries of Jacobian for given joint angles
+jntMatrix<TASK_DIM,NUM_ENC> exo::Jacobian(cVector3d a_th)
+{
+    // compute Jacobian for given joint angles
     // NOTE: this assumes reachability
-    double J11, J12, J21, J22;
-    if (m_subj->m_rightHanded) {
-        J11 = -1.0*(L1*sin(th1) + L2*sin(th1+th2));
-        J12 = -1.0*L2*sin(th1+th2);
-        J21 = L1*cos(th1) + L2*cos(th1+th2);
-        J22 = L2*cos(th1+th2);
-    } else {
-        J11 = L1*sin(th1) + L2*sin(th1+th2);
-        J12 = L2*sin(th1+th2);
-        J21 = L1*cos(th1) + L2*cos(th1+th2);
-        J22 = L2*cos(th1+th2);
-    }
-    return cMatrix3d(J11,J12,0.0,J21,J22,0.0,0.0,0.0,1.0);  // pad matrix to make 3x3
+    return chain().Jacobian(toJnt<NUM_ENC>(a_th));
 }
 
 void exo::updateDesiredState(double a_dt)
@@ -592,13 +677,22 @@ void exo::updateDesiredState(double a_dt)
         if (a_dt >= dtTot) {
             m_thDes = m_thTarg;
             m_posDes = m_posTarg;
-            m_thdotDes = chai3d::cVector3d(0.0,0.0,0.0);
-            m_velDes = chai3d::cVector3d(0.0,0.0,0.0);
+            m_velDes = m_traj.velFinal;
+
+            // convert final velocity to joint space, for consistency (zero if singular)
+            jntVector<NUM_ENC> thdotDes;
+            if (chain().taskToJoint(toJnt<NUM_ENC>(m_thDes), toJnt<TASK_DIM>(m_velDes), thdotDes)) {
+                m_thdotDes = toVec(thdotDes);
+            } else {
+                m_thdotDes = chai3d::cVector3d(0.0,0.0,0.0);
+            }
+            m_thddotDes = chai3d::cVector3d(0.0,0.0,0.0);
         } else {
 
-            // compute desired displacement & speed in polar coordinates
+            // compute desired displacement, speed & acceleration in polar coordinates
             double dr = drTot*(10*pow(a_dt/dtTot,3) - 15*pow(a_dt/dtTot,4) + 6*pow(a_dt/dtTot,5));
             double drDot = (drTot/dtTot)*(30*pow(a_dt/dtTot,2) - 60*pow(a_dt/dtTot,3) + 30*pow(a_dt/dtTot,4));
+            double drDDot = (drTot/(dtTot*dtTot))*(60*(a_dt/dtTot) - 180*pow(a_dt/dtTot,2) + 120*pow(a_dt/dtTot,3));
 
             // convert to Cartesian coordinates
             double th = m_traj.dpos[1];
@@ -608,9 +702,13 @@ void exo::updateDesiredState(double a_dt)
 
             // convert to joint space, for consistency
             m_thDes = inverseKin(m_posDes);
-            cMatrix3d Jinv;
-            cMatrix3d J = Jacobian(m_thDes);
-            if (J.invertr(Jinv)) m_thdotDes = Jinv*m_velDes;
+            jntVector<NUM_ENC> thDes = toJnt<NUM_ENC>(m_thDes);
+            jntVector<NUM_ENC> thdotDes, thddotDes;
+            if (chain().taskToJoint(thDes, toJnt<TASK_DIM>(m_velDes), thdotDes) &&
+                chain().taskToJoint(thDes, toJnt<TASK_DIM>(drDDot*polrToCart), thddotDes)) {  // neglects velocity-product (Jdot) terms, small at these speeds
+                m_thdotDes = toVec(thdotDes);
+                m_thddotDes = toVec(thddotDes);
+            }
         }
 
     } else {
@@ -619,18 +717,21 @@ void exo::updateDesiredState(double a_dt)
         for (int i = 0; i < NUM_ENC; i++) {
             if (a_dt >= m_traj.dt[i]) {
                 m_thDes(i) = m_thTarg(i);
-                m_thdotDes(i) = 0.0;
+                m_thdotDes(i) = m_traj.velFinal(i);
+                m_thddotDes(i) = 0.0;
             } else {
                 m_thDes(i) = m_traj.posInit(i) +
                         m_traj.dpos[i]*(10*pow(a_dt/m_traj.dt[i],3) - 15*pow(a_dt/m_traj.dt[i],4) + 6*pow(a_dt/m_traj.dt[i],5));
                 m_thdotDes(i) = (m_traj.dpos[i]/m_traj.dt[i])*
                         (30*pow(a_dt/m_traj.dt[i],2) - 60*pow(a_dt/m_traj.dt[i],3) + 30*pow(a_dt/m_traj.dt[i],4));
+                m_thddotDes(i) = (m_traj.dpos[i]/(m_traj.dt[i]*m_traj.dt[i]))*
+                        (60*(a_dt/m_traj.dt[i]) - 180*pow(a_dt/m_traj.dt[i],2) + 120*pow(a_dt/m_traj.dt[i],3));
             }
         }
 
         // convert to task space, for consistency
         m_posDes = forwardKin(m_thDes);
-        m_velDes = Jacobian(m_thDes)*m_thdotDes;
+        m_velDes = toVec(Jacobian(m_thDes)*toJnt<NUM_ENC>(m_thdotDes));
     }
 }
 
@@ -642,6 +743,13 @@ void exo::setJntTorqs(cVector3d a_torque)
     for (int i = 0; i < NUM_MTR; i++) if (!m_activeJnts[i])  T(i) = 0.0;
     if (DEBUG)  qDebug() << "T = [" << T(0) << " , " << T(1) << "] N";
 
+    // add identified inertia & friction torques along desired trajectory (O(1) table lookup)
+    if (m_feedforward && m_mode == position) {
+        for (int i = 0; i < NUM_MTR; i++) {
+            if (m_activeJnts[i])  T(i) += m_ffwd.torque(i, m_thdotDes(i), m_thddotDes(i));
+        }
+    }
+
     // apply "bumper" torques to unlocked joints
     if (m_bumpers) {
         if (m_thLink(0)*(180/PI) > m_thLinkLim(0)*(180/PI)-BUFFER && m_lockedJnts[0]) {
@@ -665,6 +773,9 @@ void exo::setJntTorqs(cVector3d a_torque)
         }
     }
 
+    // save joint torques for logging (excluding dither, which is aliased at logging rate)
+    m_Tcmd = T;
+
     // convert torques from robot to motor space
     T(0) = T(0)/RATIO_S;                     // gearing
     T(1) = T(1)/RATIO_E;
@@ -679,21 +790,28 @@ void exo::setJntTorqs(cVector3d a_torque)
         }
     }
 
-    // command torques to unlocked joints, saturating for safety
+    // saturate for safety
     for (int i = 0; i < NUM_MTR; i++) {
         if (fabs(T(i)) > T_MAX)  T(i) = (T(i)/fabs(T(i)))*T_MAX;
-        if (!m_lockedJnts[i])  setTorque((uint)i, T(i));
     }
+
+    // command torques here, unless batched with other exos
+    m_Tmtr = T;
+    if (!m_scheduled) writeMotors();
 }
 
-void exo::setEndForce(cVector3d a_force)
+void exo::writeMotors()
 {
-    // compute Jacobian transpose
-    cMatrix3d J = Jacobian(m_th);
-    J.trans();
+    // command torques (from last 'setJntTorqs') to unlocked joints
+    for (int i = 0; i < NUM_MTR; i++) {
+        if (!m_lockedJnts[i])  setTorque(m_map, (uint)i, m_Tmtr(i));
+    }
+}
 
-    // convert force to torque
-    cVector3d Tequiv = J*a_force;
+void exo::setEndForce(cVector3d a_force)
+{
+    // convert force to torque (via Jacobian transpose)
+    cVector3d Tequiv = toVec(chain().forceToTorque(toJnt<NUM_ENC>(m_th), toJnt<TASK_DIM>(a_force)));
     setJntTorqs(Tequiv);
 }
 
@@ -705,10 +823,9 @@ bool exo::jointSpaceCtrl(ctrl_modes a_mode)
 
         // only exert torques if target configuration is within subject's workspace
         if (!isOutOfBounds(m_thTarg, JNTSPACE)) {
-            cVector3d T_pos = m_thErr;         T_pos.mulElement(m_KpJnt);
-            cVector3d T_vel = m_thdotErr;      T_vel.mulElement(m_KdJnt);
-            cVector3d T_posInt = m_thErrInt;   T_posInt.mulElement(m_KiJnt);
-            m_T = T_pos + T_vel + T_posInt;
+            m_T = toVec(pidEffort(toJnt<NUM_ENC>(m_KpJnt), toJnt<NUM_ENC>(m_thErr),
+                                  toJnt<NUM_ENC>(m_KdJnt), toJnt<NUM_ENC>(m_thdotErr),
+                                  toJnt<NUM_ENC>(m_KiJnt), toJnt<NUM_ENC>(m_thErrInt)));
             setJntTorqs(m_T);
             return(C_SUCCESS);
         } else {
@@ -741,10 +858,9 @@ bool exo::taskSpaceCtrl(ctrl_modes a_mode)
         //       should be handled by the natural deviation from straight-line
         //       trajectory that is caused by the exo's uncompensated dynamics
         if (!isOutOfBounds(m_posTarg, TASKSPACE)) {
-            cVector3d F_pos = m_posErr;         F_pos.mulElement(m_KpTsk);
-            cVector3d F_vel = m_velErr;         F_vel.mulElement(m_KdTsk);
-            cVector3d F_posInt = m_posErrInt;   F_posInt.mulElement(m_KiTsk);
-            m_F = F_pos + F_vel + F_posInt;
+            m_F = toVec(pidEffort(toJnt<TASK_DIM>(m_KpTsk), toJnt<TASK_DIM>(m_posErr),
+                                  toJnt<TASK_DIM>(m_KdTsk), toJnt<TASK_DIM>(m_velErr),
+                                  toJnt<TASK_DIM>(m_KiTsk), toJnt<TASK_DIM>(m_posErrInt)));
             setEndForce(m_F);
             return(C_SUCCESS);
         } else {
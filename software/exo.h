@@ -4,6 +4,9 @@
 #include "chai3d.h"
 #include "subject.h"
 #include "motorcontrol.h"
+#include "ffwdtable.h"
+#include "exoreadout.h"
+#include "exochain.h"
 #include "Windows.h"
 #include <cmath>
 #include <array>
@@ -11,6 +14,7 @@
 
 #define NUM_ENC 2  // number of encoders (0 = shoulder, 1 = elbow)
 #define NUM_MTR 2  // number of motors (0 = shoulder, 1 = elbow)
+#define FFWD_FILE "ffwd.txt"  // feedforward table written by 'sysid' (applied only when enabled from GUI)
 #define PI      3.141592
 
 // enumeration of control modes
@@ -38,12 +42,16 @@ typedef struct
     double tInit = 0.0;                    // time target is set [sec]
     double dpos[NUM_ENC] = {0,0};          // total displacement vector ([dthS,dthE] in joint space, [dr,th] in task space)
     double dt[NUM_ENC] = {0,0};            // time allotted for movement, in each DOF [sec]
+    chai3d::cVector3d velFinal
+        = chai3d::cVector3d(0.0,0.0,0.0);  // velocity once target is reached (nonzero only when following, see 'follow')
 } moveTraj;
 
 class exo
 {
 public:
     subject* m_subj;                        // pointer to subject associated with exoskeleton
+    channel_map m_map;                      // 826 board & channels of exoskeleton (with motor deadbands)
+    bool m_scheduled;                       // TRUE = hardware I/O batched with other exos by 'exoScheduler' (see 'readEncoders'/'writeMotors')
 
     bool m_error;                           // TRUE = problem with exo while running
     std::string m_errMessage;               // error message
@@ -57,6 +65,7 @@ public:
     chai3d::cVector3d m_thErr;              // joint-angle error (relative to 'm_thDes') [rad]
     chai3d::cVector3d m_thdot;              // current joint velocities [rad/s]
     chai3d::cVector3d m_thdotDes;           // desired joint velocities [rad/s]
+    chai3d::cVector3d m_thddotDes;          // desired joint accelerations [rad/s^2]
     chai3d::cVector3d m_thdotErr;           // joint-velocity error [rad/s]
     chai3d::cVector3d m_thErrInt;           // integrated joint angle error [rad*s]
     chai3d::cVector3d m_pos;                // current end-effector position [m]
@@ -76,6 +85,8 @@ public:
     bool m_bumpers;                         // TRUE = virtual walls prevent collision with acrylic frame
     bool m_negDamp;                         // TRUE = negative damping control to help with friction
     bool m_dither;                          // TRUE = high-frequency actuation to help with (nonlinear) friction
+    bool m_feedforward;                     // TRUE = identified inertia/friction torques added to active joints in position mode
+    ffwdTable m_ffwd;                       // feedforward table from system identification (see 'sysid')
     std::array<bool,NUM_MTR> m_activeJnts;  // list of joints to be actively controlled (not including "bumper", negative damping, or dither torques)
     std::array<bool,NUM_MTR> m_lockedJnts;  // list of joints to be MANUALLY locked
     chai3d::cVector3d m_KpJnt;              // proportional gains for joint-space control
@@ -88,22 +99,29 @@ public:
     chai3d::cVector3d m_Adith;              // dither amplitude for joint-space (nonlinear) friction compensation [N*m]
     chai3d::cVector3d m_fdith;              // dither frequency for joint-space (nonlinear) friction compensation [Hz]
     chai3d::cVector3d m_T;                  // desired joint torques [N*m]
+    chai3d::cVector3d m_Tcmd;               // joint torques commanded after feedforward, bumpers & negative damping (for logging) [N*m]
     chai3d::cVector3d m_F;                  // desired end-effector force [N]
 
-    exo(subject *a_subj);
+    exo(subject *a_subj, channel_map a_map = channel_map());
     ~exo();
 
-    bool connect();
-    bool disconnect();
+    bool connect(bool a_openBoard = true);
+    bool disconnect(bool a_closeBoard = true);
     void calibrate();
+    void readEncoders();
     void getState();
     bool sendCommand();
+    void writeMotors();
+    void getSample(exo_sample &a_sample);
     bool reachedTarg();
     void setMode(ctrl_modes a_mode);
     void setCtrl(ctrl_states a_ctrl);
     void setTarg(chai3d::cVector3d a_targ, ctrl_states a_ctrl);
     void setForce(chai3d::cVector3d a_force, ctrl_states a_ctrl);
+    void follow(chai3d::cVector3d a_targ, chai3d::cVector3d a_vel, ctrl_states a_ctrl);
     void syncStates(bool resetTarg = true);
+    bool loadFeedforward(std::string a_filename);
+    void clearFeedforward();
     chai3d::cVector3d forwardKin(chai3d::cVector3d a_th);
     chai3d::cVector3d inverseKin(chai3d::cVector3d a_pos);
     chai3d::cVector3d findNearest(chai3d::cVector3d a_pos);
@@ -113,9 +131,20 @@ protected:
     bool m_exoReady;                // TRUE = connection to exoskeleton successful
     chai3d::cVector3d m_thLinkLim;  // max shoulder link and min elbow link angles [rad, depends on handedness]
     chai3d::cVector3d m_thLinkNom;  // nominal offsets from link-angle zeros [rad, in linkage space]
+    exoChain<NUM_ENC> m_chain;      // fixed-size kinematics of subject's arm (see 'chain')
+    int m_counts[NUM_ENC];          // encoder counts from last 'readEncoders' [counts, in motor space]
+    bool m_encOk[NUM_ENC];          // TRUE = no quadrature error on last 'readEncoders'
+    chai3d::cVector3d m_Tmtr;       // torques for next 'writeMotors' [N*m, in motor space]
+    double m_tLast;                 // time of last state update [sec]
+    chai3d::cVector3d m_thLast;     // joint angles at last state update [rad]
+    chai3d::cVector3d m_thdotLast;  // (filtered) joint velocities at last state update [rad/s]
+    chai3d::cVector3d m_thErrIntLast;   // integrated joint-angle error at last state update [rad*s]
+    chai3d::cVector3d m_posErrIntLast;  // integrated end-effector position error at last state update [m*s]
+    int m_stopCount;                // number of consecutive zero-velocity checks (see 'reachedTarg')
 
     chai3d::cVector3d getAngles();
-    chai3d::cMatrix3d Jacobian(chai3d::cVector3d a_th);
+    const exoChain<NUM_ENC>& chain();
+    jntMatrix<TASK_DIM,NUM_ENC> Jacobian(chai3d::cVector3d a_th);
     void updateDesiredState(double a_dt);
     void setJntTorqs(chai3d::cVector3d a_torque);
     void setEndForce(chai3d::cVector3d a_force);
@@ -0,0 +1,121 @@
+#ifndef EXOCHAIN_H
+#define EXOCHAIN_H
+
+#include "exomath.h"
+
+// minimum-norm solution of J*x = v (pseudo-inverse for redundant chains)
+template<int N>
+bool chainMinNorm(const jntMatrix<TASK_DIM,N> &a_J, const jntVector<TASK_DIM> &a_v, jntVector<N> &a_x)
+{
+    jntVector<TASK_DIM> y;
+    if (!jntSolve(a_J*a_J.transpose(), a_v, y)) return false;
+    a_x = a_J.mulTrans(y);
+    return true;
+}
+
+// (non-redundant) 2-DOF chain: exact inverse
+inline bool chainMinNorm(const jntMatrix<2,2> &a_J, const jntVector<2> &a_v, jntVector<2> &a_x)
+{
+    return jntSolve(a_J, a_v, a_x);
+}
+
+// least-squares solution of J^T*F = T (end-effector force equivalent to joint torques)
+template<int N>
+bool chainLeastSq(const jntMatrix<TASK_DIM,N> &a_J, const jntVector<N> &a_T, jntVector<TASK_DIM> &a_F)
+{
+    return jntSolve(a_J*a_J.transpose(), a_J*a_T, a_F);
+}
+
+// (non-redundant) 2-DOF chain: exact inverse
+inline bool chainLeastSq(const jntMatrix<2,2> &a_J, const jntVector<2> &a_T, jntVector<2> &a_F)
+{
+    return jntSolve(a_J.transpose(), a_T, a_F);
+}
+
+// PID effort (joint torques or end-effector force) from errors & element-wise gains
+template<int N>
+jntVector<N> pidEffort(const jntVector<N> &a_Kp, const jntVector<N> &a_err,
+                       const jntVector<N> &a_Kd, const jntVector<N> &a_errDot,
+                       const jntVector<N> &a_Ki, const jntVector<N> &a_errInt)
+{
+    jntVector<N> u;
+    for (int i = 0; i < N; i++) u.m_v[i] = a_Kp.m_v[i]*a_err.m_v[i] + a_Kd.m_v[i]*a_errDot.m_v[i] + a_Ki.m_v[i]*a_errInt.m_v[i];
+    return u;
+}
+
+// kinematics of an N-DOF serial chain moving the hand in the (horizontal) plane,
+// independent of exo hardware (encoders, gearing, linkage offsets)
+// NOTE: joints marked non-planar (e.g. forearm pronation) do not move the
+// ----  hand, so their Jacobian columns are zero
+// NOTE: 'exo' uses this for its kinematics only; its state & controllers are
+// ----  still written for 2 DOFs (see 'toJnt'/'toVec' in exo.cpp)
+template<int N>
+class exoChain
+{
+public:
+    double m_L[N];       // length of link following each joint [m]
+    bool m_planar[N];    // TRUE = joint rotates in plane of task space
+    double m_side;       // +1 = right-handed, -1 = left-handed (mirrored about y-axis)
+
+    exoChain()
+    {
+        for (int i = 0; i < N; i++) { m_L[i] = 0.0; m_planar[i] = true; }
+        m_side = 1.0;
+    }
+
+    // hand position
+    jntVector<TASK_DIM> forwardKin(const jntVector<N> &a_th) const
+    {
+        jntVector<TASK_DIM> pos;
+        double phi = 0.0;
+        for (int i = 0; i < N; i++) {
+            if (m_planar[i]) phi += a_th.m_v[i];
+            pos.m_v[0] += m_L[i]*cos(phi);
+            pos.m_v[1] += m_L[i]*sin(phi);
+        }
+        pos.m_v[0] *= m_side;
+        return pos;
+    }
+
+    // hand Jacobian (TASK_DIM x N), from suffix sums over the chain
+    jntMatrix<TASK_DIM,N> Jacobian(const jntVector<N> &a_th) const
+    {
+        double c[N], s[N];
+        double phi = 0.0;
+        for (int i = 0; i < N; i++) {
+            if (m_planar[i]) phi += a_th.m_v[i];
+            c[i] = m_L[i]*cos(phi);
+            s[i] = m_L[i]*sin(phi);
+        }
+        jntMatrix<TASK_DIM,N> J;
+        double sumC = 0.0, sumS = 0.0;
+        for (int i = N-1; i >= 0; i--) {
+            sumC += c[i];
+            sumS += s[i];
+            if (!m_planar[i]) continue;
+            J.m_m[0][i] = -m_side*sumS;
+            J.m_m[1][i] = sumC;
+        }
+        return J;
+    }
+
+    // joint torques equivalent to end-effector force
+    jntVector<N> forceToTorque(const jntVector<N> &a_th, const jntVector<TASK_DIM> &a_F) const
+    {
+        return Jacobian(a_th).mulTrans(a_F);
+    }
+
+    // end-effector force equivalent to joint torques (returns FALSE if singular)
+    bool torqueToForce(const jntVector<N> &a_th, const jntVector<N> &a_T, jntVector<TASK_DIM> &a_F) const
+    {
+        return chainLeastSq(Jacobian(a_th), a_T, a_F);
+    }
+
+    // joint velocities (or accelerations, neglecting Jdot terms) for hand velocity (returns FALSE if singular)
+    bool taskToJoint(const jntVector<N> &a_th, const jntVector<TASK_DIM> &a_v, jntVector<N> &a_thdot) const
+    {
+        return chainMinNorm(Jacobian(a_th), a_v, a_thdot);
+    }
+};
+
+#endif // EXOCHAIN_H
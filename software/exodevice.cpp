@@ -0,0 +1,76 @@
+#include "exodevice.h"
+
+#define F_MAX_VE     20.0      // maximum force rendered at hand by virtual world, well inside T_MAX over arm's reach [N]
+#define K_MAX_VE     500.0     // maximum stiffness of virtual objects, stable at 1 kHz servo rate [N/m]
+#define B_MAX_VE     10.0      // maximum damping of virtual objects [N/(m/s)]
+#define R_WORKSPACE  0.75      // radius of hand workspace, about shoulder [m]
+
+using namespace chai3d;
+
+exoDevice::exoDevice(exo *a_exo) :
+    cGenericHapticDevice(0)
+{
+    m_exo = a_exo;
+
+    // planar hand "device", in exo task space (origin at shoulder, meters)
+    m_specifications.m_manufacturerName      = "chARM";
+    m_specifications.m_modelName             = "chARM exoskeleton";
+    m_specifications.m_maxLinearForce        = F_MAX_VE;
+    m_specifications.m_maxLinearStiffness    = K_MAX_VE;
+    m_specifications.m_maxLinearDamping      = B_MAX_VE;
+    m_specifications.m_workspaceRadius       = R_WORKSPACE;
+    m_specifications.m_sensedPosition        = true;
+    m_specifications.m_actuatedPosition      = true;
+
+    m_deviceAvailable = true;
+    m_deviceReady = false;
+}
+
+bool exoDevice::open()
+{
+    // exo hardware is connected separately (see 'exo::connect'), so only handedness is updated
+    m_specifications.m_rightHand = m_exo->m_subj->m_rightHanded;
+    m_specifications.m_leftHand = !m_exo->m_subj->m_rightHanded;
+    m_deviceReady = true;
+    return(C_SUCCESS);
+}
+
+bool exoDevice::close()
+{
+    // leave exo transparent (zero hand force)
+    setForce(cVector3d(0.0,0.0,0.0));
+    m_deviceReady = false;
+    return(C_SUCCESS);
+}
+
+bool exoDevice::getPosition(cVector3d &a_position)
+{
+    // hand position from last 'exo::getState'
+    a_position = m_exo->m_pos;
+    a_position(2) = 0.0;
+    return(m_deviceReady);
+}
+
+bool exoDevice::getLinearVelocity(cVector3d &a_linearVelocity)
+{
+    // (filtered) hand velocity from last 'exo::getState'
+    a_linearVelocity = m_exo->m_vel;
+    a_linearVelocity(2) = 0.0;
+    m_linearVelocity = a_linearVelocity;
+    return(m_deviceReady);
+}
+
+bool exoDevice::setForceAndTorqueAndGripperForce(const cVector3d &a_force, const cVector3d &a_torque, double a_gripperForce)
+{
+    if (!m_deviceReady) return(C_ERROR);
+
+    // keep planar component of force, saturating for safety
+    cVector3d F = a_force;
+    F(2) = 0.0;
+    if (F.length() > F_MAX_VE) F = (F_MAX_VE/F.length())*F;
+
+    // force applied by exo's task-space force control on next 'sendCommand'
+    m_exo->setForce(F, task);
+    m_prevForce = F;
+    return(C_SUCCESS);
+}
@@ -0,0 +1,32 @@
+#ifndef EXODEVICE_H
+#define EXODEVICE_H
+
+#include "chai3d.h"
+#include "exo.h"
+#include <memory>
+
+// exo as a CHAI haptic device (planar, position sensed & actuated at the hand), so
+// that a 'cToolCursor' can render forces of a virtual world ('cWorld') at servo rate
+// NOTE: no hardware I/O is done here: 'exo::getState' reads the encoders before the
+// ----  tool is updated, and 'exo::sendCommand' applies the proxy force (task-space
+//       force control, via 'setEndForce') afterwards, within the same servo period
+class exoDevice : public chai3d::cGenericHapticDevice
+{
+public:
+    exoDevice(exo *a_exo);
+    virtual ~exoDevice() {}
+
+    static std::shared_ptr<exoDevice> create(exo *a_exo) { return std::make_shared<exoDevice>(a_exo); }
+
+    virtual bool open();
+    virtual bool close();
+    virtual bool calibrate(bool a_forceCalibration = false) { return(m_deviceReady); }
+    virtual bool getPosition(chai3d::cVector3d &a_position);
+    virtual bool getLinearVelocity(chai3d::cVector3d &a_linearVelocity);
+    virtual bool setForceAndTorqueAndGripperForce(const chai3d::cVector3d &a_force, const chai3d::cVector3d &a_torque, double a_gripperForce);
+
+protected:
+    exo* m_exo;  // pointer to exo providing hand state & rendering forces
+};
+
+#endif // EXODEVICE_H
@@ -0,0 +1,121 @@
+#ifndef EXOMATH_H
+#define EXOMATH_H
+
+#include <cmath>
+
+#define TASK_DIM     2         // dimension of (planar) task space
+
+// fixed-size vector, sized at compile time by the number of DOFs
+// NOTE: stack allocated & loops have constant bounds, so small
+// ----  sizes compile to straight-line code
+template<int N>
+class jntVector
+{
+public:
+    double m_v[N];
+
+    jntVector() { for (int i = 0; i < N; i++) m_v[i] = 0.0; }
+
+    double& operator()(int i) { return m_v[i]; }
+    double operator()(int i) const { return m_v[i]; }
+
+    jntVector<N> operator+(const jntVector<N> &a_b) const { jntVector<N> r; for (int i = 0; i < N; i++) r.m_v[i] = m_v[i] + a_b.m_v[i]; return r; }
+    jntVector<N> operator-(const jntVector<N> &a_b) const { jntVector<N> r; for (int i = 0; i < N; i++) r.m_v[i] = m_v[i] - a_b.m_v[i]; return r; }
+    jntVector<N> operator*(double a_s) const { jntVector<N> r; for (int i = 0; i < N; i++) r.m_v[i] = m_v[i]*a_s; return r; }
+    jntVector<N>& operator+=(const jntVector<N> &a_b) { for (int i = 0; i < N; i++) m_v[i] += a_b.m_v[i]; return *this; }
+
+    // element-wise product (e.g. gains times errors)
+    jntVector<N> mulElement(const jntVector<N> &a_b) const { jntVector<N> r; for (int i = 0; i < N; i++) r.m_v[i] = m_v[i]*a_b.m_v[i]; return r; }
+
+    double dot(const jntVector<N> &a_b) const { double s = 0.0; for (int i = 0; i < N; i++) s += m_v[i]*a_b.m_v[i]; return s; }
+    double length() const { return sqrt(dot(*this)); }
+};
+
+// fixed-size (row-major) matrix
+template<int R, int C>
+class jntMatrix
+{
+public:
+    double m_m[R][C];
+
+    jntMatrix() { for (int i = 0; i < R; i++) for (int j = 0; j < C; j++) m_m[i][j] = 0.0; }
+
+    double& operator()(int i, int j) { return m_m[i][j]; }
+    double operator()(int i, int j) const { return m_m[i][j]; }
+
+    jntVector<R> operator*(const jntVector<C> &a_x) const
+    {
+        jntVector<R> y;
+        for (int i = 0; i < R; i++)
+            for (int j = 0; j < C; j++) y.m_v[i] += m_m[i][j]*a_x.m_v[j];
+        return y;
+    }
+
+    template<int K>
+    jntMatrix<R,K> operator*(const jntMatrix<C,K> &a_B) const
+    {
+        jntMatrix<R,K> P;
+        for (int i = 0; i < R; i++)
+            for (int k = 0; k < K; k++)
+                for (int j = 0; j < C; j++) P.m_m[i][k] += m_m[i][j]*a_B.m_m[j][k];
+        return P;
+    }
+
+    jntMatrix<C,R> transpose() const
+    {
+        jntMatrix<C,R> T;
+        for (int i = 0; i < R; i++)
+            for (int j = 0; j < C; j++) T.m_m[j][i] = m_m[i][j];
+        return T;
+    }
+
+    // product with transpose, A^T*x, without forming A^T
+    jntVector<C> mulTrans(const jntVector<R> &a_x) const
+    {
+        jntVector<C> y;
+        for (int i = 0; i < R; i++)
+            for (int j = 0; j < C; j++) y.m_v[j] += m_m[i][j]*a_x.m_v[i];
+        return y;
+    }
+};
+
+// solve A*x = b for square A (Gaussian elimination with partial pivoting)
+// returns FALSE if A is (numerically) singular, leaving 'a_x' unchanged
+template<int N>
+bool jntSolve(const jntMatrix<N,N> &a_A, const jntVector<N> &a_b, jntVector<N> &a_x)
+{
+    jntMatrix<N,N> A = a_A;
+    jntVector<N> b = a_b;
+    for (int k = 0; k < N; k++) {
+        int p = k;
+        for (int i = k+1; i < N; i++) if (fabs(A.m_m[i][k]) > fabs(A.m_m[p][k])) p = i;
+        if (fabs(A.m_m[p][k]) < 1e-12) return false;
+        if (p != k) {
+            for (int j = 0; j < N; j++) { double t = A.m_m[k][j]; A.m_m[k][j] = A.m_m[p][j]; A.m_m[p][j] = t; }
+            double t = b.m_v[k]; b.m_v[k] = b.m_v[p]; b.m_v[p] = t;
+        }
+        for (int i = k+1; i < N; i++) {
+            double f = A.m_m[i][k]/A.m_m[k][k];
+            for (int j = k; j < N; j++) A.m_m[i][j] -= f*A.m_m[k][j];
+            b.m_v[i] -= f*b.m_v[k];
+        }
+    }
+    for (int i = N-1; i >= 0; i--) {
+        double s = b.m_v[i];
+        for (int j = i+1; j < N; j++) s -= A.m_m[i][j]*a_x.m_v[j];
+        a_x.m_v[i] = s/A.m_m[i][i];
+    }
+    return true;
+}
+
+// closed form for the 2x2 case (current 2-DOF exo)
+inline bool jntSolve(const jntMatrix<2,2> &a_A, const jntVector<2> &a_b, jntVector<2> &a_x)
+{
+    double det = a_A.m_m[0][0]*a_A.m_m[1][1] - a_A.m_m[0][1]*a_A.m_m[1][0];
+    if (fabs(det) < 1e-12) return false;
+    a_x.m_v[0] = ( a_A.m_m[1][1]*a_b.m_v[0] - a_A.m_m[0][1]*a_b.m_v[1])/det;
+    a_x.m_v[1] = (-a_A.m_m[1][0]*a_b.m_v[0] + a_A.m_m[0][0]*a_b.m_v[1])/det;
+    return true;
+}
+
+#endif // EXOMATH_H
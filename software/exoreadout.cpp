@@ -0,0 +1,62 @@
+#include "exoreadout.h"
+#include <algorithm>
+
+#define NUM_FIELDS   (int)(sizeof(exo_sample)/sizeof(double))  // number of (double) values in one sample
+
+static_assert(sizeof(exo_sample) % sizeof(double) == 0, "'exo_sample' must only hold doubles");
+static_assert((RING_SIZE & (RING_SIZE-1)) == 0, "RING_SIZE must be a power of 2");
+
+using namespace std;
+
+void readoutStats::add(const exo_sample &a_sample)
+{
+    const double *x = (const double*)&a_sample;
+    double *lo = (double*)&m_min;
+    double *mean = (double*)&m_mean;
+    double *hi = (double*)&m_max;
+
+    // first sample initializes all statistics
+    m_n++;
+    if (m_n == 1) {
+        m_min = a_sample;
+        m_mean = a_sample;
+        m_max = a_sample;
+        return;
+    }
+
+    // running (element-wise) statistics
+    for (int i = 0; i < NUM_FIELDS; i++) {
+        lo[i] = min(lo[i], x[i]);
+        hi[i] = max(hi[i], x[i]);
+        mean[i] += (x[i] - mean[i])/m_n;
+    }
+}
+
+exoReadout::exoReadout() :
+    m_ring(RING_SIZE)
+{
+    m_head = 0;
+    m_tail = 0;
+    m_dropped = 0;
+}
+
+bool exoReadout::push(const exo_sample &a_sample)
+{
+    unsigned int head = m_head.load(memory_order_relaxed);
+    if (head - m_tail.load(memory_order_acquire) >= RING_SIZE) {
+        m_dropped.fetch_add(1, memory_order_relaxed);
+        return false;
+    }
+    m_ring[head & (RING_SIZE-1)] = a_sample;
+    m_head.store(head + 1, memory_order_release);  // publish sample to consumer
+    return true;
+}
+
+bool exoReadout::pop(exo_sample &a_sample)
+{
+    unsigned int tail = m_tail.load(memory_order_relaxed);
+    if (tail == m_head.load(memory_order_acquire)) return false;  // empty
+    a_sample = m_ring[tail & (RING_SIZE-1)];
+    m_tail.store(tail + 1, memory_order_release);  // free slot for producer
+    return true;
+}
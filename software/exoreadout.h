@@ -0,0 +1,64 @@
+#ifndef EXOREADOUT_H
+#define EXOREADOUT_H
+
+#include "subject.h"
+#include <vector>
+#include <atomic>
+
+#define RING_SIZE    16384     // number of servo samples buffered between haptic & GUI threads (power of 2, several seconds at servo rate)
+
+// one servo-rate sample of exo state, as read out by GUI and demo recording
+// NOTE: only doubles, so that statistics can be taken element-wise (see 'readoutStats')
+typedef struct
+{
+    double d_time;                 // [sec]
+    double d_th[NUM_JNT];          // joint angles [rad]
+    double d_thdot[NUM_JNT];       // joint velocities [rad/s]
+    double d_pos[NUM_JNT];         // end-effector position [m]
+    double d_vel[NUM_JNT];         // end-effector velocity [m/s]
+    double d_thErr[NUM_JNT];       // joint-angle error [rad]
+    double d_thdotErr[NUM_JNT];    // joint-velocity error [rad/s]
+    double d_thErrInt[NUM_JNT];    // integrated joint-angle error [rad*s]
+    double d_posErr[NUM_JNT];      // end-effector position error [m]
+    double d_velErr[NUM_JNT];      // end-effector velocity error [m/s]
+    double d_posErrInt[NUM_JNT];   // integrated end-effector position error [m*s]
+    double d_T[NUM_JNT];           // desired joint torques [N*m]
+    double d_Tcmd[NUM_JNT];        // commanded joint torques (after feedforward, bumpers, etc.) [N*m]
+    double d_F[NUM_JNT];           // desired end-effector force [N]
+} exo_sample;
+
+// min/mean/max of every field of 'exo_sample' over a number of samples (e.g. one GUI frame)
+class readoutStats
+{
+public:
+    exo_sample m_min;   // element-wise minimum
+    exo_sample m_mean;  // element-wise mean
+    exo_sample m_max;   // element-wise maximum
+    int m_n;            // number of samples
+
+    readoutStats() { reset(); }
+
+    void reset() { m_n = 0; }
+    void add(const exo_sample &a_sample);
+};
+
+// single-producer (haptic thread), single-consumer (GUI thread) ring of servo samples
+// NOTE: lock-free so that the servo loop never waits on the GUI; if the GUI falls
+// ----  more than RING_SIZE samples behind, new samples are dropped (and counted)
+class exoReadout
+{
+public:
+    exoReadout();
+
+    bool push(const exo_sample &a_sample);
+    bool pop(exo_sample &a_sample);
+    unsigned int dropped() { return m_dropped.load(std::memory_order_relaxed); }
+
+protected:
+    std::vector<exo_sample> m_ring;       // sample storage
+    std::atomic<unsigned int> m_head;     // total samples written (only advanced by producer)
+    std::atomic<unsigned int> m_tail;     // total samples read (only advanced by consumer)
+    std::atomic<unsigned int> m_dropped;  // samples dropped because ring was full
+};
+
+#endif // EXOREADOUT_H
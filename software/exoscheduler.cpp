@@ -0,0 +1,190 @@
+#include "exoscheduler.h"
+#include <algorithm>
+#include <QDebug>
+
+#define MAX_EXOS  3     // maximum number of exos in one cycle (6 counter channels per 826 board, one board)
+#define DEBUG     0
+
+using namespace std;
+using namespace chai3d;
+
+exoScheduler::exoScheduler()
+{
+    m_connected = false;
+}
+
+int exoScheduler::add(exo *a_exo)
+{
+    // exos can only be added before connecting
+    if (m_connected || (int)m_exos.size() >= MAX_EXOS) return(-1);
+
+    // reject channels already used by another exo on the same board
+    for (size_t i = 0; i < m_exos.size(); i++) {
+        if (m_exos[i]->m_map.p_board != a_exo->m_map.p_board) continue;
+        for (int j = 0; j < NUM_AXES; j++) {
+            for (int k = 0; k < NUM_AXES; k++) {
+                if (m_exos[i]->m_map.p_enc[j] == a_exo->m_map.p_enc[k] ||
+                    m_exos[i]->m_map.p_mtr[j] == a_exo->m_map.p_mtr[k]) return(-1);
+            }
+        }
+    }
+    m_exos.push_back(a_exo);
+
+    // group I/O by board, keeping order within each board
+    m_ioOrder.clear();
+    for (int i = 0; i < (int)m_exos.size(); i++) m_ioOrder.push_back(i);
+    stable_sort(m_ioOrder.begin(), m_ioOrder.end(), [this](int a, int b) {
+        return m_exos[a]->m_map.p_board < m_exos[b]->m_map.p_board;
+    });
+    return (int)m_exos.size() - 1;
+}
+
+bool exoScheduler::couple(int a_leader, int a_follower, coupling_modes a_mode)
+{
+    // leader must be updated first (added before follower) so coupling takes effect in same cycle
+    if (a_leader < 0 || a_follower >= (int)m_exos.size() || a_leader >= a_follower) return(C_ERROR);
+
+    exo_coupling coupling;
+    coupling.p_leader = a_leader;
+    coupling.p_follower = a_follower;
+    coupling.p_mode = a_mode;
+    coupling.p_offset = cVector3d(0.0,0.0,0.0);
+    coupling.p_offsetSet = false;  // states are owned by servo loop, so offset is taken there
+
+    // replace any existing coupling of follower
+    m_couplingLock.acquire();
+    for (size_t i = 0; i < m_couplings.size(); i++) {
+        if (m_couplings[i].p_follower == a_follower) {
+            m_couplings.erase(m_couplings.begin() + i);
+            break;
+        }
+    }
+    m_couplings.push_back(coupling);
+    m_couplingLock.release();
+    return(C_SUCCESS);
+}
+
+void exoScheduler::uncouple(int a_follower)
+{
+    m_couplingLock.acquire();
+    for (size_t i = 0; i < m_couplings.size(); i++) {
+        if (m_couplings[i].p_follower == a_follower) {
+            m_couplings.erase(m_couplings.begin() + i);
+            break;
+        }
+    }
+    m_couplingLock.release();
+
+    // leave follower holding its current state
+    if (a_follower >= 0 && a_follower < (int)m_exos.size()) m_exos[a_follower]->setCtrl(none);
+}
+
+bool exoScheduler::connect()
+{
+    if (m_connected || m_exos.empty()) return(C_ERROR);
+
+    // open 826 system once for all exos
+    if (!connectToS826()) return(C_ERROR);
+
+    // initialize channels of each exo, backing out if any fail
+    for (size_t i = 0; i < m_exos.size(); i++) {
+        if (!m_exos[i]->connect(false)) {
+            for (size_t j = 0; j < i; j++) {
+                m_exos[j]->disconnect(false);
+                m_exos[j]->m_scheduled = false;
+            }
+            disconnectFromS826();
+            return(C_ERROR);
+        }
+        m_exos[i]->m_scheduled = true;
+    }
+
+    m_connected = true;
+    return(C_SUCCESS);
+}
+
+bool exoScheduler::disconnect()
+{
+    if (!m_connected) return(C_ERROR);
+
+    // zero all motors, then close 826 system once
+    for (size_t i = 0; i < m_exos.size(); i++) {
+        m_exos[i]->disconnect(false);
+        m_exos[i]->m_scheduled = false;
+    }
+    disconnectFromS826();
+
+    m_connected = false;
+    return(C_SUCCESS);
+}
+
+void exoScheduler::read()
+{
+    // sample all encoders back-to-back, board by board
+    for (size_t i = 0; i < m_ioOrder.size(); i++) m_exos[m_ioOrder[i]]->readEncoders();
+}
+
+void exoScheduler::update()
+{
+    // update states in order, setting each follower's target from its (already updated) leader
+    m_couplingLock.acquire();
+    for (int i = 0; i < (int)m_exos.size(); i++) {
+        for (size_t j = 0; j < m_couplings.size(); j++) {
+            if (m_couplings[j].p_follower == i) applyCoupling(m_couplings[j]);
+        }
+        m_exos[i]->getState();
+    }
+    m_couplingLock.release();
+}
+
+bool exoScheduler::command()
+{
+    // compute commands of all exos (written in 'write')
+    bool inWorkspace = C_SUCCESS;
+    for (size_t i = 0; i < m_exos.size(); i++) {
+        if (!m_exos[i]->sendCommand()) inWorkspace = C_ERROR;
+    }
+    return(inWorkspace);
+}
+
+void exoScheduler::write()
+{
+    // command all motors back-to-back, board by board
+    for (size_t i = 0; i < m_ioOrder.size(); i++) m_exos[m_ioOrder[i]]->writeMotors();
+}
+
+bool exoScheduler::cycle()
+{
+    read();
+    update();
+    bool inWorkspace = command();
+    write();
+    return(inWorkspace);
+}
+
+void exoScheduler::applyCoupling(exo_coupling &a_coupling)
+{
+    exo* leader = m_exos[a_coupling.p_leader];
+    exo* follower = m_exos[a_coupling.p_follower];
+
+    // take hand offset on first cycle of coupling
+    // NOTE: leader is already updated this cycle, follower still holds last cycle's state
+    if (!a_coupling.p_offsetSet) {
+        a_coupling.p_offset = follower->m_pos - leader->m_pos;
+        a_coupling.p_offsetSet = true;
+    }
+
+    // joint angles are measured relative to each arm's handedness, so
+    // equal joint angles give mirror-symmetric arms
+    switch (a_coupling.p_mode) {
+    case mirror:
+        follower->follow(leader->m_th, leader->m_thdot, joint);
+        break;
+    case parallel:
+        follower->follow(leader->m_pos + a_coupling.p_offset, leader->m_vel, task);
+        break;
+    default:
+        break;
+    }
+    if (DEBUG)  qDebug() << "exo" << a_coupling.p_follower << "following exo" << a_coupling.p_leader;
+}
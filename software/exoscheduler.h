@@ -0,0 +1,61 @@
+#ifndef EXOSCHEDULER_H
+#define EXOSCHEDULER_H
+
+#include "chai3d.h"
+#include "exo.h"
+#include <vector>
+
+// enumeration of couplings between exos (one arm's state sets the other's target)
+typedef enum
+{
+    mirror,    // follower's joint angles track leader's (mirror-symmetric arms, joint space)
+    parallel   // follower's hand tracks leader's hand displacement (both hands move together, task space)
+} coupling_modes;
+
+// coupling of one (following) exo to another (leading) exo
+typedef struct
+{
+    int p_leader;                 // index of leading exo
+    int p_follower;               // index of following exo
+    coupling_modes p_mode;        // type of coupling
+    chai3d::cVector3d p_offset;   // hand offset from leader to follower when coupled ('parallel' only) [m]
+    bool p_offsetSet;             // FALSE = offset still to be taken, in next servo cycle
+} exo_coupling;
+
+// runs several exos (each with own subject & channel map) in one deterministic servo
+// cycle on one thread: encoders of all exos are read together, grouped by board, then
+// all states/commands are computed, then all motors are written, grouped by board
+// NOTE: exos are updated in the order they were added, so a leader (added first)
+// ----  sets its follower's target in the same cycle, without inter-thread latency
+class exoScheduler
+{
+public:
+    exoScheduler();
+
+    int add(exo *a_exo);
+    int numExos() { return (int)m_exos.size(); }
+    exo* getExo(int a_index) { return m_exos[a_index]; }
+    bool couple(int a_leader, int a_follower, coupling_modes a_mode);
+    void uncouple(int a_follower);
+
+    bool connect();
+    bool disconnect();
+
+    // phases of one servo cycle (called in this order, see 'cycle')
+    void read();
+    void update();
+    bool command();
+    void write();
+    bool cycle();
+
+protected:
+    std::vector<exo*> m_exos;              // exos, in update order
+    std::vector<int> m_ioOrder;            // exo indices, grouped by board (for batched I/O)
+    std::vector<exo_coupling> m_couplings; // active couplings
+    chai3d::cMutex m_couplingLock;         // mutex for couplings (changed by GUI thread)
+    bool m_connected;                      // TRUE = 826 system opened & all exos connected
+
+    void applyCoupling(exo_coupling &a_coupling);
+};
+
+#endif // EXOSCHEDULER_H
@@ -0,0 +1,240 @@
+#include "expfsm.h"
+
+#define MIN_TO_SEC   60        // conversion factor between minutes and seconds
+
+using namespace std;
+
+
+expFsm::expFsm()
+{
+    m_state = welcome;
+    m_testQueue = NULL;
+    m_testComplete = false;
+    m_expComplete = false;
+    m_lockSignal = false;
+    m_breakTime = 0;
+    m_numTrials = 0;
+}
+
+void expFsm::step()
+{
+    switch (m_state) {
+
+    case welcome:
+
+        // wait for SPACE keypress
+        if (proceedRequested()) m_state = locking;
+        break;
+
+    case locking:
+
+        // only pause here if necessary to (manually) lock or unlock joint(s)
+        if (m_lockSignal) {
+            if (proceedRequested()) m_lockSignal = false;
+        } else {
+            sendToGround();
+            startTimer(WAIT_TIME);
+            m_state = resetting;
+        }
+        break;
+
+    case resetting:
+
+        // wait until exo reaches position for visual grounding
+        if (timerExpired() && reachedTarg()) {
+            startTimer(GROUND_TIME);
+            m_state = grounding;
+        }
+
+        // skip upcoming trial
+        else if (skipRequested()) m_state = prepForNextTrial();
+        break;
+
+    case grounding:
+
+        // wait for timer to expire until sending to start for next trial
+        if (timerExpired()) {
+            sendToStart();
+            m_state = setting;
+        }
+
+        // skip upcoming trial
+        else if (skipRequested()) m_state = prepForNextTrial();
+        break;
+
+    case setting:
+
+        // wait until exo reaches start position
+        if (reachedTarg()) {
+            startTrialControl();
+            startResponse();
+            m_state = waitingForResponse;
+        }
+
+        // skip upcoming trial
+        else if (skipRequested()) m_state = prepForNextTrial();
+        break;
+
+    case waitingForResponse:
+
+        // check for (and record) response and prep for next trial
+        if (responded()) {
+            recordResponse();
+            m_state = prepForNextTrial();
+        }
+        break;
+
+    case breaking:
+
+        // wait until break is over (skip with 'S')
+        if (skipRequested() || timerExpired()) m_state = locking;
+        break;
+
+    case thanks:
+        break;
+
+    default:
+        break;
+    }
+}
+
+void expFsm::updateTestParams()
+{
+    // check for end of experiment
+    if (m_testQueue == NULL || m_testQueue->empty()) {
+        m_expComplete = true;
+        return;
+    }
+
+    // pull next set of test parameters & its queue of trials
+    m_testPrev = m_test;
+    m_test = m_testQueue->front();
+    m_testQueue->pop();
+    m_trialsCurr = getTrials(m_test);
+}
+
+void expFsm::updateTrialParams()
+{
+    // check for end of test (or beginning of experiment)
+    if (m_trialsCurr.empty()) {
+        m_testComplete = true;
+        updateTestParams();
+    }
+
+    // unless end of experiment, pull next set of trial parameters
+    if (!m_expComplete) {
+        m_trialPrev = m_trial;
+        m_trial = m_trialsCurr.front();
+        m_trialsCurr.pop();
+        if (m_testComplete) prepForTest();
+    }
+
+    // no need for break at beginning of experiment
+    if (m_state == welcome) m_testComplete = false;
+}
+
+void expFsm::prepForTest()
+{
+    // initialize parameters for new test
+    switch (m_test.p_type) {
+    case staircase:
+        m_stair.m_stairStatus = 2;  // testing new joint
+        m_stair.reset(m_trial);
+        break;
+    case match1D:
+    case match2D:
+        m_numTrials = 0;
+        break;
+    default:
+        break;
+    }
+}
+
+exp_states expFsm::prepForNextTrial()
+{
+    // update test variables & trial parameters
+    switch (m_test.p_type) {
+    case staircase: {
+        int curr = m_stair.m_currStaircase;
+        int numDone = m_stair.m_numStaircases;
+        m_stair.update(m_trial);
+        if (m_stair.m_numStaircases > numDone) staircaseComplete(curr);
+        switch (m_stair.m_stairStatus) {
+        case 1:
+            m_stair.reset(m_trial);
+            break;
+        case 2:
+            staircaseSetComplete();
+            updateTrialParams();        // get parameters for first trial of coming test
+            if (!m_testComplete)        // moving to a new angle for the current joint
+                m_stair.reset(m_trial);  // reset is done automatically when switching to new joint
+            break;
+        default:
+            break;
+        }
+        break;
+    }
+    case match1D:
+    case match2D:
+        if (m_trialsCurr.empty()) matchesComplete();
+        updateTrialParams();
+        m_numTrials++;
+        if (!m_testComplete) prepForMatch();
+        break;
+    default:
+        break;
+    }
+
+    // assign next experiment state (default = 'breaking')
+    if (m_expComplete) return thanks;
+
+    switch (m_test.p_type) {
+    case staircase:
+
+        // continuing with current (double) staircase
+        if (!m_stair.m_stairStatus) {
+            startResponse();
+            return waitingForResponse;
+        }
+
+        // visually ground (but no break) between staircases and joint angles
+        else if (m_stair.m_stairStatus == 1 || (m_stair.m_stairStatus == 2 && !m_testComplete))
+            return locking;
+
+        // break between joints
+        else {
+            m_breakTime = SHORT_BREAK;
+            m_testComplete = false;
+        }
+        break;
+
+    case match1D:
+
+        if (m_testComplete) {
+            if (m_test.p_type != m_testPrev.p_type ||
+                m_test.p_active != m_testPrev.p_active ||
+                m_test.p_vision != m_testPrev.p_vision)
+                    m_breakTime = LONG_BREAK;
+            else    m_breakTime = SHORT_BREAK;  // between joints
+            m_testComplete = false;
+        } else  return locking;
+        break;
+
+    case match2D:
+
+        if (m_testComplete) {
+            m_breakTime = LONG_BREAK;
+            m_testComplete = false;
+        } else if (breakMidTest()) {
+            m_breakTime = SHORT_BREAK;
+        } else  return locking;
+        break;
+
+    default:
+        break;
+    }
+
+    // by default, send to break with time set above
+    startTimer(m_breakTime*MIN_TO_SEC);
+    return breaking;
+}
@@ -0,0 +1,64 @@
+#ifndef EXPFSM_H
+#define EXPFSM_H
+
+#include "expparams.h"
+#include "stairtracker.h"
+#include <queue>
+
+// finite state machine sequencing the tests & trials of an experiment, shared by
+// 'expWidget' (real exo, wall-clock time) and 'simSession' (simulated exo, virtual
+// time) so that both always run the same protocol
+// NOTE: independent of Qt & CHAI3D; moving the exo, timing, user input and
+// ----  recording of responses are left to the derived class
+class expFsm
+{
+public:
+    expFsm();
+    virtual ~expFsm() {}
+
+    void step();
+
+protected:
+    exp_states m_state;                        // current experiment state
+    std::queue<test_params> *m_testQueue;      // pointer to FIFO list of tests (owned by derived class/its parent)
+    test_params m_test;                        // parameters for current test
+    test_params m_testPrev;                    // parameters for previous test
+    trial_params m_trial;                      // parameters for current trial
+    trial_params m_trialPrev;                  // parameters for previous trial
+    std::queue<trial_params> m_trialsCurr;     // queue of trials for current test
+    bool m_testComplete;                       // TRUE = all trials of given test type are complete
+    bool m_expComplete;                        // TRUE = all tests are complete
+    bool m_lockSignal;                         // TRUE = experimenter must MANUALLY (un)lock joint(s)
+    int m_breakTime;                           // break time [min]
+    stairTracker m_stair;                      // state of (double) staircase for current joint & test angle
+    int m_numTrials;                           // number of matching trials performed for given test
+
+    // test & trial sequencing
+    void updateTestParams();
+    void updateTrialParams();
+    virtual void prepForTest();
+    exp_states prepForNextTrial();
+
+    // protocol details left to derived class
+    virtual std::queue<trial_params> getTrials(const test_params &a_test) = 0;  // trials for a newly pulled test
+    virtual void prepForMatch() {}                                              // reset subject's response for next matching trial
+    virtual bool breakMidTest() { return false; }                               // TRUE = short break partway through 2-D matching test
+    virtual void staircaseComplete(int /*a_staircase*/) {}                      // a (single) staircase just finished
+    virtual void staircaseSetComplete() {}                                      // all staircases for a test angle just finished
+    virtual void matchesComplete() {}                                           // all matching trials of current test just finished
+
+    // exo, timing & user input
+    virtual bool reachedTarg() = 0;            // TRUE = exo has settled at its target
+    virtual void sendToGround() = 0;
+    virtual void sendToStart() = 0;
+    virtual void startTrialControl() {}
+    virtual void startResponse() = 0;          // start timing subject's response for current trial
+    virtual bool responded() = 0;              // TRUE = current trial complete (or timed out)
+    virtual void recordResponse() = 0;
+    virtual void startTimer(double a_period) = 0;
+    virtual bool timerExpired() = 0;
+    virtual bool proceedRequested() = 0;       // TRUE = experimenter/subject asked to continue (SPACE)
+    virtual bool skipRequested() = 0;          // TRUE = experimenter asked to skip ahead ('S')
+};
+
+#endif // EXPFSM_H
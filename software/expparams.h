@@ -0,0 +1,55 @@
+#ifndef EXPPARAMS_H
+#define EXPPARAMS_H
+
+#include "subject.h"
+#include <cmath>
+
+#define WAIT_TIME    2         // time to wait for exoskeleton to reset for grounding [sec]
+#define GROUND_TIME  3         // time to display arm location for visual grounding (preventing proprioceptive drift) [sec]
+#define SHORT_BREAK  1         // duration of short break [min]
+#define LONG_BREAK   2         // duration of long break [min]
+#define CNTDWN       0         // 1 = trial time limited by countdown timer
+
+// enumeration of experiment states in FSM
+typedef enum
+{
+    welcome,
+    locking,
+    pause,
+    resetting,
+    grounding,
+    setting,
+    waitingForResponse,
+    breaking,
+    thanks
+} exp_states;
+
+// enumeration of test types
+typedef enum
+{
+    staircase,
+    match1D,
+    match2D,
+    NUM_TESTS
+} test_types;
+
+// structure capturing all attributes of a test
+typedef struct
+{
+    test_types p_type;    // type of test
+    joints p_joint;       // joint(s) being tested
+    bool p_active;        // movement condition (TRUE = active, FALSE = passive)
+    bool p_vision;        // vision condition (TRUE = provided, FALSE = blind)
+    int p_time;           // time allotted for trials (soft limit for staircase trials) [sec]
+    double p_lock = NAN;  // if 1-D test, angle at which untested joint is "locked" (NAN if 2-D test) [deg]
+} test_params;
+
+// structure capturing attributes of a trial
+typedef struct
+{
+    double p_ref;               // reference/starting joint angle (if 1-D test) or circular reach angle (if 2-D test) [deg]
+    double p_targ;              // comparison/target joint angle (if 1-D test) or circular reach angle (if 2-D test) [deg]
+    bool p_isPractice = false;  // default = non-practice
+} trial_params;
+
+#endif // EXPPARAMS_H
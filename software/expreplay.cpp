@@ -0,0 +1,218 @@
+#include "expreplay.h"
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <cmath>
+#include <fstream>
+#include <sstream>
+
+#define CM_TO_METERS 0.01      // conversion factor between centimeters and meters, same as 'expWidget'
+#define NUM_COMMON   11        // number of leading columns written for every test type (completion flags & kinematics)
+
+using namespace std;
+using namespace chai3d;
+
+expReplay::expReplay(replay_params a_params)
+{
+    m_params = a_params;
+    m_scene = new expScene();
+    m_scene->m_world->setUsePrimitiveBatching(m_params.p_batchPrimitives);
+    m_buffer = cFrameBuffer::create();
+    m_rendering = false;
+    m_failed = 0;
+}
+
+expReplay::~expReplay()
+{
+    delete m_scene;
+}
+
+bool expReplay::load(std::string a_filename)
+{
+    ifstream file(a_filename);
+    if (!file.is_open()) return false;
+
+    m_samples.clear();
+    test_types type = NUM_TESTS;  // no data block yet
+    string line;
+    while (getline(file, line)) {
+        if (!line.empty() && line.back() == '\r') line.pop_back();
+        if (line.empty()) continue;
+
+        // subject parameters (only those needed to draw the arm)
+        // NOTE: a file may hold several sessions, so keep the latest header
+        double L;
+        if      (line == "Hand: R")                                        m_subj.m_rightHanded = true;
+        else if (line == "Hand: L")                                        m_subj.m_rightHanded = false;
+        else if (sscanf(line.c_str(), "Upperarm Length: %lf m", &L) == 1)  m_subj.m_Lupper = L;
+        else if (sscanf(line.c_str(), "Forearm Length: %lf m", &L) == 1)   m_subj.m_LtoEE = L;
+
+        // start of data block for one test type
+        // NOTE: subject header precedes data, so scene (reach center) is set for decoding 2-D targets
+        else if (line == "Staircase Data" || line == "1-D Matching Data" || line == "2-D Matching Data") {
+            if      (line == "Staircase Data")     type = staircase;
+            else if (line == "1-D Matching Data")  type = match1D;
+            else                                   type = match2D;
+            m_scene->setSubject(m_subj);
+        }
+
+        // data row (column titles & banners are skipped)
+        else if (type != NUM_TESTS && isdigit((unsigned char)line[0])) {
+            vector<double> cols;
+            stringstream ss(line);
+            string col;
+            while (getline(ss, col, ',')) cols.push_back(atof(col.c_str()));
+            parseData(type, cols);
+        }
+    }
+    return !m_samples.empty();
+}
+
+void expReplay::parseData(test_types a_type, const std::vector<double> &a_cols)
+{
+    // check for truncated rows (e.g. file still being written)
+    size_t numCols = NUM_COMMON + 1;
+    switch (a_type) {
+    case staircase:  numCols += 7;  break;
+    case match1D:    numCols += 7;  break;
+    case match2D:    numCols += 9;  break;
+    default:         return;
+    }
+    if (a_cols.size() < numCols) return;
+
+    // kinematic data & experiment state common to all tests
+    // NOTE: only non-practice trials are recorded, and only while waiting for the response
+    replay_sample sample;
+    sample.d_time = a_cols[2];
+    scene_state &s = sample.d_scene;
+    s.p_state = waitingForResponse;
+    s.p_th = cVector3d(a_cols[3], a_cols[4], 0.0)*(PI/180);
+    s.p_test.p_type = a_type;
+    s.p_test.p_joint = both;
+    s.p_test.p_active = false;
+    s.p_test.p_vision = false;
+    s.p_test.p_time = 0;
+    s.p_trial.p_isPractice = false;
+    const double *c = &a_cols[NUM_COMMON + 1];
+
+    switch (a_type) {
+    case staircase:
+        // NOTE: reversals are not recorded, so that label reads 0 in replays
+        s.p_test.p_joint = (joints)(int)c[0];
+        s.p_currStaircase = (int)c[1];
+        s.p_numJudgements = (int)c[2];
+        s.p_trial.p_targ = c[3];
+        s.p_trial.p_ref = c[4];
+        break;
+    case match1D:
+        s.p_test.p_joint = (joints)(int)c[0];
+        s.p_test.p_active = c[1] != 0;
+        s.p_test.p_vision = c[2] != 0;
+        s.p_numTrials = (int)c[3];
+        s.p_trial.p_targ = c[4];
+        s.p_trial.p_ref = c[5];
+        s.p_subjAng = c[6];
+        break;
+    case match2D: {
+        // positions are recorded [m]; recover target (coded as angle on circle) from reach center
+        s.p_test.p_active = c[0] != 0;
+        s.p_test.p_vision = c[1] != 0;
+        s.p_numTrials = (int)c[2];
+        cVector3d center = m_scene->m_center*CM_TO_METERS;
+        s.p_trial.p_targ = atan2(c[4] - center(1), c[3] - center(0))*(180/PI);
+        if (s.p_trial.p_targ < 0) s.p_trial.p_targ += 360;
+        s.p_trial.p_ref = -1;
+        s.p_subjPos = cVector3d(c[7], c[8], 0.0)/CM_TO_METERS;
+        break;
+    }
+    default:
+        break;
+    }
+    m_samples.push_back(sample);
+}
+
+int expReplay::render(std::string a_dir)
+{
+    if (m_samples.empty()) return -1;
+
+    // set up scene & offscreen framebuffer
+    m_scene->setSubject(m_subj);
+    m_buffer->setup(m_scene->m_camera, m_params.p_width, m_params.p_height, true, false);
+
+    // start encoder threads
+    int numThreads = m_params.p_threads;
+    if (numThreads < 1) numThreads = max(1, (int)thread::hardware_concurrency() - 1);  // leave one core for rendering
+    m_rendering = true;
+    m_failed = 0;
+    vector<thread> workers;
+    for (int i = 0; i < numThreads; i++) workers.push_back(thread(&expReplay::encodeThread, this, a_dir));
+
+    // render each sample for as many frames as it covers in (collapsed) session time
+    // NOTE: rounding the cumulative time keeps the video paced without drift
+    double tVideo = 0.0;
+    int numFrames = 0;
+    for (size_t i = 0; i < m_samples.size(); i++) {
+        double dt = 1.0/m_params.p_fps;
+        if (i+1 < m_samples.size()) dt = m_samples[i+1].d_time - m_samples[i].d_time;
+        if (dt < 0 || dt > m_params.p_maxHold) dt = m_params.p_maxHold;  // gap between trials/tests, or new session
+        tVideo += dt;
+        int frameEnd = (int)round(tVideo*m_params.p_fps);
+        if (frameEnd <= numFrames) continue;  // sample too brief to be seen
+
+        m_scene->update(m_samples[i].d_scene, m_params.p_width, m_params.p_height);
+        m_buffer->renderView();
+        replay_frame frame;
+        frame.d_image = cImage::create();
+        m_buffer->copyImageBuffer(frame.d_image);
+
+        // held samples share one image
+        for (; numFrames < frameEnd; numFrames++) {
+            frame.d_index = numFrames;
+            pushFrame(frame);
+        }
+    }
+
+    // wait for encoders to finish
+    {
+        lock_guard<mutex> lock(m_queueLock);
+        m_rendering = false;
+    }
+    m_queueCond.notify_all();
+    for (size_t i = 0; i < workers.size(); i++) workers[i].join();
+
+    if (m_failed > 0) return -1;
+    return numFrames;
+}
+
+void expReplay::pushFrame(replay_frame a_frame)
+{
+    // block while encoders are behind, bounding memory use
+    unique_lock<mutex> lock(m_queueLock);
+    m_queueCond.wait(lock, [this]{ return (int)m_queue.size() < m_params.p_queueLen; });
+    m_queue.push(a_frame);
+    lock.unlock();
+    m_queueCond.notify_all();
+}
+
+void expReplay::encodeThread(std::string a_dir)
+{
+    while (true) {
+        replay_frame frame;
+        {
+            unique_lock<mutex> lock(m_queueLock);
+            m_queueCond.wait(lock, [this]{ return !m_queue.empty() || !m_rendering; });
+            if (m_queue.empty()) return;  // done rendering & nothing left to encode
+            frame = m_queue.front();
+            m_queue.pop();
+        }
+        m_queueCond.notify_all();
+
+        // compress & write frame
+        char filename[32];
+        sprintf(filename, "/frame_%06d.png", frame.d_index);
+        if (!frame.d_image->saveToFile(a_dir + filename)) {
+            lock_guard<mutex> lock(m_queueLock);
+            m_failed++;
+        }
+    }
+}
@@ -0,0 +1,71 @@
+#ifndef EXPREPLAY_H
+#define EXPREPLAY_H
+
+#include "chai3d.h"
+#include "expscene.h"
+#include "subject.h"
+#include <string>
+#include <vector>
+#include <queue>
+#include <thread>
+#include <mutex>
+#include <condition_variable>
+
+// parameters of a replay (output video format & pacing)
+typedef struct
+{
+    int p_width = 1280;      // width of rendered frames [pixels]
+    int p_height = 720;      // height of rendered frames [pixels]
+    double p_fps = 30;       // frame rate of output video [frames/sec]
+    double p_maxHold = 1.0;  // longest time one recorded sample is held onscreen, collapsing gaps between trials & tests [sec]
+    int p_threads = 0;       // number of encoder threads (0 = all cores)
+    int p_queueLen = 64;     // maximum number of rendered frames waiting to be encoded
+    bool p_batchPrimitives = false;  // TRUE = draw joint spheres & segment cylinders by instancing
+} replay_params;
+
+// one recorded sample of a session, as written by 'expWidget::recordData'
+typedef struct
+{
+    double d_time;           // time of sample [sec]
+    scene_state d_scene;     // state of scene at time of sample
+} replay_sample;
+
+// frame rendered but not yet encoded
+typedef struct
+{
+    int d_index;             // index of frame in output video
+    chai3d::cImagePtr d_image;
+} replay_frame;
+
+// replays recorded kinematics through the experiment scene, rendering offscreen
+// and encoding frames (PNG) on worker threads for assembly into a review video
+// NOTE: the caller must make an OpenGL context current before calling 'render'
+class expReplay
+{
+public:
+    replay_params m_params;                  // output format & pacing
+    subject m_subj;                          // subject parameters, read from data file
+    std::vector<replay_sample> m_samples;    // recorded samples, in file order
+
+    expReplay(replay_params a_params = replay_params());
+    virtual ~expReplay();
+
+    bool load(std::string a_filename);
+    int render(std::string a_dir);
+
+protected:
+    expScene* m_scene;                       // same scene shown to subject during experiment
+    chai3d::cFrameBufferPtr m_buffer;        // offscreen framebuffer
+
+    std::queue<replay_frame> m_queue;        // frames waiting to be encoded
+    std::mutex m_queueLock;                  // mutex for frame queue
+    std::condition_variable m_queueCond;     // signals frame pushed/popped
+    bool m_rendering;                        // TRUE = render thread is still pushing frames
+    int m_failed;                            // number of frames that could not be written
+
+    void parseData(test_types a_type, const std::vector<double> &a_cols);
+    void pushFrame(replay_frame a_frame);
+    void encodeThread(std::string a_dir);
+};
+
+#endif // EXPREPLAY_H
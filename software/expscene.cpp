@@ -0,0 +1,709 @@
+#include "expscene.h"
+
+#define CAM_X_RIGHT  0.04      // x-coordinate of camera for all tests with right hand (to be shifted in x for left-handed tests, for RIGHT = 0.0590 / for LEFT = 0.0372) [m]
+#define CAM_Y        0.365     // y-coordinate of camera [m]
+#define CAM_Z        1.0       // z-coordinate of camera (aka. height above scene) [m]
+#define MIRROR       1         // 1 = graphics are mirrored in display
+#define D_PARALLAX   0.09      // distance of arm below graphics plane [m]
+#define D_TO_EYES    0.07      // distance of eyes in front of shoulder [m]
+#define D_TV_EXO_R   0.129     // x-distance from right edge of TV display to corner of exo opposite main axis, when exo configured for right-hand testing [m]
+#define D_TV_EXO_L   0.111     // x-distance from left edge of TV display to corner of exo opposite main axis, when exo configured for left-hand testing [m]
+#define W_SCREEN     1.022     // screen width (used for setting orthographic view)
+#define W_TV         1.049     // width of TV display [m]
+#define W_EXO        0.441     // distance between exo's main axis and corner of exo opposite main axis [m]
+#define R_JOINT      0.04      // radius of spheres representing joints [m]
+#define R_SEGMENT    0.02      // radius of cylinders representing upper/forearm [m]
+#define H_SEGMENT    0.5       // default height of cylinders representing upper/forearm [m]
+#define H_INF        10        // "infinity" (cylinder height) for 1-D tests where end of segment should not be visible [m]
+#define L_SCALE      0.9606    // scaling factor for graphics, to enable matching between real & virtual worlds (prior to parallax correction)
+#define L_RELRAD     0.9       // scaling factor between exoskeleton joint/segment & test target radii
+#define ALPH_GHOST   0.5       // alpha value for exoskeleton components
+#define CENTER_X     3.5       // x-coordinate of reach center for right hand (negative for left hand) [cm]
+#define CENTER_Y     34.5      // y-coordinate of reach center [cm]
+#define CM_TO_METERS 0.01      // conversion factor between centimeters and meters
+#define DEBUG        0
+
+using namespace std;
+using namespace chai3d;
+
+expScene::expScene()
+{
+    m_rightHanded = true;
+    m_Lupper = 0.0;
+    m_LtoEE = 0.0;
+    m_valid = false;
+    m_lastWidth = 0;
+    m_lastHeight = 0;
+
+    // create new CHAI world
+    m_world = new cWorld();
+    m_world->m_backgroundColor.setWhiteSmoke();
+    m_world->setUseRenderQueue(true);        // skip objects outside the view, group draws by render state
+
+    // create camera to view world
+    m_camera = new cCamera(m_world);
+    m_camera->setClippingPlanes(0.01,20.0);
+    m_camera->setOrthographicView(W_SCREEN);
+    if (MIRROR) m_camera->setMirrorHorizontal(true);
+    m_world->addChild(m_camera);
+
+    // attach light source to camera for illumination
+    m_light = new cDirectionalLight(m_world);
+    m_light->setEnabled(true);
+    m_camera->addChild(m_light);
+
+    // add graphic elements for experiment, scaled relative to exoskeleton joints/segments
+    m_angle = new cShapeCylinder(L_RELRAD*R_SEGMENT, L_RELRAD*R_SEGMENT, H_INF);
+    m_target = new cShapeSphere(L_RELRAD*R_JOINT);
+    m_angle->m_material->setGreenLime();
+    m_target->m_material->setGreenLime();
+    m_world->addChild(m_angle);
+    m_world->addChild(m_target);
+
+    // add exoskeleton segments as (slightly) transparent cylinders
+    m_upperarm = new cShapeCylinder(R_SEGMENT, R_SEGMENT, H_SEGMENT);
+    m_forearm = new cShapeCylinder(R_SEGMENT, R_SEGMENT, H_SEGMENT);
+    m_upperarmL = new cShapeCylinder(R_SEGMENT, R_SEGMENT, H_INF);
+    m_forearmL = new cShapeCylinder(R_SEGMENT, R_SEGMENT, H_INF);
+    m_upperarm->m_material->setGrayLight();
+    m_forearm->m_material->setGrayLight();
+    m_upperarmL->m_material->setGrayLight();
+    m_forearmL->m_material->setGrayLight();
+    m_upperarm->setTransparencyLevel((float)ALPH_GHOST);
+    m_forearm->setTransparencyLevel((float)ALPH_GHOST);
+    m_upperarmL->setTransparencyLevel((float)ALPH_GHOST);
+    m_forearmL->setTransparencyLevel((float)ALPH_GHOST);
+    m_world->addChild(m_upperarm);
+    m_world->addChild(m_forearm);
+    m_world->addChild(m_upperarmL);
+    m_world->addChild(m_forearmL);
+
+    // add exoskeleton joints as (slightly) transparent spheres
+    m_shoulder = new cShapeSphere(R_JOINT);
+    m_elbow = new cShapeSphere(R_JOINT);
+    m_hand = new cShapeSphere(R_JOINT);
+    m_shoulder->m_material->setBlack();
+    m_elbow->m_material->setBlack();
+    m_hand->m_material->setBlack();
+    m_shoulder->setTransparencyLevel((float)ALPH_GHOST);
+    m_elbow->setTransparencyLevel((float)ALPH_GHOST);
+    m_hand->setTransparencyLevel((float)ALPH_GHOST);
+    m_world->addChild(m_shoulder);
+    m_world->addChild(m_elbow);
+    m_world->addChild(m_hand);
+
+    // add labels to background
+    cFont* fontSm = NEW_CFONTCALIBRI20();
+    cFont* fontMd = NEW_CFONTCALIBRI40();
+    cFont* fontLg = NEW_CFONTCALIBRI72();
+    cFont* fontHg = NEW_CFONTCALIBRI144();
+    m_instruct = new cLabel(fontLg);
+    m_note = new cLabel(fontSm);
+    m_remind = new cLabel(fontLg);
+    m_labelPractice = new cLabel(fontHg);
+    m_labelCntdwn = new cLabel(fontHg);
+    m_labelTestType = new cLabel(fontSm);
+    m_labelJoint = new cLabel(fontSm);
+    m_labelActive = new cLabel(fontSm);
+    m_labelVision = new cLabel(fontSm);
+    m_labelNumJudge = new cLabel(fontSm);
+    m_labelNumRev = new cLabel(fontSm);
+    m_labelNumStair = new cLabel(fontSm);
+    m_labelNumTrial = new cLabel(fontSm);
+    m_labelCntdwn->setFontScale(2.0);  // 2x bigger
+    m_instruct->m_fontColor.setBlack();
+    m_note->m_fontColor.setGray();
+    m_remind->m_fontColor.setRed();
+    m_labelPractice->m_fontColor.setRed();
+    m_labelCntdwn->m_fontColor.setRed();
+    m_labelTestType->m_fontColor.setBlack();
+    m_labelJoint->m_fontColor.setBlack();
+    m_labelActive->m_fontColor.setBlack();
+    m_labelVision->m_fontColor.setBlack();
+    m_labelNumJudge->m_fontColor.setBlack();
+    m_labelNumRev->m_fontColor.setBlack();
+    m_labelNumStair->m_fontColor.setBlack();
+    m_labelNumTrial->m_fontColor.setBlack();
+    m_camera->m_backLayer->setUseTextBatching(true);  // draw all labels sharing a font in one call, re-uploaded only on change
+    m_camera->m_backLayer->addChild(m_instruct);
+    m_camera->m_backLayer->addChild(m_note);
+    m_camera->m_backLayer->addChild(m_remind);
+    m_camera->m_backLayer->addChild(m_labelPractice);
+    m_camera->m_backLayer->addChild(m_labelCntdwn);
+    m_camera->m_backLayer->addChild(m_labelTestType);
+    m_camera->m_backLayer->addChild(m_labelJoint);
+    m_camera->m_backLayer->addChild(m_labelActive);
+    m_camera->m_backLayer->addChild(m_labelVision);
+    m_camera->m_backLayer->addChild(m_labelNumJudge);
+    m_camera->m_backLayer->addChild(m_labelNumRev);
+    m_camera->m_backLayer->addChild(m_labelNumStair);
+    m_camera->m_backLayer->addChild(m_labelNumTrial);
+}
+
+expScene::~expScene()
+{
+    // delete CHAI world
+    delete m_world;
+}
+
+void expScene::setSubject(const subject &a_subj)
+{
+    // store subject dimensions used when drawing the arm
+    m_rightHanded = a_subj.m_rightHanded;
+    m_Lupper = a_subj.m_Lupper;
+    m_LtoEE = a_subj.m_LtoEE;
+    m_valid = false;  // redraw everything for new subject
+
+    // set graphical scaling parameters (correcting for parallax, if necessary)
+    if (CORR_PARALL) {
+        m_scalePoint = cVector3d(0.508*a_subj.m_Llower,D_TO_EYES,0.0)*L_SCALE;
+        m_scaleFactor = (1.0 - D_PARALLAX/(0.717*a_subj.m_Llower))*L_SCALE;
+    } else {
+        m_scalePoint = cVector3d(0.0,0.0,0.0);
+        m_scaleFactor = L_SCALE;
+    }
+
+    // scale graphics to match subject's arm
+    m_shldOff = cVector3d(0.0,0.0,0.0);
+    m_upperarm->setHeight(m_Lupper*m_scaleFactor);
+    m_forearm->setHeight(m_LtoEE*m_scaleFactor);
+
+    // adjust for subject handedness
+    if (m_rightHanded) {
+        m_center = cVector3d(CENTER_X,CENTER_Y,0.0);
+        m_camX = CAM_X_RIGHT;
+    } else {
+        m_center = cVector3d(-1*CENTER_X,CENTER_Y,0.0);
+        double d_btwn = W_TV - 2*W_EXO - D_TV_EXO_R - D_TV_EXO_L;
+        m_camX = CAM_X_RIGHT + d_btwn;  // shift by distance between main axis in right- and left-handed configurations
+    }
+
+    // set up camera for graphics viewing
+    m_camPos = cVector3d(m_camX,CAM_Y,CAM_Z);
+    m_camLookAt = m_camPos - cVector3d(0.0,0.0,CAM_Z);  // directly below camera
+    m_camUp = cVector3d(0.0,1.0,0.0);
+    m_camera->set(m_camPos, m_camLookAt, m_camUp);
+}
+
+void expScene::update(const scene_state &a_state, int a_width, int a_height)
+{
+    // only push changes into the scene, since label layout is costly
+    bool graphicsDirty = !m_valid || !sameGraphics(a_state, m_last);
+    bool labelsDirty = !m_valid || !sameLabels(a_state, m_last) ||
+                       a_width != m_lastWidth || a_height != m_lastHeight;
+    if (graphicsDirty) updateGraphics(a_state);
+    if (labelsDirty)   updateLabels(a_state, a_width, a_height);
+
+    // retain state for comparison on next update
+    m_last = a_state;
+    m_lastWidth = a_width;
+    m_lastHeight = a_height;
+    m_valid = true;
+}
+
+void expScene::invalidate()
+{
+    m_valid = false;
+}
+
+void expScene::render(int a_width, int a_height)
+{
+    m_camera->renderView(a_width, a_height);
+}
+
+chai3d::cVector3d expScene::angleToTarg(double ang)
+{
+    double xTarg = REACH_DIST*cos(ang*PI/180) + m_center(0);
+    double yTarg = REACH_DIST*sin(ang*PI/180) + m_center(1);
+    return cVector3d(xTarg, yTarg, 0.0);
+}
+
+bool expScene::sameTest(const test_params &a_test1, const test_params &a_test2)
+{
+    // NOTE: 'p_lock' is NAN for 2-D tests, so compare NANs as equal
+    bool sameLock = (a_test1.p_lock == a_test2.p_lock) || (std::isnan(a_test1.p_lock) && std::isnan(a_test2.p_lock));
+    return a_test1.p_type == a_test2.p_type && a_test1.p_joint == a_test2.p_joint &&
+           a_test1.p_active == a_test2.p_active && a_test1.p_vision == a_test2.p_vision &&
+           a_test1.p_time == a_test2.p_time && sameLock;
+}
+
+bool expScene::sameGraphics(const scene_state &a_state1, const scene_state &a_state2)
+{
+    return a_state1.p_state == a_state2.p_state && sameTest(a_state1.p_test, a_state2.p_test) &&
+           a_state1.p_trial.p_ref == a_state2.p_trial.p_ref && a_state1.p_trial.p_targ == a_state2.p_trial.p_targ &&
+           a_state1.p_th.equals(a_state2.p_th) && a_state1.p_subjAng == a_state2.p_subjAng &&
+           a_state1.p_subjPos.equals(a_state2.p_subjPos);
+}
+
+bool expScene::sameLabels(const scene_state &a_state1, const scene_state &a_state2)
+{
+    return a_state1.p_state == a_state2.p_state && sameTest(a_state1.p_test, a_state2.p_test) &&
+           a_state1.p_trial.p_isPractice == a_state2.p_trial.p_isPractice &&
+           a_state1.p_lockSignal == a_state2.p_lockSignal &&
+           a_state1.p_lockedJnts[S] == a_state2.p_lockedJnts[S] && a_state1.p_lockedJnts[E] == a_state2.p_lockedJnts[E] &&
+           a_state1.p_currStaircase == a_state2.p_currStaircase && a_state1.p_numJudgements == a_state2.p_numJudgements &&
+           a_state1.p_numReversals == a_state2.p_numReversals && a_state1.p_numTrials == a_state2.p_numTrials &&
+           a_state1.p_timeRemaining == a_state2.p_timeRemaining && a_state1.p_breakTime == a_state2.p_breakTime;
+}
+
+void expScene::setLabelText(chai3d::cLabel* a_label, const std::string &a_text)
+{
+    // re-layout label only if text has changed
+    if (a_label->getText() != a_text) a_label->setText(a_text);
+}
+
+void expScene::hideTestStateLabels()
+{
+    m_labelPractice->setShowEnabled(false);
+    m_labelCntdwn->setShowEnabled(false);
+    m_labelTestType->setShowEnabled(false);
+    m_labelJoint->setShowEnabled(false);
+    m_labelActive->setShowEnabled(false);
+    m_labelVision->setShowEnabled(false);
+    m_labelNumStair->setShowEnabled(false);
+    m_labelNumJudge->setShowEnabled(false);
+    m_labelNumRev->setShowEnabled(false);
+    m_labelNumTrial->setShowEnabled(false);
+}
+
+
+void expScene::updateGraphics(const scene_state &a_state)
+{
+    // get subject kinematics
+    double L1 = m_Lupper*m_scaleFactor;
+    double L2 = m_LtoEE*m_scaleFactor;
+    double th1 = a_state.p_th(0);
+    double th2 = th1 + a_state.p_th(1);
+    if (!m_rightHanded) {
+        th1 = PI - th1;
+        th2 = PI - th2;
+    }
+
+    // update exoskeleton to match subject
+    m_shoulder->setLocalPos(m_scaleFactor*(m_shldOff - m_scalePoint/L_SCALE) + m_scalePoint);
+    m_elbow->setLocalPos(m_shoulder->getLocalPos() + cVector3d(L1*cos(th1), L1*sin(th1), 0.0));
+    m_hand->setLocalPos(m_elbow->getLocalPos() + cVector3d(L2*cos(th2), L2*sin(th2), 0.0));
+    m_upperarm->setLocalPos(m_shoulder->getLocalPos());
+    m_forearm->setLocalPos(m_elbow->getLocalPos());
+    m_upperarmL->setLocalPos(m_shoulder->getLocalPos());
+    m_forearmL->setLocalPos(m_elbow->getLocalPos());
+    m_upperarm->setLocalRot(cMatrix3d(th1, PI/2, 0.0, C_EULER_ORDER_ZYX));
+    m_forearm->setLocalRot(cMatrix3d(th2, PI/2, 0.0, C_EULER_ORDER_ZYX));
+    m_upperarmL->setLocalRot(cMatrix3d(th1, PI/2, 0.0, C_EULER_ORDER_ZYX));
+    m_forearmL->setLocalRot(cMatrix3d(th2, PI/2, 0.0, C_EULER_ORDER_ZYX));
+
+    switch (a_state.p_state) {
+
+    case welcome:
+    case locking:
+    case resetting:
+    case setting:
+    case breaking:
+    case thanks:
+
+        // only show exo for debugging purposes
+        if (DEBUG) {
+            m_shoulder->setShowEnabled(true);
+            m_elbow->setShowEnabled(true);
+            m_hand->setShowEnabled(true);
+            m_upperarm->setShowEnabled(true);
+            m_forearm->setShowEnabled(true);
+        } else {
+            m_shoulder->setShowEnabled(false);
+            m_elbow->setShowEnabled(false);
+            m_hand->setShowEnabled(false);
+            m_upperarm->setShowEnabled(false);
+            m_forearm->setShowEnabled(false);
+        }
+        m_upperarmL->setShowEnabled(false);
+        m_forearmL->setShowEnabled(false);
+        m_angle->setShowEnabled(false);
+        m_target->setShowEnabled(false);
+        break;
+
+    case grounding:
+
+        // show current exo configuration to ground proprioception with vision
+        switch (a_state.p_test.p_type) {
+        case staircase:
+        case match1D:
+            if (a_state.p_test.p_joint == S) {
+                m_shoulder->setShowEnabled(true);
+                m_upperarmL->setShowEnabled(true);
+                m_elbow->setShowEnabled(false);
+                m_forearmL->setShowEnabled(false);
+            } else {
+                m_elbow->setShowEnabled(true);
+                m_forearmL->setShowEnabled(true);
+                m_shoulder->setShowEnabled(false);
+                m_upperarmL->setShowEnabled(false);
+            }
+            m_upperarm->setShowEnabled(false);
+            m_forearm->setShowEnabled(false);
+            m_hand->setShowEnabled(false);
+            break;
+        case match2D:
+            m_hand->setShowEnabled(true);
+            m_shoulder->setShowEnabled(false);
+            m_elbow->setShowEnabled(false);
+            m_upperarm->setShowEnabled(false);
+            m_forearm->setShowEnabled(false);
+            m_upperarmL->setShowEnabled(false);
+            m_forearmL->setShowEnabled(false);
+            break;
+        default:
+            m_shoulder->setShowEnabled(true);
+            m_elbow->setShowEnabled(true);
+            m_hand->setShowEnabled(true);
+            m_upperarm->setShowEnabled(true);
+            m_forearm->setShowEnabled(true);
+            m_upperarmL->setShowEnabled(false);
+            m_forearmL->setShowEnabled(false);
+            break;
+        }
+        m_angle->setShowEnabled(false);
+        m_target->setShowEnabled(false);
+        break;
+
+    case waitingForResponse:
+
+        switch (a_state.p_test.p_type) {
+
+        // show reference angle
+        case staircase:
+            double refAng;
+            if (a_state.p_test.p_joint == S) {
+                refAng = a_state.p_trial.p_ref*(PI/180);
+                m_angle->setLocalPos(m_shoulder->getLocalPos());
+                m_shoulder->setShowEnabled(true);
+                m_elbow->setShowEnabled(false);
+            } else {
+                if (m_rightHanded) refAng = th1 + a_state.p_trial.p_ref*(PI/180);
+                else                                                  refAng = (PI-th1) + a_state.p_trial.p_ref*(PI/180);
+                m_angle->setLocalPos(m_elbow->getLocalPos());
+                m_elbow->setShowEnabled(true);
+                m_shoulder->setShowEnabled(false);
+            }
+            if (!m_rightHanded) refAng = PI - refAng;
+            m_angle->setLocalRot(cMatrix3d(refAng, PI/2, 0.0, C_EULER_ORDER_ZYX));
+            m_angle->setShowEnabled(true);
+            m_upperarm->setShowEnabled(false);
+            m_forearm->setShowEnabled(false);
+            m_upperarmL->setShowEnabled(false);
+            m_forearmL->setShowEnabled(false);
+            m_hand->setShowEnabled(false);
+            m_target->setShowEnabled(false);
+            break;
+
+        case match1D:
+
+            // show goal joint/segment position
+            if (a_state.p_test.p_active) {
+                double targAng;
+                if (a_state.p_test.p_joint == S) {
+                    targAng = a_state.p_trial.p_targ*(PI/180);
+                    m_angle->setLocalPos(m_shoulder->getLocalPos());
+                    m_shoulder->setShowEnabled(true);
+                    m_elbow->setShowEnabled(false);
+                    m_forearmL->setShowEnabled(false);
+                    if (a_state.p_test.p_vision) m_upperarmL->setShowEnabled(true);
+                    else                 m_upperarmL->setShowEnabled(false);
+                } else {
+                    if (m_rightHanded) targAng = th1 + a_state.p_trial.p_targ*(PI/180);
+                    else                                                  targAng = (PI-th1) + a_state.p_trial.p_targ*(PI/180);
+                    m_angle->setLocalPos(m_elbow->getLocalPos());
+                    m_elbow->setShowEnabled(true);
+                    m_shoulder->setShowEnabled(false);
+                    m_upperarmL->setShowEnabled(false);
+                    if (a_state.p_test.p_vision) m_forearmL->setShowEnabled(true);
+                    else                 m_forearmL->setShowEnabled(false);
+                }
+                if (!m_rightHanded) targAng = PI - targAng;
+                m_angle->setLocalRot(cMatrix3d(targAng, PI/2, 0.0, C_EULER_ORDER_ZYX));
+            }
+
+            // show angle cursor
+            else {
+                double subjAng;
+                if (a_state.p_test.p_joint == S) {
+                    subjAng = a_state.p_subjAng*(PI/180);
+                    m_angle->setLocalPos(m_shoulder->getLocalPos());
+                    m_shoulder->setShowEnabled(true);
+                    m_elbow->setShowEnabled(false);
+                } else {
+                    if (m_rightHanded) subjAng = th1 + a_state.p_subjAng*(PI/180);
+                    else                                                  subjAng = (PI-th1) + a_state.p_subjAng*(PI/180);
+                    m_angle->setLocalPos(m_elbow->getLocalPos());
+                    m_elbow->setShowEnabled(true);
+                    m_shoulder->setShowEnabled(false);
+                }
+                if (!m_rightHanded) subjAng = PI - subjAng;
+                m_angle->setLocalRot(cMatrix3d(subjAng, PI/2, 0.0, C_EULER_ORDER_ZYX));
+                m_upperarmL->setShowEnabled(false);
+                m_forearmL->setShowEnabled(false);
+            }
+            m_angle->setShowEnabled(true);
+            m_upperarm->setShowEnabled(false);
+            m_forearm->setShowEnabled(false);
+            m_hand->setShowEnabled(false);
+            m_target->setShowEnabled(false);
+            break;
+
+        case match2D:
+
+            // show goal hand position
+            if (a_state.p_test.p_active) {
+                m_target->setLocalPos(m_scaleFactor*(angleToTarg(a_state.p_trial.p_targ)*CM_TO_METERS - m_scalePoint/L_SCALE) + m_scalePoint);
+                if (a_state.p_test.p_vision) m_hand->setShowEnabled(true);
+                else                 m_hand->setShowEnabled(false);
+            }
+
+            // show position cursor
+            else {
+                m_target->setLocalPos(m_scaleFactor*(a_state.p_subjPos*CM_TO_METERS - m_scalePoint/L_SCALE) + m_scalePoint);
+                m_hand->setShowEnabled(false);
+            }
+            m_target->setShowEnabled(true);
+            m_shoulder->setShowEnabled(false);
+            m_elbow->setShowEnabled(false);
+            m_upperarm->setShowEnabled(false);
+            m_forearm->setShowEnabled(false);
+            m_upperarmL->setShowEnabled(false);
+            m_forearmL->setShowEnabled(false);
+            m_angle->setShowEnabled(false);
+            break;
+
+        default:
+            break;
+        }
+        break;
+
+    default:
+        m_shoulder->setShowEnabled(false);
+        m_elbow->setShowEnabled(false);
+        m_hand->setShowEnabled(false);
+        m_upperarm->setShowEnabled(false);
+        m_forearm->setShowEnabled(false);
+        m_upperarmL->setShowEnabled(false);
+        m_forearmL->setShowEnabled(false);
+        m_angle->setShowEnabled(false);
+        m_target->setShowEnabled(false);
+        break;
+    }
+}
+
+void expScene::updateLabels(const scene_state &a_state, int a_width, int a_height)
+{
+    // declare variables for label positioning
+    double longestWidth;
+    double stndrdHeight;
+
+    switch (a_state.p_state) {
+
+    case welcome:
+
+        setLabelText(m_instruct, "Welcome");
+        m_instruct->setLocalPos((int)((a_width - m_instruct->getWidth())/2),
+                                (int)((a_height - m_instruct->getHeight())/2),0);  // center
+        m_instruct->setShowEnabled(true);
+        m_note->setShowEnabled(false);
+        m_remind->setShowEnabled(false);
+        hideTestStateLabels();
+        break;
+
+    case locking:
+
+        // NOTE: assume that one joint will always be unlocked
+        if (a_state.p_lockSignal) {
+            setLabelText(m_instruct, "Please wait for experimenter.");
+            m_instruct->setLocalPos((int)((a_width - m_instruct->getWidth())/2),
+                                    (int)((a_height - m_instruct->getHeight())/2),0);  // center
+            m_instruct->setShowEnabled(true);
+
+            // add note for experimenter below subject instructions
+            if (a_state.p_lockedJnts[S]) {
+                setLabelText(m_note, "EXPERIMENTER: lock shoulder at " + to_string(a_state.p_test.p_lock) + " deg");
+            } else if (a_state.p_lockedJnts[E]) {
+                setLabelText(m_note, "EXPERIMENTER: lock elbow at " + to_string(a_state.p_test.p_lock) + " deg");
+            } else {
+                setLabelText(m_note, "EXPERIMENTER: unlock both joints");
+            }
+            m_note->setLocalPos((int)((a_width - m_note->getWidth())/2),
+                                (int)(a_height/2 - m_instruct->getHeight()),0);
+            m_note->setShowEnabled(true);
+        }
+        m_remind->setShowEnabled(false);
+        hideTestStateLabels();
+        break;
+
+    case resetting:
+
+        setLabelText(m_instruct, "Moving arm to home position.");
+        m_instruct->setLocalPos(75,(int)((a_height - m_instruct->getHeight())/2),0);
+        m_instruct->setShowEnabled(true);
+        m_note->setShowEnabled(false);
+        m_remind->setShowEnabled(false);
+        hideTestStateLabels();
+        break;
+
+    case grounding:
+
+        if (a_state.p_test.p_type == staircase || a_state.p_test.p_type == match1D)
+            if (a_state.p_test.p_joint == S) setLabelText(m_remind, "Your upperarm is here.");
+            else                     setLabelText(m_remind, "Your forearm is here.");
+        else                         setLabelText(m_remind, "Your hand is here.");
+        m_remind->setLocalPos((int)((a_width - m_instruct->getWidth())/2),(int)(a_height-150),0);
+        m_remind->setShowEnabled(true);
+        m_instruct->setShowEnabled(false);
+        m_note->setShowEnabled(false);
+        hideTestStateLabels();
+        break;
+
+    case setting:
+
+        setLabelText(m_instruct, "Moving arm to starting position.");
+        m_instruct->setLocalPos(75,(int)(a_height/2),0);
+        m_instruct->setShowEnabled(true);
+        m_note->setShowEnabled(false);
+        m_remind->setShowEnabled(false);
+        hideTestStateLabels();
+        break;
+
+    case waitingForResponse:
+
+        // label practice trials
+        if (a_state.p_trial.p_isPractice) {
+            setLabelText(m_labelPractice, "PRACTICE TRIAL");
+            m_labelPractice->setLocalPos((int)((a_width - m_labelPractice->getWidth())/2),
+                                         (int)((a_height - m_labelPractice->getHeight())/2),0);  // center
+            m_labelPractice->setShowEnabled(true);
+        } else {
+            m_labelPractice->setShowEnabled(false);
+        }
+
+        // (if necessary) display time remaining in trial
+        setLabelText(m_labelCntdwn, to_string(a_state.p_timeRemaining));
+        if (m_rightHanded)
+              m_labelCntdwn->setLocalPos(150,(int)((a_height - m_labelCntdwn->getHeight())/2),0);  // on LEFT (opposite tested arm)
+        else  m_labelCntdwn->setLocalPos((int)(a_width - m_labelCntdwn->getWidth() - 150),
+                                         (int)((a_height - m_labelCntdwn->getHeight())/2),0);      // on RIGHT (opposite tested arm)
+        m_labelCntdwn->setShowEnabled(bool(CNTDWN));
+
+        // set test details
+        switch (a_state.p_test.p_type) {
+        case staircase:
+            setLabelText(m_labelTestType, "TEST: 1-D forced choice");
+            if (a_state.p_test.p_joint == S) setLabelText(m_labelJoint, "JOINT: shoulder");
+            else                     setLabelText(m_labelJoint, "JOINT: elbow");
+            setLabelText(m_labelActive, "MOVEMENT: passive");
+            setLabelText(m_labelVision, "VISION: ---");
+            setLabelText(m_labelNumStair, "STAIRCASE #" + to_string(a_state.p_currStaircase + 1));
+            setLabelText(m_labelNumJudge, "JUDGEMENT #" + to_string(a_state.p_numJudgements + 1));
+            setLabelText(m_labelNumRev, "REVERSALS: " + to_string(a_state.p_numReversals));
+            break;
+        case match1D:
+            setLabelText(m_labelTestType, "TEST: 1-D free choice");
+            if (a_state.p_test.p_joint == S) setLabelText(m_labelJoint, "JOINT: shoulder");
+            else                     setLabelText(m_labelJoint, "JOINT: elbow");
+            if (a_state.p_test.p_active) setLabelText(m_labelActive, "MOVEMENT: active");
+            else                 setLabelText(m_labelActive, "MOVEMENT: passive");
+            if (a_state.p_test.p_vision) setLabelText(m_labelVision, "VISION: yes");
+            else                 setLabelText(m_labelVision, "VISION: ---");
+            setLabelText(m_labelNumTrial, "TRIAL #" + to_string(a_state.p_numTrials + 1));
+            break;
+        case match2D:
+            setLabelText(m_labelTestType, "TEST: 2-D matching");
+            setLabelText(m_labelJoint, "JOINT: both");
+            if (a_state.p_test.p_active) setLabelText(m_labelActive, "MOVEMENT: active");
+            else                 setLabelText(m_labelActive, "MOVEMENT: passive");
+            if (a_state.p_test.p_vision) setLabelText(m_labelVision, "VISION: yes");
+            else                 setLabelText(m_labelVision, "VISION: ---");
+            setLabelText(m_labelNumTrial, "TRIAL #" + to_string(a_state.p_numTrials + 1));
+            break;
+        default:
+            break;
+        }
+
+        // position/display test details
+        longestWidth = m_labelTestType->getWidth() + 8;
+        stndrdHeight = m_labelTestType->getHeight() + 8;
+        m_labelTestType->setLocalPos((int)(a_width-longestWidth-10),(int)(a_height-stndrdHeight),0);
+        m_labelJoint->setLocalPos((int)(a_width-longestWidth-10),(int)(a_height-2*stndrdHeight),0);
+        m_labelActive->setLocalPos((int)(a_width-longestWidth-10),(int)(a_height-3*stndrdHeight),0);
+        m_labelVision->setLocalPos((int)(a_width-longestWidth-10),(int)(a_height-4*stndrdHeight),0);
+        m_labelNumStair->setLocalPos(10,(int)(a_height-stndrdHeight),0);
+        m_labelNumJudge->setLocalPos(10,(int)(a_height-2*stndrdHeight),0);
+        m_labelNumRev->setLocalPos(10,(int)(a_height-3*stndrdHeight),0);
+        m_labelNumTrial->setLocalPos(10,(int)(a_height-stndrdHeight),0);
+
+        m_labelTestType->setShowEnabled(true);
+        m_labelJoint->setShowEnabled(true);
+        m_labelActive->setShowEnabled(true);
+        m_labelVision->setShowEnabled(true);
+        if (a_state.p_test.p_type == staircase) {
+            m_labelNumStair->setShowEnabled(true);
+            m_labelNumJudge->setShowEnabled(true);
+            m_labelNumRev->setShowEnabled(true);
+            m_labelNumTrial->setShowEnabled(false);
+        } else {
+            m_labelNumStair->setShowEnabled(false);
+            m_labelNumJudge->setShowEnabled(false);
+            m_labelNumRev->setShowEnabled(false);
+            m_labelNumTrial->setShowEnabled(true);
+        }
+
+        // set reminder of test instructions
+        switch (a_state.p_test.p_type) {
+        case staircase:
+            if (a_state.p_test.p_joint == S) setLabelText(m_remind, "Where is the green cylinder relative to your upperarm?");
+            else                     setLabelText(m_remind, "Where is the green cylinder relative to your forearm?");
+            break;
+        case match1D:
+            if (a_state.p_test.p_active) {
+                if (a_state.p_test.p_joint == S) setLabelText(m_remind, "Move your upperarm to match the green cylinder.");
+                else                     setLabelText(m_remind, "Move your forearm to match the green cylinder.");
+            } else {
+                if (a_state.p_test.p_joint == S) setLabelText(m_remind, "Move the green cylinder to match your upperarm.");
+                else                     setLabelText(m_remind, "Move the green cylinder to match your forearm.");
+            }
+            break;
+        case match2D:
+            if (a_state.p_test.p_active) setLabelText(m_remind, "Move your hand to the green sphere.");
+            else                 setLabelText(m_remind, "Move the green sphere to match your hand position.");
+            break;
+        default:
+            break;
+        }
+        m_remind->setLocalPos((int)((a_width - m_remind->getWidth())/2),(int)(a_height-150),0);
+        m_remind->setShowEnabled(true);
+
+        m_instruct->setShowEnabled(false);
+        m_note->setShowEnabled(false);
+        break;
+
+    case breaking:
+
+        setLabelText(m_instruct, "Take a " + to_string(a_state.p_breakTime) + "-minute break.");
+        m_instruct->setLocalPos((int)((a_width - m_instruct->getWidth())/2),
+                                (int)((a_height - m_instruct->getHeight())/2),0);
+        m_instruct->setShowEnabled(true);
+        m_note->setShowEnabled(false);
+        m_remind->setShowEnabled(false);
+        hideTestStateLabels();
+        break;
+
+    case thanks:
+
+        setLabelText(m_instruct, "Experiment complete.");
+        m_instruct->setLocalPos((int)((a_width - m_instruct->getWidth())/2),
+                                (int)((a_height - m_instruct->getHeight())/2),0);
+        m_instruct->setShowEnabled(true);
+        m_note->setShowEnabled(false);
+        m_remind->setShowEnabled(false);
+        hideTestStateLabels();
+        break;
+
+    default:
+        break;
+    }
+}
@@ -0,0 +1,105 @@
+#ifndef EXPSCENE_H
+#define EXPSCENE_H
+
+#include "chai3d.h"
+#include "expparams.h"
+#include "subject.h"
+#include <cmath>
+#include <string>
+
+#define CORR_PARALL  0         // 1 = correct for parallax, 0 = leave graphics directly above actual arm
+#define REACH_DIST   10        // reach distance [cm]
+
+// experiment state needed to draw one frame of the scene
+// NOTE: filled by 'expWidget' while running and by 'expReplay' from recorded data
+typedef struct
+{
+    exp_states p_state;              // current experiment state
+    test_params p_test;              // parameters for current test
+    trial_params p_trial;            // parameters for current trial
+    chai3d::cVector3d p_th;          // joint angles of exo [rad]
+    double p_subjAng = 0.0;          // angle of subject's joint (active)/angle cursor (passive), for 1-D matching [deg]
+    chai3d::cVector3d p_subjPos;     // position of subject's hand (active)/position cursor (passive), for 2-D matching [cm]
+    bool p_lockSignal = false;       // TRUE = experimenter must MANUALLY (un)lock joint(s)
+    bool p_lockedJnts[NUM_JNT] = {false};  // joints to be MANUALLY locked
+    int p_currStaircase = 0;         // current staircase (only important if double staircase)
+    int p_numJudgements = 0;         // number of judgements made during current staircase
+    int p_numReversals = 0;          // number of judgement reversals during current staircase
+    int p_numTrials = 0;             // number of matching trials performed for given test
+    int p_timeRemaining = 0;         // time remaining in trial until 'time out' [sec]
+    int p_breakTime = 0;             // break time [min]
+} scene_state;
+
+// CHAI world shown to the subject, independent of the widget it is drawn in
+// so that it can also be rendered offscreen (e.g. for session review videos)
+class expScene
+{
+public:
+    chai3d::cWorld* m_world;              // CHAI world
+    chai3d::cCamera* m_camera;            // camera to render the world
+    chai3d::cDirectionalLight* m_light;   // light to illuminate the world
+    chai3d::cShapeCylinder* m_angle;      // "infinitely" long cylinder representing test angle for 1-D tests (static in active test, dynamic in passive test)
+    chai3d::cShapeSphere* m_target;       // sphere representing target position for 2-D matching (static in active test, dynamic in passive test)
+    chai3d::cShapeCylinder* m_upperarm;   // cylinder representing upperarm
+    chai3d::cShapeCylinder* m_forearm;    // cylinder representing forearm
+    chai3d::cShapeCylinder* m_upperarmL;  // "infinitely" long cylinder representing upperarm for 1-D tests
+    chai3d::cShapeCylinder* m_forearmL;   // "infinitely" long cylinder representing forearm for 1-D tests
+    chai3d::cShapeSphere* m_shoulder;     // sphere representing shoulder joint
+    chai3d::cShapeSphere* m_elbow;        // sphere representing elbow joint
+    chai3d::cShapeSphere* m_hand;         // sphere representing hand
+    chai3d::cLabel* m_instruct;           // instructional message for subject
+    chai3d::cLabel* m_note;               // note for experimenter
+    chai3d::cLabel* m_remind;             // reminder for subject about current state/test
+    chai3d::cLabel* m_labelPractice;      // large label denoting current trial as practice
+    chai3d::cLabel* m_labelCntdwn;        // large label displaying seconds left in current trial
+    chai3d::cLabel* m_labelTestType;      // label for number of joints being tested (1 or 2)
+    chai3d::cLabel* m_labelJoint;         // label for current joint being tested (S, E, or --)
+    chai3d::cLabel* m_labelActive;        // label for current movement condition (active or passive)
+    chai3d::cLabel* m_labelVision;        // label for current vision condition (with or without)
+    chai3d::cLabel* m_labelNumStair;      // label for current staircase number for current joint & test angle
+    chai3d::cLabel* m_labelNumJudge;      // label for number of judgements made during current staircase pair: (above, below)
+    chai3d::cLabel* m_labelNumRev;        // label for number of judgement reversals during current staircase pair: (above, below)
+    chai3d::cLabel* m_labelNumTrial;      // label for number of matching trials performed for given test (& joint if 1-D test)
+
+    // graphics
+    // (NOTE: we move camera to align graphics with real world
+    //  instead of continually adding on an (x,y) offset)
+    double m_camX;                        // x-coordinate of camera viewing the world [m]
+    double m_scaleFactor;                 // factor by which to scale graphics, used for parallax correction
+    chai3d::cVector3d m_scalePoint;       // point about which to scale graphics, used for parallax correction [m]
+    chai3d::cVector3d m_camPos;           // position of camera viewing the world [m]
+    chai3d::cVector3d m_camLookAt;        // point at which camera is pointing [m]
+    chai3d::cVector3d m_camUp;            // vector pointing to top of field of view (FOV) [m]
+    chai3d::cVector3d m_shldOff;          // offset of shoulder relative to graphics origin [m]
+    chai3d::cVector3d m_center;           // center-out position for 2-D matching [cm]
+
+    expScene();
+    virtual ~expScene();
+
+    void setSubject(const subject &a_subj);
+    void update(const scene_state &a_state, int a_width, int a_height);
+    void invalidate();
+    void render(int a_width, int a_height);
+    chai3d::cVector3d angleToTarg(double ang);
+
+protected:
+    bool m_rightHanded;                   // handedness of subject (TRUE = righty, FALSE = lefty)
+    double m_Lupper;                      // length from shoulder to elbow joint [m]
+    double m_LtoEE;                       // length from elbow joint to exo end-effector [m]
+
+    // retained state, so that only changes are pushed into the scene
+    bool m_valid;                         // TRUE = scene reflects 'm_last' (FALSE forces full update)
+    scene_state m_last;                   // state at last update
+    int m_lastWidth;                      // width of view at last update
+    int m_lastHeight;                     // height of view at last update
+
+    void updateGraphics(const scene_state &a_state);
+    void updateLabels(const scene_state &a_state, int a_width, int a_height);
+    void hideTestStateLabels();
+    void setLabelText(chai3d::cLabel* a_label, const std::string &a_text);
+    static bool sameTest(const test_params &a_test1, const test_params &a_test2);
+    static bool sameGraphics(const scene_state &a_state1, const scene_state &a_state2);
+    static bool sameLabels(const scene_state &a_state1, const scene_state &a_state2);
+};
+
+#endif // EXPSCENE_H
@@ -3,51 +3,15 @@
 
 #define T_GRAPHICS   50        // update graphics every 50 ms (20 Hz)
 #define T_RECORD     50        // record movement data every 50 ms (20 Hz), at most
-#define CAM_X_RIGHT  0.04      // x-coordinate of camera for all tests with right hand (to be shifted in x for left-handed tests, for RIGHT = 0.0590 / for LEFT = 0.0372) [m]
-#define CAM_Y        0.365     // y-coordinate of camera [m]
-#define CAM_Z        1.0       // z-coordinate of camera (aka. height above scene) [m]
-#define MIRROR       1         // 1 = graphics are mirrored in display
-#define CORR_PARALL  0         // 1 = correct for parallax, 0 = leave graphics directly above actual arm
-#define D_PARALLAX   0.09      // distance of arm below graphics plane [m]
-#define D_TO_EYES    0.07      // distance of eyes in front of shoulder [m]
-#define D_TV_EXO_R   0.129     // x-distance from right edge of TV display to corner of exo opposite main axis, when exo configured for right-hand testing [m]
-#define D_TV_EXO_L   0.111     // x-distance from left edge of TV display to corner of exo opposite main axis, when exo configured for left-hand testing [m]
-#define W_SCREEN     1.022     // screen width (used for setting orthographic view)
-#define W_TV         1.049     // width of TV display [m]
-#define W_EXO        0.441     // distance between exo's main axis and corner of exo opposite main axis [m]
-#define R_JOINT      0.04      // radius of spheres representing joints [m]
-#define R_SEGMENT    0.02      // radius of cylinders representing upper/forearm [m]
-#define H_SEGMENT    0.5       // default height of cylinders representing upper/forearm [m]
-#define H_INF        10        // "infinity" (cylinder height) for 1-D tests where end of segment should not be visible [m]
-#define L_SCALE      0.9606    // scaling factor for graphics, to enable matching between real & virtual worlds (prior to parallax correction)
-#define L_RELRAD     0.9       // scaling factor between exoskeleton joint/segment & test target radii
-#define L_RELLEN     1.25      // scaling factor between exoskeleton segment and test target lengths
-#define ALPH_GHOST   0.5       // alpha value for exoskeleton components
+#define T_EXPERIMENT 0.001     // update experiment state every 1 ms [sec]
 #define MOUSE_STEP   15        // angle equivalent of 1 "click" of mouse scroll wheel [deg]
 #define JNTSPACE     0         // joint-space control
 #define TASKSPACE    1         // task-space control
-#define CNTDWN       0         // 1 = trial time limited by countdown timer
 #define ANG_STEP     0.5       // step size when moving angle cursor in 1-D passive test [deg]
 #define POS_STEP     0.5       // step size when moving position cursor in 2-D passive test [cm]
-#define DOUB_STAIRS  1         // 1 = two staircases at a time (randomized), 0 = one staircase at a time
-#define ADAPTIVE     0         // 1 = adaptive test, 0 = standard test
-#define CLOSER       0         // reference is rotated closer to body than actual arm (test angle)
-#define FURTHER      1         // reference is rotated further from body than actual arm (test angle)
-#define FROM_CLOSER  0         // in double-staircase paradigm, staircase for which reference angle starts closer to body
-#define FROM_FURTHER 1         // in double-staircase paradigm, staircase for which reference angle starts further from body
-#define START_DEV    30        // starting deviation from test angle for staircases 1 & 2 [deg]
-#define MAX_REVERSAL 4         // number of reversals for each staircase
-#define NUM_FOR_EST  4         // in adaptive paradigm, number of reference angles (from each staircase) to use for estimation of perceptual boundary/sensitivity
-#define CENTER_X     3.5       // x-coordinate of reach center for right hand (negative for left hand) [cm]
-#define CENTER_Y     34.5      // y-coordinate of reach center [cm]
 #define CENTEROUT    1         // 1 = 2-D reaches begin from center of target circle, 0 = 2-D reaches begin from other (non-adjacent) target on circle
-#define REACH_DIST   10        // reach distance [cm]
 #define NUM_VISION   2         // number of trials per matching target with visual feedback
 #define MANUAL_LOCK  0         // 1 = manually (physically) lock unused joint for 1-D tests, 0 = "locking" done automatically via exo control
-#define WAIT_TIME    2         // time to wait for exoskeleton to reset for grounding [sec]
-#define GROUND_TIME  3         // time to display arm location for visual grounding (preventing proprioceptive drift) [sec]
-#define SHORT_BREAK  1         // duration of short break [min]
-#define LONG_BREAK   2         // duration of long break [min]
 #define CM_TO_METERS 0.01      // conversion factor between centimeters and meters
 #define MSEC_TO_SEC  0.001     // conversion factor between milliseconds and seconds
 #define MIN_TO_SEC   60        // conversion factor between minutes and seconds
@@ -83,107 +47,10 @@ expWidget::expWidget(QWidget *parent) :
     m_outputFile = NULL;
     setFocusPolicy(Qt::StrongFocus);  // keyboard/mouse input processed by THIS widget
 
-    // create new CHAI world
-    m_world = new cWorld();
-    m_world->m_backgroundColor.setWhiteSmoke();
-
-    // create camera to view world
-    m_camera = new cCamera(m_world);
-    m_camera->setClippingPlanes(0.01,20.0);
-    m_camera->setOrthographicView(W_SCREEN);
-    if (MIRROR) m_camera->setMirrorHorizontal(true);
-    m_world->addChild(m_camera);
-
-    // attach light source to camera for illumination
-    m_light = new cDirectionalLight(m_world);
-    m_light->setEnabled(true);
-    m_camera->addChild(m_light);
-
-    // add graphic elements for experiment, scaled relative to exoskeleton joints/segments
-    m_angle = new cShapeCylinder(L_RELRAD*R_SEGMENT, L_RELRAD*R_SEGMENT, H_INF);
-    m_target = new cShapeSphere(L_RELRAD*R_JOINT);
-    m_angle->m_material->setGreenLime();
-    m_target->m_material->setGreenLime();
-    m_world->addChild(m_angle);
-    m_world->addChild(m_target);
-
-    // add exoskeleton segments as (slightly) transparent cylinders
-    m_upperarm = new cShapeCylinder(R_SEGMENT, R_SEGMENT, H_SEGMENT);
-    m_forearm = new cShapeCylinder(R_SEGMENT, R_SEGMENT, H_SEGMENT);
-    m_upperarmL = new cShapeCylinder(R_SEGMENT, R_SEGMENT, H_INF);
-    m_forearmL = new cShapeCylinder(R_SEGMENT, R_SEGMENT, H_INF);
-    m_upperarm->m_material->setGrayLight();
-    m_forearm->m_material->setGrayLight();
-    m_upperarmL->m_material->setGrayLight();
-    m_forearmL->m_material->setGrayLight();
-    m_upperarm->setTransparencyLevel((float)ALPH_GHOST);
-    m_forearm->setTransparencyLevel((float)ALPH_GHOST);
-    m_upperarmL->setTransparencyLevel((float)ALPH_GHOST);
-    m_forearmL->setTransparencyLevel((float)ALPH_GHOST);
-    m_world->addChild(m_upperarm);
-    m_world->addChild(m_forearm);
-    m_world->addChild(m_upperarmL);
-    m_world->addChild(m_forearmL);
-
-    // add exoskeleton joints as (slightly) transparent spheres
-    m_shoulder = new cShapeSphere(R_JOINT);
-    m_elbow = new cShapeSphere(R_JOINT);
-    m_hand = new cShapeSphere(R_JOINT);
-    m_shoulder->m_material->setBlack();
-    m_elbow->m_material->setBlack();
-    m_hand->m_material->setBlack();
-    m_shoulder->setTransparencyLevel((float)ALPH_GHOST);
-    m_elbow->setTransparencyLevel((float)ALPH_GHOST);
-    m_hand->setTransparencyLevel((float)ALPH_GHOST);
-    m_world->addChild(m_shoulder);
-    m_world->addChild(m_elbow);
-    m_world->addChild(m_hand);
-
-    // add labels to background
-    cFont* fontSm = NEW_CFONTCALIBRI20();
-    cFont* fontMd = NEW_CFONTCALIBRI40();
-    cFont* fontLg = NEW_CFONTCALIBRI72();
-    cFont* fontHg = NEW_CFONTCALIBRI144();
-    m_instruct = new cLabel(fontLg);
-    m_note = new cLabel(fontSm);
-    m_remind = new cLabel(fontLg);
-    m_labelPractice = new cLabel(fontHg);
-    m_labelCntdwn = new cLabel(fontHg);
-    m_labelTestType = new cLabel(fontSm);
-    m_labelJoint = new cLabel(fontSm);
-    m_labelActive = new cLabel(fontSm);
-    m_labelVision = new cLabel(fontSm);
-    m_labelNumJudge = new cLabel(fontSm);
-    m_labelNumRev = new cLabel(fontSm);
-    m_labelNumStair = new cLabel(fontSm);
-    m_labelNumTrial = new cLabel(fontSm);
-    m_labelCntdwn->setFontScale(2.0);  // 2x bigger
-    m_instruct->m_fontColor.setBlack();
-    m_note->m_fontColor.setGray();
-    m_remind->m_fontColor.setRed();
-    m_labelPractice->m_fontColor.setRed();
-    m_labelCntdwn->m_fontColor.setRed();
-    m_labelTestType->m_fontColor.setBlack();
-    m_labelJoint->m_fontColor.setBlack();
-    m_labelActive->m_fontColor.setBlack();
-    m_labelVision->m_fontColor.setBlack();
-    m_labelNumJudge->m_fontColor.setBlack();
-    m_labelNumRev->m_fontColor.setBlack();
-    m_labelNumStair->m_fontColor.setBlack();
-    m_labelNumTrial->m_fontColor.setBlack();
-    m_camera->m_backLayer->addChild(m_instruct);
-    m_camera->m_backLayer->addChild(m_note);
-    m_camera->m_backLayer->addChild(m_remind);
-    m_camera->m_backLayer->addChild(m_labelPractice);
-    m_camera->m_backLayer->addChild(m_labelCntdwn);
-    m_camera->m_backLayer->addChild(m_labelTestType);
-    m_camera->m_backLayer->addChild(m_labelJoint);
-    m_camera->m_backLayer->addChild(m_labelActive);
-    m_camera->m_backLayer->addChild(m_labelVision);
-    m_camera->m_backLayer->addChild(m_labelNumJudge);
-    m_camera->m_backLayer->addChild(m_labelNumRev);
-    m_camera->m_backLayer->addChild(m_labelNumStair);
-    m_camera->m_backLayer->addChild(m_labelNumTrial);
+    // create scene shown to subject
+    m_scene = new expScene();
+    m_sceneState.p_state = welcome;
+    m_sceneDirty = false;
 }
 
 expWidget::~expWidget()
@@ -194,8 +61,8 @@ expWidget::~expWidget()
     delete m_cntdwn;
     delete m_dataClk;
 
-    // delete CHAI world
-    delete m_world;
+    // delete scene
+    delete m_scene;
 }
 
 void expWidget::start()
@@ -209,6 +76,11 @@ void expWidget::start()
     // start graphics and experiment threads
     m_timer->start(T_GRAPHICS, this);
     m_thread.start(_expThread, CTHREAD_PRIORITY_GRAPHICS, this);
+    m_thread.setName("chARM experiment");
+
+    // second isolated core, if any, so experiment logic never preempts haptics
+    std::vector<int> cores = cThread::getIsolatedCores();
+    if (cores.size() > 1)  m_thread.setAffinity(cores[1]);
 }
 
 void expWidget::stop()
@@ -235,7 +107,13 @@ void* expWidget::expThread()
     m_runLock.acquire();
     m_running = true;
 
-    while (m_running) updateExperiment();
+    // pace experiment logic (all of its timeouts are >= 50 ms) instead of spinning a core
+    cPeriodicTask task(T_EXPERIMENT);
+    task.start();
+    while (m_running) {
+        updateExperiment();
+        task.wait();
+    }
 
     m_running = false;
     m_runLock.release();
@@ -247,6 +125,7 @@ void expWidget::initExperiment()
 {
     // initialize experiment state variables
     m_state = welcome;
+    m_testQueue = &m_parent->m_testQueue;
     m_trialComplete = 0;
     m_timeOut = false;
     m_testComplete = false;
@@ -304,37 +183,13 @@ void expWidget::initExperiment()
 
 void expWidget::prepForSubj()
 {
-    // set graphical scaling parameters (correcting for parallax, if necessary)
-    if (CORR_PARALL) {
-        m_scalePoint = cVector3d(0.508*m_parent->m_parent->m_exo->m_subj->m_Llower,D_TO_EYES,0.0)*L_SCALE;
-        m_scaleFactor = (1.0 - D_PARALLAX/(0.717*m_parent->m_parent->m_exo->m_subj->m_Llower))*L_SCALE;
-    } else {
-        m_scalePoint = cVector3d(0.0,0.0,0.0);
-        m_scaleFactor = L_SCALE;
-    }
-
-    // scale graphics to match subject's arm
-    m_shldOff = cVector3d(0.0,0.0,0.0);
-    m_upperarm->setHeight(m_parent->m_parent->m_exo->m_subj->m_Lupper*m_scaleFactor);
-    m_forearm->setHeight(m_parent->m_parent->m_exo->m_subj->m_LtoEE*m_scaleFactor);
+    // scale & position graphics for subject's arm and handedness
+    m_scene->setSubject(*m_parent->m_parent->m_exo->m_subj);
+    m_center = m_scene->m_center;
 
-    // adjust for subject handedness
-    if (m_parent->m_parent->m_exo->m_subj->m_rightHanded) {
-        m_center = cVector3d(CENTER_X,CENTER_Y,0.0);
-        m_camX = CAM_X_RIGHT;
-    } else {
-        m_center = cVector3d(-1*CENTER_X,CENTER_Y,0.0);
-        double d_btwn = W_TV - 2*W_EXO - D_TV_EXO_R - D_TV_EXO_L;
-        m_camX = CAM_X_RIGHT + d_btwn;  // shift by distance between main axis in right- and left-handed configurations
-    }
+    // set hand position for visual grounding
     m_groundPos = m_center;
     m_groundAng = m_parent->m_parent->m_exo->inverseKin(m_groundPos*CM_TO_METERS)*(180/PI);
-
-    // set up camera for graphics viewing
-    m_camPos = cVector3d(m_camX,CAM_Y,CAM_Z);
-    m_camLookAt = m_camPos - cVector3d(0.0,0.0,CAM_Z);  // directly below camera
-    m_camUp = cVector3d(0.0,1.0,0.0);
-    m_camera->set(m_camPos, m_camLookAt, m_camUp);
 }
 
 void expWidget::createTests()
@@ -468,629 +323,75 @@ void expWidget::createTests()
 
 void expWidget::updateExperiment()
 {
-    // update graphics
-    updateGraphics();
-    updateLabels();
+    // publish state for graphics (applied to scene at next rendered frame)
+    scene_state scene = getSceneState();
+    m_worldLock.acquire();
+    m_sceneState = scene;
+    m_sceneDirty = true;
+    m_worldLock.release();
 
     // update experiment snapshot (for debugging)
     m_snap.p_running = m_running;
     m_snap.p_test = m_test;
     m_snap.p_trial = m_trial;
 
-    // enter finite state machine
-    switch (m_state) {
-
-    case welcome:
-
-        // wait for SPACE keypress
-        if (m_keyPressed && m_key == Qt::Key_Space) {
-            m_keyPressed = false;
-            m_state = locking;
-        }
-        break;
-
-    case locking:
-
-        // only pause here if necessary to (manually) lock or unlock joint(s)
-        if (m_lockSignal) {
-            if (m_keyPressed && m_key == Qt::Key_Space) {
-                m_keyPressed = false;
-                m_lockSignal = false;
-            }
-        } else {
-            sendToGround();
-            m_clk->setTimeoutPeriodSeconds(WAIT_TIME);
-            m_clk->start(true);
-            m_state = resetting;
-        }
-        break;
-
-    case resetting:
-
-        // wait until exo reaches position for visual grounding
-        if (m_clk->timeoutOccurred() && m_parent->m_parent->m_exo->reachedTarg()) {
-            m_clk->setTimeoutPeriodSeconds(GROUND_TIME);
-            m_clk->start(true);
-            m_state = grounding;
-        }
-
-        // skip upcoming trial
-        else if (m_keyPressed && m_key == Qt::Key_S) {
-            m_keyPressed = false;
-            m_state = prepForNextTrial();
-        }
-        break;
-
-    case grounding:
-
-        // wait for timer to expire until sending to start for next trial
-        if (m_clk->timeoutOccurred()) {
-            sendToStart();
-            m_state = setting;
-        }
-
-        // skip upcoming trial
-        else if (m_keyPressed && m_key == Qt::Key_S) {
-            m_keyPressed = false;
-            m_state = prepForNextTrial();
-        }
-        break;
-
-    case setting:
-
-        // wait until exo reaches start position
-        if (m_parent->m_parent->m_exo->reachedTarg()) {
-            startTrialControl();
-            m_cntdwn->setTimeoutPeriodSeconds(m_test.p_time);
-            m_cntdwn->start(true);  // reset from 0.0 sec
-            m_state = waitingForResponse;
-        }
-
-        // skip upcoming trial
-        else if (m_keyPressed && m_key == Qt::Key_S) {
-            m_keyPressed = false;
-            m_state = prepForNextTrial();
-        }
-        break;
-
-    case waitingForResponse:
-
-        // check for (and record) response and prep for next trial
-        checkForResp();
-        if (m_trialComplete || m_timeOut) {
-            recordData();
-            m_trialComplete = 0;
-            m_timeOut = false;
-            m_state = prepForNextTrial();
-        }
-        break;
-
-    case breaking:
-
-        // wait until break is over (skip with 'S')
-        if (m_clk->timeoutOccurred() || (m_keyPressed && m_key == Qt::Key_S)) {
-            m_keyPressed = false;
-            m_state = locking;
-        }
-        break;
-
-    case thanks:
-        break;
-
-    default:
-        break;
-    }
+    // advance finite state machine (shared with 'simSession')
+    step();
 }
 
-void expWidget::updateGraphics()
+scene_state expWidget::getSceneState()
 {
-    // get subject kinematics
-    double L1 = m_parent->m_parent->m_exo->m_subj->m_Lupper*m_scaleFactor;
-    double L2 = m_parent->m_parent->m_exo->m_subj->m_LtoEE*m_scaleFactor;
-    double th1 = m_parent->m_parent->m_exo->m_th(0);
-    double th2 = th1 + m_parent->m_parent->m_exo->m_th(1);
-    if (!m_parent->m_parent->m_exo->m_subj->m_rightHanded) {
-        th1 = PI - th1;
-        th2 = PI - th2;
-    }
-
-    // update exoskeleton to match subject
-    m_shoulder->setLocalPos(m_scaleFactor*(m_shldOff - m_scalePoint/L_SCALE) + m_scalePoint);
-    m_elbow->setLocalPos(m_shoulder->getLocalPos() + cVector3d(L1*cos(th1), L1*sin(th1), 0.0));
-    m_hand->setLocalPos(m_elbow->getLocalPos() + cVector3d(L2*cos(th2), L2*sin(th2), 0.0));
-    m_upperarm->setLocalPos(m_shoulder->getLocalPos());
-    m_forearm->setLocalPos(m_elbow->getLocalPos());
-    m_upperarmL->setLocalPos(m_shoulder->getLocalPos());
-    m_forearmL->setLocalPos(m_elbow->getLocalPos());
-    m_upperarm->setLocalRot(cMatrix3d(th1, PI/2, 0.0, C_EULER_ORDER_ZYX));
-    m_forearm->setLocalRot(cMatrix3d(th2, PI/2, 0.0, C_EULER_ORDER_ZYX));
-    m_upperarmL->setLocalRot(cMatrix3d(th1, PI/2, 0.0, C_EULER_ORDER_ZYX));
-    m_forearmL->setLocalRot(cMatrix3d(th2, PI/2, 0.0, C_EULER_ORDER_ZYX));
-
-    switch (m_state) {
-
-    case welcome:
-    case locking:
-    case resetting:
-    case setting:
-    case breaking:
-    case thanks:
-
-        // only show exo for debugging purposes
-        if (DEBUG) {
-            m_shoulder->setShowEnabled(true);
-            m_elbow->setShowEnabled(true);
-            m_hand->setShowEnabled(true);
-            m_upperarm->setShowEnabled(true);
-            m_forearm->setShowEnabled(true);
-        } else {
-            m_shoulder->setShowEnabled(false);
-            m_elbow->setShowEnabled(false);
-            m_hand->setShowEnabled(false);
-            m_upperarm->setShowEnabled(false);
-            m_forearm->setShowEnabled(false);
-        }
-        m_upperarmL->setShowEnabled(false);
-        m_forearmL->setShowEnabled(false);
-        m_angle->setShowEnabled(false);
-        m_target->setShowEnabled(false);
-        break;
-
-    case grounding:
-
-        // show current exo configuration to ground proprioception with vision
-        switch (m_test.p_type) {
-        case staircase:
-        case match1D:
-            if (m_test.p_joint == S) {
-                m_shoulder->setShowEnabled(true);
-                m_upperarmL->setShowEnabled(true);
-                m_elbow->setShowEnabled(false);
-                m_forearmL->setShowEnabled(false);
-            } else {
-                m_elbow->setShowEnabled(true);
-                m_forearmL->setShowEnabled(true);
-                m_shoulder->setShowEnabled(false);
-                m_upperarmL->setShowEnabled(false);
-            }
-            m_upperarm->setShowEnabled(false);
-            m_forearm->setShowEnabled(false);
-            m_hand->setShowEnabled(false);
-            break;
-        case match2D:
-            m_hand->setShowEnabled(true);
-            m_shoulder->setShowEnabled(false);
-            m_elbow->setShowEnabled(false);
-            m_upperarm->setShowEnabled(false);
-            m_forearm->setShowEnabled(false);
-            m_upperarmL->setShowEnabled(false);
-            m_forearmL->setShowEnabled(false);
-            break;
-        default:
-            m_shoulder->setShowEnabled(true);
-            m_elbow->setShowEnabled(true);
-            m_hand->setShowEnabled(true);
-            m_upperarm->setShowEnabled(true);
-            m_forearm->setShowEnabled(true);
-            m_upperarmL->setShowEnabled(false);
-            m_forearmL->setShowEnabled(false);
-            break;
-        }
-        m_angle->setShowEnabled(false);
-        m_target->setShowEnabled(false);
-        break;
-
-    case waitingForResponse:
-
-        switch (m_test.p_type) {
-
-        // show reference angle
-        case staircase:
-            double refAng;
-            if (m_test.p_joint == S) {
-                refAng = m_trial.p_ref*(PI/180);
-                m_angle->setLocalPos(m_shoulder->getLocalPos());
-                m_shoulder->setShowEnabled(true);
-                m_elbow->setShowEnabled(false);
-            } else {
-                if (m_parent->m_parent->m_exo->m_subj->m_rightHanded) refAng = th1 + m_trial.p_ref*(PI/180);
-                else                                                  refAng = (PI-th1) + m_trial.p_ref*(PI/180);
-                m_angle->setLocalPos(m_elbow->getLocalPos());
-                m_elbow->setShowEnabled(true);
-                m_shoulder->setShowEnabled(false);
-            }
-            if (!m_parent->m_parent->m_exo->m_subj->m_rightHanded) refAng = PI - refAng;
-            m_angle->setLocalRot(cMatrix3d(refAng, PI/2, 0.0, C_EULER_ORDER_ZYX));
-            m_angle->setShowEnabled(true);
-            m_upperarm->setShowEnabled(false);
-            m_forearm->setShowEnabled(false);
-            m_upperarmL->setShowEnabled(false);
-            m_forearmL->setShowEnabled(false);
-            m_hand->setShowEnabled(false);
-            m_target->setShowEnabled(false);
-            break;
-
-        case match1D:
-
-            // show goal joint/segment position
-            if (m_test.p_active) {
-                double targAng;
-                if (m_test.p_joint == S) {
-                    targAng = m_trial.p_targ*(PI/180);
-                    m_angle->setLocalPos(m_shoulder->getLocalPos());
-                    m_shoulder->setShowEnabled(true);
-                    m_elbow->setShowEnabled(false);
-                    m_forearmL->setShowEnabled(false);
-                    if (m_test.p_vision) m_upperarmL->setShowEnabled(true);
-                    else                 m_upperarmL->setShowEnabled(false);
-                } else {
-                    if (m_parent->m_parent->m_exo->m_subj->m_rightHanded) targAng = th1 + m_trial.p_targ*(PI/180);
-                    else                                                  targAng = (PI-th1) + m_trial.p_targ*(PI/180);
-                    m_angle->setLocalPos(m_elbow->getLocalPos());
-                    m_elbow->setShowEnabled(true);
-                    m_shoulder->setShowEnabled(false);
-                    m_upperarmL->setShowEnabled(false);
-                    if (m_test.p_vision) m_forearmL->setShowEnabled(true);
-                    else                 m_forearmL->setShowEnabled(false);
-                }
-                if (!m_parent->m_parent->m_exo->m_subj->m_rightHanded) targAng = PI - targAng;
-                m_angle->setLocalRot(cMatrix3d(targAng, PI/2, 0.0, C_EULER_ORDER_ZYX));
-            }
-
-            // show angle cursor
-            else {
-                double subjAng;
-                if (m_test.p_joint == S) {
-                    subjAng = m_subjAng*(PI/180);
-                    m_angle->setLocalPos(m_shoulder->getLocalPos());
-                    m_shoulder->setShowEnabled(true);
-                    m_elbow->setShowEnabled(false);
-                } else {
-                    if (m_parent->m_parent->m_exo->m_subj->m_rightHanded) subjAng = th1 + m_subjAng*(PI/180);
-                    else                                                  subjAng = (PI-th1) + m_subjAng*(PI/180);
-                    m_angle->setLocalPos(m_elbow->getLocalPos());
-                    m_elbow->setShowEnabled(true);
-                    m_shoulder->setShowEnabled(false);
-                }
-                if (!m_parent->m_parent->m_exo->m_subj->m_rightHanded) subjAng = PI - subjAng;
-                m_angle->setLocalRot(cMatrix3d(subjAng, PI/2, 0.0, C_EULER_ORDER_ZYX));
-                m_upperarmL->setShowEnabled(false);
-                m_forearmL->setShowEnabled(false);
-            }
-            m_angle->setShowEnabled(true);
-            m_upperarm->setShowEnabled(false);
-            m_forearm->setShowEnabled(false);
-            m_hand->setShowEnabled(false);
-            m_target->setShowEnabled(false);
-            break;
-
-        case match2D:
-
-            // show goal hand position
-            if (m_test.p_active) {
-                m_target->setLocalPos(m_scaleFactor*(angleToTarg(m_trial.p_targ)*CM_TO_METERS - m_scalePoint/L_SCALE) + m_scalePoint);
-                if (m_test.p_vision) m_hand->setShowEnabled(true);
-                else                 m_hand->setShowEnabled(false);
-            }
-
-            // show position cursor
-            else {
-                m_target->setLocalPos(m_scaleFactor*(m_subjPos*CM_TO_METERS - m_scalePoint/L_SCALE) + m_scalePoint);
-                m_hand->setShowEnabled(false);
-            }
-            m_target->setShowEnabled(true);
-            m_shoulder->setShowEnabled(false);
-            m_elbow->setShowEnabled(false);
-            m_upperarm->setShowEnabled(false);
-            m_forearm->setShowEnabled(false);
-            m_upperarmL->setShowEnabled(false);
-            m_forearmL->setShowEnabled(false);
-            m_angle->setShowEnabled(false);
-            break;
-
-        default:
-            break;
-        }
-        break;
-
-    default:
-        m_shoulder->setShowEnabled(false);
-        m_elbow->setShowEnabled(false);
-        m_hand->setShowEnabled(false);
-        m_upperarm->setShowEnabled(false);
-        m_forearm->setShowEnabled(false);
-        m_upperarmL->setShowEnabled(false);
-        m_forearmL->setShowEnabled(false);
-        m_angle->setShowEnabled(false);
-        m_target->setShowEnabled(false);
-        break;
-    }
-}
-
-void expWidget::updateLabels()
-{
-    // declare variables for label positioning
-    double longestWidth;
-    double stndrdHeight;
-
-    switch (m_state) {
-
-    case welcome:
-
-        m_instruct->setText("Welcome");
-        m_instruct->setLocalPos((int)((m_width - m_instruct->getWidth())/2),
-                                (int)((m_height - m_instruct->getHeight())/2),0);  // center
-        m_instruct->setShowEnabled(true);
-        m_note->setShowEnabled(false);
-        m_remind->setShowEnabled(false);
-        hideTestStateLabels();
-        break;
-
-    case locking:
-
-        // NOTE: assume that one joint will always be unlocked
-        if (m_lockSignal) {
-            m_instruct->setText("Please wait for experimenter.");
-            m_instruct->setLocalPos((int)((m_width - m_instruct->getWidth())/2),
-                                    (int)((m_height - m_instruct->getHeight())/2),0);  // center
-            m_instruct->setShowEnabled(true);
-
-            // add note for experimenter below subject instructions
-            if (m_parent->m_parent->m_exo->m_lockedJnts[S]) {
-                m_note->setText("EXPERIMENTER: lock shoulder at " + to_string(m_test.p_lock) + " deg");
-            } else if (m_parent->m_parent->m_exo->m_lockedJnts[E]) {
-                m_note->setText("EXPERIMENTER: lock elbow at " + to_string(m_test.p_lock) + " deg");
-            } else {
-                m_note->setText("EXPERIMENTER: unlock both joints");
-            }
-            m_note->setLocalPos((int)((m_width - m_note->getWidth())/2),
-                                (int)(m_height/2 - m_instruct->getHeight()),0);
-            m_note->setShowEnabled(true);
-        }
-        m_remind->setShowEnabled(false);
-        hideTestStateLabels();
-        break;
-
-    case resetting:
-
-        m_instruct->setText("Moving arm to home position.");
-        m_instruct->setLocalPos(75,(int)((m_height - m_instruct->getHeight())/2),0);
-        m_instruct->setShowEnabled(true);
-        m_note->setShowEnabled(false);
-        m_remind->setShowEnabled(false);
-        hideTestStateLabels();
-        break;
-
-    case grounding:
-
-        if (m_test.p_type == staircase || m_test.p_type == match1D)
-            if (m_test.p_joint == S) m_remind->setText("Your upperarm is here.");
-            else                     m_remind->setText("Your forearm is here.");
-        else                         m_remind->setText("Your hand is here.");
-        m_remind->setLocalPos((int)((m_width - m_instruct->getWidth())/2),(int)(m_height-150),0);
-        m_remind->setShowEnabled(true);
-        m_instruct->setShowEnabled(false);
-        m_note->setShowEnabled(false);
-        hideTestStateLabels();
-        break;
-
-    case setting:
-
-        m_instruct->setText("Moving arm to starting position.");
-        m_instruct->setLocalPos(75,(int)(m_height/2),0);
-        m_instruct->setShowEnabled(true);
-        m_note->setShowEnabled(false);
-        m_remind->setShowEnabled(false);
-        hideTestStateLabels();
-        break;
-
-    case waitingForResponse:
-
-        // label practice trials
-        if (m_trial.p_isPractice) {
-            m_labelPractice->setText("PRACTICE TRIAL");
-            m_labelPractice->setLocalPos((int)((m_width - m_labelPractice->getWidth())/2),
-                                         (int)((m_height - m_labelPractice->getHeight())/2),0);  // center
-            m_labelPractice->setShowEnabled(true);
-        } else {
-            m_labelPractice->setShowEnabled(false);
-        }
-
-        // compute & (if necessary) display time remaining in trial
-        m_timeRemaining = round(m_test.p_time - m_cntdwn->getCurrentTimeSeconds());
-        if (m_timeRemaining < 0)  m_timeRemaining = 0;
-        m_labelCntdwn->setText(to_string(m_timeRemaining));
-        if (m_parent->m_parent->m_exo->m_subj->m_rightHanded)
-              m_labelCntdwn->setLocalPos(150,(int)((m_height - m_labelCntdwn->getHeight())/2),0);  // on LEFT (opposite tested arm)
-        else  m_labelCntdwn->setLocalPos((int)(m_width - m_labelCntdwn->getWidth() - 150),
-                                         (int)((m_height - m_labelCntdwn->getHeight())/2),0);      // on RIGHT (opposite tested arm)
-        m_labelCntdwn->setShowEnabled(bool(CNTDWN));
-
-        // set test details
-        switch (m_test.p_type) {
-        case staircase:
-            m_labelTestType->setText("TEST: 1-D forced choice");
-            if (m_test.p_joint == S) m_labelJoint->setText("JOINT: shoulder");
-            else                     m_labelJoint->setText("JOINT: elbow");
-            m_labelActive->setText("MOVEMENT: passive");
-            m_labelVision->setText("VISION: ---");
-            m_labelNumStair->setText("STAIRCASE #" + to_string(m_currStaircase + 1));
-            m_labelNumJudge->setText("JUDGEMENT #" + to_string(m_numJudgements[getStairIndex(m_currStaircase)] + 1));
-            m_labelNumRev->setText("REVERSALS: " + to_string(m_numReversals[getStairIndex(m_currStaircase)]));
-            break;
-        case match1D:
-            m_labelTestType->setText("TEST: 1-D free choice");
-            if (m_test.p_joint == S) m_labelJoint->setText("JOINT: shoulder");
-            else                     m_labelJoint->setText("JOINT: elbow");
-            if (m_test.p_active) m_labelActive->setText("MOVEMENT: active");
-            else                 m_labelActive->setText("MOVEMENT: passive");
-            if (m_test.p_vision) m_labelVision->setText("VISION: yes");
-            else                 m_labelVision->setText("VISION: ---");
-            m_labelNumTrial->setText("TRIAL #" + to_string(m_numTrials + 1));
-            break;
-        case match2D:
-            m_labelTestType->setText("TEST: 2-D matching");
-            m_labelJoint->setText("JOINT: both");
-            if (m_test.p_active) m_labelActive->setText("MOVEMENT: active");
-            else                 m_labelActive->setText("MOVEMENT: passive");
-            if (m_test.p_vision) m_labelVision->setText("VISION: yes");
-            else                 m_labelVision->setText("VISION: ---");
-            m_labelNumTrial->setText("TRIAL #" + to_string(m_numTrials + 1));
-            break;
-        default:
-            break;
-        }
-
-        // position/display test details
-        longestWidth = m_labelTestType->getWidth() + 8;
-        stndrdHeight = m_labelTestType->getHeight() + 8;
-        m_labelTestType->setLocalPos((int)(m_width-longestWidth-10),(int)(m_height-stndrdHeight),0);
-        m_labelJoint->setLocalPos((int)(m_width-longestWidth-10),(int)(m_height-2*stndrdHeight),0);
-        m_labelActive->setLocalPos((int)(m_width-longestWidth-10),(int)(m_height-3*stndrdHeight),0);
-        m_labelVision->setLocalPos((int)(m_width-longestWidth-10),(int)(m_height-4*stndrdHeight),0);
-        m_labelNumStair->setLocalPos(10,(int)(m_height-stndrdHeight),0);
-        m_labelNumJudge->setLocalPos(10,(int)(m_height-2*stndrdHeight),0);
-        m_labelNumRev->setLocalPos(10,(int)(m_height-3*stndrdHeight),0);
-        m_labelNumTrial->setLocalPos(10,(int)(m_height-stndrdHeight),0);
-
-        m_labelTestType->setShowEnabled(true);
-        m_labelJoint->setShowEnabled(true);
-        m_labelActive->setShowEnabled(true);
-        m_labelVision->setShowEnabled(true);
-        if (m_test.p_type == staircase) {
-            m_labelNumStair->setShowEnabled(true);
-            m_labelNumJudge->setShowEnabled(true);
-            m_labelNumRev->setShowEnabled(true);
-            m_labelNumTrial->setShowEnabled(false);
-        } else {
-            m_labelNumStair->setShowEnabled(false);
-            m_labelNumJudge->setShowEnabled(false);
-            m_labelNumRev->setShowEnabled(false);
-            m_labelNumTrial->setShowEnabled(true);
-        }
-
-        // set reminder of test instructions
-        switch (m_test.p_type) {
-        case staircase:
-            if (m_test.p_joint == S) m_remind->setText("Where is the green cylinder relative to your upperarm?");
-            else                     m_remind->setText("Where is the green cylinder relative to your forearm?");
-            break;
-        case match1D:
-            if (m_test.p_active) {
-                if (m_test.p_joint == S) m_remind->setText("Move your upperarm to match the green cylinder.");
-                else                     m_remind->setText("Move your forearm to match the green cylinder.");
-            } else {
-                if (m_test.p_joint == S) m_remind->setText("Move the green cylinder to match your upperarm.");
-                else                     m_remind->setText("Move the green cylinder to match your forearm.");
-            }
-            break;
-        case match2D:
-            if (m_test.p_active) m_remind->setText("Move your hand to the green sphere.");
-            else                 m_remind->setText("Move the green sphere to match your hand position.");
-            break;
-        default:
-            break;
-        }
-        m_remind->setLocalPos((int)((m_width - m_remind->getWidth())/2),(int)(m_height-150),0);
-        m_remind->setShowEnabled(true);
-
-        m_instruct->setShowEnabled(false);
-        m_note->setShowEnabled(false);
-        break;
-
-    case breaking:
-
-        m_instruct->setText("Take a " + to_string(m_breakTime) + "-minute break.");
-        m_instruct->setLocalPos((int)((m_width - m_instruct->getWidth())/2),
-                                (int)((m_height - m_instruct->getHeight())/2),0);
-        m_instruct->setShowEnabled(true);
-        m_note->setShowEnabled(false);
-        m_remind->setShowEnabled(false);
-        hideTestStateLabels();
-        break;
-
-    case thanks:
-
-        m_instruct->setText("Experiment complete.");
-        m_instruct->setLocalPos((int)((m_width - m_instruct->getWidth())/2),
-                                (int)((m_height - m_instruct->getHeight())/2),0);
-        m_instruct->setShowEnabled(true);
-        m_note->setShowEnabled(false);
-        m_remind->setShowEnabled(false);
-        hideTestStateLabels();
-        break;
-
-    default:
-        break;
-    }
+    scene_state scene;
+    scene.p_state = m_state;
+    scene.p_test = m_test;
+    scene.p_trial = m_trial;
+    scene.p_th = m_parent->m_parent->m_exo->m_th;
+    scene.p_subjAng = m_subjAng;
+    scene.p_subjPos = m_subjPos;
+    scene.p_lockSignal = m_lockSignal;
+    scene.p_lockedJnts[S] = m_parent->m_parent->m_exo->m_lockedJnts[S];
+    scene.p_lockedJnts[E] = m_parent->m_parent->m_exo->m_lockedJnts[E];
+    scene.p_currStaircase = m_stair.m_currStaircase;
+    scene.p_numJudgements = m_stair.m_numJudgements[m_stair.getStairIndex()];
+    scene.p_numReversals = m_stair.m_numReversals[m_stair.getStairIndex()];
+    scene.p_numTrials = m_numTrials;
+    scene.p_breakTime = m_breakTime;
+
+    // compute time remaining in trial
+    m_timeRemaining = round(m_test.p_time - m_cntdwn->getCurrentTimeSeconds());
+    if (m_timeRemaining < 0)  m_timeRemaining = 0;
+    scene.p_timeRemaining = m_timeRemaining;
+
+    return scene;
 }
 
-void expWidget::updateTestParams()
+std::queue<trial_params> expWidget::getTrials(const test_params &a_test)
 {
-    // check for end of experiment
-    if (m_parent->m_testQueue.empty()) {
-        m_expComplete = true;
-        return;
-    }
-
-    // pull next set of test parameters
-    m_testPrev = m_test;
-    m_test = m_parent->m_testQueue.front();
-    m_parent->m_testQueue.pop();
-
-    // update queue of trials
-    switch (m_test.p_type) {
+    // queue of trials for newly pulled test
+    switch (a_test.p_type) {
     case staircase:
-        m_trialsCurr = m_firstStairTrls[m_test.p_joint];
-        break;
+        return m_firstStairTrls[a_test.p_joint];
     case match1D:
-        if (m_test.p_vision) m_trialsCurr = m_1DMatchTrls_V[m_test.p_joint];
-        else                 m_trialsCurr = m_1DMatchTrls_NV[m_test.p_joint];
-        break;
+        if (a_test.p_vision) return m_1DMatchTrls_V[a_test.p_joint];
+        else                 return m_1DMatchTrls_NV[a_test.p_joint];
     case match2D:
-        if (m_test.p_vision) m_trialsCurr = m_2DMatchTrls_V;
-        else                 m_trialsCurr = m_2DMatchTrls_NV;
-        break;
+        if (a_test.p_vision) return m_2DMatchTrls_V;
+        else                 return m_2DMatchTrls_NV;
     default:
-        break;
+        return std::queue<trial_params>();
     }
 }
 
-void expWidget::updateTrialParams()
-{
-    // check for end of test (or beginning of experiment)
-    if (m_trialsCurr.empty()) {
-        m_testComplete = true;
-        updateTestParams();
-    }
-
-    // unless end of experiment, pull next set of trial parameters
-    if (!m_expComplete) {
-        m_trialPrev = m_trial;
-        m_trial = m_trialsCurr.front();
-        m_trialsCurr.pop();
-        if (m_testComplete) prepForTest();
-    }
-
-    // no need for break at beginning of experiment
-    if (m_state == welcome) m_testComplete = false;
-}
-
 void expWidget::prepForTest()
 {
     // initialize parameters for new test
+    expFsm::prepForTest();
     switch (m_test.p_type) {
-    case staircase:
-        m_stairStatus = 2;  // testing new joint
-        resetStaircase();
-        break;
     case match1D:
         m_subjAng = m_trial.p_ref;  // starting angle
-        m_numTrials = 0;
     case match2D:
         if (m_trial.p_ref < 0)  m_subjPos = m_center;                    // starting from center
         else                    m_subjPos = angleToTarg(m_trial.p_ref);  // starting from circle
-        m_numTrials = 0;
         break;
     default:
         break;
@@ -1126,263 +427,29 @@ void expWidget::prepForTest()
     }
 }
 
-exp_states expWidget::prepForNextTrial()
+void expWidget::prepForMatch()
 {
-    // update test variables & trial parameters
-    switch (m_test.p_type) {
-    case staircase:
-        updateStaircase();
-        switch (m_stairStatus) {
-        case 1:
-            resetStaircase();
-            break;
-        case 2:
-            updateTrialParams();   // get parameters for first trial of coming test
-            if (!m_testComplete)   // moving to a new angle for the current joint
-                resetStaircase();  // reset is done automatically when switching to new joint
-            break;
-        default:
-            break;
-        }
-        break;
-    case match1D:
-        updateTrialParams();
-        m_numTrials++;
-        if (!m_testComplete)
-            m_subjAng = m_trial.p_ref;
-        break;
-    case match2D:
-        updateTrialParams();
-        m_numTrials++;
-        if (!m_testComplete)
-            if (m_trial.p_ref < 0)  m_subjPos = m_center;                    // starting from center
-            else                    m_subjPos = angleToTarg(m_trial.p_ref);  // starting from circle
-        break;
-    default:
-        break;
-    }
-
-    // assign next experiment state (default = 'breaking')
-    if (m_expComplete) return thanks;
-
-    switch (m_test.p_type) {
-    case staircase:
-
-        // continuing with current (double) staircase
-        if (!m_stairStatus) {
-            m_cntdwn->setTimeoutPeriodSeconds(m_test.p_time);
-            m_cntdwn->start(true);
-            return waitingForResponse;
-        }
-
-        // visually ground (but no break) between staircases and joint angles
-        else if (m_stairStatus == 1 || (m_stairStatus == 2 && !m_testComplete))
-            return locking;
-
-        // break between joints
-        else {
-            m_breakTime = SHORT_BREAK;
-            m_testComplete = false;
-        }
-        break;
-
-    case match1D:
-
-        if (m_testComplete) {
-            if (m_test.p_type != m_testPrev.p_type ||
-                m_test.p_active != m_testPrev.p_active ||
-                m_test.p_vision != m_testPrev.p_vision)
-                    m_breakTime = LONG_BREAK;
-            else    m_breakTime = SHORT_BREAK;  // between joints
-            m_testComplete = false;
-        } else  return locking;
-        break;
-
-    case match2D:
-
-        if (m_testComplete) {
-            m_breakTime = LONG_BREAK;
-            m_testComplete = false;
-        } else if (!m_test.p_vision &&                                   // testing without visual feedback
-                   m_numTrials == NUM_REACH + m_numMatch*NUM_REACH/2) {  // & halfway done (after practice)
-            m_breakTime = SHORT_BREAK;
-        } else  return locking;
-        break;
-
-    default:
-        break;
+    // reset angle/position cursor to start of next matching trial
+    if (m_test.p_type == match1D) {
+        m_subjAng = m_trial.p_ref;
+    } else {
+        if (m_trial.p_ref < 0)  m_subjPos = m_center;                    // starting from center
+        else                    m_subjPos = angleToTarg(m_trial.p_ref);  // starting from circle
     }
-
-    // by default, send to break with time set above
-    m_clk->setTimeoutPeriodSeconds(m_breakTime*MIN_TO_SEC);
-    m_clk->start(true);
-    return breaking;
 }
 
-void expWidget::resetStaircase()
+bool expWidget::breakMidTest()
 {
-    // reset parameters independent of staircase status
-    for (int i = 0; i < 2; i++) {
-        m_numJudgements[i] = 0;
-        m_oneCorrect[i] = true;
-    }
-
-    // reset parameters for new SET of staircases (i.e., beginning to test new angle/joint)
-    if (m_stairStatus == 2) {
-        m_numStaircases = 0;
-        if (ADAPTIVE) m_maxStaircases = 6;
-        else          m_maxStaircases = 4;
-        for (int i = 0; i < 2; i++) m_refStep[i] = 10;
-        if (DOUB_STAIRS) {
-            if (m_trial.p_isPractice) m_maxStaircases = 2;             // 2 = 1 double-staircase
-            m_currStaircase = (m_trial.p_ref < m_trial.p_targ);        // either 0 (starting CLOSER to body) or 1
-            m_refStartSide[CLOSER] = 1; m_refStartSide[FURTHER] = -1;  // always {starts CLOSER, starts FURTHER}
-            m_refAng[m_currStaircase] = m_trial.p_ref;
-            m_refAng[!m_currStaircase] = m_trial.p_targ + m_refStartSide[!m_currStaircase]*START_DEV;
-            for (int i = 0; i < 2; i++) {
-                m_numReversals[i] = 0;
-                m_refStepDir[i] = -1*m_refStartSide[i];
-                m_corrResp[i] = (m_trial.p_targ >= m_refAng[i]);
-            }
-        } else {
-            if (m_trial.p_isPractice) m_maxStaircases = 1;
-            m_currStaircase = 0;
-            m_numReversals[0] = 0; m_numReversals[1] = MAX_REVERSAL;  // only want to work along first dimension of array
-            m_refStartSide[0] = (int)(m_trial.p_ref > m_trial.p_targ) - (int)(m_trial.p_ref < m_trial.p_targ);
-            m_refStepDir[0] = -1*m_refStartSide[0];
-            m_refAng[0] = m_trial.p_ref;
-            m_corrResp[0] = (m_trial.p_targ >= m_refAng[0]);
-        }
-    }
-
-    // reset parameters for next single or double staircase (within set for same joint angle)
-    else {
-        if (ADAPTIVE && m_numStaircases == 2)  estimatePerceptParams();
-        if (DOUB_STAIRS) {
-            m_currStaircase = m_numStaircases + (int)randBool();
-            m_refStartSide[CLOSER] = 1; m_refStartSide[FURTHER] = -1;
-            for (int i = 0; i < 2; i++) {
-                m_numReversals[i] = 0;
-                m_refStepDir[i] = -1*m_refStartSide[i];
-            }
-            if (ADAPTIVE && m_numStaircases >= 2) {
-                for (int i = 0; i < 2; i++) {
-                    m_refStep[i] = 5;
-                    m_refAng[i] = m_boundary + m_refStartSide[i]*m_sensitiv;
-                    m_corrResp[i] = (m_trial.p_targ >= m_refAng[i]);  // arm position stays same
-
-                    // possibly correct start side & step direction because where reference falls
-                    // relative to target is dependent on estimated perceptual parameters
-                    if (m_corrResp[i] == CLOSER) {
-                        m_refStartSide[i] = 1;
-                        m_refStepDir[i] = -1;
-                    } else {
-                        m_refStartSide[i] = -1;
-                        m_refStepDir[i] = 1;
-                    }
-                }
-            } else {
-                for (int i = 0; i < 2; i++) {
-                    m_refStep[i] = 10;
-                    m_refAng[i] = m_trial.p_targ + m_refStartSide[i]*START_DEV;
-                    m_corrResp[i] = (m_trial.p_targ >= m_refAng[i]);
-                }
-            }
-        } else {
-            m_currStaircase = m_numStaircases;
-            m_numReversals[0] = 0; m_numReversals[1] = MAX_REVERSAL;
-            m_refStartSide[0] = -1*m_refStartSide[0];  // flip relative to previous staircase
-            m_refStepDir[0] = -1*m_refStartSide[0];
-            if (ADAPTIVE && m_numStaircases >= 2) {
-                m_refStep[0] = 5;
-                m_refAng[0] = m_boundary + m_refStartSide[0]*m_sensitiv;
-                m_corrResp[0] = (m_trial.p_targ >= m_refAng[0]);
-                if (m_corrResp[0] == CLOSER) {
-                    m_refStartSide[0] = 1;
-                    m_refStepDir[0] = -1;
-                } else {
-                    m_refStartSide[0] = -1;
-                    m_refStepDir[0] = 1;
-                }
-            } else {
-                m_refStep[0] = 10;
-                m_refAng[0] = m_trial.p_targ + m_refStartSide[0]*START_DEV;
-                m_corrResp[0] = (m_trial.p_targ >= m_refAng[0]);
-            }
-        }
-
-        // set up for first trial of next single/double staircase
-        m_trial.p_ref = m_refAng[getStairIndex(m_currStaircase)];
-    }
+    // short break halfway through (non-practice) 2-D matching without visual feedback
+    return !m_test.p_vision && m_numTrials == NUM_REACH + m_numMatch*NUM_REACH/2;
 }
 
-void expWidget::updateStaircase()
-{
-    int i = getStairIndex(m_currStaircase);
-    m_numJudgements[i]++;
-    if (DEBUG)  qDebug() << "judgement #" << m_numJudgements[i];
-
-    // save tested reference angle if staircase is "adaptive"
-    if (ADAPTIVE && !m_trial.p_isPractice && m_numStaircases < 2)
-        m_refAngsForEstim[m_currStaircase].push_back(m_trial.p_ref);
-
-    // if judgement was first of current staircase (until one correct)
-    if (m_numJudgements[i] == 1 || !m_oneCorrect[i]) {
-        if (m_subjResp[i] != m_corrResp[i]) {
-            if (DEBUG)  qDebug() << "  WRONG, moving away from arm";
-            m_oneCorrect[i] = false;
-            m_refStepDir[i] = m_refStartSide[i];
-        } else {
-            if (DEBUG)  qDebug() << "  CORRECT, moving towards arm";
-            m_oneCorrect[i] = true;
-            m_refStepDir[i] = -1*m_refStartSide[i];
-        }
-        m_stairStatus = 0;
-    }
-
-    // once a correct judgement has been made
-    else {
-
-        // if reversed judgement
-        if (m_subjResp[i] != m_subjRespPrev[i]) {
-            m_numReversals[i]++;
-            if (DEBUG)  qDebug() << "  switched decision, reversing direction time #" << m_numReversals[i];
-            m_refStep[i] = 0.5*m_refStep[i];
-            m_refStepDir[i] = -1*m_refStepDir[i];
-            m_stairStatus = 0;
-
-            // if done with staircase
-            if (m_numReversals[i] == MAX_REVERSAL) {
-                m_numStaircases++;
-                if (DEBUG)  qDebug() << "  finished staircase #" << m_numStaircases;
-
-                // if done with BOTH staircases in double-staircase paradigm
-                // NOTE: because of how test variables are initialized, this
-                // ----  check also works for single-staircase paradigm
-                if (m_numReversals[!i] == MAX_REVERSAL) {
-                    m_stairStatus = 1;
-
-                    // if done with set of staircases
-                    if (m_numStaircases == m_maxStaircases) {
-                        m_stairStatus = 2;
-                    }
-                }
-            }
-        }
-    }
 
-    // if mid-staircase, update reference angle & trial params
-    if (!m_stairStatus) {
-        m_refAng[i] = m_refAng[i] + m_refStepDir[i]*m_refStep[i];
-        int i_next = randBool();
-        if (m_numReversals[i_next] == MAX_REVERSAL) i_next = (int)(!i_next);
-        if (DOUB_STAIRS) m_currStaircase = (int)floor(m_numStaircases/2)*2 + i_next;
-        else             m_currStaircase = m_numStaircases + i_next;
-        m_trial.p_ref = m_refAng[i_next];
-    }
+bool expWidget::reachedTarg()
+{
+    return m_parent->m_parent->m_exo->reachedTarg();
 }
 
-
 void expWidget::sendToGround()
 {
     m_parent->m_parent->m_exo->setTarg(m_groundPos*CM_TO_METERS, task);
@@ -1445,6 +512,24 @@ void expWidget::startTrialControl()
     m_parent->m_parent->m_exo->setCtrl(trialCtrl);
 }
 
+void expWidget::startResponse()
+{
+    // start countdown for trial (reset from 0.0 sec)
+    m_cntdwn->setTimeoutPeriodSeconds(m_test.p_time);
+    m_cntdwn->start(true);
+}
+
+void expWidget::startTimer(double a_period)
+{
+    m_clk->setTimeoutPeriodSeconds(a_period);
+    m_clk->start(true);
+}
+
+bool expWidget::timerExpired()
+{
+    return m_clk->timeoutOccurred();
+}
+
 
 void expWidget::recordSubjParams()
 {
@@ -1477,8 +562,8 @@ void expWidget::recordExpParams()
     // write parameters for (all possible) tests if file exists
     if (m_outputFile != NULL) {
         fprintf(m_outputFile, "Parallax Correction: %i\n", (int)CORR_PARALL);
-        fprintf(m_outputFile, "Double-Randomized Staircase: %i\n", (int)DOUB_STAIRS);
-        fprintf(m_outputFile, "Adaptive Staircase: %i\n", (int)ADAPTIVE);
+        fprintf(m_outputFile, "Double-Randomized Staircase: %i\n", (int)m_stair.m_params.p_doubStairs);
+        fprintf(m_outputFile, "Adaptive Staircase: %i\n", (int)m_stair.m_params.p_adaptive);
         fprintf(m_outputFile, "Grounding Position: [%f, %f] m\n", m_groundPos(0)*CM_TO_METERS, m_groundPos(1)*CM_TO_METERS);
         fprintf(m_outputFile, "Grounding Angles: [%f, %f] deg\n", m_groundAng(0), m_groundAng(1));
         fprintf(m_outputFile, "Shoulder Test Angles: [%f, %f, %f] deg\n", m_targAngs[0][0], m_targAngs[0][1], m_targAngs[0][2]);
@@ -1540,11 +625,11 @@ void expWidget::saveData()
         temp.d_timeOut = m_timeOut;
 
         // record staircase data
-        int i = getStairIndex(m_currStaircase);
-        temp.d_currStaircase = m_currStaircase;
-        temp.d_numJudgements = m_numJudgements[i];
-        temp.d_subjResp = m_subjResp[i];
-        temp.d_corrResp = m_corrResp[i];
+        int i = m_stair.getStairIndex();
+        temp.d_currStaircase = m_stair.m_currStaircase;
+        temp.d_numJudgements = m_stair.m_numJudgements[i];
+        temp.d_subjResp = m_stair.m_subjResp[i];
+        temp.d_corrResp = m_stair.m_corrResp[i];
 
         // record matching data
         temp.d_numTrials = m_numTrials;
@@ -1603,6 +688,37 @@ void expWidget::recordData()
 }
 
 
+bool expWidget::proceedRequested()
+{
+    if (m_keyPressed && m_key == Qt::Key_Space) {
+        m_keyPressed = false;
+        return true;
+    }
+    return false;
+}
+
+bool expWidget::skipRequested()
+{
+    if (m_keyPressed && m_key == Qt::Key_S) {
+        m_keyPressed = false;
+        return true;
+    }
+    return false;
+}
+
+bool expWidget::responded()
+{
+    checkForResp();
+    return m_trialComplete || m_timeOut;
+}
+
+void expWidget::recordResponse()
+{
+    recordData();
+    m_trialComplete = 0;
+    m_timeOut = false;
+}
+
 void expWidget::checkForResp()
 {
     // check for mouse event before keyboard
@@ -1639,7 +755,7 @@ void expWidget::checkForResp()
 
 void expWidget::processKey()
 {
-    int i = getStairIndex(m_currStaircase);
+    int i = m_stair.getStairIndex();
     switch (m_test.p_type) {
 
     // for staircase, R/L = (forced) choice
@@ -1647,13 +763,11 @@ void expWidget::processKey()
 
         switch (m_key) {
         case Qt::Key_Right:
-            m_subjRespPrev[i] = m_subjResp[i];
-            m_subjResp[i] = FURTHER;
+            m_stair.respond(FURTHER);
             m_trialComplete = 1;
             break;
         case Qt::Key_Left:
-            m_subjRespPrev[i] = m_subjResp[i];
-            m_subjResp[i] = CLOSER;
+            m_stair.respond(CLOSER);
             m_trialComplete = 1;
             break;
         default:
@@ -1662,9 +776,9 @@ void expWidget::processKey()
         }
         if (DEBUG) {
             qDebug() << "";
-            if (m_corrResp[i] == FURTHER)  qDebug() << "  correct response = FURTHER";
+            if (m_stair.m_corrResp[i] == FURTHER)  qDebug() << "  correct response = FURTHER";
             else                           qDebug() << "  correct response = CLOSER";
-            if (m_subjResp[i] == FURTHER)  qDebug() << "  subject response = FURTHER";
+            if (m_stair.m_subjResp[i] == FURTHER)  qDebug() << "  subject response = FURTHER";
             else                           qDebug() << "  subject response = CLOSER";
         }
         break;
@@ -1763,22 +877,19 @@ void expWidget::processKey()
 
 void expWidget::processButton()
 {
-    int i = getStairIndex(m_currStaircase);
     switch (m_test.p_type) {
 
     // for staircase, R/L = (forced) choice
     case staircase:
         switch (m_button) {
         case Qt::RightButton:
-            m_subjRespPrev[i] = m_subjResp[i];
-            if (m_parent->m_parent->m_exo->m_subj->m_rightHanded) m_subjResp[i] = FURTHER;
-            else                                                  m_subjResp[i] = CLOSER;
+            if (m_parent->m_parent->m_exo->m_subj->m_rightHanded) m_stair.respond(FURTHER);
+            else                                                  m_stair.respond(CLOSER);
             m_trialComplete = 1;
             break;
         case Qt::LeftButton:
-            m_subjRespPrev[i] = m_subjResp[i];
-            if (m_parent->m_parent->m_exo->m_subj->m_rightHanded) m_subjResp[i] = CLOSER;
-            else                                                  m_subjResp[i] = FURTHER;
+            if (m_parent->m_parent->m_exo->m_subj->m_rightHanded) m_stair.respond(CLOSER);
+            else                                                  m_stair.respond(FURTHER);
             m_trialComplete = 1;
             break;
         default:
@@ -1879,46 +990,9 @@ void expWidget::processScroll()
 }
 
 
-int expWidget::getStairIndex(int currStaircase)
-{
-    if (DOUB_STAIRS) {
-        return fmod(currStaircase,2);
-    } else {
-        return 0;  // don't really need array if only one staircase at a time
-    }
-}
-
-void expWidget::estimatePerceptParams()
-{
-    // extract last 4 angles tested in staircases 1 & 2
-    vector<double> data;
-    for (int sc = 0; sc < 2; sc++) {
-        int numJudgements = m_refAngsForEstim[sc].size();
-        for (int i = 0; i < NUM_FOR_EST; i++) {
-            data.push_back(m_refAngsForEstim[sc][numJudgements-(i+1)]);
-        }
-        m_refAngsForEstim[sc].clear();
-    }
-
-    // estimate perceptual boundary & sensitivity (mean/range of last 4 angles tested in staircases 1 & 2)
-    double max = -180;
-    double min = 180;
-    double sum = 0;
-    for(vector<double>::iterator it = data.begin(); it != data.end(); ++it) {
-        if (*it > max) max = *it;
-        if (*it < min) min = *it;
-        sum = sum + *it;
-    }
-    m_boundary = sum/data.size();
-    m_sensitiv = 0.75*(max-min);
-    if (DEBUG)  qDebug() << "** boundary = " << m_boundary << " / sensitivity = " << m_sensitiv << " **";
-}
-
 chai3d::cVector3d expWidget::angleToTarg(double ang)
 {
-    double xTarg = REACH_DIST*cos(ang*PI/180) + m_center(0);
-    double yTarg = REACH_DIST*sin(ang*PI/180) + m_center(1);
-    return cVector3d(xTarg, yTarg, 0.0);
+    return m_scene->angleToTarg(ang);
 }
 
 std::vector<double> expWidget::getStartTargs(double ang)
@@ -1939,20 +1013,6 @@ std::vector<double> expWidget::getStartTargs(double ang)
     return startPos;
 }
 
-void expWidget::hideTestStateLabels()
-{
-    m_labelPractice->setShowEnabled(false);
-    m_labelCntdwn->setShowEnabled(false);
-    m_labelTestType->setShowEnabled(false);
-    m_labelJoint->setShowEnabled(false);
-    m_labelActive->setShowEnabled(false);
-    m_labelVision->setShowEnabled(false);
-    m_labelNumStair->setShowEnabled(false);
-    m_labelNumJudge->setShowEnabled(false);
-    m_labelNumRev->setShowEnabled(false);
-    m_labelNumTrial->setShowEnabled(false);
-}
-
 int expWidget::randInRange(int low, int high)
 {
     return (int) (low + rand() % (high-low+1));
@@ -1984,13 +1044,18 @@ void expWidget::paintGL()
 {
     if (!m_running) return;
 
+    // take latest experiment state
+    // NOTE: only the GUI thread touches the scene, so lock is held just for the copy
     m_worldLock.acquire();
+    bool dirty = m_sceneDirty;
+    scene_state scene = m_sceneState;
+    m_sceneDirty = false;
+    m_worldLock.release();
 
-    // render world
-    m_camera->renderView(m_width, m_height);
+    // push changes into scene (at most once per frame) & render world
+    if (dirty) m_scene->update(scene, m_width, m_height);
+    m_scene->render(m_width, m_height);
     glFinish();
-
-    m_worldLock.release();
 }
 
 void expWidget::resizeGL(int a_width, int a_height)
@@ -1999,6 +1064,7 @@ void expWidget::resizeGL(int a_width, int a_height)
 
     m_width = a_width;
     m_height = a_height;
+    m_sceneDirty = true;  // reposition labels
 
     m_worldLock.release();
 }
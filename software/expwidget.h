@@ -4,6 +4,8 @@
 #include "chai3d.h"
 #include "expwindow.h"
 #include "exo.h"
+#include "expfsm.h"
+#include "expscene.h"
 #include <cstdlib>
 #include <cmath>
 #include <cstdio>
@@ -28,20 +30,6 @@
                        // NOTE: this implicitly defines the number of matches per target position
                        // ----  (see function 'targToStartPos')
 
-// enumeration of experiment states in FSM
-typedef enum
-{
-    welcome,
-    locking,
-    pause,
-    resetting,
-    grounding,
-    setting,
-    waitingForResponse,
-    breaking,
-    thanks
-} exp_states;
-
 // data to be recorded for offline analysis
 typedef struct
 {
@@ -73,40 +61,18 @@ typedef struct
 
 void _expThread(void *arg);  // pointer to thread function (not a class member)
 
-class expWidget : public QGLWidget
+class expWidget : public QGLWidget, public expFsm
 {
 public:
     ExpWindow* m_parent;                  // pointer to experiment window
 
     chai3d::cThread m_thread;             // experiment thread
-    chai3d::cMutex m_worldLock;           // mutex for graphics updates
+    chai3d::cMutex m_worldLock;           // mutex for scene state passed from experiment thread to graphics
     chai3d::cMutex m_runLock;             // mutex for experiment updates
 
-    chai3d::cWorld* m_world;              // CHAI world
-    chai3d::cCamera* m_camera;            // camera to render the world
-    chai3d::cDirectionalLight* m_light;   // light to illuminate the world
-    chai3d::cShapeCylinder* m_angle;      // "infinitely" long cylinder representing test angle for 1-D tests (static in active test, dynamic in passive test)
-    chai3d::cShapeSphere* m_target;       // sphere representing target position for 2-D matching (static in active test, dynamic in passive test)
-    chai3d::cShapeCylinder* m_upperarm;   // cylinder representing upperarm
-    chai3d::cShapeCylinder* m_forearm;    // cylinder representing forearm
-    chai3d::cShapeCylinder* m_upperarmL;  // "infinitely" long cylinder representing upperarm for 1-D tests
-    chai3d::cShapeCylinder* m_forearmL;   // "infinitely" long cylinder representing forearm for 1-D tests
-    chai3d::cShapeSphere* m_shoulder;     // sphere representing shoulder joint
-    chai3d::cShapeSphere* m_elbow;        // sphere representing elbow joint
-    chai3d::cShapeSphere* m_hand;         // sphere representing hand
-    chai3d::cLabel* m_instruct;           // instructional message for subject
-    chai3d::cLabel* m_note;               // note for experimenter
-    chai3d::cLabel* m_remind;             // reminder for subject about current state/test
-    chai3d::cLabel* m_labelPractice;      // large label denoting current trial as practice
-    chai3d::cLabel* m_labelCntdwn;        // large label displaying seconds left in current trial
-    chai3d::cLabel* m_labelTestType;      // label for number of joints being tested (1 or 2)
-    chai3d::cLabel* m_labelJoint;         // label for current joint being tested (S, E, or --)
-    chai3d::cLabel* m_labelActive;        // label for current movement condition (active or passive)
-    chai3d::cLabel* m_labelVision;        // label for current vision condition (with or without)
-    chai3d::cLabel* m_labelNumStair;      // label for current staircase number for current joint & test angle
-    chai3d::cLabel* m_labelNumJudge;      // label for number of judgements made during current staircase pair: (above, below)
-    chai3d::cLabel* m_labelNumRev;        // label for number of judgement reversals during current staircase pair: (above, below)
-    chai3d::cLabel* m_labelNumTrial;      // label for number of matching trials performed for given test (& joint if 1-D test)
+    expScene* m_scene;                    // scene shown to subject (world, camera, arm, targets & labels)
+    scene_state m_sceneState;             // latest experiment state to be drawn
+    bool m_sceneDirty;                    // TRUE = 'm_sceneState' changed since last rendered frame
 
     bool m_running;                       // TRUE = experiment thread is running
     QBasicTimer* m_timer;                 // timer for graphics updates
@@ -131,43 +97,15 @@ public:
     void* expThread();
 
 protected:
-    // overall experiment
-    exp_states m_state;                                  // current experiment state
-    test_params m_test;                                  // parameters for current test
-    test_params m_testPrev;                              // parameters for previous test
-    trial_params m_trial;                                // parameters for current trial
-    trial_params m_trialPrev;                            // parameters for previous trial
-    std::queue<trial_params> m_trialsCurr;               // queue of trials for current test
+    // overall experiment (test & trial sequencing in 'expFsm')
     int m_trialComplete;                                 // 1 = current trial is complete (i.e., subject responded), 2 = skipped trial, 0 = not yet complete
     int m_timeRemaining;                                 // time remaining trial until 'time out' [sec]
     bool m_timeOut;                                      // TRUE = timer expired for current trial (signals end of trial for all but staircase)
-    bool m_testComplete;                                 // TRUE = all trials of given test type are complete
-    bool m_expComplete;                                  // TRUE = all tests are complete
-    bool m_lockSignal;                                   // TRUE = experimenter must MANUALLY (un)lock joint(s)
-    int m_breakTime;                                     // break time [min]
 
     // staircase tests
-    int m_stairStatus;                                   // status of staircase test: 2 = beginning new angle/joint, 1 = beginning new (double) staircase, 0 = mid-staircase
-    int m_numStaircases;                                 // number of staircases completed for current joint & test angle
-    int m_currStaircase;                                 // current staircase (only important if double staircase)
-    int m_maxStaircases;                                 // 6 normally (if double-staircase, 3 sets of 2), 1 for practice (1 set of 2)
-    int m_numJudgements[2];                              // number of judgements made during current staircase (pair)
-    int m_numReversals[2];                               // number of judgement reversals during current staircase (pair)
-    int m_refStartSide[2];                               // 1 = visual reference starts CLOSER to body relative to test angle, -1 = FURTHER from body
-    int m_refStepDir[2];                                 // (+/-)1 depending on where reference falls relative to test angles
-    double m_refStep[2];                                 // step size for visual reference between judgements [deg]
-    double m_refAng[2];                                  // angle of visual reference, for current judgement [deg]
-    bool m_corrResp[2];                                  // correct response to 2AFC: TRUE = FURTHER, FALSE = CLOSER (reference relative to test angle)
-    bool m_subjResp[2];                                  // subject's response to 2AFC: TRUE = FURTHER, FALSE = CLOSER (reference relative to test angle)
-    bool m_subjRespPrev[2];                              // subject response from previous judgement
-    bool m_oneCorrect[2];                                // TRUE = correctly answered one 2AFC
-    double m_boundary;                                   // estimate of subject's proprioceptive boundary, used if adaptive [deg]
-    double m_sensitiv;                                   // estimate of subject's proprioceptive sensitivity, used if adaptive [deg]
-    std::vector<double> m_refAngsForEstim[2];            // vectors for tracking visual reference angles over staircases 1-2 [deg]
     std::queue<trial_params> m_firstStairTrls[NUM_JNT];  // queues of test angles for joint staircases (randomized) [deg]
 
     // 1-D matching tests
-    int m_numTrials;                                     // number of matching trials performed for given test (& joint if 1-D test)
     double m_subjAng;                                    // angle of subject's joint (active)/angle cursor (passive), for 1-D matching [deg]
     std::queue<trial_params> m_1DMatchTrls_NV[NUM_JNT];  // queues of target angles for 1-D matching without visual feedback (randomized) [deg]
     std::queue<trial_params> m_1DMatchTrls_V[NUM_JNT];   // queues of target angles for 1-D matching WITH visual feeback (randomized) [deg]
@@ -197,16 +135,6 @@ protected:
                                                          // NOTE: only a subset of these tested WITH visual feedback
 
     // graphics
-    // (NOTE: we move camera to align graphics with real world
-    //  instead of continually adding on an (x,y) offset)
-    double m_camX;                                       // x-coordinate of camera viewing the world [m]
-    double m_camY;                                       // y-coordinate of camera viewing the world [m]
-    double m_scaleFactor;                                // factor by which to scale graphics, used for parallax correction
-    chai3d::cVector3d m_scalePoint;                      // point about which to scale graphics, used for parallax correction [m]
-    chai3d::cVector3d m_camPos;                          // position of camera viewing the world [m]
-    chai3d::cVector3d m_camLookAt;                       // point at which camera is pointing [m]
-    chai3d::cVector3d m_camUp;                           // vector pointing to top of field of view (FOV) [m]
-    chai3d::cVector3d m_shldOff;                         // offset of shoulder relative to graphics origin [m]
     chai3d::cVector3d m_groundPos;                       // hand position for visual grounding (constant across experiment) [cm]
     chai3d::cVector3d m_groundAng;                       // joint angles for visual grounding (correspond exactly to position above) [deg]
 
@@ -223,20 +151,23 @@ protected:
 
     // update functions
     void updateExperiment();
-    void updateGraphics();
-    void updateLabels();
-    void updateTestParams();
-    void updateTrialParams();
+    scene_state getSceneState();
+    std::queue<trial_params> getTrials(const test_params &a_test);
     void prepForTest();
-    exp_states prepForNextTrial();
-    void updateStaircase();
-    void resetStaircase();
+    void prepForMatch();
+    bool breakMidTest();
 
     // exo control functions
+    bool reachedTarg();
     void sendToGround();
     void sendToStart();
     void startTrialControl();
 
+    // timing functions
+    void startResponse();
+    void startTimer(double a_period);
+    bool timerExpired();
+
     // data recording functions
     void recordSubjParams();
     void recordExpParams();
@@ -245,17 +176,18 @@ protected:
     void recordData();
 
     // user-input functions
+    bool proceedRequested();
+    bool skipRequested();
+    bool responded();
+    void recordResponse();
     void checkForResp();
     void processKey();
     void processButton();
     void processScroll();
 
     // "small" helper functions
-    int getStairIndex(int currStaircase);
-    void estimatePerceptParams();
     chai3d::cVector3d angleToTarg(double ang);
     std::vector<double> getStartTargs(double ang);
-    void hideTestStateLabels();
     int randInRange(int low, int high);
     bool randBool();
     int randSign();
@@ -39,6 +39,12 @@ void ExpWindow::pairWithMainWindow(MainWindow *a_parent)
     m_parent = a_parent;
 }
 
+void ExpWindow::setPrimitiveBatching(bool a_enabled)
+{
+    // NOTE: only call before graphics start (world not locked)
+    ui->display->m_scene->m_world->setUsePrimitiveBatching(a_enabled);
+}
+
 void ExpWindow::startExp()
 {
     ui->display->start();
@@ -59,6 +59,7 @@ void cGELMesh::initialise()
     m_showMassParticleModel = false;
     m_useSkeletonModel = false;
     m_useMassParticleModel = false;
+    m_useSolver = false;
 }
 
 
@@ -78,7 +79,7 @@ void cGELMesh::clearForces()
             (*i)->clearForces();
         }
     }
-    if (m_useMassParticleModel)
+    if (m_useMassParticleModel && !m_useSolver)
     {
         vector<cGELVertex>::iterator i;
 
@@ -135,7 +136,7 @@ void cGELMesh::computeForces()
             (*i)->computeForces();
         }
     }
-    if (m_useMassParticleModel)
+    if (m_useMassParticleModel && !m_useSolver)
     {
         list<cGELLinearSpring*>::iterator i;
 
@@ -166,7 +167,7 @@ void cGELMesh::computeNextPose(double a_timeInterval)
             (*i)->computeNextPose(a_timeInterval);
         }
     }
-    if (m_useMassParticleModel)
+    if (m_useMassParticleModel && !m_useSolver)
     {
         vector<cGELVertex>::iterator i;
 
@@ -194,7 +195,7 @@ void cGELMesh::applyNextPose()
             (*i)->applyNextPose();
         }
     }
-    if (m_useMassParticleModel)
+    if (m_useMassParticleModel && !m_useSolver)
     {
         vector<cGELVertex>::iterator i;
 
@@ -151,6 +151,9 @@ public:
     //! If __true__ then use vertex mass particle model.
     bool m_useMassParticleModel;
 
+    //! If __true__ then the mass particle model is integrated by the solver of the world (see cGELWorld::setUseSolver()).
+    bool m_useSolver;
+
 
     //-----------------------------------------------------------------------
     // METHODS:
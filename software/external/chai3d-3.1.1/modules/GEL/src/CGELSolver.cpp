@@ -0,0 +1,614 @@
+//===========================================================================
+/*
+    Software License Agreement (BSD License)
+    Copyright (c) 2003-2016, CHAI3D.
+    (www.chai3d.org)
+
+    All rights reserved.
+
+    Redistribution and use in source and binary forms, with or without
+    modification, are permitted provided that the following conditions
+    are met:
+
+    * Redistributions of source code must retain the above copyright
+    notice, this list of conditions and the following disclaimer.
+
+    * Redistributions in binary form must reproduce the above
+    copyright notice, this list of conditions and the following
+    disclaimer in the documentation and/or other materials provided
+    with the distribution.
+
+    * Neither the name of CHAI3D nor the names of its contributors may
+    be used to endorse or promote products derived from this software
+    without specific prior written permission.
+
+    THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS
+    "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT
+    LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS
+    FOR A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE
+    COPYRIGHT OWNER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT,
+    INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING,
+    BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES;
+    LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER
+    CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT
+    LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN
+    ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE
+    POSSIBILITY OF SUCH DAMAGE. 
+
+    \author    <http://www.chai3d.org>
+    \version   3.1.1 $Rev: 1869 $
+*/
+//===========================================================================
+
+//---------------------------------------------------------------------------
+#include "CGELSolver.h"
+//---------------------------------------------------------------------------
+#include <unordered_map>
+//---------------------------------------------------------------------------
+using namespace chai3d;
+using namespace std;
+//---------------------------------------------------------------------------
+
+//===========================================================================
+/*!
+    Constructor of cGELSolver.
+
+    \param  a_numThreads  Number of threads used by the solver. If zero, 
+                          one thread per core is used.
+*/
+//===========================================================================
+cGELSolver::cGELSolver(const int a_numThreads)
+{
+    m_integrator = C_GEL_EXPLICIT_EULER;
+    m_timeInterval = 0.0;
+    m_numMeshes = 0;
+    m_numVertices = 0;
+    m_numSpringsPacked = 0;
+    m_jobSize = 0;
+    m_generation = 0;
+    m_pending = 0;
+    m_quit = false;
+
+    // start worker threads
+    int numThreads = a_numThreads;
+    if (numThreads < 1)
+    {
+        numThreads = cMax(1, (int)(thread::hardware_concurrency()));
+    }
+    for (int i=1; i<numThreads; i++)
+    {
+        m_workers.push_back(thread(&cGELSolver::workerLoop, this, i));
+    }
+}
+
+
+//===========================================================================
+/*!
+    Destructor of cGELSolver.
+*/
+//===========================================================================
+cGELSolver::~cGELSolver()
+{
+    // stop worker threads
+    {
+        lock_guard<mutex> lock(m_mutex);
+        m_quit = true;
+    }
+    m_wake.notify_all();
+    for (unsigned int i=0; i<m_workers.size(); i++)
+    {
+        m_workers[i].join();
+    }
+}
+
+
+//===========================================================================
+/*!
+    This method packs the particles and springs of the mass particle models
+    of a list of deformable objects. Objects which use a mass particle model
+    are flagged so that they are no longer integrated individually.
+
+    \param  a_meshes  List of deformable objects.
+*/
+//===========================================================================
+void cGELSolver::build(list<cGELMesh*>& a_meshes)
+{
+    m_particles.clear();
+    m_springNode0.clear();
+    m_springNode1.clear();
+    m_springK.clear();
+    m_springLength0.clear();
+    m_numMeshes = 0;
+    m_numVertices = 0;
+    m_numSpringsPacked = 0;
+
+    // index particles
+    unordered_map<cGELMassParticle*, int> index;
+    auto addParticle = [&](cGELMassParticle* a_particle)
+    {
+        auto it = index.find(a_particle);
+        if (it != index.end()) { return (it->second); }
+        int i = (int)(m_particles.size());
+        index[a_particle] = i;
+        m_particles.push_back(a_particle);
+        return (i);
+    };
+
+    list<cGELMesh*>::iterator i;
+    for(i = a_meshes.begin(); i != a_meshes.end(); ++i)
+    {
+        cGELMesh *nextItem = *i;
+        nextItem->m_useSolver = nextItem->m_useMassParticleModel;
+        if (!nextItem->m_useSolver) { continue; }
+
+        m_numMeshes++;
+        m_numVertices += (int)(nextItem->m_gelVertices.size());
+        m_numSpringsPacked += (int)(nextItem->m_linearSprings.size());
+
+        vector<cGELVertex>::iterator j;
+        for(j = nextItem->m_gelVertices.begin(); j != nextItem->m_gelVertices.end(); ++j)
+        {
+            if (j->m_massParticle != NULL) { addParticle(j->m_massParticle); }
+        }
+
+        list<cGELLinearSpring*>::iterator k;
+        for(k = nextItem->m_linearSprings.begin(); k != nextItem->m_linearSprings.end(); ++k)
+        {
+            m_springNode0.push_back(addParticle((*k)->m_node0));
+            m_springNode1.push_back(addParticle((*k)->m_node1));
+            m_springK.push_back((*k)->m_kSpringElongation);
+            m_springLength0.push_back((*k)->m_length0);
+        }
+    }
+
+    // allocate buffers
+    int numParticles = (int)(m_particles.size());
+    int numSprings = (int)(m_springNode0.size());
+    for (vector<double>* v : { &m_posX, &m_posY, &m_posZ, &m_velX, &m_velY, &m_velZ,
+                               &m_nextVelX, &m_nextVelY, &m_nextVelZ, &m_rhsX, &m_rhsY, &m_rhsZ,
+                               &m_diagonal })
+    {
+        v->assign(numParticles, 0.0);
+    }
+    m_fixed.assign(numParticles, 0);
+    for (vector<double>* v : { &m_springForceX, &m_springForceY, &m_springForceZ })
+    {
+        v->assign(numSprings, 0.0);
+    }
+
+    // build adjacency list of particles (counting sort by particle)
+    m_adjacencyStart.assign(numParticles + 1, 0);
+    for (int s=0; s<numSprings; s++)
+    {
+        m_adjacencyStart[m_springNode0[s] + 1]++;
+        m_adjacencyStart[m_springNode1[s] + 1]++;
+    }
+    for (int p=0; p<numParticles; p++)
+    {
+        m_adjacencyStart[p + 1] += m_adjacencyStart[p];
+    }
+    m_adjacency.resize(2 * numSprings);
+    vector<int> fill(m_adjacencyStart.begin(), m_adjacencyStart.end() - 1);
+    for (int s=0; s<numSprings; s++)
+    {
+        m_adjacency[fill[m_springNode0[s]]++] = 2 * s;
+        m_adjacency[fill[m_springNode1[s]]++] = 2 * s + 1;
+    }
+}
+
+
+//===========================================================================
+/*!
+    This method checks whether the solver still matches the mass particle 
+    models of a list of deformable objects, by comparing the number of 
+    objects, vertices and springs with those packed by \ref build().
+
+    \param  a_meshes  List of deformable objects.
+
+    \return __true__ if the solver is up to date, __false__ otherwise.
+*/
+//===========================================================================
+bool cGELSolver::isValid(list<cGELMesh*>& a_meshes) const
+{
+    int numMeshes = 0;
+    int numVertices = 0;
+    int numSprings = 0;
+
+    list<cGELMesh*>::const_iterator i;
+    for(i = a_meshes.begin(); i != a_meshes.end(); ++i)
+    {
+        cGELMesh *nextItem = *i;
+        if (nextItem->m_useMassParticleModel != nextItem->m_useSolver) { return (false); }
+        if (!nextItem->m_useMassParticleModel) { continue; }
+
+        numMeshes++;
+        numVertices += (int)(nextItem->m_gelVertices.size());
+        numSprings += (int)(nextItem->m_linearSprings.size());
+    }
+
+    return ((numMeshes == m_numMeshes) && 
+            (numVertices == m_numVertices) && 
+            (numSprings == m_numSpringsPacked));
+}
+
+
+//===========================================================================
+/*!
+    This method integrates all mass particle models over a time interval 
+    passed as argument.
+
+    \param  a_timeInterval  Time interval.
+*/
+//===========================================================================
+void cGELSolver::step(const double a_timeInterval)
+{
+    int numParticles = (int)(m_particles.size());
+    int numSprings = (int)(m_springNode0.size());
+    if (numParticles == 0) { return; }
+
+    m_timeInterval = a_timeInterval;
+
+    // read positions, then compute spring forces
+    parallelFor(numParticles, [this](int a, int b) { gatherParticles(a, b); });
+    parallelFor(numSprings, [this](int a, int b) { computeSpringForces(a, b); });
+
+    // integrate and update particles
+    if (m_integrator == C_GEL_IMPLICIT_EULER)
+    {
+        parallelFor(numParticles, [this](int a, int b) { prepareImplicit(a, b); });
+        for (int i=0; i<C_GEL_IMPLICIT_ITERATIONS; i++)
+        {
+            parallelFor(numParticles, [this](int a, int b) { iterateImplicit(a, b); });
+            m_velX.swap(m_nextVelX);
+            m_velY.swap(m_nextVelY);
+            m_velZ.swap(m_nextVelZ);
+        }
+        parallelFor(numParticles, [this](int a, int b) { scatterParticles(a, b); });
+    }
+    else
+    {
+        parallelFor(numParticles, [this](int a, int b) { integrateExplicit(a, b); });
+    }
+}
+
+
+//===========================================================================
+/*!
+    This method reads the positions of a range of particles.
+
+    \param  a_first  Index of first particle.
+    \param  a_last   Index after last particle.
+*/
+//===========================================================================
+void cGELSolver::gatherParticles(const int a_first, const int a_last)
+{
+    for (int i=a_first; i<a_last; i++)
+    {
+        const cVector3d& pos = m_particles[i]->m_pos;
+        m_posX[i] = pos(0);
+        m_posY[i] = pos(1);
+        m_posZ[i] = pos(2);
+    }
+}
+
+
+//===========================================================================
+/*!
+    This method computes the elongation forces of a range of springs (see
+    \ref cGELLinearSpring::computeForces()).
+
+    \param  a_first  Index of first spring.
+    \param  a_last   Index after last spring.
+*/
+//===========================================================================
+void cGELSolver::computeSpringForces(const int a_first, const int a_last)
+{
+    const int* node0 = m_springNode0.data();
+    const int* node1 = m_springNode1.data();
+    const double* posX = m_posX.data();
+    const double* posY = m_posY.data();
+    const double* posZ = m_posZ.data();
+
+    for (int s=a_first; s<a_last; s++)
+    {
+        double dx = posX[node1[s]] - posX[node0[s]];
+        double dy = posY[node1[s]] - posY[node0[s]];
+        double dz = posZ[node1[s]] - posZ[node0[s]];
+        double length = sqrt(dx*dx + dy*dy + dz*dz);
+
+        // if distance too small, no forces are applied
+        double f = (length > 0.000001) ? (m_springK[s] * (length - m_springLength0[s]) / length) : 0.0;
+
+        m_springForceX[s] = f * dx;
+        m_springForceY[s] = f * dy;
+        m_springForceZ[s] = f * dz;
+    }
+}
+
+
+//===========================================================================
+/*!
+    This method sums spring forces onto a range of particles, then 
+    integrates them with the semi-implicit Euler method of 
+    \ref cGELMassParticle::computeNextPose(). Properties, velocities and
+    external forces are read from the particles, which are updated in the
+    same pass.
+
+    \param  a_first  Index of first particle.
+    \param  a_last   Index after last particle.
+*/
+//===========================================================================
+void cGELSolver::integrateExplicit(const int a_first, const int a_last)
+{
+    double h = m_timeInterval;
+
+    for (int i=a_first; i<a_last; i++)
+    {
+        cGELMassParticle* particle = m_particles[i];
+        if (particle->m_fixed) 
+        { 
+            particle->m_nextPos = particle->m_pos;
+            continue; 
+        }
+
+        // sum spring forces
+        double fx = 0.0;
+        double fy = 0.0;
+        double fz = 0.0;
+        for (int a=m_adjacencyStart[i]; a<m_adjacencyStart[i+1]; a++)
+        {
+            int s = m_adjacency[a] >> 1;
+            double sign = (m_adjacency[a] & 1) ? -1.0 : 1.0;
+            fx += sign * m_springForceX[s];
+            fy += sign * m_springForceY[s];
+            fz += sign * m_springForceZ[s];
+        }
+        cVector3d force(fx, fy, fz);
+
+        // gravity, damping and external forces
+        double m = particle->m_mass;
+        if (particle->m_useGravity)
+        {
+            force.add(m * particle->m_gravity);
+        }
+        force.add((-particle->m_kDampingPos * m) * particle->m_vel);
+        force.add(particle->getExternalForce());
+
+        // Euler double integration for position
+        particle->m_acc = (1.0 / m) * force;
+        particle->m_vel.add(h * particle->m_acc);
+        particle->m_pos.set(m_posX[i] + h * particle->m_vel(0),
+                            m_posY[i] + h * particle->m_vel(1),
+                            m_posZ[i] + h * particle->m_vel(2));
+        particle->m_nextPos = particle->m_pos;
+    }
+}
+
+
+//===========================================================================
+/*!
+    This method prepares the implicit (backward) Euler integration of a 
+    range of particles. \n\n
+
+    Linearizing spring forces with an isotropic stiffness k per spring, the
+    next velocity v' of particle i satisfies:\n
+    (m (1 + h d) + h^2 sum(k)) v'_i = m v_i + h f_i + h^2 sum(k v'_j)\n
+    where d is the damping, f_i the forces at the current positions and j 
+    the particles attached to i by springs. This method reads properties,
+    velocities and external forces from the particles, and computes the 
+    diagonal and constant terms of this system.
+
+    \param  a_first  Index of first particle.
+    \param  a_last   Index after last particle.
+*/
+//===========================================================================
+void cGELSolver::prepareImplicit(const int a_first, const int a_last)
+{
+    double h = m_timeInterval;
+
+    for (int i=a_first; i<a_last; i++)
+    {
+        const cGELMassParticle* particle = m_particles[i];
+
+        // fixed particles do not move
+        m_fixed[i] = particle->m_fixed;
+        if (m_fixed[i])
+        {
+            m_velX[i] = 0.0;
+            m_velY[i] = 0.0;
+            m_velZ[i] = 0.0;
+            continue;
+        }
+
+        // sum forces and stiffness
+        double m = particle->m_mass;
+        cVector3d force = particle->getExternalForce();
+        if (particle->m_useGravity)
+        {
+            force.add(m * particle->m_gravity);
+        }
+        double k = 0.0;
+        for (int a=m_adjacencyStart[i]; a<m_adjacencyStart[i+1]; a++)
+        {
+            int s = m_adjacency[a] >> 1;
+            double sign = (m_adjacency[a] & 1) ? -1.0 : 1.0;
+            force(0) += sign * m_springForceX[s];
+            force(1) += sign * m_springForceY[s];
+            force(2) += sign * m_springForceZ[s];
+            k += m_springK[s];
+        }
+
+        // initial guess, constant term and diagonal
+        const cVector3d& vel = particle->m_vel;
+        m_velX[i] = vel(0);
+        m_velY[i] = vel(1);
+        m_velZ[i] = vel(2);
+        m_rhsX[i] = m * vel(0) + h * force(0);
+        m_rhsY[i] = m * vel(1) + h * force(1);
+        m_rhsZ[i] = m * vel(2) + h * force(2);
+        m_diagonal[i] = m * (1.0 + h * particle->m_kDampingPos) + h * h * k;
+    }
+}
+
+
+//===========================================================================
+/*!
+    This method performs one Jacobi iteration of the implicit integration 
+    (see \ref prepareImplicit()) for a range of particles, writing next
+    velocities.
+
+    \param  a_first  Index of first particle.
+    \param  a_last   Index after last particle.
+*/
+//===========================================================================
+void cGELSolver::iterateImplicit(const int a_first, const int a_last)
+{
+    double h2 = m_timeInterval * m_timeInterval;
+
+    for (int i=a_first; i<a_last; i++)
+    {
+        if (m_fixed[i])
+        {
+            m_nextVelX[i] = 0.0;
+            m_nextVelY[i] = 0.0;
+            m_nextVelZ[i] = 0.0;
+            continue;
+        }
+
+        double bx = m_rhsX[i];
+        double by = m_rhsY[i];
+        double bz = m_rhsZ[i];
+        for (int a=m_adjacencyStart[i]; a<m_adjacencyStart[i+1]; a++)
+        {
+            int s = m_adjacency[a] >> 1;
+            int j = (m_adjacency[a] & 1) ? m_springNode0[s] : m_springNode1[s];
+            double k = h2 * m_springK[s];
+            bx += k * m_velX[j];
+            by += k * m_velY[j];
+            bz += k * m_velZ[j];
+        }
+
+        double scale = 1.0 / m_diagonal[i];
+        m_nextVelX[i] = scale * bx;
+        m_nextVelY[i] = scale * by;
+        m_nextVelZ[i] = scale * bz;
+    }
+}
+
+
+//===========================================================================
+/*!
+    This method integrates the positions of a range of particles from the
+    velocities computed by the implicit integrator, and writes them back.
+
+    \param  a_first  Index of first particle.
+    \param  a_last   Index after last particle.
+*/
+//===========================================================================
+void cGELSolver::scatterParticles(const int a_first, const int a_last)
+{
+    double h = m_timeInterval;
+
+    for (int i=a_first; i<a_last; i++)
+    {
+        cGELMassParticle* particle = m_particles[i];
+        if (m_fixed[i])
+        {
+            particle->m_nextPos = particle->m_pos;
+            continue;
+        }
+
+        cVector3d vel(m_velX[i], m_velY[i], m_velZ[i]);
+        if (h > 0.0)
+        {
+            particle->m_acc = (1.0 / h) * (vel - particle->m_vel);
+        }
+        particle->m_vel = vel;
+        particle->m_pos.set(m_posX[i] + h * vel(0),
+                            m_posY[i] + h * vel(1),
+                            m_posZ[i] + h * vel(2));
+        particle->m_nextPos = particle->m_pos;
+    }
+}
+
+
+//===========================================================================
+/*!
+    This method runs a job over indices 0 to \p a_size - 1. Large jobs are 
+    split in equal contiguous ranges, one per thread; the calling thread 
+    runs the first range and waits for the workers to complete theirs.
+
+    \param  a_size  Number of indices.
+    \param  a_job   Job, called with a range of indices (first, after last).
+*/
+//===========================================================================
+void cGELSolver::parallelFor(const int a_size, const function<void(int, int)>& a_job)
+{
+    if ((m_workers.empty()) || (a_size < C_GEL_PARALLEL_THRESHOLD))
+    {
+        a_job(0, a_size);
+        return;
+    }
+
+    // publish job and wake workers
+    {
+        lock_guard<mutex> lock(m_mutex);
+        m_job = a_job;
+        m_jobSize = a_size;
+        m_pending = (int)(m_workers.size());
+        m_generation++;
+    }
+    m_wake.notify_all();
+
+    // run own share, then wait for workers
+    runJob(0);
+    while (m_pending > 0)
+    {
+        this_thread::yield();
+    }
+}
+
+
+//===========================================================================
+/*!
+    This method runs the share of the current job of a thread.
+
+    \param  a_threadIndex  Index of thread (0 = calling thread).
+*/
+//===========================================================================
+void cGELSolver::runJob(const int a_threadIndex)
+{
+    int numThreads = (int)(m_workers.size()) + 1;
+    int size = (m_jobSize + numThreads - 1) / numThreads;
+    int first = a_threadIndex * size;
+    int last = cMin(m_jobSize, first + size);
+    if (first < last)
+    {
+        m_job(first, last);
+    }
+}
+
+
+//===========================================================================
+/*!
+    This method implements the main loop of worker threads, which wait for
+    jobs published by \ref parallelFor().
+
+    \param  a_threadIndex  Index of thread.
+*/
+//===========================================================================
+void cGELSolver::workerLoop(const int a_threadIndex)
+{
+    unsigned int generation = 0;
+    while (true)
+    {
+        {
+            unique_lock<mutex> lock(m_mutex);
+            m_wake.wait(lock, [&]() { return (m_quit || (m_generation != generation)); });
+            if (m_quit) { return; }
+            generation = m_generation;
+        }
+        runJob(a_threadIndex);
+        m_pending--;
+    }
+}
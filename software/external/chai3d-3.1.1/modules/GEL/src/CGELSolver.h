@@ -0,0 +1,292 @@
+//===========================================================================
+/*
+    Software License Agreement (BSD License)
+    Copyright (c) 2003-2016, CHAI3D.
+    (www.chai3d.org)
+
+    All rights reserved.
+
+    Redistribution and use in source and binary forms, with or without
+    modification, are permitted provided that the following conditions
+    are met:
+
+    * Redistributions of source code must retain the above copyright
+    notice, this list of conditions and the following disclaimer.
+
+    * Redistributions in binary form must reproduce the above
+    copyright notice, this list of conditions and the following
+    disclaimer in the documentation and/or other materials provided
+    with the distribution.
+
+    * Neither the name of CHAI3D nor the names of its contributors may
+    be used to endorse or promote products derived from this software
+    without specific prior written permission.
+
+    THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS
+    "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT
+    LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS
+    FOR A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE
+    COPYRIGHT OWNER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT,
+    INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING,
+    BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES;
+    LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER
+    CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT
+    LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN
+    ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE
+    POSSIBILITY OF SUCH DAMAGE. 
+
+    \author    <http://www.chai3d.org>
+    \version   3.1.1 $Rev: 1869 $
+*/
+//===========================================================================
+
+//---------------------------------------------------------------------------
+#ifndef CGELSolverH
+#define CGELSolverH
+//---------------------------------------------------------------------------
+#include "chai3d.h"
+#include "CGELMesh.h"
+//---------------------------------------------------------------------------
+#include <atomic>
+#include <condition_variable>
+#include <functional>
+#include <list>
+#include <mutex>
+#include <thread>
+#include <vector>
+//---------------------------------------------------------------------------
+
+//===========================================================================
+/*!
+    \file       CGELSolver.h
+
+    \brief
+    Implementation of a packed, parallel solver for mass particle models.
+*/
+//===========================================================================
+
+//---------------------------------------------------------------------------
+//! Integration methods of the GEL solver.
+typedef enum
+{
+    C_GEL_EXPLICIT_EULER,
+    C_GEL_IMPLICIT_EULER
+} cGELIntegrator;
+
+//! Minimum number of particles or springs for a solver phase to be split across threads.
+const int C_GEL_PARALLEL_THRESHOLD = 2048;
+
+//! Number of Jacobi iterations performed per step by the implicit integrator.
+const int C_GEL_IMPLICIT_ITERATIONS = 8;
+//---------------------------------------------------------------------------
+
+//===========================================================================
+/*!
+    \class      cGELSolver
+    \ingroup    GEL
+
+    \brief
+    This class implements a packed, parallel solver for mass particle models.
+
+    \details
+    cGELSolver integrates the mass particle models (particles and linear 
+    springs) of all deformable objects of a world in one pass. Particle 
+    positions and spring data are packed in structure-of-arrays buffers, 
+    so that spring forces are computed by loops over contiguous arrays 
+    which the compiler can vectorize.\n\n
+
+    Each step runs in phases (particles, springs, particles) which are split
+    across a pool of worker threads. Spring forces are written per spring, 
+    then summed per particle through an adjacency list, so that no two 
+    threads ever write to the same particle.\n\n
+
+    Two integrators are available. \ref C_GEL_EXPLICIT_EULER reproduces the
+    semi-implicit Euler scheme of \ref cGELMassParticle. 
+    \ref C_GEL_IMPLICIT_EULER linearizes spring forces (with an isotropic
+    stiffness per spring) and solves the backward Euler step by Jacobi 
+    iterations; it remains stable at much larger time steps or stiffnesses,
+    at the cost of some additional damping.\n\n
+
+    Particles remain the public interface of the model: properties (mass,
+    damping, gravity, fixed state), positions, velocities and external 
+    forces are read from them at every step, and positions and velocities
+    are written back. Springs are read when the solver is built; call 
+    \ref build() again after changing their stiffness or rest length.
+*/
+//===========================================================================
+class cGELSolver
+{
+    //-----------------------------------------------------------------------
+    // CONSTRUCTOR & DESTRUCTOR:
+    //-----------------------------------------------------------------------
+
+public:
+
+    //! Constructor of cGELSolver.
+    cGELSolver(const int a_numThreads = 0);
+
+    //! Destructor of cGELSolver.
+    ~cGELSolver();
+
+
+    //-----------------------------------------------------------------------
+    // PUBLIC METHODS:
+    //-----------------------------------------------------------------------
+
+public:
+
+    //! This method packs the mass particle models of a list of deformable objects.
+    void build(std::list<cGELMesh*>& a_meshes);
+
+    //! This method returns __true__ if the solver matches the mass particle models of a list of deformable objects.
+    bool isValid(std::list<cGELMesh*>& a_meshes) const;
+
+    //! This method integrates all mass particle models over a time interval.
+    void step(const double a_timeInterval);
+
+    //! This method sets the integration method.
+    void setIntegrator(const cGELIntegrator a_integrator) { m_integrator = a_integrator; }
+
+    //! This method returns the integration method.
+    cGELIntegrator getIntegrator() const { return (m_integrator); }
+
+    //! This method returns the number of particles handled by the solver.
+    int getNumParticles() const { return ((int)(m_particles.size())); }
+
+    //! This method returns the number of springs handled by the solver.
+    int getNumSprings() const { return ((int)(m_springNode0.size())); }
+
+    //! This method returns the number of threads used by the solver.
+    int getNumThreads() const { return ((int)(m_workers.size()) + 1); }
+
+
+    //-----------------------------------------------------------------------
+    // PROTECTED METHODS:
+    //-----------------------------------------------------------------------
+
+protected:
+
+    //! This method reads the positions of a range of particles.
+    void gatherParticles(const int a_first, const int a_last);
+
+    //! This method computes the forces of a range of springs.
+    void computeSpringForces(const int a_first, const int a_last);
+
+    //! This method sums the forces applied to a range of particles, integrates them explicitly and updates them.
+    void integrateExplicit(const int a_first, const int a_last);
+
+    //! This method sums the forces applied to a range of particles and prepares the implicit integration.
+    void prepareImplicit(const int a_first, const int a_last);
+
+    //! This method performs one Jacobi iteration of the implicit integration for a range of particles.
+    void iterateImplicit(const int a_first, const int a_last);
+
+    //! This method integrates the positions of a range of particles implicitly and updates them.
+    void scatterParticles(const int a_first, const int a_last);
+
+    //! This method runs a job over a range of indices, split across all threads if large enough.
+    void parallelFor(const int a_size, const std::function<void(int, int)>& a_job);
+
+    //! This method runs the share of the current job of a thread.
+    void runJob(const int a_threadIndex);
+
+    //! This method implements the main loop of worker threads.
+    void workerLoop(const int a_threadIndex);
+
+
+    //-----------------------------------------------------------------------
+    // PROTECTED MEMBERS - PARTICLES:
+    //-----------------------------------------------------------------------
+
+protected:
+
+    //! Integration method.
+    cGELIntegrator m_integrator;
+
+    //! Time interval of current step.
+    double m_timeInterval;
+
+    //! Particles, in packed order.
+    std::vector<cGELMassParticle*> m_particles;
+
+    //! Position of particles at the start of current step.
+    std::vector<double> m_posX, m_posY, m_posZ;
+
+    //! Velocity of particles (implicit integration).
+    std::vector<double> m_velX, m_velY, m_velZ;
+
+    //! Next velocity of particles (implicit integration).
+    std::vector<double> m_nextVelX, m_nextVelY, m_nextVelZ;
+
+    //! Constant term of implicit system.
+    std::vector<double> m_rhsX, m_rhsY, m_rhsZ;
+
+    //! Diagonal of implicit system matrix.
+    std::vector<double> m_diagonal;
+
+    //! Fixed state of particles (implicit integration).
+    std::vector<char> m_fixed;
+
+    //! Index of first entry in \ref m_adjacency for each particle (plus one final entry).
+    std::vector<int> m_adjacencyStart;
+
+    //! Springs attached to each particle, encoded as (2 x spring index + end of spring).
+    std::vector<int> m_adjacency;
+
+
+    //-----------------------------------------------------------------------
+    // PROTECTED MEMBERS - SPRINGS:
+    //-----------------------------------------------------------------------
+
+protected:
+
+    //! Index of first and second particle of springs.
+    std::vector<int> m_springNode0, m_springNode1;
+
+    //! Stiffness of springs.
+    std::vector<double> m_springK;
+
+    //! Rest length of springs.
+    std::vector<double> m_springLength0;
+
+    //! Force applied by springs onto their first particle (opposite onto second).
+    std::vector<double> m_springForceX, m_springForceY, m_springForceZ;
+
+    //! Number of meshes, vertices and springs packed (used to detect changes).
+    int m_numMeshes, m_numVertices, m_numSpringsPacked;
+
+
+    //-----------------------------------------------------------------------
+    // PROTECTED MEMBERS - THREADS:
+    //-----------------------------------------------------------------------
+
+protected:
+
+    //! Worker threads (the calling thread also takes part in every job).
+    std::vector<std::thread> m_workers;
+
+    //! Mutex protecting job generation.
+    std::mutex m_mutex;
+
+    //! Condition used to wake workers for a new job.
+    std::condition_variable m_wake;
+
+    //! Current job.
+    std::function<void(int, int)> m_job;
+
+    //! Size of current job.
+    int m_jobSize;
+
+    //! Generation number of current job.
+    unsigned int m_generation;
+
+    //! Number of workers which have not completed the current job.
+    std::atomic<int> m_pending;
+
+    //! If __true__, then workers exit.
+    bool m_quit;
+};
+
+//---------------------------------------------------------------------------
+#endif
+//---------------------------------------------------------------------------
@@ -89,6 +89,9 @@ cGELWorld::cGELWorld()
     // reset simulation time.
     m_simulationTime = 0.0;
 
+    // mass particle models are integrated by each object by default
+    m_solver = NULL;
+
     // create a collision detector for world
     m_collisionDetector = new cGELWorldCollision(this);
 }
@@ -101,6 +104,7 @@ cGELWorld::cGELWorld()
 //===========================================================================
 cGELWorld::~cGELWorld()
 {
+    setUseSolver(false);
     m_gelMeshes.clear();
 }
 
@@ -154,6 +158,16 @@ void cGELWorld::updateDynamics(double a_timeInterval)
 {
     list<cGELMesh*>::iterator i;
 
+    // integrate mass particle models with solver, repacking them if they changed
+    if (m_solver != NULL)
+    {
+        if (!m_solver->isValid(m_gelMeshes))
+        {
+            m_solver->build(m_gelMeshes);
+        }
+        m_solver->step(a_timeInterval);
+    }
+
     // clear all internal forces of each model
     for(i = m_gelMeshes.begin(); i != m_gelMeshes.end(); ++i)
     {
@@ -187,15 +201,60 @@ void cGELWorld::updateDynamics(double a_timeInterval)
 }
 
 
+//===========================================================================
+/*!
+    This method enables or disables the packed, parallel solver (see 
+    \ref cGELSolver) for the mass particle models of all deformable objects
+    of this world. Skeleton models are not affected. \n\n
+
+    When enabled, particles and springs are packed when 
+    \ref updateDynamics() is first called, and repacked whenever objects,
+    vertices or springs are added or removed. The integration method can be
+    selected with \ref getSolver()->setIntegrator().
+
+    \param  a_useSolver   If __true__ then the solver is enabled.
+    \param  a_numThreads  Number of threads used by the solver. If zero,
+                          one thread per core is used.
+*/
+//===========================================================================
+void cGELWorld::setUseSolver(const bool a_useSolver, const int a_numThreads)
+{
+    // delete previous solver; objects integrate their models again
+    if (m_solver != NULL)
+    {
+        delete m_solver;
+        m_solver = NULL;
+
+        list<cGELMesh*>::iterator i;
+        for(i = m_gelMeshes.begin(); i != m_gelMeshes.end(); ++i)
+        {
+            (*i)->m_useSolver = false;
+        }
+    }
+
+    // create new solver
+    if (a_useSolver)
+    {
+        m_solver = new cGELSolver(a_numThreads);
+    }
+}
+
+
 //===========================================================================
 /*!
     This method update the mesh of every deformable object contained
     in the virtual world.
 
-    \param  a_updateNormals  If __true__ then surface normals are recomputed.
+    \param  a_updateNormals             If __true__ then surface normals are recomputed.
+    \param  a_updateCollisionDetectors  If __true__ then collision trees are refit to 
+                                        the new vertex positions.
+
+    Refitting modifies the collision trees in place. It should therefore only
+    be requested from the thread that performs collision queries (typically 
+    the haptics thread), and not from the graphics thread.
 */
 //===========================================================================
-void cGELWorld::updateSkins(bool a_updateNormals)
+void cGELWorld::updateSkins(bool a_updateNormals, bool a_updateCollisionDetectors)
 {
     // update surface mesh to latest skeleton configuration
     list<cGELMesh*>::iterator i;
@@ -208,5 +267,10 @@ void cGELWorld::updateSkins(bool a_updateNormals)
         {
             nextItem->computeAllNormals();
         }
+
+        if (a_updateCollisionDetectors)
+        {
+            nextItem->updateCollisionDetector();
+        }
     }
-}
\ No newline at end of file
+}
\ No newline at end of file
@@ -47,6 +47,7 @@
 //---------------------------------------------------------------------------
 #include "chai3d.h"
 #include "CGELMesh.h"
+#include "CGELSolver.h"
 //---------------------------------------------------------------------------
 
 //===========================================================================
@@ -97,8 +98,14 @@ public:
     //! This method clears all external forces applied on all deformable objects.
     void clearExternalForces();
 
-    //! This method updates the mesh of all deformable objects.
-    void updateSkins(bool a_updateNormals = true);
+    //! This method updates the mesh (and collision detectors) of all deformable objects.
+    void updateSkins(bool a_updateNormals = true, bool a_updateCollisionDetectors = false);
+
+    //! This method enables or disables the packed, parallel solver for mass particle models.
+    void setUseSolver(const bool a_useSolver, const int a_numThreads = 0);
+
+    //! This method returns a pointer to the solver for mass particle models, or __NULL__ if disabled.
+    cGELSolver* getSolver() { return (m_solver); }
 
 
     //-----------------------------------------------------------------------
@@ -117,6 +124,16 @@ public:
     chai3d::cVector3d m_gravity;
 
 
+    //-----------------------------------------------------------------------
+    // PROTECTED MEMBERS:
+    //-----------------------------------------------------------------------
+
+protected:
+
+    //! Solver for mass particle models (__NULL__ if disabled).
+    cGELSolver* m_solver;
+
+
     //-----------------------------------------------------------------------
     // PRIVATE METHODS:
     //-----------------------------------------------------------------------
@@ -66,6 +66,7 @@
 #include "CGELSkeletonLink.h"
 #include "CGELVertex.h"
 #include "CGELMesh.h"
+#include "CGELSolver.h"
 #include "CGELWorld.h"
 
 //---------------------------------------------------------------------------
@@ -146,6 +146,7 @@ void cODEGenericBody::setLocalPos(const chai3d::cVector3d &a_position)
     {
         // store value
         m_localPos = a_position;
+        invalidateGlobalPositions();
 
         // adjust position
         dBodySetPosition(m_ode_body, a_position.x(), a_position.y(), a_position.z());
@@ -154,6 +155,7 @@ void cODEGenericBody::setLocalPos(const chai3d::cVector3d &a_position)
     {
         // store value
         m_localPos = a_position;
+        invalidateGlobalPositions();
 
         // adjust position
         dGeomSetPosition(m_ode_geom, a_position.x(), a_position.y(), a_position.z());
@@ -188,12 +190,14 @@ void cODEGenericBody::setLocalRot(const cMatrix3d &a_rotation)
     {
         // store new rotation matrix
         m_localRot = a_rotation;
+        invalidateGlobalPositions();
         dBodySetRotation(m_ode_body, R);
     }
     else if (m_ode_geom != NULL)
     {
         // store new rotation matrix
         m_localRot = a_rotation;
+        invalidateGlobalPositions();
         dGeomSetRotation(m_ode_geom, R);
     }
 }
@@ -246,6 +250,24 @@ void cODEGenericBody::addExternalTorque(const cVector3d& a_torque)
 }
 
 
+//===========================================================================
+/*!
+    This method marks the global position of this object as out of date. 
+    Bodies are updated through the list of bodies of their ODE world rather
+    than as children of the world, so the world is marked too.
+*/
+//===========================================================================
+void cODEGenericBody::invalidateGlobalPositions()
+{
+    cGenericObject::invalidateGlobalPositions();
+
+    if (m_ODEWorld != NULL)
+    {
+        m_ODEWorld->invalidateGlobalPositions();
+    }
+}
+
+
 //===========================================================================
 /*!
     This method updates the position and orientation data from the ODE 
@@ -276,6 +298,9 @@ void cODEGenericBody::updateBodyPosition(void)
                    odeRotation[4],odeRotation[5],odeRotation[6],
                    odeRotation[8],odeRotation[9],odeRotation[10]);
 
+    // global position needs to be updated
+    invalidateGlobalPositions();
+
     // store previous position if object is a mesh
     if (m_ode_triMeshDataID != NULL)
     {
@@ -388,6 +413,110 @@ bool cODEGenericBody::computeCollisionDetection(const chai3d::cVector3d& a_segme
 }
 
 
+//===========================================================================
+/*!
+    This method checks if each line segment of a batch intersects this 
+    object. Collisions of segment \p i are reported in recorder 
+    \p a_recorders[i].
+
+    \param  a_numSegments     Number of segments.
+    \param  a_segmentPointsA  Initial points of segments.
+    \param  a_segmentPointsB  End points of segments.
+    \param  a_recorders       Recorders which store the collision events of each segment.
+    \param  a_settings        Structure which contains some rules about how the
+                              collision detection should be performed.
+
+    \return __true__ if collision occurred, __false__ otherwise.
+*/
+//===========================================================================
+bool cODEGenericBody::computeCollisionDetectionBatch(const int a_numSegments,
+                                                     const chai3d::cVector3d* a_segmentPointsA,
+                                                     const chai3d::cVector3d* a_segmentPointsB,
+                                                     chai3d::cCollisionRecorder** a_recorders,
+                                                     chai3d::cCollisionSettings& a_settings)
+{
+    ///////////////////////////////////////////////////////////////////////////
+    // INITIALIZATION
+    ///////////////////////////////////////////////////////////////////////////
+
+    // check if node is a ghost. If yes, then ignore call
+    if (m_ghostEnabled) { return (false); }
+
+    // process large batches in chunks
+    if (a_numSegments > C_COLLISION_MAX_SEGMENTS)
+    {
+        bool hit = false;
+        for (int first=0; first<a_numSegments; first+=C_COLLISION_MAX_SEGMENTS)
+        {
+            hit = hit | computeCollisionDetectionBatch(cMin(a_numSegments - first, C_COLLISION_MAX_SEGMENTS),
+                                                       &a_segmentPointsA[first],
+                                                       &a_segmentPointsB[first],
+                                                       &a_recorders[first],
+                                                       a_settings);
+        }
+        return (hit);
+    }
+
+    // temp variable
+    bool hit = false;
+
+    // get the transpose of the local rotation matrix
+    cMatrix3d transLocalRot;
+    m_localRot.transr(transLocalRot);
+
+    // convert endpoints of the segments into local coordinate frame
+    cVector3d localSegmentPointsA[C_COLLISION_MAX_SEGMENTS];
+    cVector3d localSegmentPointsB[C_COLLISION_MAX_SEGMENTS];
+    for (int i=0; i<a_numSegments; i++)
+    {
+        localSegmentPointsA[i] = a_segmentPointsA[i];
+        localSegmentPointsA[i].sub(m_localPos);
+        transLocalRot.mul(localSegmentPointsA[i]);
+
+        localSegmentPointsB[i] = a_segmentPointsB[i];
+        localSegmentPointsB[i].sub(m_localPos);
+        transLocalRot.mul(localSegmentPointsB[i]);
+    }
+
+
+    ///////////////////////////////////////////////////////////////////////////
+    // CHECK BODY IMAGE
+    ///////////////////////////////////////////////////////////////////////////
+
+    if (m_imageModel!=NULL)
+    {
+        hit = m_imageModel->computeCollisionDetectionBatch(a_numSegments,
+                                                           localSegmentPointsA,
+                                                           localSegmentPointsB,
+                                                           a_recorders,
+                                                           a_settings);
+    }
+
+
+    ///////////////////////////////////////////////////////////////////////////
+    // CHECK CHILDREN
+    ///////////////////////////////////////////////////////////////////////////
+
+    // check for collisions with all children of this object
+    for (unsigned int i=0; i<m_children.size(); i++)
+    {
+        hit = hit | m_children[i]->computeCollisionDetectionBatch(a_numSegments,
+                                                                  localSegmentPointsA,
+                                                                  localSegmentPointsB,
+                                                                  a_recorders,
+                                                                  a_settings);
+    }
+
+
+    ///////////////////////////////////////////////////////////////////////////
+    // FINALIZE
+    ///////////////////////////////////////////////////////////////////////////
+
+    // return result
+    return (hit);
+}
+
+
 //===========================================================================
 /*!
     This method assigns a generic object such as a mesh or a shape that is 
@@ -1184,4 +1313,4 @@ void cODEGenericBody::updateGlobalPositions(const bool a_frameOnly)
                                             m_globalPos,
                                             m_globalRot);
     }
-};
\ No newline at end of file
+};
\ No newline at end of file
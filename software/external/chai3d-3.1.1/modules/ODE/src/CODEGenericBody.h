@@ -144,6 +144,9 @@ public:
     //! This method updates the position and orientation from the ODE model to CHAI3D model.
     void updateBodyPosition(void);
 
+    //! This method marks the global position of this object and of its ODE world as out of date.
+    virtual void invalidateGlobalPositions();
+
 
     //-----------------------------------------------------------------------
     // PUBLIC METHODS - EXTERNAL FORCES:
@@ -238,6 +241,13 @@ public:
                                            chai3d::cCollisionRecorder& a_recorder,
                                            chai3d::cCollisionSettings& a_settings);
 
+    //! This method computes all collisions between a batch of segments and the body image of this object.
+    virtual bool computeCollisionDetectionBatch(const int a_numSegments,
+                                                const chai3d::cVector3d* a_segmentPointsA,
+                                                const chai3d::cVector3d* a_segmentPointsB,
+                                                chai3d::cCollisionRecorder** a_recorders,
+                                                chai3d::cCollisionSettings& a_settings);
+
 
     //-----------------------------------------------------------------------
     // PUBLIC METHODS - BODY IMAGE AND DISPLAY PROPERTIES:
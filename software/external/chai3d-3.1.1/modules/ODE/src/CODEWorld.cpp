@@ -383,3 +383,110 @@ bool cODEWorld::computeCollisionDetection(const cVector3d& a_segmentPointA,
     // return whether there was a collision between the segment and this world
     return (hit);
 }
+
+
+//==============================================================================
+/*!
+    This method checks if each line segment of a batch intersects any object
+    located inside the virtual world. Collisions of segment \p i are reported
+    in recorder \p a_recorders[i].
+
+    \param  a_numSegments     Number of segments.
+    \param  a_segmentPointsA  Initial points of segments.
+    \param  a_segmentPointsB  End points of segments.
+    \param  a_recorders       Recorders which store the collision events of each segment.
+    \param  a_settings        Structure which contains some rules about how the
+    collision detection should be performed.
+
+    \return __true__ if a collision occurred, __false__ otherwise.
+*/
+//==============================================================================
+bool cODEWorld::computeCollisionDetectionBatch(const int a_numSegments,
+                                               const cVector3d* a_segmentPointsA,
+                                               const cVector3d* a_segmentPointsB,
+                                               cCollisionRecorder** a_recorders,
+                                               cCollisionSettings& a_settings)
+{
+    ///////////////////////////////////////////////////////////////////////////
+    // INITIALIZATION
+    ///////////////////////////////////////////////////////////////////////////
+
+    // check if node is a ghost. If yes, then ignore call
+    if (m_ghostEnabled) { return (false); }
+
+    // process large batches in chunks
+    if (a_numSegments > C_COLLISION_MAX_SEGMENTS)
+    {
+        bool hit = false;
+        for (int first=0; first<a_numSegments; first+=C_COLLISION_MAX_SEGMENTS)
+        {
+            hit = hit | computeCollisionDetectionBatch(cMin(a_numSegments - first, C_COLLISION_MAX_SEGMENTS),
+                                                       &a_segmentPointsA[first],
+                                                       &a_segmentPointsB[first],
+                                                       &a_recorders[first],
+                                                       a_settings);
+        }
+        return (hit);
+    }
+
+    // temp variable
+    bool hit = false;
+
+    // get the transpose of the local rotation matrix
+    cMatrix3d transLocalRot;
+    m_localRot.transr(transLocalRot);
+
+    // convert endpoints of the segments into local coordinate frame
+    cVector3d localSegmentPointsA[C_COLLISION_MAX_SEGMENTS];
+    cVector3d localSegmentPointsB[C_COLLISION_MAX_SEGMENTS];
+    for (int i=0; i<a_numSegments; i++)
+    {
+        localSegmentPointsA[i] = a_segmentPointsA[i];
+        localSegmentPointsA[i].sub(m_localPos);
+        transLocalRot.mul(localSegmentPointsA[i]);
+
+        localSegmentPointsB[i] = a_segmentPointsB[i];
+        localSegmentPointsB[i].sub(m_localPos);
+        transLocalRot.mul(localSegmentPointsB[i]);
+    }
+
+
+    ///////////////////////////////////////////////////////////////////////////
+    // CHECK COLLISIONS
+    ///////////////////////////////////////////////////////////////////////////
+
+    // check each ODE body
+    list<cODEGenericBody*>::iterator i;
+    for(i = m_bodies.begin(); i != m_bodies.end(); ++i)
+    {
+        cODEGenericBody *nextItem = *i;
+        hit = hit | nextItem->computeCollisionDetectionBatch(a_numSegments,
+                                                             localSegmentPointsA,
+                                                             localSegmentPointsB,
+                                                             a_recorders,
+                                                             a_settings);
+    }
+
+
+    ///////////////////////////////////////////////////////////////////////////
+    // CHECK CHILDREN
+    ///////////////////////////////////////////////////////////////////////////
+
+    // check for collisions with all children of this object
+    for (unsigned int i=0; i<m_children.size(); i++)
+    {
+        hit = hit | m_children[i]->computeCollisionDetectionBatch(a_numSegments,
+                                                                  localSegmentPointsA,
+                                                                  localSegmentPointsB,
+                                                                  a_recorders,
+                                                                  a_settings);
+    }
+
+
+    ///////////////////////////////////////////////////////////////////////////
+    // FINALIZE
+    ///////////////////////////////////////////////////////////////////////////
+
+    // return whether there was a collision between the segments and this world
+    return (hit);
+}
@@ -133,6 +133,13 @@ public:
                                            chai3d::cCollisionRecorder& a_recorder,
                                            chai3d::cCollisionSettings& a_settings);
 
+    //! This method computes any collision between a batch of segments and all objects in this world.
+    virtual bool computeCollisionDetectionBatch(const int a_numSegments,
+                                                const chai3d::cVector3d* a_segmentPointsA,
+                                                const chai3d::cVector3d* a_segmentPointsB,
+                                                chai3d::cCollisionRecorder** a_recorders,
+                                                chai3d::cCollisionSettings& a_settings);
+
 
     //-----------------------------------------------------------------------
     // PUBLIC MEMBERS:
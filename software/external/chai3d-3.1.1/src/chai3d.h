@@ -90,9 +90,11 @@
 #include "graphics/CFont.h"
 #include "graphics/CImage.h"
 #include "graphics/CMultiImage.h"
+#include "graphics/CSparseVolume.h"
 #include "graphics/CVideo.h"
 #include "graphics/CPrimitives.h"
 #include "graphics/CRenderOptions.h"
+#include "graphics/CTextBatch.h"
 #include "graphics/CGenericArray.h"
 #include "graphics/CPointArray.h"
 #include "graphics/CSegmentArray.h"
@@ -147,6 +149,7 @@
 #include "widgets/CLevel.h"
 #include "widgets/CPanel.h"
 #include "widgets/CScope.h"
+#include "widgets/CSignalScope.h"
 #include "widgets/CViewPanel.h"
 
 
@@ -159,6 +162,8 @@
 #include "world/CMultiMesh.h"
 #include "world/CMultiPoint.h"
 #include "world/CMultiSegment.h"
+#include "world/CPrimitiveBatch.h"
+#include "world/CRenderQueue.h"
 #include "world/CShapeBox.h"
 #include "world/CShapeCylinder.h"
 #include "world/CShapeLine.h"
@@ -227,13 +232,15 @@
 #include "collisions/CCollisionBasics.h"
 #include "collisions/CCollisionBrute.h"
 #include "collisions/CCollisionAABB.h"
+#include "collisions/CCollisionBVH.h"
 
 
 //---------------------------------------------------------------------------
 //! \defgroup   timers  Timers
-//! \brief      Implements a frequency counter and high precision clock.
+//! \brief      Implements a frequency counter, latency histogram and high precision clock.
 //---------------------------------------------------------------------------
 #include "timers/CFrequencyCounter.h"
+#include "timers/CLatencyHistogram.h"
 #include "timers/CPrecisionClock.h"
 
 
@@ -249,6 +256,7 @@
 #include "files/CFileImagePPM.h"
 #include "files/CFileImageRAW.h"
 #include "files/CFileModel3DS.h"
+#include "files/CFileModelCMESH.h"
 #include "files/CFileModelOBJ.h"
 #include "files/CFileModelSTL.h"
 
@@ -259,7 +267,9 @@
 //---------------------------------------------------------------------------
 #include "system/CGenericType.h"
 #include "system/CGlobals.h"
+#include "system/CMappedFile.h"
 #include "system/CMutex.h"
+#include "system/CPeriodicTask.h"
 #include "system/CString.h"
 #include "system/CThread.h"
 
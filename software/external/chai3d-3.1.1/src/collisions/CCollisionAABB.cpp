@@ -78,6 +78,11 @@ cCollisionAABB::cCollisionAABB()
     m_rootIndex = -1;
     m_maxDepth = 0;
     m_radius = 0.0;
+    m_nextNode = 0;
+    m_rebuildThreshold = 1.5;
+    m_generation = 0;
+    m_pending = 0;
+    m_quit = false;
 }
 
 
@@ -88,6 +93,16 @@ cCollisionAABB::cCollisionAABB()
 //==============================================================================
 cCollisionAABB::~cCollisionAABB()
 {
+    // stop worker threads
+    {
+        lock_guard<mutex> lock(m_mutex);
+        m_quit = true;
+    }
+    m_wake.notify_all();
+    for (unsigned int i=0; i<m_workers.size(); i++)
+    {
+        m_workers[i].join();
+    }
 }
 
 
@@ -224,6 +239,7 @@ void cCollisionAABB::initialize(const cGenericArrayPtr a_elements, const double
     int indexLast = m_numElements - 1;
     int depth = 0;
 
+    m_nextNode = m_numElements;
     if (m_numElements > 1)
     {
         m_rootIndex = buildTree(indexFirst, indexLast, depth);
@@ -232,6 +248,92 @@ void cCollisionAABB::initialize(const cGenericArrayPtr a_elements, const double
     {
         m_rootIndex = 0;
     }
+
+    // store quality of tree, used by update() to detect degraded subtrees
+    m_cost.resize(m_nodes.size());
+    m_quality.resize(m_nodes.size());
+    computeCost(0, (int)(m_nodes.size()) - 1, true);
+}
+
+
+//==============================================================================
+/*!
+    This method initializes the collision tree from a list of nodes previously
+    returned by \ref getNodes(), for instance after reading them from a file.
+    This avoids building the tree again when the elements have not changed.\n\n
+
+    The nodes are checked to form a valid tree over the elements. If they
+    do, they are swapped into the tree, and __a_nodes__ is left empty.
+    Otherwise, the tree is built from the elements instead.
+
+    \param  a_elements   Pointer to element array.
+    \param  a_radius     Bounding radius around each element used to build the nodes.
+    \param  a_nodes      List of nodes.
+    \param  a_rootIndex  Index number of root node.
+
+    \return __true__ if the nodes were used, __false__ if the tree was built instead.
+*/
+//==============================================================================
+bool cCollisionAABB::initialize(const cGenericArrayPtr a_elements, 
+                                const double a_radius,
+                                std::vector<cCollisionAABBNode>& a_nodes,
+                                const int a_rootIndex)
+{
+    // sanity check
+    if (a_elements == nullptr)
+    {
+        m_rootIndex = -1;
+        return (false);
+    }
+
+    // a tree over n elements has n leaves followed by n-1 internal nodes
+    int numElements = a_elements->getNumElements();
+    int numNodes = (int)(a_nodes.size());
+    bool valid = (numElements == 0) ? ((numNodes == 0) && (a_rootIndex == -1)) :
+                                      ((numNodes == 2 * numElements - 1) && (a_rootIndex == numNodes - 1));
+
+    // leaves must point to elements, internal nodes to nodes stored before them
+    int maxDepth = 0;
+    for (int i=0; (i<numNodes) && valid; i++)
+    {
+        const cCollisionAABBNode& node = a_nodes[i];
+        if (i < numElements)
+        {
+            valid = (node.m_nodeType == C_AABB_NODE_LEAF) &&
+                    (node.m_leftSubTree >= 0) && (node.m_leftSubTree < numElements);
+        }
+        else
+        {
+            valid = (node.m_nodeType == C_AABB_NODE_INTERNAL) &&
+                    (node.m_leftSubTree >= 0) && (node.m_leftSubTree < i) &&
+                    (node.m_rightSubTree >= 0) && (node.m_rightSubTree < i);
+        }
+        maxDepth = cMax(maxDepth, node.m_depth);
+    }
+
+    // build tree from elements
+    if (!valid)
+    {
+        initialize(a_elements, a_radius);
+        return (false);
+    }
+
+    // use nodes
+    m_elements = a_elements;
+    m_radius = a_radius;
+    m_numElements = numElements;
+    m_nodes.clear();
+    m_nodes.swap(a_nodes);
+    m_rootIndex = a_rootIndex;
+    m_maxDepth = maxDepth;
+    m_nextNode = numNodes;
+
+    // store quality of tree, used by update() to detect degraded subtrees
+    m_cost.resize(m_nodes.size());
+    m_quality.resize(m_nodes.size());
+    computeCost(0, numNodes - 1, true);
+
+    return (true);
 }
 
 
@@ -350,9 +452,316 @@ int cCollisionAABB::buildTree(const int a_indexFirstNode, const int a_indexLastN
         }
     }
 
-    // insert node
-    m_nodes.push_back(node);
-    return (m_nodes.size()-1);
+    // insert node (in place when rebuilding a subtree, see rebuildSubtree())
+    if (m_nextNode < (int)(m_nodes.size()))
+    {
+        m_nodes[m_nextNode] = node;
+    }
+    else
+    {
+        m_nodes.push_back(node);
+    }
+    return (m_nextNode++);
+}
+
+
+//==============================================================================
+/*!
+    This method refits the collision tree to the current positions of the
+    vertices, without changing its structure. It should be called whenever 
+    vertices have moved (e.g. after updating a deformable or animated mesh), 
+    but elements have neither been added nor removed.\n\n
+
+    Leaf nodes are refit to their elements, then internal nodes are refit 
+    to their children. Because children are always stored before their 
+    parent, a single pass over the node list is required. Leaves of large 
+    trees are refit on a pool of worker threads, which is started the first
+    time it is needed and kept for the lifetime of the tree.\n\n
+
+    Deformations can make a tree increasingly loose. The quality of each 
+    subtree (its surface area heuristic cost, normalized by the area of its
+    root) is therefore compared to the quality it had when built. Subtrees
+    which have degraded by more than the rebuild threshold are rebuilt in
+    place.
+*/
+//==============================================================================
+void cCollisionAABB::update()
+{
+    // sanity check
+    if (m_elements == nullptr) { return; }
+
+    // if elements were added or removed, the tree must be rebuilt
+    if ((int)(m_elements->getNumElements()) != m_numElements)
+    {
+        initialize(m_elements, m_radius);
+        return;
+    }
+
+    // if zero elements, then exit
+    if (m_rootIndex == -1) { return; }
+
+
+    ////////////////////////////////////////////////////////////////////////////
+    // REFIT LEAF NODES
+    ////////////////////////////////////////////////////////////////////////////
+
+    if (m_numElements >= C_AABB_PARALLEL_THRESHOLD)
+    {
+        startWorkers();
+    }
+
+    if ((m_workers.empty()) || (m_numElements < C_AABB_PARALLEL_THRESHOLD))
+    {
+        refitLeaves(0, m_numElements - 1);
+    }
+    else
+    {
+        // wake workers
+        {
+            lock_guard<mutex> lock(m_mutex);
+            m_pending = (int)(m_workers.size());
+            m_generation++;
+        }
+        m_wake.notify_all();
+
+        // refit own share, then wait for workers
+        runRefit(0);
+        while (m_pending > 0)
+        {
+            this_thread::yield();
+        }
+    }
+
+
+    ////////////////////////////////////////////////////////////////////////////
+    // REFIT INTERNAL NODES
+    ////////////////////////////////////////////////////////////////////////////
+
+    int numNodes = (int)(m_nodes.size());
+    for (int i=m_numElements; i<numNodes; i++)
+    {
+        cCollisionAABBNode& node = m_nodes[i];
+        node.m_bbox.setEmpty();
+        node.m_bbox.enclose(m_nodes[node.m_leftSubTree].m_bbox);
+        node.m_bbox.enclose(m_nodes[node.m_rightSubTree].m_bbox);
+    }
+    computeCost(0, numNodes - 1, false);
+
+
+    ////////////////////////////////////////////////////////////////////////////
+    // REBUILD DEGRADED SUBTREES
+    ////////////////////////////////////////////////////////////////////////////
+
+    if ((m_rebuildThreshold <= 0.0) || (numNodes < 2)) { return; }
+
+    // walk tree from root; a degraded subtree is rebuilt and not searched further
+    m_checkStack.clear();
+    m_checkStack.push_back(m_rootIndex);
+    while (!m_checkStack.empty())
+    {
+        int nodeIndex = m_checkStack.back();
+        m_checkStack.pop_back();
+
+        double area = getArea(m_nodes[nodeIndex].m_bbox);
+        if ((area > C_TINY) && (m_cost[nodeIndex] > m_rebuildThreshold * m_quality[nodeIndex] * area))
+        {
+            rebuildSubtree(nodeIndex);
+            continue;
+        }
+
+        int left = m_nodes[nodeIndex].m_leftSubTree;
+        int right = m_nodes[nodeIndex].m_rightSubTree;
+        if (m_nodes[left].m_nodeType == C_AABB_NODE_INTERNAL) { m_checkStack.push_back(left); }
+        if (m_nodes[right].m_nodeType == C_AABB_NODE_INTERNAL) { m_checkStack.push_back(right); }
+    }
+}
+
+
+//==============================================================================
+/*!
+    This method starts the worker threads used by \ref update() to refit
+    leaves, one per core (the calling thread being the first). Workers are
+    only started once, and are kept until the tree is deleted.
+*/
+//==============================================================================
+void cCollisionAABB::startWorkers()
+{
+    if ((!m_workers.empty()) || (m_quit)) { return; }
+
+    int numThreads = (int)(thread::hardware_concurrency());
+    for (int i=1; i<numThreads; i++)
+    {
+        m_workers.push_back(thread(&cCollisionAABB::workerLoop, this, i));
+    }
+}
+
+
+//==============================================================================
+/*!
+    This method refits the share of leaf nodes of a thread, the leaves being
+    split in equal contiguous ranges, one per thread.
+
+    \param  a_threadIndex  Index of thread (0 = calling thread).
+*/
+//==============================================================================
+void cCollisionAABB::runRefit(const int a_threadIndex)
+{
+    int numThreads = (int)(m_workers.size()) + 1;
+    int size = (m_numElements + numThreads - 1) / numThreads;
+    int first = a_threadIndex * size;
+    int last = cMin(m_numElements, first + size) - 1;
+    if (first <= last)
+    {
+        refitLeaves(first, last);
+    }
+}
+
+
+//==============================================================================
+/*!
+    This method implements the main loop of worker threads, which wait for
+    refits started by \ref update().
+
+    \param  a_threadIndex  Index of thread.
+*/
+//==============================================================================
+void cCollisionAABB::workerLoop(const int a_threadIndex)
+{
+    unsigned int generation = 0;
+    while (true)
+    {
+        {
+            unique_lock<mutex> lock(m_mutex);
+            m_wake.wait(lock, [&]() { return (m_quit || (m_generation != generation)); });
+            if (m_quit) { return; }
+            generation = m_generation;
+        }
+        runRefit(a_threadIndex);
+        m_pending--;
+    }
+}
+
+
+//==============================================================================
+/*!
+    This method fits the boundary boxes of a range of leaf nodes to the 
+    current positions of the vertices of their elements.
+
+    \param  a_indexFirstNode  Lower index value of leaf node.
+    \param  a_indexLastNode   Upper index value of leaf node.
+*/
+//==============================================================================
+void cCollisionAABB::refitLeaves(const int a_indexFirstNode, const int a_indexLastNode)
+{
+    // get number of vertices per element
+    int numVerticesPerElement = m_elements->getNumVerticesPerElement();
+
+    for (int i=a_indexFirstNode; i<=a_indexLastNode; i++)
+    {
+        cCollisionAABBNode& leaf = m_nodes[i];
+        int element = leaf.m_leftSubTree;
+
+        switch (numVerticesPerElement)
+        {
+        case 1:
+            {
+                cVector3d vertex0 = m_elements->m_vertices->getLocalPos(m_elements->getVertexIndex(element, 0));
+                leaf.fitBBox(m_radius, vertex0);
+                break;
+            }
+
+        case 2:
+            {
+                cVector3d vertex0 = m_elements->m_vertices->getLocalPos(m_elements->getVertexIndex(element, 0));
+                cVector3d vertex1 = m_elements->m_vertices->getLocalPos(m_elements->getVertexIndex(element, 1));
+                leaf.fitBBox(m_radius, vertex0, vertex1);
+                break;
+            }
+
+        case 3:
+            {
+                cVector3d vertex0 = m_elements->m_vertices->getLocalPos(m_elements->getVertexIndex(element, 0));
+                cVector3d vertex1 = m_elements->m_vertices->getLocalPos(m_elements->getVertexIndex(element, 1));
+                cVector3d vertex2 = m_elements->m_vertices->getLocalPos(m_elements->getVertexIndex(element, 2));
+                leaf.fitBBox(m_radius, vertex0, vertex1, vertex2);
+                break;
+            }
+        }
+    }
+}
+
+
+//==============================================================================
+/*!
+    This method computes the surface area heuristic cost of a range of nodes:
+    the sum of the areas of each node and all its descendants. The children 
+    of any internal node in the range must either be located before it in 
+    the range, or have an up to date cost.
+
+    \param  a_indexFirstNode  Lower index value of node.
+    \param  a_indexLastNode   Upper index value of node.
+    \param  a_storeQuality    If __true__, the quality of internal nodes is 
+                              stored as reference for update().
+*/
+//==============================================================================
+void cCollisionAABB::computeCost(const int a_indexFirstNode, const int a_indexLastNode, const bool a_storeQuality)
+{
+    for (int i=a_indexFirstNode; i<=a_indexLastNode; i++)
+    {
+        cCollisionAABBNode& node = m_nodes[i];
+        double area = getArea(node.m_bbox);
+
+        if (node.m_nodeType == C_AABB_NODE_LEAF)
+        {
+            m_cost[i] = area;
+        }
+        else
+        {
+            m_cost[i] = area + m_cost[node.m_leftSubTree] + m_cost[node.m_rightSubTree];
+            if (a_storeQuality)
+            {
+                m_quality[i] = (area > C_TINY) ? (m_cost[i] / area) : 1.0;
+            }
+        }
+    }
+}
+
+
+//==============================================================================
+/*!
+    This method rebuilds the subtree below an internal node. \n\n
+
+    The leaves of a subtree cover a contiguous range of the node list, and its
+    internal nodes (one fewer than its leaves) immediately precede the node 
+    itself. The subtree is therefore rebuilt within the same ranges, and the 
+    indices of all other nodes remain valid.
+
+    \param  a_nodeIndex  Index of root node of the subtree.
+*/
+//==============================================================================
+void cCollisionAABB::rebuildSubtree(const int a_nodeIndex)
+{
+    // find range of leaves covered by subtree
+    int first = a_nodeIndex;
+    while (m_nodes[first].m_nodeType == C_AABB_NODE_INTERNAL)
+    {
+        first = m_nodes[first].m_leftSubTree;
+    }
+    int last = a_nodeIndex;
+    while (m_nodes[last].m_nodeType == C_AABB_NODE_INTERNAL)
+    {
+        last = m_nodes[last].m_rightSubTree;
+    }
+
+    // rebuild internal nodes in place; the root of the subtree is written last
+    int firstInternal = a_nodeIndex - (last - first) + 1;
+    m_nextNode = firstInternal;
+    buildTree(first, last, m_nodes[a_nodeIndex].m_depth);
+    m_nextNode = (int)(m_nodes.size());
+
+    // update cost and quality of subtree
+    computeCost(first, last, true);
+    computeCost(firstInternal, a_nodeIndex, true);
 }
 
 
@@ -51,6 +51,10 @@
 #include "collisions/CGenericCollision.h"
 #include "collisions/CCollisionAABBTree.h"
 //------------------------------------------------------------------------------
+#include <atomic>
+#include <condition_variable>
+#include <mutex>
+#include <thread>
 #include <vector>
 //------------------------------------------------------------------------------
 
@@ -58,6 +62,11 @@
 namespace chai3d {
 //------------------------------------------------------------------------------
 
+//------------------------------------------------------------------------------
+//! Minimum number of elements for leaves to be refit on several threads.
+const int C_AABB_PARALLEL_THRESHOLD = 16384;
+//------------------------------------------------------------------------------
+
 //==============================================================================
 /*!
     \file       CCollisionAABB.h
@@ -78,7 +87,12 @@ namespace chai3d {
     \details
     This class implements an axis-aligned bounding box collision detection
     tree to efficiently detect for any collision between a line segment and 
-    a collection of elements (point, segment, triangle) that compose an object.
+    a collection of elements (point, segment, triangle) that compose an object.\n\n
+
+    When the vertices of the object move (e.g. deformable or animated meshes),
+    \ref update() refits the boundary boxes of the existing tree bottom-up 
+    in linear time instead of rebuilding it. Subtrees whose quality degrades
+    beyond a threshold (see \ref setRebuildThreshold()) are rebuilt in place.
 */
 //==============================================================================
 class cCollisionAABB : public cGenericCollision
@@ -130,6 +144,30 @@ public:
                           cCollisionRecorder& a_recorder,
                           cCollisionSettings& a_settings);
 
+    //! This method refits the collision tree to the current vertex positions, rebuilding degraded subtrees.
+    void update();
+
+    //! This method sets the degradation ratio above which a subtree is rebuilt by \ref update(). A value of 0 disables rebuilds.
+    void setRebuildThreshold(const double a_rebuildThreshold) { m_rebuildThreshold = cMax(0.0, a_rebuildThreshold); }
+
+    //! This method returns the degradation ratio above which a subtree is rebuilt by \ref update().
+    double getRebuildThreshold() const { return (m_rebuildThreshold); }
+
+    //! This method initializes the collision tree from nodes previously returned by \ref getNodes(), taking over their content.
+    bool initialize(const cGenericArrayPtr a_elements,
+                    const double a_radius,
+                    std::vector<cCollisionAABBNode>& a_nodes,
+                    const int a_rootIndex);
+
+    //! This method returns the nodes of the collision tree. Leaves come first and children are stored before their parent.
+    const std::vector<cCollisionAABBNode>& getNodes() const { return (m_nodes); }
+
+    //! This method returns the index number of the root node, or -1 if the tree is empty.
+    int getRootIndex() const { return (m_rootIndex); }
+
+    //! This method returns the collision shell radius around elements.
+    double getRadius() const { return (m_radius); }
+
 
     //--------------------------------------------------------------------------
     // PROTECTED METHODS:
@@ -140,6 +178,31 @@ protected:
     // This method is used to recursively build the collision tree.
     int buildTree(const int a_indexFirstNode, const int a_indexLastNode, const int a_depth);
 
+    //! This method fits the boundary boxes of a range of leaf nodes to their elements.
+    void refitLeaves(const int a_indexFirstNode, const int a_indexLastNode);
+
+    //! This method updates the cost of a range of nodes, storing the resulting quality of internal nodes if requested.
+    void computeCost(const int a_indexFirstNode, const int a_indexLastNode, const bool a_storeQuality);
+
+    //! This method rebuilds the subtree below an internal node in place.
+    void rebuildSubtree(const int a_nodeIndex);
+
+    //! This method starts the worker threads used to refit leaves, if not already started.
+    void startWorkers();
+
+    //! This method refits the share of leaves of a thread.
+    void runRefit(const int a_threadIndex);
+
+    //! This method implements the main loop of worker threads.
+    void workerLoop(const int a_threadIndex);
+
+    //! This method returns the (half) surface area of a box.
+    static inline double getArea(const cCollisionAABBBox& a_box)
+    {
+        cVector3d extent = a_box.getExtent();
+        return (extent(0)*extent(1) + extent(1)*extent(2) + extent(2)*extent(0));
+    }
+
 
     //--------------------------------------------------------------------------
     // PROTECTED MEMBERS:
@@ -164,6 +227,46 @@ protected:
 
     //! Maximum depth of tree.
     int m_maxDepth;
+
+    //! Index at which \ref buildTree() writes its next internal node.
+    int m_nextNode;
+
+    //! Surface area heuristic cost of each node (sum of areas of the node and its descendants).
+    std::vector<double> m_cost;
+
+    //! Quality (normalized cost) of each internal node when it was last built.
+    std::vector<double> m_quality;
+
+    //! Stack of internal nodes checked for degradation by \ref update().
+    std::vector<int> m_checkStack;
+
+    //! Degradation ratio (current over built quality) above which a subtree is rebuilt.
+    double m_rebuildThreshold;
+
+
+    //--------------------------------------------------------------------------
+    // PROTECTED MEMBERS - THREADS:
+    //--------------------------------------------------------------------------
+
+protected:
+
+    //! Worker threads refitting leaves (the calling thread also refits its share).
+    std::vector<std::thread> m_workers;
+
+    //! Mutex protecting refit generation.
+    std::mutex m_mutex;
+
+    //! Condition used to wake workers for a new refit.
+    std::condition_variable m_wake;
+
+    //! Generation number of current refit.
+    unsigned int m_generation;
+
+    //! Number of workers which have not completed the current refit.
+    std::atomic<int> m_pending;
+
+    //! If __true__, then workers exit.
+    bool m_quit;
 };
 
 //------------------------------------------------------------------------------
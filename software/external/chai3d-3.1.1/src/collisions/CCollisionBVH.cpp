@@ -0,0 +1,960 @@
+//==============================================================================
+/*
+    Software License Agreement (BSD License)
+    Copyright (c) 2003-2016, CHAI3D.
+    (www.chai3d.org)
+
+    All rights reserved.
+
+    Redistribution and use in source and binary forms, with or without
+    modification, are permitted provided that the following conditions
+    are met:
+
+    * Redistributions of source code must retain the above copyright
+    notice, this list of conditions and the following disclaimer.
+
+    * Redistributions in binary form must reproduce the above
+    copyright notice, this list of conditions and the following
+    disclaimer in the documentation and/or other materials provided
+    with the distribution.
+
+    * Neither the name of CHAI3D nor the names of its contributors may
+    be used to endorse or promote products derived from this software
+    without specific prior written permission.
+
+    THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS
+    "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT
+    LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS
+    FOR A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE
+    COPYRIGHT OWNER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT,
+    INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING,
+    BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES;
+    LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER
+    CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT
+    LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN
+    ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE
+    POSSIBILITY OF SUCH DAMAGE.
+
+    \author    <http://www.chai3d.org>
+    \version   3.1.1 $Rev: 1869 $
+*/
+//==============================================================================
+
+//------------------------------------------------------------------------------
+#include "collisions/CCollisionBVH.h"
+#include "graphics/CDraw3D.h"
+//------------------------------------------------------------------------------
+#include <algorithm>
+#include <thread>
+//------------------------------------------------------------------------------
+using namespace std;
+//------------------------------------------------------------------------------
+
+//------------------------------------------------------------------------------
+namespace chai3d {
+//------------------------------------------------------------------------------
+
+//==============================================================================
+/*!
+    Constructor of cCollisionBVH.
+*/
+//==============================================================================
+cCollisionBVH::cCollisionBVH()
+{
+    // radius padding around elements
+    m_radiusAroundElements = 0.0;
+
+    // list of elements
+    m_elements = nullptr;
+
+    // number of elements
+    m_numElements = 0;
+
+    // clear nodes
+    m_nodes.clear();
+
+    // initialize variables
+    m_maxDepth = 0;
+    m_radius = 0.0;
+}
+
+
+//==============================================================================
+/*!
+    Destructor of cCollisionBVH.
+*/
+//==============================================================================
+cCollisionBVH::~cCollisionBVH()
+{
+}
+
+
+//==============================================================================
+/*!
+    This method builds a BVH collision-detection tree for a collection of 
+    elements passed as argument. \n\n
+
+    Elements are split recursively using a binned surface area heuristic,
+    until leaves hold at most \ref C_BVH_MAX_LEAF_SIZE elements. Subtrees 
+    holding more than \ref C_BVH_PARALLEL_THRESHOLD elements are built on 
+    separate threads.
+
+    \param  a_elements  Pointer to element array.
+    \param  a_radius    Bounding radius to add around each elements.
+*/
+//==============================================================================
+void cCollisionBVH::initialize(const cGenericArrayPtr a_elements, const double a_radius)
+{
+    ////////////////////////////////////////////////////////////////////////////
+    // INITIALIZATION
+    ////////////////////////////////////////////////////////////////////////////
+
+    // clear previous tree
+    m_nodes.clear();
+    m_elementIndices.clear();
+    m_maxDepth = 0;
+
+    // sanity check
+    if (a_elements == nullptr)
+    {
+        m_numElements = 0;
+        return;
+    }
+    m_elements = a_elements;
+
+    // store radius
+    m_radius = a_radius;
+
+    // get number of elements
+    m_numElements = m_elements->getNumElements();
+
+    // if zero elements, then exit
+    if (m_numElements == 0)
+    {
+        return;
+    }
+
+
+    ////////////////////////////////////////////////////////////////////////////
+    // COMPUTE ELEMENT BOXES
+    ////////////////////////////////////////////////////////////////////////////
+
+    m_elementMin.resize(m_numElements);
+    m_elementMax.resize(m_numElements);
+    m_elementIndices.resize(m_numElements);
+    for (int i=0; i<m_numElements; i++)
+    {
+        computeElementBox(i, m_elementMin[i], m_elementMax[i]);
+        m_elementIndices[i] = i;
+    }
+
+
+    ////////////////////////////////////////////////////////////////////////////
+    // CREATE TREE
+    ////////////////////////////////////////////////////////////////////////////
+
+    int numThreads = cMax(1, (int)(thread::hardware_concurrency()));
+    m_nodes.reserve(2 * m_numElements);
+    buildTree(0, m_numElements, 0, m_nodes, numThreads);
+
+    // compute depth of tree
+    int stack[C_BVH_MAX_DEPTH + 1][2];
+    int index = 0;
+    stack[0][0] = 0;
+    stack[0][1] = 0;
+    while (index > -1)
+    {
+        int nodeIndex = stack[index][0];
+        int depth = stack[index][1];
+        index--;
+        m_maxDepth = cMax(m_maxDepth, depth);
+        if (m_nodes[nodeIndex].m_count == 0)
+        {
+            stack[++index][0] = nodeIndex + 1;
+            stack[index][1] = depth + 1;
+            stack[++index][0] = m_nodes[nodeIndex].m_offset;
+            stack[index][1] = depth + 1;
+        }
+    }
+
+    // element boxes are no longer needed
+    m_elementMin.clear();
+    m_elementMin.shrink_to_fit();
+    m_elementMax.clear();
+    m_elementMax.shrink_to_fit();
+}
+
+
+//==============================================================================
+/*!
+    This method initializes the collision tree from the nodes and element
+    indices previously returned by \ref getNodes() and 
+    \ref getElementIndices(), for instance after reading them from a file.
+    This avoids building the tree again when the elements have not changed.\n\n
+
+    The nodes are checked to form a valid depth-first tree over the 
+    elements. If they do, they are swapped into the tree, and __a_nodes__ 
+    and __a_elementIndices__ are left empty. Otherwise, the tree is built 
+    from the elements instead.
+
+    \param  a_elements        Pointer to element array.
+    \param  a_radius          Bounding radius around each element used to build the nodes.
+    \param  a_nodes           List of nodes.
+    \param  a_elementIndices  List of element indices referred to by the leaves.
+
+    \return __true__ if the nodes were used, __false__ if the tree was built instead.
+*/
+//==============================================================================
+bool cCollisionBVH::initialize(const cGenericArrayPtr a_elements, 
+                               const double a_radius,
+                               std::vector<cCollisionBVHNode>& a_nodes,
+                               std::vector<int>& a_elementIndices)
+{
+    // sanity check
+    if (a_elements == nullptr)
+    {
+        initialize(a_elements, a_radius);
+        return (false);
+    }
+
+    // element indices must be a permutation of the elements
+    int numElements = a_elements->getNumElements();
+    int numNodes = (int)(a_nodes.size());
+    bool valid = ((int)(a_elementIndices.size()) == numElements) && ((numElements == 0) == (numNodes == 0));
+    vector<bool> used(valid ? numElements : 0, false);
+    for (int i=0; (i<numElements) && valid; i++)
+    {
+        int index = a_elementIndices[i];
+        valid = (index >= 0) && (index < numElements) && (!used[index]);
+        if (valid) { used[index] = true; }
+    }
+
+    // walk the tree from its root: every node must be reached exactly once, 
+    // children must be stored after their parent, and leaves must cover 
+    // all element indices
+    int maxDepth = 0;
+    int numVisited = 0;
+    int numCovered = 0;
+    if (valid && (numNodes > 0))
+    {
+        vector<bool> visited(numNodes, false);
+        int stack[C_BVH_MAX_DEPTH + 1][2];
+        int index = 0;
+        stack[0][0] = 0;
+        stack[0][1] = 0;
+        while ((index > -1) && valid)
+        {
+            int nodeIndex = stack[index][0];
+            int depth = stack[index][1];
+            index--;
+
+            valid = (!visited[nodeIndex]) && (depth <= C_BVH_MAX_DEPTH);
+            if (!valid) { break; }
+            visited[nodeIndex] = true;
+            numVisited++;
+            maxDepth = cMax(maxDepth, depth);
+
+            const cCollisionBVHNode& node = a_nodes[nodeIndex];
+            if (node.m_count > 0)
+            {
+                valid = (node.m_offset >= 0) && (node.m_offset + node.m_count <= numElements);
+                numCovered += node.m_count;
+            }
+            else
+            {
+                valid = (nodeIndex + 1 < numNodes) && 
+                        (node.m_offset > nodeIndex + 1) && (node.m_offset < numNodes) &&
+                        (depth < C_BVH_MAX_DEPTH);
+                if (valid)
+                {
+                    stack[++index][0] = nodeIndex + 1;
+                    stack[index][1] = depth + 1;
+                    stack[++index][0] = node.m_offset;
+                    stack[index][1] = depth + 1;
+                }
+            }
+        }
+        valid = valid && (numVisited == numNodes) && (numCovered == numElements);
+    }
+
+    // build tree from elements
+    if (!valid)
+    {
+        initialize(a_elements, a_radius);
+        return (false);
+    }
+
+    // use nodes
+    m_elements = a_elements;
+    m_radius = a_radius;
+    m_numElements = numElements;
+    m_nodes.clear();
+    m_nodes.swap(a_nodes);
+    m_elementIndices.clear();
+    m_elementIndices.swap(a_elementIndices);
+    m_maxDepth = maxDepth;
+
+    return (true);
+}
+
+
+//==============================================================================
+/*!
+    This method checks which elements of the mesh are intersected by a batch
+    of line segments, traversing the tree once for all of them. \n\n
+
+    Each node is tested against all segments that intersect its parent (see
+    \ref intersect()), and is skipped when none of them intersect it. Nodes 
+    near the top of the tree are therefore fetched once instead of once per 
+    segment. The collision events of each segment are reported in its own 
+    recorder. Batches larger than \ref C_COLLISION_MAX_SEGMENTS are traversed
+    in chunks.
+
+    \param  a_object          Object for which collision detector is being used.
+    \param  a_numSegments     Number of segments.
+    \param  a_segmentPointsA  Initial points of segments.
+    \param  a_segmentPointsB  End points of segments.
+    \param  a_recorders       Recorders which store the collision events of each segment.
+    \param  a_settings        Contains collision settings information.
+
+    \return  __true__ if a collision event has occurred, __false__otherwise.
+*/
+//==============================================================================
+bool cCollisionBVH::computeCollisionBatch(cGenericObject* a_object,
+                                          const int a_numSegments,
+                                          cVector3d* a_segmentPointsA,
+                                          cVector3d* a_segmentPointsB,
+                                          cCollisionRecorder** a_recorders,
+                                          cCollisionSettings& a_settings)
+{
+    // sanity check
+    if ((m_nodes.empty()) || (a_numSegments < 1)) { return (false); }
+
+    // segments are tracked by a bit mask; larger batches are processed in chunks
+    if (a_numSegments > C_COLLISION_MAX_SEGMENTS)
+    {
+        bool result = false;
+        for (int first=0; first<a_numSegments; first+=C_COLLISION_MAX_SEGMENTS)
+        {
+            result = result | computeCollisionBatch(a_object,
+                                                    cMin(a_numSegments - first, C_COLLISION_MAX_SEGMENTS),
+                                                    &a_segmentPointsA[first],
+                                                    &a_segmentPointsB[first],
+                                                    &a_recorders[first],
+                                                    a_settings);
+        }
+        return (result);
+    }
+    int numSegments = a_numSegments;
+
+    // segment origins & inverse directions, in single precision and stored per axis
+    float origin[3][C_COLLISION_MAX_SEGMENTS] = {};
+    float invDir[3][C_COLLISION_MAX_SEGMENTS] = {};
+    unsigned int negDir[3] = { 0, 0, 0 };
+    for (int k=0; k<numSegments; k++)
+    {
+        for (int i=0; i<3; i++)
+        {
+            double dir = a_segmentPointsB[k](i) - a_segmentPointsA[k](i);
+            origin[i][k] = (float)(a_segmentPointsA[k](i));
+            invDir[i][k] = (fabs(dir) > C_TINY) ? (float)(1.0 / dir) : ((dir < 0.0) ? -1e30f : 1e30f);
+            if (dir < 0.0) { negDir[i] |= (1u << k); }
+        }
+    }
+
+    // no collision occurred yet
+    bool result = false;
+
+    // collision search; each stack entry holds a node and the segments that intersect its parent
+    int stack[C_BVH_MAX_DEPTH + 1];
+    unsigned int stackMask[C_BVH_MAX_DEPTH + 1];
+    int index = -1;
+    int nodeIndex = 0;
+    unsigned int mask = (numSegments == 32) ? 0xffffffffu : ((1u << numSegments) - 1);
+    while (true)
+    {
+        const cCollisionBVHNode& node = m_nodes[nodeIndex];
+
+        mask = intersect(node, mask, origin, invDir);
+        if (mask != 0)
+        {
+            //------------------------------------------------------------------
+            // LEAF NODE:
+            //------------------------------------------------------------------
+            if (node.m_count > 0)
+            {
+                for (int i=node.m_offset; i<node.m_offset+node.m_count; i++)
+                {
+                    int elementIndex = m_elementIndices[i];
+                    if (!m_elements->m_allocated[elementIndex]) { continue; }
+
+                    // call the element's collision detection method for each segment
+                    for (int k=0; k<numSegments; k++)
+                    {
+                        if ((mask & (1u << k)) == 0) { continue; }
+                        if (m_elements->computeCollision(elementIndex,
+                                                         a_object,
+                                                         a_segmentPointsA[k],
+                                                         a_segmentPointsB[k],
+                                                         *a_recorders[k],
+                                                         a_settings))
+                        {
+                            result = true;
+                        }
+                    }
+                }
+            }
+
+            //------------------------------------------------------------------
+            // INTERNAL NODE: visit nearest child first (left, unless all
+            // segments point backwards along the split axis)
+            //------------------------------------------------------------------
+            else
+            {
+                stackMask[++index] = mask;
+                if ((negDir[node.m_axis] & mask) == mask)
+                {
+                    stack[index] = nodeIndex + 1;
+                    nodeIndex = node.m_offset;
+                }
+                else
+                {
+                    stack[index] = node.m_offset;
+                    nodeIndex = nodeIndex + 1;
+                }
+                continue;
+            }
+        }
+
+        // pop stack
+        if (index < 0) { break; }
+        nodeIndex = stack[index];
+        mask = stackMask[index--];
+    }
+
+    // return result
+    return (result);
+}
+
+
+//==============================================================================
+/*!
+    This method refits the collision tree to the current positions of the
+    vertices, without changing its structure. Because children are always
+    stored after their parent, nodes are refit in a single reverse pass.\n\n
+
+    Unlike \ref cCollisionAABB::update(), degraded subtrees are not rebuilt; 
+    call \ref initialize() again if deformations are large.
+*/
+//==============================================================================
+void cCollisionBVH::update()
+{
+    // sanity check
+    if (m_elements == nullptr) { return; }
+
+    // if elements were added or removed, the tree must be rebuilt
+    if ((int)(m_elements->getNumElements()) != m_numElements)
+    {
+        initialize(m_elements, m_radius);
+        return;
+    }
+
+    for (int i=(int)(m_nodes.size())-1; i>=0; i--)
+    {
+        cCollisionBVHNode& node = m_nodes[i];
+
+        // leaf node: enclose elements
+        if (node.m_count > 0)
+        {
+            cVector3d min, max;
+            computeElementBox(m_elementIndices[node.m_offset], min, max);
+            for (int j=node.m_offset+1; j<node.m_offset+node.m_count; j++)
+            {
+                cVector3d elementMin, elementMax;
+                computeElementBox(m_elementIndices[j], elementMin, elementMax);
+                min.set(cMin(min(0), elementMin(0)), cMin(min(1), elementMin(1)), cMin(min(2), elementMin(2)));
+                max.set(cMax(max(0), elementMax(0)), cMax(max(1), elementMax(1)), cMax(max(2), elementMax(2)));
+            }
+            setNodeBox(node, min, max);
+        }
+
+        // internal node: enclose children
+        else
+        {
+            const cCollisionBVHNode& left = m_nodes[i+1];
+            const cCollisionBVHNode& right = m_nodes[node.m_offset];
+            for (int k=0; k<3; k++)
+            {
+                node.m_min[k] = cMin(left.m_min[k], right.m_min[k]);
+                node.m_max[k] = cMax(left.m_max[k], right.m_max[k]);
+            }
+        }
+    }
+}
+
+
+//==============================================================================
+/*!
+    This method computes the bounding box of an element, including the 
+    collision shell radius.
+
+    \param  a_elementIndex  Index of element.
+    \param  a_min           Returned lower corner of box.
+    \param  a_max           Returned upper corner of box.
+*/
+//==============================================================================
+void cCollisionBVH::computeElementBox(const int a_elementIndex, cVector3d& a_min, cVector3d& a_max)
+{
+    int numVerticesPerElement = m_elements->getNumVerticesPerElement();
+
+    a_min = m_elements->m_vertices->getLocalPos(m_elements->getVertexIndex(a_elementIndex, 0));
+    a_max = a_min;
+    for (int i=1; i<numVerticesPerElement; i++)
+    {
+        cVector3d vertex = m_elements->m_vertices->getLocalPos(m_elements->getVertexIndex(a_elementIndex, i));
+        a_min.set(cMin(a_min(0), vertex(0)), cMin(a_min(1), vertex(1)), cMin(a_min(2), vertex(2)));
+        a_max.set(cMax(a_max(0), vertex(0)), cMax(a_max(1), vertex(1)), cMax(a_max(2), vertex(2)));
+    }
+
+    // add radius envelope
+    a_min.sub(m_radius, m_radius, m_radius);
+    a_max.add(m_radius, m_radius, m_radius);
+}
+
+
+//==============================================================================
+/*!
+    This method sets the bounds of a node. Values are rounded outwards to single
+    precision so that the node always encloses its elements.
+
+    \param  a_node  Node to modify.
+    \param  a_min   Lower corner of box.
+    \param  a_max   Upper corner of box.
+*/
+//==============================================================================
+void cCollisionBVH::setNodeBox(cCollisionBVHNode& a_node, const cVector3d& a_min, const cVector3d& a_max)
+{
+    for (int i=0; i<3; i++)
+    {
+        float lo = (float)(a_min(i));
+        float hi = (float)(a_max(i));
+        if ((double)lo > a_min(i)) { lo = nextafterf(lo, -FLT_MAX); }
+        if ((double)hi < a_max(i)) { hi = nextafterf(hi, FLT_MAX); }
+        a_node.m_min[i] = lo;
+        a_node.m_max[i] = hi;
+    }
+}
+
+
+//==============================================================================
+/*!
+    This method finds the best split of a range of elements according to the 
+    surface area heuristic, evaluated over \ref C_BVH_NUM_BINS bins of element
+    centers along each axis. Elements are partitioned accordingly.
+
+    \param  a_first  Index of first element (in element index list).
+    \param  a_last   Index after last element (in element index list).
+    \param  a_min    Lower corner of box enclosing all elements in range.
+    \param  a_max    Upper corner of box enclosing all elements in range.
+    \param  a_axis   Returned axis of split.
+
+    \return  Index of first element of right subtree, or -1 if a leaf is cheaper.
+*/
+//==============================================================================
+int cCollisionBVH::findSplit(const int a_first,
+                             const int a_last,
+                             const cVector3d& a_min,
+                             const cVector3d& a_max,
+                             int& a_axis)
+{
+    int count = a_last - a_first;
+
+    // compute box enclosing element centers
+    cVector3d cmin( C_LARGE,  C_LARGE,  C_LARGE);
+    cVector3d cmax(-C_LARGE, -C_LARGE, -C_LARGE);
+    for (int i=a_first; i<a_last; i++)
+    {
+        int e = m_elementIndices[i];
+        cVector3d center = 0.5 * (m_elementMin[e] + m_elementMax[e]);
+        cmin.set(cMin(cmin(0), center(0)), cMin(cmin(1), center(1)), cMin(cmin(2), center(2)));
+        cmax.set(cMax(cmax(0), center(0)), cMax(cmax(1), center(1)), cMax(cmax(2), center(2)));
+    }
+
+    // surface area of a box (up to a factor of 2)
+    auto area = [](const cVector3d& a_lo, const cVector3d& a_hi)
+    {
+        cVector3d d = a_hi - a_lo;
+        return (d(0)*d(1) + d(1)*d(2) + d(2)*d(0));
+    };
+
+    // evaluate splits between bins along each axis
+    double bestCost = C_LARGE;
+    int bestAxis = -1;
+    int bestBin = -1;
+    for (int axis=0; axis<3; axis++)
+    {
+        double extent = cmax(axis) - cmin(axis);
+        if (extent <= 0.0) { continue; }
+        double scale = C_BVH_NUM_BINS / extent;
+
+        int binCount[C_BVH_NUM_BINS] = {};
+        cVector3d binMin[C_BVH_NUM_BINS];
+        cVector3d binMax[C_BVH_NUM_BINS];
+        for (int b=0; b<C_BVH_NUM_BINS; b++)
+        {
+            binMin[b].set( C_LARGE,  C_LARGE,  C_LARGE);
+            binMax[b].set(-C_LARGE, -C_LARGE, -C_LARGE);
+        }
+
+        for (int i=a_first; i<a_last; i++)
+        {
+            int e = m_elementIndices[i];
+            double center = 0.5 * (m_elementMin[e](axis) + m_elementMax[e](axis));
+            int b = cMin(C_BVH_NUM_BINS - 1, (int)((center - cmin(axis)) * scale));
+            binCount[b]++;
+            for (int k=0; k<3; k++)
+            {
+                binMin[b](k) = cMin(binMin[b](k), m_elementMin[e](k));
+                binMax[b](k) = cMax(binMax[b](k), m_elementMax[e](k));
+            }
+        }
+
+        // sweep from the right to accumulate areas of right-hand sides
+        double rightArea[C_BVH_NUM_BINS];
+        int rightCount[C_BVH_NUM_BINS];
+        cVector3d lo( C_LARGE,  C_LARGE,  C_LARGE);
+        cVector3d hi(-C_LARGE, -C_LARGE, -C_LARGE);
+        int n = 0;
+        for (int b=C_BVH_NUM_BINS-1; b>0; b--)
+        {
+            n += binCount[b];
+            if (binCount[b] > 0)
+            {
+                for (int k=0; k<3; k++) { lo(k) = cMin(lo(k), binMin[b](k)); hi(k) = cMax(hi(k), binMax[b](k)); }
+            }
+            rightCount[b] = n;
+            rightArea[b] = (n > 0) ? area(lo, hi) : 0.0;
+        }
+
+        // sweep from the left and evaluate cost of each split
+        lo.set( C_LARGE,  C_LARGE,  C_LARGE);
+        hi.set(-C_LARGE, -C_LARGE, -C_LARGE);
+        n = 0;
+        for (int b=0; b<C_BVH_NUM_BINS-1; b++)
+        {
+            n += binCount[b];
+            if (binCount[b] > 0)
+            {
+                for (int k=0; k<3; k++) { lo(k) = cMin(lo(k), binMin[b](k)); hi(k) = cMax(hi(k), binMax[b](k)); }
+            }
+            if ((n == 0) || (rightCount[b+1] == 0)) { continue; }
+            double cost = n * area(lo, hi) + rightCount[b+1] * rightArea[b+1];
+            if (cost < bestCost)
+            {
+                bestCost = cost;
+                bestAxis = axis;
+                bestBin = b;
+            }
+        }
+    }
+
+    // all element centers coincide: split list in half
+    if (bestAxis < 0)
+    {
+        a_axis = 0;
+        return (a_first + count / 2);
+    }
+
+    // compare with cost of a leaf (traversal cost taken equal to element cost)
+    double parentArea = area(a_min, a_max);
+    double splitCost = 1.0 + bestCost / cMax(parentArea, C_TINY);
+    if ((count <= C_BVH_MAX_LEAF_SIZE) && (splitCost >= count))
+    {
+        return (-1);
+    }
+
+    // partition elements about chosen bin boundary
+    double scale = C_BVH_NUM_BINS / (cmax(bestAxis) - cmin(bestAxis));
+    double lo = cmin(bestAxis);
+    int axis = bestAxis;
+    int bin = bestBin;
+    vector<int>::iterator mid = partition(m_elementIndices.begin() + a_first,
+                                          m_elementIndices.begin() + a_last,
+                                          [&](int e)
+    {
+        double center = 0.5 * (m_elementMin[e](axis) + m_elementMax[e](axis));
+        return (cMin(C_BVH_NUM_BINS - 1, (int)((center - lo) * scale)) <= bin);
+    });
+
+    a_axis = axis;
+    return ((int)(mid - m_elementIndices.begin()));
+}
+
+
+//==============================================================================
+/*!
+    This method recursively builds the subtree of a range of elements. Nodes 
+    are appended to a list in depth-first order; the index of right children 
+    is relative to the start of the list.
+
+    \param  a_first       Index of first element (in element index list).
+    \param  a_last        Index after last element (in element index list).
+    \param  a_depth       Current depth of the tree. Root starts at 0.
+    \param  a_nodes       List to which nodes are appended.
+    \param  a_numThreads  Number of threads available for building this subtree.
+
+    \return  Index of the subtree root in list.
+*/
+//==============================================================================
+int cCollisionBVH::buildTree(const int a_first,
+                             const int a_last,
+                             const int a_depth,
+                             vector<cCollisionBVHNode>& a_nodes,
+                             const int a_numThreads)
+{
+    int count = a_last - a_first;
+
+    // create a box to enclose all elements below this node
+    cVector3d min( C_LARGE,  C_LARGE,  C_LARGE);
+    cVector3d max(-C_LARGE, -C_LARGE, -C_LARGE);
+    for (int i=a_first; i<a_last; i++)
+    {
+        int e = m_elementIndices[i];
+        min.set(cMin(min(0), m_elementMin[e](0)), cMin(min(1), m_elementMin[e](1)), cMin(min(2), m_elementMin[e](2)));
+        max.set(cMax(max(0), m_elementMax[e](0)), cMax(max(1), m_elementMax[e](1)), cMax(max(2), m_elementMax[e](2)));
+    }
+
+    // create node
+    cCollisionBVHNode node;
+    setNodeBox(node, min, max);
+    node.m_offset = a_first;
+    node.m_count = (unsigned short)count;
+    node.m_axis = 0;
+
+    int index = (int)(a_nodes.size());
+    a_nodes.push_back(node);
+
+    // single element: leaf
+    if (count <= 1)
+    {
+        return (index);
+    }
+
+    // find split; below half of maximum depth, split at median to bound depth
+    int axis = 0;
+    int mid;
+    if (a_depth < C_BVH_MAX_DEPTH / 2)
+    {
+        mid = findSplit(a_first, a_last, min, max, axis);
+        if (mid < 0)
+        {
+            return (index);
+        }
+    }
+    else
+    {
+        mid = a_first + count / 2;
+    }
+    if ((mid <= a_first) || (mid >= a_last))
+    {
+        mid = a_first + count / 2;
+    }
+
+    // internal node
+    a_nodes[index].m_count = 0;
+    a_nodes[index].m_axis = (unsigned short)axis;
+
+    // build large subtrees in parallel, then append them in depth-first order
+    if ((a_numThreads > 1) && (count > C_BVH_PARALLEL_THRESHOLD))
+    {
+        vector<cCollisionBVHNode> left;
+        vector<cCollisionBVHNode> right;
+        int numThreadsLeft = a_numThreads / 2;
+        thread worker([&]() { buildTree(a_first, mid, a_depth + 1, left, numThreadsLeft); });
+        buildTree(mid, a_last, a_depth + 1, right, a_numThreads - numThreadsLeft);
+        worker.join();
+
+        int offsetLeft = index + 1;
+        int offsetRight = offsetLeft + (int)(left.size());
+        for (unsigned int i=0; i<left.size(); i++)
+        {
+            if (left[i].m_count == 0) { left[i].m_offset += offsetLeft; }
+            a_nodes.push_back(left[i]);
+        }
+        for (unsigned int i=0; i<right.size(); i++)
+        {
+            if (right[i].m_count == 0) { right[i].m_offset += offsetRight; }
+            a_nodes.push_back(right[i]);
+        }
+        a_nodes[index].m_offset = offsetRight;
+    }
+    else
+    {
+        buildTree(a_first, mid, a_depth + 1, a_nodes, 1);
+        int right = (int)(a_nodes.size());
+        buildTree(mid, a_last, a_depth + 1, a_nodes, 1);
+        a_nodes[index].m_offset = right;
+    }
+
+    return (index);
+}
+
+
+//==============================================================================
+/*!
+    This method checks if the given line segment intersects any element of the 
+    mesh. 
+
+    If a collision occurs, the method returns __true__, and the collision events
+    are reported through the collision recorder. Children are visited 
+    front-to-back along the segment, using a fixed-size stack.
+
+    \param  a_object         Object for which collision detector is being used.
+    \param  a_segmentPointA  Initial point of segment.
+    \param  a_segmentPointB  End point of segment.
+    \param  a_recorder       Recorder which stores all collision events.
+    \param  a_settings       Contains collision settings information.
+
+    \return  __true__ if a collision event has occurred, __false__otherwise.
+*/
+//==============================================================================
+bool cCollisionBVH::computeCollision(cGenericObject* a_object,
+                                     cVector3d& a_segmentPointA, 
+                                     cVector3d& a_segmentPointB,
+                                     cCollisionRecorder& a_recorder, 
+                                     cCollisionSettings& a_settings)
+{
+    // sanity check
+    if (m_nodes.empty()) { return (false); }
+
+    // segment origin & inverse direction, in single precision
+    float origin[3];
+    float invDir[3];
+    bool negDir[3];
+    for (int i=0; i<3; i++)
+    {
+        double dir = a_segmentPointB(i) - a_segmentPointA(i);
+        origin[i] = (float)(a_segmentPointA(i));
+        invDir[i] = (fabs(dir) > C_TINY) ? (float)(1.0 / dir) : ((dir < 0.0) ? -1e30f : 1e30f);
+        negDir[i] = (dir < 0.0);
+    }
+
+    // no collision occurred yet
+    bool result = false;
+
+    // collision search
+    int stack[C_BVH_MAX_DEPTH + 1];
+    int index = -1;
+    int nodeIndex = 0;
+    while (true)
+    {
+        const cCollisionBVHNode& node = m_nodes[nodeIndex];
+
+        if (intersect(node, origin, invDir))
+        {
+            //------------------------------------------------------------------
+            // LEAF NODE:
+            //------------------------------------------------------------------
+            if (node.m_count > 0)
+            {
+                for (int i=node.m_offset; i<node.m_offset+node.m_count; i++)
+                {
+                    // call the element's collision detection method
+                    int elementIndex = m_elementIndices[i];
+                    if (m_elements->m_allocated[elementIndex])
+                    {
+                        if (m_elements->computeCollision(elementIndex,
+                                                         a_object,
+                                                         a_segmentPointA,
+                                                         a_segmentPointB,
+                                                         a_recorder,
+                                                         a_settings))
+                        {
+                            result = true;
+                        }
+                    }
+                }
+            }
+
+            //------------------------------------------------------------------
+            // INTERNAL NODE: visit nearest child first
+            //------------------------------------------------------------------
+            else
+            {
+                if (negDir[node.m_axis])
+                {
+                    stack[++index] = nodeIndex + 1;
+                    nodeIndex = node.m_offset;
+                }
+                else
+                {
+                    stack[++index] = node.m_offset;
+                    nodeIndex = nodeIndex + 1;
+                }
+                continue;
+            }
+        }
+
+        // pop stack
+        if (index < 0) { break; }
+        nodeIndex = stack[index--];
+    }
+
+    // return result
+    return (result);
+}
+
+
+//==============================================================================
+/*!
+    This method graphically renders the boundary boxes of the collision tree 
+    using OpenGL.
+*/
+//==============================================================================
+void cCollisionBVH::render(cRenderOptions& /*a_options*/)
+{
+#ifdef C_USE_OPENGL
+
+    if (m_nodes.empty()) { return; }
+
+    // set rendering settings
+    glDisable(GL_LIGHTING);
+    glLineWidth(1.0);
+    glColor4fv(m_color.getData());
+
+    // render boxes at requested depth (see cCollisionAABBNode::render())
+    int stack[C_BVH_MAX_DEPTH + 1][2];
+    int index = 0;
+    stack[0][0] = 0;
+    stack[0][1] = 0;
+    while (index > -1)
+    {
+        int nodeIndex = stack[index][0];
+        int depth = stack[index][1];
+        index--;
+
+        const cCollisionBVHNode& node = m_nodes[nodeIndex];
+        if (((m_displayDepth < 0) && (abs(m_displayDepth) >= depth)) || (m_displayDepth == depth))
+        {
+            cDrawWireBox(node.m_min[0], node.m_max[0], node.m_min[1], node.m_max[1], node.m_min[2], node.m_max[2]);
+        }
+
+        if (node.m_count == 0)
+        {
+            stack[++index][0] = nodeIndex + 1;
+            stack[index][1] = depth + 1;
+            stack[++index][0] = node.m_offset;
+            stack[index][1] = depth + 1;
+        }
+    }
+
+    // restore lighting settings
+    glEnable(GL_LIGHTING);
+
+#endif
+}
+
+
+//------------------------------------------------------------------------------
+} // namespace chai3d
+//------------------------------------------------------------------------------
@@ -0,0 +1,332 @@
+//==============================================================================
+/*
+    Software License Agreement (BSD License)
+    Copyright (c) 2003-2016, CHAI3D.
+    (www.chai3d.org)
+
+    All rights reserved.
+
+    Redistribution and use in source and binary forms, with or without
+    modification, are permitted provided that the following conditions
+    are met:
+
+    * Redistributions of source code must retain the above copyright
+    notice, this list of conditions and the following disclaimer.
+
+    * Redistributions in binary form must reproduce the above
+    copyright notice, this list of conditions and the following
+    disclaimer in the documentation and/or other materials provided
+    with the distribution.
+
+    * Neither the name of CHAI3D nor the names of its contributors may
+    be used to endorse or promote products derived from this software
+    without specific prior written permission.
+
+    THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS
+    "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT
+    LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS
+    FOR A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE
+    COPYRIGHT OWNER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT,
+    INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING,
+    BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES;
+    LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER
+    CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT
+    LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN
+    ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE
+    POSSIBILITY OF SUCH DAMAGE. 
+
+    \author    <http://www.chai3d.org>
+    \version   3.1.1 $Rev: 1869 $
+*/
+//==============================================================================
+
+//------------------------------------------------------------------------------
+#ifndef CCollisionBVHH
+#define CCollisionBVHH
+//------------------------------------------------------------------------------
+#include "math/CMaths.h"
+#include "collisions/CGenericCollision.h"
+#include "graphics/CGenericArray.h"
+//------------------------------------------------------------------------------
+#include <cfloat>
+#include <vector>
+//------------------------------------------------------------------------------
+
+//------------------------------------------------------------------------------
+namespace chai3d {
+//------------------------------------------------------------------------------
+
+//==============================================================================
+/*!
+    \file       CCollisionBVH.h
+
+    \brief
+    Implements a flattened bounding volume hierarchy (BVH) built with the
+    surface area heuristic (SAH).
+*/
+//==============================================================================
+
+//------------------------------------------------------------------------------
+//! Maximum depth of a BVH tree (also size of the fixed traversal stack).
+const int C_BVH_MAX_DEPTH = 64;
+
+//! Maximum number of elements stored in a BVH leaf.
+const int C_BVH_MAX_LEAF_SIZE = 4;
+
+//! Number of bins used by the SAH builder along each axis.
+const int C_BVH_NUM_BINS = 16;
+
+//! Minimum number of elements in a subtree for it to be built on a separate thread.
+const int C_BVH_PARALLEL_THRESHOLD = 65536;
+
+//! Number of segments of a batch tested together against a node (must divide \ref C_COLLISION_MAX_SEGMENTS).
+const int C_BVH_PACKET_SIZE = 8;
+//------------------------------------------------------------------------------
+
+//==============================================================================
+/*!
+    \struct     cCollisionBVHNode
+    \ingroup    collisions
+
+    \brief
+    This structure implements a compact (32 byte) node of a flattened BVH tree.
+
+    \details
+    Nodes are stored in depth-first order: the left child of an internal node
+    immediately follows its parent, and the index of the right child is
+    stored in the node. Bounds are single precision and rounded outwards,
+    so that they always enclose the double precision bounds of the elements.
+*/
+//==============================================================================
+struct cCollisionBVHNode
+{
+    //! Lower corner of bounding box.
+    float m_min[3];
+
+    //! Upper corner of bounding box.
+    float m_max[3];
+
+    //! Internal node: index of right child. Leaf node: index of first element in element index list.
+    int m_offset;
+
+    //! Number of elements in leaf (0 for internal nodes).
+    unsigned short m_count;
+
+    //! Axis along which the children of an internal node were split.
+    unsigned short m_axis;
+};
+
+
+//==============================================================================
+/*!
+    \class      cCollisionBVH
+    \ingroup    collisions
+
+    \brief
+    This class implements a flattened, SAH-built BVH collision detector.
+
+    \details
+    This class implements an alternative to \ref cCollisionAABB for large
+    meshes. The tree is built with a binned surface area heuristic (SAH),
+    which adapts splits to the distribution of elements; large trees are
+    built in parallel on several cores.\n\n
+
+    Nodes are compact and stored depth-first in a single array, so that
+    queries visit memory mostly sequentially. Segment queries traverse the
+    tree front-to-back with a fixed-size stack and perform no memory 
+    allocation, which makes them suitable for the haptic thread.
+*/
+//==============================================================================
+class cCollisionBVH : public cGenericCollision
+{
+    //--------------------------------------------------------------------------
+    // CONSTRUCTOR & DESTRUCTOR:
+    //--------------------------------------------------------------------------
+
+public:
+
+    //! Constructor of cCollisionBVH.
+    cCollisionBVH();
+
+    //! Destructor of cCollisionBVH.
+    virtual ~cCollisionBVH();
+
+
+    //--------------------------------------------------------------------------
+    // PUBLIC METHODS:
+    //--------------------------------------------------------------------------
+
+public:
+
+    //! This method initializes and builds the BVH collision tree.
+    void initialize(const cGenericArrayPtr a_elements,
+                    const double a_radius = 0.0);
+
+    //! This method renders a visual representation of the collision tree.
+    void render(cRenderOptions& a_options);
+
+    //! This method computes all collisions between a segment passed as argument and the attributed 3D object.
+    bool computeCollision(cGenericObject* a_object,
+                          cVector3d& a_segmentPointA,
+                          cVector3d& a_segmentPointB,
+                          cCollisionRecorder& a_recorder,
+                          cCollisionSettings& a_settings);
+
+    //! This method computes all collisions between a batch of segments and the attributed 3D object, traversing the tree once.
+    bool computeCollisionBatch(cGenericObject* a_object,
+                               const int a_numSegments,
+                               cVector3d* a_segmentPointsA,
+                               cVector3d* a_segmentPointsB,
+                               cCollisionRecorder** a_recorders,
+                               cCollisionSettings& a_settings);
+
+    //! This method refits the collision tree to the current vertex positions.
+    void update();
+
+    //! This method returns the number of nodes in the tree.
+    int getNumNodes() const { return ((int)(m_nodes.size())); }
+
+    //! This method returns the depth of the tree.
+    int getMaxDepth() const { return (m_maxDepth); }
+
+    //! This method initializes the collision tree from nodes and element indices previously returned by \ref getNodes() and \ref getElementIndices(), taking over their content.
+    bool initialize(const cGenericArrayPtr a_elements,
+                    const double a_radius,
+                    std::vector<cCollisionBVHNode>& a_nodes,
+                    std::vector<int>& a_elementIndices);
+
+    //! This method returns the nodes of the collision tree, in depth-first order.
+    const std::vector<cCollisionBVHNode>& getNodes() const { return (m_nodes); }
+
+    //! This method returns the element indices referred to by the leaves of the tree.
+    const std::vector<int>& getElementIndices() const { return (m_elementIndices); }
+
+    //! This method returns the collision shell radius around elements.
+    double getRadius() const { return (m_radius); }
+
+
+    //--------------------------------------------------------------------------
+    // PROTECTED METHODS:
+    //--------------------------------------------------------------------------
+
+protected:
+
+    //! This method computes the bounding box of an element.
+    void computeElementBox(const int a_elementIndex, cVector3d& a_min, cVector3d& a_max);
+
+    //! This method recursively builds the subtree of a range of elements, appending its nodes to a list.
+    int buildTree(const int a_first,
+                  const int a_last,
+                  const int a_depth,
+                  std::vector<cCollisionBVHNode>& a_nodes,
+                  const int a_numThreads);
+
+    //! This method finds the best SAH split of a range of elements. Returns -1 if a leaf should be created.
+    int findSplit(const int a_first,
+                  const int a_last,
+                  const cVector3d& a_min,
+                  const cVector3d& a_max,
+                  int& a_axis);
+
+    //! This method sets the bounds of a node, rounding outwards to single precision.
+    static void setNodeBox(cCollisionBVHNode& a_node, const cVector3d& a_min, const cVector3d& a_max);
+
+    //! This method tests a segment (origin and inverse direction) against the bounds of a node.
+    static inline bool intersect(const cCollisionBVHNode& a_node,
+                                 const float a_origin[3],
+                                 const float a_invDir[3])
+    {
+        float tmin = 0.0f;
+        float tmax = 1.0f;
+        for (int i=0; i<3; i++)
+        {
+            float t0 = (a_node.m_min[i] - a_origin[i]) * a_invDir[i];
+            float t1 = (a_node.m_max[i] - a_origin[i]) * a_invDir[i];
+            if (t0 > t1) { float t = t0; t0 = t1; t1 = t; }
+            if (t0 > tmin) { tmin = t0; }
+            if (t1 < tmax) { tmax = t1; }
+        }
+
+        // widen by a few ulps so that grazing segments are never culled
+        return (tmin <= tmax * (1.0f + 4.0f * FLT_EPSILON));
+    }
+
+    //! This method tests the active segments of a batch (stored per axis) against the bounds of a node. Returns a mask of intersecting segments.
+    static inline unsigned int intersect(const cCollisionBVHNode& a_node,
+                                         const unsigned int a_mask,
+                                         const float a_origin[3][C_COLLISION_MAX_SEGMENTS],
+                                         const float a_invDir[3][C_COLLISION_MAX_SEGMENTS])
+    {
+        // same test as above, on groups of segments of fixed size so that the inner loops vectorize
+        unsigned int result = 0;
+        for (int first=0; first<C_COLLISION_MAX_SEGMENTS; first+=C_BVH_PACKET_SIZE)
+        {
+            unsigned int mask = (a_mask >> first) & ((1u << C_BVH_PACKET_SIZE) - 1);
+            if (mask == 0) { continue; }
+
+            float tmin[C_BVH_PACKET_SIZE];
+            float tmax[C_BVH_PACKET_SIZE];
+            for (int k=0; k<C_BVH_PACKET_SIZE; k++)
+            {
+                tmin[k] = 0.0f;
+                tmax[k] = 1.0f;
+            }
+            for (int i=0; i<3; i++)
+            {
+                const float* origin = &a_origin[i][first];
+                const float* invDir = &a_invDir[i][first];
+                for (int k=0; k<C_BVH_PACKET_SIZE; k++)
+                {
+                    float t0 = (a_node.m_min[i] - origin[k]) * invDir[k];
+                    float t1 = (a_node.m_max[i] - origin[k]) * invDir[k];
+                    tmin[k] = cMax(tmin[k], cMin(t0, t1));
+                    tmax[k] = cMin(tmax[k], cMax(t0, t1));
+                }
+            }
+            for (int k=0; k<C_BVH_PACKET_SIZE; k++)
+            {
+                result |= ((unsigned int)(tmin[k] <= tmax[k] * (1.0f + 4.0f * FLT_EPSILON))) << (first + k);
+            }
+        }
+        return (result & a_mask);
+    }
+
+
+    //--------------------------------------------------------------------------
+    // PROTECTED MEMBERS:
+    //--------------------------------------------------------------------------
+
+protected:
+
+    //! Collision shell radius around elements.
+    double m_radius;
+
+    //! Number of elements inside tree.
+    int m_numElements;
+
+    //! Pointer to the list of elements in the object.
+    cGenericArrayPtr m_elements;
+
+    //! List of nodes, in depth-first order (root = 0).
+    std::vector<cCollisionBVHNode> m_nodes;
+
+    //! Element indices, ordered such that each leaf covers a contiguous range.
+    std::vector<int> m_elementIndices;
+
+    //! Bounding box of each element (used while building the tree).
+    std::vector<cVector3d> m_elementMin;
+
+    //! Bounding box of each element (used while building the tree).
+    std::vector<cVector3d> m_elementMax;
+
+    //! Maximum depth of tree.
+    int m_maxDepth;
+};
+
+//------------------------------------------------------------------------------
+} // namespace chai3d
+//------------------------------------------------------------------------------
+
+//------------------------------------------------------------------------------
+#endif
+//------------------------------------------------------------------------------
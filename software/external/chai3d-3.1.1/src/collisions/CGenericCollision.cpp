@@ -68,6 +68,49 @@ cGenericCollision::cGenericCollision()
 }
 
 
+//==============================================================================
+/*!
+    This method computes all collisions between a batch of segments and the 
+    attributed 3D object. Collisions of each segment are reported in its own 
+    recorder. \n\n
+
+    This default implementation queries each segment separately. Collision 
+    detectors which can traverse their data structures once for all segments 
+    (see \ref cCollisionBVH) override this method.
+
+    \param  a_object          Object for which collision detector is being used.
+    \param  a_numSegments     Number of segments.
+    \param  a_segmentPointsA  Initial points of segments.
+    \param  a_segmentPointsB  End points of segments.
+    \param  a_recorders       Recorders which store the collision events of each segment.
+    \param  a_settings        Contains collision settings information.
+
+    \return  __true__ if a collision event has occurred, __false__otherwise.
+*/
+//==============================================================================
+bool cGenericCollision::computeCollisionBatch(cGenericObject* a_object,
+                                              const int a_numSegments,
+                                              cVector3d* a_segmentPointsA,
+                                              cVector3d* a_segmentPointsB,
+                                              cCollisionRecorder** a_recorders,
+                                              cCollisionSettings& a_settings)
+{
+    bool result = false;
+    for (int i=0; i<a_numSegments; i++)
+    {
+        if (computeCollision(a_object,
+                             a_segmentPointsA[i],
+                             a_segmentPointsB[i],
+                             *a_recorders[i],
+                             a_settings))
+        {
+            result = true;
+        }
+    }
+    return (result);
+}
+
+
 //------------------------------------------------------------------------------
 } // namespace chai3d
 //------------------------------------------------------------------------------
@@ -63,6 +63,11 @@ namespace chai3d {
 */
 //==============================================================================
 
+//------------------------------------------------------------------------------
+//! Maximum number of segments processed together by a batched collision query.
+const int C_COLLISION_MAX_SEGMENTS = 32;
+//------------------------------------------------------------------------------
+
 //==============================================================================
 /*!
     \class      cGenericCollision
@@ -92,7 +97,9 @@ namespace chai3d {
     If the shape of the object is modified (e.g triangles are added or removed
     from a mesh), then the \ref initialize() command of the collision detector
     must be called again. The method is responsible for deallocating any 
-    previously built data structures.\n\n
+    previously built data structures. If only the positions of the vertices
+    change (e.g. deformable or animated objects), then \ref update() can be
+    called instead, which is typically much faster.\n\n
 
     Please note that this class does not support collision detection 
     between objects themselves.\n\n
@@ -123,6 +130,9 @@ public:
     //! This method initializes the collision detector.
     virtual void initialize(const double a_radius = 0.0) {};
 
+    //! This method updates the collision detector after vertices have moved.
+    virtual void update() {};
+
     //! This method renders a visual representation of the collision tree.
     virtual void render(cRenderOptions& a_options) {};
 
@@ -133,6 +143,14 @@ public:
                                   cCollisionRecorder& a_recorder,
                                   cCollisionSettings& a_settings)
                                   { return (false); }
+
+    //! This method computes all collisions between a batch of segments passed as argument and the attributed 3D object.
+    virtual bool computeCollisionBatch(cGenericObject* a_object,
+                                       const int a_numSegments,
+                                       cVector3d* a_segmentPointsA,
+                                       cVector3d* a_segmentPointsB,
+                                       cCollisionRecorder** a_recorders,
+                                       cCollisionSettings& a_settings);
     
     //! This method returns the radius of the boundary shell that covers every triangles.
     double getBoundaryRadius() const { return (m_radiusAroundElements); }
@@ -1404,6 +1404,8 @@ void cCamera::renderView(const int a_windowWidth,
                     options.m_shadow_light_level                    = 1.0 - m_parentWorld->getShadowIntensity();
                     options.m_storeObjectPositions                  = false;
                     options.m_markForUpdate                         = m_markForUpdate;
+                    options.m_primitiveBatch                        = NULL;
+                    options.m_textBatch                             = NULL;
 
                     // render 1st pass (opaque objects - shadowed regions)
                     m_parentWorld->renderSceneGraph(options);
@@ -1524,6 +1526,8 @@ void cCamera::renderView(const int a_windowWidth,
                     options.m_shadow_light_level                    = 1.0;
                     options.m_storeObjectPositions                  = true;
                     options.m_markForUpdate                         = m_markForUpdate;
+                    options.m_primitiveBatch                        = NULL;
+                    options.m_textBatch                             = NULL;
 
                     // render 1st pass (opaque objects - all faces)
                     if (m_parentWorld != NULL)
@@ -1575,6 +1579,8 @@ void cCamera::renderView(const int a_windowWidth,
                     options.m_shadow_light_level                    = 1.0 - m_parentWorld->getShadowIntensity();
                     options.m_storeObjectPositions                  = false;
                     options.m_markForUpdate                         = m_markForUpdate;
+                    options.m_primitiveBatch                        = NULL;
+                    options.m_textBatch                             = NULL;
 
                     // render 1st pass (opaque objects - all faces - shadowed regions)
                     m_parentWorld->renderSceneGraph(options);
@@ -1638,6 +1644,8 @@ void cCamera::renderView(const int a_windowWidth,
                     options.m_shadow_light_level                    = 1.0;
                     options.m_storeObjectPositions                  = true;
                     options.m_markForUpdate                         = m_markForUpdate;
+                    options.m_primitiveBatch                        = NULL;
+                    options.m_textBatch                             = NULL;
 
                     // render single pass (all objects)
                     if (m_parentWorld != NULL)
@@ -1837,6 +1845,8 @@ void cCamera::renderLayer(cGenericObject* a_graph,
     options.m_shadow_light_level                    = 1.0;
     options.m_storeObjectPositions                  = true;
     options.m_markForUpdate                         = false;
+    options.m_primitiveBatch                        = NULL;
+    options.m_textBatch                             = NULL;
 
     // render light source
     glColorMaterial(GL_FRONT_AND_BACK,GL_AMBIENT_AND_DIFFUSE);
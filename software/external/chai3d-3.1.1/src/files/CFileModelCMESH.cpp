@@ -0,0 +1,1009 @@
+//==============================================================================
+/*
+    Software License Agreement (BSD License)
+    Copyright (c) 2003-2016, CHAI3D.
+    (www.chai3d.org)
+
+    All rights reserved.
+
+    Redistribution and use in source and binary forms, with or without
+    modification, are permitted provided that the following conditions
+    are met:
+
+    * Redistributions of source code must retain the above copyright
+    notice, this list of conditions and the following disclaimer.
+
+    * Redistributions in binary form must reproduce the above
+    copyright notice, this list of conditions and the following
+    disclaimer in the documentation and/or other materials provided
+    with the distribution.
+
+    * Neither the name of CHAI3D nor the names of its contributors may
+    be used to endorse or promote products derived from this software
+    without specific prior written permission.
+
+    THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS
+    "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT
+    LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS
+    FOR A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE
+    COPYRIGHT OWNER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT,
+    INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING,
+    BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES;
+    LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER
+    CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT
+    LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN
+    ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE
+    POSSIBILITY OF SUCH DAMAGE. 
+
+    \author    <http://www.chai3d.org>
+    \version   3.1.1 $Rev: 1869 $
+*/
+//==============================================================================
+
+//------------------------------------------------------------------------------
+#include "files/CFileModelCMESH.h"
+#include "files/CFileModelOBJ.h"
+#include "collisions/CCollisionAABB.h"
+#include "collisions/CCollisionBVH.h"
+#include "materials/CTexture2d.h"
+#include "system/CMappedFile.h"
+#include "system/CString.h"
+//------------------------------------------------------------------------------
+#include "stdint.h"
+#include <stdio.h>
+#include <algorithm>
+#include <cstring>
+#include <vector>
+//------------------------------------------------------------------------------
+using namespace std;
+//------------------------------------------------------------------------------
+
+//------------------------------------------------------------------------------
+using namespace chai3d;
+namespace chai3d {
+//------------------------------------------------------------------------------
+
+//------------------------------------------------------------------------------
+#ifndef DOXYGEN_SHOULD_SKIP_THIS
+//------------------------------------------------------------------------------
+
+// file identifier, format version and byte order marker
+const char C_CMESH_MAGIC[8] = { 'C', 'H', 'A', 'I', 'M', 'E', 'S', 'H' };
+const uint32_t C_CMESH_VERSION = 2;
+const uint32_t C_CMESH_BYTE_ORDER = 0x01020304;
+
+// alignment of data blocks in bytes
+const uint64_t C_CMESH_ALIGNMENT = 64;
+
+// object flags
+const uint32_t C_CMESH_USE_MATERIAL       = 0x01;
+const uint32_t C_CMESH_USE_TEXTURE        = 0x02;
+const uint32_t C_CMESH_USE_VERTEX_COLORS  = 0x04;
+const uint32_t C_CMESH_USE_TRANSPARENCY   = 0x08;
+const uint32_t C_CMESH_USE_CULLING        = 0x10;
+const uint32_t C_CMESH_HAS_AABB           = 0x20;
+const uint32_t C_CMESH_HAS_BVH            = 0x40;
+
+// file header, at offset 0
+struct cHeaderCMESH
+{
+    char m_magic[8];
+    uint32_t m_version;
+    uint32_t m_byteOrder;
+    uint64_t m_sourceHash;
+    uint64_t m_fileSize;
+    uint64_t m_meshes;
+    uint32_t m_numMeshes;
+    uint32_t m_flags;
+    uint64_t m_dependencies;
+    uint32_t m_numDependencies;
+    uint32_t m_reserved;
+};
+
+// file the source model depends on (material library, texture image)
+struct cDependencyCMESH
+{
+    uint64_t m_filename;
+    uint64_t m_hash;
+};
+
+// mesh record. offsets of absent data are 0.
+struct cMeshCMESH
+{
+    uint64_t m_name;
+    uint64_t m_texture;
+    uint64_t m_localPos;
+    uint64_t m_normal;
+    uint64_t m_texCoord;
+    uint64_t m_color;
+    uint64_t m_tangent;
+    uint64_t m_bitangent;
+    uint64_t m_indices;
+    uint64_t m_allocated;
+    uint64_t m_nodes;
+    uint64_t m_elementIndices;
+    uint32_t m_numVertices;
+    uint32_t m_numTriangles;
+    uint32_t m_numNodes;
+    int32_t m_rootIndex;
+    double m_radius;
+    uint32_t m_flags;
+    uint32_t m_shininess;
+    float m_ambient[4];
+    float m_diffuse[4];
+    float m_specular[4];
+    float m_emission[4];
+};
+
+// AABB collision tree node. BVH nodes are stored in their native layout.
+struct cNodeCMESH
+{
+    double m_min[3];
+    double m_max[3];
+    int32_t m_depth;
+    int32_t m_nodeType;
+    int32_t m_leftSubTree;
+    int32_t m_rightSubTree;
+};
+
+// vertex data is copied as a whole, which requires cVector3d to hold exactly three doubles
+static_assert(sizeof(cVector3d) == 3 * sizeof(double), "unexpected layout of cVector3d");
+static_assert(sizeof(cHeaderCMESH) == 64, "unexpected layout of cHeaderCMESH");
+static_assert(sizeof(cDependencyCMESH) == 16, "unexpected layout of cDependencyCMESH");
+static_assert(sizeof(cMeshCMESH) == 192, "unexpected layout of cMeshCMESH");
+static_assert(sizeof(cNodeCMESH) == 64, "unexpected layout of cNodeCMESH");
+static_assert(sizeof(cCollisionBVHNode) == 32, "unexpected layout of cCollisionBVHNode");
+static_assert(sizeof(int) == sizeof(int32_t), "unexpected size of int");
+
+//------------------------------------------------------------------------------
+
+// Get the flags of an object.
+static uint32_t cGetFlagsCMESH(cGenericObject* a_object)
+{
+    uint32_t flags = 0;
+    if (a_object->getUseMaterial())       { flags |= C_CMESH_USE_MATERIAL; }
+    if (a_object->getUseTexture())        { flags |= C_CMESH_USE_TEXTURE; }
+    if (a_object->getUseVertexColors())   { flags |= C_CMESH_USE_VERTEX_COLORS; }
+    if (a_object->getUseTransparency())   { flags |= C_CMESH_USE_TRANSPARENCY; }
+    if (a_object->getUseCulling())        { flags |= C_CMESH_USE_CULLING; }
+    return (flags);
+}
+
+//------------------------------------------------------------------------------
+
+// Set the flags of an object, without affecting its children.
+static void cSetFlagsCMESH(cGenericObject* a_object, const uint32_t a_flags)
+{
+    a_object->setUseMaterial((a_flags & C_CMESH_USE_MATERIAL) != 0, false);
+    a_object->setUseTexture((a_flags & C_CMESH_USE_TEXTURE) != 0, false);
+    a_object->setUseVertexColors((a_flags & C_CMESH_USE_VERTEX_COLORS) != 0, false);
+    a_object->setUseTransparency((a_flags & C_CMESH_USE_TRANSPARENCY) != 0, false);
+    a_object->setUseCulling((a_flags & C_CMESH_USE_CULLING) != 0, false);
+}
+
+//------------------------------------------------------------------------------
+
+// Get the address of a block of data inside a file, or NULL if it does not fit.
+static const char* cGetBlockCMESH(const cMappedFile& a_file, const uint64_t a_offset, const uint64_t a_size)
+{
+    uint64_t size = (uint64_t)(a_file.getSize());
+    if ((a_offset == 0) || (a_offset % 8 != 0) || (a_offset > size) || (a_size > size - a_offset))
+    {
+        return (NULL);
+    }
+    return (a_file.getData() + a_offset);
+}
+
+//------------------------------------------------------------------------------
+
+// Get a null-terminated string inside a file, or NULL if it does not fit.
+static const char* cGetStringCMESH(const cMappedFile& a_file, const uint64_t a_offset)
+{
+    uint64_t size = (uint64_t)(a_file.getSize());
+    if ((a_offset == 0) || (a_offset >= size)) { return (NULL); }
+    const char* str = a_file.getData() + a_offset;
+    if (memchr(str, 0, (size_t)(size - a_offset)) == NULL) { return (NULL); }
+    return (str);
+}
+
+//------------------------------------------------------------------------------
+
+// Check that all data of a mesh record fits inside the file.
+static bool cCheckMeshCMESH(const cMappedFile& a_file, const cMeshCMESH& a_mesh)
+{
+    uint64_t numVertices = a_mesh.m_numVertices;
+    uint64_t numTriangles = a_mesh.m_numTriangles;
+    uint64_t vectorSize = numVertices * 3 * sizeof(double);
+
+    if ((a_mesh.m_name != 0) && (cGetStringCMESH(a_file, a_mesh.m_name) == NULL)) { return (false); }
+    if ((a_mesh.m_texture != 0) && (cGetStringCMESH(a_file, a_mesh.m_texture) == NULL)) { return (false); }
+    if ((numVertices > 0) && (cGetBlockCMESH(a_file, a_mesh.m_localPos, vectorSize) == NULL)) { return (false); }
+    if ((a_mesh.m_normal != 0) && (cGetBlockCMESH(a_file, a_mesh.m_normal, vectorSize) == NULL)) { return (false); }
+    if ((a_mesh.m_texCoord != 0) && (cGetBlockCMESH(a_file, a_mesh.m_texCoord, vectorSize) == NULL)) { return (false); }
+    if ((a_mesh.m_color != 0) && (cGetBlockCMESH(a_file, a_mesh.m_color, numVertices * 4 * sizeof(float)) == NULL)) { return (false); }
+    if ((a_mesh.m_tangent != 0) && (cGetBlockCMESH(a_file, a_mesh.m_tangent, vectorSize) == NULL)) { return (false); }
+    if ((a_mesh.m_bitangent != 0) && (cGetBlockCMESH(a_file, a_mesh.m_bitangent, vectorSize) == NULL)) { return (false); }
+    if ((a_mesh.m_allocated != 0) && (cGetBlockCMESH(a_file, a_mesh.m_allocated, numTriangles) == NULL)) { return (false); }
+
+    // collision tree
+    bool hasAABB = (a_mesh.m_flags & C_CMESH_HAS_AABB) != 0;
+    bool hasBVH = (a_mesh.m_flags & C_CMESH_HAS_BVH) != 0;
+    uint64_t nodeSize = hasBVH ? sizeof(cCollisionBVHNode) : sizeof(cNodeCMESH);
+    if (hasAABB && hasBVH) { return (false); }
+    if ((a_mesh.m_numNodes > 0) && (cGetBlockCMESH(a_file, a_mesh.m_nodes, a_mesh.m_numNodes * nodeSize) == NULL)) { return (false); }
+    if (hasBVH && (numTriangles > 0) && (cGetBlockCMESH(a_file, a_mesh.m_elementIndices, numTriangles * sizeof(int32_t)) == NULL)) { return (false); }
+
+    // all triangles must refer to existing vertices
+    if (numTriangles > 0)
+    {
+        const uint32_t* indices = (const uint32_t*)(cGetBlockCMESH(a_file, a_mesh.m_indices, numTriangles * 3 * sizeof(uint32_t)));
+        if (indices == NULL) { return (false); }
+        uint32_t maxIndex = 0;
+        for (uint64_t i=0; i<3*numTriangles; i++)
+        {
+            maxIndex = cMax(maxIndex, indices[i]);
+        }
+        if (maxIndex >= numVertices) { return (false); }
+    }
+
+    return (true);
+}
+
+//------------------------------------------------------------------------------
+
+// Sequential writer of aligned blocks of data.
+class cWriterCMESH
+{
+public:
+
+    cWriterCMESH(FILE* a_file) : m_file(a_file), m_offset(0), m_ok(true) {}
+
+    // write data at the current position
+    void write(const void* a_data, const size_t a_size)
+    {
+        if (m_ok && (a_size > 0))
+        {
+            m_ok = (fwrite(a_data, 1, a_size, m_file) == a_size);
+        }
+        m_offset += a_size;
+    }
+
+    // write a block of data at the next aligned position and return its offset
+    uint64_t writeBlock(const void* a_data, const size_t a_size)
+    {
+        static const char padding[C_CMESH_ALIGNMENT] = { 0 };
+        write(padding, (size_t)((C_CMESH_ALIGNMENT - m_offset % C_CMESH_ALIGNMENT) % C_CMESH_ALIGNMENT));
+        uint64_t offset = m_offset;
+        write(a_data, a_size);
+        return (offset);
+    }
+
+    // write a null-terminated string and return its offset
+    uint64_t writeString(const std::string& a_string)
+    {
+        uint64_t offset = m_offset;
+        write(a_string.c_str(), a_string.length() + 1);
+        return (offset);
+    }
+
+    FILE* m_file;
+    uint64_t m_offset;
+    bool m_ok;
+};
+
+//------------------------------------------------------------------------------
+
+// Write a mesh and set the offsets of its record.
+static void cWriteMeshCMESH(cWriterCMESH& a_writer, cMesh* a_mesh, cMeshCMESH& a_record)
+{
+    cVertexArrayPtr vertices = a_mesh->m_vertices;
+    cTriangleArrayPtr triangles = a_mesh->m_triangles;
+    unsigned int numVertices = vertices->getNumVertices();
+    unsigned int numTriangles = triangles->getNumElements();
+
+    memset(&a_record, 0, sizeof(a_record));
+    a_record.m_numVertices = numVertices;
+    a_record.m_numTriangles = numTriangles;
+    a_record.m_rootIndex = -1;
+    a_record.m_flags = cGetFlagsCMESH(a_mesh);
+
+    // material
+    cMaterialPtr material = a_mesh->m_material;
+    for (int i=0; i<4; i++)
+    {
+        a_record.m_ambient[i] = material->m_ambient[i];
+        a_record.m_diffuse[i] = material->m_diffuse[i];
+        a_record.m_specular[i] = material->m_specular[i];
+        a_record.m_emission[i] = material->m_emission[i];
+    }
+    a_record.m_shininess = material->getShininess();
+
+    // strings
+    if (a_mesh->m_name.length() > 0)
+    {
+        a_record.m_name = a_writer.writeString(a_mesh->m_name);
+    }
+    if ((a_mesh->m_texture != nullptr) && (a_mesh->m_texture->m_image != nullptr) && 
+        (a_mesh->m_texture->m_image->getFilename().length() > 0))
+    {
+        a_record.m_texture = a_writer.writeString(a_mesh->m_texture->m_image->getFilename());
+    }
+
+    // vertices
+    if (numVertices > 0)
+    {
+        size_t vectorSize = numVertices * sizeof(cVector3d);
+        a_record.m_localPos = a_writer.writeBlock(&vertices->m_localPos[0], vectorSize);
+        if (vertices->m_normal.size() == numVertices)
+        {
+            a_record.m_normal = a_writer.writeBlock(&vertices->m_normal[0], vectorSize);
+        }
+        if (vertices->m_texCoord.size() == numVertices)
+        {
+            a_record.m_texCoord = a_writer.writeBlock(&vertices->m_texCoord[0], vectorSize);
+        }
+        if (vertices->m_color.size() == numVertices)
+        {
+            vector<float> colors(4 * numVertices);
+            for (unsigned int i=0; i<numVertices; i++)
+            {
+                memcpy(&colors[4*i], vertices->m_color[i].getData(), 4 * sizeof(float));
+            }
+            a_record.m_color = a_writer.writeBlock(&colors[0], colors.size() * sizeof(float));
+        }
+        if (vertices->m_tangent.size() == numVertices)
+        {
+            a_record.m_tangent = a_writer.writeBlock(&vertices->m_tangent[0], vectorSize);
+        }
+        if (vertices->m_bitangent.size() == numVertices)
+        {
+            a_record.m_bitangent = a_writer.writeBlock(&vertices->m_bitangent[0], vectorSize);
+        }
+    }
+
+    // triangles
+    if (numTriangles > 0)
+    {
+        a_record.m_indices = a_writer.writeBlock(&triangles->m_indices[0], 3 * numTriangles * sizeof(unsigned int));
+
+        // removed triangles are rare; their flags are only stored if there are any
+        vector<unsigned char> allocated(numTriangles);
+        bool removed = false;
+        for (unsigned int i=0; i<numTriangles; i++)
+        {
+            allocated[i] = triangles->m_allocated[i] ? 1 : 0;
+            removed = removed || (!triangles->m_allocated[i]);
+        }
+        if (removed)
+        {
+            a_record.m_allocated = a_writer.writeBlock(&allocated[0], numTriangles);
+        }
+    }
+
+    // collision tree
+    cCollisionAABB* collision = dynamic_cast<cCollisionAABB*>(a_mesh->getCollisionDetector());
+    if (collision != NULL)
+    {
+        const vector<cCollisionAABBNode>& nodes = collision->getNodes();
+        a_record.m_flags |= C_CMESH_HAS_AABB;
+        a_record.m_numNodes = (uint32_t)(nodes.size());
+        a_record.m_rootIndex = collision->getRootIndex();
+        a_record.m_radius = collision->getRadius();
+        if (nodes.size() > 0)
+        {
+            vector<cNodeCMESH> records(nodes.size());
+            for (unsigned int i=0; i<nodes.size(); i++)
+            {
+                for (int j=0; j<3; j++)
+                {
+                    records[i].m_min[j] = nodes[i].m_bbox.m_min(j);
+                    records[i].m_max[j] = nodes[i].m_bbox.m_max(j);
+                }
+                records[i].m_depth = nodes[i].m_depth;
+                records[i].m_nodeType = nodes[i].m_nodeType;
+                records[i].m_leftSubTree = nodes[i].m_leftSubTree;
+                records[i].m_rightSubTree = nodes[i].m_rightSubTree;
+            }
+            a_record.m_nodes = a_writer.writeBlock(&records[0], records.size() * sizeof(cNodeCMESH));
+        }
+    }
+
+    // a BVH tree is only stored if it covers all triangles
+    cCollisionBVH* bvh = dynamic_cast<cCollisionBVH*>(a_mesh->getCollisionDetector());
+    if ((bvh != NULL) && (bvh->getElementIndices().size() == numTriangles))
+    {
+        const vector<cCollisionBVHNode>& nodes = bvh->getNodes();
+        const vector<int>& elementIndices = bvh->getElementIndices();
+        a_record.m_flags |= C_CMESH_HAS_BVH;
+        a_record.m_numNodes = (uint32_t)(nodes.size());
+        a_record.m_radius = bvh->getRadius();
+        if (nodes.size() > 0)
+        {
+            a_record.m_nodes = a_writer.writeBlock(&nodes[0], nodes.size() * sizeof(cCollisionBVHNode));
+        }
+        if (numTriangles > 0)
+        {
+            a_record.m_elementIndices = a_writer.writeBlock(&elementIndices[0], numTriangles * sizeof(int));
+        }
+    }
+}
+
+//------------------------------------------------------------------------------
+
+// Copy vectors stored in a file. The destination is accessed as plain doubles.
+static void cReadVectorsCMESH(vector<cVector3d>& a_vectors, const char* a_data, const unsigned int a_numVectors)
+{
+    memcpy((double*)(&a_vectors[0]), a_data, a_numVectors * 3 * sizeof(double));
+}
+
+//------------------------------------------------------------------------------
+
+// Create a mesh from a record.
+static void cReadMeshCMESH(const cMappedFile& a_file, const cMeshCMESH& a_record, cMesh* a_mesh)
+{
+    cVertexArrayPtr vertices = a_mesh->m_vertices;
+    cTriangleArrayPtr triangles = a_mesh->m_triangles;
+    unsigned int numVertices = a_record.m_numVertices;
+    unsigned int numTriangles = a_record.m_numTriangles;
+    const char* data = a_file.getData();
+
+    // name
+    if (a_record.m_name != 0)
+    {
+        a_mesh->m_name = string(data + a_record.m_name);
+    }
+
+    // vertices
+    if (numVertices > 0)
+    {
+        vertices->newVertices(numVertices);
+        cReadVectorsCMESH(vertices->m_localPos, data + a_record.m_localPos, numVertices);
+        vertices->m_flagPositionData = true;
+        if ((a_record.m_normal != 0) && (vertices->m_normal.size() == numVertices))
+        {
+            cReadVectorsCMESH(vertices->m_normal, data + a_record.m_normal, numVertices);
+            vertices->m_flagNormalData = true;
+        }
+        if ((a_record.m_texCoord != 0) && (vertices->m_texCoord.size() == numVertices))
+        {
+            cReadVectorsCMESH(vertices->m_texCoord, data + a_record.m_texCoord, numVertices);
+            vertices->m_flagTexCoordData = true;
+        }
+        if ((a_record.m_color != 0) && (vertices->m_color.size() == numVertices))
+        {
+            const float* colors = (const float*)(data + a_record.m_color);
+            for (unsigned int i=0; i<numVertices; i++)
+            {
+                vertices->m_color[i].set(colors[4*i], colors[4*i+1], colors[4*i+2], colors[4*i+3]);
+            }
+            vertices->m_flagColorData = true;
+        }
+        if ((a_record.m_tangent != 0) && (vertices->m_tangent.size() == numVertices))
+        {
+            cReadVectorsCMESH(vertices->m_tangent, data + a_record.m_tangent, numVertices);
+            vertices->m_flagTangentData = true;
+        }
+        if ((a_record.m_bitangent != 0) && (vertices->m_bitangent.size() == numVertices))
+        {
+            cReadVectorsCMESH(vertices->m_bitangent, data + a_record.m_bitangent, numVertices);
+            vertices->m_flagBitangentData = true;
+        }
+    }
+
+    // triangles
+    if (numTriangles > 0)
+    {
+        triangles->newTriangles(numTriangles);
+        memcpy(&triangles->m_indices[0], data + a_record.m_indices, 3 * numTriangles * sizeof(unsigned int));
+        if (a_record.m_allocated != 0)
+        {
+            const unsigned char* allocated = (const unsigned char*)(data + a_record.m_allocated);
+            for (unsigned int i=0; i<numTriangles; i++)
+            {
+                if (allocated[i] == 0)
+                {
+                    triangles->removeTriangle(i);
+                }
+            }
+        }
+    }
+
+    // material
+    cMaterialPtr material = a_mesh->m_material;
+    material->m_ambient.set(a_record.m_ambient[0], a_record.m_ambient[1], a_record.m_ambient[2], a_record.m_ambient[3]);
+    material->m_diffuse.set(a_record.m_diffuse[0], a_record.m_diffuse[1], a_record.m_diffuse[2], a_record.m_diffuse[3]);
+    material->m_specular.set(a_record.m_specular[0], a_record.m_specular[1], a_record.m_specular[2], a_record.m_specular[3]);
+    material->m_emission.set(a_record.m_emission[0], a_record.m_emission[1], a_record.m_emission[2], a_record.m_emission[3]);
+    material->setShininess(a_record.m_shininess);
+
+    // texture. the image is loaded from its original file.
+    uint32_t flags = a_record.m_flags;
+    if (a_record.m_texture != 0)
+    {
+        cTexture2dPtr texture = cTexture2d::create();
+        if (texture->loadFromFile(string(data + a_record.m_texture)))
+        {
+            a_mesh->setTexture(texture);
+        }
+    }
+    if (a_mesh->m_texture == nullptr)
+    {
+        flags &= ~C_CMESH_USE_TEXTURE;
+    }
+    cSetFlagsCMESH(a_mesh, flags);
+
+    // collision tree
+    if ((a_record.m_flags & C_CMESH_HAS_AABB) != 0)
+    {
+        const cNodeCMESH* records = (const cNodeCMESH*)(data + a_record.m_nodes);
+        vector<cCollisionAABBNode> nodes(a_record.m_numNodes);
+        for (unsigned int i=0; i<a_record.m_numNodes; i++)
+        {
+            nodes[i].m_bbox.setValue(cVector3d(records[i].m_min[0], records[i].m_min[1], records[i].m_min[2]),
+                                     cVector3d(records[i].m_max[0], records[i].m_max[1], records[i].m_max[2]));
+            nodes[i].m_depth = records[i].m_depth;
+            nodes[i].m_nodeType = (cAABBNodeType)(records[i].m_nodeType);
+            nodes[i].m_leftSubTree = records[i].m_leftSubTree;
+            nodes[i].m_rightSubTree = records[i].m_rightSubTree;
+        }
+
+        cCollisionAABB* collision = new cCollisionAABB();
+        collision->initialize(triangles, a_record.m_radius, nodes, a_record.m_rootIndex);
+        a_mesh->setCollisionDetector(collision);
+    }
+    else if ((a_record.m_flags & C_CMESH_HAS_BVH) != 0)
+    {
+        vector<cCollisionBVHNode> nodes(a_record.m_numNodes);
+        if (a_record.m_numNodes > 0)
+        {
+            memcpy(&nodes[0], data + a_record.m_nodes, a_record.m_numNodes * sizeof(cCollisionBVHNode));
+        }
+        vector<int> elementIndices(numTriangles);
+        if (numTriangles > 0)
+        {
+            memcpy(&elementIndices[0], data + a_record.m_elementIndices, numTriangles * sizeof(int));
+        }
+
+        cCollisionBVH* collision = new cCollisionBVH();
+        collision->initialize(triangles, a_record.m_radius, nodes, elementIndices);
+        a_mesh->setCollisionDetector(collision);
+    }
+
+    a_mesh->markForUpdate(false);
+}
+
+//------------------------------------------------------------------------------
+
+// Get the material libraries referred to by an OBJ file.
+static void cGetMaterialLibrariesCMESH(const string& a_filename, vector<string>& a_libraries)
+{
+    cMappedFile file;
+    if (!file.open(a_filename)) { return; }
+
+    const char* data = file.getData();
+    const char* end = data + file.getSize();
+    const size_t length = strlen(C_OBJ_MTL_LIB_ID);
+    string path = cGetDirectory(a_filename);
+
+    while (data < end)
+    {
+        // find end of line
+        const char* next = (const char*)(memchr(data, '\n', (size_t)(end - data)));
+        if (next == NULL) { next = end; }
+
+        // skip leading spaces
+        const char* str = data;
+        while ((str < next) && ((*str == ' ') || (*str == '\t'))) { str++; }
+
+        // material library definition, followed by its filename
+        if (((size_t)(next - str) > length) && (strncmp(str, C_OBJ_MTL_LIB_ID, length) == 0) &&
+            ((str[length] == ' ') || (str[length] == '\t')))
+        {
+            const char* first = str + length;
+            const char* last = next;
+            while ((first < last) && ((*first == ' ') || (*first == '\t'))) { first++; }
+            while ((last > first) && ((last[-1] == ' ') || (last[-1] == '\t') || (last[-1] == '\r'))) { last--; }
+            if (last > first)
+            {
+                a_libraries.push_back(path + string(first, last));
+            }
+        }
+
+        data = next + 1;
+    }
+}
+
+//------------------------------------------------------------------------------
+
+// Mix the bits of a hash value.
+static inline uint64_t cMixHashCMESH(uint64_t a_hash)
+{
+    a_hash ^= a_hash >> 33;
+    a_hash *= 0xff51afd7ed558ccdULL;
+    a_hash ^= a_hash >> 33;
+    a_hash *= 0xc4ceb9fe1a85ec53ULL;
+    a_hash ^= a_hash >> 33;
+    return (a_hash);
+}
+
+//------------------------------------------------------------------------------
+#endif  // DOXYGEN_SHOULD_SKIP_THIS
+//------------------------------------------------------------------------------
+
+
+//==============================================================================
+/*!
+    This function loads a CMESH model file into a cMultiMesh object. All
+    meshes of the object are replaced by the meshes stored in the file.\n\n
+
+    If a hash value of the source model is given, the file is only loaded
+    if it was saved with the same hash value, and if the files the source 
+    model depends on (see \ref cSaveFileCMESH()) still have the content 
+    they had when it was saved. The file is also rejected if
+    it is truncated, inconsistent, or was written by a different version or 
+    on a platform with a different byte order. In all these cases, the 
+    object is left unchanged.
+
+    \param  a_object      Multimesh object.
+    \param  a_filename    Filename.
+    \param  a_sourceHash  Expected hash value of the source model, or 0 to accept any.
+
+    \return __true__ in case of success, __false__ otherwise.
+*/
+//==============================================================================
+bool cLoadFileCMESH(cMultiMesh* a_object, const std::string& a_filename, const unsigned long long a_sourceHash)
+{
+    // sanity check
+    if (a_object == NULL) { return (C_ERROR); }
+
+    try
+    {
+        cMappedFile file;
+        if (!file.open(a_filename)) { return (C_ERROR); }
+
+        // check header
+        if (file.getSize() < sizeof(cHeaderCMESH)) { return (C_ERROR); }
+        const cHeaderCMESH* header = (const cHeaderCMESH*)(file.getData());
+        if ((memcmp(header->m_magic, C_CMESH_MAGIC, sizeof(C_CMESH_MAGIC)) != 0) ||
+            (header->m_version != C_CMESH_VERSION) ||
+            (header->m_byteOrder != C_CMESH_BYTE_ORDER) ||
+            (header->m_fileSize != (uint64_t)(file.getSize())) ||
+            ((a_sourceHash != 0) && (header->m_sourceHash != a_sourceHash)))
+        {
+            return (C_ERROR);
+        }
+
+        // check that the files the source model depends on are unchanged
+        if (a_sourceHash != 0)
+        {
+            int numDependencies = header->m_numDependencies;
+            const cDependencyCMESH* dependencies = (const cDependencyCMESH*)(cGetBlockCMESH(file, header->m_dependencies, (uint64_t)(numDependencies) * sizeof(cDependencyCMESH)));
+            if ((numDependencies > 0) && (dependencies == NULL)) { return (C_ERROR); }
+            for (int i=0; i<numDependencies; i++)
+            {
+                const char* filename = cGetStringCMESH(file, dependencies[i].m_filename);
+                if ((filename == NULL) || (cGetFileHash(filename) != dependencies[i].m_hash)) { return (C_ERROR); }
+            }
+        }
+
+        // check all meshes before modifying the object
+        int numMeshes = header->m_numMeshes;
+        const cMeshCMESH* meshes = (const cMeshCMESH*)(cGetBlockCMESH(file, header->m_meshes, (uint64_t)(numMeshes) * sizeof(cMeshCMESH)));
+        if ((numMeshes > 0) && (meshes == NULL)) { return (C_ERROR); }
+        for (int i=0; i<numMeshes; i++)
+        {
+            if (!cCheckMeshCMESH(file, meshes[i])) { return (C_ERROR); }
+        }
+
+        // create meshes
+        a_object->deleteAllMeshes();
+        for (int i=0; i<numMeshes; i++)
+        {
+            cReadMeshCMESH(file, meshes[i], a_object->newMesh());
+        }
+        cSetFlagsCMESH(a_object, header->m_flags);
+
+        // compute boundary boxes
+        a_object->computeBoundaryBox(true);
+
+        // update global position in world
+        a_object->computeGlobalPositionsFromRoot(true);
+
+        // return success
+        return (C_SUCCESS);
+    }
+
+    catch (...)
+    {
+        return (C_ERROR);
+    }
+}
+
+
+//==============================================================================
+/*!
+    This function saves the meshes of a cMultiMesh object to a CMESH model 
+    file, together with their AABB or BVH collision trees if they have any.
+    The file is first written under a temporary name and then renamed, so
+    that an incomplete file is never left under the given name.\n\n
+
+    The hash values of the texture images of the meshes and of the given
+    dependencies (e.g. material libraries) are stored with their filenames,
+    so that \ref cLoadFileCMESH() can reject the file once any of them 
+    changes.
+
+    \param  a_object        Multimesh object.
+    \param  a_filename      Filename.
+    \param  a_sourceHash    Hash value of the source model (see \ref cGetFileHash()).
+    \param  a_dependencies  Additional files the source model depends on.
+
+    \return __true__ in case of success, __false__ otherwise.
+*/
+//==============================================================================
+bool cSaveFileCMESH(cMultiMesh* a_object, 
+                    const std::string& a_filename, 
+                    const unsigned long long a_sourceHash,
+                    const std::vector<std::string>& a_dependencies)
+{
+    // sanity check
+    if (a_object == NULL) { return (C_ERROR); }
+
+    string tempFilename = a_filename + ".tmp";
+    FILE* file = fopen(tempFilename.c_str(), "wb");
+    if (file == NULL) { return (C_ERROR); }
+
+    bool result = C_ERROR;
+    try
+    {
+        int numMeshes = a_object->getNumMeshes();
+
+        cHeaderCMESH header;
+        memset(&header, 0, sizeof(header));
+        memcpy(header.m_magic, C_CMESH_MAGIC, sizeof(C_CMESH_MAGIC));
+        header.m_version = C_CMESH_VERSION;
+        header.m_byteOrder = C_CMESH_BYTE_ORDER;
+        header.m_sourceHash = a_sourceHash;
+        header.m_numMeshes = numMeshes;
+        header.m_flags = cGetFlagsCMESH(a_object);
+
+        // reserve space for header and mesh records, which are written last
+        vector<cMeshCMESH> meshes(numMeshes);
+        cWriterCMESH writer(file);
+        writer.write(&header, sizeof(header));
+        if (numMeshes > 0)
+        {
+            header.m_meshes = writer.writeBlock(&meshes[0], numMeshes * sizeof(cMeshCMESH));
+        }
+
+        // write data of meshes
+        vector<string> filenames = a_dependencies;
+        for (int i=0; i<numMeshes; i++)
+        {
+            cMesh* mesh = a_object->getMesh(i);
+            cWriteMeshCMESH(writer, mesh, meshes[i]);
+            if ((mesh->m_texture != nullptr) && (mesh->m_texture->m_image != nullptr) && 
+                (mesh->m_texture->m_image->getFilename().length() > 0))
+            {
+                filenames.push_back(mesh->m_texture->m_image->getFilename());
+            }
+        }
+
+        // write dependencies
+        sort(filenames.begin(), filenames.end());
+        filenames.erase(unique(filenames.begin(), filenames.end()), filenames.end());
+        int numDependencies = (int)(filenames.size());
+        vector<cDependencyCMESH> dependencies(numDependencies);
+        for (int i=0; i<numDependencies; i++)
+        {
+            dependencies[i].m_filename = writer.writeString(filenames[i]);
+            dependencies[i].m_hash = cGetFileHash(filenames[i]);
+        }
+        if (numDependencies > 0)
+        {
+            header.m_dependencies = writer.writeBlock(&dependencies[0], numDependencies * sizeof(cDependencyCMESH));
+            header.m_numDependencies = numDependencies;
+        }
+        header.m_fileSize = writer.m_offset;
+
+        // write header and mesh records
+        if (writer.m_ok && (fseek(file, 0, SEEK_SET) == 0))
+        {
+            writer.write(&header, sizeof(header));
+            if ((numMeshes > 0) && (fseek(file, (long)(header.m_meshes), SEEK_SET) == 0))
+            {
+                writer.write(&meshes[0], numMeshes * sizeof(cMeshCMESH));
+            }
+            result = writer.m_ok;
+        }
+    }
+
+    catch (...)
+    {
+        result = C_ERROR;
+    }
+
+    // replace previous file
+    result = (fclose(file) == 0) && result;
+    if (result)
+    {
+        remove(a_filename.c_str());
+        result = (rename(tempFilename.c_str(), a_filename.c_str()) == 0);
+    }
+    if (!result)
+    {
+        remove(tempFilename.c_str());
+    }
+
+    return (result);
+}
+
+
+//==============================================================================
+/*!
+    This function loads a model file (see \ref cMultiMesh::loadFromFile())
+    through a cache file, which is stored next to it with the additional
+    extension __.cmesh__.\n\n
+
+    If the cache file exists and was created from the current content of 
+    the model file, of its material libraries and of its texture images,
+    the meshes and collision trees are loaded from it directly. Otherwise, 
+    the model file is loaded, and the cache file is created or replaced. 
+    If the cache file cannot be written (e.g. because the directory is 
+    read-only), the model is still loaded. Textures are always loaded from
+    their image files.
+
+    \param  a_object                  Multimesh object.
+    \param  a_filename                Filename of the model.
+    \param  a_buildCollisionDetector  If __true__, then a collision tree is built (or loaded) for each mesh.
+    \param  a_collisionRadius         Bounding radius of the collision trees.
+    \param  a_useBVH                  If __true__, then BVH collision trees are used, otherwise AABB collision trees.
+
+    \return __true__ in case of success, __false__ otherwise.
+*/
+//==============================================================================
+bool cLoadFileCached(cMultiMesh* a_object, 
+                     const std::string& a_filename,
+                     const bool a_buildCollisionDetector,
+                     const double a_collisionRadius,
+                     const bool a_useBVH)
+{
+    // sanity check
+    if (a_object == NULL) { return (C_ERROR); }
+
+    // cache files are not cached themselves
+    if (cStrToLower(cGetFileExtension(a_filename)) == "cmesh")
+    {
+        return (cLoadFileCMESH(a_object, a_filename));
+    }
+
+    // loader options which change the resulting meshes are part of the hash value
+    string cacheFilename = a_filename + ".cmesh";
+    uint64_t hash = cGetFileHash(a_filename);
+    if (hash != 0)
+    {
+        hash ^= (g_objLoaderShouldGenerateExtraVertices ? 0x1 : 0x0) | (g_objLoaderShouldUseFastParser ? 0x2 : 0x0);
+        hash = cMax(cMixHashCMESH(hash), (uint64_t)(1));
+    }
+
+    // load cache file
+    bool updateCache = true;
+    if ((hash != 0) && cLoadFileCMESH(a_object, cacheFilename, hash))
+    {
+        updateCache = false;
+
+        // build collision trees which are missing or have a different radius
+        int numMeshes = a_object->getNumMeshes();
+        for (int i=0; i<numMeshes; i++)
+        {
+            cMesh* mesh = a_object->getMesh(i);
+            cCollisionAABB* aabb = dynamic_cast<cCollisionAABB*>(mesh->getCollisionDetector());
+            cCollisionBVH* bvh = dynamic_cast<cCollisionBVH*>(mesh->getCollisionDetector());
+            bool valid = a_useBVH ? ((bvh != NULL) && (bvh->getRadius() == a_collisionRadius)) :
+                                    ((aabb != NULL) && (aabb->getRadius() == a_collisionRadius));
+            if (!a_buildCollisionDetector)
+            {
+                mesh->deleteCollisionDetector();
+            }
+            else if (!valid)
+            {
+                if (a_useBVH)
+                {
+                    mesh->createBVHCollisionDetector(a_collisionRadius);
+                }
+                else
+                {
+                    mesh->createAABBCollisionDetector(a_collisionRadius);
+                }
+                updateCache = true;
+            }
+        }
+    }
+
+    // load model file
+    else
+    {
+        if (!a_object->loadFromFile(a_filename)) { return (C_ERROR); }
+        if (a_buildCollisionDetector && a_useBVH)
+        {
+            a_object->createBVHCollisionDetector(a_collisionRadius);
+        }
+        else if (a_buildCollisionDetector)
+        {
+            a_object->createAABBCollisionDetector(a_collisionRadius);
+        }
+    }
+
+    // create or update cache file. texture images are added by cSaveFileCMESH().
+    if (updateCache && (hash != 0))
+    {
+        vector<string> dependencies;
+        if (cStrToLower(cGetFileExtension(a_filename)) == "obj")
+        {
+            cGetMaterialLibrariesCMESH(a_filename, dependencies);
+        }
+        cSaveFileCMESH(a_object, cacheFilename, hash, dependencies);
+    }
+
+    return (C_SUCCESS);
+}
+
+
+//==============================================================================
+/*!
+    This function computes a 64-bit hash value of the content of a file.
+    The whole file is read through a memory mapping, 8 bytes at a time.
+
+    \param  a_filename  Filename.
+
+    \return Hash value of the file, or 0 if the file cannot be read.
+*/
+//==============================================================================
+unsigned long long cGetFileHash(const std::string& a_filename)
+{
+    cMappedFile file;
+    if (!file.open(a_filename)) { return (0); }
+
+    const unsigned char* data = (const unsigned char*)(file.getData());
+    size_t size = file.getSize();
+
+    // MurmurHash64A
+    const uint64_t m = 0xc6a4a7935bd1e995ULL;
+    const int r = 47;
+    uint64_t hash = 0x43484149ULL ^ ((uint64_t)(size) * m);
+
+    size_t numWords = size / 8;
+    for (size_t i=0; i<numWords; i++)
+    {
+        uint64_t k;
+        memcpy(&k, data + 8*i, 8);
+        k *= m;
+        k ^= k >> r;
+        k *= m;
+        hash ^= k;
+        hash *= m;
+    }
+
+    const unsigned char* tail = data + 8*numWords;
+    switch (size & 7)
+    {
+        case 7: hash ^= (uint64_t)(tail[6]) << 48;
+        case 6: hash ^= (uint64_t)(tail[5]) << 40;
+        case 5: hash ^= (uint64_t)(tail[4]) << 32;
+        case 4: hash ^= (uint64_t)(tail[3]) << 24;
+        case 3: hash ^= (uint64_t)(tail[2]) << 16;
+        case 2: hash ^= (uint64_t)(tail[1]) << 8;
+        case 1: hash ^= (uint64_t)(tail[0]);
+                hash *= m;
+    };
+
+    hash ^= hash >> r;
+    hash *= m;
+    hash ^= hash >> r;
+
+    // 0 is reserved for unreadable files
+    return ((hash != 0) ? hash : 1);
+}
+
+//------------------------------------------------------------------------------
+} // namespace chai3d
+//------------------------------------------------------------------------------
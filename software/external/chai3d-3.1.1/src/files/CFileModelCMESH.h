@@ -0,0 +1,108 @@
+//==============================================================================
+/*
+    Software License Agreement (BSD License)
+    Copyright (c) 2003-2016, CHAI3D.
+    (www.chai3d.org)
+
+    All rights reserved.
+
+    Redistribution and use in source and binary forms, with or without
+    modification, are permitted provided that the following conditions
+    are met:
+
+    * Redistributions of source code must retain the above copyright
+    notice, this list of conditions and the following disclaimer.
+
+    * Redistributions in binary form must reproduce the above
+    copyright notice, this list of conditions and the following
+    disclaimer in the documentation and/or other materials provided
+    with the distribution.
+
+    * Neither the name of CHAI3D nor the names of its contributors may
+    be used to endorse or promote products derived from this software
+    without specific prior written permission.
+
+    THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS
+    "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT
+    LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS
+    FOR A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE
+    COPYRIGHT OWNER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT,
+    INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING,
+    BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES;
+    LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER
+    CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT
+    LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN
+    ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE
+    POSSIBILITY OF SUCH DAMAGE. 
+
+    \author    <http://www.chai3d.org>
+    \version   3.1.1 $Rev: 1869 $
+*/
+//==============================================================================
+
+//------------------------------------------------------------------------------
+#ifndef CFileModelCMESHH
+#define CFileModelCMESHH
+//------------------------------------------------------------------------------
+#include "world/CMultiMesh.h"
+//------------------------------------------------------------------------------
+namespace chai3d {
+//------------------------------------------------------------------------------
+
+//==============================================================================
+/*!
+    \file       CFileModelCMESH.h
+    \ingroup    files
+
+    \brief
+    Implements CMESH binary model cache file support.
+
+    \details
+    A CMESH file stores the meshes of a cMultiMesh in the native binary 
+    layout of \ref cVertexArray and \ref cTriangleArray, together with
+    their materials, texture filenames and AABB or BVH collision trees, and 
+    the hash values of the files the source model depends on. Each array
+    is stored as a single aligned block, so that loading a model only copies
+    memory-mapped data, without any parsing, normal computation or tree 
+    construction.\n\n
+
+    CMESH files are meant to be used as a cache of models stored in other 
+    formats (see \ref cLoadFileCached()). They are written with the native
+    byte order and are not intended for exchange between platforms.
+*/
+//==============================================================================
+
+//------------------------------------------------------------------------------
+/*!
+    \addtogroup files
+*/
+//------------------------------------------------------------------------------
+
+//@{
+
+//! This function loads a CMESH model file.
+bool cLoadFileCMESH(cMultiMesh* a_object, const std::string& a_filename, const unsigned long long a_sourceHash = 0);
+
+//! This function saves a CMESH model file.
+bool cSaveFileCMESH(cMultiMesh* a_object, 
+                    const std::string& a_filename, 
+                    const unsigned long long a_sourceHash = 0,
+                    const std::vector<std::string>& a_dependencies = std::vector<std::string>());
+
+//! This function loads a model file through a CMESH cache file, which is created or updated when needed.
+bool cLoadFileCached(cMultiMesh* a_object, 
+                     const std::string& a_filename,
+                     const bool a_buildCollisionDetector = false,
+                     const double a_collisionRadius = 0.0,
+                     const bool a_useBVH = false);
+
+//! This function returns a hash value of the content of a file.
+unsigned long long cGetFileHash(const std::string& a_filename);
+
+//@}
+
+//------------------------------------------------------------------------------
+} // namespace chai3d
+//------------------------------------------------------------------------------
+#endif
+//------------------------------------------------------------------------------
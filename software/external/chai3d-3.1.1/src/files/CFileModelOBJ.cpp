@@ -44,6 +44,7 @@
 
 //------------------------------------------------------------------------------
 #include "files/CFileModelOBJ.h"
+#include "system/CMappedFile.h"
 //------------------------------------------------------------------------------
 #include <iostream>
 #include <iomanip>
@@ -52,6 +53,8 @@
 #include <algorithm>
 #include <string>
 #include <cstring>
+#include <functional>
+#include <thread>
 //------------------------------------------------------------------------------
 using namespace std;
 //------------------------------------------------------------------------------
@@ -63,6 +66,7 @@ namespace chai3d {
 
 //------------------------------------------------------------------------------
 bool g_objLoaderShouldGenerateExtraVertices = false;
+bool g_objLoaderShouldUseFastParser = true;
 //------------------------------------------------------------------------------
 
 //==============================================================================
@@ -80,6 +84,12 @@ bool g_objLoaderShouldGenerateExtraVertices = false;
 //==============================================================================
 bool cLoadFileOBJ(cMultiMesh* a_object, const std::string& a_filename)
 {
+    // use memory-mapped, parallel parser
+    if (g_objLoaderShouldUseFastParser)
+    {
+        return (cLoadFileOBJFast(a_object, a_filename));
+    }
+
     try
     {
         cOBJModel fileObj;
@@ -93,105 +103,8 @@ bool cLoadFileOBJ(cMultiMesh* a_object, const std::string& a_filename)
         // get information about file
         int numMaterials = fileObj.m_OBJInfo.m_materialCount;
 
-        // extract materials
-        vector<cMaterial> materials;
-
-        // object has no material properties
-        if (numMaterials == 0)
-        {
-            // create a new child
-            cMesh *newMesh = a_object->newMesh();
-            newMesh->setUseMaterial(true);
-            newMesh->setUseTransparency(false);
-        }
-
-        // object has material properties. Create a child for each material
-        // property.
-        else
-        {
-            int i = 0;
-            bool found_transparent_material = false;
-
-            while (i < numMaterials)
-            {
-                // create a new child
-                cMesh *newMesh = a_object->newMesh();
-
-                // use materials
-                newMesh->setUseMaterial(true);
-
-                // get next material
-                cMaterialInfo material = fileObj.m_pMaterials[i];
-
-                int textureId = material.m_textureID;
-                if (textureId >= 1)
-                {
-                    cTexture2dPtr newTexture = cTexture2d::create();
-                    bool result = newTexture->loadFromFile(material.m_texture);
-
-                    // If this didn't work out, try again in the obj file's path
-                    if (result == false) 
-                    {
-                        string model_dir = cGetDirectory(a_filename);
-
-                        char new_texture_path[1024];
-                        sprintf(new_texture_path,"%s/%s",model_dir.c_str(),material.m_texture);
-
-                        result = newTexture->loadFromFile(new_texture_path);
-                    }
-
-                    if (result)
-                    {
-                        newMesh->setTexture(newTexture);
-                        newMesh->setUseTexture(true);
-                    }
-                }
-
-                float alpha = material.m_alpha;
-                if (alpha < 1.0) 
-                {
-                    newMesh->setUseTransparency(true, false);
-                    found_transparent_material = true;
-                }
-
-                // get ambient component:
-                newMesh->m_material->m_ambient.setR(material.m_ambient[0]);
-                newMesh->m_material->m_ambient.setG(material.m_ambient[1]);
-                newMesh->m_material->m_ambient.setB(material.m_ambient[2]);
-                newMesh->m_material->m_ambient.setA(alpha);
-
-                // get diffuse component:
-                newMesh->m_material->m_diffuse.setR(material.m_diffuse[0]);
-                newMesh->m_material->m_diffuse.setG(material.m_diffuse[1]);
-                newMesh->m_material->m_diffuse.setB(material.m_diffuse[2]);
-                newMesh->m_material->m_diffuse.setA(alpha);
-
-                // get specular component:
-                newMesh->m_material->m_specular.setR(material.m_specular[0]);
-                newMesh->m_material->m_specular.setG(material.m_specular[1]);
-                newMesh->m_material->m_specular.setB(material.m_specular[2]);
-                newMesh->m_material->m_specular.setA(alpha);
-
-                // get emissive component:
-                newMesh->m_material->m_emission.setR(material.m_emmissive[0]);
-                newMesh->m_material->m_emission.setG(material.m_emmissive[1]);
-                newMesh->m_material->m_emission.setB(material.m_emmissive[2]);
-                newMesh->m_material->m_emission.setA(alpha);
-
-                // get shininess
-                newMesh->m_material->setShininess((GLuint)(1.28 * material.m_shininess));
-
-                i++;
-            }
-
-            // Enable material property rendering
-            a_object->setUseVertexColors(false, true);
-            a_object->setUseMaterial(true, true);
-
-            // Mark the presence of transparency in the root mesh; don't
-            // modify the value stored in children...
-            a_object->setUseTransparency(found_transparent_material, false);
-        }
+        // create a child mesh for each material
+        cCreateMeshesOBJ(a_object, fileObj.m_pMaterials, numMaterials, a_filename);
 
         // Keep track of vertex mapping in each mesh; maps "old" vertices
         // to new vertices
@@ -1235,36 +1148,49 @@ void cOBJModel::getFileInfo(FILE *a_hStream, cOBJFileInfo *a_info, const char a_
             // append .mtl
             //strcat(szBasePath, ".mtl");
 
-            // open the library file
-            FILE *hMaterialLib = fopen(basePath, "r");
+            // count materials of the library
+            a_info->m_materialCount += countMaterials(basePath);
+        }
 
-            // success?
-            if (hMaterialLib)
+       // clear string two avoid counting something twice
+       memset(str, '\0', sizeof(str));
+    }
+}
+
+//------------------------------------------------------------------------------
+
+unsigned int cOBJModel::countMaterials(const char a_fileName[])
+{
+    char str[C_OBJ_MAX_STR_SIZE];    // Buffer for reading the file
+    unsigned int count = 0;
+
+    // open the library file
+    FILE *hMaterialLib = fopen(a_fileName, "r");
+
+    // success?
+    if (hMaterialLib)
+    {
+        // quit reading when end of file has been reached
+        while (!feof(hMaterialLib))
+        {
+            // read next string
+            if (fscanf(hMaterialLib, "%1023s" ,str) > 0)
             {
-                // quit reading when end of file has been reached
-                while (!feof(hMaterialLib))
-                {
-                    // read next string
-                    if (fscanf(hMaterialLib, "%1024s" ,str) > 0)
-                    {
 
-                        // is it a "new material" identifier ?
-                        if (!strncmp(str, C_OBJ_NEW_MTL_ID, sizeof(C_OBJ_NEW_MTL_ID)))
-                        {
-                            // one more material defined
-                            a_info->m_materialCount++;
-                        }
-                    }
+                // is it a "new material" identifier ?
+                if (!strncmp(str, C_OBJ_NEW_MTL_ID, sizeof(C_OBJ_NEW_MTL_ID)))
+                {
+                    // one more material defined
+                    count++;
                 }
-
-                // close material library
-                fclose(hMaterialLib);
             }
         }
 
-       // clear string two avoid counting something twice
-       memset(str, '\0', sizeof(str));
+        // close material library
+        fclose(hMaterialLib);
     }
+
+    return (count);
 }
 
 //------------------------------------------------------------------------------
@@ -1384,6 +1310,819 @@ unsigned int getVertexIndex(cMesh* a_mesh, cOBJModel* a_model,
     }
 }
 
+//------------------------------------------------------------------------------
+
+void cCreateMeshesOBJ(cMultiMesh* a_object,
+                      const cMaterialInfo* a_materials,
+                      const int a_numMaterials,
+                      const std::string& a_filename)
+{
+    // object has no material properties
+    if (a_numMaterials == 0)
+    {
+        // create a new child
+        cMesh *newMesh = a_object->newMesh();
+        newMesh->setUseMaterial(true);
+        newMesh->setUseTransparency(false);
+    }
+
+    // object has material properties. Create a child for each material
+    // property.
+    else
+    {
+        int i = 0;
+        bool found_transparent_material = false;
+
+        while (i < a_numMaterials)
+        {
+            // create a new child
+            cMesh *newMesh = a_object->newMesh();
+
+            // use materials
+            newMesh->setUseMaterial(true);
+
+            // get next material
+            const cMaterialInfo& material = a_materials[i];
+
+            int textureId = material.m_textureID;
+            if (textureId >= 1)
+            {
+                cTexture2dPtr newTexture = cTexture2d::create();
+                bool result = newTexture->loadFromFile(material.m_texture);
+
+                // If this didn't work out, try again in the obj file's path
+                if (result == false) 
+                {
+                    string model_dir = cGetDirectory(a_filename);
+
+                    char new_texture_path[1024];
+                    sprintf(new_texture_path,"%s/%s",model_dir.c_str(),material.m_texture);
+
+                    result = newTexture->loadFromFile(new_texture_path);
+                }
+
+                if (result)
+                {
+                    newMesh->setTexture(newTexture);
+                    newMesh->setUseTexture(true);
+                }
+            }
+
+            float alpha = material.m_alpha;
+            if (alpha < 1.0) 
+            {
+                newMesh->setUseTransparency(true, false);
+                found_transparent_material = true;
+            }
+
+            // get ambient component:
+            newMesh->m_material->m_ambient.setR(material.m_ambient[0]);
+            newMesh->m_material->m_ambient.setG(material.m_ambient[1]);
+            newMesh->m_material->m_ambient.setB(material.m_ambient[2]);
+            newMesh->m_material->m_ambient.setA(alpha);
+
+            // get diffuse component:
+            newMesh->m_material->m_diffuse.setR(material.m_diffuse[0]);
+            newMesh->m_material->m_diffuse.setG(material.m_diffuse[1]);
+            newMesh->m_material->m_diffuse.setB(material.m_diffuse[2]);
+            newMesh->m_material->m_diffuse.setA(alpha);
+
+            // get specular component:
+            newMesh->m_material->m_specular.setR(material.m_specular[0]);
+            newMesh->m_material->m_specular.setG(material.m_specular[1]);
+            newMesh->m_material->m_specular.setB(material.m_specular[2]);
+            newMesh->m_material->m_specular.setA(alpha);
+
+            // get emissive component:
+            newMesh->m_material->m_emission.setR(material.m_emmissive[0]);
+            newMesh->m_material->m_emission.setG(material.m_emmissive[1]);
+            newMesh->m_material->m_emission.setB(material.m_emmissive[2]);
+            newMesh->m_material->m_emission.setA(alpha);
+
+            // get shininess
+            newMesh->m_material->setShininess((GLuint)(1.28 * material.m_shininess));
+
+            i++;
+        }
+
+        // Enable material property rendering
+        a_object->setUseVertexColors(false, true);
+        a_object->setUseMaterial(true, true);
+
+        // Mark the presence of transparency in the root mesh; don't
+        // modify the value stored in children...
+        a_object->setUseTransparency(found_transparent_material, false);
+    }
+}
+
+
+//==============================================================================
+// OBJ FAST PARSER IMPLEMENTATION:
+//==============================================================================
+
+//------------------------------------------------------------------------------
+
+bool cOBJModel::LoadMaterials(const char a_fileName[], const std::vector<std::string>& a_materialLibs)
+{
+    char basePath[C_OBJ_SIZE_PATH];     // path were all paths in the OBJ start
+
+    // get base path
+    strncpy(basePath, a_fileName, C_OBJ_SIZE_PATH - 1);
+    basePath[C_OBJ_SIZE_PATH - 1] = '\0';
+    makePath(basePath);
+
+    // count materials of all libraries
+    memset(&m_OBJInfo, 0, sizeof(cOBJFileInfo));
+    for (unsigned int i=0; i<a_materialLibs.size(); i++)
+    {
+        string libraryFile = basePath + a_materialLibs[i];
+        m_OBJInfo.m_materialCount += countMaterials(libraryFile.c_str());
+    }
+
+    // allocate and load materials
+    if (m_pMaterials) { delete [] m_pMaterials; m_pMaterials = NULL; }
+    if (m_OBJInfo.m_materialCount == 0) { return (true); }
+    m_pMaterials = new cMaterialInfo[m_OBJInfo.m_materialCount];
+
+    unsigned int curMaterial = 0;
+    for (unsigned int i=0; i<a_materialLibs.size(); i++)
+    {
+        string libraryFile = basePath + a_materialLibs[i];
+        loadMaterialLib(libraryFile.c_str(), m_pMaterials, &curMaterial, basePath);
+    }
+
+    return (true);
+}
+
+//------------------------------------------------------------------------------
+
+// Run a task for indices 0 to a_count-1 on all cores.
+static void cRunParallelOBJ(const int a_count, const std::function<void(int)>& a_task)
+{
+    int numThreads = cMin(a_count, cMax(1, (int)(thread::hardware_concurrency())));
+    if (numThreads <= 1)
+    {
+        for (int i=0; i<a_count; i++) { a_task(i); }
+        return;
+    }
+
+    vector<thread> workers;
+    for (int t=0; t<numThreads; t++)
+    {
+        workers.push_back(thread([&a_task, a_count, numThreads, t]()
+        {
+            for (int i=t; i<a_count; i+=numThreads) { a_task(i); }
+        }));
+    }
+    for (int t=0; t<numThreads; t++)
+    {
+        workers[t].join();
+    }
+}
+
+//------------------------------------------------------------------------------
+
+static inline const char* cSkipSpacesOBJ(const char* a_str, const char* a_end)
+{
+    while ((a_str < a_end) && ((*a_str == ' ') || (*a_str == '\t'))) { a_str++; }
+    return (a_str);
+}
+
+//------------------------------------------------------------------------------
+
+// Parse a floating point number; returns a_str if no number was found.
+static const char* cParseFloatOBJ(const char* a_str, const char* a_end, float& a_value)
+{
+    static const double pow10[] = { 1e0,  1e1,  1e2,  1e3,  1e4,  1e5,  1e6,  1e7,
+                                    1e8,  1e9,  1e10, 1e11, 1e12, 1e13, 1e14, 1e15,
+                                    1e16, 1e17, 1e18, 1e19, 1e20, 1e21, 1e22 };
+
+    const char* p = a_str;
+    bool negative = false;
+    if ((p < a_end) && ((*p == '-') || (*p == '+')))
+    {
+        negative = (*p == '-');
+        p++;
+    }
+
+    // mantissa (first 18 significant digits) and decimal exponent
+    unsigned long long mantissa = 0;
+    int numDigits = 0;
+    int exponent = 0;
+    bool found = false;
+    while ((p < a_end) && (*p >= '0') && (*p <= '9'))
+    {
+        if (numDigits < 18) { mantissa = 10 * mantissa + (*p - '0'); if (mantissa > 0) { numDigits++; } }
+        else { exponent++; }
+        found = true;
+        p++;
+    }
+    if ((p < a_end) && (*p == '.'))
+    {
+        p++;
+        while ((p < a_end) && (*p >= '0') && (*p <= '9'))
+        {
+            if (numDigits < 18) { mantissa = 10 * mantissa + (*p - '0'); if (mantissa > 0) { numDigits++; } exponent--; }
+            found = true;
+            p++;
+        }
+    }
+
+    // not a plain number (e.g. "nan", "inf"): use standard library
+    if (!found)
+    {
+        char str[64];
+        int length = 0;
+        while ((a_str + length < a_end) && (length < 63) && (a_str[length] > ' ')) { str[length] = a_str[length]; length++; }
+        str[length] = '\0';
+        char* last;
+        double value = strtod(str, &last);
+        if (last == str) { return (a_str); }
+        a_value = (float)(value);
+        return (a_str + (last - str));
+    }
+
+    if ((p < a_end) && ((*p == 'e') || (*p == 'E')))
+    {
+        const char* q = p + 1;
+        bool negativeExponent = false;
+        if ((q < a_end) && ((*q == '-') || (*q == '+')))
+        {
+            negativeExponent = (*q == '-');
+            q++;
+        }
+        if ((q < a_end) && (*q >= '0') && (*q <= '9'))
+        {
+            int value = 0;
+            while ((q < a_end) && (*q >= '0') && (*q <= '9'))
+            {
+                if (value < 10000) { value = 10 * value + (*q - '0'); }
+                q++;
+            }
+            exponent += negativeExponent ? -value : value;
+            p = q;
+        }
+    }
+
+    double value = (double)(mantissa);
+    if ((exponent >= 0) && (exponent <= 22))
+    {
+        value *= pow10[exponent];
+    }
+    else if ((exponent < 0) && (exponent >= -22))
+    {
+        value /= pow10[-exponent];
+    }
+    else
+    {
+        value *= pow(10.0, exponent);
+    }
+    a_value = (float)(negative ? -value : value);
+    return (p);
+}
+
+//------------------------------------------------------------------------------
+
+// Parse an integer; returns a_str if no integer was found.
+static inline const char* cParseIntOBJ(const char* a_str, const char* a_end, int& a_value)
+{
+    const char* p = a_str;
+    bool negative = false;
+    if ((p < a_end) && ((*p == '-') || (*p == '+')))
+    {
+        negative = (*p == '-');
+        p++;
+    }
+    if ((p >= a_end) || (*p < '0') || (*p > '9')) { return (a_str); }
+
+    int value = 0;
+    while ((p < a_end) && (*p >= '0') && (*p <= '9'))
+    {
+        value = 10 * value + (*p - '0');
+        p++;
+    }
+    a_value = negative ? -value : value;
+    return (p);
+}
+
+//------------------------------------------------------------------------------
+
+// Parse up to a_maxCount floats; returns the number of floats found.
+static inline int cParseFloatsOBJ(const char* a_str, const char* a_end, float* a_values, const int a_maxCount)
+{
+    int count = 0;
+    while (count < a_maxCount)
+    {
+        a_str = cSkipSpacesOBJ(a_str, a_end);
+        const char* next = cParseFloatOBJ(a_str, a_end, a_values[count]);
+        if (next == a_str) { break; }
+        a_str = next;
+        count++;
+    }
+    return (count);
+}
+
+//------------------------------------------------------------------------------
+
+// Return the parameter of a token without surrounding spaces.
+static inline std::string cGetParameterOBJ(const char* a_str, const char* a_end)
+{
+    a_str = cSkipSpacesOBJ(a_str, a_end);
+    while ((a_end > a_str) && ((a_end[-1] == ' ') || (a_end[-1] == '\t'))) { a_end--; }
+    return (string(a_str, a_end - a_str));
+}
+
+//------------------------------------------------------------------------------
+
+// Parse all lines of a chunk.
+static void cParseChunkOBJ(cOBJChunk* a_chunk)
+{
+    // reserve memory, assuming about 32 characters per line
+    size_t numLines = (a_chunk->m_end - a_chunk->m_begin) / 32;
+    a_chunk->m_vertices.reserve(numLines);
+    a_chunk->m_faceVertices.reserve(2 * numLines);
+
+    const char* p = a_chunk->m_begin;
+    while (p < a_chunk->m_end)
+    {
+        // find end of line
+        const char* end = (const char*)(memchr(p, '\n', a_chunk->m_end - p));
+        if (end == NULL) { end = a_chunk->m_end; }
+        const char* next = end + 1;
+        if ((end > p) && (end[-1] == '\r')) { end--; }
+
+        // find token
+        p = cSkipSpacesOBJ(p, end);
+        const char* token = p;
+        while ((p < end) && (*p != ' ') && (*p != '\t')) { p++; }
+        size_t length = p - token;
+
+        // vertex
+        if ((length == 1) && (token[0] == 'v'))
+        {
+            float values[6] = { 0.0f, 0.0f, 0.0f, 0.0f, 0.0f, 0.0f };
+            int count = cParseFloatsOBJ(p, end, values, 6);
+            a_chunk->m_vertices.insert(a_chunk->m_vertices.end(), values, values + 3);
+            a_chunk->m_colors.insert(a_chunk->m_colors.end(), values + 3, values + 6);
+            a_chunk->m_colorFlags.push_back(count >= 6);
+        }
+
+        // texture coordinate
+        else if ((length == 2) && (token[0] == 'v') && (token[1] == 't'))
+        {
+            float values[3] = { 0.0f, 0.0f, 0.0f };
+            cParseFloatsOBJ(p, end, values, 3);
+            a_chunk->m_texCoords.insert(a_chunk->m_texCoords.end(), values, values + 3);
+        }
+
+        // vertex normal
+        else if ((length == 2) && (token[0] == 'v') && (token[1] == 'n'))
+        {
+            float values[3] = { 0.0f, 0.0f, 0.0f };
+            cParseFloatsOBJ(p, end, values, 3);
+            a_chunk->m_normals.insert(a_chunk->m_normals.end(), values, values + 3);
+        }
+
+        // face: vertices given as i, i/j, i//k or i/j/k
+        else if ((length == 1) && (token[0] == 'f'))
+        {
+            a_chunk->m_faceStarts.push_back((int)(a_chunk->m_faceVertices.size() / 3));
+            const int counts[3] = { (int)(a_chunk->m_vertices.size() / 3),
+                                    (int)(a_chunk->m_texCoords.size() / 3),
+                                    (int)(a_chunk->m_normals.size() / 3) };
+            while (true)
+            {
+                p = cSkipSpacesOBJ(p, end);
+                int indices[3] = { 0, 0, 0 };
+                const char* q = cParseIntOBJ(p, end, indices[0]);
+                if (q == p) { break; }
+                if ((q < end) && (*q == '/'))
+                {
+                    q = cParseIntOBJ(q + 1, end, indices[1]);
+                    if ((q < end) && (*q == '/'))
+                    {
+                        q = cParseIntOBJ(q + 1, end, indices[2]);
+                    }
+                }
+                while ((q < end) && (*q != ' ') && (*q != '\t')) { q++; }
+                p = q;
+
+                // relative indices are stored relative to the start of the chunk
+                for (int i=0; i<3; i++)
+                {
+                    if (indices[i] < 0)
+                    {
+                        indices[i] = counts[i] + indices[i] + 1;
+                        a_chunk->m_relativeIndices.push_back((int)(a_chunk->m_faceVertices.size()) + i);
+                    }
+                }
+                a_chunk->m_faceVertices.insert(a_chunk->m_faceVertices.end(), indices, indices + 3);
+            }
+        }
+
+        // group name
+        else if ((length == 1) && (token[0] == 'g'))
+        {
+            a_chunk->m_groupNames.push_back(make_pair((int)(a_chunk->m_faceStarts.size()), cGetParameterOBJ(p, end)));
+        }
+
+        // material name
+        else if ((length == 6) && (!strncmp(token, C_OBJ_USE_MTL_ID, 6)))
+        {
+            a_chunk->m_materialNames.push_back(make_pair((int)(a_chunk->m_faceStarts.size()), cGetParameterOBJ(p, end)));
+        }
+
+        // material library
+        else if ((length == 6) && (!strncmp(token, C_OBJ_MTL_LIB_ID, 6)))
+        {
+            a_chunk->m_materialLibs.push_back(cGetParameterOBJ(p, end));
+        }
+
+        p = next;
+    }
+}
+
+//------------------------------------------------------------------------------
+
+// Build the vertices and triangles of a mesh from its faces, in bulk.
+static void cBuildMeshOBJ(cMesh* a_mesh, 
+                          const cOBJChunk& a_data, 
+                          const std::vector<int>& a_faces, 
+                          std::vector<int>& a_vertexMap)
+{
+    const int* faceVertices = a_data.m_faceVertices.data();
+
+    // count triangles and face vertices
+    int numTriangles = 0;
+    int numFaceVertices = 0;
+    for (unsigned int i=0; i<a_faces.size(); i++)
+    {
+        int numVertices = a_data.m_faceStarts[a_faces[i] + 1] - a_data.m_faceStarts[a_faces[i]];
+        if (numVertices >= 3)
+        {
+            numTriangles += numVertices - 2;
+            numFaceVertices += numVertices;
+        }
+    }
+    if (numTriangles == 0) { return; }
+
+    // face vertex of each triangle vertex (faces are split into fans)
+    vector<int> triangleVertices(3 * numTriangles);
+    int* triangle = triangleVertices.data();
+    for (unsigned int i=0; i<a_faces.size(); i++)
+    {
+        int first = a_data.m_faceStarts[a_faces[i]];
+        int last = a_data.m_faceStarts[a_faces[i] + 1] - 1;
+        for (int j=first+2; j<=last; j++)
+        {
+            triangle[0] = first;
+            triangle[1] = j - 1;
+            triangle[2] = j;
+            triangle += 3;
+        }
+    }
+
+    // assign a mesh vertex to each triangle vertex
+    vector<int> sources;        // face vertex of each mesh vertex
+    vector<int> meshVertices;   // mesh vertex of each triangle vertex
+    if (g_objLoaderShouldGenerateExtraVertices)
+    {
+        // three distinct vertices per triangle
+        sources = triangleVertices;
+        meshVertices.resize(3 * numTriangles);
+        for (int i=0; i<3*numTriangles; i++) { meshVertices[i] = i; }
+    }
+    else
+    {
+        // share vertices with the same vertex, normal and texture coordinate 
+        // indices; vertices are numbered in order of first use
+        vector<int> nextSource;
+        sources.reserve(numFaceVertices);
+        nextSource.reserve(numFaceVertices);
+        meshVertices.resize(3 * numTriangles);
+        for (int i=0; i<3*numTriangles; i++)
+        {
+            int faceVertex = triangleVertices[i];
+            const int* indices = &faceVertices[3 * faceVertex];
+            int vertex = a_vertexMap[indices[0]];
+            while ((vertex >= 0) &&
+                   ((faceVertices[3 * sources[vertex] + 1] != indices[1]) ||
+                    (faceVertices[3 * sources[vertex] + 2] != indices[2])))
+            {
+                vertex = nextSource[vertex];
+            }
+            if (vertex < 0)
+            {
+                vertex = (int)(sources.size());
+                sources.push_back(faceVertex);
+                nextSource.push_back(a_vertexMap[indices[0]]);
+                a_vertexMap[indices[0]] = vertex;
+            }
+            meshVertices[i] = vertex;
+        }
+
+        // reset vertex map for next mesh
+        for (unsigned int i=0; i<sources.size(); i++)
+        {
+            a_vertexMap[faceVertices[3 * sources[i]]] = -1;
+        }
+    }
+
+    // create vertices
+    int numVertices = (int)(sources.size());
+    cVertexArrayPtr vertices = a_mesh->m_vertices;
+    int firstVertex = vertices->newVertices(numVertices);
+    for (int i=0; i<numVertices; i++)
+    {
+        const int* indices = &faceVertices[3 * sources[i]];
+        const float* pos = &a_data.m_vertices[3 * indices[0]];
+        vertices->setLocalPos(firstVertex + i, pos[0], pos[1], pos[2]);
+        if (indices[1] >= 0)
+        {
+            const float* texCoord = &a_data.m_texCoords[3 * indices[1]];
+            vertices->setTexCoord(firstVertex + i, texCoord[0], texCoord[1], texCoord[2]);
+        }
+    }
+
+    // create triangles, and set vertex normals to the normal of the last 
+    // triangle using them, unless normals are defined by the file
+    cTriangleArrayPtr triangles = a_mesh->m_triangles;
+    int firstTriangle = triangles->newTriangles(numTriangles);
+    for (int i=0; i<numTriangles; i++)
+    {
+        const int* vertex = &meshVertices[3 * i];
+        triangles->setVertices(firstTriangle + i, firstVertex + vertex[0], firstVertex + vertex[1], firstVertex + vertex[2]);
+        triangles->computeNormal(firstTriangle + i, true);
+        for (int j=0; j<3; j++)
+        {
+            int normalIndex = faceVertices[3 * triangleVertices[3 * i + j] + 2];
+            if (normalIndex >= 0)
+            {
+                const float* normal = &a_data.m_normals[3 * normalIndex];
+                cVector3d n(normal[0], normal[1], normal[2]);
+                n.normalize();
+                vertices->setNormal(firstVertex + vertex[j], n);
+            }
+        }
+    }
+}
+
+//------------------------------------------------------------------------------
+
+bool cLoadFileOBJFast(cMultiMesh* a_object, const std::string& a_filename)
+{
+    try
+    {
+        /////////////////////////////////////////////////////////////////////
+        // PARSE FILE IN PARALLEL
+        /////////////////////////////////////////////////////////////////////
+
+        cMappedFile file;
+        if (!file.open(a_filename)) { return (C_ERROR); }
+
+        // split file into chunks of whole lines, one per core
+        int numChunks = (int)(cMin(cMax((size_t)(1), file.getSize() / C_OBJ_MIN_CHUNK_SIZE), (size_t)(cMax(1, (int)(thread::hardware_concurrency())))));
+        vector<cOBJChunk> chunks(numChunks);
+        const char* data = file.getData();
+        const char* dataEnd = file.getData() + file.getSize();
+        for (int i=0; i<numChunks; i++)
+        {
+            const char* begin = data + (file.getSize() * i) / numChunks;
+            if (i > 0)
+            {
+                const char* end = (const char*)(memchr(begin, '\n', dataEnd - begin));
+                begin = (end == NULL) ? dataEnd : end + 1;
+            }
+            chunks[i].m_begin = begin;
+            if (i > 0) { chunks[i-1].m_end = begin; }
+        }
+        if (numChunks > 0) { chunks[numChunks-1].m_end = dataEnd; }
+
+        cRunParallelOBJ(numChunks, [&chunks](int a_index) { cParseChunkOBJ(&chunks[a_index]); });
+        file.close();
+
+
+        /////////////////////////////////////////////////////////////////////
+        // MERGE CHUNKS
+        /////////////////////////////////////////////////////////////////////
+
+        // offsets of chunk data in merged data
+        vector<int> vertexOffsets(numChunks + 1, 0);
+        vector<int> texCoordOffsets(numChunks + 1, 0);
+        vector<int> normalOffsets(numChunks + 1, 0);
+        vector<int> faceOffsets(numChunks + 1, 0);
+        vector<int> faceVertexOffsets(numChunks + 1, 0);
+        for (int i=0; i<numChunks; i++)
+        {
+            vertexOffsets[i+1] = vertexOffsets[i] + (int)(chunks[i].m_vertices.size() / 3);
+            texCoordOffsets[i+1] = texCoordOffsets[i] + (int)(chunks[i].m_texCoords.size() / 3);
+            normalOffsets[i+1] = normalOffsets[i] + (int)(chunks[i].m_normals.size() / 3);
+            faceOffsets[i+1] = faceOffsets[i] + (int)(chunks[i].m_faceStarts.size());
+            faceVertexOffsets[i+1] = faceVertexOffsets[i] + (int)(chunks[i].m_faceVertices.size() / 3);
+        }
+        int numVertices = vertexOffsets[numChunks];
+        int numFaces = faceOffsets[numChunks];
+
+        cOBJChunk model;
+        model.m_vertices.resize(3 * numVertices);
+        model.m_colors.resize(3 * numVertices);
+        model.m_colorFlags.resize(numVertices);
+        model.m_texCoords.resize(3 * texCoordOffsets[numChunks]);
+        model.m_normals.resize(3 * normalOffsets[numChunks]);
+        model.m_faceStarts.resize(numFaces + 1);
+        model.m_faceVertices.resize(3 * faceVertexOffsets[numChunks]);
+        model.m_faceStarts[numFaces] = faceVertexOffsets[numChunks];
+
+        // copy chunk data, converting indices to zero-based indices in merged data
+        vector<char> valid(numChunks, true);
+        cRunParallelOBJ(numChunks, [&](int a_index)
+        {
+            cOBJChunk& chunk = chunks[a_index];
+            copy(chunk.m_vertices.begin(), chunk.m_vertices.end(), model.m_vertices.begin() + 3 * vertexOffsets[a_index]);
+            copy(chunk.m_colors.begin(), chunk.m_colors.end(), model.m_colors.begin() + 3 * vertexOffsets[a_index]);
+            copy(chunk.m_colorFlags.begin(), chunk.m_colorFlags.end(), model.m_colorFlags.begin() + vertexOffsets[a_index]);
+            copy(chunk.m_texCoords.begin(), chunk.m_texCoords.end(), model.m_texCoords.begin() + 3 * texCoordOffsets[a_index]);
+            copy(chunk.m_normals.begin(), chunk.m_normals.end(), model.m_normals.begin() + 3 * normalOffsets[a_index]);
+            for (unsigned int i=0; i<chunk.m_faceStarts.size(); i++)
+            {
+                model.m_faceStarts[faceOffsets[a_index] + i] = faceVertexOffsets[a_index] + chunk.m_faceStarts[i];
+            }
+
+            const int offsets[3] = { vertexOffsets[a_index], texCoordOffsets[a_index], normalOffsets[a_index] };
+            const int counts[3] = { numVertices, texCoordOffsets[numChunks], normalOffsets[numChunks] };
+            for (unsigned int i=0; i<chunk.m_relativeIndices.size(); i++)
+            {
+                int position = chunk.m_relativeIndices[i];
+                chunk.m_faceVertices[position] += offsets[position % 3];
+            }
+            int* faceVertices = &model.m_faceVertices[3 * faceVertexOffsets[a_index]];
+            for (unsigned int i=0; i<chunk.m_faceVertices.size(); i++)
+            {
+                int attribute = i % 3;
+                int index = chunk.m_faceVertices[i] - 1;
+                if ((index < 0) && (attribute > 0))
+                {
+                    index = -1;
+                }
+                else if ((index < 0) || (index >= counts[attribute]))
+                {
+                    valid[a_index] = false;
+                    index = 0;
+                }
+                faceVertices[i] = index;
+            }
+
+            // release chunk data
+            vector<float>().swap(chunk.m_vertices);
+            vector<float>().swap(chunk.m_colors);
+            vector<float>().swap(chunk.m_texCoords);
+            vector<float>().swap(chunk.m_normals);
+            vector<int>().swap(chunk.m_faceVertices);
+        });
+
+        for (int i=0; i<numChunks; i++)
+        {
+            if (!valid[i]) { return (C_ERROR); }
+        }
+
+
+        /////////////////////////////////////////////////////////////////////
+        // MATERIALS AND GROUPS
+        /////////////////////////////////////////////////////////////////////
+
+        // load material libraries
+        vector<string> materialLibs;
+        for (int i=0; i<numChunks; i++)
+        {
+            materialLibs.insert(materialLibs.end(), chunks[i].m_materialLibs.begin(), chunks[i].m_materialLibs.end());
+        }
+        cOBJModel materials;
+        materials.LoadMaterials(a_filename.c_str(), materialLibs);
+        int numMaterials = materials.m_OBJInfo.m_materialCount;
+
+        // assign material and group to each face
+        vector<int> faceMaterials(numFaces, 0);
+        vector<int> faceGroups(numFaces, -1);
+        vector<string> groupNames;
+        int material = 0;
+        int group = -1;
+        for (int i=0; i<numChunks; i++)
+        {
+            const cOBJChunk& chunk = chunks[i];
+            unsigned int nextMaterial = 0;
+            unsigned int nextGroup = 0;
+            int numChunkFaces = faceOffsets[i+1] - faceOffsets[i];
+            for (int j=0; j<=numChunkFaces; j++)
+            {
+                while ((nextMaterial < chunk.m_materialNames.size()) && (chunk.m_materialNames[nextMaterial].first == j))
+                {
+                    for (int k=0; k<numMaterials; k++)
+                    {
+                        if (chunk.m_materialNames[nextMaterial].second == materials.m_pMaterials[k].m_name)
+                        {
+                            material = k;
+                            break;
+                        }
+                    }
+                    nextMaterial++;
+                }
+                while ((nextGroup < chunk.m_groupNames.size()) && (chunk.m_groupNames[nextGroup].first == j))
+                {
+                    groupNames.push_back(chunk.m_groupNames[nextGroup].second);
+                    group = (int)(groupNames.size()) - 1;
+                    nextGroup++;
+                }
+                if (j < numChunkFaces)
+                {
+                    faceMaterials[faceOffsets[i] + j] = material;
+                    faceGroups[faceOffsets[i] + j] = group;
+                }
+            }
+        }
+        chunks.clear();
+
+
+        /////////////////////////////////////////////////////////////////////
+        // BUILD OBJECT
+        /////////////////////////////////////////////////////////////////////
+
+        // clear all vertices and triangle of current mesh
+        a_object->deleteAllMeshes();
+
+        // create a child mesh for each material
+        cCreateMeshesOBJ(a_object, materials.m_pMaterials, numMaterials, a_filename);
+        int numMeshes = a_object->getNumMeshes();
+
+        // model without faces: copy vertex and color data
+        if (numFaces == 0)
+        {
+            cMesh* mesh = a_object->getMesh(0);
+            if (numVertices > 0)
+            {
+                cVertexArrayPtr vertices = mesh->m_vertices;
+                int firstVertex = vertices->newVertices(numVertices);
+                for (int i=0; i<numVertices; i++)
+                {
+                    const float* pos = &model.m_vertices[3 * i];
+                    const float* color = &model.m_colors[3 * i];
+                    vertices->setLocalPos(firstVertex + i, pos[0], pos[1], pos[2]);
+                    cColorf vertexColor(color[0], color[1], color[2]);
+                    vertexColor.m_flag_color = (model.m_colorFlags[i] != 0);
+                    vertices->setColor(firstVertex + i, vertexColor);
+                }
+                mesh->setUseVertexColors(model.m_colorFlags[numVertices - 1] != 0);
+            }
+        }
+
+        // model with faces: build meshes in parallel
+        else
+        {
+            // faces of each mesh, in file order
+            vector<vector<int> > meshFaces(numMeshes);
+            for (int i=0; i<numFaces; i++)
+            {
+                int index = cClamp(faceMaterials[i], 0, numMeshes - 1);
+                meshFaces[index].push_back(i);
+
+                // name mesh after the group of its last face
+                if (faceGroups[i] >= 0)
+                {
+                    a_object->getMesh(index)->m_name = groupNames[faceGroups[i]];
+                }
+            }
+
+            int numThreads = cMin(numMeshes, cMax(1, (int)(thread::hardware_concurrency())));
+            vector<vector<int> > vertexMaps(numThreads);
+            cRunParallelOBJ(numThreads, [&](int a_thread)
+            {
+                vertexMaps[a_thread].resize(numVertices, -1);
+                for (int i=a_thread; i<numMeshes; i+=numThreads)
+                {
+                    cBuildMeshOBJ(a_object->getMesh(i), model, meshFaces[i], vertexMaps[a_thread]);
+                }
+            });
+
+            for (int i=0; i<numMeshes; i++)
+            {
+                a_object->getMesh(i)->markForUpdate(false);
+            }
+        }
+
+        // compute boundary boxes
+        a_object->computeBoundaryBox(true);
+
+        // update global position in world
+        a_object->computeGlobalPositionsFromRoot(true);
+
+        // return success
+        return (C_SUCCESS);
+    }
+
+    catch (...)
+    {
+        return (C_ERROR);
+    }
+}
 
 //------------------------------------------------------------------------------
 #endif  // DOXYGEN_SHOULD_SKIP_THIS
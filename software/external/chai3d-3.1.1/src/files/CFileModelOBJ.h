@@ -49,6 +49,8 @@
 #include "world/CMultiMesh.h"
 //------------------------------------------------------------------------------
 #include <map>
+#include <string>
+#include <vector>
 //------------------------------------------------------------------------------
 
 //------------------------------------------------------------------------------
@@ -93,6 +95,16 @@ bool cSaveFileOBJ(cMultiMesh* a_object, const std::string& a_filename);
 extern bool g_objLoaderShouldGenerateExtraVertices;
 
 
+//------------------------------------------------------------------------------
+/*!
+    Clients can use this to select the OBJ file parser. \n
+    If __true__ (default), OBJ files are memory-mapped and parsed in parallel
+    on all cores. If __false__, the original single-threaded parser is used.
+*/
+//------------------------------------------------------------------------------
+extern bool g_objLoaderShouldUseFastParser;
+
+
 //------------------------------------------------------------------------------
 #ifndef DOXYGEN_SHOULD_SKIP_THIS
 //------------------------------------------------------------------------------
@@ -180,6 +192,9 @@ typedef std::map<vertexIndexSet,unsigned int,ltVertexIndexSet> vertexIndexSet_ui
 // Maximum number of vertices a that a single face can have
 #define C_OBJ_MAX_VERTICES 256
 
+// Minimum size of a part of an OBJ file parsed by one thread [bytes]
+#define C_OBJ_MIN_CHUNK_SIZE 262144
+
 // Image File information.
 struct cOBJFileInfo
 {
@@ -235,6 +250,30 @@ struct cMaterialInfo
 };
 
 
+// Data parsed from a range of lines of an OBJ file (fast parser).
+// Indices of face vertices are stored as in the file (one-based, zero if 
+// absent) until chunks are merged, then as zero-based indices (-1 if absent).
+struct cOBJChunk
+{
+    const char* m_begin;
+    const char* m_end;
+
+    std::vector<float> m_vertices;      // x, y, z of each vertex
+    std::vector<float> m_colors;        // r, g, b of each vertex
+    std::vector<char>  m_colorFlags;    // true if color of vertex is defined
+    std::vector<float> m_normals;       // x, y, z of each normal
+    std::vector<float> m_texCoords;     // u, v, w of each texture coordinate
+
+    std::vector<int> m_faceStarts;      // first face vertex of each face
+    std::vector<int> m_faceVertices;    // vertex, texture coordinate and normal index of each face vertex
+    std::vector<int> m_relativeIndices; // positions in m_faceVertices of negative (relative) indices
+
+    std::vector<std::pair<int, std::string> > m_materialNames;  // first face and name of each 'usemtl'
+    std::vector<std::pair<int, std::string> > m_groupNames;     // first face and name of each 'g'
+    std::vector<std::string> m_materialLibs;                    // filename of each 'mtllib'
+};
+
+
 //==============================================================================
 /*!
     \class      cOBJModel
@@ -265,6 +304,9 @@ class cOBJModel
     //! Load model file.
     bool LoadModel(const char szFileName[]);
 
+    //! Load material files [mtl] referenced by a model file.
+    bool LoadMaterials(const char a_fileName[], const std::vector<std::string>& a_materialLibs);
+
 
     //--------------------------------------------------------------------------
     // MEMBERS:
@@ -320,6 +362,9 @@ class cOBJModel
     
     //! Read information about file.
     void  getFileInfo(FILE *a_hStream, cOBJFileInfo *a_stat, const char a_constBasePath[]);    
+
+    //! Count materials defined in material file [mtl].
+    unsigned int countMaterials(const char a_fileName[]);
 };
 
 //! Internal: get a (possibly new) vertex index for a vertex.
@@ -328,6 +373,15 @@ unsigned int getVertexIndex(cMesh* a_Mesh,
                             vertexIndexSet_uint_map* a_VertexMap, 
                             vertexIndexSet& vis);
 
+//! Internal: create one mesh per material of an OBJ model.
+void cCreateMeshesOBJ(cMultiMesh* a_object,
+                      const cMaterialInfo* a_materials,
+                      const int a_numMaterials,
+                      const std::string& a_filename);
+
+//! Internal: load an OBJ model file with the memory-mapped, parallel parser.
+bool cLoadFileOBJFast(cMultiMesh* a_object, const std::string& a_filename);
+
 //------------------------------------------------------------------------------
 #endif  // DOXYGEN_SHOULD_SKIP_THIS
 //------------------------------------------------------------------------------
@@ -112,6 +112,8 @@ cAlgorithmFingerProxy::cAlgorithmFingerProxy()
 
     // initialize algorithm variables
     m_algoCounter = 0;
+    m_queryReady = false;
+    m_queryHit = false;
 
     // render settings (for debug purposes)
     m_showEnabled = true;
@@ -213,6 +215,7 @@ cVector3d cAlgorithmFingerProxy::computeForces(const cVector3d& a_toolPos,
     {
         // compute next best position of proxy
         computeNextBestProxyPosition(m_deviceGlobalPos);
+        m_queryReady = false;
 
         // update proxy to next best position
         m_proxyGlobalPos = m_nextBestProxyGlobalPos;
@@ -232,6 +235,79 @@ cVector3d cAlgorithmFingerProxy::computeForces(const cVector3d& a_toolPos,
 }
 
 
+//==============================================================================
+/*!
+    This method returns the first collision query which the next call to 
+    \ref computeForces() will perform, so that the queries of several proxies
+    (e.g. the haptic points of a tool) can be computed together by
+    \ref cWorld::computeCollisionDetectionBatch(). This is only possible for
+    the first constraint of a static proxy, as every other query depends on 
+    the result of the previous one. \n\n
+
+    The caller computes the collisions between the segment and the world 
+    with \ref m_collisionSettings, reports them in the returned (cleared) 
+    recorder, and passes the result to \ref setCollisionQueryResult() before
+    calling \ref computeForces() with the same tool position.
+
+    \param  a_toolPos         Next position of tool.
+    \param  a_segmentPointA   Returned start point of segment.
+    \param  a_segmentPointB   Returned end point of segment.
+    \param  a_recorder        Returned recorder in which collisions are reported.
+
+    \return __true__ if a query can be computed ahead, __false__ otherwise.
+*/
+//==============================================================================
+bool cAlgorithmFingerProxy::getCollisionQuery(const cVector3d& a_toolPos,
+                                              cVector3d& a_segmentPointA,
+                                              cVector3d& a_segmentPointB,
+                                              cCollisionRecorder*& a_recorder)
+{
+    m_queryReady = false;
+
+    // only the first query of a static proxy is independent of other queries
+    if ((m_world == NULL) || (m_useDynamicProxy) || (m_algoCounter != 0)) { return (false); }
+
+    // no query is performed if the proxy has reached the goal
+    if (goalAchieved(m_proxyGlobalPos, a_toolPos)) { return (false); }
+
+    // epsilon value, as set by computeNextProxyPositionWithContraints0()
+    double epsilon = m_epsilon;
+    if (m_numCollisionEvents == 0)
+    {
+        epsilon = cMax(fabs(0.0001 * m_radius), m_epsilonBaseValue);
+    }
+
+    // segment from proxy to goal, tested with the proxy radius
+    m_collisionSettings.m_collisionRadius = m_radius;
+    cVector3d vProxyToGoalNormalized;
+    m_querySegmentPointA = m_proxyGlobalPos;
+    m_querySegmentPointB = computeCollisionTarget(a_toolPos, epsilon, vProxyToGoalNormalized);
+
+    a_segmentPointA = m_querySegmentPointA;
+    a_segmentPointB = m_querySegmentPointB;
+    m_collisionRecorderConstraint0.clear();
+    a_recorder = &m_collisionRecorderConstraint0;
+
+    return (true);
+}
+
+
+//==============================================================================
+/*!
+    This method sets the result of the collision query returned by 
+    \ref getCollisionQuery(). It is used by the next call to 
+    \ref computeForces() instead of querying the world again.
+
+    \param  a_hit  __true__ if a collision was reported for the segment.
+*/
+//==============================================================================
+void cAlgorithmFingerProxy::setCollisionQueryResult(const bool a_hit)
+{
+    m_queryReady = true;
+    m_queryHit = a_hit;
+}
+
+
 //==============================================================================
 /*!
     Given the new position of the device and considering the current
@@ -406,6 +482,29 @@ void cAlgorithmFingerProxy::adjustDynamicProxy(const cVector3d& a_goal)
 
 //------------------------------------------------------------------------------
 
+cVector3d cAlgorithmFingerProxy::computeCollisionTarget(const cVector3d& a_goalGlobalPos,
+                                                        const double a_epsilon,
+                                                        cVector3d& a_vProxyToGoalNormalized) const
+{
+    // compute the normalized form of the vector going from the
+    // current proxy position to the desired goal position
+    if (cDistance(m_proxyGlobalPos, a_goalGlobalPos) > a_epsilon)
+    {
+        cVector3d vProxyToGoal;
+        a_goalGlobalPos.subr(m_proxyGlobalPos, vProxyToGoal);
+        vProxyToGoal.normalizer(a_vProxyToGoalNormalized);
+    }
+    else
+    {
+        a_vProxyToGoalNormalized.zero();
+    }
+
+    // the segment ends at the goal position plus a little extra
+    return (a_goalGlobalPos + cMul(m_epsilonCollisionDetection, a_vProxyToGoalNormalized));
+}
+
+//------------------------------------------------------------------------------
+
 bool cAlgorithmFingerProxy::computeNextProxyPositionWithContraints0(const cVector3d& a_goalGlobalPos)
 {
     // we define the goal position of the proxy.
@@ -437,43 +536,36 @@ bool cAlgorithmFingerProxy::computeNextProxyPositionWithContraints0(const cVecto
         return (false);
     }
 
-    // compute the normalized form of the vector going from the
-    // current proxy position to the desired goal position
-
     // compute the distance between the proxy and the goal positions
     double distanceProxyGoal = cDistance(m_proxyGlobalPos, goalGlobalPos);
 
-    // a vector from the proxy to the goal
-    cVector3d vProxyToGoal;
-    cVector3d vProxyToGoalNormalized;
-
-    if (distanceProxyGoal > m_epsilon)
-    {
-        goalGlobalPos.subr(m_proxyGlobalPos, vProxyToGoal);
-        vProxyToGoal.normalizer(vProxyToGoalNormalized);
-    }
-    else
-    {
-        vProxyToGoal.zero();
-        vProxyToGoalNormalized.zero();
-    }
-
     // test whether the path from the proxy to the goal is obstructed;
     // for this we create a segment that goes from the proxy position to
     // the goal position plus a little extra to take into account the
     // physical radius of the proxy.
-    cVector3d targetPos =  goalGlobalPos + cMul(m_epsilonCollisionDetection, vProxyToGoalNormalized);
+    cVector3d vProxyToGoalNormalized;
+    cVector3d targetPos = computeCollisionTarget(goalGlobalPos, m_epsilon, vProxyToGoalNormalized);
 
     // setup collision detector
     m_collisionSettings.m_collisionRadius = m_radius;
 
     // search for a collision between the first segment (proxy-device)
-    // and the environment.
-    m_collisionRecorderConstraint0.clear();
-    bool hit = m_world->computeCollisionDetection(m_proxyGlobalPos,
-                                                  targetPos,
-                                                  m_collisionRecorderConstraint0,
-                                                  m_collisionSettings);
+    // and the environment, unless it was already computed together with 
+    // the queries of other proxies (see getCollisionQuery())
+    bool hit;
+    if (m_queryReady && m_querySegmentPointA.equals(m_proxyGlobalPos) && m_querySegmentPointB.equals(targetPos))
+    {
+        hit = m_queryHit;
+    }
+    else
+    {
+        m_collisionRecorderConstraint0.clear();
+        hit = m_world->computeCollisionDetection(m_proxyGlobalPos,
+                                                 targetPos,
+                                                 m_collisionRecorderConstraint0,
+                                                 m_collisionSettings);
+    }
+    m_queryReady = false;
 
     // check if collision occurred between proxy and goal positions.
     double collisionDistance;
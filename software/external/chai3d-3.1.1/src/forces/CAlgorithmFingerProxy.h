@@ -111,6 +111,12 @@ public:
     //! This method calculates the interaction forces.
     virtual cVector3d computeForces(const cVector3d& a_toolPos, const cVector3d& a_toolVel);
 
+    //! This method returns the first collision query of the next call to \ref computeForces(), if it can be computed ahead.
+    bool getCollisionQuery(const cVector3d& a_toolPos, cVector3d& a_segmentPointA, cVector3d& a_segmentPointB, cCollisionRecorder*& a_recorder);
+
+    //! This method sets the result of the collision query returned by \ref getCollisionQuery().
+    void setCollisionQueryResult(const bool a_hit);
+
 
     //----------------------------------------------------------------------
     // METHODS - GETTER AND SETTER FUNCTIONS:
@@ -308,6 +314,18 @@ protected:
     //! Value of state machine.
     unsigned int m_algoCounter;
 
+    //! If __true__, then the first collision query was computed ahead (see \ref getCollisionQuery()).
+    bool m_queryReady;
+
+    //! Result of the collision query computed ahead.
+    bool m_queryHit;
+
+    //! Start point of the collision query computed ahead.
+    cVector3d m_querySegmentPointA;
+
+    //! End point of the collision query computed ahead.
+    cVector3d m_querySegmentPointB;
+
 
     //----------------------------------------------------------------------
     // PROTECTED METHODS - PROXY ALGORITHM
@@ -318,6 +336,9 @@ protected:
     //! This method ajust the position of __proxy__ by taking into account motion of objects in the world.
     void adjustDynamicProxy(const cVector3d& a_goal);
 
+    //! This method computes the end point of the segment from the __proxy__ towards a goal, which is tested for collisions by \ref computeNextProxyPositionWithContraints0().
+    cVector3d computeCollisionTarget(const cVector3d& a_goalGlobalPos, const double a_epsilon, cVector3d& a_vProxyToGoalNormalized) const;
+
     //! This method updates the position of the __proxy__ - constraint 0.
     bool computeNextProxyPositionWithContraints0(const cVector3d& a_goalGlobalPos);
 
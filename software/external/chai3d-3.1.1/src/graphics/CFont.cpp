@@ -269,41 +269,51 @@ double cFont::renderText(const string& a_text,
                          const double a_fontScale,
                          cRenderOptions& a_options)
 {
-#ifdef C_USE_OPENGL
-    // sanity check
-    if (m_texture == nullptr)
-    {
-        return (0);
-    }
+    // layout characters
+    vector<float> vertices;
+    double cursorX = createTextVertices(a_text, a_fontScale, vertices);
 
-    // initialization
-    double cursorX = 0;
-    int length = (int)(a_text.length());
-    if (length == 0) { return(0.0); }
+    // render all character quads
+    renderTextVertices(vertices, a_color, a_options);
 
-    // render texture
-    glEnable(GL_BLEND);
-    glBlendFunc (GL_SRC_ALPHA, GL_ONE_MINUS_SRC_ALPHA);
+    // return position of cursor
+    return (cursorX);
+}
 
-    // render texture
-    m_texture->renderInitialize(a_options);
 
-    // render font texture
-    m_texture->setEnvironmentMode(GL_MODULATE);
-    
-    // render font color
-    a_color.render();
+//==============================================================================
+/*!
+    This method lays out a string as a list of glyph quads, one quad of four 
+    vertices per character. Each vertex is described by \ref C_FONT_VERTEX_SIZE 
+    values: its position (x, y) followed by its texture coordinates (u, v) 
+    in the font texture. \n
 
-    // render a quad for each character in the string
-    glBegin(GL_QUADS);
+    The quads only depend on the string and scale factor, and can therefore
+    be computed once and rendered many times.
 
-    // get reference to texture unit
-    GLenum textureUnit = m_texture->getTextureUnit();
+    \param  a_text       String to be laid out.
+    \param  a_fontScale  Font scale factor.
+    \param  a_vertices   Returned list of vertices. Previous content is erased.
+
+    \return Length of string.
+*/
+//==============================================================================
+double cFont::createTextVertices(const string& a_text,
+                                 const double a_fontScale,
+                                 vector<float>& a_vertices) const
+{
+    // initialization
+    a_vertices.clear();
+    double cursorX = 0;
+    int length = (int)(a_text.length());
+    if (length == 0) { return(0.0); }
+
+    a_vertices.reserve(4 * C_FONT_VERTEX_SIZE * length);
 
     // get size of font.
     double offset = getPointSize();
 
-     // render each character
+    // layout each character
     for (int i=0; i<length; i++)
     {
         int index = a_text[i];
@@ -311,37 +321,82 @@ double cFont::renderText(const string& a_text,
         // seb's magic formula for unicode > 127 (which is not extended ASCII)
         if (index < 0) index = 381 + index + a_text[++i];
 
-        cFontCharDescriptor *ch = &(m_charset.m_chars[index]);
+        const cFontCharDescriptor *ch = &(m_charset.m_chars[index]);
 
-        // render character
-        glNormal3d(0.0, 0.0, 1.0);
-        glMultiTexCoord2dARB(textureUnit, ch->m_tu0, ch->m_tv0);
-        glVertex3d((double)(a_fontScale * ch->m_px0 + cursorX), (double)(a_fontScale * (ch->m_py0 + offset)), 0.0);
-        glMultiTexCoord2dARB(textureUnit, ch->m_tu1, ch->m_tv1);
-        glVertex3d((double)(a_fontScale * ch->m_px1 + cursorX), (double)(a_fontScale * (ch->m_py1 + offset)), 0.0);
-        glMultiTexCoord2dARB(textureUnit, ch->m_tu2, ch->m_tv2);
-        glVertex3d((double)(a_fontScale * ch->m_px2 + cursorX), (double)(a_fontScale * (ch->m_py2 + offset)), 0.0);
-        glMultiTexCoord2dARB(textureUnit, ch->m_tu3, ch->m_tv3);
-        glVertex3d((double)(a_fontScale * ch->m_px3 + cursorX), (double)(a_fontScale * (ch->m_py3 + offset)), 0.0);
+        float quad[4 * C_FONT_VERTEX_SIZE] =
+        {
+            (float)(a_fontScale * ch->m_px0 + cursorX), (float)(a_fontScale * (ch->m_py0 + offset)), (float)ch->m_tu0, (float)ch->m_tv0,
+            (float)(a_fontScale * ch->m_px1 + cursorX), (float)(a_fontScale * (ch->m_py1 + offset)), (float)ch->m_tu1, (float)ch->m_tv1,
+            (float)(a_fontScale * ch->m_px2 + cursorX), (float)(a_fontScale * (ch->m_py2 + offset)), (float)ch->m_tu2, (float)ch->m_tv2,
+            (float)(a_fontScale * ch->m_px3 + cursorX), (float)(a_fontScale * (ch->m_py3 + offset)), (float)ch->m_tu3, (float)ch->m_tv3
+        };
+        a_vertices.insert(a_vertices.end(), quad, quad + 4 * C_FONT_VERTEX_SIZE);
 
         // increment cursor
-        cursorX += a_fontScale * m_charset.m_chars[index].m_xAdvance;
+        cursorX += a_fontScale * ch->m_xAdvance;
     }
 
-    // all character quads have been rendered
-    glEnd();
+    // return position of cursor
+    return (cursorX);
+}
+
+
+//==============================================================================
+/*!
+    This method renders a list of glyph quads, as created by 
+    \ref createTextVertices(), with a single draw call.
+
+    \param  a_vertices  List of vertices.
+    \param  a_color     Font color.
+    \param  a_options   Rendering options.
+*/
+//==============================================================================
+void cFont::renderTextVertices(const vector<float>& a_vertices,
+                               const cColorf& a_color,
+                               cRenderOptions& a_options)
+{
+#ifdef C_USE_OPENGL
+    // sanity check
+    if ((m_texture == nullptr) || (a_vertices.size() == 0))
+    {
+        return;
+    }
+
+    // render texture
+    glEnable(GL_BLEND);
+    glBlendFunc (GL_SRC_ALPHA, GL_ONE_MINUS_SRC_ALPHA);
+
+    // render texture
+    m_texture->renderInitialize(a_options);
+
+    // render font texture
+    m_texture->setEnvironmentMode(GL_MODULATE);
+    
+    // render font color
+    a_color.render();
+    glNormal3d(0.0, 0.0, 1.0);
+
+    // setup vertex arrays. texture coordinates are assigned to the texture unit of the font.
+    GLsizei stride = C_FONT_VERTEX_SIZE * sizeof(float);
+    glEnableClientState(GL_VERTEX_ARRAY);
+    glVertexPointer(2, GL_FLOAT, stride, &(a_vertices[0]));
+    glClientActiveTexture(m_texture->getTextureUnit());
+    glEnableClientState(GL_TEXTURE_COORD_ARRAY);
+    glTexCoordPointer(2, GL_FLOAT, stride, &(a_vertices[2]));
+
+    // render all character quads
+    glDrawArrays(GL_QUADS, 0, (GLsizei)(a_vertices.size() / C_FONT_VERTEX_SIZE));
+
+    // restore vertex arrays
+    glDisableClientState(GL_TEXTURE_COORD_ARRAY);
+    glClientActiveTexture(GL_TEXTURE0);
+    glDisableClientState(GL_VERTEX_ARRAY);
 
     // disable texture
     m_texture->renderFinalize(a_options);
 
     // cleanup
     glDisable(GL_BLEND);
-
-    // return position of cursor
-    return (cursorX);
-
-#else
-    return (0);
 #endif
 }
 
@@ -52,6 +52,7 @@
 #include <string.h>
 #include <iostream>
 #include <sstream>
+#include <vector>
 //------------------------------------------------------------------------------
 
 //------------------------------------------------------------------------------
@@ -67,6 +68,11 @@ namespace chai3d {
 */
 //==============================================================================
 
+//------------------------------------------------------------------------------
+//! Number of values per glyph vertex (position x, y and texture coordinates u, v).
+#define C_FONT_VERTEX_SIZE 4
+//------------------------------------------------------------------------------
+
 //------------------------------------------------------------------------------
 #ifndef DOXYGEN_SHOULD_SKIP_THIS
 //------------------------------------------------------------------------------
@@ -153,7 +159,11 @@ struct cFontCharset
     bitmap fonts from TrueType fonts. The application generates both image 
     files and character descriptions that can be read by a game for easy 
     rendering of fonts. These files can then be loaded into the cFont class
-    by using the loadFromFile() method.
+    by using the loadFromFile() method. \n
+
+    Text which does not change from one frame to the next can be laid out 
+    once as a list of glyph quads with createTextVertices(), and drawn with 
+    renderTextVertices() or collected by a \ref cTextBatch.
 */
 //==============================================================================
 class cFont
@@ -209,6 +219,16 @@ public:
         const double a_fontScale,
         cRenderOptions& a_options);
 
+    //! This method lays out a string of text as a list of glyph quads.
+    double createTextVertices(const std::string& a_text,
+        const double a_fontScale,
+        std::vector<float>& a_vertices) const;
+
+    //! This method renders a list of glyph quads created by \ref createTextVertices().
+    void renderTextVertices(const std::vector<float>& a_vertices,
+        const cColorf& a_color,
+        cRenderOptions& a_options);
+
 
     //--------------------------------------------------------------------------
     // PUBLIC MEMBERS:
@@ -114,7 +114,7 @@ public:
     cImagePtr copy();
 
     //! This method allocates a new image by defining its size, pixel format and pixel type.
-    bool allocate(const unsigned int a_width,
+    virtual bool allocate(const unsigned int a_width,
                   const unsigned int a_height,
                   const GLenum a_format = GL_RGB,
                   const GLenum a_type = GL_UNSIGNED_BYTE);
@@ -44,6 +44,7 @@
 //------------------------------------------------------------------------------
 #include "CMultiImage.h"
 //------------------------------------------------------------------------------
+#include <cstring>
 #include <iomanip>
 #include <iostream>
 #include <sstream>
@@ -55,6 +56,69 @@ using namespace std;
 namespace chai3d {
 //------------------------------------------------------------------------------
 
+//------------------------------------------------------------------------------
+#ifndef DOXYGEN_SHOULD_SKIP_THIS
+//------------------------------------------------------------------------------
+
+//==============================================================================
+/*!
+    cImageSlice is an image whose pixel data is a slice of a cMultiImage. 
+    When a file decoder allocates an image that matches the slice, the 
+    decoder writes directly into the slice instead of a separate buffer.
+*/
+//==============================================================================
+class cImageSlice : public cImage
+{
+public:
+
+    cImageSlice(unsigned char* a_slice,
+                const unsigned int a_width,
+                const unsigned int a_height,
+                const GLenum a_format,
+                const GLenum a_type) :
+        m_slice(a_slice), m_sliceWidth(a_width), m_sliceHeight(a_height),
+        m_sliceFormat(a_format), m_sliceType(a_type) {}
+
+    virtual bool allocate(const unsigned int a_width,
+                          const unsigned int a_height,
+                          const GLenum a_format = GL_RGB,
+                          const GLenum a_type = GL_UNSIGNED_BYTE)
+    {
+        // images that do not match the slice are decoded in their own memory
+        if ((a_width  != m_sliceWidth)  ||
+            (a_height != m_sliceHeight) ||
+            (a_format != m_sliceFormat) ||
+            (a_type   != m_sliceType))
+        {
+            return (cImage::allocate(a_width, a_height, a_format, a_type));
+        }
+
+        m_width         = a_width;
+        m_height        = a_height;
+        m_format        = a_format;
+        m_type          = a_type;
+        m_bytesPerPixel = queryBytesPerPixel(a_format, a_type);
+        m_memorySize    = m_width * m_height * m_bytesPerPixel;
+        m_data          = m_slice;
+        m_allocated     = true;
+        m_responsibleForMemoryAllocation = false;
+
+        return (true);
+    }
+
+protected:
+
+    unsigned char* m_slice;
+    unsigned int m_sliceWidth;
+    unsigned int m_sliceHeight;
+    GLenum m_sliceFormat;
+    GLenum m_sliceType;
+};
+
+//------------------------------------------------------------------------------
+#endif  // DOXYGEN_SHOULD_SKIP_THIS
+//------------------------------------------------------------------------------
+
 //==============================================================================
 /*!
     Default constructor of cMultiImage.
@@ -62,6 +126,12 @@ namespace chai3d {
 //==============================================================================
 cMultiImage::cMultiImage() : cImage()
 {
+    // no background loading
+    m_loadNext.store(0);
+    m_loadProcessed.store(0);
+    m_loadCount.store(0);
+    m_loadCancel.store(false);
+
     // init internal variables
     defaults();
 }
@@ -102,6 +172,9 @@ void cMultiImage::defaults()
 //==============================================================================
 void cMultiImage::cleanup()
 {
+    // stop background loading into the array
+    stopLoading();
+
     // delete data
     if (m_responsibleForMemoryAllocation)
     {
@@ -142,6 +215,9 @@ bool cMultiImage::allocate(const unsigned int a_width,
         return (false);
     }
 
+    // stop background loading into the current array
+    stopLoading();
+
     // verify the memory requirements for given format
     int bytesPerPixel = queryBytesPerPixel(a_format, a_type);
     if (bytesPerPixel < 1)
@@ -230,6 +306,9 @@ cMultiImagePtr cMultiImage::copy()
 //==============================================================================
 bool cMultiImage::convert(const unsigned int a_newFormat)
 {
+    // complete background loading first
+    waitForLoad();
+
     // sanity check
     if (m_imageCount == 0)
     {
@@ -341,6 +420,9 @@ bool cMultiImage::selectImage(unsigned long a_index)
 bool cMultiImage::addImage(cImage &a_image,
                            unsigned long a_index)
 {
+    // complete background loading first
+    waitForLoad();
+
     // check index validity
     if (a_index != (unsigned long)-1 &&
         a_index >= m_imageCount &&
@@ -469,6 +551,9 @@ bool cMultiImage::addImagePrealloc(cImage &a_image,
 //==============================================================================
 bool cMultiImage::removeImage(unsigned long a_index)
 {
+    // complete background loading first
+    waitForLoad();
+
     // check index validity
     if (a_index >= m_imageCount)
     {
@@ -704,6 +789,9 @@ void cMultiImage::setVoxelColor(const unsigned int a_x,
 void cMultiImage::setTransparentColor(const cColorb &a_color,
                                       const unsigned char a_transparencyLevel)
 {
+    // complete background loading first
+    waitForLoad();
+
     // verify format, convert otherwise
     if (m_format != GL_RGBA)
     {
@@ -732,6 +820,9 @@ void cMultiImage::setTransparentColor(const cColorb &a_color,
 //==============================================================================
 void cMultiImage::setTransparency(const unsigned char a_transparencyLevel)
 {
+    // complete background loading first
+    waitForLoad();
+
     // verify format, convert otherwise
     if (m_format != GL_RGBA)
     {
@@ -805,6 +896,9 @@ unsigned char* cMultiImage::getVoxelData(const unsigned int a_x,
 //==============================================================================
 void cMultiImage::flipHorizontal()
 {
+    // complete background loading first
+    waitForLoad();
+
     // process all images one-by-one
     for (unsigned long i=0; i<m_imageCount; i++)
     {
@@ -904,8 +998,9 @@ int cMultiImage::loadFromFiles(const std::string& a_basename,
 //==============================================================================
 /*!
     This method loads a set of images from a set of files. The filenames are 
-    contained in a vector, and the files are loaded in the order they are stored 
-    in the vector.
+    contained in a vector, and each file is loaded at the index it is stored 
+    at in the vector. Files are decoded in parallel, using all cores, and the 
+    method returns once all files have been processed.
 
     The first image defines the properties of the whole set. Each subsequent image
     must match the properties of the first image, otherwise it will be ignored.
@@ -918,44 +1013,202 @@ int cMultiImage::loadFromFiles(const std::string& a_basename,
 //==============================================================================
 int cMultiImage::loadFromFiles(const std::vector<std::string>& a_filename)
 {
-    int loaded = 0;
+    // start loading
+    if (!loadFromFilesAsync(a_filename))
+    {
+        return (0);
+    }
+
+    // wait for all files to be processed
+    return (waitForLoad());
+}
+
+
+//==============================================================================
+/*!
+    This method starts loading a set of images from a set of files, and 
+    returns as soon as the first image has been loaded. \n
 
+    The first image defines the properties of the whole set, which is then 
+    allocated for all files and cleared. The remaining files are decoded by 
+    a pool of threads, directly into their slice of the set. Each subsequent 
+    image must match the properties of the first image, otherwise it is 
+    ignored and its slice remains black. \n
+
+    While loading, the set can be read and rendered; use getImageLoaded() or 
+    getLoadProgress() to follow progress, and waitForLoad() to wait for 
+    completion. Methods that reallocate or modify all images wait for loading 
+    to complete. This routine erases and replaces any previous content.
+
+    \param  a_filename    The vector containing the filenames.
+    \param  a_numThreads  Number of loading threads. If 0, one thread per core is used.
+
+    \return __true__ if the first image was loaded and loading has started, 
+            __false__ otherwise.
+*/
+//==============================================================================
+bool cMultiImage::loadFromFilesAsync(const std::vector<std::string>& a_filename,
+                                     const unsigned int a_numThreads)
+{
     // sanity check
-    if (a_filename.size() == 0) return (0);
+    if (a_filename.size() == 0) return (false);
 
     // cleanup previous set
     cleanup();
 
     // load first image to get parameters
-    if (!addFromFile(a_filename[0]))
-        return false;
-
-    // set total image count
-    m_imageCount = a_filename.size();
+    cImage image;
+    if (!image.loadFromFile(a_filename[0]))
+    {
+        return (false);
+    }
 
     // pre-allocate array for all images
-    unsigned char* array = new unsigned char[m_imageCount * m_memorySize];
+    if (!allocate(image.getWidth(), image.getHeight(), (unsigned int)a_filename.size(), image.getFormat(), image.getType()))
+    {
+        return (false);
+    }
 
-    // copy existing first image into reallocated array
-    std::copy(m_array, m_array+m_memorySize, array);
+    // store first image
+    addImagePrealloc(image, 0);
 
-    // delete old array and reassign
-    unsigned char *tmp = m_array;
-    m_array = array;
-    m_data  = m_array + m_currentIndex * m_memorySize;
-    delete [] tmp;
+    // initialize progress
+    m_loadFilenames = a_filename;
+    m_imageLoaded.reset(new std::atomic<unsigned char>[m_loadFilenames.size()]);
+    for (unsigned int i=0; i<m_loadFilenames.size(); i++)
+    {
+        m_imageLoaded[i].store(0);
+    }
+    m_imageLoaded[0].store(1);
+    m_loadNext.store(1);
+    m_loadProcessed.store(1);
+    m_loadCount.store(1);
+    m_loadCancel.store(false);
+
+    // start loading threads
+    unsigned int numThreads = a_numThreads;
+    if (numThreads == 0)
+    {
+        numThreads = cMax(std::thread::hardware_concurrency(), (unsigned int)1);
+    }
+    numThreads = cMin(numThreads, (unsigned int)m_loadFilenames.size() - 1);
+
+    for (unsigned int i=0; i<numThreads; i++)
+    {
+        m_loadThreads.push_back(std::thread(&cMultiImage::loadWorker, this));
+    }
+
+    return (true);
+}
 
-    // load each following file, count those that fit
-    for (unsigned int i=0; i<m_imageCount; i++)
+
+//==============================================================================
+/*!
+    This method waits until all files of the current background load have 
+    been processed.
+
+    \return The number of images loaded by the current or last load.
+*/
+//==============================================================================
+int cMultiImage::waitForLoad()
+{
+    for (unsigned int i=0; i<m_loadThreads.size(); i++)
+    {
+        m_loadThreads[i].join();
+    }
+    m_loadThreads.clear();
+
+    return ((int)m_loadCount.load(std::memory_order_acquire));
+}
+
+
+//==============================================================================
+/*!
+    This method returns the fraction of files processed by the current or 
+    last background load, whether they were loaded or rejected.
+
+    \return Progress from 0.0 to 1.0, or 0.0 if no files were loaded.
+*/
+//==============================================================================
+double cMultiImage::getLoadProgress() const
+{
+    if (m_loadFilenames.size() == 0)
+    {
+        return (0.0);
+    }
+
+    return ((double)m_loadProcessed.load(std::memory_order_acquire) / (double)m_loadFilenames.size());
+}
+
+
+//==============================================================================
+/*!
+    This method returns whether an image of the set has been loaded by the 
+    current or last background load. Once it returns __true__, the pixel 
+    data of the image can be read from any thread.
+
+    \param  a_index  Index of the image.
+
+    \return __true__ if the image has been loaded, __false__ otherwise.
+*/
+//==============================================================================
+bool cMultiImage::getImageLoaded(const unsigned long a_index) const
+{
+    if (!m_imageLoaded || (a_index >= m_loadFilenames.size()))
+    {
+        return (false);
+    }
+
+    return (m_imageLoaded[a_index].load(std::memory_order_acquire) != 0);
+}
+
+
+//==============================================================================
+/*!
+    This method is executed by each background loading thread. Threads take 
+    the next file to decode until all files are processed or loading is 
+    cancelled.
+*/
+//==============================================================================
+void cMultiImage::loadWorker()
+{
+    while (!m_loadCancel.load(std::memory_order_relaxed))
     {
-        if (addFromFilePrealloc(a_filename[i], i))
+        unsigned int index = m_loadNext.fetch_add(1, std::memory_order_relaxed);
+        if (index >= m_loadFilenames.size())
+        {
+            break;
+        }
+
+        if (addFromFilePrealloc(m_loadFilenames[index], index))
         {
-            loaded++;
+            // publish image data
+            m_imageLoaded[index].store(1, std::memory_order_release);
+            m_loadCount.fetch_add(1, std::memory_order_release);
         }
+
+        m_loadProcessed.fetch_add(1, std::memory_order_release);
     }
+}
 
-    // return number of files actually loaded
-    return (loaded);
+
+//==============================================================================
+/*!
+    This method cancels background loading, waits for the loading threads to 
+    exit and resets the loading progress.
+*/
+//==============================================================================
+void cMultiImage::stopLoading()
+{
+    m_loadCancel.store(true);
+    waitForLoad();
+
+    m_loadFilenames.clear();
+    m_imageLoaded.reset();
+    m_loadNext.store(0);
+    m_loadProcessed.store(0);
+    m_loadCount.store(0);
+    m_loadCancel.store(false);
 }
 
 
@@ -992,7 +1245,7 @@ bool cMultiImage::addFromFile(const string& a_filename,
 //==============================================================================
 /*!
     This method adds an image file to a preallocated image set. The set must be
-    preallocated by calling \ref loadFromFiles(). This method checks that the 
+    preallocated by calling \ref loadFromFiles() or \ref loadFromFilesAsync(). This method checks that the 
     new image matches the properties of the images already in the set. If the 
     image properties do not match, the image is not loaded and an error is returned.
 
@@ -1006,14 +1259,30 @@ bool cMultiImage::addFromFile(const string& a_filename,
 bool cMultiImage::addFromFilePrealloc(const string& a_filename,
                                       unsigned long a_index)
 {
-    cImage image;
+    // check index validity
+    if (a_index >= m_imageCount)
+    {
+        return (false);
+    }
+
+    // decode image directly into its slice when properties match
+    unsigned char* slice = m_array + a_index * m_memorySize;
+    cImageSlice image(slice, m_width, m_height, m_format, m_type);
 
     // load image from file
     if (!image.loadFromFile(a_filename))
     {
+        // discard partially decoded data
+        memset(slice, 0, m_memorySize);
         return (false);
     }
 
+    // image was decoded in place
+    if (image.getData() == slice)
+    {
+        return (true);
+    }
+
     // add new image to data set
     return (addImagePrealloc(image, a_index));
 }
@@ -1036,6 +1305,9 @@ bool cMultiImage::addFromFilePrealloc(const string& a_filename,
 //==============================================================================
 bool cMultiImage::saveToFiles(const std::string& a_basename, const std::string& a_extension)
 {
+    // complete background loading first
+    waitForLoad();
+
     // sanity check
     if (a_basename == "")
     {
@@ -47,7 +47,10 @@
 //------------------------------------------------------------------------------
 #include "graphics/CImage.h"
 //------------------------------------------------------------------------------
+#include <atomic>
+#include <memory>
 #include <string>
+#include <thread>
 #include <vector>
 //------------------------------------------------------------------------------
 namespace chai3d {
@@ -81,8 +84,15 @@ typedef std::shared_ptr<cMultiImage> cMultiImagePtr;
     either as a slice of a volume representation, or a frame of a time lapse.
     The images are treated as a set of pixel arrays, all sharing common
     properties and geometry. All pixel arrays are guaranteed to be allocated
-    contiguously in a single memory array.
-
+    contiguously in a single memory array. \n
+
+    Sets of files are decoded by a pool of threads, directly into the slices 
+    of the preallocated array. loadFromFilesAsync() returns as soon as the 
+    first image has defined the properties of the set; images are then filled 
+    in the background, and the partially loaded set can be used meanwhile 
+    (slices not yet loaded are black). Progress can be polled with 
+    getLoadProgress() and getImageLoaded(). Methods that reallocate the set 
+    wait for loading to complete.
 */
 //==============================================================================
 class cMultiImage : public cImage
@@ -234,6 +244,24 @@ public:
     //! This method loads an image set from a set of files.
     virtual int loadFromFiles(const std::vector<std::string>& a_filename);
 
+    //! This method starts loading an image set from a set of files in background threads.
+    virtual bool loadFromFilesAsync(const std::vector<std::string>& a_filename, const unsigned int a_numThreads = 0);
+
+    //! This method waits until background loading completes and returns the number of images loaded.
+    int waitForLoad();
+
+    //! This method returns __true__ while images are being loaded in background.
+    bool isLoading() const { return (m_loadProcessed.load(std::memory_order_acquire) < m_loadFilenames.size()); }
+
+    //! This method returns the fraction of files processed by the current or last load, from 0.0 to 1.0.
+    double getLoadProgress() const;
+
+    //! This method returns the number of images successfully loaded by the current or last load.
+    unsigned int getNumImagesLoaded() const { return (m_loadCount.load(std::memory_order_acquire)); }
+
+    //! This method returns __true__ if an image of the set has been loaded from file.
+    bool getImageLoaded(const unsigned long a_index) const;
+
     //! This method loads an image set from a set of similarly named images.
     virtual int loadFromFiles(const std::string& a_basename, const std::string& a_extension, unsigned long a_max = 9999);
 
@@ -262,6 +290,12 @@ protected:
     //! Add an image to a preallocated set if size and format are compatible.
     bool addImagePrealloc(cImage &a_image, unsigned long a_index);
 
+    //! This method decodes files until none is left (body of background loading threads).
+    void loadWorker();
+
+    //! This method cancels background loading and waits for the loading threads to exit.
+    void stopLoading();
+
 
     //--------------------------------------------------------------------------
     // PROTECTED MEMBERS:
@@ -277,6 +311,27 @@ protected:
 
     //! Index of the currently selected image.
     unsigned long m_currentIndex;
+
+    //! Files of the current or last background load.
+    std::vector<std::string> m_loadFilenames;
+
+    //! Background loading threads.
+    std::vector<std::thread> m_loadThreads;
+
+    //! Index of the next file to be decoded.
+    std::atomic<unsigned int> m_loadNext;
+
+    //! Number of files processed (loaded or rejected).
+    std::atomic<unsigned int> m_loadProcessed;
+
+    //! Number of files successfully loaded.
+    std::atomic<unsigned int> m_loadCount;
+
+    //! If __true__, then loading threads exit before decoding their next file.
+    std::atomic<bool> m_loadCancel;
+
+    //! Per image, nonzero once the image has been loaded.
+    std::unique_ptr<std::atomic<unsigned char>[]> m_imageLoaded;
 };
 
 //------------------------------------------------------------------------------
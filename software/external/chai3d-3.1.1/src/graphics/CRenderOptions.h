@@ -52,6 +52,8 @@ namespace chai3d {
 
 //------------------------------------------------------------------------------
 class cCamera;
+class cPrimitiveBatch;
+class cTextBatch;
 //------------------------------------------------------------------------------
 
 //==============================================================================
@@ -122,6 +124,12 @@ struct cRenderOptions
 
     //! If __true__, then reset OpenGL display lists and texture objects.
     bool m_markForUpdate;
+
+    //! Batch collecting shapes which are drawn at the end of the pass. (NULL if shapes are drawn directly)
+    cPrimitiveBatch* m_primitiveBatch;
+
+    //! Batch collecting text which is drawn at the end of the pass. (NULL if text is drawn directly)
+    cTextBatch* m_textBatch;
 };
 
 
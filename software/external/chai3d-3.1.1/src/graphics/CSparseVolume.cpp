@@ -0,0 +1,737 @@
+//==============================================================================
+/*
+    Software License Agreement (BSD License)
+    Copyright (c) 2003-2016, CHAI3D.
+    (www.chai3d.org)
+
+    All rights reserved.
+
+    Redistribution and use in source and binary forms, with or without
+    modification, are permitted provided that the following conditions
+    are met:
+
+    * Redistributions of source code must retain the above copyright
+    notice, this list of conditions and the following disclaimer.
+
+    * Redistributions in binary form must reproduce the above
+    copyright notice, this list of conditions and the following
+    disclaimer in the documentation and/or other materials provided
+    with the distribution.
+
+    * Neither the name of CHAI3D nor the names of its contributors may
+    be used to endorse or promote products derived from this software
+    without specific prior written permission.
+
+    THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS
+    "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT
+    LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS
+    FOR A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE
+    COPYRIGHT OWNER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT,
+    INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING,
+    BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES;
+    LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER
+    CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT
+    LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN
+    ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE
+    POSSIBILITY OF SUCH DAMAGE. 
+
+    \author    <http://www.chai3d.org>
+    \version   3.1.1 $Rev: 1869 $
+*/
+//==============================================================================
+
+//------------------------------------------------------------------------------
+#include "graphics/CSparseVolume.h"
+//------------------------------------------------------------------------------
+#include <climits>
+#include <limits>
+#include <thread>
+//------------------------------------------------------------------------------
+using namespace std;
+//------------------------------------------------------------------------------
+
+//------------------------------------------------------------------------------
+namespace chai3d {
+//------------------------------------------------------------------------------
+
+//------------------------------------------------------------------------------
+#ifndef DOXYGEN_SHOULD_SKIP_THIS
+//------------------------------------------------------------------------------
+
+//! Squared distance given to voxels which do not belong to the target set of a distance transform.
+const double C_SPARSE_VOLUME_FAR = 1e20;
+
+//! Size of the region, along each axis, over which the distances of a brick are computed.
+const int C_SPARSE_VOLUME_REGION = C_SPARSE_VOLUME_BRICK_SIZE + 2 * C_SPARSE_VOLUME_DISTANCE_BAND;
+
+//==============================================================================
+/*!
+    Computes the one dimensional squared Euclidean distance transform of a 
+    sampled function (Felzenszwalb and Huttenlocher).
+
+    \param  a_f        Input samples.
+    \param  a_d        Output samples.
+    \param  a_n        Number of samples.
+    \param  a_spacing  Distance between samples.
+*/
+//==============================================================================
+static void cDistanceTransform1d(const double* a_f, double* a_d, const int a_n, const double a_spacing)
+{
+    int v[C_SPARSE_VOLUME_REGION];
+    double z[C_SPARSE_VOLUME_REGION + 1];
+
+    // compute lower envelope of parabolas
+    int k = 0;
+    v[0] = 0;
+    z[0] = -numeric_limits<double>::infinity();
+    z[1] =  numeric_limits<double>::infinity();
+    for (int q=1; q<a_n; q++)
+    {
+        double pq = q * a_spacing;
+        double s;
+        while (true)
+        {
+            double pv = v[k] * a_spacing;
+            s = ((a_f[q] + pq * pq) - (a_f[v[k]] + pv * pv)) / (2.0 * (pq - pv));
+            if (s > z[k]) { break; }
+            k--;
+        }
+        k++;
+        v[k] = q;
+        z[k] = s;
+        z[k+1] = numeric_limits<double>::infinity();
+    }
+
+    // sample lower envelope
+    k = 0;
+    for (int q=0; q<a_n; q++)
+    {
+        double pq = q * a_spacing;
+        while (z[k+1] < pq) { k++; }
+        double dq = pq - v[k] * a_spacing;
+        a_d[q] = dq * dq + a_f[v[k]];
+    }
+}
+
+//------------------------------------------------------------------------------
+#endif  // DOXYGEN_SHOULD_SKIP_THIS
+//------------------------------------------------------------------------------
+
+//==============================================================================
+/*!
+    Constructor of cSparseVolume.
+*/
+//==============================================================================
+cSparseVolume::cSparseVolume()
+{
+    clear();
+}
+
+
+//==============================================================================
+/*!
+    This method builds the volume from a region of a 3D image (\ref cMultiImage)
+    or 2D image. The level of each voxel is read from the alpha channel of 
+    the image (the luminance, for luminance images). Voxels of the region 
+    located outside of the image are considered empty.
+
+    \param  a_image    Source image.
+    \param  a_originX  X coordinate of the first voxel of the region.
+    \param  a_originY  Y coordinate of the first voxel of the region.
+    \param  a_originZ  Z coordinate of the first voxel of the region.
+    \param  a_sizeX    Size of the region along X.
+    \param  a_sizeY    Size of the region along Y.
+    \param  a_sizeZ    Size of the region along Z.
+
+    \return __true__ if the operation succeeded, __false__ otherwise.
+*/
+//==============================================================================
+bool cSparseVolume::build(cImage* a_image,
+                          const int a_originX,
+                          const int a_originY,
+                          const int a_originZ,
+                          const int a_sizeX,
+                          const int a_sizeY,
+                          const int a_sizeZ)
+{
+    clear();
+
+    // sanity check
+    if ((a_image == nullptr) || (a_sizeX < 1) || (a_sizeY < 1) || (a_sizeZ < 1))
+    {
+        return (false);
+    }
+
+    // setup brick table
+    m_origin[0] = a_originX;
+    m_origin[1] = a_originY;
+    m_origin[2] = a_originZ;
+    m_size[0] = a_sizeX;
+    m_size[1] = a_sizeY;
+    m_size[2] = a_sizeZ;
+    for (int i=0; i<3; i++)
+    {
+        m_numBricks[i] = (m_size[i] + C_SPARSE_VOLUME_BRICK_SIZE - 1) >> C_SPARSE_VOLUME_BRICK_SHIFT;
+    }
+    int numBricks = m_numBricks[0] * m_numBricks[1] * m_numBricks[2];
+    m_brickMin.resize(numBricks);
+    m_brickMax.resize(numBricks);
+    m_brickData.resize(numBricks);
+
+    // read bricks, keeping voxel data of non-uniform ones only
+    unsigned char levels[C_SPARSE_VOLUME_BRICK_VOXELS];
+    for (int bz=0; bz<m_numBricks[2]; bz++)
+    {
+        for (int by=0; by<m_numBricks[1]; by++)
+        {
+            for (int bx=0; bx<m_numBricks[0]; bx++)
+            {
+                unsigned char levelMin = 255;
+                unsigned char levelMax = 0;
+                for (int z=0; z<C_SPARSE_VOLUME_BRICK_SIZE; z++)
+                {
+                    for (int y=0; y<C_SPARSE_VOLUME_BRICK_SIZE; y++)
+                    {
+                        for (int x=0; x<C_SPARSE_VOLUME_BRICK_SIZE; x++)
+                        {
+                            int vx = (bx << C_SPARSE_VOLUME_BRICK_SHIFT) + x;
+                            int vy = (by << C_SPARSE_VOLUME_BRICK_SHIFT) + y;
+                            int vz = (bz << C_SPARSE_VOLUME_BRICK_SHIFT) + z;
+
+                            unsigned char level = 0;
+                            cColorb color;
+                            if ((vx < m_size[0]) && (vy < m_size[1]) && (vz < m_size[2]) && 
+                                (m_origin[0] + vx >= 0) && (m_origin[1] + vy >= 0) && (m_origin[2] + vz >= 0) &&
+                                (a_image->getVoxelColor(m_origin[0] + vx, m_origin[1] + vy, m_origin[2] + vz, color)))
+                            {
+                                level = color.getA();
+                            }
+
+                            levels[getVoxelOffset(x, y, z)] = level;
+                            levelMin = cMin(levelMin, level);
+                            levelMax = cMax(levelMax, level);
+                        }
+                    }
+                }
+
+                int brick = getBrickIndex(bx, by, bz);
+                m_brickMin[brick] = levelMin;
+                m_brickMax[brick] = levelMax;
+                if (levelMin == levelMax)
+                {
+                    m_brickData[brick] = -1;
+                }
+                else
+                {
+                    m_brickData[brick] = (int)(m_levels.size());
+                    m_levels.insert(m_levels.end(), levels, levels + C_SPARSE_VOLUME_BRICK_VOXELS);
+                }
+            }
+        }
+    }
+
+    return (true);
+}
+
+
+//==============================================================================
+/*!
+    This method deletes all data of the volume.
+*/
+//==============================================================================
+void cSparseVolume::clear()
+{
+    for (int i=0; i<3; i++)
+    {
+        m_size[i] = 0;
+        m_origin[i] = 0;
+        m_numBricks[i] = 0;
+    }
+    m_brickMin.clear();
+    m_brickMax.clear();
+    m_brickData.clear();
+    m_levels.clear();
+    m_boundsLevel = -1;
+    m_boundsFound = false;
+    clearDistanceField();
+}
+
+
+//==============================================================================
+/*!
+    This method returns the maximum level of all voxels contained in a box,
+    bounds included. The maximum is taken over all bricks overlapping the box,
+    so that it may exceed the exact maximum: this method is meant to skip 
+    empty regions quickly.
+
+    \param  a_minX  Minimum X coordinate of box.
+    \param  a_minY  Minimum Y coordinate of box.
+    \param  a_minZ  Minimum Z coordinate of box.
+    \param  a_maxX  Maximum X coordinate of box.
+    \param  a_maxY  Maximum Y coordinate of box.
+    \param  a_maxZ  Maximum Z coordinate of box.
+
+    \return Maximum level of bricks overlapping the box.
+*/
+//==============================================================================
+unsigned char cSparseVolume::getMaxLevel(const int a_minX, const int a_minY, const int a_minZ,
+                                         const int a_maxX, const int a_maxY, const int a_maxZ) const
+{
+    // clamp box to volume
+    int minX = cMax(a_minX, 0);
+    int minY = cMax(a_minY, 0);
+    int minZ = cMax(a_minZ, 0);
+    int maxX = cMin(a_maxX, m_size[0] - 1);
+    int maxY = cMin(a_maxY, m_size[1] - 1);
+    int maxZ = cMin(a_maxZ, m_size[2] - 1);
+    if ((minX > maxX) || (minY > maxY) || (minZ > maxZ))
+    {
+        return (0);
+    }
+
+    // scan bricks
+    unsigned char level = 0;
+    for (int bz=(minZ >> C_SPARSE_VOLUME_BRICK_SHIFT); bz<=(maxZ >> C_SPARSE_VOLUME_BRICK_SHIFT); bz++)
+    {
+        for (int by=(minY >> C_SPARSE_VOLUME_BRICK_SHIFT); by<=(maxY >> C_SPARSE_VOLUME_BRICK_SHIFT); by++)
+        {
+            for (int bx=(minX >> C_SPARSE_VOLUME_BRICK_SHIFT); bx<=(maxX >> C_SPARSE_VOLUME_BRICK_SHIFT); bx++)
+            {
+                level = cMax(level, m_brickMax[getBrickIndex(bx, by, bz)]);
+            }
+        }
+    }
+
+    return (level);
+}
+
+
+//==============================================================================
+/*!
+    This method computes the box enclosing all bricks which contain voxels
+    of level greater or equal to a threshold. The result is cached until
+    the threshold changes.
+
+    \param  a_level  Threshold.
+    \param  a_min    Returned minimum coordinates of box.
+    \param  a_max    Returned maximum coordinates of box.
+
+    \return __true__ if such voxels exist, __false__ otherwise.
+*/
+//==============================================================================
+bool cSparseVolume::getOccupiedBounds(const int a_level, int a_min[3], int a_max[3]) const
+{
+    if (a_level != m_boundsLevel)
+    {
+        m_boundsLevel = a_level;
+        m_boundsFound = false;
+        for (int bz=0; bz<m_numBricks[2]; bz++)
+        {
+            for (int by=0; by<m_numBricks[1]; by++)
+            {
+                for (int bx=0; bx<m_numBricks[0]; bx++)
+                {
+                    if (m_brickMax[getBrickIndex(bx, by, bz)] < a_level) { continue; }
+
+                    int b[3] = { bx, by, bz };
+                    for (int i=0; i<3; i++)
+                    {
+                        int lo = b[i] << C_SPARSE_VOLUME_BRICK_SHIFT;
+                        int hi = cMin(lo + C_SPARSE_VOLUME_BRICK_SIZE, m_size[i]) - 1;
+                        m_bounds[i]   = m_boundsFound ? cMin(m_bounds[i], lo) : lo;
+                        m_bounds[i+3] = m_boundsFound ? cMax(m_bounds[i+3], hi) : hi;
+                    }
+                    m_boundsFound = true;
+                }
+            }
+        }
+    }
+
+    for (int i=0; i<3; i++)
+    {
+        a_min[i] = m_bounds[i];
+        a_max[i] = m_bounds[i+3];
+    }
+    return (m_boundsFound);
+}
+
+
+//==============================================================================
+/*!
+    This method computes the signed distance field to the isosurface which
+    separates voxels of level greater or equal to __a_level__ (inside) from
+    other voxels (outside). The surface lies halfway between the centers of
+    neighboring inside and outside voxels.\n\n
+
+    Bricks are first classified. Surface bricks, which contain the surface
+    or border a brick of different state, and their neighbors store one 
+    distance per voxel, computed exactly up to 
+    \ref C_SPARSE_VOLUME_DISTANCE_BAND voxels away. Every other brick 
+    stores a single lower bound of the distance of its voxels, derived from
+    the distance (in bricks) to the nearest surface brick. Bricks are 
+    computed in parallel on all cores.
+
+    \param  a_level      Level of isosurface (1 to 255).
+    \param  a_voxelSize  Size of voxels along each axis.
+
+    \return __true__ if the operation succeeded, __false__ otherwise.
+*/
+//==============================================================================
+bool cSparseVolume::computeDistanceField(const int a_level, const cVector3d& a_voxelSize)
+{
+    clearDistanceField();
+
+    // sanity check
+    if (isEmpty() || (a_level < 1) || (a_level > 255) ||
+        (a_voxelSize(0) <= 0.0) || (a_voxelSize(1) <= 0.0) || (a_voxelSize(2) <= 0.0))
+    {
+        return (false);
+    }
+
+    m_distanceLevel = a_level;
+    m_voxelSize = a_voxelSize;
+    double voxelSize = cMin(a_voxelSize(0), cMin(a_voxelSize(1), a_voxelSize(2)));
+
+    // classify bricks of the distance field: outside (0), inside (1) or 
+    // mixed (2); bricks of the border are outside
+    int numBricks[3] = { m_numBricks[0] + 2, m_numBricks[1] + 2, m_numBricks[2] + 2 };
+    int numFieldBricks = numBricks[0] * numBricks[1] * numBricks[2];
+    vector<char> state(numFieldBricks, 0);
+    for (int bz=0; bz<m_numBricks[2]; bz++)
+    {
+        for (int by=0; by<m_numBricks[1]; by++)
+        {
+            for (int bx=0; bx<m_numBricks[0]; bx++)
+            {
+                int brick = getBrickIndex(bx, by, bz);
+                state[getDistanceBrickIndex(bx, by, bz)] = (m_brickMin[brick] >= a_level) ? 1 : ((m_brickMax[brick] < a_level) ? 0 : 2);
+            }
+        }
+    }
+
+    // find surface bricks: mixed bricks, and bricks next to a brick of different state
+    vector<int> distance(numFieldBricks, INT_MAX);
+    vector<int> queue;
+    queue.reserve(numFieldBricks);
+    for (int b=0; b<numFieldBricks; b++)
+    {
+        int bx = b % numBricks[0];
+        int by = (b / numBricks[0]) % numBricks[1];
+        int bz = b / (numBricks[0] * numBricks[1]);
+        bool surface = (state[b] == 2);
+        for (int n=0; (n<27) && (!surface); n++)
+        {
+            int nx = bx + (n % 3) - 1;
+            int ny = by + ((n / 3) % 3) - 1;
+            int nz = bz + (n / 9) - 1;
+            bool inside = (nx >= 0) && (ny >= 0) && (nz >= 0) &&
+                          (nx < numBricks[0]) && (ny < numBricks[1]) && (nz < numBricks[2]);
+            char neighborState = inside ? state[nx + numBricks[0] * (ny + numBricks[1] * nz)] : 0;
+            surface = (neighborState != state[b]);
+        }
+        if (surface)
+        {
+            distance[b] = 0;
+            queue.push_back(b);
+        }
+    }
+
+    // compute distance of all bricks to the surface, in bricks (breadth-first search)
+    for (unsigned int q=0; q<queue.size(); q++)
+    {
+        int brick = queue[q];
+        int bx = brick % numBricks[0];
+        int by = (brick / numBricks[0]) % numBricks[1];
+        int bz = brick / (numBricks[0] * numBricks[1]);
+        for (int n=0; n<27; n++)
+        {
+            int nx = bx + (n % 3) - 1;
+            int ny = by + ((n / 3) % 3) - 1;
+            int nz = bz + (n / 9) - 1;
+            if ((nx < 0) || (ny < 0) || (nz < 0) ||
+                (nx >= numBricks[0]) || (ny >= numBricks[1]) || (nz >= numBricks[2]))
+            {
+                continue;
+            }
+            int neighbor = nx + numBricks[0] * (ny + numBricks[1] * nz);
+            if (distance[neighbor] == INT_MAX)
+            {
+                distance[neighbor] = distance[brick] + 1;
+                queue.push_back(neighbor);
+            }
+        }
+    }
+
+    // assign distance data to surface bricks and their neighbors, and a 
+    // lower bound to others (voxels of bricks two or more bricks away from
+    // the surface are at least a brick size away from it)
+    double diagonal = cVector3d(m_size[0] * a_voxelSize(0), m_size[1] * a_voxelSize(1), m_size[2] * a_voxelSize(2)).length();
+    vector<int> bricks;
+    m_brickDistance.resize(numFieldBricks);
+    m_distanceData.resize(numFieldBricks, -1);
+    for (int b=0; b<numFieldBricks; b++)
+    {
+        double sign = (state[b] == 1) ? -1.0 : 1.0;
+        if (distance[b] <= 1)
+        {
+            m_distanceData[b] = (int)(bricks.size()) * C_SPARSE_VOLUME_BRICK_VOXELS;
+            m_brickDistance[b] = (float)(sign * 0.5 * voxelSize);
+            bricks.push_back(b);
+        }
+        else if (distance[b] == INT_MAX)
+        {
+            m_brickDistance[b] = (float)(sign * diagonal);
+        }
+        else
+        {
+            m_brickDistance[b] = (float)(sign * ((distance[b] - 1) * C_SPARSE_VOLUME_BRICK_SIZE + 0.5) * voxelSize);
+        }
+    }
+    m_distances.resize(bricks.size() * C_SPARSE_VOLUME_BRICK_VOXELS);
+
+    // compute distances, in parallel
+    auto computeBricks = [&](const int a_first, const int a_last)
+    {
+        for (int i=a_first; i<a_last; i++)
+        {
+            int brick = bricks[i];
+            int bx = brick % numBricks[0] - 1;
+            int by = (brick / numBricks[0]) % numBricks[1] - 1;
+            int bz = brick / (numBricks[0] * numBricks[1]) - 1;
+            computeBrickDistances(bx, by, bz, &m_distances[m_distanceData[brick]]);
+        }
+    };
+
+    int numComputedBricks = (int)(bricks.size());
+    int numThreads = cMin(cMax(1, (int)(thread::hardware_concurrency())), cMax(1, numComputedBricks / 64));
+    vector<thread> workers;
+    for (int t=1; t<numThreads; t++)
+    {
+        workers.push_back(thread(computeBricks, (t * numComputedBricks) / numThreads, ((t + 1) * numComputedBricks) / numThreads));
+    }
+    computeBricks(0, numComputedBricks / numThreads);
+    for (unsigned int t=0; t<workers.size(); t++)
+    {
+        workers[t].join();
+    }
+
+    return (true);
+}
+
+
+//==============================================================================
+/*!
+    This method deletes the signed distance field.
+*/
+//==============================================================================
+void cSparseVolume::clearDistanceField()
+{
+    m_distanceLevel = -1;
+    m_voxelSize.zero();
+    m_brickDistance.clear();
+    m_distanceData.clear();
+    m_distances.clear();
+}
+
+
+//==============================================================================
+/*!
+    This method computes the signed distances of the voxels of a brick, 
+    by Euclidean distance transforms of the inside and outside voxels of a
+    region extending \ref C_SPARSE_VOLUME_DISTANCE_BAND voxels around the 
+    brick. Distances are clamped to the band, beyond which the region may
+    miss closer voxels.
+
+    \param  a_bx         X index of brick.
+    \param  a_by         Y index of brick.
+    \param  a_bz         Z index of brick.
+    \param  a_distances  Returned distances.
+*/
+//==============================================================================
+void cSparseVolume::computeBrickDistances(const int a_bx, const int a_by, const int a_bz, float* a_distances) const
+{
+    const int n = C_SPARSE_VOLUME_REGION;
+    const int band = C_SPARSE_VOLUME_DISTANCE_BAND;
+
+    // squared distances to nearest inside voxel and to nearest outside voxel
+    vector<double> toInside(n * n * n);
+    vector<double> toOutside(n * n * n);
+    vector<char> inside(n * n * n);
+
+    int x0 = (a_bx << C_SPARSE_VOLUME_BRICK_SHIFT) - band;
+    int y0 = (a_by << C_SPARSE_VOLUME_BRICK_SHIFT) - band;
+    int z0 = (a_bz << C_SPARSE_VOLUME_BRICK_SHIFT) - band;
+    for (int z=0; z<n; z++)
+    {
+        for (int y=0; y<n; y++)
+        {
+            for (int x=0; x<n; x++)
+            {
+                int v = x + n * (y + n * z);
+                inside[v] = (getLevel(x0 + x, y0 + y, z0 + z) >= m_distanceLevel);
+                toInside[v] = inside[v] ? 0.0 : C_SPARSE_VOLUME_FAR;
+                toOutside[v] = inside[v] ? C_SPARSE_VOLUME_FAR : 0.0;
+            }
+        }
+    }
+
+    // separable distance transforms along X, Y and Z
+    double f[C_SPARSE_VOLUME_REGION];
+    double d[C_SPARSE_VOLUME_REGION];
+    const int stride[3] = { 1, n, n * n };
+    for (int axis=0; axis<3; axis++)
+    {
+        int s1 = stride[(axis + 1) % 3];
+        int s2 = stride[(axis + 2) % 3];
+        for (vector<double>* grid : { &toInside, &toOutside })
+        {
+            for (int j=0; j<n; j++)
+            {
+                for (int i=0; i<n; i++)
+                {
+                    double* line = grid->data() + i * s1 + j * s2;
+                    for (int k=0; k<n; k++) { f[k] = line[k * stride[axis]]; }
+                    cDistanceTransform1d(f, d, n, m_voxelSize(axis));
+                    for (int k=0; k<n; k++) { line[k * stride[axis]] = d[k]; }
+                }
+            }
+        }
+    }
+
+    // signed distances of brick voxels
+    double voxelSize = cMin(m_voxelSize(0), cMin(m_voxelSize(1), m_voxelSize(2)));
+    double maxDistance = (band + 1) * voxelSize;
+    for (int z=0; z<C_SPARSE_VOLUME_BRICK_SIZE; z++)
+    {
+        for (int y=0; y<C_SPARSE_VOLUME_BRICK_SIZE; y++)
+        {
+            for (int x=0; x<C_SPARSE_VOLUME_BRICK_SIZE; x++)
+            {
+                int v = (x + band) + n * ((y + band) + n * (z + band));
+                double distance;
+                if (inside[v])
+                {
+                    distance = -(cMin(sqrt(toOutside[v]), maxDistance) - 0.5 * voxelSize);
+                }
+                else
+                {
+                    distance = cMin(sqrt(toInside[v]), maxDistance) - 0.5 * voxelSize;
+                }
+                a_distances[getVoxelOffset(x, y, z)] = (float)distance;
+            }
+        }
+    }
+}
+
+
+//==============================================================================
+/*!
+    This method returns the signed distance to the isosurface (negative 
+    inside) at a position given in voxel coordinates, where voxel centers
+    have integer coordinates. Distances between voxel centers are 
+    interpolated trilinearly, and the gradient is that of the interpolation.
+    Outside of the distance field, a lower bound of the distance is returned.
+
+    \param  a_voxelPos  Position in voxel coordinates.
+    \param  a_gradient  Returned gradient of the distance, in local units.
+
+    \return Signed distance, in local units.
+*/
+//==============================================================================
+double cSparseVolume::getDistance(const cVector3d& a_voxelPos, cVector3d& a_gradient) const
+{
+    if (!getHasDistanceField())
+    {
+        a_gradient.zero();
+        return (C_LARGE);
+    }
+
+    // clamp position to the box of voxel centers of the distance field
+    int i0[3], i1[3];
+    double t[3];
+    cVector3d offset;
+    for (int i=0; i<3; i++)
+    {
+        int last = m_size[i] - 1 + C_SPARSE_VOLUME_BRICK_SIZE;
+        double p = cClamp(a_voxelPos(i), (double)(-C_SPARSE_VOLUME_BRICK_SIZE), (double)last);
+        offset(i) = (a_voxelPos(i) - p) * m_voxelSize(i);
+        i0[i] = cMin((int)floor(p), last);
+        i1[i] = cMin(i0[i] + 1, last);
+        t[i] = p - i0[i];
+    }
+
+    // trilinear interpolation
+    double d000 = getVoxelDistance(i0[0], i0[1], i0[2]);
+    double d100 = getVoxelDistance(i1[0], i0[1], i0[2]);
+    double d010 = getVoxelDistance(i0[0], i1[1], i0[2]);
+    double d110 = getVoxelDistance(i1[0], i1[1], i0[2]);
+    double d001 = getVoxelDistance(i0[0], i0[1], i1[2]);
+    double d101 = getVoxelDistance(i1[0], i0[1], i1[2]);
+    double d011 = getVoxelDistance(i0[0], i1[1], i1[2]);
+    double d111 = getVoxelDistance(i1[0], i1[1], i1[2]);
+
+    double d00 = d000 + t[0] * (d100 - d000);
+    double d10 = d010 + t[0] * (d110 - d010);
+    double d01 = d001 + t[0] * (d101 - d001);
+    double d11 = d011 + t[0] * (d111 - d011);
+    double d0 = d00 + t[1] * (d10 - d00);
+    double d1 = d01 + t[1] * (d11 - d01);
+    double distance = d0 + t[2] * (d1 - d0);
+
+    double gx = (1.0 - t[1]) * (1.0 - t[2]) * (d100 - d000) + t[1] * (1.0 - t[2]) * (d110 - d010) +
+                (1.0 - t[1]) * t[2] * (d101 - d001) + t[1] * t[2] * (d111 - d011);
+    double gy = (1.0 - t[0]) * (1.0 - t[2]) * (d010 - d000) + t[0] * (1.0 - t[2]) * (d110 - d100) +
+                (1.0 - t[0]) * t[2] * (d011 - d001) + t[0] * t[2] * (d111 - d101);
+    double gz = d1 - d0;
+    a_gradient.set(gx / m_voxelSize(0), gy / m_voxelSize(1), gz / m_voxelSize(2));
+
+    // outside of the distance field, the surface lies at least the border
+    // (less half a voxel) away along each axis
+    double outside = offset.length();
+    if (outside > 0.0)
+    {
+        cVector3d toVolume;
+        for (int i=0; i<3; i++)
+        {
+            if (offset(i) != 0.0)
+            {
+                toVolume(i) = offset(i) + cSign(offset(i)) * (C_SPARSE_VOLUME_BRICK_SIZE - 0.5) * m_voxelSize(i);
+            }
+        }
+        double bound = toVolume.length();
+        distance = distance - outside;
+        if (bound > distance)
+        {
+            distance = bound;
+            a_gradient = (1.0 / bound) * toVolume;
+        }
+    }
+
+    return (distance);
+}
+
+
+//==============================================================================
+/*!
+    This method returns the memory used by the volume and its distance field.
+
+    \return Memory size in bytes.
+*/
+//==============================================================================
+unsigned int cSparseVolume::getMemorySize() const
+{
+    size_t size = sizeof(cSparseVolume);
+    size += m_brickMin.size() * sizeof(unsigned char);
+    size += m_brickMax.size() * sizeof(unsigned char);
+    size += m_brickData.size() * sizeof(int);
+    size += m_levels.size() * sizeof(unsigned char);
+    size += m_brickDistance.size() * sizeof(float);
+    size += m_distanceData.size() * sizeof(int);
+    size += m_distances.size() * sizeof(float);
+    return ((unsigned int)size);
+}
+
+
+//------------------------------------------------------------------------------
+} // namespace chai3d
+//------------------------------------------------------------------------------
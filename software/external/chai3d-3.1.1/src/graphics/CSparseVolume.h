@@ -0,0 +1,335 @@
+//==============================================================================
+/*
+    Software License Agreement (BSD License)
+    Copyright (c) 2003-2016, CHAI3D.
+    (www.chai3d.org)
+
+    All rights reserved.
+
+    Redistribution and use in source and binary forms, with or without
+    modification, are permitted provided that the following conditions
+    are met:
+
+    * Redistributions of source code must retain the above copyright
+    notice, this list of conditions and the following disclaimer.
+
+    * Redistributions in binary form must reproduce the above
+    copyright notice, this list of conditions and the following
+    disclaimer in the documentation and/or other materials provided
+    with the distribution.
+
+    * Neither the name of CHAI3D nor the names of its contributors may
+    be used to endorse or promote products derived from this software
+    without specific prior written permission.
+
+    THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS
+    "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT
+    LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS
+    FOR A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE
+    COPYRIGHT OWNER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT,
+    INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING,
+    BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES;
+    LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER
+    CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT
+    LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN
+    ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE
+    POSSIBILITY OF SUCH DAMAGE. 
+
+    \author    <http://www.chai3d.org>
+    \version   3.1.1 $Rev: 1869 $
+*/
+//==============================================================================
+
+//------------------------------------------------------------------------------
+#ifndef CSparseVolumeH
+#define CSparseVolumeH
+//------------------------------------------------------------------------------
+#include "graphics/CImage.h"
+#include "math/CVector3d.h"
+//------------------------------------------------------------------------------
+#include <vector>
+//------------------------------------------------------------------------------
+
+//------------------------------------------------------------------------------
+namespace chai3d {
+//------------------------------------------------------------------------------
+
+//==============================================================================
+/*!
+    \file       CSparseVolume.h
+
+    \brief
+    Implements a sparse, brick-based voxel volume with an optional signed 
+    distance field.
+*/
+//==============================================================================
+
+//------------------------------------------------------------------------------
+//! Base-2 logarithm of the size of a brick along each axis.
+const int C_SPARSE_VOLUME_BRICK_SHIFT = 3;
+
+//! Size of a brick along each axis, in voxels.
+const int C_SPARSE_VOLUME_BRICK_SIZE = (1 << C_SPARSE_VOLUME_BRICK_SHIFT);
+
+//! Number of voxels in a brick.
+const int C_SPARSE_VOLUME_BRICK_VOXELS = (C_SPARSE_VOLUME_BRICK_SIZE * C_SPARSE_VOLUME_BRICK_SIZE * C_SPARSE_VOLUME_BRICK_SIZE);
+
+//! Distance (in voxels) up to which the distance field is exact around the surface.
+const int C_SPARSE_VOLUME_DISTANCE_BAND = C_SPARSE_VOLUME_BRICK_SIZE;
+//------------------------------------------------------------------------------
+
+//==============================================================================
+/*!
+    \class      cSparseVolume
+    \ingroup    graphics
+
+    \brief
+    This class implements a sparse, brick-based voxel volume with an optional
+    signed distance field.
+
+    \details
+    cSparseVolume stores the level (alpha channel) of the voxels of a 3D 
+    image in bricks of \ref C_SPARSE_VOLUME_BRICK_SIZE voxels along each 
+    axis. A brick table holds the minimum and maximum level of every brick;
+    bricks of uniform level (typically the empty space around a scanned 
+    object) store no voxel data. Level lookups cost one table access, and 
+    the table allows whole regions of empty space to be skipped.\n\n
+
+    A signed distance field to the isosurface of a given level can then be
+    computed. The field covers the volume and a border of one brick on each
+    side of it. Distances are stored per voxel only for bricks which contain
+    or border the surface; every other brick stores a single, conservative
+    distance. Distance and gradient queries are O(1) trilinear lookups, 
+    which makes them suitable for the haptic thread.\n\n
+
+    Voxels are addressed relative to the origin of the volume, and voxels
+    outside of it are considered empty.\n\n
+
+    The sparse volume is a copy of the levels of the image, not a 
+    replacement for it: it does not reduce the memory used by the image 
+    itself, which is still needed for the colors of the voxels and for the
+    3D texture used by the GPU.
+*/
+//==============================================================================
+class cSparseVolume
+{
+    //--------------------------------------------------------------------------
+    // CONSTRUCTOR & DESTRUCTOR:
+    //--------------------------------------------------------------------------
+
+public:
+
+    //! Constructor of cSparseVolume.
+    cSparseVolume();
+
+    //! Destructor of cSparseVolume.
+    virtual ~cSparseVolume() {}
+
+
+    //--------------------------------------------------------------------------
+    // PUBLIC METHODS - VOXELS:
+    //--------------------------------------------------------------------------
+
+public:
+
+    //! This method builds the volume from a region of a 3D image.
+    bool build(cImage* a_image,
+               const int a_originX,
+               const int a_originY,
+               const int a_originZ,
+               const int a_sizeX,
+               const int a_sizeY,
+               const int a_sizeZ);
+
+    //! This method deletes all data of the volume.
+    void clear();
+
+    //! This method returns __true__ if the volume contains no voxels.
+    bool isEmpty() const { return (m_brickMin.empty()); }
+
+    //! This method returns the size of the volume along an axis, in voxels.
+    int getSize(const int a_axis) const { return (m_size[a_axis]); }
+
+    //! This method returns the origin of the volume in the source image along an axis, in voxels.
+    int getOrigin(const int a_axis) const { return (m_origin[a_axis]); }
+
+    //! This method returns the level of a voxel.
+    inline unsigned char getLevel(const int a_x, const int a_y, const int a_z) const
+    {
+        if (((unsigned int)a_x >= (unsigned int)m_size[0]) ||
+            ((unsigned int)a_y >= (unsigned int)m_size[1]) ||
+            ((unsigned int)a_z >= (unsigned int)m_size[2]))
+        {
+            return (0);
+        }
+
+        int brick = getBrickIndex(a_x >> C_SPARSE_VOLUME_BRICK_SHIFT,
+                                  a_y >> C_SPARSE_VOLUME_BRICK_SHIFT,
+                                  a_z >> C_SPARSE_VOLUME_BRICK_SHIFT);
+        int data = m_brickData[brick];
+        if (data < 0)
+        {
+            return (m_brickMin[brick]);
+        }
+        return (m_levels[data + getVoxelOffset(a_x, a_y, a_z)]);
+    }
+
+    //! This method returns the maximum level of all voxels in a box (bounds included), at brick resolution.
+    unsigned char getMaxLevel(const int a_minX, const int a_minY, const int a_minZ,
+                              const int a_maxX, const int a_maxY, const int a_maxZ) const;
+
+    //! This method computes the box enclosing all voxels of level greater or equal to a threshold, at brick resolution.
+    bool getOccupiedBounds(const int a_level, int a_min[3], int a_max[3]) const;
+
+
+    //--------------------------------------------------------------------------
+    // PUBLIC METHODS - DISTANCE FIELD:
+    //--------------------------------------------------------------------------
+
+public:
+
+    //! This method computes the signed distance field to the isosurface of a level.
+    bool computeDistanceField(const int a_level, const cVector3d& a_voxelSize);
+
+    //! This method deletes the signed distance field.
+    void clearDistanceField();
+
+    //! This method returns __true__ if a signed distance field is available.
+    bool getHasDistanceField() const { return (!m_brickDistance.empty()); }
+
+    //! This method returns the level of the isosurface of the signed distance field.
+    int getDistanceFieldLevel() const { return (m_distanceLevel); }
+
+    //! This method returns the voxel size used by the signed distance field.
+    cVector3d getDistanceFieldVoxelSize() const { return (m_voxelSize); }
+
+    //! This method returns the distance to the isosurface below which interpolated distances are exact.
+    double getDistanceFieldRange() const { return ((C_SPARSE_VOLUME_DISTANCE_BAND - 2) * cMin(m_voxelSize(0), cMin(m_voxelSize(1), m_voxelSize(2)))); }
+
+    //! This method returns the signed distance (negative inside) and its gradient at a position given in voxel coordinates.
+    double getDistance(const cVector3d& a_voxelPos, cVector3d& a_gradient) const;
+
+
+    //--------------------------------------------------------------------------
+    // PUBLIC METHODS - STATISTICS:
+    //--------------------------------------------------------------------------
+
+public:
+
+    //! This method returns the number of bricks of the volume.
+    int getNumBricks() const { return ((int)(m_brickMin.size())); }
+
+    //! This method returns the number of bricks storing voxel levels.
+    int getNumLevelBricks() const { return ((int)(m_levels.size()) / C_SPARSE_VOLUME_BRICK_VOXELS); }
+
+    //! This method returns the number of bricks storing voxel distances.
+    int getNumDistanceBricks() const { return ((int)(m_distances.size()) / C_SPARSE_VOLUME_BRICK_VOXELS); }
+
+    //! This method returns the memory used by the volume, in bytes.
+    unsigned int getMemorySize() const;
+
+
+    //--------------------------------------------------------------------------
+    // PROTECTED METHODS:
+    //--------------------------------------------------------------------------
+
+protected:
+
+    //! This method returns the index of a brick in the brick table.
+    inline int getBrickIndex(const int a_bx, const int a_by, const int a_bz) const
+    {
+        return (a_bx + m_numBricks[0] * (a_by + m_numBricks[1] * a_bz));
+    }
+
+    //! This method returns the offset of a voxel within its brick.
+    static inline int getVoxelOffset(const int a_x, const int a_y, const int a_z)
+    {
+        const int mask = C_SPARSE_VOLUME_BRICK_SIZE - 1;
+        return ((a_x & mask) + 
+                ((a_y & mask) << C_SPARSE_VOLUME_BRICK_SHIFT) + 
+                ((a_z & mask) << (2 * C_SPARSE_VOLUME_BRICK_SHIFT)));
+    }
+
+    //! This method returns the index of a brick in the distance field, which has a border of one brick.
+    inline int getDistanceBrickIndex(const int a_bx, const int a_by, const int a_bz) const
+    {
+        return ((a_bx + 1) + (m_numBricks[0] + 2) * ((a_by + 1) + (m_numBricks[1] + 2) * (a_bz + 1)));
+    }
+
+    //! This method returns the signed distance stored at the center of a voxel (border of distance field included).
+    inline float getVoxelDistance(const int a_x, const int a_y, const int a_z) const
+    {
+        int brick = getDistanceBrickIndex(((a_x + C_SPARSE_VOLUME_BRICK_SIZE) >> C_SPARSE_VOLUME_BRICK_SHIFT) - 1,
+                                          ((a_y + C_SPARSE_VOLUME_BRICK_SIZE) >> C_SPARSE_VOLUME_BRICK_SHIFT) - 1,
+                                          ((a_z + C_SPARSE_VOLUME_BRICK_SIZE) >> C_SPARSE_VOLUME_BRICK_SHIFT) - 1);
+        int data = m_distanceData[brick];
+        if (data < 0)
+        {
+            return (m_brickDistance[brick]);
+        }
+        return (m_distances[data + getVoxelOffset(a_x, a_y, a_z)]);
+    }
+
+    //! This method computes the distances of the voxels of a brick.
+    void computeBrickDistances(const int a_bx, const int a_by, const int a_bz, float* a_distances) const;
+
+
+    //--------------------------------------------------------------------------
+    // PROTECTED MEMBERS:
+    //--------------------------------------------------------------------------
+
+protected:
+
+    //! Size of volume along each axis, in voxels.
+    int m_size[3];
+
+    //! Origin of volume in source image, in voxels.
+    int m_origin[3];
+
+    //! Number of bricks along each axis.
+    int m_numBricks[3];
+
+    //! Minimum level of each brick.
+    std::vector<unsigned char> m_brickMin;
+
+    //! Maximum level of each brick.
+    std::vector<unsigned char> m_brickMax;
+
+    //! Offset of the levels of each brick in \ref m_levels, or -1 if the brick is uniform.
+    std::vector<int> m_brickData;
+
+    //! Levels of all non-uniform bricks.
+    std::vector<unsigned char> m_levels;
+
+    //! Threshold of last call to \ref getOccupiedBounds() (-1 if none).
+    mutable int m_boundsLevel;
+
+    //! If __true__, then voxels were found by last call to \ref getOccupiedBounds().
+    mutable bool m_boundsFound;
+
+    //! Box found by last call to \ref getOccupiedBounds().
+    mutable int m_bounds[6];
+
+    //! Level of isosurface of signed distance field.
+    int m_distanceLevel;
+
+    //! Voxel size used by signed distance field.
+    cVector3d m_voxelSize;
+
+    //! Distance of every voxel of each brick of the distance field without distance data (conservative).
+    std::vector<float> m_brickDistance;
+
+    //! Offset of the distances of each brick of the distance field in \ref m_distances, or -1 if the brick has none.
+    std::vector<int> m_distanceData;
+
+    //! Distances of all bricks containing or bordering the surface.
+    std::vector<float> m_distances;
+};
+
+//------------------------------------------------------------------------------
+} // namespace chai3d
+//------------------------------------------------------------------------------
+
+//------------------------------------------------------------------------------
+#endif
+//------------------------------------------------------------------------------
@@ -0,0 +1,377 @@
+//==============================================================================
+/*
+    Software License Agreement (BSD License)
+    Copyright (c) 2003-2016, CHAI3D.
+    (www.chai3d.org)
+
+    All rights reserved.
+
+    Redistribution and use in source and binary forms, with or without
+    modification, are permitted provided that the following conditions
+    are met:
+
+    * Redistributions of source code must retain the above copyright
+    notice, this list of conditions and the following disclaimer.
+
+    * Redistributions in binary form must reproduce the above
+    copyright notice, this list of conditions and the following
+    disclaimer in the documentation and/or other materials provided
+    with the distribution.
+
+    * Neither the name of CHAI3D nor the names of its contributors may
+    be used to endorse or promote products derived from this software
+    without specific prior written permission.
+
+    THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS
+    "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT
+    LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS
+    FOR A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE
+    COPYRIGHT OWNER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT,
+    INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING,
+    BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES;
+    LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER
+    CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT
+    LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN
+    ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE
+    POSSIBILITY OF SUCH DAMAGE. 
+
+
+    \author    <http://www.chai3d.org>
+    \version   3.1.1 $Rev: 1869 $
+*/
+//==============================================================================
+
+//------------------------------------------------------------------------------
+#include "graphics/CTextBatch.h"
+//------------------------------------------------------------------------------
+#ifdef C_USE_OPENGL
+#include "graphics/COpenGLHeaders.h"
+#endif
+//------------------------------------------------------------------------------
+#include <cstring>
+//------------------------------------------------------------------------------
+using namespace std;
+//------------------------------------------------------------------------------
+
+//------------------------------------------------------------------------------
+namespace chai3d {
+//------------------------------------------------------------------------------
+
+//------------------------------------------------------------------------------
+#ifndef DOXYGEN_SHOULD_SKIP_THIS
+//------------------------------------------------------------------------------
+
+// number of values per vertex in the vertex buffer: position (3), texture coordinates (2), color (4)
+static const int C_TEXT_BATCH_VERTEX_SIZE = 9;
+
+//------------------------------------------------------------------------------
+#endif  // DOXYGEN_SHOULD_SKIP_THIS
+//------------------------------------------------------------------------------
+
+
+//==============================================================================
+/*!
+    Constructor of cTextBatch.
+*/
+//==============================================================================
+cTextBatch::cTextBatch()
+{
+    m_numPendingTexts = 0;
+    m_numTextsRendered = 0;
+    m_numDrawCallsRendered = 0;
+    m_numBufferUpdates = 0;
+}
+
+
+//==============================================================================
+/*!
+    Destructor of cTextBatch.
+*/
+//==============================================================================
+cTextBatch::~cTextBatch()
+{
+}
+
+
+//==============================================================================
+/*!
+    This method prepares the batch for a new rendering pass. If OpenGL 
+    objects are marked for update, all vertex buffers are recreated.
+
+    \param  a_options  Rendering options.
+*/
+//==============================================================================
+void cTextBatch::begin(cRenderOptions& a_options)
+{
+    if (!a_options.m_markForUpdate) { return; }
+
+    for (unsigned int i=0; i<m_groups.size(); i++)
+    {
+        m_groups[i].m_drawn.clear();
+        m_groups[i].m_vertexBuffer = (GLuint)(-1);
+    }
+}
+
+
+//==============================================================================
+/*!
+    This method adds a string of text to the batch. The string is positioned
+    by the current OpenGL modelview matrix, and drawn with its font and color
+    when \ref render() is called. The vertices must remain valid until then.
+
+    \param  a_font      Font of the string.
+    \param  a_owner     Object owning the string.
+    \param  a_revision  Revision of the vertices, changed by the owner whenever they are modified.
+    \param  a_vertices  Glyph quads, as created by \ref cFont::createTextVertices().
+    \param  a_color     Color of the string.
+    \param  a_options   Rendering options.
+
+    \return __true__ if the string was added, __false__ if it must be rendered directly.
+*/
+//==============================================================================
+bool cTextBatch::add(cFont* a_font,
+                     const void* a_owner,
+                     const unsigned int a_revision,
+                     const vector<float>& a_vertices,
+                     const cColorf& a_color,
+                     const cRenderOptions& a_options)
+{
+#ifdef C_USE_OPENGL
+    if ((a_font == NULL) || (a_font->m_texture == nullptr) || a_options.m_creating_shadow_map)
+    {
+        return (false);
+    }
+
+    // nothing to draw
+    if (a_vertices.size() == 0) { return (true); }
+
+    cTextBatchEntry entry;
+    entry.m_owner = a_owner;
+    entry.m_revision = a_revision;
+    entry.m_vertices = &a_vertices;
+    glGetFloatv(GL_MODELVIEW_MATRIX, entry.m_modelView);
+    for (int i=0; i<4; i++)
+    {
+        entry.m_color[i] = a_color[i];
+    }
+
+    // find group of font
+    unsigned int index = 0;
+    while ((index < m_groups.size()) && (m_groups[index].m_font != a_font))
+    {
+        index++;
+    }
+
+    if (index == m_groups.size())
+    {
+        cTextBatchGroup group;
+        group.m_font = a_font;
+        group.m_vertexBuffer = (GLuint)(-1);
+        group.m_numVertices = 0;
+        m_groups.push_back(group);
+    }
+
+    m_groups[index].m_pending.push_back(entry);
+    m_numPendingTexts++;
+
+    return (true);
+#else
+    return (false);
+#endif
+}
+
+
+//==============================================================================
+/*!
+    This method returns __true__ if the strings added to a group during the 
+    current pass are identical, and in the same order, to the strings drawn
+    by the previous pass.
+
+    \param  a_group  Group of strings.
+
+    \return __true__ if the vertex buffer of the group is up to date, __false__ otherwise.
+*/
+//==============================================================================
+bool cTextBatch::isUnchanged(const cTextBatchGroup& a_group) const
+{
+    if (a_group.m_vertexBuffer == (GLuint)(-1)) { return (false); }
+    if (a_group.m_pending.size() != a_group.m_drawn.size()) { return (false); }
+
+    for (unsigned int i=0; i<a_group.m_pending.size(); i++)
+    {
+        const cTextBatchEntry& a = a_group.m_pending[i];
+        const cTextBatchEntry& b = a_group.m_drawn[i];
+
+        if ((a.m_owner != b.m_owner) ||
+            (a.m_revision != b.m_revision) ||
+            (memcmp(a.m_modelView, b.m_modelView, sizeof(a.m_modelView)) != 0) ||
+            (memcmp(a.m_color, b.m_color, sizeof(a.m_color)) != 0))
+        {
+            return (false);
+        }
+    }
+
+    return (true);
+}
+
+
+//==============================================================================
+/*!
+    This method transforms the glyph quads of the strings added to a group 
+    into eye coordinates, and uploads them with their color to the vertex 
+    buffer of the group.
+
+    \param  a_group  Group of strings.
+*/
+//==============================================================================
+void cTextBatch::updateGroup(cTextBatchGroup& a_group)
+{
+#ifdef C_USE_OPENGL
+    vector<GLfloat>& v = a_group.m_staging;
+    v.clear();
+
+    for (unsigned int i=0; i<a_group.m_pending.size(); i++)
+    {
+        const cTextBatchEntry& entry = a_group.m_pending[i];
+        const GLfloat* m = entry.m_modelView;
+        const vector<float>& vertices = *(entry.m_vertices);
+
+        for (unsigned int j=0; j+C_FONT_VERTEX_SIZE<=vertices.size(); j+=C_FONT_VERTEX_SIZE)
+        {
+            GLfloat x = vertices[j];
+            GLfloat y = vertices[j+1];
+            GLfloat vertex[C_TEXT_BATCH_VERTEX_SIZE] =
+            {
+                m[0] * x + m[4] * y + m[12],
+                m[1] * x + m[5] * y + m[13],
+                m[2] * x + m[6] * y + m[14],
+                vertices[j+2],
+                vertices[j+3],
+                entry.m_color[0],
+                entry.m_color[1],
+                entry.m_color[2],
+                entry.m_color[3]
+            };
+            v.insert(v.end(), vertex, vertex + C_TEXT_BATCH_VERTEX_SIZE);
+        }
+    }
+
+    a_group.m_numVertices = (GLsizei)(v.size() / C_TEXT_BATCH_VERTEX_SIZE);
+
+    if (a_group.m_vertexBuffer == (GLuint)(-1))
+    {
+        glGenBuffers(1, &a_group.m_vertexBuffer);
+    }
+    glBindBuffer(GL_ARRAY_BUFFER, a_group.m_vertexBuffer);
+    glBufferData(GL_ARRAY_BUFFER, v.size() * sizeof(GLfloat), &(v[0]), GL_DYNAMIC_DRAW);
+
+    m_numBufferUpdates++;
+#endif
+}
+
+
+//==============================================================================
+/*!
+    This method draws all strings added to the batch since the last call,
+    and clears the batch. Each font is drawn with a single draw call, and 
+    its vertex buffer is only updated if its strings have changed since 
+    the previous pass.
+
+    \param  a_options  Rendering options.
+*/
+//==============================================================================
+void cTextBatch::render(cRenderOptions& a_options)
+{
+    m_numTextsRendered = 0;
+    m_numDrawCallsRendered = 0;
+    m_numBufferUpdates = 0;
+    if (m_numPendingTexts == 0) { return; }
+
+#ifdef C_USE_OPENGL
+
+    /////////////////////////////////////////////////////////////////////////
+    // INITIALIZATION
+    /////////////////////////////////////////////////////////////////////////
+
+    // vertices are already in eye coordinates
+    glMatrixMode(GL_MODELVIEW);
+    glPushMatrix();
+    glLoadIdentity();
+
+    glDisable(GL_LIGHTING);
+    glEnable(GL_BLEND);
+    glBlendFunc(GL_SRC_ALPHA, GL_ONE_MINUS_SRC_ALPHA);
+    glNormal3d(0.0, 0.0, 1.0);
+
+    GLsizei stride = C_TEXT_BATCH_VERTEX_SIZE * sizeof(GLfloat);
+    glEnableClientState(GL_VERTEX_ARRAY);
+    glEnableClientState(GL_COLOR_ARRAY);
+    glDisableClientState(GL_NORMAL_ARRAY);
+
+
+    /////////////////////////////////////////////////////////////////////////
+    // RENDER STRINGS
+    /////////////////////////////////////////////////////////////////////////
+
+    for (unsigned int i=0; i<m_groups.size(); i++)
+    {
+        cTextBatchGroup& group = m_groups[i];
+        if (group.m_pending.size() == 0)
+        {
+            group.m_drawn.clear();
+            continue;
+        }
+
+        // update vertex buffer if strings have changed
+        if (isUnchanged(group))
+        {
+            glBindBuffer(GL_ARRAY_BUFFER, group.m_vertexBuffer);
+        }
+        else
+        {
+            updateGroup(group);
+            group.m_drawn.swap(group.m_pending);
+        }
+        m_numTextsRendered += (unsigned int)(group.m_pending.size());
+        group.m_pending.clear();
+
+        // bind font texture
+        cTexture2d* texture = group.m_font->m_texture;
+        texture->renderInitialize(a_options);
+        texture->setEnvironmentMode(GL_MODULATE);
+
+        glVertexPointer(3, GL_FLOAT, stride, 0);
+        glColorPointer(4, GL_FLOAT, stride, (void*)(5 * sizeof(GLfloat)));
+        glClientActiveTexture(texture->getTextureUnit());
+        glEnableClientState(GL_TEXTURE_COORD_ARRAY);
+        glTexCoordPointer(2, GL_FLOAT, stride, (void*)(3 * sizeof(GLfloat)));
+
+        // draw all strings of font
+        glDrawArrays(GL_QUADS, 0, group.m_numVertices);
+        m_numDrawCallsRendered++;
+
+        glDisableClientState(GL_TEXTURE_COORD_ARRAY);
+        glClientActiveTexture(GL_TEXTURE0);
+        texture->renderFinalize(a_options);
+    }
+
+
+    /////////////////////////////////////////////////////////////////////////
+    // FINALIZATION
+    /////////////////////////////////////////////////////////////////////////
+
+    glBindBuffer(GL_ARRAY_BUFFER, 0);
+    glDisableClientState(GL_VERTEX_ARRAY);
+    glDisableClientState(GL_COLOR_ARRAY);
+    glDisable(GL_BLEND);
+    glEnable(GL_LIGHTING);
+    glPopMatrix();
+
+    m_numPendingTexts = 0;
+
+#endif
+}
+
+//------------------------------------------------------------------------------
+} // namespace chai3d
+//------------------------------------------------------------------------------
@@ -0,0 +1,217 @@
+//==============================================================================
+/*
+    Software License Agreement (BSD License)
+    Copyright (c) 2003-2016, CHAI3D.
+    (www.chai3d.org)
+
+    All rights reserved.
+
+    Redistribution and use in source and binary forms, with or without
+    modification, are permitted provided that the following conditions
+    are met:
+
+    * Redistributions of source code must retain the above copyright
+    notice, this list of conditions and the following disclaimer.
+
+    * Redistributions in binary form must reproduce the above
+    copyright notice, this list of conditions and the following
+    disclaimer in the documentation and/or other materials provided
+    with the distribution.
+
+    * Neither the name of CHAI3D nor the names of its contributors may
+    be used to endorse or promote products derived from this software
+    without specific prior written permission.
+
+    THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS
+    "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT
+    LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS
+    FOR A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE
+    COPYRIGHT OWNER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT,
+    INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING,
+    BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES;
+    LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER
+    CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT
+    LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN
+    ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE
+    POSSIBILITY OF SUCH DAMAGE. 
+
+
+    \author    <http://www.chai3d.org>
+    \version   3.1.1 $Rev: 1869 $
+*/
+//==============================================================================
+
+//------------------------------------------------------------------------------
+#ifndef CTextBatchH
+#define CTextBatchH
+//------------------------------------------------------------------------------
+#include "graphics/CFont.h"
+#include "graphics/CRenderOptions.h"
+//------------------------------------------------------------------------------
+#include <vector>
+//------------------------------------------------------------------------------
+
+//------------------------------------------------------------------------------
+namespace chai3d {
+//------------------------------------------------------------------------------
+
+//==============================================================================
+/*!
+    \file       CTextBatch.h
+
+    \brief
+    Implements batched rendering of text.
+*/
+//==============================================================================
+
+//==============================================================================
+/*!
+    \class      cTextBatch
+    \ingroup    graphics
+
+    \brief
+    This class implements batched rendering of text.
+
+    \details
+    cTextBatch collects strings of text, laid out as glyph quads by 
+    \ref cFont::createTextVertices(), while the scene graph is traversed, and 
+    draws them once traversal is completed. \n
+
+    Strings are grouped by font. The quads of all strings sharing a font 
+    are transformed by the modelview matrix of their object, stored in a 
+    single vertex buffer, and drawn by a single draw call. Each string is 
+    identified by its owner and a revision number that the owner increments
+    whenever the quads change. If a font is used by the same strings, with 
+    the same revisions, matrices and colors as in the previous pass, its 
+    vertex buffer is drawn again without being updated. \n
+
+    Batching is enabled for a world by calling 
+    \ref cWorld::setUseTextBatching().
+*/
+//==============================================================================
+class cTextBatch
+{
+    //--------------------------------------------------------------------------
+    // CONSTRUCTOR & DESTRUCTOR:
+    //--------------------------------------------------------------------------
+
+public:
+
+    //! Constructor of cTextBatch.
+    cTextBatch();
+
+    //! Destructor of cTextBatch.
+    virtual ~cTextBatch();
+
+
+    //--------------------------------------------------------------------------
+    // PUBLIC METHODS:
+    //--------------------------------------------------------------------------
+
+public:
+
+    //! This method prepares the batch for a new rendering pass.
+    void begin(cRenderOptions& a_options);
+
+    //! This method adds a string of text to the batch, using the current OpenGL modelview matrix.
+    bool add(cFont* a_font,
+             const void* a_owner,
+             const unsigned int a_revision,
+             const std::vector<float>& a_vertices,
+             const cColorf& a_color,
+             const cRenderOptions& a_options);
+
+    //! This method draws and clears all strings added to the batch.
+    void render(cRenderOptions& a_options);
+
+    //! This method returns __true__ if the batch contains strings that are not yet drawn.
+    bool isEmpty() const { return (m_numPendingTexts == 0); }
+
+    //! This method returns the number of strings drawn by the last call to \ref render().
+    unsigned int getNumTextsRendered() const { return (m_numTextsRendered); }
+
+    //! This method returns the number of draw calls issued by the last call to \ref render().
+    unsigned int getNumDrawCallsRendered() const { return (m_numDrawCallsRendered); }
+
+    //! This method returns the number of vertex buffers updated by the last call to \ref render().
+    unsigned int getNumBufferUpdates() const { return (m_numBufferUpdates); }
+
+
+    //--------------------------------------------------------------------------
+    // PROTECTED TYPES:
+    //--------------------------------------------------------------------------
+
+#ifndef DOXYGEN_SHOULD_SKIP_THIS
+
+protected:
+
+    //! String of text added to the batch.
+    struct cTextBatchEntry
+    {
+        const void* m_owner;
+        unsigned int m_revision;
+        GLfloat m_modelView[16];
+        GLfloat m_color[4];
+        const std::vector<float>* m_vertices;
+    };
+
+    //! Strings of text that share a font.
+    struct cTextBatchGroup
+    {
+        cFont* m_font;
+        std::vector<cTextBatchEntry> m_pending;
+        std::vector<cTextBatchEntry> m_drawn;
+        std::vector<GLfloat> m_staging;
+        GLuint m_vertexBuffer;
+        GLsizei m_numVertices;
+    };
+
+#endif  // DOXYGEN_SHOULD_SKIP_THIS
+
+
+    //--------------------------------------------------------------------------
+    // PROTECTED METHODS:
+    //--------------------------------------------------------------------------
+
+protected:
+
+#ifndef DOXYGEN_SHOULD_SKIP_THIS
+    //! This method returns __true__ if the pending strings of a group are identical to the strings drawn previously.
+    bool isUnchanged(const cTextBatchGroup& a_group) const;
+
+    //! This method transforms the pending strings of a group and uploads them to its vertex buffer.
+    void updateGroup(cTextBatchGroup& a_group);
+#endif
+
+
+    //--------------------------------------------------------------------------
+    // PROTECTED MEMBERS:
+    //--------------------------------------------------------------------------
+
+protected:
+
+    //! Number of strings not yet drawn.
+    unsigned int m_numPendingTexts;
+
+    //! Number of strings drawn by the last call to render().
+    unsigned int m_numTextsRendered;
+
+    //! Number of draw calls issued by the last call to render().
+    unsigned int m_numDrawCallsRendered;
+
+    //! Number of vertex buffers updated by the last call to render().
+    unsigned int m_numBufferUpdates;
+
+#ifndef DOXYGEN_SHOULD_SKIP_THIS
+    //! Groups of strings, one per font.
+    std::vector<cTextBatchGroup> m_groups;
+#endif
+};
+
+//------------------------------------------------------------------------------
+} // namespace chai3d
+//------------------------------------------------------------------------------
+
+//------------------------------------------------------------------------------
+#endif
+//------------------------------------------------------------------------------
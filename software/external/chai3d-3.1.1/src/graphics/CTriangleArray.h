@@ -215,6 +215,39 @@ public:
     }
 
 
+    //--------------------------------------------------------------------------
+    /*!
+        This method creates a number of new triangles at the end of the array,
+        without using the free triangle list. The vertices of the new
+        triangles are initialized to zero and can be set by calling
+        \ref setVertices().
+
+        \param  a_numberOfTriangles  Number of triangles to create.
+
+        \return Index number of the first new triangle.
+    */
+    //--------------------------------------------------------------------------
+    int newTriangles(const unsigned int a_numberOfTriangles)
+    {
+        // sanity check
+        if (a_numberOfTriangles == 0) { return (-1); }
+
+        // store index of first new triangle
+        int index = (int)(m_allocated.size());
+
+        // allocate new triangles
+        m_indices.resize(m_indices.size() + 3 * a_numberOfTriangles, 0);
+        m_allocated.resize(m_allocated.size() + a_numberOfTriangles, true);
+
+        // mark for update
+        m_flagMarkForResize = true;
+        m_flagMarkForUpdate = true;
+
+        // return index of first new triangle
+        return (index);
+    }
+
+
     //--------------------------------------------------------------------------
     /*!
         This method deallocates a selected triangle from the array. The three 
@@ -103,6 +103,47 @@ public:
     bool m_useUserData; 
 };
 
+//==============================================================================
+/*!
+    \struct     cVertexArrayRange
+    \ingroup    graphics
+
+    \brief
+    This structure stores a range of vertex indices.
+*/
+//==============================================================================
+struct cVertexArrayRange
+{
+
+public:
+
+    cVertexArrayRange() { clear(); }
+
+    //! This method empties the range.
+    inline void clear() { m_first = 0xFFFFFFFF; m_last = 0; }
+
+    //! This method extends the range to include a vertex.
+    inline void add(const unsigned int a_index)
+    {
+        if (a_index < m_first) { m_first = a_index; }
+        if (a_index > m_last)  { m_last = a_index; }
+    }
+
+    //! This method extends the range to include a range of vertices. Empty ranges are ignored.
+    inline void add(const unsigned int a_first, const unsigned int a_last)
+    {
+        if (a_first > a_last) { return; }
+        add(a_first);
+        add(a_last);
+    }
+
+    //! This method returns __true__ if the range is empty.
+    inline bool isEmpty() const { return (m_first > m_last); }
+
+    unsigned int m_first;
+    unsigned int m_last;
+};
+
 //------------------------------------------------------------------------------
 class cVertexArray;
 typedef std::shared_ptr<cVertexArray> cVertexArrayPtr;
@@ -128,6 +169,21 @@ typedef std::shared_ptr<cVertexArray> cVertexArrayPtr;
     The properties of each vertex can be modified by calling the appropriate 
     methods and by passing the vertex index as argument with the associated
     data. \n
+
+    For rendering, vertex data is copied to OpenGL buffers. The methods which
+    modify a vertex record the range of modified vertices, so that only this
+    range is uploaded. Setting one of the public modification flags 
+    (e.g. \ref m_flagPositionData) instead uploads all vertices. \n
+
+    By calling \ref setUsePackedBuffers(), vertex data is uploaded in a 
+    compact layout instead: positions and texture coordinates are stored as 
+    single precision floats, colors as bytes, and normals, tangents and 
+    bitangents as normalized 10-bit integers. Positions and normals, which
+    change for deforming objects, are interleaved in one buffer, and the 
+    other properties in a second one. The first buffer is double buffered: 
+    when most vertices have changed, the data is streamed to the other 
+    buffer, so that OpenGL does not wait for the previous frame to be drawn. 
+    The number of bytes uploaded is counted by \ref getNumBytesUploaded(). \n
 */
 //==============================================================================
 class cVertexArray
@@ -164,12 +220,20 @@ public:
         m_flagBitangentData = false;
         m_flagUserData      = false;
         m_flagBufferResize  = true;
+        m_usePackedBuffers  = false;
+        m_packedBuffersActive = false;
+        m_bufferCapacity    = 0;
+        m_numBytesUploaded  = 0;
         m_positionBuffer    = (GLuint)(-1);
         m_normalBuffer      = (GLuint)(-1);
         m_texCoordBuffer    = (GLuint)(-1);
         m_colorBuffer       = (GLuint)(-1);
         m_tangentBuffer     = (GLuint)(-1);
         m_bitangentBuffer   = (GLuint)(-1);
+        m_packedDynamicBuffer[0] = (GLuint)(-1);
+        m_packedDynamicBuffer[1] = (GLuint)(-1);
+        m_packedDynamicIndex = 0;
+        m_packedStaticBuffer = (GLuint)(-1);
     }
 
 
@@ -234,6 +298,8 @@ public:
         m_userData.clear();
         m_numVertices = 0;
         m_flagBufferResize = true;
+        m_bufferCapacity = 0;
+        clearModifiedRanges();
     }
 
 
@@ -328,7 +394,7 @@ public:
                             const double& a_z)
     {
         m_localPos[a_vertexIndex].set(a_x, a_y, a_z);
-        m_flagPositionData = true;
+        m_modifiedPosition.add(a_vertexIndex);
     }
 
 
@@ -344,7 +410,7 @@ public:
                             const cVector3d& a_pos)
     {
         m_localPos[a_vertexIndex] = a_pos;
-        m_flagPositionData = true;
+        m_modifiedPosition.add(a_vertexIndex);
     }
 
 
@@ -361,7 +427,7 @@ public:
                           const cVector3d& a_translation)
     {
         m_localPos[a_vertexIndex].add(a_translation);
-        m_flagPositionData = true;
+        m_modifiedPosition.add(a_vertexIndex);
     }
 
 
@@ -409,7 +475,7 @@ public:
         if (m_useNormalData)
         {
             m_normal[a_vertexIndex] = a_normal;
-            m_flagNormalData = true;
+            m_modifiedNormal.add(a_vertexIndex);
         }
     }
 
@@ -432,7 +498,7 @@ public:
         if (m_useNormalData)
         {
             m_normal[a_vertexIndex].set(a_x, a_y, a_z);
-            m_flagNormalData = true;
+            m_modifiedNormal.add(a_vertexIndex);
         }
     }
 
@@ -465,7 +531,7 @@ public:
         if (m_useTexCoordData)
         {
             m_texCoord[a_vertexIndex] = a_texCoord;
-            m_flagTexCoordData = true;
+            m_modifiedTexCoord.add(a_vertexIndex);
         }
     }
 
@@ -489,7 +555,7 @@ public:
         if (m_useTexCoordData)
         {
             m_texCoord[a_vertexIndex].set(a_tx, a_ty,a_tz);
-            m_flagTexCoordData = true;
+            m_modifiedTexCoord.add(a_vertexIndex);
         }
     }
 
@@ -522,7 +588,7 @@ public:
         if (m_useColorData)
         {
             m_color[a_vertexIndex] = a_color;
-            m_flagColorData = true;
+            m_modifiedColor.add(a_vertexIndex);
         }
     }
 
@@ -548,7 +614,7 @@ public:
         if (m_useColorData)
         {
             m_color[a_vertexIndex].set(a_red, a_green, a_blue, a_alpha);
-            m_flagColorData = true;
+            m_modifiedColor.add(a_vertexIndex);
         }
     }
 
@@ -567,7 +633,7 @@ public:
         if (m_useColorData)
         {
             m_color[a_vertexIndex] = a_color.getColorf();
-            m_flagColorData = true;
+            m_modifiedColor.add(a_vertexIndex);
         }
     }
 
@@ -763,6 +829,82 @@ public:
     }
 
 
+    //--------------------------------------------------------------------------
+    /*!
+        This method enables or disables the packed layout of the OpenGL 
+        buffers (see class description). The packed layout requires 
+        OpenGL 3.3 or the ARB_vertex_type_2_10_10_10_rev extension; if they 
+        are not available, the default layout is used.
+
+        \param  a_usePackedBuffers  If __true__, then the packed layout is used.
+    */
+    //--------------------------------------------------------------------------
+    inline void setUsePackedBuffers(const bool a_usePackedBuffers)
+    {
+        if (a_usePackedBuffers != m_usePackedBuffers)
+        {
+            m_usePackedBuffers = a_usePackedBuffers;
+            m_flagBufferResize = true;
+        }
+    }
+
+
+    //--------------------------------------------------------------------------
+    /*!
+        This method returns __true__ if the packed layout of the OpenGL buffers
+        is enabled.
+
+        \return __true__ if the packed layout is enabled, __false__ otherwise.
+    */
+    //--------------------------------------------------------------------------
+    inline bool getUsePackedBuffers() const
+    {
+        return (m_usePackedBuffers);
+    }
+
+
+    //--------------------------------------------------------------------------
+    /*!
+        This method returns the number of bytes uploaded to OpenGL buffers by 
+        this vertex array since it was created or since the counter was reset
+        by calling \ref resetNumBytesUploaded().
+
+        \return Number of bytes uploaded.
+    */
+    //--------------------------------------------------------------------------
+    inline unsigned long long getNumBytesUploaded() const
+    {
+        return (m_numBytesUploaded);
+    }
+
+
+    //--------------------------------------------------------------------------
+    /*!
+        This method resets the counter of bytes uploaded to OpenGL buffers by
+        this vertex array.
+    */
+    //--------------------------------------------------------------------------
+    inline void resetNumBytesUploaded()
+    {
+        m_numBytesUploaded = 0;
+    }
+
+
+    //--------------------------------------------------------------------------
+    /*!
+        This method returns the number of bytes uploaded to OpenGL buffers by 
+        all vertex arrays since the application started. The difference 
+        between two frames gives the number of bytes uploaded per frame.
+
+        \return Number of bytes uploaded.
+    */
+    //--------------------------------------------------------------------------
+    static inline unsigned long long getTotalNumBytesUploaded()
+    {
+        return (totalNumBytesUploaded());
+    }
+
+
     //--------------------------------------------------------------------------
     /*!
         This method allocates or updates all OpenGL buffers.
@@ -771,6 +913,41 @@ public:
     inline void renderInitialize()
     { 
 #ifdef C_USE_OPENGL
+        // the packed layout requires normalized 10-bit integer attributes
+        bool packed = m_usePackedBuffers;
+#ifdef GLEW_VERSION
+        packed = packed && (GLEW_VERSION_3_3 || GLEW_ARB_vertex_type_2_10_10_10_rev);
+#endif
+        if (packed != m_packedBuffersActive)
+        {
+            m_packedBuffersActive = packed;
+            m_flagBufferResize = true;
+        }
+
+        // buffers are reallocated when cleared or too small. buffers grow
+        // geometrically so that vertices which are added one at a time
+        // (e.g. a scrolling point cloud) do not reallocate them every frame.
+        if (m_numVertices > m_bufferCapacity)
+        {
+            m_flagBufferResize = true;
+        }
+        if (m_flagBufferResize)
+        {
+            m_bufferCapacity = cMax<unsigned int>(m_numVertices, m_bufferCapacity + m_bufferCapacity / 2);
+            m_flagPositionData  = true;
+            m_flagNormalData    = m_useNormalData;
+            m_flagTexCoordData  = m_useTexCoordData;
+            m_flagColorData     = m_useColorData;
+            m_flagTangentData   = m_useTangentData;
+            m_flagBitangentData = m_useBitangentData;
+        }
+
+        if (m_packedBuffersActive)
+        {
+            renderInitializePacked();
+            return;
+        }
+
         // create buffers first time
         if (m_positionBuffer == (GLuint)(-1))
         {
@@ -808,79 +985,50 @@ public:
             if (true)
             {
                 glBindBuffer(GL_ARRAY_BUFFER, m_positionBuffer);
-                glBufferData(GL_ARRAY_BUFFER, m_numVertices * sizeof(cVector3d), &(m_localPos[0]), GL_STATIC_DRAW);
+                glBufferData(GL_ARRAY_BUFFER, m_bufferCapacity * sizeof(cVector3d), NULL, GL_STATIC_DRAW);
             }
 
             if (m_useNormalData)
             {
                 glBindBuffer(GL_ARRAY_BUFFER, m_normalBuffer);
-                glBufferData(GL_ARRAY_BUFFER, m_numVertices * sizeof(cVector3d), &(m_normal[0]), GL_STATIC_DRAW);
+                glBufferData(GL_ARRAY_BUFFER, m_bufferCapacity * sizeof(cVector3d), NULL, GL_STATIC_DRAW);
             }
 
             if (m_useTexCoordData)
             {
                 glBindBuffer(GL_ARRAY_BUFFER, m_texCoordBuffer);
-                glBufferData(GL_ARRAY_BUFFER, m_numVertices * sizeof(cVector3d), &(m_texCoord[0]), GL_STATIC_DRAW);
+                glBufferData(GL_ARRAY_BUFFER, m_bufferCapacity * sizeof(cVector3d), NULL, GL_STATIC_DRAW);
             }
 
             if (m_useColorData)
             {
                 glBindBuffer(GL_ARRAY_BUFFER, m_colorBuffer);
-                glBufferData(GL_ARRAY_BUFFER, m_numVertices * sizeof(cColorf), &(m_color[0]), GL_STATIC_DRAW);
+                glBufferData(GL_ARRAY_BUFFER, m_bufferCapacity * sizeof(cColorf), NULL, GL_STATIC_DRAW);
             }
 
             if (m_useTangentData)
             {
                 glBindBuffer(GL_ARRAY_BUFFER, m_tangentBuffer);
-                glBufferData(GL_ARRAY_BUFFER, m_numVertices * sizeof(cVector3d), &(m_tangent[0]), GL_STATIC_DRAW);
+                glBufferData(GL_ARRAY_BUFFER, m_bufferCapacity * sizeof(cVector3d), NULL, GL_STATIC_DRAW);
             }
         
             if (m_useBitangentData)
             {
                 glBindBuffer(GL_ARRAY_BUFFER, m_bitangentBuffer);
-                glBufferData(GL_ARRAY_BUFFER, m_numVertices * sizeof(cVector3d), &(m_bitangent[0]), GL_STATIC_DRAW);
+                glBufferData(GL_ARRAY_BUFFER, m_bufferCapacity * sizeof(cVector3d), NULL, GL_STATIC_DRAW);
             }
 
             m_flagBufferResize = false;
         }
 
-        // update buffers if needed
-        if (m_flagPositionData)
-        {
-            glBindBuffer(GL_ARRAY_BUFFER, m_positionBuffer);
-            glBufferSubData(GL_ARRAY_BUFFER, 0, m_numVertices * sizeof(cVector3d), &(m_localPos[0]));
-            m_flagPositionData = false;
-        }
-        if (m_flagNormalData)
-        {
-            glBindBuffer(GL_ARRAY_BUFFER, m_normalBuffer);
-            glBufferSubData(GL_ARRAY_BUFFER, 0, m_numVertices * sizeof(cVector3d), &(m_normal[0]));
-            m_flagNormalData = false;
-        }
-        if (m_flagTexCoordData)
-        {
-            glBindBuffer(GL_ARRAY_BUFFER, m_texCoordBuffer);
-            glBufferSubData(GL_ARRAY_BUFFER, 0, m_numVertices * sizeof(cVector3d), &(m_texCoord[0]));
-            m_flagTexCoordData = false;
-        }
-        if (m_flagColorData)
-        {
-            glBindBuffer(GL_ARRAY_BUFFER, m_colorBuffer);
-            glBufferSubData(GL_ARRAY_BUFFER, 0, m_numVertices * sizeof(cColorf), &(m_color[0]));
-            m_flagColorData = false;
-        }
-        if (m_flagTangentData)
-        {
-            glBindBuffer(GL_ARRAY_BUFFER, m_tangentBuffer);
-            glBufferSubData(GL_ARRAY_BUFFER, 0, m_numVertices * sizeof(cVector3d), &(m_tangent[0]));
-            m_flagTangentData = false;
-        }
-        if (m_flagBitangentData)
-        {
-            glBindBuffer(GL_ARRAY_BUFFER, m_bitangentBuffer);
-            glBufferSubData(GL_ARRAY_BUFFER, 0, m_numVertices * sizeof(cVector3d), &(m_bitangent[0]));
-            m_flagBitangentData = false;
-        }
+        // update modified ranges of buffers
+        updateBuffer(m_positionBuffer, m_localPos, m_flagPositionData, m_modifiedPosition);
+        if (m_useNormalData)    { updateBuffer(m_normalBuffer, m_normal, m_flagNormalData, m_modifiedNormal); }
+        if (m_useTexCoordData)  { updateBuffer(m_texCoordBuffer, m_texCoord, m_flagTexCoordData, m_modifiedTexCoord); }
+        if (m_useColorData)     { updateBuffer(m_colorBuffer, m_color, m_flagColorData, m_modifiedColor); }
+        if (m_useTangentData)   { updateBuffer(m_tangentBuffer, m_tangent, m_flagTangentData, m_modifiedTangent); }
+        if (m_useBitangentData) { updateBuffer(m_bitangentBuffer, m_bitangent, m_flagBitangentData, m_modifiedBitangent); }
+        clearModifiedRanges();
 
         // bind buffers and set client state
         {
@@ -949,7 +1097,6 @@ public:
 #endif
     }
 
-
     //--------------------------------------------------------------------------
     /*!
         This method finalizes rendering by disabling all OpenGL buffers.
@@ -989,8 +1136,23 @@ public:
                              const bool a_useBitangentData,
                              const bool a_useUserData)
     {
+        // buffers are reallocated if the set of attributes changes
+        if ((a_useNormalData != m_useNormalData) ||
+            (a_useTexCoordData != m_useTexCoordData) ||
+            (a_useColorData != m_useColorData) ||
+            (a_useTangentData != m_useTangentData) ||
+            (a_useBitangentData != m_useBitangentData))
+        {
+            m_flagBufferResize = true;
+        }
+
         // increment counter
+        unsigned int first = m_numVertices;
         m_numVertices = m_numVertices + a_numberOfVertices;
+        if (m_numVertices > first)
+        {
+            m_modifiedPosition.add(first, m_numVertices - 1);
+        }
 
         // update position data allocation
         cVector3d pos(0.0, 0.0, 0.0);
@@ -1010,7 +1172,10 @@ public:
             {
                 m_normal.push_back(normal);
             }
-            m_flagNormalData = true;
+            if (m_numVertices > first)
+            {
+                m_modifiedNormal.add(first, m_numVertices - 1);
+            }
         }
         else
         {
@@ -1030,7 +1195,10 @@ public:
             {
                 m_texCoord.push_back(texCoord);
             }
-            m_flagTexCoordData = true;
+            if (m_numVertices > first)
+            {
+                m_modifiedTexCoord.add(first, m_numVertices - 1);
+            }
         }
         else
         {
@@ -1050,7 +1218,10 @@ public:
             {
                 m_color.push_back(color);
             }
-            m_flagColorData = true;
+            if (m_numVertices > first)
+            {
+                m_modifiedColor.add(first, m_numVertices - 1);
+            }
         }
         else
         {
@@ -1070,7 +1241,10 @@ public:
             {
                 m_tangent.push_back(tangent);
             }
-            m_flagTangentData = true;
+            if (m_numVertices > first)
+            {
+                m_modifiedTangent.add(first, m_numVertices - 1);
+            }
         }
         else
         {
@@ -1090,7 +1264,10 @@ public:
             {
                 m_bitangent.push_back(bitangent);
             }
-            m_flagBitangentData = true;
+            if (m_numVertices > first)
+            {
+                m_modifiedBitangent.add(first, m_numVertices - 1);
+            }
         }
         else
         {
@@ -1116,11 +1293,299 @@ public:
         {
             m_userData.clear();
         }
+    }
 
-        // update buffer size
-        m_flagBufferResize = true;
+
+    //--------------------------------------------------------------------------
+    // PROTECTED METHODS:
+    //--------------------------------------------------------------------------
+
+#ifndef DOXYGEN_SHOULD_SKIP_THIS
+
+protected:
+
+    //! Vertex of the packed stream which is updated when the shape deforms.
+    struct cPackedDynamicVertex
+    {
+        GLfloat m_pos[3];
+        GLuint m_normal;
+    };
+
+    //! Vertex of the packed stream which rarely changes.
+    struct cPackedStaticVertex
+    {
+        GLfloat m_texCoord[3];
+        GLubyte m_color[4];
+        GLuint m_tangent;
+        GLuint m_bitangent;
+    };
+
+    //! This method clears the modified ranges of all attributes.
+    inline void clearModifiedRanges()
+    {
+        m_modifiedPosition.clear();
+        m_modifiedNormal.clear();
+        m_modifiedTexCoord.clear();
+        m_modifiedColor.clear();
+        m_modifiedTangent.clear();
+        m_modifiedBitangent.clear();
+    }
+
+    //! This method records a number of bytes uploaded to OpenGL.
+    inline void addNumBytesUploaded(const unsigned long long a_numBytes)
+    {
+        m_numBytesUploaded += a_numBytes;
+        totalNumBytesUploaded() += a_numBytes;
     }
 
+    //! This method returns the number of bytes uploaded by all vertex arrays.
+    static inline unsigned long long& totalNumBytesUploaded()
+    {
+        static unsigned long long s_numBytes = 0;
+        return (s_numBytes);
+    }
+
+    //! This method packs a unit vector into a signed normalized 10-10-10-2 integer.
+    static inline GLuint packVector(const cVector3d& a_vector)
+    {
+        GLuint result = 0;
+        for (int i=0; i<3; i++)
+        {
+            double v = cClamp(a_vector(i), -1.0, 1.0) * 511.0;
+            int p = (int)((v >= 0.0) ? (v + 0.5) : (v - 0.5));
+            result |= ((GLuint)p & 0x3FF) << (10 * i);
+        }
+        return (result);
+    }
+
+    //! This method uploads the modified range of an unpacked attribute.
+    template<class T> inline void updateBuffer(const GLuint a_buffer,
+                                               const std::vector<T>& a_data,
+                                               bool& a_flag,
+                                               cVertexArrayRange& a_range)
+    {
+#ifdef C_USE_OPENGL
+        if (m_numVertices == 0)
+        {
+            a_flag = false;
+            return;
+        }
+
+        unsigned int first = 0;
+        unsigned int last = m_numVertices - 1;
+        if (!a_flag)
+        {
+            if (a_range.isEmpty()) { return; }
+            first = a_range.m_first;
+            last = cMin(a_range.m_last, m_numVertices - 1);
+            if (first > last) { return; }
+        }
+
+        unsigned int size = (last - first + 1) * sizeof(T);
+        glBindBuffer(GL_ARRAY_BUFFER, a_buffer);
+        glBufferSubData(GL_ARRAY_BUFFER, first * sizeof(T), size, &(a_data[first]));
+        addNumBytesUploaded(size);
+        a_flag = false;
+#endif
+    }
+
+    //! This method allocates, updates and binds the packed OpenGL buffers.
+    inline void renderInitializePacked()
+    {
+#ifdef C_USE_OPENGL
+        // create buffers first time
+        if (m_packedDynamicBuffer[0] == (GLuint)(-1))
+        {
+            glGenBuffers(2, m_packedDynamicBuffer);
+        }
+        if (m_packedStaticBuffer == (GLuint)(-1))
+        {
+            glGenBuffers(1, &m_packedStaticBuffer);
+        }
+
+        bool useStatic = m_useTexCoordData || m_useColorData || m_useTangentData || m_useBitangentData;
+
+        // dynamic stream: positions and normals
+        cVertexArrayRange range;
+        range.add(m_modifiedPosition.m_first, m_modifiedPosition.m_last);
+        if (m_useNormalData) { range.add(m_modifiedNormal.m_first, m_modifiedNormal.m_last); }
+        bool full = m_flagPositionData || m_flagNormalData;
+        if (!range.isEmpty())
+        {
+            range.m_last = cMin(range.m_last, m_numVertices - 1);
+            full = full || (2 * (range.m_last - range.m_first + 1) >= m_numVertices);
+        }
+
+        if (m_flagBufferResize)
+        {
+            // both buffers of the stream must have the new capacity
+            for (int i=0; i<2; i++)
+            {
+                glBindBuffer(GL_ARRAY_BUFFER, m_packedDynamicBuffer[i]);
+                glBufferData(GL_ARRAY_BUFFER, m_bufferCapacity * sizeof(cPackedDynamicVertex), NULL, GL_STREAM_DRAW);
+            }
+        }
+        else if (full)
+        {
+            // large updates go to the other buffer, which is orphaned so that
+            // the driver does not wait for the frame that still draws from it
+            m_packedDynamicIndex = 1 - m_packedDynamicIndex;
+            glBindBuffer(GL_ARRAY_BUFFER, m_packedDynamicBuffer[m_packedDynamicIndex]);
+            glBufferData(GL_ARRAY_BUFFER, m_bufferCapacity * sizeof(cPackedDynamicVertex), NULL, GL_STREAM_DRAW);
+        }
+
+        if ((m_numVertices > 0) && (full || !range.isEmpty()))
+        {
+            unsigned int first = full ? 0 : range.m_first;
+            unsigned int last = full ? m_numVertices - 1 : range.m_last;
+            unsigned int count = last - first + 1;
+
+            m_packedDynamic.resize(count);
+            for (unsigned int i=0; i<count; i++)
+            {
+                const cVector3d& pos = m_localPos[first + i];
+                cPackedDynamicVertex& v = m_packedDynamic[i];
+                v.m_pos[0] = (GLfloat)pos(0);
+                v.m_pos[1] = (GLfloat)pos(1);
+                v.m_pos[2] = (GLfloat)pos(2);
+                v.m_normal = m_useNormalData ? packVector(m_normal[first + i]) : 0;
+            }
+
+            unsigned int size = count * sizeof(cPackedDynamicVertex);
+            glBindBuffer(GL_ARRAY_BUFFER, m_packedDynamicBuffer[m_packedDynamicIndex]);
+            glBufferSubData(GL_ARRAY_BUFFER, first * sizeof(cPackedDynamicVertex), size, &(m_packedDynamic[0]));
+            addNumBytesUploaded(size);
+        }
+
+        // static stream: texture coordinates, colors, tangents and bitangents
+        if (useStatic)
+        {
+            range.clear();
+            if (m_useTexCoordData)  { range.add(m_modifiedTexCoord.m_first, m_modifiedTexCoord.m_last); }
+            if (m_useColorData)     { range.add(m_modifiedColor.m_first, m_modifiedColor.m_last); }
+            if (m_useTangentData)   { range.add(m_modifiedTangent.m_first, m_modifiedTangent.m_last); }
+            if (m_useBitangentData) { range.add(m_modifiedBitangent.m_first, m_modifiedBitangent.m_last); }
+            full = m_flagTexCoordData || m_flagColorData || m_flagTangentData || m_flagBitangentData;
+
+            if (m_flagBufferResize)
+            {
+                glBindBuffer(GL_ARRAY_BUFFER, m_packedStaticBuffer);
+                glBufferData(GL_ARRAY_BUFFER, m_bufferCapacity * sizeof(cPackedStaticVertex), NULL, GL_STATIC_DRAW);
+            }
+
+            if (!range.isEmpty())
+            {
+                range.m_last = cMin(range.m_last, m_numVertices - 1);
+            }
+
+            if ((m_numVertices > 0) && (full || (!range.isEmpty() && (range.m_first <= range.m_last))))
+            {
+                unsigned int first = full ? 0 : range.m_first;
+                unsigned int last = full ? m_numVertices - 1 : range.m_last;
+                unsigned int count = last - first + 1;
+
+                m_packedStatic.resize(count);
+                for (unsigned int i=0; i<count; i++)
+                {
+                    unsigned int j = first + i;
+                    cPackedStaticVertex& v = m_packedStatic[i];
+                    for (int k=0; k<3; k++)
+                    {
+                        v.m_texCoord[k] = m_useTexCoordData ? (GLfloat)m_texCoord[j](k) : 0.0f;
+                    }
+                    for (int k=0; k<4; k++)
+                    {
+                        v.m_color[k] = m_useColorData ? (GLubyte)(cClamp(m_color[j][k], 0.0f, 1.0f) * 255.0f + 0.5f) : 255;
+                    }
+                    v.m_tangent = m_useTangentData ? packVector(m_tangent[j]) : 0;
+                    v.m_bitangent = m_useBitangentData ? packVector(m_bitangent[j]) : 0;
+                }
+
+                unsigned int size = count * sizeof(cPackedStaticVertex);
+                glBindBuffer(GL_ARRAY_BUFFER, m_packedStaticBuffer);
+                glBufferSubData(GL_ARRAY_BUFFER, first * sizeof(cPackedStaticVertex), size, &(m_packedStatic[0]));
+                addNumBytesUploaded(size);
+            }
+        }
+
+        m_flagBufferResize  = false;
+        m_flagPositionData  = false;
+        m_flagNormalData    = false;
+        m_flagTexCoordData  = false;
+        m_flagColorData     = false;
+        m_flagTangentData   = false;
+        m_flagBitangentData = false;
+        clearModifiedRanges();
+
+        // bind buffers and set client state
+        GLsizei stride = sizeof(cPackedDynamicVertex);
+        glBindBuffer(GL_ARRAY_BUFFER, m_packedDynamicBuffer[m_packedDynamicIndex]);
+        glEnableVertexAttribArray(C_VB_POSITION);
+        glVertexAttribPointer(C_VB_POSITION, 3, GL_FLOAT, GL_FALSE, stride, 0);
+        glVertexPointer(3, GL_FLOAT, stride, 0);
+
+        if (m_useNormalData)
+        {
+            glEnableVertexAttribArray(C_VB_NORMAL);
+            glVertexAttribPointer(C_VB_NORMAL, 4, GL_INT_2_10_10_10_REV, GL_TRUE, stride, (void*)12);
+        }
+        else
+        {
+            glDisableVertexAttribArray(C_VB_NORMAL);
+        }
+
+        stride = sizeof(cPackedStaticVertex);
+        if (useStatic)
+        {
+            glBindBuffer(GL_ARRAY_BUFFER, m_packedStaticBuffer);
+        }
+
+        if (m_useTexCoordData)
+        {
+            glEnableVertexAttribArray(C_VB_TEXCOORD);
+            glVertexAttribPointer(C_VB_TEXCOORD, 3, GL_FLOAT, GL_FALSE, stride, 0);
+        }
+        else
+        {
+            glDisableVertexAttribArray(C_VB_TEXCOORD);
+        }
+
+        if (m_useColorData)
+        {
+            glEnableVertexAttribArray(C_VB_COLOR);
+            glVertexAttribPointer(C_VB_COLOR, 4, GL_UNSIGNED_BYTE, GL_TRUE, stride, (void*)12);
+        }
+        else
+        {
+            glDisableVertexAttribArray(C_VB_COLOR);
+        }
+
+        if (m_useTangentData)
+        {
+            glEnableVertexAttribArray(C_VB_TANGENT);
+            glVertexAttribPointer(C_VB_TANGENT, 4, GL_INT_2_10_10_10_REV, GL_TRUE, stride, (void*)16);
+        }
+        else
+        {
+            glDisableVertexAttribArray(C_VB_TANGENT);
+        }
+
+        if (m_useBitangentData)
+        {
+            glEnableVertexAttribArray(C_VB_BITANGENT);
+            glVertexAttribPointer(C_VB_BITANGENT, 4, GL_INT_2_10_10_10_REV, GL_TRUE, stride, (void*)20);
+        }
+        else
+        {
+            glDisableVertexAttribArray(C_VB_BITANGENT);
+        }
+
+        glBindBuffer(GL_ARRAY_BUFFER, 0);
+#endif
+    }
+
+#endif  // DOXYGEN_SHOULD_SKIP_THIS
+
 
     //--------------------------------------------------------------------------
     // PUBLIC MEMBERS:
@@ -1180,6 +1645,53 @@ protected:
     //! If __true__ then surface bitangent data will be allocated for each new vertex.
     bool m_useUserData;
 
+    //! If __true__ then the packed layout of OpenGL buffers is requested.
+    bool m_usePackedBuffers;
+
+    //! If __true__ then the OpenGL buffers currently use the packed layout.
+    bool m_packedBuffersActive;
+
+    //! Number of vertices the OpenGL buffers can hold.
+    unsigned int m_bufferCapacity;
+
+    //! Number of bytes uploaded to OpenGL buffers.
+    unsigned long long m_numBytesUploaded;
+
+    //! Range of modified positions.
+    cVertexArrayRange m_modifiedPosition;
+
+    //! Range of modified normals.
+    cVertexArrayRange m_modifiedNormal;
+
+    //! Range of modified texture coordinates.
+    cVertexArrayRange m_modifiedTexCoord;
+
+    //! Range of modified vertex colors.
+    cVertexArrayRange m_modifiedColor;
+
+    //! Range of modified surface tangents.
+    cVertexArrayRange m_modifiedTangent;
+
+    //! Range of modified surface bitangents.
+    cVertexArrayRange m_modifiedBitangent;
+
+    //! OpenGL buffers (double buffered) of the packed dynamic stream.
+    GLuint m_packedDynamicBuffer[2];
+
+    //! Index of the packed dynamic buffer currently used for rendering.
+    int m_packedDynamicIndex;
+
+    //! OpenGL buffer of the packed static stream.
+    GLuint m_packedStaticBuffer;
+
+#ifndef DOXYGEN_SHOULD_SKIP_THIS
+    //! Staging data of the packed dynamic stream.
+    std::vector<cPackedDynamicVertex> m_packedDynamic;
+
+    //! Staging data of the packed static stream.
+    std::vector<cPackedStaticVertex> m_packedStatic;
+#endif
+
 
     //--------------------------------------------------------------------------
     // PUBLIC MEMBERS:
@@ -116,6 +116,7 @@ void cDirectionalLight::setDir(const cVector3d& a_direction)
 
     // update rotation matrix
     m_localRot.setCol(c0,c1,c2);
+    invalidateGlobalPositions();
 }
 
 
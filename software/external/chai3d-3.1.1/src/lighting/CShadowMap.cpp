@@ -335,6 +335,8 @@ bool cShadowMap::updateMap(const int a_displayContext,
         options.m_shadow_light_level                    = 1.0;
         options.m_storeObjectPositions                  = true;
         options.m_markForUpdate                         = false;
+        options.m_primitiveBatch                        = NULL;
+        options.m_textBatch                             = NULL;
 
         // render single pass (all objects)
         a_world->renderSceneGraph(options);
@@ -64,6 +64,9 @@ cTexture1d::cTexture1d()
     // create image
     m_image = cImage::create();
 
+    // not updated yet
+    m_updateCounter = 0;
+
     // initialize internal variables
     reset();
 }
@@ -325,6 +328,7 @@ void cTexture1d::markForUpdate()
     {
         m_updateTextureFlag[i] = true;
     }
+    m_updateCounter++;
 }
 
 
@@ -341,6 +345,7 @@ void cTexture1d::markForDeleteAndUpdate()
         m_deleteTextureFlag[i] = true;
         m_updateTextureFlag[i] = true;
     }
+    m_updateCounter++;
 }
 
 
@@ -138,6 +138,9 @@ public:
     //! This method marks this texture for GPU deletion and reinitialization.
     virtual void markForDeleteAndUpdate();
 
+    //! This method returns the number of times this texture has been marked for update, so that data derived from its image can be checked.
+    unsigned int getUpdateCounter() const { return (m_updateCounter); }
+
     //! This method sets the environment mode (GL_MODULATE, GL_DECAL, GL_BLEND, GL_REPLACE).
     void setEnvironmentMode(const GLint& a_environmentMode) { m_environmentMode = a_environmentMode; }
 
@@ -216,6 +219,9 @@ protected:
     //! If __true__, texture bitmap needs to be updated to GPU memory.
     bool m_updateTextureFlag[C_MAX_DISPLAY_CONTEXTS];
 
+    //! Number of times this texture has been marked for update.
+    unsigned int m_updateCounter;
+
     //! OpenGL texture ID number.
     GLuint m_textureID[C_MAX_DISPLAY_CONTEXTS];
 
@@ -223,7 +223,9 @@ void cShaderProgram::disable()
 
 //==============================================================================
 /*!
-    This method binds an attribute to a name.
+    This method binds an attribute to a name. OpenGL applies attribute 
+    bindings when the program is linked, so this method should be called 
+    before \ref linkProgram().
 
     \param  a_index  Index of the attribute to be bound
     \param  a_name   Name of the attribute.
@@ -232,18 +234,14 @@ void cShaderProgram::disable()
 void cShaderProgram::bindAttributeLocation(const unsigned int a_index, const char *a_name)
 {
 #ifdef C_USE_OPENGL
-    // check program
-    if (!m_linked) { return; } 
-
-    // get location
-    glUseProgram(m_id);
-    glBindAttribLocation(m_id, a_index, a_name);
-
-    // finalize
-    if (!m_enabled)
+    // generate a unique Id / handle for the shader program if needed
+    if (m_id == 0)
     {
-        glUseProgram(0);
+        m_id = glCreateProgram();
     }
+
+    // bind location (effective at next link)
+    glBindAttribLocation(m_id, a_index, a_name);
 #endif
 }
 
@@ -0,0 +1,188 @@
+//==============================================================================
+/*
+    Software License Agreement (BSD License)
+    Copyright (c) 2003-2016, CHAI3D.
+    (www.chai3d.org)
+
+    All rights reserved.
+
+    Redistribution and use in source and binary forms, with or without
+    modification, are permitted provided that the following conditions
+    are met:
+
+    * Redistributions of source code must retain the above copyright
+    notice, this list of conditions and the following disclaimer.
+
+    * Redistributions in binary form must reproduce the above
+    copyright notice, this list of conditions and the following
+    disclaimer in the documentation and/or other materials provided
+    with the distribution.
+
+    * Neither the name of CHAI3D nor the names of its contributors may
+    be used to endorse or promote products derived from this software
+    without specific prior written permission.
+
+    THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS
+    "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT
+    LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS
+    FOR A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE
+    COPYRIGHT OWNER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT,
+    INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING,
+    BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES;
+    LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER
+    CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT
+    LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN
+    ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE
+    POSSIBILITY OF SUCH DAMAGE. 
+
+    \author    <http://www.chai3d.org>
+    \version   3.1.1 $Rev: 1869 $
+*/
+//==============================================================================
+
+//------------------------------------------------------------------------------
+#include "system/CMappedFile.h"
+//------------------------------------------------------------------------------
+#include <cstdio>
+//------------------------------------------------------------------------------
+#if defined(LINUX) | defined(MACOSX)
+#include <fcntl.h>
+#include <unistd.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#endif
+//------------------------------------------------------------------------------
+
+//------------------------------------------------------------------------------
+namespace chai3d {
+//------------------------------------------------------------------------------
+
+//==============================================================================
+/*!
+    Constructor of cMappedFile.
+*/
+//==============================================================================
+cMappedFile::cMappedFile()
+{
+    m_data = NULL;
+    m_size = 0;
+    m_mapped = false;
+
+#if defined(WIN32) | defined(WIN64)
+    m_file = INVALID_HANDLE_VALUE;
+    m_mapping = NULL;
+#endif
+}
+
+
+//==============================================================================
+/*!
+    Destructor of cMappedFile.
+*/
+//==============================================================================
+cMappedFile::~cMappedFile()
+{
+    close();
+}
+
+
+//==============================================================================
+/*!
+    This method opens a file and maps its content into memory. Any previously
+    opened file is closed first.
+
+    \param  a_filename          Filename.
+    \param  a_sequentialAccess  If __true__, then the content is expected to be read from start to end.
+
+    \return __true__ if the operation succeeds, __false__ otherwise.
+*/
+//==============================================================================
+bool cMappedFile::open(const std::string& a_filename, const bool a_sequentialAccess)
+{
+    close();
+
+#if defined(WIN32) | defined(WIN64)
+    m_file = CreateFileA(a_filename.c_str(), GENERIC_READ, FILE_SHARE_READ, NULL, OPEN_EXISTING, 
+                         a_sequentialAccess ? FILE_FLAG_SEQUENTIAL_SCAN : FILE_ATTRIBUTE_NORMAL, NULL);
+    if (m_file == INVALID_HANDLE_VALUE) { return (false); }
+    LARGE_INTEGER size;
+    if (!GetFileSizeEx(m_file, &size)) { close(); return (false); }
+    m_size = (size_t)(size.QuadPart);
+    if (m_size > 0)
+    {
+        m_mapping = CreateFileMappingA(m_file, NULL, PAGE_READONLY, 0, 0, NULL);
+        if (m_mapping != NULL)
+        {
+            m_data = (const char*)(MapViewOfFile(m_mapping, FILE_MAP_READ, 0, 0, 0));
+            m_mapped = (m_data != NULL);
+        }
+    }
+#else
+    int file = ::open(a_filename.c_str(), O_RDONLY);
+    if (file < 0) { return (false); }
+    struct stat info;
+    if (fstat(file, &info) != 0) { ::close(file); return (false); }
+    m_size = (size_t)(info.st_size);
+    if (m_size > 0)
+    {
+        void* data = mmap(NULL, m_size, PROT_READ, MAP_PRIVATE, file, 0);
+        if (data != MAP_FAILED)
+        {
+            if (a_sequentialAccess)
+            {
+                madvise(data, m_size, MADV_SEQUENTIAL);
+            }
+            m_data = (const char*)(data);
+            m_mapped = true;
+        }
+    }
+    ::close(file);
+#endif
+
+    // fall back to reading the whole file
+    if ((m_size > 0) && (!m_mapped))
+    {
+        FILE* file = fopen(a_filename.c_str(), "rb");
+        if (file == NULL) { close(); return (false); }
+        m_buffer.resize(m_size);
+        size_t numRead = fread(&m_buffer[0], 1, m_size, file);
+        fclose(file);
+        if (numRead != m_size) { close(); return (false); }
+        m_data = &m_buffer[0];
+    }
+
+    return (true);
+}
+
+
+//==============================================================================
+/*!
+    This method releases the content of the file. Pointers returned by
+    \ref getData() are no longer valid afterwards.
+*/
+//==============================================================================
+void cMappedFile::close()
+{
+    if (m_mapped)
+    {
+#if defined(WIN32) | defined(WIN64)
+        UnmapViewOfFile(m_data);
+#else
+        munmap((void*)(m_data), m_size);
+#endif
+    }
+
+#if defined(WIN32) | defined(WIN64)
+    if (m_mapping != NULL) { CloseHandle(m_mapping); m_mapping = NULL; }
+    if (m_file != INVALID_HANDLE_VALUE) { CloseHandle(m_file); m_file = INVALID_HANDLE_VALUE; }
+#endif
+
+    std::vector<char>().swap(m_buffer);
+    m_data = NULL;
+    m_size = 0;
+    m_mapped = false;
+}
+
+//------------------------------------------------------------------------------
+} // namespace chai3d
+//------------------------------------------------------------------------------
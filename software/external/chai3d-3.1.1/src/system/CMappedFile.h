@@ -0,0 +1,158 @@
+//==============================================================================
+/*
+    Software License Agreement (BSD License)
+    Copyright (c) 2003-2016, CHAI3D.
+    (www.chai3d.org)
+
+    All rights reserved.
+
+    Redistribution and use in source and binary forms, with or without
+    modification, are permitted provided that the following conditions
+    are met:
+
+    * Redistributions of source code must retain the above copyright
+    notice, this list of conditions and the following disclaimer.
+
+    * Redistributions in binary form must reproduce the above
+    copyright notice, this list of conditions and the following
+    disclaimer in the documentation and/or other materials provided
+    with the distribution.
+
+    * Neither the name of CHAI3D nor the names of its contributors may
+    be used to endorse or promote products derived from this software
+    without specific prior written permission.
+
+    THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS
+    "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT
+    LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS
+    FOR A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE
+    COPYRIGHT OWNER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT,
+    INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING,
+    BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES;
+    LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER
+    CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT
+    LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN
+    ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE
+    POSSIBILITY OF SUCH DAMAGE. 
+
+    \author    <http://www.chai3d.org>
+    \version   3.1.1 $Rev: 1869 $
+*/
+//==============================================================================
+
+//------------------------------------------------------------------------------
+#ifndef CMappedFileH
+#define CMappedFileH
+//------------------------------------------------------------------------------
+#include "system/CGlobals.h"
+//------------------------------------------------------------------------------
+#include <string>
+#include <vector>
+//------------------------------------------------------------------------------
+
+//------------------------------------------------------------------------------
+namespace chai3d {
+//------------------------------------------------------------------------------
+
+//==============================================================================
+/*!
+    \file       CMappedFile.h
+    \ingroup    system
+
+    \brief
+    Implements read-only memory-mapped files.
+*/
+//==============================================================================
+
+//==============================================================================
+/*!
+    \class      cMappedFile
+    \ingroup    system
+
+    \brief
+    This class implements a read-only view of the content of a file.
+
+    \details
+    The content of the file is memory-mapped, so that only the pages which
+    are actually accessed are read from disk, and pages already present in
+    the file cache of the operating system are accessed without any copy.
+    If the file cannot be mapped, its whole content is read into memory 
+    instead. In both cases, the content remains valid until \ref close()
+    is called or the object is destroyed.
+*/
+//==============================================================================
+class cMappedFile
+{
+    //--------------------------------------------------------------------------
+    // CONSTRUCTOR & DESTRUCTOR:
+    //--------------------------------------------------------------------------
+
+public:
+
+    //! Constructor of cMappedFile.
+    cMappedFile();
+
+    //! Destructor of cMappedFile.
+    virtual ~cMappedFile();
+
+
+    //--------------------------------------------------------------------------
+    // PUBLIC METHODS:
+    //--------------------------------------------------------------------------
+
+public:
+
+    //! This method opens a file and maps its content into memory.
+    bool open(const std::string& a_filename, const bool a_sequentialAccess = true);
+
+    //! This method releases the content of the file.
+    void close();
+
+    //! This method returns a pointer to the content of the file, or __NULL__ if no file is open or the file is empty.
+    inline const char* getData() const { return (m_data); }
+
+    //! This method returns the size of the file in bytes.
+    inline size_t getSize() const { return (m_size); }
+
+    //! This method returns __true__ if the content of the file is memory-mapped, __false__ if it was read into memory.
+    inline bool getMapped() const { return (m_mapped); }
+
+
+    //--------------------------------------------------------------------------
+    // PRIVATE MEMBERS:
+    //--------------------------------------------------------------------------
+
+private:
+
+    //! Content of the file.
+    const char* m_data;
+
+    //! Size of the file in bytes.
+    size_t m_size;
+
+    //! If __true__, then the content of the file is memory-mapped.
+    bool m_mapped;
+
+    //! Content of the file if it could not be memory-mapped.
+    std::vector<char> m_buffer;
+
+#if defined(WIN32) | defined(WIN64)
+    //! File handle.
+    HANDLE m_file;
+
+    //! File mapping handle.
+    HANDLE m_mapping;
+#endif
+
+    // copying a mapping is not allowed.
+    cMappedFile(const cMappedFile&);
+    cMappedFile& operator=(const cMappedFile&);
+};
+
+//------------------------------------------------------------------------------
+} // namespace chai3d
+//------------------------------------------------------------------------------
+
+//------------------------------------------------------------------------------
+#endif
+//------------------------------------------------------------------------------
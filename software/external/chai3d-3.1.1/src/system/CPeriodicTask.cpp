@@ -0,0 +1,197 @@
+//==============================================================================
+/*
+    Software License Agreement (BSD License)
+    Copyright (c) 2003-2016, CHAI3D.
+    (www.chai3d.org)
+
+    All rights reserved.
+
+    Redistribution and use in source and binary forms, with or without
+    modification, are permitted provided that the following conditions
+    are met:
+
+    * Redistributions of source code must retain the above copyright
+    notice, this list of conditions and the following disclaimer.
+
+    * Redistributions in binary form must reproduce the above
+    copyright notice, this list of conditions and the following
+    disclaimer in the documentation and/or other materials provided
+    with the distribution.
+
+    * Neither the name of CHAI3D nor the names of its contributors may
+    be used to endorse or promote products derived from this software
+    without specific prior written permission.
+
+    THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS
+    "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT
+    LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS
+    FOR A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE
+    COPYRIGHT OWNER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT,
+    INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING,
+    BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES;
+    LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER
+    CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT
+    LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN
+    ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE
+    POSSIBILITY OF SUCH DAMAGE. 
+
+
+    \author    <http://www.chai3d.org>
+    \version   3.1.1 $Rev: 1869 $
+*/
+//==============================================================================
+
+//------------------------------------------------------------------------------
+#include "system/CPeriodicTask.h"
+//------------------------------------------------------------------------------
+#include "timers/CPrecisionClock.h"
+//------------------------------------------------------------------------------
+#include <cerrno>
+//------------------------------------------------------------------------------
+
+//------------------------------------------------------------------------------
+namespace chai3d {
+//------------------------------------------------------------------------------
+
+//==============================================================================
+/*!
+    Constructor of cPeriodicTask.
+
+    \param  a_period  Period of the task in seconds.
+*/
+//==============================================================================
+cPeriodicTask::cPeriodicTask(const double a_period)
+{
+    m_period = 0;
+    m_deadline = 0;
+    m_overruns = 0;
+    m_started = false;
+
+    setPeriod(a_period);
+}
+
+
+//==============================================================================
+/*!
+    This method sets the period of the task. Changing the period of a running 
+    task takes effect after the next deadline.
+
+    \param  a_period  Period of the task in seconds.
+*/
+//==============================================================================
+void cPeriodicTask::setPeriod(const double a_period)
+{
+    double period = (a_period > 0.0) ? a_period : 0.0;
+    m_period = (unsigned long long)(period * 1e9 + 0.5);
+}
+
+
+//==============================================================================
+/*!
+    This method resets the overrun counter and sets the first deadline one 
+    period from now.
+*/
+//==============================================================================
+void cPeriodicTask::start()
+{
+    m_overruns = 0;
+    m_deadline = (unsigned long long)cPrecisionClock::getSystemTimeNanoseconds() + m_period;
+    m_started = true;
+}
+
+
+//==============================================================================
+/*!
+    This method sleeps until the next deadline, then advances the deadline by 
+    one period. If start() has not been called yet, the task is started and 
+    the method waits for one period.
+
+    \return __true__ if the deadline was met, __false__ if it had already passed.
+*/
+//==============================================================================
+bool cPeriodicTask::wait()
+{
+    if (!m_started)
+    {
+        start();
+    }
+
+    unsigned long long now = (unsigned long long)cPrecisionClock::getSystemTimeNanoseconds();
+
+    // deadline missed
+    if (now >= m_deadline)
+    {
+        m_overruns++;
+
+        // more than one period late: resynchronize instead of catching up
+        if (now - m_deadline >= m_period)
+        {
+            m_deadline = now + m_period;
+        }
+        else
+        {
+            m_deadline += m_period;
+        }
+
+        return (false);
+    }
+
+    sleepUntil(m_deadline);
+    m_deadline += m_period;
+
+    return (true);
+}
+
+
+//==============================================================================
+/*!
+    This method sleeps until the given absolute time.
+
+    \param  a_time  Absolute time in nanoseconds, as returned by 
+                    cPrecisionClock::getSystemTimeNanoseconds().
+*/
+//==============================================================================
+void cPeriodicTask::sleepUntil(const unsigned long long a_time)
+{
+#ifdef LINUX
+
+    struct timespec deadline;
+    deadline.tv_sec  = (time_t)(a_time / 1000000000ULL);
+    deadline.tv_nsec = (long)(a_time % 1000000000ULL);
+
+    // clock_nanosleep returns the error code and must be restarted if interrupted
+    while (clock_nanosleep(CLOCK_MONOTONIC, TIMER_ABSTIME, &deadline, NULL) == EINTR) {}
+
+#else
+
+    // margin left to spinning, since sleeps are only coarse on these platforms
+#if defined(WIN32) | defined(WIN64)
+    const unsigned long long margin = 2000000ULL;
+#else
+    const unsigned long long margin = 200000ULL;
+#endif
+
+    unsigned long long now = (unsigned long long)cPrecisionClock::getSystemTimeNanoseconds();
+    if (a_time > now + margin)
+    {
+        unsigned long long duration = a_time - now - margin;
+
+#if defined(WIN32) | defined(WIN64)
+        Sleep((DWORD)(duration / 1000000ULL));
+#else
+        struct timespec sleep;
+        sleep.tv_sec  = (time_t)(duration / 1000000000ULL);
+        sleep.tv_nsec = (long)(duration % 1000000000ULL);
+        nanosleep(&sleep, NULL);
+#endif
+    }
+
+    while ((unsigned long long)cPrecisionClock::getSystemTimeNanoseconds() < a_time) {}
+
+#endif
+}
+
+
+//------------------------------------------------------------------------------
+} // namespace chai3d
+//------------------------------------------------------------------------------
@@ -0,0 +1,170 @@
+//==============================================================================
+/*
+    Software License Agreement (BSD License)
+    Copyright (c) 2003-2016, CHAI3D.
+    (www.chai3d.org)
+
+    All rights reserved.
+
+    Redistribution and use in source and binary forms, with or without
+    modification, are permitted provided that the following conditions
+    are met:
+
+    * Redistributions of source code must retain the above copyright
+    notice, this list of conditions and the following disclaimer.
+
+    * Redistributions in binary form must reproduce the above
+    copyright notice, this list of conditions and the following
+    disclaimer in the documentation and/or other materials provided
+    with the distribution.
+
+    * Neither the name of CHAI3D nor the names of its contributors may
+    be used to endorse or promote products derived from this software
+    without specific prior written permission.
+
+    THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS
+    "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT
+    LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS
+    FOR A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE
+    COPYRIGHT OWNER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT,
+    INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING,
+    BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES;
+    LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER
+    CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT
+    LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN
+    ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE
+    POSSIBILITY OF SUCH DAMAGE. 
+
+
+    \author    <http://www.chai3d.org>
+    \version   3.1.1 $Rev: 1869 $
+*/
+//==============================================================================
+
+//------------------------------------------------------------------------------
+#ifndef CPeriodicTaskH
+#define CPeriodicTaskH
+//------------------------------------------------------------------------------
+#include "system/CGlobals.h"
+#include "math/CConstants.h"
+//------------------------------------------------------------------------------
+
+//------------------------------------------------------------------------------
+namespace chai3d {
+//------------------------------------------------------------------------------
+
+//==============================================================================
+/*!
+    \file       CPeriodicTask.h
+    \ingroup    system
+
+    \brief
+    Implements a timer for running fixed-rate loops.
+*/
+//==============================================================================
+
+//==============================================================================
+/*!
+    \class      cPeriodicTask
+    \ingroup    system
+
+    \brief
+    This class implements a timer for running fixed-rate loops.
+
+    \details
+    cPeriodicTask paces a loop at a fixed period. Deadlines are absolute 
+    (start time plus a whole number of periods), so the time spent in the 
+    loop body and the sleep latency do not accumulate as drift. On Linux, 
+    the thread sleeps with __clock_nanosleep__ on the monotonic clock; on 
+    other platforms, it sleeps until shortly before the deadline and spins 
+    for the remaining time. \n
+
+    \code
+    cPeriodicTask task(0.001);
+    task.start();
+    while (running)
+    {
+        update();
+        task.wait();
+    }
+    \endcode
+
+    If the loop body overruns a deadline, wait() returns immediately and 
+    reports the overrun. If the loop falls behind by more than one period, 
+    the deadlines are resynchronized to the current time instead of 
+    running a burst of back-to-back iterations to catch up.
+*/
+//==============================================================================
+class cPeriodicTask
+{
+    //--------------------------------------------------------------------------
+    // CONSTRUCTOR & DESTRUCTOR:
+    //--------------------------------------------------------------------------
+
+public:
+
+    //! Constructor of cPeriodicTask.
+    cPeriodicTask(const double a_period = 0.001);
+
+    //! Destructor of cPeriodicTask.
+    virtual ~cPeriodicTask() {};
+
+
+    //--------------------------------------------------------------------------
+    // PUBLIC METHODS:
+    //--------------------------------------------------------------------------
+
+public:
+
+    //! This method sets the period of the task in seconds.
+    void setPeriod(const double a_period);
+
+    //! This method returns the period of the task in seconds.
+    double getPeriod() const { return ((double)m_period * 1e-9); }
+
+    //! This method sets the first deadline one period from now.
+    void start();
+
+    //! This method waits until the next deadline. Returns __false__ if the deadline had already passed.
+    bool wait();
+
+    //! This method returns the number of missed deadlines since start() was called.
+    unsigned long long getNumOverruns() const { return (m_overruns); }
+
+
+    //--------------------------------------------------------------------------
+    // PROTECTED METHODS:
+    //--------------------------------------------------------------------------
+
+protected:
+
+    //! This method sleeps until the given absolute time in nanoseconds.
+    void sleepUntil(const unsigned long long a_time);
+
+
+    //--------------------------------------------------------------------------
+    // PROTECTED MEMBERS:
+    //--------------------------------------------------------------------------
+
+protected:
+
+    //! Period of the task in nanoseconds.
+    unsigned long long m_period;
+
+    //! Next deadline in nanoseconds.
+    unsigned long long m_deadline;
+
+    //! Number of missed deadlines.
+    unsigned long long m_overruns;
+
+    //! If __true__, then start() has been called.
+    bool m_started;
+};
+
+//------------------------------------------------------------------------------
+} // namespace chai3d
+//------------------------------------------------------------------------------
+
+//------------------------------------------------------------------------------
+#endif
+//------------------------------------------------------------------------------
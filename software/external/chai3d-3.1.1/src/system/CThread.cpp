@@ -45,6 +45,25 @@
 //------------------------------------------------------------------------------
 #include "system/CThread.h"
 //------------------------------------------------------------------------------
+#include <cstring>
+#include <fstream>
+#include <sstream>
+#include <thread>
+#if defined(WIN32) | defined(WIN64)
+#include <malloc.h>
+#endif
+#if defined(LINUX)
+#include <alloca.h>
+#include <sched.h>
+#include <sys/mman.h>
+#include <sys/resource.h>
+#endif
+#if defined(MACOSX)
+#include <alloca.h>
+#include <sys/mman.h>
+#include <sys/resource.h>
+#endif
+//------------------------------------------------------------------------------
 
 //------------------------------------------------------------------------------
 namespace chai3d {
@@ -62,6 +81,15 @@ cThread::cThread()
 
     // default value for priority level
     m_priorityLevel = CTHREAD_PRIORITY_GRAPHICS;
+    m_priorityApplied = false;
+
+    // thread not started yet
+    m_started = false;
+
+#if defined(WIN32) | defined(WIN64)
+    m_threadId = 0;
+    m_threadHandle = NULL;
+#endif
 }
 
 
@@ -72,6 +100,12 @@ cThread::cThread()
 //==============================================================================
 cThread::~cThread()
 {
+#if defined(WIN32) | defined(WIN64)
+    if (m_threadHandle != NULL)
+    {
+        CloseHandle(m_threadHandle);
+    }
+#endif
 }
 
 
@@ -79,7 +113,10 @@ cThread::~cThread()
 /*!
     This method creates a thread to execute within the address space of the 
     calling process. Parameters include a pointer to the function and its 
-    priority level.
+    priority level. \n
+
+    Method getPriorityApplied() can be called afterwards to check whether 
+    the requested priority level was granted by the operating system.
 
     \param  a_function  Pointer to thread function.
     \param  a_level     Priority level of thread.
@@ -89,7 +126,7 @@ void cThread::start(void(*a_function)(void), CThreadPriority a_level)
 {
     // create thread
 #if defined(WIN32) | defined(WIN64)
-    CreateThread(
+    m_threadHandle = CreateThread(
           0,
           0,
           (LPTHREAD_START_ROUTINE)(a_function),
@@ -97,15 +134,16 @@ void cThread::start(void(*a_function)(void), CThreadPriority a_level)
           0,
           &m_threadId
       );
+    m_started = (m_threadHandle != NULL);
 #endif
 
 #if defined (LINUX) || defined (MACOSX)
-    pthread_create(
+    m_started = (pthread_create(
           &m_handle,
           0,
           (void * (*)(void*)) a_function,
           0
-    );
+    ) == 0);
 #endif
 
     // set thread priority level
@@ -128,7 +166,7 @@ void cThread::start(void(*a_function)(void*), CThreadPriority a_level, void *a_a
 {
     // create thread
 #if defined(WIN32) | defined(WIN64)
-    CreateThread(
+    m_threadHandle = CreateThread(
           0,
           0,
           (LPTHREAD_START_ROUTINE)(a_function),
@@ -136,15 +174,16 @@ void cThread::start(void(*a_function)(void*), CThreadPriority a_level, void *a_a
           0,
           &m_threadId
       );
+    m_started = (m_threadHandle != NULL);
 #endif
 
 #if defined (LINUX) || defined (MACOSX)
-    pthread_create(
+    m_started = (pthread_create(
           &m_handle,
           0,
           (void * (*)(void*)) a_function,
           a_arg
-    );
+    ) == 0);
 #endif
 
     // set thread priority level
@@ -159,25 +198,34 @@ void cThread::start(void(*a_function)(void*), CThreadPriority a_level, void *a_a
 //==============================================================================
 void cThread::stop()
 {
+    if (!m_started) return;
+
     // terminate thread
 #if defined(WIN32) | defined(WIN64)
-    TerminateThread(&m_threadId, 0);
+    TerminateThread(m_threadHandle, 0);
 #endif
 
 #if defined (LINUX) || defined (MACOSX)
     pthread_cancel(m_handle);
 #endif
+
+    m_started = false;
 }
 
 
 //==============================================================================
 /*!
-    This method adjusts the priority level of the thread.
+    This method adjusts the priority level of the thread. On Linux and Mac OS X, 
+    both levels map to the __SCHED_FIFO__ policy, which usually requires the 
+    process to hold real-time privileges (e.g. `CAP_SYS_NICE` or an 
+    `rtprio` limit).
 
     \param  a_level  Priority level of the thread.
+
+    \return __true__ if the priority level was applied, __false__ otherwise.
 */
 //==============================================================================
-void cThread::setPriority(CThreadPriority a_level)
+bool cThread::setPriority(CThreadPriority a_level)
 {
     m_priorityLevel = a_level;
 
@@ -192,7 +240,7 @@ void cThread::setPriority(CThreadPriority a_level)
     }
 
     // adjust the thread priority within the process
-    int priority;
+    int priority = THREAD_PRIORITY_NORMAL;
 
     switch (m_priorityLevel)
     {
@@ -205,34 +253,310 @@ void cThread::setPriority(CThreadPriority a_level)
         break;
     }
 
-    SetThreadPriority (&m_threadId, priority);
+    m_priorityApplied = m_started && (SetThreadPriority (m_threadHandle, priority) != 0);
+
+    return (m_priorityApplied);
+
+#elif defined(LINUX) || defined(MACOSX)
+
+    switch (m_priorityLevel)
+    {
+        case CTHREAD_PRIORITY_GRAPHICS:
+        return (setScheduling(CTHREAD_POLICY_FIFO, 75));
+
+        case CTHREAD_PRIORITY_HAPTICS:
+        return (setScheduling(CTHREAD_POLICY_FIFO, 99));
+    }
+
+    m_priorityApplied = false;
+    return (C_ERROR);
+
+#else
+
+    m_priorityApplied = false;
+    return (C_ERROR);
+
+#endif
+}
+
+
+//==============================================================================
+/*!
+    This method sets the scheduling policy and priority of the thread. On 
+    Linux and Mac OS X, the priority is clamped to the range supported by 
+    the policy. On Windows, real-time policies map to the highest thread 
+    priority and __a_priority__ is ignored. \n
+
+    The outcome is also stored and can be read back with getPriorityApplied().
+
+    \param  a_policy    Scheduling policy.
+    \param  a_priority  Priority within the scheduling policy.
+
+    \return __true__ if the policy and priority were applied, __false__ otherwise.
+*/
+//==============================================================================
+bool cThread::setScheduling(const CThreadPolicy a_policy, const int a_priority)
+{
+    m_priorityApplied = false;
+
+    if (!m_started) return (C_ERROR);
+
+#if defined(WIN32) | defined(WIN64)
+
+    int priority = THREAD_PRIORITY_NORMAL;
+    if (a_policy != CTHREAD_POLICY_DEFAULT)
+    {
+        priority = THREAD_PRIORITY_TIME_CRITICAL;
+    }
+
+    m_priorityApplied = (SetThreadPriority (m_threadHandle, priority) != 0);
 
 #endif
 
 #if defined(LINUX) || defined(MACOSX)
 
+    int policy = SCHED_OTHER;
+    switch (a_policy)
+    {
+        case CTHREAD_POLICY_DEFAULT:     policy = SCHED_OTHER; break;
+        case CTHREAD_POLICY_FIFO:        policy = SCHED_FIFO;  break;
+        case CTHREAD_POLICY_ROUND_ROBIN: policy = SCHED_RR;    break;
+    }
+
     struct sched_param sp;
-    int policy;
+    memset(&sp, 0, sizeof(sp));
+    int priorityMin = sched_get_priority_min(policy);
+    int priorityMax = sched_get_priority_max(policy);
+    sp.sched_priority = (a_priority < priorityMin) ? priorityMin : ((a_priority > priorityMax) ? priorityMax : a_priority);
 
-    pthread_getschedparam (m_handle, &policy, &sp);
+    m_priorityApplied = (pthread_setschedparam(m_handle, policy, &sp) == 0);
 
-    switch (m_priorityLevel)
+#endif
+
+    return (m_priorityApplied);
+}
+
+
+//==============================================================================
+/*!
+    This method pins the thread to a single core.
+
+    \param  a_core  Index of the core, starting at 0.
+
+    \return __true__ if the affinity was applied, __false__ otherwise.
+*/
+//==============================================================================
+bool cThread::setAffinity(const int a_core)
+{
+    std::vector<int> cores(1, a_core);
+    return (setAffinity(cores));
+}
+
+
+//==============================================================================
+/*!
+    This method restricts the thread to run on the given set of cores. 
+    Mac OS X does not support explicit core pinning, so this method always 
+    fails on that platform.
+
+    \param  a_cores  Indices of the cores, starting at 0.
+
+    \return __true__ if the affinity was applied, __false__ otherwise.
+*/
+//==============================================================================
+bool cThread::setAffinity(const std::vector<int>& a_cores)
+{
+    if (!m_started || a_cores.empty()) return (C_ERROR);
+
+#if defined(WIN32) | defined(WIN64)
+
+    DWORD_PTR mask = 0;
+    for (unsigned int i=0; i<a_cores.size(); i++)
     {
-        case CTHREAD_PRIORITY_GRAPHICS:
-        sp.sched_priority = 75;
-        break;
+        if ((a_cores[i] < 0) || (a_cores[i] >= (int)(8 * sizeof(DWORD_PTR)))) return (C_ERROR);
+        mask |= ((DWORD_PTR)1 << a_cores[i]);
+    }
 
-        case CTHREAD_PRIORITY_HAPTICS:
-        sp.sched_priority = 99;
-        break;
+    return (SetThreadAffinityMask(m_threadHandle, mask) != 0);
+
+#elif defined(LINUX)
+
+    cpu_set_t set;
+    CPU_ZERO(&set);
+    for (unsigned int i=0; i<a_cores.size(); i++)
+    {
+        if ((a_cores[i] < 0) || (a_cores[i] >= CPU_SETSIZE)) return (C_ERROR);
+        CPU_SET(a_cores[i], &set);
     }
 
-    pthread_setschedparam(m_handle, SCHED_FIFO, &sp);
+    return (pthread_setaffinity_np(m_handle, sizeof(set), &set) == 0);
+
+#else
+
+    return (C_ERROR);
 
 #endif
 }
 
 
+//==============================================================================
+/*!
+    This method sets the name of the thread, as shown by debuggers and 
+    system tools such as __top__ or __ps__. On Linux, names are truncated 
+    to 15 characters. On Mac OS X, only the calling thread can be named, 
+    so this method must be called from within the thread function.
+    Not supported on Windows. \n
+
+    \param  a_name  Name of the thread.
+
+    \return __true__ if the name was applied, __false__ otherwise.
+*/
+//==============================================================================
+bool cThread::setName(const std::string& a_name)
+{
+    if (!m_started) return (C_ERROR);
+
+#if defined(LINUX)
+
+    std::string name = a_name.substr(0, 15);
+    return (pthread_setname_np(m_handle, name.c_str()) == 0);
+
+#elif defined(MACOSX)
+
+    if (!pthread_equal(m_handle, pthread_self())) return (C_ERROR);
+    return (pthread_setname_np(a_name.c_str()) == 0);
+
+#else
+
+    return (C_ERROR);
+
+#endif
+}
+
+
+//==============================================================================
+/*!
+    This method locks the memory pages of the process in RAM, so that a 
+    real-time loop never waits for a page to be swapped in. This usually 
+    requires the process to hold the `CAP_IPC_LOCK` capability or a 
+    sufficient `memlock` limit. Not supported on Windows. \n
+
+    Future pages are only locked as well if the `memlock` limit is 
+    unlimited. Under a finite limit, locking future pages would make every 
+    allocation fail once the limit is reached (e.g. graphics buffers or 
+    images loaded later by a GUI process), so only the pages mapped at the
+    time of the call are locked. Memory allocated afterwards by a real-time
+    loop should then be touched before the loop starts.
+
+    \return __true__ if the memory was locked, __false__ otherwise.
+*/
+//==============================================================================
+bool cThread::lockMemory()
+{
+#if defined(LINUX) || defined(MACOSX)
+    int flags = MCL_CURRENT;
+    struct rlimit limit;
+    if ((getrlimit(RLIMIT_MEMLOCK, &limit) == 0) && (limit.rlim_cur == RLIM_INFINITY))
+    {
+        flags |= MCL_FUTURE;
+    }
+    return (mlockall(flags) == 0);
+#else
+    return (C_ERROR);
+#endif
+}
+
+
+//==============================================================================
+/*!
+    This method writes to a number of bytes of the stack of the calling 
+    thread, so that the corresponding pages are mapped before a real-time 
+    loop starts. It must be called from within the thread function, 
+    preferably after lockMemory().
+
+    \param  a_numBytes  Number of bytes to prefault.
+
+    \return __true__ once the stack has been touched.
+*/
+//==============================================================================
+bool cThread::prefaultStack(const size_t a_numBytes)
+{
+    if (a_numBytes == 0) return (C_SUCCESS);
+
+#if defined(WIN32) | defined(WIN64)
+    volatile unsigned char* buffer = (volatile unsigned char*)_alloca(a_numBytes);
+#else
+    volatile unsigned char* buffer = (volatile unsigned char*)alloca(a_numBytes);
+#endif
+
+    // touch one byte per page (4 KB pages or larger)
+    for (size_t i=0; i<a_numBytes; i+=4096)
+    {
+        buffer[i] = 0;
+    }
+    buffer[a_numBytes-1] = 0;
+
+    return (C_SUCCESS);
+}
+
+
+//==============================================================================
+/*!
+    This method returns the number of cores available to the process.
+
+    \return Number of cores, or 0 if unknown.
+*/
+//==============================================================================
+unsigned int cThread::getNumCores()
+{
+    return (std::thread::hardware_concurrency());
+}
+
+
+//==============================================================================
+/*!
+    This method returns the list of cores isolated from the scheduler of the 
+    operating system (Linux kernel parameter `isolcpus`). Such cores only run 
+    threads explicitly pinned to them with setAffinity(), which makes them 
+    well suited to haptic loops. On other platforms the list is empty.
+
+    \return Indices of the isolated cores.
+*/
+//==============================================================================
+std::vector<int> cThread::getIsolatedCores()
+{
+    std::vector<int> cores;
+
+#if defined(LINUX)
+
+    std::ifstream file("/sys/devices/system/cpu/isolated");
+    if (!file.is_open()) return (cores);
+
+    std::string line;
+    std::getline(file, line);
+
+    // parse list such as "2-3,5"
+    std::stringstream list(line);
+    std::string range;
+    while (std::getline(list, range, ','))
+    {
+        int first, last;
+        char dash;
+        std::stringstream item(range);
+        if (!(item >> first)) continue;
+        if (!(item >> dash >> last) || (dash != '-')) last = first;
+        for (int i=first; i<=last; i++)
+        {
+            cores.push_back(i);
+        }
+    }
+
+#endif
+
+    return (cores);
+}
+
+
 //------------------------------------------------------------------------------
 } // namespace chai3d
 //------------------------------------------------------------------------------
@@ -47,6 +47,10 @@
 #define CThreadH
 //------------------------------------------------------------------------------
 #include "system/CGlobals.h"
+#include "math/CConstants.h"
+//------------------------------------------------------------------------------
+#include <string>
+#include <vector>
 //------------------------------------------------------------------------------
 
 //------------------------------------------------------------------------------
@@ -76,6 +80,25 @@ enum CThreadPriority
 };
 
 
+//------------------------------------------------------------------------------
+/*!
+    Defines the scheduling policies that can be requested for a thread.
+*/
+//------------------------------------------------------------------------------
+enum CThreadPolicy
+{
+    CTHREAD_POLICY_DEFAULT,       // time-sharing (SCHED_OTHER)
+    CTHREAD_POLICY_FIFO,          // real-time, first in first out (SCHED_FIFO)
+    CTHREAD_POLICY_ROUND_ROBIN    // real-time, round robin (SCHED_RR)
+};
+
+
+//------------------------------------------------------------------------------
+//! Default number of bytes of stack prefaulted by cThread::prefaultStack().
+#define CTHREAD_PREFAULT_STACK_SIZE (256 * 1024)
+//------------------------------------------------------------------------------
+
+
 //==============================================================================
 /*!
     \class      cThread
@@ -92,8 +115,17 @@ enum CThreadPriority
     
     A scheduling priority level, as defined in __CThreadPriority__, can be 
     requested for a thread, but is not guaranteed to be honored by the 
-    operating system.
-
+    operating system. Method getPriorityApplied() reports whether the 
+    request succeeded (real-time priorities usually require additional 
+    permissions). \n
+
+    For real-time loops, a thread can be given an explicit scheduling 
+    policy and priority (setScheduling()), pinned to one or more cores, 
+    for instance cores isolated from the scheduler (setAffinity(), 
+    getIsolatedCores()), and named (setName()). Static methods 
+    lockMemory() and prefaultStack() are called from within the thread 
+    function to avoid page faults once the loop is running. Each of 
+    these methods returns __true__ if it succeeded, __false__ otherwise.
 */
 //==============================================================================
 
@@ -128,11 +160,45 @@ public:
     void stop();
 
     //! This method sets the thread priority level.
-    void setPriority(CThreadPriority a_level);
+    bool setPriority(CThreadPriority a_level);
 
     //! This method returns the current thread priority level.
     CThreadPriority getPriority() const { return (m_priorityLevel); }
 
+    //! This method returns __true__ if the last requested priority or scheduling policy was applied by the operating system.
+    bool getPriorityApplied() const { return (m_priorityApplied); }
+
+    //! This method sets the scheduling policy and priority of the thread.
+    bool setScheduling(const CThreadPolicy a_policy, const int a_priority);
+
+    //! This method pins the thread to a single core.
+    bool setAffinity(const int a_core);
+
+    //! This method restricts the thread to a set of cores.
+    bool setAffinity(const std::vector<int>& a_cores);
+
+    //! This method sets the name of the thread, as shown by debuggers and system tools.
+    bool setName(const std::string& a_name);
+
+
+    //--------------------------------------------------------------------------
+    // PUBLIC STATIC METHODS:
+    //--------------------------------------------------------------------------
+
+public:
+
+    //! This method locks the current memory pages of the process in RAM, and future pages if the memlock limit is unlimited.
+    static bool lockMemory();
+
+    //! This method touches a number of bytes of the stack of the calling thread, so that they are mapped in memory.
+    static bool prefaultStack(const size_t a_numBytes = CTHREAD_PREFAULT_STACK_SIZE);
+
+    //! This method returns the number of cores available to the process.
+    static unsigned int getNumCores();
+
+    //! This method returns the list of cores isolated from the scheduler of the operating system.
+    static std::vector<int> getIsolatedCores();
+
 
     //--------------------------------------------------------------------------
     // PROTECTED MEMBERS:
@@ -141,8 +207,11 @@ public:
 protected:
 
 #if defined(WIN32) | defined(WIN64)
-    //! Thread handle.
+    //! Thread identifier.
     DWORD m_threadId;
+
+    //! Thread handle.
+    HANDLE m_threadHandle;
 #endif
 
 #if defined(LINUX) || defined(MACOSX)
@@ -155,6 +224,12 @@ protected:
 
     //! Thread priority level.
     CThreadPriority m_priorityLevel;
+
+    //! If __true__, then the last requested priority was applied.
+    bool m_priorityApplied;
+
+    //! If __true__, then the thread has been started.
+    bool m_started;
 };
 
 //------------------------------------------------------------------------------
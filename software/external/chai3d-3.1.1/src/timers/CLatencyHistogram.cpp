@@ -0,0 +1,263 @@
+//==============================================================================
+/*
+    Software License Agreement (BSD License)
+    Copyright (c) 2003-2016, CHAI3D.
+    (www.chai3d.org)
+
+    All rights reserved.
+
+    Redistribution and use in source and binary forms, with or without
+    modification, are permitted provided that the following conditions
+    are met:
+
+    * Redistributions of source code must retain the above copyright
+    notice, this list of conditions and the following disclaimer.
+
+    * Redistributions in binary form must reproduce the above
+    copyright notice, this list of conditions and the following
+    disclaimer in the documentation and/or other materials provided
+    with the distribution.
+
+    * Neither the name of CHAI3D nor the names of its contributors may
+    be used to endorse or promote products derived from this software
+    without specific prior written permission.
+
+    THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS
+    "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT
+    LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS
+    FOR A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE
+    COPYRIGHT OWNER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT,
+    INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING,
+    BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES;
+    LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER
+    CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT
+    LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN
+    ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE
+    POSSIBILITY OF SUCH DAMAGE. 
+
+
+    \author    <http://www.chai3d.org>
+    \version   3.1.1 $Rev: 1869 $
+*/
+//==============================================================================
+
+//------------------------------------------------------------------------------
+#include "timers/CLatencyHistogram.h"
+//------------------------------------------------------------------------------
+#include <cmath>
+//------------------------------------------------------------------------------
+
+//------------------------------------------------------------------------------
+namespace chai3d {
+//------------------------------------------------------------------------------
+
+//==============================================================================
+/*!
+    This method clears the snapshot.
+*/
+//==============================================================================
+void cLatencyHistogramSnapshot::clear()
+{
+    m_counts.assign(C_LATENCY_HISTOGRAM_NUM_BUCKETS, 0);
+    m_count = 0;
+    m_sum = 0;
+    m_max = 0;
+    m_overruns = 0;
+}
+
+
+//==============================================================================
+/*!
+    This method subtracts an earlier snapshot of the same histogram, so that 
+    this snapshot only contains the values recorded between both snapshots. \n
+
+    The maximum value of the interval is estimated from the highest bucket
+    that contains values, and is therefore known within the resolution of 
+    the histogram.
+
+    \param  a_previous  Snapshot taken earlier from the same histogram.
+*/
+//==============================================================================
+void cLatencyHistogramSnapshot::subtract(const cLatencyHistogramSnapshot& a_previous)
+{
+    unsigned long long max = 0;
+
+    for (unsigned int i=0; i<C_LATENCY_HISTOGRAM_NUM_BUCKETS; i++)
+    {
+        m_counts[i] = (m_counts[i] > a_previous.m_counts[i]) ? (m_counts[i] - a_previous.m_counts[i]) : 0;
+        if (m_counts[i] > 0)
+        {
+            max = cLatencyHistogram::getBucketHighestValue(i);
+        }
+    }
+
+    m_count    = (m_count > a_previous.m_count) ? (m_count - a_previous.m_count) : 0;
+    m_sum      = (m_sum > a_previous.m_sum) ? (m_sum - a_previous.m_sum) : 0;
+    m_overruns = (m_overruns > a_previous.m_overruns) ? (m_overruns - a_previous.m_overruns) : 0;
+    m_max      = (max < m_max) ? max : m_max;
+}
+
+
+//==============================================================================
+/*!
+    This method returns the value below which a given percentage of the 
+    recorded values fall. The highest value of the bucket is returned, so
+    that the result is never below the exact percentile.
+
+    \param  a_percent  Percentage (for instance 99.9).
+
+    \return Percentile in nanoseconds, or 0 if no value was recorded.
+*/
+//==============================================================================
+unsigned long long cLatencyHistogramSnapshot::getPercentile(const double a_percent) const
+{
+    if (m_count == 0) { return (0); }
+
+    // rank of the requested value
+    double percent = (a_percent < 0.0) ? 0.0 : ((a_percent > 100.0) ? 100.0 : a_percent);
+    unsigned long long rank = (unsigned long long)ceil(0.01 * percent * (double)m_count);
+    if (rank < 1) { rank = 1; }
+
+    unsigned long long count = 0;
+    for (unsigned int i=0; i<C_LATENCY_HISTOGRAM_NUM_BUCKETS; i++)
+    {
+        count += m_counts[i];
+        if (count >= rank)
+        {
+            unsigned long long value = cLatencyHistogram::getBucketHighestValue(i);
+            return ((value < m_max) ? value : m_max);
+        }
+    }
+
+    return (m_max);
+}
+
+
+//==============================================================================
+/*!
+    Constructor of cLatencyHistogram.
+
+    \param  a_overrunThreshold  Threshold in seconds above which values are 
+                                counted as overruns (0 = disabled).
+*/
+//==============================================================================
+cLatencyHistogram::cLatencyHistogram(const double a_overrunThreshold)
+{
+    for (unsigned int i=0; i<C_LATENCY_HISTOGRAM_NUM_BUCKETS; i++)
+    {
+        m_counts[i].store(0);
+    }
+    m_count.store(0);
+    m_sum.store(0);
+    m_max.store(0);
+    m_overruns.store(0);
+    m_periodStart = 0;
+
+    setOverrunThreshold(a_overrunThreshold);
+}
+
+
+//==============================================================================
+/*!
+    This method records the time elapsed since its previous call. The first
+    call only starts the measurement.
+*/
+//==============================================================================
+void cLatencyHistogram::recordPeriod()
+{
+    unsigned long long time = (unsigned long long)cPrecisionClock::getSystemTimeNanoseconds();
+
+    if (m_periodStart > 0)
+    {
+        record(time - m_periodStart);
+    }
+
+    m_periodStart = time;
+}
+
+
+//==============================================================================
+/*!
+    This method copies the current content of the histogram. It may be called
+    from any thread while values are being recorded, in which case the values
+    recorded during the copy may be partially included.
+
+    \param  a_snapshot  Returned snapshot.
+*/
+//==============================================================================
+void cLatencyHistogram::getSnapshot(cLatencyHistogramSnapshot& a_snapshot) const
+{
+    a_snapshot.m_counts.resize(C_LATENCY_HISTOGRAM_NUM_BUCKETS);
+
+    // the count is read first, so that it never exceeds the sum of the buckets
+    a_snapshot.m_count = m_count.load(std::memory_order_acquire);
+    a_snapshot.m_sum = m_sum.load(std::memory_order_relaxed);
+    a_snapshot.m_max = m_max.load(std::memory_order_relaxed);
+    a_snapshot.m_overruns = m_overruns.load(std::memory_order_relaxed);
+
+    for (unsigned int i=0; i<C_LATENCY_HISTOGRAM_NUM_BUCKETS; i++)
+    {
+        a_snapshot.m_counts[i] = m_counts[i].load(std::memory_order_relaxed);
+    }
+}
+
+
+//==============================================================================
+/*!
+    This method sets the threshold above which values are counted as overruns.
+
+    \param  a_overrunThreshold  Threshold in seconds (0 = disabled).
+*/
+//==============================================================================
+void cLatencyHistogram::setOverrunThreshold(const double a_overrunThreshold)
+{
+    m_overrunThreshold = (a_overrunThreshold > 0.0) ? (unsigned long long)(a_overrunThreshold * 1e9) : 0;
+}
+
+
+//==============================================================================
+/*!
+    This method returns the smallest value stored in a bucket.
+
+    \param  a_index  Index of bucket.
+
+    \return Value in nanoseconds.
+*/
+//==============================================================================
+unsigned long long cLatencyHistogram::getBucketLowestValue(const unsigned int a_index)
+{
+    if (a_index < C_LATENCY_HISTOGRAM_SUB_BUCKET_COUNT)
+    {
+        return (a_index);
+    }
+
+    unsigned int shift = a_index / C_LATENCY_HISTOGRAM_SUB_BUCKET_COUNT - 1;
+    unsigned long long subBucket = C_LATENCY_HISTOGRAM_SUB_BUCKET_COUNT + a_index % C_LATENCY_HISTOGRAM_SUB_BUCKET_COUNT;
+    return (subBucket << shift);
+}
+
+
+//==============================================================================
+/*!
+    This method returns the largest value stored in a bucket.
+
+    \param  a_index  Index of bucket.
+
+    \return Value in nanoseconds.
+*/
+//==============================================================================
+unsigned long long cLatencyHistogram::getBucketHighestValue(const unsigned int a_index)
+{
+    if (a_index < C_LATENCY_HISTOGRAM_SUB_BUCKET_COUNT)
+    {
+        return (a_index);
+    }
+
+    unsigned int shift = a_index / C_LATENCY_HISTOGRAM_SUB_BUCKET_COUNT - 1;
+    return (getBucketLowestValue(a_index) + ((1ULL << shift) - 1));
+}
+
+
+//------------------------------------------------------------------------------
+} // namespace chai3d
+//------------------------------------------------------------------------------
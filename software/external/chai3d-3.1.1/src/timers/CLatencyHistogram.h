@@ -0,0 +1,377 @@
+//==============================================================================
+/*
+    Software License Agreement (BSD License)
+    Copyright (c) 2003-2016, CHAI3D.
+    (www.chai3d.org)
+
+    All rights reserved.
+
+    Redistribution and use in source and binary forms, with or without
+    modification, are permitted provided that the following conditions
+    are met:
+
+    * Redistributions of source code must retain the above copyright
+    notice, this list of conditions and the following disclaimer.
+
+    * Redistributions in binary form must reproduce the above
+    copyright notice, this list of conditions and the following
+    disclaimer in the documentation and/or other materials provided
+    with the distribution.
+
+    * Neither the name of CHAI3D nor the names of its contributors may
+    be used to endorse or promote products derived from this software
+    without specific prior written permission.
+
+    THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS
+    "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT
+    LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS
+    FOR A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE
+    COPYRIGHT OWNER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT,
+    INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING,
+    BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES;
+    LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER
+    CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT
+    LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN
+    ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE
+    POSSIBILITY OF SUCH DAMAGE. 
+
+
+    \author    <http://www.chai3d.org>
+    \version   3.1.1 $Rev: 1869 $
+*/
+//==============================================================================
+
+//------------------------------------------------------------------------------
+#ifndef CLatencyHistogramH
+#define CLatencyHistogramH
+//------------------------------------------------------------------------------
+#include "system/CGlobals.h"
+#include "timers/CPrecisionClock.h"
+//------------------------------------------------------------------------------
+#include <atomic>
+#include <vector>
+//------------------------------------------------------------------------------
+
+//------------------------------------------------------------------------------
+namespace chai3d {
+//------------------------------------------------------------------------------
+
+//==============================================================================
+/*!
+    \file       CLatencyHistogram.h
+    \ingroup    timers
+
+    \brief
+    Implements a histogram of latencies.
+*/
+//==============================================================================
+
+//------------------------------------------------------------------------------
+//! Number of bits of the sub-buckets of each power of two (32 sub-buckets, ~3% resolution).
+#define C_LATENCY_HISTOGRAM_SUB_BUCKET_BITS 5
+
+//! Number of sub-buckets of each power of two.
+#define C_LATENCY_HISTOGRAM_SUB_BUCKET_COUNT (1 << C_LATENCY_HISTOGRAM_SUB_BUCKET_BITS)
+
+//! Total number of buckets, covering all 64-bit values.
+#define C_LATENCY_HISTOGRAM_NUM_BUCKETS ((64 - C_LATENCY_HISTOGRAM_SUB_BUCKET_BITS + 1) * C_LATENCY_HISTOGRAM_SUB_BUCKET_COUNT)
+//------------------------------------------------------------------------------
+
+//==============================================================================
+/*!
+    \class      cLatencyHistogramSnapshot
+    \ingroup    timers
+
+    \brief
+    This class stores a copy of a latency histogram.
+
+    \details
+    __cLatencyHistogramSnapshot__ is filled by 
+    \ref cLatencyHistogram::getSnapshot() and provides the statistics of the
+    recorded values (count, mean, maximum, percentiles and overruns). 
+    All values are expressed in nanoseconds. \n
+
+    Snapshots are cumulative. The statistics of an interval of time are 
+    obtained by subtracting the snapshot taken at the beginning of the 
+    interval (see \ref subtract()).
+*/
+//==============================================================================
+class cLatencyHistogramSnapshot
+{
+    //--------------------------------------------------------------------------
+    // CONSTRUCTOR & DESTRUCTOR:
+    //--------------------------------------------------------------------------
+
+public:
+
+    //! Constructor of cLatencyHistogramSnapshot.
+    cLatencyHistogramSnapshot() { clear(); }
+
+    //! Destructor of cLatencyHistogramSnapshot.
+    virtual ~cLatencyHistogramSnapshot() {}
+
+
+    //--------------------------------------------------------------------------
+    // PUBLIC METHODS:
+    //--------------------------------------------------------------------------
+
+public:
+
+    //! This method clears the snapshot.
+    void clear();
+
+    //! This method subtracts an earlier snapshot of the same histogram, leaving the values recorded in between.
+    void subtract(const cLatencyHistogramSnapshot& a_previous);
+
+    //! This method returns the number of recorded values.
+    unsigned long long getCount() const { return (m_count); }
+
+    //! This method returns the number of values above the overrun threshold.
+    unsigned long long getOverruns() const { return (m_overruns); }
+
+    //! This method returns the mean value in nanoseconds.
+    double getMean() const { return ((m_count > 0) ? ((double)m_sum / (double)m_count) : 0.0); }
+
+    //! This method returns the maximum value in nanoseconds.
+    unsigned long long getMax() const { return (m_max); }
+
+    //! This method returns the value in nanoseconds below which a given percentage of values fall.
+    unsigned long long getPercentile(const double a_percent) const;
+
+    //! This method returns the value in seconds below which a given percentage of values fall.
+    double getPercentileSeconds(const double a_percent) const { return (1e-9 * (double)getPercentile(a_percent)); }
+
+
+    //--------------------------------------------------------------------------
+    // PUBLIC MEMBERS:
+    //--------------------------------------------------------------------------
+
+public:
+
+    //! Number of values recorded in each bucket.
+    std::vector<unsigned long long> m_counts;
+
+    //! Number of recorded values.
+    unsigned long long m_count;
+
+    //! Sum of recorded values in nanoseconds.
+    unsigned long long m_sum;
+
+    //! Maximum recorded value in nanoseconds.
+    unsigned long long m_max;
+
+    //! Number of values above the overrun threshold.
+    unsigned long long m_overruns;
+};
+
+
+//==============================================================================
+/*!
+    \class      cLatencyHistogram
+    \ingroup    timers
+
+    \brief
+    This class implements a histogram of latencies.
+
+    \details
+    __cLatencyHistogram__ records durations (in nanoseconds) into buckets of
+    logarithmically increasing width. Each power of two is divided into 32 
+    sub-buckets, so that every value is stored with a relative error below 
+    3%, from nanoseconds to hours, using a fixed amount of memory. \n
+
+    Values are recorded by a single thread (for instance the haptic 
+    thread), without locks or memory allocation. Snapshots may be taken 
+    from any other thread at any time by calling \ref getSnapshot(). \n
+
+    Besides \ref record(), method \ref recordPeriod() measures the time 
+    between two successive calls (for instance the period of a servo loop),
+    and class \ref cScopedLatencyTimer measures the time spent in a block 
+    of code. Values above a programmable threshold are counted as overruns.
+*/
+//==============================================================================
+class cLatencyHistogram
+{
+    //--------------------------------------------------------------------------
+    // CONSTRUCTOR & DESTRUCTOR:
+    //--------------------------------------------------------------------------
+
+public:
+
+    //! Constructor of cLatencyHistogram.
+    cLatencyHistogram(const double a_overrunThreshold = 0.0);
+
+    //! Destructor of cLatencyHistogram.
+    virtual ~cLatencyHistogram() {}
+
+
+    //--------------------------------------------------------------------------
+    // PUBLIC METHODS:
+    //--------------------------------------------------------------------------
+
+public:
+
+    //! This method records a value in nanoseconds. It must always be called from the same thread.
+    inline void record(const unsigned long long a_value)
+    {
+        increment(m_counts[getBucketIndex(a_value)]);
+        m_count.store(m_count.load(std::memory_order_relaxed) + 1, std::memory_order_release);
+        m_sum.store(m_sum.load(std::memory_order_relaxed) + a_value, std::memory_order_relaxed);
+        if (a_value > m_max.load(std::memory_order_relaxed))
+        {
+            m_max.store(a_value, std::memory_order_relaxed);
+        }
+        if ((m_overrunThreshold > 0) && (a_value > m_overrunThreshold))
+        {
+            increment(m_overruns);
+        }
+    }
+
+    //! This method records a value in seconds. It must always be called from the same thread.
+    inline void recordSeconds(const double a_value) { record((a_value > 0.0) ? (unsigned long long)(a_value * 1e9) : 0); }
+
+    //! This method records the time elapsed since its previous call. It must always be called from the same thread.
+    void recordPeriod();
+
+    //! This method copies the current content of the histogram. It may be called from any thread.
+    void getSnapshot(cLatencyHistogramSnapshot& a_snapshot) const;
+
+    //! This method sets the threshold in seconds above which values are counted as overruns (0 = disabled).
+    void setOverrunThreshold(const double a_overrunThreshold);
+
+    //! This method returns the threshold in seconds above which values are counted as overruns.
+    double getOverrunThreshold() const { return (1e-9 * (double)m_overrunThreshold); }
+
+
+    //--------------------------------------------------------------------------
+    // PUBLIC STATIC METHODS:
+    //--------------------------------------------------------------------------
+
+public:
+
+    //! This method returns the bucket in which a value is stored.
+    static inline unsigned int getBucketIndex(const unsigned long long a_value)
+    {
+        if (a_value < C_LATENCY_HISTOGRAM_SUB_BUCKET_COUNT)
+        {
+            return ((unsigned int)a_value);
+        }
+        unsigned int shift = getMostSignificantBit(a_value) - C_LATENCY_HISTOGRAM_SUB_BUCKET_BITS;
+        return ((shift + 1) * C_LATENCY_HISTOGRAM_SUB_BUCKET_COUNT + (unsigned int)(a_value >> shift) - C_LATENCY_HISTOGRAM_SUB_BUCKET_COUNT);
+    }
+
+    //! This method returns the smallest value stored in a bucket.
+    static unsigned long long getBucketLowestValue(const unsigned int a_index);
+
+    //! This method returns the largest value stored in a bucket.
+    static unsigned long long getBucketHighestValue(const unsigned int a_index);
+
+
+    //--------------------------------------------------------------------------
+    // PROTECTED METHODS:
+    //--------------------------------------------------------------------------
+
+protected:
+
+    //! This method increments a counter owned by the recording thread.
+    static inline void increment(std::atomic<unsigned long long>& a_counter)
+    {
+        a_counter.store(a_counter.load(std::memory_order_relaxed) + 1, std::memory_order_relaxed);
+    }
+
+    //! This method returns the position of the most significant bit of a non-zero value.
+    static inline unsigned int getMostSignificantBit(const unsigned long long a_value)
+    {
+#if defined(__GNUC__)
+        return (63 - (unsigned int)__builtin_clzll(a_value));
+#else
+        unsigned int bit = 0;
+        unsigned long long value = a_value;
+        while (value >>= 1) { bit++; }
+        return (bit);
+#endif
+    }
+
+
+    //--------------------------------------------------------------------------
+    // PROTECTED MEMBERS:
+    //--------------------------------------------------------------------------
+
+protected:
+
+    //! Number of values recorded in each bucket.
+    std::atomic<unsigned long long> m_counts[C_LATENCY_HISTOGRAM_NUM_BUCKETS];
+
+    //! Number of recorded values.
+    std::atomic<unsigned long long> m_count;
+
+    //! Sum of recorded values in nanoseconds.
+    std::atomic<unsigned long long> m_sum;
+
+    //! Maximum recorded value in nanoseconds.
+    std::atomic<unsigned long long> m_max;
+
+    //! Number of values above the overrun threshold.
+    std::atomic<unsigned long long> m_overruns;
+
+    //! Threshold in nanoseconds above which values are counted as overruns.
+    unsigned long long m_overrunThreshold;
+
+    //! Time of the previous call to recordPeriod() in nanoseconds (0 = none).
+    unsigned long long m_periodStart;
+};
+
+
+//==============================================================================
+/*!
+    \class      cScopedLatencyTimer
+    \ingroup    timers
+
+    \brief
+    This class measures the time spent in a block of code.
+
+    \details
+    __cScopedLatencyTimer__ reads the time when it is created, and records 
+    the elapsed time in a latency histogram when it is destroyed, i.e. when 
+    the block of code in which it is declared is left.
+
+    \code
+    {
+        cScopedLatencyTimer timer(forceHistogram);
+        tool->computeInteractionForces();
+    }
+    \endcode
+*/
+//==============================================================================
+class cScopedLatencyTimer
+{
+public:
+
+    //! Constructor of cScopedLatencyTimer.
+    cScopedLatencyTimer(cLatencyHistogram& a_histogram) : 
+        m_histogram(a_histogram),
+        m_start((unsigned long long)cPrecisionClock::getSystemTimeNanoseconds()) {}
+
+    //! Destructor of cScopedLatencyTimer. Records the elapsed time.
+    ~cScopedLatencyTimer() { m_histogram.record((unsigned long long)cPrecisionClock::getSystemTimeNanoseconds() - m_start); }
+
+protected:
+
+    //! Histogram in which the elapsed time is recorded.
+    cLatencyHistogram& m_histogram;
+
+    //! Time when the timer was created in nanoseconds.
+    unsigned long long m_start;
+
+private:
+
+    cScopedLatencyTimer(const cScopedLatencyTimer&);
+    cScopedLatencyTimer& operator=(const cScopedLatencyTimer&);
+};
+
+//------------------------------------------------------------------------------
+} // namespace chai3d
+//------------------------------------------------------------------------------
+
+//------------------------------------------------------------------------------
+#endif
+//------------------------------------------------------------------------------
@@ -44,11 +44,34 @@
 //------------------------------------------------------------------------------
 #include "timers/CPrecisionClock.h"
 //------------------------------------------------------------------------------
+#if defined(__x86_64__) || defined(__i386__) || defined(_M_X64) || defined(_M_IX86)
+#define C_PRECISION_CLOCK_USE_TSC
+#if defined(_MSC_VER)
+#include <intrin.h>
+#else
+#include <cpuid.h>
+#include <x86intrin.h>
+#endif
+#endif
+//------------------------------------------------------------------------------
 
 //------------------------------------------------------------------------------
 namespace chai3d {
 //------------------------------------------------------------------------------
 
+//------------------------------------------------------------------------------
+#ifndef DOXYGEN_SHOULD_SKIP_THIS
+//------------------------------------------------------------------------------
+
+CPrecisionClockSource cPrecisionClock::s_clockSource = CPRECISIONCLOCK_SOURCE_SYSTEM;
+unsigned long long cPrecisionClock::s_tscBase = 0;
+long long cPrecisionClock::s_tscBaseTime = 0;
+unsigned long long cPrecisionClock::s_tscScale = 0;
+
+//------------------------------------------------------------------------------
+#endif  // DOXYGEN_SHOULD_SKIP_THIS
+//------------------------------------------------------------------------------
+
 //==============================================================================
 /*!
     Constructor of cPrecisionClock. The clock is initialized to zero.
@@ -76,10 +99,11 @@ cPrecisionClock::cPrecisionClock()
 #endif
 
     // initialize the time counter
-    m_timeAccumulated = 0.0;
+    m_timeAccumulated = 0;
 
     // initialize timeout period
-    m_timeoutPeriod = 0.0;
+    m_timeoutPeriod = 0;
+    m_timeoutStart = 0.0;
 
     // reset clock
     reset();
@@ -97,10 +121,10 @@ cPrecisionClock::cPrecisionClock()
 void cPrecisionClock::reset(const double a_currentTime)
 {
     // initialize clock
-    m_timeAccumulated = a_currentTime;
+    m_timeAccumulated = (long long)(a_currentTime * 1e9);
 
     // store current CPU time as starting time
-    m_timeStart = getCPUTimeSeconds();
+    m_timeStart = getCPUTimeNanoseconds();
 }
 
 
@@ -118,16 +142,16 @@ void cPrecisionClock::reset(const double a_currentTime)
 double cPrecisionClock::start(const bool a_resetClock)
 {
     // store current CPU time as starting time
-    m_timeStart = getCPUTimeSeconds();
+    m_timeStart = getCPUTimeNanoseconds();
 
     if (a_resetClock)
-        m_timeAccumulated = 0.0;
+        m_timeAccumulated = 0;
 
     // timer is now on
     m_on = true;
 
     // return time when timer was started.
-    return (m_timeAccumulated);
+    return ((double)m_timeAccumulated * 1e-9);
 }
 
 
@@ -142,7 +166,7 @@ double cPrecisionClock::start(const bool a_resetClock)
 double cPrecisionClock::stop()
 {
     // how much time has now elapsed in total running "sessions"?
-    m_timeAccumulated += getCPUTimeSeconds() - m_timeStart;
+    m_timeAccumulated += getCPUTimeNanoseconds() - m_timeStart;
 
     // stop timer
     m_on = false;
@@ -163,13 +187,14 @@ double cPrecisionClock::stop()
 //==============================================================================
 void cPrecisionClock::setTimeoutPeriodSeconds(const double a_timeoutPeriod)
 {
-    m_timeoutPeriod = a_timeoutPeriod;
+    m_timeoutPeriod = (long long)(a_timeoutPeriod * 1e9);
 }
 
 
 //==============================================================================
 /*!
-    This method check if the clock has expired its _timeout_ period.
+    This method check if the clock has expired its _timeout_ period. 
+    The comparison is performed on integer nanoseconds.
 
     \return __true__ if _timeout_ occurred, otherwise __false__.
 */
@@ -177,7 +202,7 @@ void cPrecisionClock::setTimeoutPeriodSeconds(const double a_timeoutPeriod)
 bool cPrecisionClock::timeoutOccurred() const 
 {
     // check if timeout has occurred
-    if (getCurrentTimeSeconds() > m_timeoutPeriod)
+    if (getCurrentTimeNanoseconds() > m_timeoutPeriod)
     {
         return (true);
     }
@@ -190,16 +215,16 @@ bool cPrecisionClock::timeoutOccurred() const
 
 //==============================================================================
 /*!
-    This method returns the current time of clock in seconds.
+    This method returns the current time of clock in nanoseconds.
 
-    \return Current time in seconds.
+    \return Current time in nanoseconds.
 */
 //==============================================================================
-double cPrecisionClock::getCurrentTimeSeconds() const 
+long long cPrecisionClock::getCurrentTimeNanoseconds() const 
 {
     if (m_on)
     {
-        return (m_timeAccumulated + getCPUTimeSeconds() - m_timeStart);
+        return (m_timeAccumulated + getCPUTimeNanoseconds() - m_timeStart);
     }
 
     else return (m_timeAccumulated);
@@ -208,25 +233,189 @@ double cPrecisionClock::getCurrentTimeSeconds() const
 
 //==============================================================================
 /*!
-    This method returns the raw CPU time in seconds.
+    This method returns the raw CPU time in nanoseconds, read from the clock 
+    source selected by setClockSource().
+
+    \return Raw CPU clock time in nanoseconds.
+*/
+//==============================================================================
+long long cPrecisionClock::getCPUTimeNanoseconds()
+{
+#ifdef C_PRECISION_CLOCK_USE_TSC
+
+    if (s_clockSource == CPRECISIONCLOCK_SOURCE_TSC)
+    {
+        // 64 x 32.32 bit fixed-point product, split to avoid overflow
+        unsigned long long ticks = readTSC() - s_tscBase;
+        unsigned long long nanoseconds = (ticks >> 32) * s_tscScale + (((ticks & 0xffffffffULL) * s_tscScale) >> 32);
+        return (s_tscBaseTime + (long long)nanoseconds);
+    }
+
+#endif
+
+    return (getSystemTimeNanoseconds());
+}
+
+
+//==============================================================================
+/*!
+    This method selects the time source used by all clocks. Selecting 
+    __CPRECISIONCLOCK_SOURCE_TSC__ calibrates the time stamp counter against 
+    the system clock, which takes about 50 ms. \n
 
-    \return Raw CPU clock time in seconds.
+    Clocks that are running when the source changes may jump by the offset 
+    between both sources, so this method should be called at startup.
+
+    \param  a_source  Clock source.
+
+    \return __true__ if the clock source was selected, __false__ if it is not 
+            available on this computer (the system clock is then used).
 */
 //==============================================================================
-double cPrecisionClock::getCPUTimeSeconds() const 
+bool cPrecisionClock::setClockSource(const CPrecisionClockSource a_source)
+{
+    if (a_source == CPRECISIONCLOCK_SOURCE_SYSTEM)
+    {
+        s_clockSource = CPRECISIONCLOCK_SOURCE_SYSTEM;
+        return (C_SUCCESS);
+    }
+
+#ifdef C_PRECISION_CLOCK_USE_TSC
+
+    if (s_clockSource == CPRECISIONCLOCK_SOURCE_TSC)
+    {
+        return (C_SUCCESS);
+    }
+
+    // a TSC that varies with power states cannot be used as a time source
+    if (!getInvariantTSCAvailable())
+    {
+        return (C_ERROR);
+    }
+
+    // each sample pairs a system time with the TSC value read halfway through
+    // the system call; the tightest of several attempts is kept
+    unsigned long long tsc[2];
+    long long time[2];
+    for (int i=0; i<2; i++)
+    {
+        unsigned long long window = ~0ULL;
+        for (int j=0; j<16; j++)
+        {
+            unsigned long long t0 = readTSC();
+            long long t = getSystemTimeNanoseconds();
+            unsigned long long t1 = readTSC();
+            if (t1 - t0 < window)
+            {
+                window = t1 - t0;
+                tsc[i] = t0 + (t1 - t0) / 2;
+                time[i] = t;
+            }
+        }
+
+        // calibration interval
+        if (i == 0)
+        {
+            long long end = getSystemTimeNanoseconds() + 50000000LL;
+            while (getSystemTimeNanoseconds() < end) {}
+        }
+    }
+
+    if ((tsc[1] <= tsc[0]) || (time[1] <= time[0]))
+    {
+        return (C_ERROR);
+    }
+
+    // nanoseconds per tick in 32.32 fixed point; TSC must run at 1 GHz or more 
+    // so that the scale fits in 32 bits
+    unsigned long long scale = ((unsigned long long)(time[1] - time[0]) << 32) / (tsc[1] - tsc[0]);
+    if (scale >= (1ULL << 32))
+    {
+        return (C_ERROR);
+    }
+
+    s_tscBase = tsc[1];
+    s_tscBaseTime = time[1];
+    s_tscScale = scale;
+    s_clockSource = CPRECISIONCLOCK_SOURCE_TSC;
+
+    return (C_SUCCESS);
+
+#else
+
+    return (C_ERROR);
+
+#endif
+}
+
+
+//==============================================================================
+/*!
+    This method checks whether the CPU provides an invariant time stamp 
+    counter, that is, one that runs at a constant rate in all power states 
+    and is synchronized across cores.
+
+    \return __true__ if an invariant TSC is available, __false__ otherwise.
+*/
+//==============================================================================
+bool cPrecisionClock::getInvariantTSCAvailable()
+{
+#ifdef C_PRECISION_CLOCK_USE_TSC
+
+    // CPUID leaf 0x80000007 (advanced power management), EDX bit 8
+    unsigned int regs[4] = { 0, 0, 0, 0 };
+
+#if defined(_MSC_VER)
+    int info[4];
+    __cpuid(info, 0x80000000);
+    if ((unsigned int)info[0] < 0x80000007) return (false);
+    __cpuid(info, 0x80000007);
+    regs[3] = (unsigned int)info[3];
+#else
+    if (__get_cpuid_max(0x80000000, NULL) < 0x80000007) return (false);
+    __get_cpuid(0x80000007, &regs[0], &regs[1], &regs[2], &regs[3]);
+#endif
+
+    return ((regs[3] & (1 << 8)) != 0);
+
+#else
+
+    return (false);
+
+#endif
+}
+
+
+//==============================================================================
+/*!
+    This method returns the time of the monotonic clock of the operating 
+    system in nanoseconds. Unlike getCPUTimeNanoseconds(), it does not depend 
+    on the selected clock source. On Linux, it is read from `CLOCK_MONOTONIC` 
+    and can therefore be used for absolute sleeps on that clock.
+
+    \return System time in nanoseconds.
+*/
+//==============================================================================
+long long cPrecisionClock::getSystemTimeNanoseconds()
 {
 #if defined(WIN32) | defined(WIN64)
 
-    if (m_highres)
+    static LARGE_INTEGER freq = { 0 };
+    if (freq.QuadPart == 0)
+    {
+        QueryPerformanceFrequency(&freq);
+    }
+
+    if (freq.QuadPart > 0)
     {
-        __int64 curtime;
-        QueryPerformanceCounter( (LARGE_INTEGER *)&curtime );
-        return ((double)curtime / (double)m_freq.QuadPart);
+        LARGE_INTEGER time;
+        QueryPerformanceCounter(&time);
+        return ((time.QuadPart / freq.QuadPart) * 1000000000LL + ((time.QuadPart % freq.QuadPart) * 1000000000LL) / freq.QuadPart);
     }
 
     else
     {
-        return (((double)(GetTickCount())) / 1000.0);
+        return ((long long)GetTickCount() * 1000000LL);
     }
 
 #endif
@@ -235,25 +424,37 @@ double cPrecisionClock::getCPUTimeSeconds() const
 
     struct timespec time;
     clock_gettime (CLOCK_MONOTONIC, &time);
-    return ((double)(time.tv_sec + time.tv_nsec*1e-9));
+    return ((long long)time.tv_sec * 1000000000LL + (long long)time.tv_nsec);
 
 #endif
 
 #ifdef MACOSX
 
-    static double ratio = 0.0;
-
-    if (!ratio) 
+    static mach_timebase_info_data_t info = { 0, 0 };
+    if (info.denom == 0)
     {
-        mach_timebase_info_data_t info;
-        if (mach_timebase_info(&info) == KERN_SUCCESS) 
-        {
-            ratio = info.numer * 1e-9 * info.denom;
-        }
+        mach_timebase_info(&info);
     }
 
-    return (mach_absolute_time() * ratio);
+    return ((long long)(mach_absolute_time() * info.numer / info.denom));
+
+#endif
+}
+
+
+//==============================================================================
+/*!
+    This method reads the time stamp counter of the CPU.
 
+    \return Time stamp counter value, or 0 if not available.
+*/
+//==============================================================================
+unsigned long long cPrecisionClock::readTSC()
+{
+#ifdef C_PRECISION_CLOCK_USE_TSC
+    return ((unsigned long long)__rdtsc());
+#else
+    return (0);
 #endif
 }
 
@@ -46,6 +46,7 @@
 #define CPrecisionClockH
 //------------------------------------------------------------------------------
 #include "system/CGlobals.h"
+#include "math/CConstants.h"
 //------------------------------------------------------------------------------
 
 //------------------------------------------------------------------------------
@@ -62,6 +63,19 @@ namespace chai3d {
 */
 //==============================================================================
 
+//------------------------------------------------------------------------------
+/*!
+    Defines the time sources that can be used by all instances of 
+    cPrecisionClock.
+*/
+//------------------------------------------------------------------------------
+enum CPrecisionClockSource
+{
+    CPRECISIONCLOCK_SOURCE_SYSTEM,    // operating system monotonic clock
+    CPRECISIONCLOCK_SOURCE_TSC        // CPU time stamp counter (x86, invariant TSC only)
+};
+
+
 //==============================================================================
 /*!
     \class      cPrecisionClock
@@ -78,7 +92,20 @@ namespace chai3d {
     stopped and restarted at a later time. When a clock is running (__ON__), 
     time is accumulated until the next stop event (__OFF__). The value of a 
     clock can be read by calling method getCurrentTimeSeconds(). When a clock
-    is disabled (__OFF__), time is no longer accumulated.
+    is disabled (__OFF__), time is no longer accumulated. \n
+
+    Time is kept internally as an integer number of nanoseconds, which can be 
+    read with getCurrentTimeNanoseconds(); the methods in seconds are 
+    convenience wrappers. \n
+
+    By default, time is read from the monotonic clock of the operating system. 
+    On x86 processors with an invariant time stamp counter (TSC), calling 
+    setClockSource() with __CPRECISIONCLOCK_SOURCE_TSC__ reads the TSC 
+    directly instead, which reduces the cost of a time reading to a few 
+    nanoseconds. The TSC is calibrated once against the system clock when 
+    the source is selected. If the TSC is not invariant, the system clock 
+    remains in use. The clock source is shared by all clocks and should be 
+    selected at startup, before any clock or thread is started.
 */
 //==============================================================================
 
@@ -116,13 +143,16 @@ public:
     bool on() const { return (m_on); };
 
     //! This method returns the current clock time in seconds.
-    double getCurrentTimeSeconds() const;
+    double getCurrentTimeSeconds() const { return ((double)getCurrentTimeNanoseconds() * 1e-9); }
+
+    //! This method returns the current clock time in nanoseconds.
+    long long getCurrentTimeNanoseconds() const;
 
     //! This method sets the period in seconds before a _timeout_ occurs (you need to poll for this).
     void setTimeoutPeriodSeconds(const double a_timeoutPeriod);
 
     //! This method reads the programmed _timeout_ period is seconds.
-    double getTimeoutPeriodSeconds() const { return (m_timeoutPeriod); }
+    double getTimeoutPeriodSeconds() const { return ((double)m_timeoutPeriod * 1e-9); }
 
     //! This method returns __true__ if _timeout_ has occurred, otherwise return  __false__.
     bool timeoutOccurred() const ;
@@ -131,7 +161,39 @@ public:
     bool highResolution() const { return (m_highres); };
 
     //! This method returns the raw CPU time in seconds.
-    double getCPUTimeSeconds() const;
+    double getCPUTimeSeconds() const { return ((double)getCPUTimeNanoseconds() * 1e-9); }
+
+
+    //--------------------------------------------------------------------------
+    // PUBLIC STATIC METHODS:
+    //--------------------------------------------------------------------------
+
+public:
+
+    //! This method returns the raw CPU time in nanoseconds, read from the selected clock source.
+    static long long getCPUTimeNanoseconds();
+
+    //! This method selects the time source of all clocks. Returns __false__ if the source is not available.
+    static bool setClockSource(const CPrecisionClockSource a_source);
+
+    //! This method returns the time source of all clocks.
+    static CPrecisionClockSource getClockSource() { return (s_clockSource); }
+
+    //! This method returns __true__ if the CPU provides an invariant time stamp counter.
+    static bool getInvariantTSCAvailable();
+
+    //! This method returns the time of the operating system monotonic clock in nanoseconds, regardless of the selected clock source.
+    static long long getSystemTimeNanoseconds();
+
+
+    //--------------------------------------------------------------------------
+    // PROTECTED STATIC METHODS:
+    //--------------------------------------------------------------------------
+
+protected:
+
+    //! This method reads the time stamp counter.
+    static unsigned long long readTSC();
 
 
     //--------------------------------------------------------------------------
@@ -145,14 +207,14 @@ protected:
     LARGE_INTEGER m_freq;
 #endif
 
-    //! Time accumulated between previous calls to start() and stop().
-    double m_timeAccumulated;
+    //! Time in nanoseconds accumulated between previous calls to start() and stop().
+    long long m_timeAccumulated;
 
-    //! CPU time in seconds when clock was started.
-    double m_timeStart;
+    //! CPU time in nanoseconds when clock was started.
+    long long m_timeStart;
 
-    //! Timeout period in seconds.
-    double m_timeoutPeriod;
+    //! Timeout period in nanoseconds.
+    long long m_timeoutPeriod;
 
     //! Clock time in seconds when timer was started. 
     double m_timeoutStart;
@@ -162,6 +224,25 @@ protected:
 
     //! If __true__, then clock is currently __ON__.
     bool m_on;
+
+
+    //--------------------------------------------------------------------------
+    // PROTECTED STATIC MEMBERS:
+    //--------------------------------------------------------------------------
+
+protected:
+
+    //! Time source of all clocks.
+    static CPrecisionClockSource s_clockSource;
+
+    //! Value of the time stamp counter at calibration.
+    static unsigned long long s_tscBase;
+
+    //! System time in nanoseconds at calibration.
+    static long long s_tscBaseTime;
+
+    //! Nanoseconds per time stamp counter tick, as a 32.32 fixed-point value.
+    static unsigned long long s_tscScale;
 };
 
 //------------------------------------------------------------------------------
@@ -813,6 +813,10 @@ void cGenericTool::updateToolImagePosition()
     // points (or proxy positions).
     m_image->setLocalPos(m_deviceLocalPos);
     m_image->setLocalRot(m_deviceLocalRot);
+
+    // the tool image is not a child of the tool, so its global position is 
+    // only updated if the tool itself is visited during the next update.
+    invalidateGlobalPositions();
 }
 
 
@@ -834,6 +838,24 @@ void cGenericTool::computeInteractionForces()
     torque.zero();
 
     int numContactPoint = (int)(m_hapticPoints.size());
+
+    // compute the first collision query of all haptic points together;
+    // all haptic points of a generic tool are located at the device position
+    if (numContactPoint > 1)
+    {
+        cVector3d globalPos[C_COLLISION_MAX_SEGMENTS];
+        for (int i=0; i<C_COLLISION_MAX_SEGMENTS; i++)
+        {
+            globalPos[i] = m_deviceGlobalPos;
+        }
+        for (int first=0; first<numContactPoint; first+=C_COLLISION_MAX_SEGMENTS)
+        {
+            computeCollisionQueriesBatch(cMin(numContactPoint - first, C_COLLISION_MAX_SEGMENTS),
+                                         &m_hapticPoints[first],
+                                         globalPos);
+        }
+    }
+
     for (int i=0; i<numContactPoint; i++)
     {
         // get next haptic point
@@ -859,6 +881,81 @@ void cGenericTool::computeInteractionForces()
 }
 
 
+//==============================================================================
+/*!
+    This method computes the first collision query of the finger-proxy 
+    algorithm of several haptic points (see 
+    \ref cAlgorithmFingerProxy::getCollisionQuery()), so that the world is 
+    traversed once for all of them by 
+    \ref cWorld::computeCollisionDetectionBatch(). It must be called right 
+    before computing the interaction forces of these haptic points at the 
+    same positions. \n\n
+
+    Haptic points are batched if their proxies operate in the same world with
+    the same collision settings. Points whose query cannot be computed ahead
+    (e.g. a dynamic proxy or a proxy in contact) compute it themselves.
+
+    \param  a_numPoints     Number of haptic points.
+    \param  a_hapticPoints  Haptic points.
+    \param  a_globalPos     Next position of each haptic point in world coordinates.
+*/
+//==============================================================================
+void cGenericTool::computeCollisionQueriesBatch(const int a_numPoints, 
+                                                cHapticPoint* const* a_hapticPoints, 
+                                                const cVector3d* a_globalPos)
+{
+    cVector3d segmentPointsA[C_COLLISION_MAX_SEGMENTS];
+    cVector3d segmentPointsB[C_COLLISION_MAX_SEGMENTS];
+    cCollisionRecorder* recorders[C_COLLISION_MAX_SEGMENTS];
+    cAlgorithmFingerProxy* proxies[C_COLLISION_MAX_SEGMENTS];
+    int numSegments = 0;
+
+    for (int i=0; i<a_numPoints; i++)
+    {
+        // points join the batch of the first proxy if they share its world and settings
+        cAlgorithmFingerProxy* proxy = a_hapticPoints[i]->m_algorithmFingerProxy;
+        bool join = true;
+        if (numSegments > 0)
+        {
+            const cCollisionSettings& settings = proxies[0]->m_collisionSettings;
+            join = ((proxy->getWorld() == proxies[0]->getWorld()) &&
+                    (proxy->getProxyRadius() == proxies[0]->getProxyRadius()) &&
+                    (proxy->m_collisionSettings.m_checkForNearestCollisionOnly == settings.m_checkForNearestCollisionOnly) &&
+                    (proxy->m_collisionSettings.m_returnMinimalCollisionData == settings.m_returnMinimalCollisionData) &&
+                    (proxy->m_collisionSettings.m_checkVisibleObjects == settings.m_checkVisibleObjects) &&
+                    (proxy->m_collisionSettings.m_checkHapticObjects == settings.m_checkHapticObjects) &&
+                    (proxy->m_collisionSettings.m_adjustObjectMotion == settings.m_adjustObjectMotion) &&
+                    (proxy->m_collisionSettings.m_ignoreShapes == settings.m_ignoreShapes));
+        }
+
+        if (join && proxy->getCollisionQuery(a_globalPos[i],
+                                             segmentPointsA[numSegments],
+                                             segmentPointsB[numSegments],
+                                             recorders[numSegments]))
+        {
+            proxies[numSegments] = proxy;
+            numSegments++;
+        }
+
+        // a single query gains nothing from a batch; its proxy computes it itself
+        if ((numSegments == C_COLLISION_MAX_SEGMENTS) || ((i == a_numPoints - 1) && (numSegments > 1)))
+        {
+            proxies[0]->getWorld()->computeCollisionDetectionBatch(numSegments,
+                                                                   segmentPointsA,
+                                                                   segmentPointsB,
+                                                                   recorders,
+                                                                   proxies[0]->m_collisionSettings);
+            for (int j=0; j<numSegments; j++)
+            {
+                bool hit = (recorders[j]->m_nearestCollision.m_object != NULL) || (!recorders[j]->m_collisions.empty());
+                proxies[j]->setCollisionQueryResult(hit);
+            }
+            numSegments = 0;
+        }
+    }
+}
+
+
 //==============================================================================
 /*!
     This method applies the latest computed force to the haptic device.
@@ -649,6 +649,9 @@ protected:
 
     //! This method updates the global position of this tool in the world.
     virtual void updateGlobalPositions(const bool a_frameOnly);
+
+    //! This method computes the first collision query of several haptic points in batches.
+    void computeCollisionQueriesBatch(const int a_numPoints, cHapticPoint* const* a_hapticPoints, const cVector3d* a_globalPos);
 };
 
 //------------------------------------------------------------------------------
@@ -139,6 +139,11 @@ void cToolGripper::computeInteractionForces()
         posThumb  = m_deviceGlobalPos + cMul(m_deviceGlobalRot, (-1.0 * pThumb));
     }
 
+    // compute the first collision query of both haptic points together
+    cHapticPoint* hapticPoints[2] = { m_hapticPointThumb, m_hapticPointFinger };
+    cVector3d globalPos[2] = { posThumb, posFinger };
+    computeCollisionQueriesBatch(2, hapticPoints, globalPos);
+
     // compute forces
     cVector3d forceThumb = m_hapticPointThumb->computeInteractionForces(posThumb, 
                                                                         m_deviceGlobalRot, 
@@ -62,6 +62,9 @@ cLabel::cLabel(cFont* a_font)
     m_fontScale = 1.0;
     m_text = "";
     m_font = a_font;
+    m_textVerticesFont = NULL;
+    m_textVerticesRevision = 0;
+    m_textVerticesModified = true;
     m_textPosition.set(0.0, 0.0, 0.1); // the offset of 0.1 places the string in front of the panel.
 
     // set panel properties
@@ -110,20 +113,32 @@ void cLabel::render(cRenderOptions& a_options)
     /////////////////////////////////////////////////////////////////////////
     if (SECTION_RENDER_OPAQUE_PARTS_ONLY(a_options))
     {
-        // disable lighting  properties
-        glDisable(GL_LIGHTING);
-
-        // render font color
-        m_fontColor.render();
+        // layout glyph quads if needed
+        updateTextVertices();
 
         // render string at desired location
         glPushMatrix();
         glTranslated(m_textPosition(0), m_textPosition(1), 0.0);
-        m_font->renderText(m_text, m_fontColor, m_fontScale, a_options);
-        glPopMatrix();
 
-        // enable lighting  properties
-        glEnable(GL_LIGHTING);
+        // add string to batch, or render it directly
+        if ((m_font != NULL) &&
+            ((a_options.m_textBatch == NULL) ||
+             !a_options.m_textBatch->add(m_font, this, m_textVerticesRevision, m_textVertices, m_fontColor, a_options)))
+        {
+            // disable lighting  properties
+            glDisable(GL_LIGHTING);
+
+            // render font color
+            m_fontColor.render();
+
+            // render glyph quads
+            m_font->renderTextVertices(m_textVertices, m_fontColor, a_options);
+
+            // enable lighting  properties
+            glEnable(GL_LIGHTING);
+        }
+
+        glPopMatrix();
     }
 
 #endif
@@ -141,6 +156,7 @@ void cLabel::setText(const string a_text)
 {
     // copy string
     m_text = a_text;
+    m_textVerticesModified = true;
 
     // get width and height of string
     double w = getTextWidth();
@@ -189,12 +205,44 @@ void cLabel::setFontScale(const double a_scale)
 { 
     // update scale factor
     m_fontScale = fabs(a_scale);
+    m_textVerticesModified = true;
 
     // adjust size of boundary box
     updateBoundaryBox();
 }
 
 
+//==============================================================================
+/*!
+    This method lays out the glyph quads of the current text string, if the
+    text, font scale or font have changed since they were last laid out.
+*/
+//==============================================================================
+void cLabel::updateTextVertices()
+{
+    if (!m_textVerticesModified && (m_textVerticesFont == m_font))
+    {
+        return;
+    }
+
+    if (m_font == NULL)
+    {
+        m_textVertices.clear();
+    }
+    else
+    {
+        m_font->createTextVertices(m_text, m_fontScale, m_textVertices);
+    }
+
+    // revisions are unique among all labels, so that a text batch never 
+    // mistakes a new label for a deleted one allocated at the same address
+    static unsigned int revision = 0;
+    m_textVerticesFont = m_font;
+    m_textVerticesRevision = ++revision;
+    m_textVerticesModified = false;
+}
+
+
 //==============================================================================
 /*!
     This method returns the width of the current text string in pixels.
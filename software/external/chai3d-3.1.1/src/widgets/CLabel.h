@@ -47,9 +47,11 @@
 //------------------------------------------------------------------------------
 #include "widgets/CPanel.h"
 #include "graphics/CFont.h"
+#include "graphics/CTextBatch.h"
 #include "graphics/CColor.h"
 #include "system/CString.h"
 #include <string>
+#include <vector>
 //------------------------------------------------------------------------------
 
 //------------------------------------------------------------------------------
@@ -75,6 +77,10 @@ namespace chai3d {
 
     \details
     This class implements a 2D label widget to display one line of text.
+    The glyph quads of the text are laid out once when the text, font scale 
+    or font change, and are reused by each rendering pass. When the world 
+    uses text batching (\ref cWorld::setUseTextBatching()), labels sharing
+    a font are drawn together by a \ref cTextBatch.
 */
 //==============================================================================
 class cLabel : public cPanel
@@ -152,6 +158,18 @@ protected:
     //! Position of string in reference to panel origin.
     cVector3d m_textPosition;
 
+    //! Glyph quads of the text, as laid out by the font.
+    std::vector<float> m_textVertices;
+
+    //! Font with which the glyph quads were laid out.
+    cFont* m_textVerticesFont;
+
+    //! Revision of the glyph quads, renewed each time they are laid out.
+    unsigned int m_textVerticesRevision;
+
+    //! If __true__, then the glyph quads must be laid out again.
+    bool m_textVerticesModified;
+
 
     //--------------------------------------------------------------------------
     // PUBLIC METHODS:
@@ -181,6 +199,9 @@ protected:
     //! This method renders the object graphically using OpenGL.
     virtual void render(cRenderOptions& a_options);
 
+    //! This method lays out the glyph quads of the text if the text, font scale or font have changed.
+    void updateTextVertices();
+
     //! This method copies all properties of this object to another.
     void copyLabelProperties(cLabel* a_obj,
         const bool a_duplicateMaterialData,
@@ -0,0 +1,887 @@
+//==============================================================================
+/*
+    Software License Agreement (BSD License)
+    Copyright (c) 2003-2016, CHAI3D.
+    (www.chai3d.org)
+
+    All rights reserved.
+
+    Redistribution and use in source and binary forms, with or without
+    modification, are permitted provided that the following conditions
+    are met:
+
+    * Redistributions of source code must retain the above copyright
+    notice, this list of conditions and the following disclaimer.
+
+    * Redistributions in binary form must reproduce the above
+    copyright notice, this list of conditions and the following
+    disclaimer in the documentation and/or other materials provided
+    with the distribution.
+
+    * Neither the name of CHAI3D nor the names of its contributors may
+    be used to endorse or promote products derived from this software
+    without specific prior written permission.
+
+    THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS
+    "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT
+    LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS
+    FOR A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE
+    COPYRIGHT OWNER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT,
+    INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING,
+    BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES;
+    LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER
+    CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT
+    LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN
+    ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE
+    POSSIBILITY OF SUCH DAMAGE. 
+
+
+    \author    <http://www.chai3d.org>
+    \version   3.1.1 $Rev: 1869 $
+*/
+//==============================================================================
+
+//------------------------------------------------------------------------------
+#include "widgets/CSignalScope.h"
+//------------------------------------------------------------------------------
+
+//------------------------------------------------------------------------------
+namespace chai3d {
+//------------------------------------------------------------------------------
+
+//==============================================================================
+/*!
+    Constructor of cSignalBuffer.
+
+    \param  a_numChannels  Number of channels of each sample.
+    \param  a_capacity     Maximum number of samples, rounded up to a power of two.
+*/
+//==============================================================================
+cSignalBuffer::cSignalBuffer(const unsigned int a_numChannels,
+                             const unsigned int a_capacity)
+{
+    m_numChannels = cMax(a_numChannels, (unsigned int)1);
+
+    // power of two, so that the indices can wrap around without discontinuity
+    m_capacity = 1;
+    while (m_capacity < a_capacity)
+    {
+        m_capacity *= 2;
+    }
+
+    m_data.resize(m_capacity * (m_numChannels + 1), 0.0);
+
+    m_head.store(0);
+    m_tail.store(0);
+    m_dropped.store(0);
+}
+
+
+//==============================================================================
+/*!
+    This method adds a sample to the buffer. It must only be called by the 
+    producer thread. It never blocks; if the buffer is full, the sample is 
+    dropped.
+
+    \param  a_time    Time stamp of the sample in seconds.
+    \param  a_values  Values of all channels.
+
+    \return __true__ if the sample was added, __false__ if the buffer was full.
+*/
+//==============================================================================
+bool cSignalBuffer::push(const double a_time, const double* a_values)
+{
+    unsigned int head = m_head.load(std::memory_order_relaxed);
+    unsigned int tail = m_tail.load(std::memory_order_acquire);
+
+    if (head - tail >= m_capacity)
+    {
+        // single writer, so a plain store is enough
+        m_dropped.store(m_dropped.load(std::memory_order_relaxed) + 1, std::memory_order_relaxed);
+        return (false);
+    }
+
+    double* sample = &m_data[(head & (m_capacity - 1)) * (m_numChannels + 1)];
+    sample[0] = a_time;
+    for (unsigned int i=0; i<m_numChannels; i++)
+    {
+        sample[i+1] = a_values[i];
+    }
+
+    // publish sample
+    m_head.store(head + 1, std::memory_order_release);
+
+    return (true);
+}
+
+
+//==============================================================================
+/*!
+    This method removes the oldest sample from the buffer. It must only be 
+    called by the consumer thread.
+
+    \param  a_time    Returned time stamp of the sample.
+    \param  a_values  Returned values of all channels.
+
+    \return __true__ if a sample was returned, __false__ if the buffer was empty.
+*/
+//==============================================================================
+bool cSignalBuffer::pop(double& a_time, double* a_values)
+{
+    unsigned int tail = m_tail.load(std::memory_order_relaxed);
+    unsigned int head = m_head.load(std::memory_order_acquire);
+
+    if (tail == head)
+    {
+        return (false);
+    }
+
+    const double* sample = &m_data[(tail & (m_capacity - 1)) * (m_numChannels + 1)];
+    a_time = sample[0];
+    for (unsigned int i=0; i<m_numChannels; i++)
+    {
+        a_values[i] = sample[i+1];
+    }
+
+    // release slot to producer
+    m_tail.store(tail + 1, std::memory_order_release);
+
+    return (true);
+}
+
+
+//==============================================================================
+/*!
+    This method discards all samples currently in the buffer. It must only be 
+    called by the consumer thread.
+*/
+//==============================================================================
+void cSignalBuffer::clear()
+{
+    m_tail.store(m_head.load(std::memory_order_acquire), std::memory_order_release);
+}
+
+
+//==============================================================================
+/*!
+    Constructor of cSignalScope.
+
+    \param  a_numChannels  Number of channels.
+    \param  a_historySize  Number of samples kept for display, per channel.
+*/
+//==============================================================================
+cSignalScope::cSignalScope(const unsigned int a_numChannels,
+                           const unsigned int a_historySize) :
+    m_buffer(a_numChannels)
+{
+    m_numChannels = m_buffer.getNumChannels();
+
+    // allocate history
+    m_historySize = cMax(a_historySize, (unsigned int)2);
+    m_historyTimes.resize(m_historySize, 0.0);
+    m_historyValues.resize(m_historySize * m_numChannels, 0.0);
+    m_historyCount = 0;
+    m_historyNext = 0;
+    m_sample.resize(m_numChannels, 0.0);
+
+    // set default channel settings
+    m_channelEnabled.resize(m_numChannels, true);
+    m_channelColors.resize(m_numChannels);
+    m_channelMin.resize(m_numChannels, -1.0);
+    m_channelMax.resize(m_numChannels,  1.0);
+    for (unsigned int i=0; i<m_numChannels; i++)
+    {
+        switch (i % 8)
+        {
+            case 0: m_channelColors[i].setBlueCornflower(); break;
+            case 1: m_channelColors[i].setGreenMediumSea(); break;
+            case 2: m_channelColors[i].setPinkDeep(); break;
+            case 3: m_channelColors[i].setYellowLemonChiffon(); break;
+            case 4: m_channelColors[i].setOrangeCoral(); break;
+            case 5: m_channelColors[i].setBlueCyan(); break;
+            case 6: m_channelColors[i].setPurpleAmethyst(); break;
+            case 7: m_channelColors[i].setWhite(); break;
+        }
+    }
+
+    // default time base
+    m_timeSpan = 2.0;
+    m_frozen = false;
+    m_frozenEnd = 0.0;
+
+    // trigger disabled
+    m_triggerEdge = CSIGNALSCOPE_TRIGGER_OFF;
+    m_triggerChannel = 0;
+    m_triggerLevel = 0.0;
+    m_triggerSingleShot = false;
+    m_triggerPosition = 0.5;
+    m_triggerTime = 0.0;
+    m_triggered = false;
+
+    // set default radius values
+    m_panelRadiusTopLeft =       10;
+    m_panelRadiusTopRight =      10;
+    m_panelRadiusBottomLeft =    10;
+    m_panelRadiusBottomRight =   10;
+
+    // default line width
+    m_lineWidth = 1.0;
+
+    // default panel background color settings
+    m_panelColorTopLeft.setGrayLevel(0.3f);
+    m_panelColorTopRight.setGrayLevel(0.3f);
+    m_panelColorBottomLeft.setGrayLevel(0.2f);
+    m_panelColorBottomRight.setGrayLevel(0.2f);
+
+    // initialize values
+    m_scopeWidth = 0.0;
+    m_scopeHeight = 0.0;
+    m_scopePosition.set(0.0, 0.0, 0.0);
+
+    // set a default size
+    setSize(600, 200);
+}
+
+
+//==============================================================================
+/*!
+    This method moves all samples received since the last call from the 
+    lock-free buffer to the history, and detects trigger events. It is called 
+    automatically when the scope is rendered. While the display is frozen, 
+    new samples are discarded.
+*/
+//==============================================================================
+void cSignalScope::updateSamples()
+{
+    double time;
+    while (m_buffer.pop(time, &m_sample[0]))
+    {
+        if (m_frozen) continue;
+
+        // detect trigger event between previous and new sample
+        if ((m_triggerEdge != CSIGNALSCOPE_TRIGGER_OFF) && (m_historyCount > 0))
+        {
+            double value0 = getHistoryValue(m_historyCount-1, m_triggerChannel);
+            double value1 = m_sample[m_triggerChannel];
+
+            bool crossed;
+            if (m_triggerEdge == CSIGNALSCOPE_TRIGGER_RISING)
+            {
+                crossed = (value0 < m_triggerLevel) && (value1 >= m_triggerLevel);
+            }
+            else
+            {
+                crossed = (value0 > m_triggerLevel) && (value1 <= m_triggerLevel);
+            }
+
+            if (crossed)
+            {
+                // interpolate time of crossing
+                double time0 = getHistoryTime(m_historyCount-1);
+                double ratio = (m_triggerLevel - value0) / (value1 - value0);
+                m_triggerCandidates.push_back(time0 + ratio * (time - time0));
+                if (m_triggerCandidates.size() > 64)
+                {
+                    m_triggerCandidates.pop_front();
+                }
+            }
+        }
+
+        // store sample in history
+        m_historyTimes[m_historyNext] = time;
+        for (unsigned int i=0; i<m_numChannels; i++)
+        {
+            m_historyValues[m_historyNext * m_numChannels + i] = m_sample[i];
+        }
+        m_historyNext = (m_historyNext + 1) % m_historySize;
+        if (m_historyCount < m_historySize)
+        {
+            m_historyCount++;
+        }
+    }
+
+    if (m_frozen || (m_triggerEdge == CSIGNALSCOPE_TRIGGER_OFF) || (m_historyCount == 0))
+    {
+        return;
+    }
+
+    // display the most recent trigger event for which the display can be filled
+    double latest = getHistoryTime(m_historyCount-1);
+    double after = (1.0 - m_triggerPosition) * m_timeSpan;
+    for (int i=(int)m_triggerCandidates.size()-1; i>=0; i--)
+    {
+        if (m_triggerCandidates[i] + after <= latest)
+        {
+            m_triggerTime = m_triggerCandidates[i];
+            m_triggered = true;
+            m_triggerCandidates.erase(m_triggerCandidates.begin(), m_triggerCandidates.begin() + i + 1);
+
+            if (m_triggerSingleShot)
+            {
+                setFrozen(true);
+            }
+            break;
+        }
+    }
+}
+
+
+//==============================================================================
+/*!
+    This method clears all signals and pending trigger events.
+*/
+//==============================================================================
+void cSignalScope::clearSignals()
+{
+    m_buffer.clear();
+    m_historyCount = 0;
+    m_historyNext = 0;
+    m_triggerCandidates.clear();
+    m_triggered = false;
+}
+
+
+//==============================================================================
+/*!
+    This method enables or disables the display of a channel.
+
+    \param  a_channel  Channel index.
+    \param  a_enabled  Display status.
+*/
+//==============================================================================
+void cSignalScope::setChannelEnabled(const unsigned int a_channel, const bool a_enabled)
+{
+    if (a_channel >= m_numChannels) return;
+    m_channelEnabled[a_channel] = a_enabled;
+}
+
+
+//==============================================================================
+/*!
+    This method returns the display status of a channel.
+
+    \param  a_channel  Channel index.
+
+    \return __true__ if the channel is displayed, __false__ otherwise.
+*/
+//==============================================================================
+bool cSignalScope::getChannelEnabled(const unsigned int a_channel) const
+{
+    if (a_channel >= m_numChannels) return (false);
+    return (m_channelEnabled[a_channel]);
+}
+
+
+//==============================================================================
+/*!
+    This method sets the color of a channel.
+
+    \param  a_channel  Channel index.
+    \param  a_color    Color.
+*/
+//==============================================================================
+void cSignalScope::setChannelColor(const unsigned int a_channel, const cColorf& a_color)
+{
+    if (a_channel >= m_numChannels) return;
+    m_channelColors[a_channel] = a_color;
+}
+
+
+//==============================================================================
+/*!
+    This method returns the color of a channel.
+
+    \param  a_channel  Channel index.
+
+    \return Color of the channel.
+*/
+//==============================================================================
+cColorf cSignalScope::getChannelColor(const unsigned int a_channel) const
+{
+    if (a_channel >= m_numChannels) return (cColorf());
+    return (m_channelColors[a_channel]);
+}
+
+
+//==============================================================================
+/*!
+    This method sets the range of values of a channel that is mapped to the 
+    height of the scope.
+
+    \param  a_channel   Channel index.
+    \param  a_minValue  Minimum value.
+    \param  a_maxValue  Maximum value.
+*/
+//==============================================================================
+void cSignalScope::setChannelRange(const unsigned int a_channel,
+                                   const double a_minValue,
+                                   const double a_maxValue)
+{
+    // sanity check
+    if ((a_channel >= m_numChannels) || (a_minValue == a_maxValue))
+    {
+        return;
+    }
+
+    // store values
+    m_channelMin[a_channel] = cMin(a_minValue, a_maxValue);
+    m_channelMax[a_channel] = cMax(a_minValue, a_maxValue);
+}
+
+
+//==============================================================================
+/*!
+    This method sets the range of values of all channels.
+
+    \param  a_minValue  Minimum value.
+    \param  a_maxValue  Maximum value.
+*/
+//==============================================================================
+void cSignalScope::setRange(const double a_minValue, 
+                            const double a_maxValue)
+{
+    for (unsigned int i=0; i<m_numChannels; i++)
+    {
+        setChannelRange(i, a_minValue, a_maxValue);
+    }
+}
+
+
+//==============================================================================
+/*!
+    This method returns the minimum value from the range of a channel.
+
+    \param  a_channel  Channel index.
+
+    \return Minimum value.
+*/
+//==============================================================================
+double cSignalScope::getRangeMin(const unsigned int a_channel) const
+{
+    if (a_channel >= m_numChannels) return (0.0);
+    return (m_channelMin[a_channel]);
+}
+
+
+//==============================================================================
+/*!
+    This method returns the maximum value from the range of a channel.
+
+    \param  a_channel  Channel index.
+
+    \return Maximum value.
+*/
+//==============================================================================
+double cSignalScope::getRangeMax(const unsigned int a_channel) const
+{
+    if (a_channel >= m_numChannels) return (0.0);
+    return (m_channelMax[a_channel]);
+}
+
+
+//==============================================================================
+/*!
+    This method sets the time span displayed across the width of the scope. 
+    The span that can be displayed is limited by the size of the history 
+    and the sampling rate.
+
+    \param  a_timeSpan  Time span in seconds.
+*/
+//==============================================================================
+void cSignalScope::setTimeSpan(const double a_timeSpan)
+{
+    if (a_timeSpan <= 0.0) return;
+    m_timeSpan = a_timeSpan;
+}
+
+
+//==============================================================================
+/*!
+    This method freezes or resumes the display. While the display is frozen, 
+    new samples are discarded. Resuming a single-shot trigger arms it again.
+
+    \param  a_frozen  If __true__, the display is frozen.
+*/
+//==============================================================================
+void cSignalScope::setFrozen(const bool a_frozen)
+{
+    if (a_frozen == m_frozen) return;
+
+    if (a_frozen)
+    {
+        m_frozenEnd = getDisplayEnd();
+    }
+    else
+    {
+        m_triggerCandidates.clear();
+        m_triggered = false;
+    }
+
+    m_frozen = a_frozen;
+}
+
+
+//==============================================================================
+/*!
+    This method sets the trigger of the scope. When a trigger edge is 
+    selected, the display is synchronized on the most recent crossing of 
+    __a_level__ by channel __a_channel__, which is shown at the position set 
+    by setTriggerPosition(). Until a first event occurs, the display is 
+    free running.
+
+    \param  a_channel     Trigger channel.
+    \param  a_level       Trigger level.
+    \param  a_edge        Trigger edge, or __CSIGNALSCOPE_TRIGGER_OFF__ to disable triggering.
+    \param  a_singleShot  If __true__, the display freezes on the first trigger event.
+*/
+//==============================================================================
+void cSignalScope::setTrigger(const unsigned int a_channel,
+                              const double a_level,
+                              const CSignalScopeTrigger a_edge,
+                              const bool a_singleShot)
+{
+    if (a_channel >= m_numChannels) return;
+
+    m_triggerChannel = a_channel;
+    m_triggerLevel = a_level;
+    m_triggerEdge = a_edge;
+    m_triggerSingleShot = a_singleShot;
+
+    // discard events detected with the previous settings
+    m_triggerCandidates.clear();
+    m_triggered = false;
+}
+
+
+//==============================================================================
+/*!
+    This method sets the horizontal position of the trigger event on the 
+    display.
+
+    \param  a_position  Position, from 0.0 (left edge) to 1.0 (right edge).
+*/
+//==============================================================================
+void cSignalScope::setTriggerPosition(const double a_position)
+{
+    m_triggerPosition = cClamp01(a_position);
+}
+
+
+//==============================================================================
+/*!
+    This method sets the size of the scope by defining its width and height.
+
+    \param  a_width   Width of scope.
+    \param  a_height  Height of scope.
+*/
+//==============================================================================
+void cSignalScope::setSize(const double& a_width, const double& a_height)
+{
+    // minimum margin between scope data and edge of panel
+    double SCOPE_MARGIN = 10;
+
+    // set new values for width and height.
+    double w = cMax(m_panelRadiusTopLeft, m_panelRadiusBottomLeft) + 
+               cMax(m_panelRadiusTopRight, m_panelRadiusBottomRight);
+    w = cMax(w, SCOPE_MARGIN);
+    m_width = cMax(a_width, w);
+
+    double h = cMax(m_panelRadiusTopLeft, m_panelRadiusTopRight) + 
+               cMax(m_panelRadiusBottomLeft, m_panelRadiusBottomRight);
+    h = cMax(h, SCOPE_MARGIN);
+    m_height = cMax(a_height, h);
+
+    // update model of panel
+    updatePanelMesh();
+
+    // set dimension of scope.
+    m_scopeWidth = m_width - w;
+    m_scopeHeight = m_height - h;
+
+    // set position of scope within panel
+    m_scopePosition.set(0.5 * (m_width - m_scopeWidth), 0.5 * (m_height - m_scopeHeight), 0.0);
+}
+
+
+//==============================================================================
+/*!
+    This method returns the time at the right edge of the display: the time 
+    at which the display was frozen, the end of the window around the current 
+    trigger event, or the time of the most recent sample.
+
+    \return Time in seconds.
+*/
+//==============================================================================
+double cSignalScope::getDisplayEnd() const
+{
+    if (m_frozen)
+    {
+        return (m_frozenEnd);
+    }
+
+    if ((m_triggerEdge != CSIGNALSCOPE_TRIGGER_OFF) && m_triggered)
+    {
+        return (m_triggerTime + (1.0 - m_triggerPosition) * m_timeSpan);
+    }
+
+    if (m_historyCount > 0)
+    {
+        return (getHistoryTime(m_historyCount-1));
+    }
+
+    return (0.0);
+}
+
+
+//==============================================================================
+/*!
+    This method returns the index of the oldest sample of the history whose 
+    time is greater than or equal to a given time.
+
+    \param  a_time  Time in seconds.
+
+    \return Index of sample (0 = oldest), or the number of samples if none.
+*/
+//==============================================================================
+unsigned int cSignalScope::findSample(const double a_time) const
+{
+    // time stamps increase along the history
+    unsigned int first = 0;
+    unsigned int last = m_historyCount;
+    while (first < last)
+    {
+        unsigned int middle = first + (last - first) / 2;
+        if (getHistoryTime(middle) < a_time)
+        {
+            first = middle + 1;
+        }
+        else
+        {
+            last = middle;
+        }
+    }
+
+    return (first);
+}
+
+
+//==============================================================================
+/*!
+    This method decimates the samples of the displayed time span to a number 
+    of columns. For each channel, each column stores the minimum and maximum 
+    of the samples it covers, and which of the two came first.
+
+    \param  a_timeStart   Time at the left edge of the display.
+    \param  a_numColumns  Number of columns.
+*/
+//==============================================================================
+void cSignalScope::decimate(const double a_timeStart, const unsigned int a_numColumns)
+{
+    m_columnMin.resize(a_numColumns * m_numChannels);
+    m_columnMax.resize(a_numColumns * m_numChannels);
+    m_columnMinFirst.resize(a_numColumns * m_numChannels);
+    m_columnUsed.assign(a_numColumns, 0);
+
+    double timeEnd = a_timeStart + m_timeSpan;
+    double columnsPerSecond = (double)a_numColumns / m_timeSpan;
+
+    for (unsigned int i=findSample(a_timeStart); i<m_historyCount; i++)
+    {
+        double time = getHistoryTime(i);
+        if (time > timeEnd) break;
+
+        unsigned int column = cMin((unsigned int)((time - a_timeStart) * columnsPerSecond), a_numColumns-1);
+        unsigned int index = column * m_numChannels;
+
+        if (!m_columnUsed[column])
+        {
+            m_columnUsed[column] = 1;
+            for (unsigned int j=0; j<m_numChannels; j++)
+            {
+                double value = getHistoryValue(i, j);
+                m_columnMin[index+j] = value;
+                m_columnMax[index+j] = value;
+                m_columnMinFirst[index+j] = 1;
+            }
+        }
+        else
+        {
+            for (unsigned int j=0; j<m_numChannels; j++)
+            {
+                double value = getHistoryValue(i, j);
+                if (value < m_columnMin[index+j])
+                {
+                    m_columnMin[index+j] = value;
+                    m_columnMinFirst[index+j] = 0;
+                }
+                else if (value > m_columnMax[index+j])
+                {
+                    m_columnMax[index+j] = value;
+                    m_columnMinFirst[index+j] = 1;
+                }
+            }
+        }
+    }
+}
+
+
+//==============================================================================
+/*!
+    This method renders the scope using OpenGL.
+
+    \param  a_options  Rendering options.
+*/
+//==============================================================================
+void cSignalScope::render(cRenderOptions& a_options)
+{
+#ifdef C_USE_OPENGL
+
+    // render background panel
+    if (m_panelEnabled)
+    {
+        cMesh::render(a_options);
+    }
+
+    /////////////////////////////////////////////////////////////////////////
+    // Render parts that are always opaque
+    /////////////////////////////////////////////////////////////////////////
+    if (SECTION_RENDER_OPAQUE_PARTS_ONLY(a_options))
+    {
+        // collect new samples
+        updateSamples();
+
+        if (m_historyCount == 0) { return; }
+
+        // decimate displayed samples to one column per pixel
+        unsigned int numColumns = (unsigned int)cMax(m_scopeWidth, 1.0);
+        double timeStart = getDisplayEnd() - m_timeSpan;
+        decimate(timeStart, numColumns);
+
+        // disable lighting
+        glDisable(GL_LIGHTING);
+
+        // set line width
+        glLineWidth((GLfloat)m_lineWidth);
+
+        // position scope within panel
+        glPushMatrix();
+        glTranslated(m_scopePosition(0), m_scopePosition(1), 0.0);
+
+        // render signals
+        for (unsigned int i=0; i<m_numChannels; i++)
+        {
+            if (!m_channelEnabled[i]) continue;
+
+            m_channelColors[i].render();
+
+            double scale = m_scopeHeight / (m_channelMax[i] - m_channelMin[i]);
+
+            // draw extremes of each column in the order in which they occurred
+            glBegin(GL_LINE_STRIP);
+            for (unsigned int j=0; j<numColumns; j++)
+            {
+                if (!m_columnUsed[j]) continue;
+
+                unsigned int index = j * m_numChannels + i;
+                double y0 = scale * (cClamp(m_columnMin[index], m_channelMin[i], m_channelMax[i]) - m_channelMin[i]);
+                double y1 = scale * (cClamp(m_columnMax[index], m_channelMin[i], m_channelMax[i]) - m_channelMin[i]);
+                if (!m_columnMinFirst[index])
+                {
+                    cSwap(y0, y1);
+                }
+
+                double x = (double)j + 0.5;
+                glVertex3d(x, y0, 0.0);
+                if (y1 != y0)
+                {
+                    glVertex3d(x, y1, 0.0);
+                }
+            }
+            glEnd();
+        }
+
+        // restore OpenGL settings
+        glPopMatrix();
+        glEnable(GL_LIGHTING);
+    }
+
+#endif
+}
+
+
+//==============================================================================
+/*!
+    This method creates a copy of itself. Samples are not copied.
+
+    \param  a_duplicateMaterialData   If __true__, material (if available) is duplicated, otherwise it is shared.
+    \param  a_duplicateTextureData    If __true__, texture data (if available) is duplicated, otherwise it is shared.
+    \param  a_duplicateMeshData       If __true__, mesh data (if available) is duplicated, otherwise it is shared.
+    \param  a_buildCollisionDetector  If __true__, collision detector (if available) is duplicated, otherwise it is shared.
+
+    \return Pointer to new object.
+*/
+//==============================================================================
+cSignalScope* cSignalScope::copy(const bool a_duplicateMaterialData,
+    const bool a_duplicateTextureData, 
+    const bool a_duplicateMeshData,
+    const bool a_buildCollisionDetector)
+{
+    // create new instance
+    cSignalScope* obj = new cSignalScope(m_numChannels, m_historySize);
+
+    // copy properties of cGenericObject
+    copySignalScopeProperties(obj, 
+        a_duplicateMaterialData, 
+        a_duplicateTextureData,
+        a_duplicateMeshData,
+        a_buildCollisionDetector);
+
+    // return
+    return (obj);
+}
+
+
+//==============================================================================
+/*!
+    This method copies all properties of this object to another.
+
+    \param  a_obj                     Destination object where properties are copied to.
+    \param  a_duplicateMaterialData   If __true__, material (if available) is duplicated, otherwise it is shared.
+    \param  a_duplicateTextureData    If __true__, texture data (if available) is duplicated, otherwise it is shared.
+    \param  a_duplicateMeshData       If __true__, mesh data (if available) is duplicated, otherwise it is shared.
+    \param  a_buildCollisionDetector  If __true__, collision detector (if available) is duplicated, otherwise it is shared.
+*/
+//==============================================================================
+void cSignalScope::copySignalScopeProperties(cSignalScope* a_obj,
+    const bool a_duplicateMaterialData,
+    const bool a_duplicateTextureData, 
+    const bool a_duplicateMeshData,
+    const bool a_buildCollisionDetector)
+{
+    // copy properties of cPanel
+    copyPanelProperties(a_obj, 
+        a_duplicateMaterialData, 
+        a_duplicateTextureData,
+        a_duplicateMeshData,
+        a_buildCollisionDetector);
+
+    // copy properties of cSignalScope
+    a_obj->m_channelEnabled = m_channelEnabled;
+    a_obj->m_channelColors = m_channelColors;
+    a_obj->m_channelMin = m_channelMin;
+    a_obj->m_channelMax = m_channelMax;
+    a_obj->m_timeSpan = m_timeSpan;
+    a_obj->m_triggerEdge = m_triggerEdge;
+    a_obj->m_triggerChannel = m_triggerChannel;
+    a_obj->m_triggerLevel = m_triggerLevel;
+    a_obj->m_triggerSingleShot = m_triggerSingleShot;
+    a_obj->m_triggerPosition = m_triggerPosition;
+    a_obj->m_lineWidth = m_lineWidth;
+
+    a_obj->setSize(m_width, m_height);
+}
+
+
+//------------------------------------------------------------------------------
+} // namespace chai3d
+//------------------------------------------------------------------------------
@@ -0,0 +1,456 @@
+//==============================================================================
+/*
+    Software License Agreement (BSD License)
+    Copyright (c) 2003-2016, CHAI3D.
+    (www.chai3d.org)
+
+    All rights reserved.
+
+    Redistribution and use in source and binary forms, with or without
+    modification, are permitted provided that the following conditions
+    are met:
+
+    * Redistributions of source code must retain the above copyright
+    notice, this list of conditions and the following disclaimer.
+
+    * Redistributions in binary form must reproduce the above
+    copyright notice, this list of conditions and the following
+    disclaimer in the documentation and/or other materials provided
+    with the distribution.
+
+    * Neither the name of CHAI3D nor the names of its contributors may
+    be used to endorse or promote products derived from this software
+    without specific prior written permission.
+
+    THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS
+    "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT
+    LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS
+    FOR A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE
+    COPYRIGHT OWNER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT,
+    INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING,
+    BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES;
+    LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER
+    CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT
+    LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN
+    ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE
+    POSSIBILITY OF SUCH DAMAGE. 
+
+
+    \author    <http://www.chai3d.org>
+    \version   3.1.1 $Rev: 1869 $
+*/
+//==============================================================================
+
+//------------------------------------------------------------------------------
+#ifndef CSignalScopeH
+#define CSignalScopeH
+//------------------------------------------------------------------------------
+#include "widgets/CPanel.h"
+//------------------------------------------------------------------------------
+#include <atomic>
+#include <deque>
+#include <vector>
+//------------------------------------------------------------------------------
+
+//------------------------------------------------------------------------------
+namespace chai3d {
+//------------------------------------------------------------------------------
+
+//==============================================================================
+/*!
+    \file       CSignalScope.h
+
+    \brief
+    Implements a multi-channel scope widget for high-rate signals.
+*/
+//==============================================================================
+
+//------------------------------------------------------------------------------
+/*!
+    Defines the edges on which a cSignalScope can trigger.
+*/
+//------------------------------------------------------------------------------
+enum CSignalScopeTrigger
+{
+    CSIGNALSCOPE_TRIGGER_OFF,         // free running display
+    CSIGNALSCOPE_TRIGGER_RISING,      // signal crosses level upwards
+    CSIGNALSCOPE_TRIGGER_FALLING      // signal crosses level downwards
+};
+
+
+//==============================================================================
+/*!
+    \class      cSignalBuffer
+    \ingroup    widgets
+
+    \brief
+    This class implements a lock-free ring buffer of time-stamped, 
+    multi-channel samples.
+
+    \details
+    cSignalBuffer transfers samples from one producer thread (typically a 
+    haptic or servo loop) to one consumer thread (typically the graphics 
+    loop). Each sample holds a time stamp and one double-precision value per 
+    channel. \n
+
+    push() never blocks, allocates or locks. If the consumer falls behind and 
+    the buffer is full, new samples are dropped and counted, so that the 
+    producer is never slowed down.
+*/
+//==============================================================================
+class cSignalBuffer
+{
+    //--------------------------------------------------------------------------
+    // CONSTRUCTOR & DESTRUCTOR:
+    //--------------------------------------------------------------------------
+
+public:
+
+    //! Constructor of cSignalBuffer.
+    cSignalBuffer(const unsigned int a_numChannels = 1,
+                  const unsigned int a_capacity = 16384);
+
+    //! Destructor of cSignalBuffer.
+    virtual ~cSignalBuffer() {};
+
+
+    //--------------------------------------------------------------------------
+    // PUBLIC METHODS:
+    //--------------------------------------------------------------------------
+
+public:
+
+    //! This method adds a sample to the buffer (producer thread only).
+    bool push(const double a_time, const double* a_values);
+
+    //! This method removes the oldest sample from the buffer (consumer thread only).
+    bool pop(double& a_time, double* a_values);
+
+    //! This method discards all samples in the buffer (consumer thread only).
+    void clear();
+
+    //! This method returns the number of channels of each sample.
+    unsigned int getNumChannels() const { return (m_numChannels); }
+
+    //! This method returns the maximum number of samples held by the buffer.
+    unsigned int getCapacity() const { return (m_capacity); }
+
+    //! This method returns the number of samples dropped because the buffer was full.
+    unsigned int getNumDropped() const { return (m_dropped.load(std::memory_order_relaxed)); }
+
+
+    //--------------------------------------------------------------------------
+    // PROTECTED MEMBERS:
+    //--------------------------------------------------------------------------
+
+protected:
+
+    //! Number of channels.
+    unsigned int m_numChannels;
+
+    //! Capacity in samples (power of two).
+    unsigned int m_capacity;
+
+    //! Sample storage (time stamp followed by channel values).
+    std::vector<double> m_data;
+
+    //! Total number of samples written (only advanced by the producer).
+    std::atomic<unsigned int> m_head;
+
+    //! Total number of samples read (only advanced by the consumer).
+    std::atomic<unsigned int> m_tail;
+
+    //! Number of dropped samples (only written by the producer).
+    std::atomic<unsigned int> m_dropped;
+};
+
+
+//==============================================================================
+/*!
+    \class      cSignalScope
+    \ingroup    widgets
+
+    \brief
+    This class implements a 2D scope to display high-rate signals.
+
+    \details
+    cSignalScope displays any number of time-stamped signals, typically 
+    sampled at haptic rate. Samples are added from the haptic thread with 
+    addSample(), which only writes to a lock-free cSignalBuffer. Each time the 
+    scope is rendered, new samples are moved to a history and the visible 
+    time span is decimated to one column per pixel. Each column keeps the 
+    minimum and maximum of the samples it covers, so that short spikes remain 
+    visible at any time span. \n
+
+    Each channel has its own color and value range. The display can be 
+    frozen, or synchronized on a rising or falling edge of one channel 
+    (setTrigger()). In single-shot mode, the display freezes on the first 
+    trigger event.
+*/
+//==============================================================================
+class cSignalScope : public cPanel
+{
+    //--------------------------------------------------------------------------
+    // CONSTRUCTOR & DESTRUCTOR:
+    //--------------------------------------------------------------------------
+
+public:
+
+    //! Constructor of cSignalScope.
+    cSignalScope(const unsigned int a_numChannels = 4,
+                 const unsigned int a_historySize = 65536);
+
+    //! Destructor of cSignalScope.
+    virtual ~cSignalScope() {};
+
+
+    //--------------------------------------------------------------------------
+    // PUBLIC METHODS - GENERAL:
+    //--------------------------------------------------------------------------
+
+public:
+
+    //! This method creates a copy of itself.
+    virtual cSignalScope* copy(const bool a_duplicateMaterialData = false,
+        const bool a_duplicateTextureData = false, 
+        const bool a_duplicateMeshData = false,
+        const bool a_buildCollisionDetector = false);
+
+    //! This method sets the size of this scope.
+    virtual void setSize(const double& a_width, const double& a_height);
+
+    //! This method sets the line width of the signals.
+    inline void setLineWidth(const double a_lineWidth) { m_lineWidth = fabs(a_lineWidth); }
+
+    //! This method returns the line width of the signals.
+    inline double getLineWidth() const { return (m_lineWidth); }
+
+
+    //--------------------------------------------------------------------------
+    // PUBLIC METHODS - SIGNALS:
+    //--------------------------------------------------------------------------
+
+public:
+
+    //! This method adds a sample of all channels. It may be called from a haptic thread.
+    inline bool addSample(const double a_time, const double* a_values) { return (m_buffer.push(a_time, a_values)); }
+
+    //! This method moves new samples to the history. It is called automatically when the scope is rendered.
+    void updateSamples();
+
+    //! This method clears all signals.
+    void clearSignals();
+
+    //! This method returns the number of channels.
+    unsigned int getNumChannels() const { return (m_numChannels); }
+
+    //! This method returns the number of samples dropped because the display fell behind.
+    unsigned int getNumDroppedSamples() const { return (m_buffer.getNumDropped()); }
+
+    //! This method enables or disables the display of a channel.
+    void setChannelEnabled(const unsigned int a_channel, const bool a_enabled);
+
+    //! This method returns __true__ if a channel is displayed.
+    bool getChannelEnabled(const unsigned int a_channel) const;
+
+    //! This method sets the color of a channel.
+    void setChannelColor(const unsigned int a_channel, const cColorf& a_color);
+
+    //! This method returns the color of a channel.
+    cColorf getChannelColor(const unsigned int a_channel) const;
+
+    //! This method sets the range of values of a channel which can be displayed on the scope.
+    void setChannelRange(const unsigned int a_channel,
+                         const double a_minValue,
+                         const double a_maxValue);
+
+    //! This method sets the range of values of all channels.
+    virtual void setRange(const double a_minValue, 
+                          const double a_maxValue); 
+
+    //! This method returns the minimum value from the range of a channel.
+    double getRangeMin(const unsigned int a_channel = 0) const;
+
+    //! This method returns the maximum value from the range of a channel.
+    double getRangeMax(const unsigned int a_channel = 0) const;
+
+
+    //--------------------------------------------------------------------------
+    // PUBLIC METHODS - TIME BASE AND TRIGGER:
+    //--------------------------------------------------------------------------
+
+public:
+
+    //! This method sets the time span displayed across the width of the scope in seconds.
+    void setTimeSpan(const double a_timeSpan);
+
+    //! This method returns the time span displayed across the width of the scope in seconds.
+    double getTimeSpan() const { return (m_timeSpan); }
+
+    //! This method freezes or resumes the display.
+    void setFrozen(const bool a_frozen);
+
+    //! This method returns __true__ if the display is frozen.
+    bool getFrozen() const { return (m_frozen); }
+
+    //! This method sets the trigger channel, level and edge.
+    void setTrigger(const unsigned int a_channel,
+                    const double a_level,
+                    const CSignalScopeTrigger a_edge,
+                    const bool a_singleShot = false);
+
+    //! This method returns the edge on which the scope triggers.
+    CSignalScopeTrigger getTriggerEdge() const { return (m_triggerEdge); }
+
+    //! This method sets the horizontal position of the trigger event, as a fraction of the width of the scope.
+    void setTriggerPosition(const double a_position);
+
+    //! This method returns the horizontal position of the trigger event.
+    double getTriggerPosition() const { return (m_triggerPosition); }
+
+
+    //--------------------------------------------------------------------------
+    // PROTECTED MEMBERS:
+    //--------------------------------------------------------------------------
+
+protected:
+
+    //! Number of channels.
+    unsigned int m_numChannels;
+
+    //! Buffer of samples not yet displayed, written by the haptic thread.
+    cSignalBuffer m_buffer;
+
+    //! Time stamps of the history (ring buffer).
+    std::vector<double> m_historyTimes;
+
+    //! Channel values of the history (ring buffer).
+    std::vector<double> m_historyValues;
+
+    //! Capacity of the history in samples.
+    unsigned int m_historySize;
+
+    //! Number of samples in the history.
+    unsigned int m_historyCount;
+
+    //! Index where the next sample is stored in the history.
+    unsigned int m_historyNext;
+
+    //! Temporary storage for one sample.
+    std::vector<double> m_sample;
+
+    //! Status of each channel.
+    std::vector<bool> m_channelEnabled;
+
+    //! Color of each channel.
+    std::vector<cColorf> m_channelColors;
+
+    //! Minimum displayed value of each channel.
+    std::vector<double> m_channelMin;
+
+    //! Maximum displayed value of each channel.
+    std::vector<double> m_channelMax;
+
+    //! Time span displayed across the scope.
+    double m_timeSpan;
+
+    //! If __true__, then the display is frozen.
+    bool m_frozen;
+
+    //! Time at the right edge of the frozen display.
+    double m_frozenEnd;
+
+    //! Trigger edge.
+    CSignalScopeTrigger m_triggerEdge;
+
+    //! Trigger channel.
+    unsigned int m_triggerChannel;
+
+    //! Trigger level.
+    double m_triggerLevel;
+
+    //! If __true__, then the display freezes on the first trigger event.
+    bool m_triggerSingleShot;
+
+    //! Horizontal position of the trigger event (0.0 = left edge, 1.0 = right edge).
+    double m_triggerPosition;
+
+    //! Time of the trigger event currently displayed.
+    double m_triggerTime;
+
+    //! If __true__, then a trigger event is being displayed.
+    bool m_triggered;
+
+    //! Trigger events waiting for enough samples to fill the display.
+    std::deque<double> m_triggerCandidates;
+
+    //! Width used to render lines.
+    double m_lineWidth;
+
+    //! Internal width of scope data display.
+    double m_scopeWidth;
+
+    //! Internal height of scope data display.
+    double m_scopeHeight;
+
+    //! Position of scope in reference to Panel.
+    cVector3d m_scopePosition;
+
+    //! Decimated minimum of each channel, per column.
+    std::vector<double> m_columnMin;
+
+    //! Decimated maximum of each channel, per column.
+    std::vector<double> m_columnMax;
+
+    //! Per column, __true__ if the minimum was reached before the maximum.
+    std::vector<char> m_columnMinFirst;
+
+    //! Per column, __true__ if at least one sample falls in the column.
+    std::vector<char> m_columnUsed;
+
+
+    //--------------------------------------------------------------------------
+    // PROTECTED METHODS:
+    //--------------------------------------------------------------------------
+
+protected:
+
+    //! This method renders the object graphically using OpenGL.
+    virtual void render(cRenderOptions& a_options);
+
+    //! This method decimates the visible samples to one minimum and maximum per column.
+    void decimate(const double a_timeStart, const unsigned int a_numColumns);
+
+    //! This method returns the time at the right edge of the display.
+    double getDisplayEnd() const;
+
+    //! This method returns the index in the history of the first sample at or after a given time.
+    unsigned int findSample(const double a_time) const;
+
+    //! This method returns the time of a sample of the history (0 = oldest sample).
+    inline double getHistoryTime(const unsigned int a_index) const
+    {
+        return (m_historyTimes[(m_historyNext + m_historySize - m_historyCount + a_index) % m_historySize]);
+    }
+
+    //! This method returns the value of a channel of a sample of the history (0 = oldest sample).
+    inline double getHistoryValue(const unsigned int a_index, const unsigned int a_channel) const
+    {
+        return (m_historyValues[((m_historyNext + m_historySize - m_historyCount + a_index) % m_historySize) * m_numChannels + a_channel]);
+    }
+
+    //! This method copies all properties of this object to another.
+    void copySignalScopeProperties(cSignalScope* a_obj,
+        const bool a_duplicateMaterialData,
+        const bool a_duplicateTextureData, 
+        const bool a_duplicateMeshData,
+        const bool a_buildCollisionDetector);
+};
+
+//------------------------------------------------------------------------------
+} // namespace chai3d
+//------------------------------------------------------------------------------
+
+//------------------------------------------------------------------------------
+#endif
+//------------------------------------------------------------------------------
@@ -53,6 +53,7 @@
 #include "effects/CEffectVibration.h"
 #include "effects/CEffectViscosity.h"
 #include "shaders/CShaderProgram.h"
+#include "world/CPrimitiveBatch.h"
 //------------------------------------------------------------------------------
 #include <float.h>
 #include <vector>
@@ -134,6 +135,10 @@ cGenericObject::cGenericObject()
     // no parent defined
     m_parent = NULL;
 
+    // global frame needs to be computed
+    m_globalPositionsDirty = true;
+    m_globalPositionsMoved = false;
+
     // object is not interacting with any tool
     m_interactionInside = false;
     m_interactionPoint.zero();
@@ -347,6 +352,13 @@ void cGenericObject::rotateIntrinsicEulerAnglesRad(const double& a_angleRad1,
     If \a a_frameOnly is set to __false__, additional global positions such as
     vertex positions are computed too (which may be time-consuming!). \n
 
+    If \a a_frameOnly is set to __true__, children are only visited when the 
+    global frame of this object has changed, or when the local frame of one of
+    its descendants was modified since the last update (see 
+    \ref invalidateGlobalPositions()). The cost of an update therefore scales 
+    with the number of objects that moved rather than with the size of the 
+    scene graph. \n
+
     \param  a_frameOnly  If __true__ then only the global frame is computed
     \param  a_globalPos  Global position of parent object.
     \param  a_globalRot  Global rotation matrix of parent object.
@@ -359,13 +371,26 @@ void cGenericObject::computeGlobalPositions(const bool a_frameOnly,
     // check if node is a ghost. If yes, then ignore call
     if (m_ghostEnabled) { return; }
 
+    // compute global position vector and global rotation matrix
+    cVector3d globalPos = cAdd(a_globalPos, cMul(a_globalRot, m_localPos));
+    cMatrix3d globalRot = cMul(a_globalRot, m_localRot);
+
+    // check if global frame has changed since last update
+    m_globalPositionsMoved = !(globalPos.equals(m_globalPos) && globalRot.equals(m_globalRot));
+
     // current values become previous values
     m_prevGlobalPos = m_globalPos;
     m_prevGlobalRot = m_globalRot;
 
     // update global position vector and global rotation matrix
-    m_globalPos = cAdd(a_globalPos, cMul(a_globalRot, m_localPos));
-    m_globalRot = cMul(a_globalRot, m_localRot);
+    m_globalPos = globalPos;
+    m_globalRot = globalRot;
+
+    // if the frame of this object has not changed and nothing below it has been 
+    // modified, then the global frames of all descendants are already up to date
+    if (a_frameOnly && !m_globalPositionsMoved && !m_globalPositionsDirty) { return; }
+
+    m_globalPositionsDirty = false;
 
     // update any positions within the current object that need to be
     // updated (e.g. vertex positions)
@@ -377,6 +402,13 @@ void cGenericObject::computeGlobalPositions(const bool a_frameOnly,
     {
         (*it)->computeGlobalPositions(a_frameOnly, m_globalPos, m_globalRot);
     }
+
+    // if object has moved, its previous position still differs from its current
+    // position. we visit it again during the next update so that both catch up.
+    if (m_globalPositionsMoved)
+    {
+        invalidateGlobalPositions();
+    }
 }
 
 
@@ -423,6 +455,29 @@ void cGenericObject::computeGlobalPositionsFromRoot(const bool a_frameOnly)
 }
 
 
+//==============================================================================
+/*!
+    This method marks the global position of this object as out of date. 
+    The flag is propagated up the scene graph so that the next call to 
+    \ref computeGlobalPositions() from any ancestor reaches this object. 
+    Propagation stops at the first ancestor that is already marked. \n
+
+    This method is called by \ref setLocalPos(), \ref setLocalRot() and when 
+    the scene graph is modified. Classes that modify \ref m_localPos or 
+    \ref m_localRot directly must call it too.
+*/
+//==============================================================================
+void cGenericObject::invalidateGlobalPositions()
+{
+    cGenericObject* object = this;
+    while ((object != NULL) && (!object->m_globalPositionsDirty))
+    {
+        object->m_globalPositionsDirty = true;
+        object = object->m_parent;
+    }
+}
+
+
 //==============================================================================
 /*!
     This method adds a haptic effect to this object.
@@ -1700,6 +1755,149 @@ bool cGenericObject::computeCollisionDetection(const cVector3d& a_segmentPointA,
 }
 
 
+//==============================================================================
+/*!
+    This method determines whether each segment of a batch intersects this 
+    object or any of its descendants. \n
+    Segment \p i is described by start point \p a_segmentPointsA[i] and end 
+    point \p a_segmentPointsB[i], and its collisions are reported in recorder
+    \p a_recorders[i]. \n
+    All segments are converted to the local frame once, and passed together
+    to the collision detector (see \ref cGenericCollision::computeCollisionBatch()),
+    in chunks of at most \ref C_COLLISION_MAX_SEGMENTS segments.
+    
+    \param  a_numSegments     Number of segments.
+    \param  a_segmentPointsA  Start points of segments.
+    \param  a_segmentPointsB  End points of segments.
+    \param  a_recorders       Recorders which store the collision events of each segment.
+    \param  a_settings        Collision settings information.
+
+    \return __true__ if one or more collisions have occurred, __false__ otherwise.
+*/
+//==============================================================================
+bool cGenericObject::computeCollisionDetectionBatch(const int a_numSegments,
+                                                    const cVector3d* a_segmentPointsA,
+                                                    const cVector3d* a_segmentPointsB,
+                                                    cCollisionRecorder** a_recorders,
+                                                    cCollisionSettings& a_settings)
+{
+    ///////////////////////////////////////////////////////////////////////////
+    // INITIALIZATION
+    ///////////////////////////////////////////////////////////////////////////
+
+    // check if node is a ghost. If yes, then ignore call
+    if (m_ghostEnabled) { return (false); }
+
+    // process batches larger than the segment masks of collision detectors in chunks
+    if (a_numSegments > C_COLLISION_MAX_SEGMENTS)
+    {
+        bool hit = false;
+        for (int first=0; first<a_numSegments; first+=C_COLLISION_MAX_SEGMENTS)
+        {
+            hit = hit | computeCollisionDetectionBatch(cMin(a_numSegments - first, C_COLLISION_MAX_SEGMENTS),
+                                                       &a_segmentPointsA[first],
+                                                       &a_segmentPointsB[first],
+                                                       &a_recorders[first],
+                                                       a_settings);
+        }
+        return (hit);
+    }
+
+    // temp variable
+    bool hit = false;
+    int numSegments = a_numSegments;
+
+    // get the transpose of the local rotation matrix
+    cMatrix3d transLocalRot;
+    m_localRot.transr(transLocalRot);
+
+    // convert endpoints of the segments into local coordinate frame
+    cVector3d localSegmentPointsA[C_COLLISION_MAX_SEGMENTS];
+    cVector3d localSegmentPointsB[C_COLLISION_MAX_SEGMENTS];
+    for (int i=0; i<numSegments; i++)
+    {
+        localSegmentPointsA[i] = a_segmentPointsA[i];
+        localSegmentPointsA[i].sub(m_localPos);
+        transLocalRot.mul(localSegmentPointsA[i]);
+
+        localSegmentPointsB[i] = a_segmentPointsB[i];
+        localSegmentPointsB[i].sub(m_localPos);
+        transLocalRot.mul(localSegmentPointsB[i]);
+    }
+
+
+    ///////////////////////////////////////////////////////////////////////////
+    // CHECK COLLISIONS
+    ///////////////////////////////////////////////////////////////////////////
+
+    if ((m_enabled) &&
+        ((a_settings.m_checkVisibleObjects && m_showEnabled) ||
+         (a_settings.m_checkHapticObjects && m_hapticEnabled)))
+    {
+        // adjust the first segment endpoints for motion of object (see computeCollisionDetection())
+        cVector3d localSegmentPointsAadjusted[C_COLLISION_MAX_SEGMENTS];
+        for (int i=0; i<numSegments; i++)
+        {
+            if (a_settings.m_adjustObjectMotion)
+            {
+                adjustCollisionSegment(localSegmentPointsA[i], localSegmentPointsAadjusted[i]);
+            }
+            else
+            {
+                localSegmentPointsAadjusted[i] = localSegmentPointsA[i];
+            }
+        }
+
+        // call the collision detector's batched collision detection function
+        if (m_collisionDetector != NULL)
+        {
+            if (m_collisionDetector->computeCollisionBatch(this,
+                                                           numSegments,
+                                                           localSegmentPointsAadjusted,
+                                                           localSegmentPointsB,
+                                                           a_recorders,
+                                                           a_settings))
+            {
+                // record that there has been a collision
+                hit = true;
+            }
+        }
+
+        // compute any other collisions
+        for (int i=0; i<numSegments; i++)
+        {
+            hit = hit | computeOtherCollisionDetection(localSegmentPointsAadjusted[i],
+                                                       localSegmentPointsB[i],
+                                                       *a_recorders[i],
+                                                       a_settings);
+        }
+    }
+
+
+    ///////////////////////////////////////////////////////////////////////////
+    // CHECK CHILDREN
+    ///////////////////////////////////////////////////////////////////////////
+
+    // check for collisions with all children of this object
+    for (unsigned int i=0; i<m_children.size(); i++)
+    {
+        hit = hit | m_children[i]->computeCollisionDetectionBatch(numSegments,
+                                                                  localSegmentPointsA,
+                                                                  localSegmentPointsB,
+                                                                  a_recorders,
+                                                                  a_settings);
+    }
+
+
+    ///////////////////////////////////////////////////////////////////////////
+    // FINALIZE
+    ///////////////////////////////////////////////////////////////////////////
+
+    // return whether there was a collision between the segments and this object
+    return (hit);
+}
+
+
 //==============================================================================
 /*!
     This method enables or disables graphic representation of the collision 
@@ -1789,6 +1987,8 @@ bool cGenericObject::addChild(cGenericObject* a_object)
     {
         m_children.push_back(a_object);
         a_object->m_parent = this;
+        a_object->invalidateGlobalPositions();
+        invalidateGlobalPositions();
         return (true);
     }
 
@@ -1797,6 +1997,7 @@ bool cGenericObject::addChild(cGenericObject* a_object)
     else if (m_ghostEnabled)
     {
         m_children.push_back(a_object);
+        invalidateGlobalPositions();
         return (true);
     }
 
@@ -1984,6 +2185,7 @@ void cGenericObject::scale(const double& a_scaleFactor,
         for (it = m_children.begin(); it < m_children.end(); it++)
         {
             (*it)->m_localPos.mul(a_scaleFactor);
+            (*it)->invalidateGlobalPositions();
             (*it)->scale(a_scaleFactor, true);
         }
     }
@@ -2156,6 +2358,35 @@ void cGenericObject::renderSceneGraph(cRenderOptions& a_options)
     glPushMatrix();
     glMultMatrixd( (const double *)m_frameGL.getData() );
 
+    // render object
+    renderObject(a_options);
+
+    // render children
+    for (unsigned int i=0; i<m_children.size(); i++)
+    {
+        m_children[i]->renderSceneGraph(a_options);
+    }
+
+    // pop current matrix
+    glPopMatrix();
+
+#endif
+}
+
+
+//==============================================================================
+/*!
+    This method renders this object only, excluding its children, in the 
+    current OpenGL reference frame. It renders the object itself, its 
+    reference frame and its collision tree according to the rendering options.
+
+    \param  a_options  Rendering options.
+*/
+//==============================================================================
+void cGenericObject::renderObject(cRenderOptions& a_options)
+{
+#ifdef C_USE_OPENGL
+
     // render if object is enabled
     if (m_enabled)
     {
@@ -2242,6 +2473,16 @@ void cGenericObject::renderSceneGraph(cRenderOptions& a_options)
         //-----------------------------------------------------------------------
         if (m_showEnabled)
         {
+            // in single pass mode, batched shapes are drawn before transparent
+            // objects which are not batched, so that they remain visible through them
+            if (a_options.m_single_pass_only && m_useTransparency && 
+                (a_options.m_primitiveBatch != NULL) && 
+                !a_options.m_primitiveBatch->isEmpty() &&
+                !a_options.m_primitiveBatch->canBatch(this, a_options))
+            {
+                a_options.m_primitiveBatch->render(a_options);
+            }
+
             // set polygon and face mode
             glPolygonMode(GL_FRONT_AND_BACK, m_triangleMode);
 
@@ -2371,15 +2612,6 @@ void cGenericObject::renderSceneGraph(cRenderOptions& a_options)
         }
     }
 
-    // render children
-    for (unsigned int i=0; i<m_children.size(); i++)
-    {
-        m_children[i]->renderSceneGraph(a_options);
-    }
-
-    // pop current matrix
-    glPopMatrix();
-
 #endif
 }
 
@@ -112,6 +112,7 @@ typedef std::shared_ptr<cShaderProgram> cShaderProgramPtr;
 class cGenericObject : public cGenericType
 {
     friend class cMultiMesh;
+    friend class cRenderQueue;
 
     //--------------------------------------------------------------------------
     // CONSTRUCTOR & DESTRUCTOR:
@@ -162,6 +163,7 @@ public:
     virtual void setLocalPos(const cVector3d& a_localPos)
     {
         m_localPos = a_localPos;
+        invalidateGlobalPositions();
     }
 
 #ifdef C_USE_EIGEN
@@ -190,6 +192,7 @@ public:
     virtual void setLocalRot(const cMatrix3d& a_localRot)
     {
         m_localRot = a_localRot;
+        invalidateGlobalPositions();
     }
 
 #ifdef C_USE_EIGEN
@@ -329,6 +332,12 @@ public:
     //! This method computes the global position and rotation of current object only.
     void computeGlobalPositionsFromRoot(const bool a_frameOnly = true);
 
+    //! This method marks the global position of this object and of its children as out of date.
+    virtual void invalidateGlobalPositions();
+
+    //! This method returns __true__ if the global position or rotation of this object changed during the last update.
+    inline bool getGlobalPositionsMoved() const { return (m_globalPositionsMoved); }
+
 
     //-----------------------------------------------------------------------
     // PUBLIC METHODS - HAPTIC EFFECTS:
@@ -599,6 +608,13 @@ public:
         cCollisionRecorder& a_recorder,
         cCollisionSettings& a_settings);
 
+    //! This method computes any collision between a batch of segments and this object.
+    virtual bool computeCollisionDetectionBatch(const int a_numSegments,
+        const cVector3d* a_segmentPointsA,
+        const cVector3d* a_segmentPointsB,
+        cCollisionRecorder** a_recorders,
+        cCollisionSettings& a_settings);
+
     //! This method enables or disables the display of the collision detector, optionally propagating the change to its children.
     virtual void setShowCollisionDetector(const bool a_showCollisionDetector, const bool a_affectChildren = false);
 
@@ -618,7 +634,12 @@ public:
 public:
 
     //! This method sets the parent of this object.
-    inline void setParent(cGenericObject* a_parent) { m_parent = a_parent; }
+    inline void setParent(cGenericObject* a_parent) 
+    { 
+        m_parent = a_parent; 
+        invalidateGlobalPositions(); 
+        if (m_parent != NULL) { m_parent->invalidateGlobalPositions(); }
+    }
 
     //! This method returns the parent of this object.
     inline cGenericObject* getParent() const { return (m_parent); }
@@ -664,7 +685,7 @@ public:
 public:
 
     //! This method enables or disables this object to be a ghost node.
-    void setGhostEnabled(bool a_ghostEnabled) { m_ghostEnabled = a_ghostEnabled; }
+    void setGhostEnabled(bool a_ghostEnabled) { m_ghostEnabled = a_ghostEnabled; invalidateGlobalPositions(); }
 
     //! This method returns __truee__ if this object is a ghost node.
     bool getGhostEnabled() { return (m_ghostEnabled); }
@@ -762,6 +783,12 @@ protected:
     //! Previous rotation since last haptic computation.
     cMatrix3d m_prevGlobalRot;
 
+    //! If __true__, then the global frame of this object or of one of its descendants is out of date.
+    bool m_globalPositionsDirty;
+
+    //! If __true__, then the global frame of this object changed during the last update.
+    bool m_globalPositionsMoved;
+
 
     //-----------------------------------------------------------------------
     // PROTECTED MEMBERS - BOUNDARY BOX
@@ -896,6 +923,9 @@ protected:
     //! This method renders this object graphically using OpenGL.
     virtual void render(cRenderOptions& a_options);
 
+    //! This method renders this object, excluding its children, in the current OpenGL reference frame.
+    void renderObject(cRenderOptions& a_options);
+
     //! This method update the global position information about this object.
     virtual void updateGlobalPositions(const bool a_frameOnly) {};
 
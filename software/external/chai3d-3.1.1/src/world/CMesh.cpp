@@ -49,6 +49,7 @@
 #include "collisions/CGenericCollision.h"
 #include "collisions/CCollisionBrute.h"
 #include "collisions/CCollisionAABB.h"
+#include "collisions/CCollisionBVH.h"
 #include "files/CFileModel3DS.h"
 #include "files/CFileModelOBJ.h"
 #include "shaders/CShaderProgram.h"
@@ -680,7 +681,7 @@ void cMesh::offsetVertices(const cVector3d& a_offset,
     // update collision detector if requested
     if (a_updateCollisionDetector && m_collisionDetector)
     {
-        m_collisionDetector->initialize();
+        m_collisionDetector->update();
     }
 
     // mark for update
@@ -1016,6 +1017,50 @@ void cMesh::createAABBCollisionDetector(const double a_radius)
 }
 
 
+//==============================================================================
+/*!
+    This method builds a BVH collision detector for this mesh. The tree is
+    built with the surface area heuristic, which is faster to query than
+    \ref createAABBCollisionDetector() for large or unevenly tessellated meshes.
+
+    \param  a_radius  Bounding radius.
+*/
+//==============================================================================
+void cMesh::createBVHCollisionDetector(const double a_radius)
+{
+    // delete previous collision detector
+    if (m_collisionDetector != NULL)
+    {
+        delete m_collisionDetector;
+        m_collisionDetector = NULL;
+    }
+
+    // create BVH collision detector
+    cCollisionBVH* col = new cCollisionBVH();
+    col->initialize(m_triangles, a_radius);
+
+    // assign new collision detector
+    m_collisionDetector = col;
+}
+
+
+//==============================================================================
+/*!
+    This method updates the collision detector of this mesh after the 
+    positions of its vertices have been modified (e.g. animated or deformable
+    meshes). AABB and BVH trees are refit instead of being rebuilt. If 
+    triangles have been added or removed, the tree is rebuilt.
+*/
+//==============================================================================
+void cMesh::updateCollisionDetector()
+{
+    if (m_collisionDetector != NULL)
+    {
+        m_collisionDetector->update();
+    }
+}
+
+
 //==============================================================================
 /*!
     This method uses the position of the tool and searches for the nearest point
@@ -289,6 +289,12 @@ public:
     //! This method builds an AABB collision detector for this mesh.
     virtual void createAABBCollisionDetector(const double a_radius);
 
+    //! This method builds an SAH-built BVH collision detector for this mesh.
+    virtual void createBVHCollisionDetector(const double a_radius);
+
+    //! This method updates the collision detector of this mesh after its vertices have moved.
+    virtual void updateCollisionDetector();
+
 
     //--------------------------------------------------------------------------
     // PUBLIC METHODS - GEOMETRY:
@@ -47,7 +47,9 @@
 #include "collisions/CGenericCollision.h"
 #include "collisions/CCollisionBrute.h"
 #include "collisions/CCollisionAABB.h"
+#include "collisions/CCollisionBVH.h"
 #include "files/CFileModel3DS.h"
+#include "files/CFileModelCMESH.h"
 #include "files/CFileModelOBJ.h"
 #include "files/CFileModelSTL.h"
 #include "math/CMaths.h"
@@ -967,6 +969,164 @@ bool cMultiMesh::computeCollisionDetection(const cVector3d& a_segmentPointA,
 }
 
 
+//==============================================================================
+/*!
+    This method determines whether each segment of a batch intersects this 
+    object or any of its descendants. \n
+    Segment \p i is described by start point \p a_segmentPointsA[i] and end 
+    point \p a_segmentPointsB[i], and its collisions are reported in recorder
+    \p a_recorders[i]. \n
+    All segments are converted to the local frame once, and passed together
+    to the collision detector (see \ref cGenericCollision::computeCollisionBatch()),
+    in chunks of at most \ref C_COLLISION_MAX_SEGMENTS segments.
+    
+    \param  a_numSegments     Number of segments.
+    \param  a_segmentPointsA  Start points of segments.
+    \param  a_segmentPointsB  End points of segments.
+    \param  a_recorders       Recorders which store the collision events of each segment.
+    \param  a_settings        Collision settings information.
+
+    \return __true__ if one or more collisions have occurred, __false__ otherwise.
+*/
+//==============================================================================
+bool cMultiMesh::computeCollisionDetectionBatch(const int a_numSegments,
+                                                const cVector3d* a_segmentPointsA,
+                                                const cVector3d* a_segmentPointsB,
+                                                cCollisionRecorder** a_recorders,
+                                                cCollisionSettings& a_settings)
+{
+    ///////////////////////////////////////////////////////////////////////////
+    // INITIALIZATION
+    ///////////////////////////////////////////////////////////////////////////
+
+    // check if node is a ghost. If yes, then ignore call
+    if (m_ghostEnabled) { return (false); }
+
+    // process batches larger than the segment masks of collision detectors in chunks
+    if (a_numSegments > C_COLLISION_MAX_SEGMENTS)
+    {
+        bool hit = false;
+        for (int first=0; first<a_numSegments; first+=C_COLLISION_MAX_SEGMENTS)
+        {
+            hit = hit | computeCollisionDetectionBatch(cMin(a_numSegments - first, C_COLLISION_MAX_SEGMENTS),
+                                                       &a_segmentPointsA[first],
+                                                       &a_segmentPointsB[first],
+                                                       &a_recorders[first],
+                                                       a_settings);
+        }
+        return (hit);
+    }
+
+    // temp variable
+    bool hit = false;
+    int numSegments = a_numSegments;
+
+    // get the transpose of the local rotation matrix
+    cMatrix3d transLocalRot;
+    m_localRot.transr(transLocalRot);
+
+    // convert endpoints of the segments into local coordinate frame
+    cVector3d localSegmentPointsA[C_COLLISION_MAX_SEGMENTS];
+    cVector3d localSegmentPointsB[C_COLLISION_MAX_SEGMENTS];
+    for (int i=0; i<numSegments; i++)
+    {
+        localSegmentPointsA[i] = a_segmentPointsA[i];
+        localSegmentPointsA[i].sub(m_localPos);
+        transLocalRot.mul(localSegmentPointsA[i]);
+
+        localSegmentPointsB[i] = a_segmentPointsB[i];
+        localSegmentPointsB[i].sub(m_localPos);
+        transLocalRot.mul(localSegmentPointsB[i]);
+    }
+
+
+    ///////////////////////////////////////////////////////////////////////////
+    // CHECK COLLISIONS
+    ///////////////////////////////////////////////////////////////////////////
+
+    if ((m_enabled) &&
+        ((a_settings.m_checkVisibleObjects && m_showEnabled) ||
+         (a_settings.m_checkHapticObjects && m_hapticEnabled)))
+    {
+        // adjust the first segment endpoints for motion of object (see computeCollisionDetection())
+        cVector3d localSegmentPointsAadjusted[C_COLLISION_MAX_SEGMENTS];
+        for (int i=0; i<numSegments; i++)
+        {
+            if (a_settings.m_adjustObjectMotion)
+            {
+                adjustCollisionSegment(localSegmentPointsA[i], localSegmentPointsAadjusted[i]);
+            }
+            else
+            {
+                localSegmentPointsAadjusted[i] = localSegmentPointsA[i];
+            }
+        }
+
+        // call the collision detector's batched collision detection function
+        if (m_collisionDetector != NULL)
+        {
+            if (m_collisionDetector->computeCollisionBatch(this,
+                                                           numSegments,
+                                                           localSegmentPointsAadjusted,
+                                                           localSegmentPointsB,
+                                                           a_recorders,
+                                                           a_settings))
+            {
+                // record that there has been a collision
+                hit = true;
+            }
+        }
+
+        // compute any other collisions
+        for (int i=0; i<numSegments; i++)
+        {
+            hit = hit | computeOtherCollisionDetection(localSegmentPointsAadjusted[i],
+                                                       localSegmentPointsB[i],
+                                                       *a_recorders[i],
+                                                       a_settings);
+        }
+    }
+
+
+    ///////////////////////////////////////////////////////////////////////////
+    // CHECK MESHES
+    ///////////////////////////////////////////////////////////////////////////
+
+    // check for collisions with all meshes of this object
+    for (unsigned int i=0; i<m_meshes->size(); i++)
+    {
+        hit = hit | m_meshes->at(i)->computeCollisionDetectionBatch(numSegments,
+                                                                    localSegmentPointsA,
+                                                                    localSegmentPointsB,
+                                                                    a_recorders,
+                                                                    a_settings);
+    }
+
+
+    ///////////////////////////////////////////////////////////////////////////
+    // CHECK CHILDREN
+    ///////////////////////////////////////////////////////////////////////////
+
+    // check for collisions with all children of this object
+    for (unsigned int i=0; i<m_children.size(); i++)
+    {
+        hit = hit | m_children[i]->computeCollisionDetectionBatch(numSegments,
+                                                                  localSegmentPointsA,
+                                                                  localSegmentPointsB,
+                                                                  a_recorders,
+                                                                  a_settings);
+    }
+
+
+    ///////////////////////////////////////////////////////////////////////////
+    // FINALIZE
+    ///////////////////////////////////////////////////////////////////////////
+
+    // return whether there was a collision between the segments and this object
+    return (hit);
+}
+
+
 //==============================================================================
 /*!
     This method enables or disables graphic representation of the collision 
@@ -1084,6 +1244,7 @@ void cMultiMesh::scaleXYZ(const double a_scaleX, const double a_scaleY, const do
 
         // scale position
         (*it)->m_localPos.mul(a_scaleX, a_scaleY, a_scaleZ);
+        (*it)->invalidateGlobalPositions();
 
         // update boundary box
         cVector3d b_BoxMin = (*it)->m_boundaryBoxMin;
@@ -1541,7 +1702,7 @@ void cMultiMesh::convertToSingleMesh(cMesh* a_mesh)
 //==============================================================================
 /*!
     This method loads a 3D mesh file. \n
-    CHAI3D currently supports .obj, .3ds, and .stl files.
+    CHAI3D currently supports .obj, .3ds, .stl and .cmesh files.
 
     \param  a_filename  Filename of 3D model.
 
@@ -1589,6 +1750,14 @@ bool cMultiMesh::loadFromFile(string a_filename)
         result = cLoadFileSTL(this, a_filename);
     }
 
+    //--------------------------------------------------------------------
+    // .CMESH FORMAT
+    //--------------------------------------------------------------------
+    else if (fileType == "cmesh")
+    {
+        result = cLoadFileCMESH(this, a_filename);
+    }
+
     return (result);
 }
 
@@ -1596,7 +1765,7 @@ bool cMultiMesh::loadFromFile(string a_filename)
 //==============================================================================
 /*!
     This method saves a mesh object to file. \n
-    CHAI3D currently supports .obj, .3ds, and .stl files.
+    CHAI3D currently supports .obj, .3ds, .stl and .cmesh files.
 
     \param  a_filename  Filename of 3D model.
 
@@ -1644,6 +1813,14 @@ bool cMultiMesh::saveToFile(std::string a_filename)
         result = cSaveFileSTL(this, a_filename);
     }
 
+    //--------------------------------------------------------------------
+    // .CMESH FORMAT
+    //--------------------------------------------------------------------
+    else if (fileType == "cmesh")
+    {
+        result = cSaveFileCMESH(this, a_filename);
+    }
+
     return (result);
 }
 
@@ -1908,6 +2085,39 @@ void cMultiMesh::createAABBCollisionDetector(const double a_radius)
 }
 
 
+//==============================================================================
+/*!
+    This method builds a BVH collision detector for this mesh.
+
+    \param  a_radius  Bounding radius.
+*/
+//==============================================================================
+void cMultiMesh::createBVHCollisionDetector(const double a_radius)
+{
+    vector<cMesh*>::iterator it;
+    for (it = m_meshes->begin(); it < m_meshes->end(); it++)
+    {
+        (*it)->createBVHCollisionDetector(a_radius);
+    }
+}
+
+
+//==============================================================================
+/*!
+    This method updates the collision detectors of all meshes after the 
+    positions of their vertices have been modified.
+*/
+//==============================================================================
+void cMultiMesh::updateCollisionDetector()
+{
+    vector<cMesh*>::iterator it;
+    for (it = m_meshes->begin(); it < m_meshes->end(); it++)
+    {
+        (*it)->updateCollisionDetector();
+    }
+}
+
+
 //==============================================================================
 /*!
     This message renders this multi-mesh using OpenGL.
@@ -238,6 +238,13 @@ public:
                                            cCollisionRecorder& a_recorder,
                                            cCollisionSettings& a_settings);
 
+    //! This method computes any collision between a batch of segments and this object.
+    virtual bool computeCollisionDetectionBatch(const int a_numSegments,
+                                                const cVector3d* a_segmentPointsA,
+                                                const cVector3d* a_segmentPointsB,
+                                                cCollisionRecorder** a_recorders,
+                                                cCollisionSettings& a_settings);
+
     //! This method enables or disables the display of the collision detector, optionally propagating the change to its children.
     virtual void setShowCollisionDetector(const bool a_showCollisionDetector, 
                                           const bool a_affectChildren = false);
@@ -253,6 +260,12 @@ public:
     //! Set up an AABB collision detector for this mesh.
     virtual void createAABBCollisionDetector(const double a_radius);
 
+    //! Set up an SAH-built BVH collision detector for this mesh.
+    virtual void createBVHCollisionDetector(const double a_radius);
+
+    //! Update the collision detectors of all meshes after their vertices have moved.
+    virtual void updateCollisionDetector();
+
 
     //-----------------------------------------------------------------------
     // PUBLIC VIRTUAL METHODS - INTERACTIONS
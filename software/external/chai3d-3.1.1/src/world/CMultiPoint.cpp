@@ -511,7 +511,7 @@ void cMultiPoint::offsetVertices(const cVector3d& a_offset,
     // update collision detector if requested
     if (a_updateCollisionDetector && m_collisionDetector)
     {
-        m_collisionDetector->initialize();
+        m_collisionDetector->update();
     }
 }
 
@@ -524,7 +524,7 @@ void cMultiSegment::offsetVertices(const cVector3d& a_offset,
     // update collision detector if requested
     if (a_updateCollisionDetector && m_collisionDetector)
     {
-        m_collisionDetector->initialize();
+        m_collisionDetector->update();
     }
 }
 
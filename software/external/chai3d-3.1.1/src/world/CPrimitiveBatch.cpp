@@ -0,0 +1,838 @@
+//==============================================================================
+/*
+    Software License Agreement (BSD License)
+    Copyright (c) 2003-2016, CHAI3D.
+    (www.chai3d.org)
+
+    All rights reserved.
+
+    Redistribution and use in source and binary forms, with or without
+    modification, are permitted provided that the following conditions
+    are met:
+
+    * Redistributions of source code must retain the above copyright
+    notice, this list of conditions and the following disclaimer.
+
+    * Redistributions in binary form must reproduce the above
+    copyright notice, this list of conditions and the following
+    disclaimer in the documentation and/or other materials provided
+    with the distribution.
+
+    * Neither the name of CHAI3D nor the names of its contributors may
+    be used to endorse or promote products derived from this software
+    without specific prior written permission.
+
+    THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS
+    "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT
+    LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS
+    FOR A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE
+    COPYRIGHT OWNER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT,
+    INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING,
+    BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES;
+    LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER
+    CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT
+    LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN
+    ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE
+    POSSIBILITY OF SUCH DAMAGE. 
+
+
+    \author    <http://www.chai3d.org>
+    \version   3.1.1 $Rev: 1869 $
+*/
+//==============================================================================
+
+//------------------------------------------------------------------------------
+#include "world/CPrimitiveBatch.h"
+//------------------------------------------------------------------------------
+#include "world/CShapeSphere.h"
+#include "world/CShapeCylinder.h"
+//------------------------------------------------------------------------------
+#ifdef C_USE_OPENGL
+#include "graphics/COpenGLHeaders.h"
+#endif
+//------------------------------------------------------------------------------
+using namespace std;
+//------------------------------------------------------------------------------
+
+//------------------------------------------------------------------------------
+namespace chai3d {
+//------------------------------------------------------------------------------
+
+//------------------------------------------------------------------------------
+#ifndef DOXYGEN_SHOULD_SKIP_THIS
+//------------------------------------------------------------------------------
+
+// number of slices (and stacks) of each level of detail
+static const int C_PRIMITIVE_SLICES[C_PRIMITIVE_BATCH_NUM_LOD] = { 36, 18, 10 };
+
+// projected radius (in pixels) above which a level of detail is used
+static const double C_PRIMITIVE_LOD_PIXELS[C_PRIMITIVE_BATCH_NUM_LOD] = { 48.0, 12.0, 0.0 };
+
+// attribute locations of instance data. the modelview matrix uses four locations.
+static const GLuint C_PRIMITIVE_ATTRIB_MODELVIEW = 7;
+static const GLuint C_PRIMITIVE_ATTRIB_PARAMS    = 11;
+static const GLuint C_PRIMITIVE_ATTRIB_AMBIENT   = 12;
+static const GLuint C_PRIMITIVE_ATTRIB_DIFFUSE   = 13;
+static const GLuint C_PRIMITIVE_ATTRIB_SPECULAR  = 14;
+static const GLuint C_PRIMITIVE_ATTRIB_EMISSION  = 15;
+
+// vertex shader reproducing the fixed function lighting model for instanced primitives
+static const char* C_PRIMITIVE_VERTEX_SHADER =
+"#version 120                                                                           \n"
+"attribute mat4 iModelView;                                                             \n"
+"attribute vec4 iParams;                                                                \n"
+"attribute vec4 iAmbient;                                                               \n"
+"attribute vec4 iDiffuse;                                                               \n"
+"attribute vec4 iSpecular;                                                              \n"
+"attribute vec4 iEmission;                                                              \n"
+"uniform int uType;                                                                     \n"
+"uniform int uLightEnabled[8];                                                          \n"
+"                                                                                       \n"
+"vec4 computeLighting(vec3 p, vec3 n)                                                   \n"
+"{                                                                                      \n"
+"    vec4 color = iEmission + iAmbient * gl_LightModel.ambient;                         \n"
+"    for (int i=0; i<8; i++)                                                            \n"
+"    {                                                                                  \n"
+"        if (uLightEnabled[i] == 0) { continue; }                                       \n"
+"        vec3 l = gl_LightSource[i].position.xyz;                                       \n"
+"        float att = 1.0;                                                               \n"
+"        if (gl_LightSource[i].position.w != 0.0)                                       \n"
+"        {                                                                              \n"
+"            l = l - p;                                                                 \n"
+"            float d = length(l);                                                       \n"
+"            l = l / d;                                                                 \n"
+"            att = 1.0 / (gl_LightSource[i].constantAttenuation +                       \n"
+"                         gl_LightSource[i].linearAttenuation * d +                     \n"
+"                         gl_LightSource[i].quadraticAttenuation * d * d);              \n"
+"            if (gl_LightSource[i].spotCutoff <= 90.0)                                  \n"
+"            {                                                                          \n"
+"                float s = dot(-l, normalize(gl_LightSource[i].spotDirection));         \n"
+"                att *= (s < gl_LightSource[i].spotCosCutoff) ? 0.0 :                   \n"
+"                       pow(max(s, 0.0), gl_LightSource[i].spotExponent);               \n"
+"            }                                                                          \n"
+"        }                                                                              \n"
+"        else                                                                           \n"
+"        {                                                                              \n"
+"            l = normalize(l);                                                          \n"
+"        }                                                                              \n"
+"        float nl = max(dot(n, l), 0.0);                                                \n"
+"        vec4 c = iAmbient * gl_LightSource[i].ambient +                                \n"
+"                 nl * iDiffuse * gl_LightSource[i].diffuse;                            \n"
+"        if (nl > 0.0)                                                                  \n"
+"        {                                                                              \n"
+"            vec3 h = normalize(l + vec3(0.0, 0.0, 1.0));                               \n"
+"            c += pow(max(dot(n, h), 0.0001), iSpecular.a) *                            \n"
+"                 vec4(iSpecular.rgb, 1.0) * gl_LightSource[i].specular;                \n"
+"        }                                                                              \n"
+"        color += att * c;                                                              \n"
+"    }                                                                                  \n"
+"    color = clamp(color, 0.0, 1.0);                                                    \n"
+"    color.a = iDiffuse.a;                                                              \n"
+"    return (color);                                                                    \n"
+"}                                                                                      \n"
+"                                                                                       \n"
+"void main()                                                                            \n"
+"{                                                                                      \n"
+"    vec3 p = gl_Vertex.xyz;                                                            \n"
+"    vec3 n = gl_Normal;                                                                \n"
+"    if (uType == 0)                                                                    \n"
+"    {                                                                                  \n"
+"        p = p * iParams.x;                                                             \n"
+"    }                                                                                  \n"
+"    else                                                                               \n"
+"    {                                                                                  \n"
+"        if (abs(n.z) < 0.5)                                                            \n"
+"        {                                                                              \n"
+"            n = normalize(vec3(n.xy * iParams.z, iParams.x - iParams.y));              \n"
+"        }                                                                              \n"
+"        p = vec3(p.xy * mix(iParams.x, iParams.y, p.z), p.z * iParams.z);              \n"
+"    }                                                                                  \n"
+"    vec4 eye = iModelView * vec4(p, 1.0);                                              \n"
+"    n = normalize(mat3(iModelView) * n);                                               \n"
+"    gl_Position = gl_ProjectionMatrix * eye;                                           \n"
+"    gl_ClipVertex = eye;                                                               \n"
+"    gl_FogFragCoord = abs(eye.z);                                                      \n"
+"    gl_FrontColor = computeLighting(eye.xyz, n);                                       \n"
+"    gl_BackColor = computeLighting(eye.xyz, -n);                                       \n"
+"}                                                                                      \n";
+
+//------------------------------------------------------------------------------
+#ifdef C_USE_OPENGL
+#ifdef GLEW_VERSION
+
+static void cVertexAttribDivisor(const GLuint a_index, const GLuint a_divisor)
+{
+    if (GLEW_VERSION_3_3) { glVertexAttribDivisor(a_index, a_divisor); }
+    else { glVertexAttribDivisorARB(a_index, a_divisor); }
+}
+
+static void cDrawElementsInstanced(const GLsizei a_count, const GLsizei a_numInstances)
+{
+    if (GLEW_VERSION_3_3) { glDrawElementsInstanced(GL_TRIANGLES, a_count, GL_UNSIGNED_INT, 0, a_numInstances); }
+    else { glDrawElementsInstancedARB(GL_TRIANGLES, a_count, GL_UNSIGNED_INT, 0, a_numInstances); }
+}
+
+#endif
+#endif
+//------------------------------------------------------------------------------
+#endif  // DOXYGEN_SHOULD_SKIP_THIS
+//------------------------------------------------------------------------------
+
+
+//==============================================================================
+/*!
+    Constructor of cPrimitiveBatch.
+*/
+//==============================================================================
+cPrimitiveBatch::cPrimitiveBatch()
+{
+    m_initialized = false;
+    m_instancingSupported = false;
+    m_useLevelOfDetail = true;
+    m_numPendingInstances = 0;
+    m_numInstancesRendered = 0;
+    m_numDrawCallsRendered = 0;
+    m_instanceBuffer = (GLuint)(-1);
+
+    for (int i=0; i<16; i++)
+    {
+        m_projection[i] = ((i % 5) == 0) ? 1.0f : 0.0f;
+    }
+    for (int i=0; i<4; i++)
+    {
+        m_viewport[i] = 0;
+    }
+
+    for (int type=0; type<C_PRIMITIVE_NUM_TYPES; type++)
+    {
+        for (int lod=0; lod<C_PRIMITIVE_BATCH_NUM_LOD; lod++)
+        {
+            m_meshes[type][lod].m_vertexBuffer = (GLuint)(-1);
+            m_meshes[type][lod].m_indexBuffer = (GLuint)(-1);
+        }
+    }
+}
+
+
+//==============================================================================
+/*!
+    Destructor of cPrimitiveBatch.
+*/
+//==============================================================================
+cPrimitiveBatch::~cPrimitiveBatch()
+{
+}
+
+
+//==============================================================================
+/*!
+    This method checks the capabilities of the current OpenGL context. If
+    instanced draw calls are supported, the shader program used to draw 
+    instances is created.
+*/
+//==============================================================================
+void cPrimitiveBatch::initialize()
+{
+    if (m_initialized) { return; }
+    m_initialized = true;
+    m_instancingSupported = false;
+
+#ifdef C_USE_OPENGL
+#ifdef GLEW_VERSION
+    // check for necessary OpenGL extensions
+    if (!(GLEW_ARB_shading_language_100 &&
+         (GLEW_VERSION_3_3 || (GLEW_ARB_instanced_arrays && GLEW_ARB_draw_instanced))))
+    {
+        return;
+    }
+
+    // create shader program
+    cShaderPtr shader = cShader::create(C_VERTEX_SHADER);
+    if (!shader->loadSourceCode(C_PRIMITIVE_VERTEX_SHADER)) { return; }
+
+    m_shaderProgram = cShaderProgram::create();
+    m_shaderProgram->attachShader(shader);
+    m_shaderProgram->bindAttributeLocation(C_PRIMITIVE_ATTRIB_MODELVIEW, "iModelView");
+    m_shaderProgram->bindAttributeLocation(C_PRIMITIVE_ATTRIB_PARAMS,    "iParams");
+    m_shaderProgram->bindAttributeLocation(C_PRIMITIVE_ATTRIB_AMBIENT,   "iAmbient");
+    m_shaderProgram->bindAttributeLocation(C_PRIMITIVE_ATTRIB_DIFFUSE,   "iDiffuse");
+    m_shaderProgram->bindAttributeLocation(C_PRIMITIVE_ATTRIB_SPECULAR,  "iSpecular");
+    m_shaderProgram->bindAttributeLocation(C_PRIMITIVE_ATTRIB_EMISSION,  "iEmission");
+
+    if (!m_shaderProgram->linkProgram())
+    {
+        m_shaderProgram = nullptr;
+        return;
+    }
+
+    glGenBuffers(1, &m_instanceBuffer);
+    m_instancingSupported = true;
+#endif
+#endif
+}
+
+
+//==============================================================================
+/*!
+    This method prepares the batch for a new rendering pass. It must be called
+    with the view and projection matrices of the pass loaded.
+
+    \param  a_options  Rendering options.
+*/
+//==============================================================================
+void cPrimitiveBatch::begin(cRenderOptions& /*a_options*/)
+{
+#ifdef C_USE_OPENGL
+    initialize();
+
+    glGetFloatv(GL_PROJECTION_MATRIX, m_projection);
+    glGetIntegerv(GL_VIEWPORT, m_viewport);
+#endif
+}
+
+
+//==============================================================================
+/*!
+    This method returns the type of primitive of an object.
+
+    \param  a_object  Object.
+
+    \return Type of primitive, or -1 if the object cannot be batched.
+*/
+//==============================================================================
+int cPrimitiveBatch::getPrimitiveType(const cGenericObject* a_object) const
+{
+    if (dynamic_cast<const cShapeSphere*>(a_object) != NULL)
+    {
+        return (C_PRIMITIVE_SPHERE);
+    }
+
+    const cShapeCylinder* cylinder = dynamic_cast<const cShapeCylinder*>(a_object);
+    if (cylinder != NULL)
+    {
+        // without instancing, the cached mesh can only be scaled into a cylinder, not a cone
+        if (!m_instancingSupported && (cylinder->getBaseRadius() != cylinder->getTopRadius()))
+        {
+            return (-1);
+        }
+        return (C_PRIMITIVE_CYLINDER);
+    }
+
+    return (-1);
+}
+
+
+//==============================================================================
+/*!
+    This method returns __true__ if an object may be added to the batch during
+    the current rendering pass. Only spheres and cylinders which use material
+    properties, no texture, and are not rendered in wire mode are batched.
+
+    \param  a_object   Object.
+    \param  a_options  Rendering options.
+
+    \return __true__ if the object can be batched, __false__ otherwise.
+*/
+//==============================================================================
+bool cPrimitiveBatch::canBatch(const cGenericObject* a_object, const cRenderOptions& a_options) const
+{
+    if (!m_initialized) { return (false); }
+
+    if (!a_options.m_render_materials ||
+        a_options.m_creating_shadow_map ||
+        a_options.m_rendering_shadow)
+    {
+        return (false);
+    }
+
+    if (!a_object->getUseMaterial() || (a_object->m_material == nullptr)) { return (false); }
+    if (a_object->getUseTexture() && (a_object->m_texture != nullptr)) { return (false); }
+    if (a_object->getWireMode()) { return (false); }
+
+    return (getPrimitiveType(a_object) >= 0);
+}
+
+
+//==============================================================================
+/*!
+    This method adds a shape to the batch. The shape is positioned by the 
+    current OpenGL modelview matrix, and drawn with its current material when 
+    \ref render() is called.
+
+    \param  a_object   Shape object (\ref cShapeSphere or \ref cShapeCylinder).
+    \param  a_options  Rendering options.
+
+    \return __true__ if the shape was added, __false__ if it must be rendered directly.
+*/
+//==============================================================================
+bool cPrimitiveBatch::add(const cGenericObject* a_object, const cRenderOptions& a_options)
+{
+#ifdef C_USE_OPENGL
+    if (!canBatch(a_object, a_options)) { return (false); }
+
+    int type = getPrimitiveType(a_object);
+
+    cPrimitiveInstance instance;
+    glGetFloatv(GL_MODELVIEW_MATRIX, instance.m_modelView);
+
+    // size of primitive
+    double radius;
+    if (type == C_PRIMITIVE_SPHERE)
+    {
+        const cShapeSphere* sphere = static_cast<const cShapeSphere*>(a_object);
+        radius = sphere->getRadius();
+        instance.m_params[0] = (GLfloat)radius;
+        instance.m_params[1] = (GLfloat)radius;
+        instance.m_params[2] = (GLfloat)radius;
+    }
+    else
+    {
+        const cShapeCylinder* cylinder = static_cast<const cShapeCylinder*>(a_object);
+        instance.m_params[0] = (GLfloat)cylinder->getBaseRadius();
+        instance.m_params[1] = (GLfloat)cylinder->getTopRadius();
+        instance.m_params[2] = (GLfloat)cylinder->getHeight();
+        radius = cMax(cMax(cylinder->getBaseRadius(), cylinder->getTopRadius()), 0.5 * cylinder->getHeight());
+    }
+    instance.m_params[3] = 0.0f;
+
+    // material
+    cMaterial* material = a_object->m_material.get();
+    for (int i=0; i<4; i++)
+    {
+        instance.m_ambient[i]  = material->m_ambient[i];
+        instance.m_diffuse[i]  = material->m_diffuse[i];
+        instance.m_specular[i] = material->m_specular[i];
+        instance.m_emission[i] = material->m_emission[i];
+    }
+    instance.m_specular[3] = (GLfloat)material->getShininess();
+
+    // add instance to its bucket
+    int lod = selectLevelOfDetail(instance.m_modelView, radius);
+    int transparent = a_object->getUseTransparency() ? 1 : 0;
+    int culled = a_object->getUseCulling() ? 1 : 0;
+    m_buckets[type][lod][transparent][culled].m_instances.push_back(instance);
+    m_numPendingInstances++;
+
+    return (true);
+#else
+    return (false);
+#endif
+}
+
+
+//==============================================================================
+/*!
+    This method selects the level of detail of a shape from its radius 
+    projected on screen.
+
+    \param  a_modelView  Modelview matrix of the shape.
+    \param  a_radius     Bounding radius of the shape.
+
+    \return Level of detail (0 being the finest).
+*/
+//==============================================================================
+int cPrimitiveBatch::selectLevelOfDetail(const GLfloat* a_modelView, const double a_radius) const
+{
+    if (!m_useLevelOfDetail) { return (0); }
+
+    // homogeneous coordinate of the center of the shape in clip space
+    double w = m_projection[3]  * a_modelView[12] +
+               m_projection[7]  * a_modelView[13] +
+               m_projection[11] * a_modelView[14] +
+               m_projection[15];
+    if (w < C_SMALL) { return (0); }
+
+    // projected radius in pixels
+    double scale = 0.5 * cMax(fabs(m_projection[0]) * m_viewport[2], fabs(m_projection[5]) * m_viewport[3]);
+    double pixels = a_radius * scale / w;
+
+    for (int lod=0; lod<C_PRIMITIVE_BATCH_NUM_LOD-1; lod++)
+    {
+        if (pixels > C_PRIMITIVE_LOD_PIXELS[lod]) { return (lod); }
+    }
+    return (C_PRIMITIVE_BATCH_NUM_LOD-1);
+}
+
+
+//==============================================================================
+/*!
+    This method tessellates the mesh of a primitive at a level of detail and 
+    uploads it to OpenGL. Spheres have a unit radius. Cylinders have a unit 
+    radius and height, and are closed at both ends; their radius is 
+    interpolated along the height when drawn.
+
+    \param  a_type  Type of primitive.
+    \param  a_lod   Level of detail.
+*/
+//==============================================================================
+void cPrimitiveBatch::createMesh(const int a_type, const int a_lod)
+{
+#ifdef C_USE_OPENGL
+    cPrimitiveMesh& mesh = m_meshes[a_type][a_lod];
+    if (mesh.m_vertexBuffer != (GLuint)(-1)) { return; }
+
+    int slices = C_PRIMITIVE_SLICES[a_lod];
+    int stacks = slices;
+    vector<GLfloat>& v = mesh.m_vertices;
+    vector<GLuint>& t = mesh.m_indices;
+    v.clear();
+    t.clear();
+
+    if (a_type == C_PRIMITIVE_SPHERE)
+    {
+        // rings from top to bottom. position and normal are identical.
+        for (int i=0; i<=stacks; i++)
+        {
+            double phi = C_PI * (double)i / (double)stacks;
+            for (int j=0; j<=slices; j++)
+            {
+                double theta = C_TWO_PI * (double)j / (double)slices;
+                GLfloat p[3] = { (GLfloat)(sin(phi) * cos(theta)), 
+                                 (GLfloat)(sin(phi) * sin(theta)), 
+                                 (GLfloat)(cos(phi)) };
+                v.insert(v.end(), p, p + 3);
+                v.insert(v.end(), p, p + 3);
+            }
+        }
+
+        for (int i=0; i<stacks; i++)
+        {
+            for (int j=0; j<slices; j++)
+            {
+                GLuint a = i * (slices + 1) + j;
+                GLuint b = a + slices + 1;
+                GLuint tri[6] = { a, b, a + 1, a + 1, b, b + 1 };
+                t.insert(t.end(), tri, tri + 6);
+            }
+        }
+    }
+    else
+    {
+        // side, from bottom to top
+        for (int i=0; i<=stacks; i++)
+        {
+            GLfloat z = (GLfloat)i / (GLfloat)stacks;
+            for (int j=0; j<=slices; j++)
+            {
+                double theta = C_TWO_PI * (double)j / (double)slices;
+                GLfloat c = (GLfloat)cos(theta);
+                GLfloat s = (GLfloat)sin(theta);
+                GLfloat vertex[6] = { c, s, z, c, s, 0.0f };
+                v.insert(v.end(), vertex, vertex + 6);
+            }
+        }
+
+        for (int i=0; i<stacks; i++)
+        {
+            for (int j=0; j<slices; j++)
+            {
+                GLuint a = i * (slices + 1) + j;
+                GLuint b = a + slices + 1;
+                GLuint tri[6] = { a, a + 1, b, a + 1, b + 1, b };
+                t.insert(t.end(), tri, tri + 6);
+            }
+        }
+
+        // caps at both ends
+        for (int k=0; k<2; k++)
+        {
+            GLfloat z = (GLfloat)k;
+            GLfloat nz = (k == 0) ? -1.0f : 1.0f;
+            GLuint center = (GLuint)(v.size() / 6);
+            GLfloat centerVertex[6] = { 0.0f, 0.0f, z, 0.0f, 0.0f, nz };
+            v.insert(v.end(), centerVertex, centerVertex + 6);
+
+            for (int j=0; j<=slices; j++)
+            {
+                double theta = C_TWO_PI * (double)j / (double)slices;
+                GLfloat vertex[6] = { (GLfloat)cos(theta), (GLfloat)sin(theta), z, 0.0f, 0.0f, nz };
+                v.insert(v.end(), vertex, vertex + 6);
+            }
+
+            for (int j=0; j<slices; j++)
+            {
+                GLuint a = center + 1 + j;
+                if (k == 0)
+                {
+                    GLuint tri[3] = { center, a + 1, a };
+                    t.insert(t.end(), tri, tri + 3);
+                }
+                else
+                {
+                    GLuint tri[3] = { center, a, a + 1 };
+                    t.insert(t.end(), tri, tri + 3);
+                }
+            }
+        }
+    }
+
+    glGenBuffers(1, &mesh.m_vertexBuffer);
+    glBindBuffer(GL_ARRAY_BUFFER, mesh.m_vertexBuffer);
+    glBufferData(GL_ARRAY_BUFFER, v.size() * sizeof(GLfloat), &(v[0]), GL_STATIC_DRAW);
+    glBindBuffer(GL_ARRAY_BUFFER, 0);
+
+    glGenBuffers(1, &mesh.m_indexBuffer);
+    glBindBuffer(GL_ELEMENT_ARRAY_BUFFER, mesh.m_indexBuffer);
+    glBufferData(GL_ELEMENT_ARRAY_BUFFER, t.size() * sizeof(GLuint), &(t[0]), GL_STATIC_DRAW);
+    glBindBuffer(GL_ELEMENT_ARRAY_BUFFER, 0);
+#endif
+}
+
+
+//==============================================================================
+/*!
+    This method draws the instances of a bucket, either with one instanced 
+    draw call, or one draw call per instance if instancing is not supported.
+
+    \param  a_type    Type of primitive.
+    \param  a_lod     Level of detail.
+    \param  a_bucket  Bucket of instances.
+*/
+//==============================================================================
+void cPrimitiveBatch::renderBucket(const int a_type, const int a_lod, cPrimitiveBucket& a_bucket)
+{
+#ifdef C_USE_OPENGL
+    unsigned int numInstances = (unsigned int)(a_bucket.m_instances.size());
+    if (numInstances == 0) { return; }
+
+    // bind mesh
+    createMesh(a_type, a_lod);
+    cPrimitiveMesh& mesh = m_meshes[a_type][a_lod];
+    GLsizei count = (GLsizei)(mesh.m_indices.size());
+
+    glBindBuffer(GL_ARRAY_BUFFER, mesh.m_vertexBuffer);
+    glBindBuffer(GL_ELEMENT_ARRAY_BUFFER, mesh.m_indexBuffer);
+    glVertexPointer(3, GL_FLOAT, 6 * sizeof(GLfloat), 0);
+    glNormalPointer(GL_FLOAT, 6 * sizeof(GLfloat), (void*)(3 * sizeof(GLfloat)));
+
+#ifdef GLEW_VERSION
+    if (m_instancingSupported)
+    {
+        // point instance attributes at the instances of this bucket
+        GLsizei stride = sizeof(cPrimitiveInstance);
+        char* base = (char*)0 + a_bucket.m_firstInstance * sizeof(cPrimitiveInstance);
+
+        glBindBuffer(GL_ARRAY_BUFFER, m_instanceBuffer);
+        for (int i=0; i<4; i++)
+        {
+            glVertexAttribPointer(C_PRIMITIVE_ATTRIB_MODELVIEW + i, 4, GL_FLOAT, GL_FALSE, stride, base + offsetof(cPrimitiveInstance, m_modelView) + 4 * i * sizeof(GLfloat));
+        }
+        glVertexAttribPointer(C_PRIMITIVE_ATTRIB_PARAMS,   4, GL_FLOAT, GL_FALSE, stride, base + offsetof(cPrimitiveInstance, m_params));
+        glVertexAttribPointer(C_PRIMITIVE_ATTRIB_AMBIENT,  4, GL_FLOAT, GL_FALSE, stride, base + offsetof(cPrimitiveInstance, m_ambient));
+        glVertexAttribPointer(C_PRIMITIVE_ATTRIB_DIFFUSE,  4, GL_FLOAT, GL_FALSE, stride, base + offsetof(cPrimitiveInstance, m_diffuse));
+        glVertexAttribPointer(C_PRIMITIVE_ATTRIB_SPECULAR, 4, GL_FLOAT, GL_FALSE, stride, base + offsetof(cPrimitiveInstance, m_specular));
+        glVertexAttribPointer(C_PRIMITIVE_ATTRIB_EMISSION, 4, GL_FLOAT, GL_FALSE, stride, base + offsetof(cPrimitiveInstance, m_emission));
+
+        cDrawElementsInstanced(count, (GLsizei)numInstances);
+        m_numDrawCallsRendered++;
+    }
+    else
+#endif
+    {
+        // draw each instance with the cached mesh
+        for (unsigned int i=0; i<numInstances; i++)
+        {
+            const cPrimitiveInstance& instance = a_bucket.m_instances[i];
+
+            glMaterialfv(GL_FRONT_AND_BACK, GL_AMBIENT, instance.m_ambient);
+            glMaterialfv(GL_FRONT_AND_BACK, GL_DIFFUSE, instance.m_diffuse);
+            glMaterialfv(GL_FRONT_AND_BACK, GL_SPECULAR, instance.m_specular);
+            glMaterialfv(GL_FRONT_AND_BACK, GL_EMISSION, instance.m_emission);
+            glMaterialf(GL_FRONT_AND_BACK, GL_SHININESS, instance.m_specular[3]);
+
+            glLoadMatrixf(instance.m_modelView);
+            if (a_type == C_PRIMITIVE_SPHERE)
+            {
+                glScalef(instance.m_params[0], instance.m_params[0], instance.m_params[0]);
+            }
+            else
+            {
+                glScalef(instance.m_params[0], instance.m_params[0], instance.m_params[2]);
+            }
+
+            glDrawElements(GL_TRIANGLES, count, GL_UNSIGNED_INT, 0);
+            m_numDrawCallsRendered++;
+        }
+    }
+
+    m_numInstancesRendered += numInstances;
+    a_bucket.m_instances.clear();
+#endif
+}
+
+
+//==============================================================================
+/*!
+    This method draws all instances added to the batch since the last call,
+    and clears the batch. Opaque instances are drawn first, followed by 
+    transparent ones.
+
+    \param  a_options  Rendering options.
+*/
+//==============================================================================
+void cPrimitiveBatch::render(cRenderOptions& a_options)
+{
+    m_numInstancesRendered = 0;
+    m_numDrawCallsRendered = 0;
+    if (m_numPendingInstances == 0) { return; }
+
+#ifdef C_USE_OPENGL
+
+    /////////////////////////////////////////////////////////////////////////
+    // INITIALIZATION
+    /////////////////////////////////////////////////////////////////////////
+
+    glPolygonMode(GL_FRONT_AND_BACK, GL_FILL);
+    glEnable(GL_LIGHTING);
+    glEnable(GL_DEPTH_TEST);
+    glDisable(GL_COLOR_MATERIAL);
+    glEnableClientState(GL_VERTEX_ARRAY);
+    glEnableClientState(GL_NORMAL_ARRAY);
+    glDisableClientState(GL_COLOR_ARRAY);
+    glDisableClientState(GL_TEXTURE_COORD_ARRAY);
+
+#ifdef GLEW_VERSION
+    GLboolean twoSided = GL_FALSE;
+    if (m_instancingSupported)
+    {
+        // upload all instances at once, bucket after bucket
+        m_staging.clear();
+        for (int type=0; type<C_PRIMITIVE_NUM_TYPES; type++)
+        for (int lod=0; lod<C_PRIMITIVE_BATCH_NUM_LOD; lod++)
+        for (int transparent=0; transparent<2; transparent++)
+        for (int culled=0; culled<2; culled++)
+        {
+            cPrimitiveBucket& bucket = m_buckets[type][lod][transparent][culled];
+            bucket.m_firstInstance = (unsigned int)(m_staging.size());
+            m_staging.insert(m_staging.end(), bucket.m_instances.begin(), bucket.m_instances.end());
+        }
+
+        glBindBuffer(GL_ARRAY_BUFFER, m_instanceBuffer);
+        glBufferData(GL_ARRAY_BUFFER, m_staging.size() * sizeof(cPrimitiveInstance), &(m_staging[0]), GL_STREAM_DRAW);
+
+        // enable shader program
+        m_shaderProgram->use(NULL, a_options);
+        m_shaderProgram->setUniformi("uType", 0);
+
+        GLint lights[8];
+        for (int i=0; i<8; i++)
+        {
+            lights[i] = glIsEnabled(GL_LIGHT0 + i) ? 1 : 0;
+        }
+        m_shaderProgram->setUniformiv("uLightEnabled", lights, 8);
+
+        glGetBooleanv(GL_LIGHT_MODEL_TWO_SIDE, &twoSided);
+        if (twoSided)
+        {
+            glEnable(GL_VERTEX_PROGRAM_TWO_SIDE);
+        }
+
+        for (GLuint i=C_PRIMITIVE_ATTRIB_MODELVIEW; i<=C_PRIMITIVE_ATTRIB_EMISSION; i++)
+        {
+            glEnableVertexAttribArray(i);
+            cVertexAttribDivisor(i, 1);
+        }
+    }
+    else
+#endif
+    {
+        // the cached meshes are scaled to the size of each shape
+        glEnable(GL_NORMALIZE);
+        glPushMatrix();
+    }
+
+
+    /////////////////////////////////////////////////////////////////////////
+    // RENDER INSTANCES
+    /////////////////////////////////////////////////////////////////////////
+
+    for (int transparent=0; transparent<2; transparent++)
+    {
+        if (transparent)
+        {
+            glEnable(GL_BLEND);
+            glBlendFunc(GL_SRC_ALPHA, GL_ONE_MINUS_SRC_ALPHA);
+            glDepthMask(GL_FALSE);
+        }
+        else
+        {
+            glDisable(GL_BLEND);
+            glDepthMask(GL_TRUE);
+        }
+
+        for (int culled=0; culled<2; culled++)
+        {
+            // face culling follows the rules of cGenericObject::renderSceneGraph()
+            if (transparent && a_options.m_render_transparent_back_faces_only)
+            {
+                glEnable(GL_CULL_FACE);
+                glCullFace(GL_FRONT);
+            }
+            else if ((transparent && a_options.m_render_transparent_front_faces_only) || culled)
+            {
+                glEnable(GL_CULL_FACE);
+                glCullFace(GL_BACK);
+            }
+            else
+            {
+                glDisable(GL_CULL_FACE);
+            }
+
+            for (int type=0; type<C_PRIMITIVE_NUM_TYPES; type++)
+            {
+#ifdef GLEW_VERSION
+                if (m_instancingSupported)
+                {
+                    m_shaderProgram->setUniformi("uType", type);
+                }
+#endif
+                for (int lod=0; lod<C_PRIMITIVE_BATCH_NUM_LOD; lod++)
+                {
+                    renderBucket(type, lod, m_buckets[type][lod][transparent][culled]);
+                }
+            }
+        }
+    }
+
+
+    /////////////////////////////////////////////////////////////////////////
+    // FINALIZATION
+    /////////////////////////////////////////////////////////////////////////
+
+#ifdef GLEW_VERSION
+    if (m_instancingSupported)
+    {
+        for (GLuint i=C_PRIMITIVE_ATTRIB_MODELVIEW; i<=C_PRIMITIVE_ATTRIB_EMISSION; i++)
+        {
+            cVertexAttribDivisor(i, 0);
+            glDisableVertexAttribArray(i);
+        }
+        if (twoSided)
+        {
+            glDisable(GL_VERTEX_PROGRAM_TWO_SIDE);
+        }
+        m_shaderProgram->disable();
+    }
+    else
+#endif
+    {
+        glPopMatrix();
+        glDisable(GL_NORMALIZE);
+    }
+
+    glBindBuffer(GL_ARRAY_BUFFER, 0);
+    glBindBuffer(GL_ELEMENT_ARRAY_BUFFER, 0);
+    glDisableClientState(GL_VERTEX_ARRAY);
+    glDisableClientState(GL_NORMAL_ARRAY);
+    glDisable(GL_BLEND);
+    glDepthMask(GL_TRUE);
+    glDisable(GL_CULL_FACE);
+
+    m_numPendingInstances = 0;
+
+#endif
+}
+
+//------------------------------------------------------------------------------
+} // namespace chai3d
+//------------------------------------------------------------------------------
@@ -0,0 +1,281 @@
+//==============================================================================
+/*
+    Software License Agreement (BSD License)
+    Copyright (c) 2003-2016, CHAI3D.
+    (www.chai3d.org)
+
+    All rights reserved.
+
+    Redistribution and use in source and binary forms, with or without
+    modification, are permitted provided that the following conditions
+    are met:
+
+    * Redistributions of source code must retain the above copyright
+    notice, this list of conditions and the following disclaimer.
+
+    * Redistributions in binary form must reproduce the above
+    copyright notice, this list of conditions and the following
+    disclaimer in the documentation and/or other materials provided
+    with the distribution.
+
+    * Neither the name of CHAI3D nor the names of its contributors may
+    be used to endorse or promote products derived from this software
+    without specific prior written permission.
+
+    THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS
+    "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT
+    LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS
+    FOR A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE
+    COPYRIGHT OWNER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT,
+    INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING,
+    BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES;
+    LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER
+    CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT
+    LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN
+    ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE
+    POSSIBILITY OF SUCH DAMAGE. 
+
+
+    \author    <http://www.chai3d.org>
+    \version   3.1.1 $Rev: 1869 $
+*/
+//==============================================================================
+
+//------------------------------------------------------------------------------
+#ifndef CPrimitiveBatchH
+#define CPrimitiveBatchH
+//------------------------------------------------------------------------------
+#include "graphics/CRenderOptions.h"
+#include "shaders/CShaderProgram.h"
+//------------------------------------------------------------------------------
+#include <cstddef>
+#include <vector>
+//------------------------------------------------------------------------------
+
+//------------------------------------------------------------------------------
+namespace chai3d {
+//------------------------------------------------------------------------------
+
+//------------------------------------------------------------------------------
+class cGenericObject;
+//------------------------------------------------------------------------------
+
+//==============================================================================
+/*!
+    \file       CPrimitiveBatch.h
+
+    \brief
+    Implements instanced rendering of shape primitives.
+*/
+//==============================================================================
+
+//------------------------------------------------------------------------------
+//! Number of levels of detail of tessellated primitives.
+#define C_PRIMITIVE_BATCH_NUM_LOD 3
+//------------------------------------------------------------------------------
+
+//==============================================================================
+/*!
+    \class      cPrimitiveBatch
+    \ingroup    world
+
+    \brief
+    This class implements instanced rendering of shape primitives.
+
+    \details
+    cPrimitiveBatch collects spheres and cylinders (\ref cShapeSphere, 
+    \ref cShapeCylinder) while the scene graph is traversed, and draws 
+    them once traversal is completed. \n
+
+    One tessellated mesh is cached for each primitive type and level of
+    detail. The level of detail of a shape is selected from its projected 
+    size on screen. The transformation, size and material of each shape are 
+    stored in a buffer of instances, and all instances sharing the same mesh
+    and rendering state are drawn by a single instanced draw call. On 
+    hardware which does not support instancing (OpenGL 3.3 or 
+    ARB_instanced_arrays and ARB_draw_instanced), each instance is drawn 
+    with the cached mesh instead. \n
+
+    Shapes which use textures, no material properties, or wire mode are not
+    batched and are rendered directly. Batches are not used when shadow
+    maps are rendered. \n
+
+    Batching is enabled for a world by calling 
+    \ref cWorld::setUsePrimitiveBatching().
+*/
+//==============================================================================
+class cPrimitiveBatch
+{
+    //--------------------------------------------------------------------------
+    // CONSTRUCTOR & DESTRUCTOR:
+    //--------------------------------------------------------------------------
+
+public:
+
+    //! Constructor of cPrimitiveBatch.
+    cPrimitiveBatch();
+
+    //! Destructor of cPrimitiveBatch.
+    virtual ~cPrimitiveBatch();
+
+
+    //--------------------------------------------------------------------------
+    // PUBLIC METHODS:
+    //--------------------------------------------------------------------------
+
+public:
+
+    //! This method prepares the batch for a new rendering pass.
+    void begin(cRenderOptions& a_options);
+
+    //! This method returns __true__ if an object may be added to the batch during the current pass.
+    bool canBatch(const cGenericObject* a_object, const cRenderOptions& a_options) const;
+
+    //! This method adds a shape to the batch, using the current OpenGL modelview matrix.
+    bool add(const cGenericObject* a_object, const cRenderOptions& a_options);
+
+    //! This method draws and clears all instances added to the batch.
+    void render(cRenderOptions& a_options);
+
+    //! This method returns __true__ if the batch contains instances that are not yet drawn.
+    bool isEmpty() const { return (m_numPendingInstances == 0); }
+
+    //! This method enables or disables the selection of the level of detail from the projected size of shapes.
+    void setUseLevelOfDetail(const bool a_useLevelOfDetail) { m_useLevelOfDetail = a_useLevelOfDetail; }
+
+    //! This method returns __true__ if the level of detail is selected from the projected size of shapes.
+    bool getUseLevelOfDetail() const { return (m_useLevelOfDetail); }
+
+    //! This method returns __true__ if instanced draw calls are supported by the current OpenGL context.
+    bool getInstancingSupported() const { return (m_instancingSupported); }
+
+    //! This method returns the number of instances drawn by the last call to \ref render().
+    unsigned int getNumInstancesRendered() const { return (m_numInstancesRendered); }
+
+    //! This method returns the number of draw calls issued by the last call to \ref render().
+    unsigned int getNumDrawCallsRendered() const { return (m_numDrawCallsRendered); }
+
+
+    //--------------------------------------------------------------------------
+    // PROTECTED TYPES:
+    //--------------------------------------------------------------------------
+
+#ifndef DOXYGEN_SHOULD_SKIP_THIS
+
+protected:
+
+    //! Primitive types.
+    enum cPrimitiveType
+    {
+        C_PRIMITIVE_SPHERE = 0,
+        C_PRIMITIVE_CYLINDER = 1,
+        C_PRIMITIVE_NUM_TYPES = 2
+    };
+
+    //! Data of a single instance, as stored in the instance buffer.
+    struct cPrimitiveInstance
+    {
+        GLfloat m_modelView[16];
+        GLfloat m_params[4];
+        GLfloat m_ambient[4];
+        GLfloat m_diffuse[4];
+        GLfloat m_specular[4];
+        GLfloat m_emission[4];
+    };
+
+    //! Tessellated mesh of a primitive.
+    struct cPrimitiveMesh
+    {
+        std::vector<GLfloat> m_vertices;
+        std::vector<GLuint> m_indices;
+        GLuint m_vertexBuffer;
+        GLuint m_indexBuffer;
+    };
+
+    //! Instances that share a mesh and rendering state.
+    struct cPrimitiveBucket
+    {
+        std::vector<cPrimitiveInstance> m_instances;
+        unsigned int m_firstInstance;
+    };
+
+#endif  // DOXYGEN_SHOULD_SKIP_THIS
+
+
+    //--------------------------------------------------------------------------
+    // PROTECTED METHODS:
+    //--------------------------------------------------------------------------
+
+protected:
+
+    //! This method checks the capabilities of the OpenGL context and creates the shader program.
+    void initialize();
+
+    //! This method tessellates the mesh of a primitive.
+    void createMesh(const int a_type, const int a_lod);
+
+    //! This method selects the level of detail of a shape from its projected size.
+    int selectLevelOfDetail(const GLfloat* a_modelView, const double a_radius) const;
+
+    //! This method returns the type of primitive of an object, or -1 if the object cannot be batched.
+    int getPrimitiveType(const cGenericObject* a_object) const;
+
+    //! This method draws the instances of a bucket.
+    void renderBucket(const int a_type, const int a_lod, cPrimitiveBucket& a_bucket);
+
+
+    //--------------------------------------------------------------------------
+    // PROTECTED MEMBERS:
+    //--------------------------------------------------------------------------
+
+protected:
+
+    //! If __true__, then the OpenGL capabilities have been checked.
+    bool m_initialized;
+
+    //! If __true__, then instanced draw calls are supported.
+    bool m_instancingSupported;
+
+    //! If __true__, then the level of detail is selected from the projected size of shapes.
+    bool m_useLevelOfDetail;
+
+    //! Projection matrix of the current pass.
+    GLfloat m_projection[16];
+
+    //! Viewport of the current pass.
+    GLint m_viewport[4];
+
+    //! Number of instances not yet drawn.
+    unsigned int m_numPendingInstances;
+
+    //! Number of instances drawn by the last call to render().
+    unsigned int m_numInstancesRendered;
+
+    //! Number of draw calls issued by the last call to render().
+    unsigned int m_numDrawCallsRendered;
+
+    //! Shader program used for instanced draw calls.
+    cShaderProgramPtr m_shaderProgram;
+
+    //! OpenGL buffer of instances.
+    GLuint m_instanceBuffer;
+
+#ifndef DOXYGEN_SHOULD_SKIP_THIS
+    //! Cached meshes for each primitive type and level of detail.
+    cPrimitiveMesh m_meshes[C_PRIMITIVE_NUM_TYPES][C_PRIMITIVE_BATCH_NUM_LOD];
+
+    //! Buckets of instances, indexed by type, level of detail, transparency and culling.
+    cPrimitiveBucket m_buckets[C_PRIMITIVE_NUM_TYPES][C_PRIMITIVE_BATCH_NUM_LOD][2][2];
+
+    //! Staging data of the instance buffer.
+    std::vector<cPrimitiveInstance> m_staging;
+#endif
+};
+
+//------------------------------------------------------------------------------
+} // namespace chai3d
+//------------------------------------------------------------------------------
+
+//------------------------------------------------------------------------------
+#endif
+//------------------------------------------------------------------------------
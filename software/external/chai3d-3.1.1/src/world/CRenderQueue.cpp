@@ -0,0 +1,314 @@
+//==============================================================================
+/*
+    Software License Agreement (BSD License)
+    Copyright (c) 2003-2016, CHAI3D.
+    (www.chai3d.org)
+
+    All rights reserved.
+
+    Redistribution and use in source and binary forms, with or without
+    modification, are permitted provided that the following conditions
+    are met:
+
+    * Redistributions of source code must retain the above copyright
+    notice, this list of conditions and the following disclaimer.
+
+    * Redistributions in binary form must reproduce the above
+    copyright notice, this list of conditions and the following
+    disclaimer in the documentation and/or other materials provided
+    with the distribution.
+
+    * Neither the name of CHAI3D nor the names of its contributors may
+    be used to endorse or promote products derived from this software
+    without specific prior written permission.
+
+    THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS
+    "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT
+    LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS
+    FOR A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE
+    COPYRIGHT OWNER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT,
+    INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING,
+    BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES;
+    LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER
+    CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT
+    LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN
+    ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE
+    POSSIBILITY OF SUCH DAMAGE. 
+
+
+    \author    <http://www.chai3d.org>
+    \version   3.1.1 $Rev: 1869 $
+*/
+//==============================================================================
+
+//------------------------------------------------------------------------------
+#include "world/CRenderQueue.h"
+//------------------------------------------------------------------------------
+#include "world/CGenericObject.h"
+//------------------------------------------------------------------------------
+#ifdef C_USE_OPENGL
+#include "graphics/COpenGLHeaders.h"
+#endif
+//------------------------------------------------------------------------------
+#include <algorithm>
+//------------------------------------------------------------------------------
+using namespace std;
+//------------------------------------------------------------------------------
+
+//------------------------------------------------------------------------------
+namespace chai3d {
+//------------------------------------------------------------------------------
+
+//==============================================================================
+/*!
+    Constructor of cRenderQueue.
+*/
+//==============================================================================
+cRenderQueue::cRenderQueue()
+{
+    m_useFrustumCulling = true;
+    m_projection.identity();
+    m_numObjectsRendered = 0;
+    m_numObjectsCulled = 0;
+}
+
+
+//==============================================================================
+/*!
+    This method renders the scene graph below object \p a_root. Objects are 
+    gathered, culled against the view volume defined by the current OpenGL
+    projection and modelview matrices, sorted, and drawn. Opaque objects are 
+    drawn first, followed by transparent objects. \n
+
+    The queue is rebuilt at each call, so that every rendering pass (for 
+    instance each eye in stereo mode, or each pass of multi-pass 
+    transparency) uses its own view volume.
+
+    \param  a_root     Root of the scene graph to be rendered.
+    \param  a_options  Rendering options.
+*/
+//==============================================================================
+void cRenderQueue::render(cGenericObject* a_root, cRenderOptions& a_options)
+{
+#ifdef C_USE_OPENGL
+
+    m_items.clear();
+    m_opaque.clear();
+    m_transparent.clear();
+    m_numObjectsRendered = 0;
+    m_numObjectsCulled = 0;
+
+    if (a_root == NULL) { return; }
+
+    // retrieve current matrices
+    cTransform modelView;
+    glGetDoublev(GL_MODELVIEW_MATRIX, modelView.getData());
+    glGetDoublev(GL_PROJECTION_MATRIX, m_projection.getData());
+
+    // gather objects. the root object is never culled.
+    collect(a_root, modelView, a_options, false);
+
+    // sort objects
+    for (unsigned int i=0; i<m_items.size(); i++)
+    {
+        if (m_items[i].m_transparent)
+        {
+            m_transparent.push_back(&m_items[i]);
+        }
+        else
+        {
+            m_opaque.push_back(&m_items[i]);
+        }
+    }
+
+    // the root object is drawn first, since it may set up states for the 
+    // rest of the scene (e.g. light sources of a world)
+    unsigned int first = ((!m_opaque.empty()) && (m_opaque[0]->m_object == a_root)) ? 1 : 0;
+    if (m_opaque.size() > first)
+    {
+        sort(m_opaque.begin() + first, m_opaque.end(), compareOpaque);
+    }
+    sort(m_transparent.begin(), m_transparent.end(), compareTransparent);
+
+    // draw objects
+    glMatrixMode(GL_MODELVIEW);
+    glPushMatrix();
+
+    for (unsigned int i=0; i<m_opaque.size(); i++)
+    {
+        glLoadMatrixd(m_opaque[i]->m_modelView.getData());
+        m_opaque[i]->m_object->renderObject(a_options);
+    }
+
+    for (unsigned int i=0; i<m_transparent.size(); i++)
+    {
+        glLoadMatrixd(m_transparent[i]->m_modelView.getData());
+        m_transparent[i]->m_object->renderObject(a_options);
+    }
+
+    glPopMatrix();
+
+    m_numObjectsRendered = (unsigned int)m_items.size();
+
+#endif
+}
+
+
+//==============================================================================
+/*!
+    This method gathers an object and its children into the queue. As in
+    \ref cGenericObject::renderSceneGraph(), disabled objects are skipped but 
+    their children are still rendered.
+
+    \param  a_object           Object to be gathered.
+    \param  a_parentModelView  Modelview matrix of the parent object.
+    \param  a_options          Rendering options.
+    \param  a_allowCulling     If __false__, then the object is never culled.
+*/
+//==============================================================================
+void cRenderQueue::collect(cGenericObject* a_object,
+                           const cTransform& a_parentModelView, 
+                           const cRenderOptions& a_options,
+                           const bool a_allowCulling)
+{
+    // convert the position and orientation of the object into a 4x4 matrix. 
+    // this task only needs to be performed during the first rendering pass
+    if (a_options.m_storeObjectPositions)
+    {
+        a_object->m_frameGL.set(a_object->m_localPos, a_object->m_localRot);
+    }
+
+    cTransform modelView;
+    a_parentModelView.mulr(a_object->m_frameGL, modelView);
+
+    if (a_object->m_enabled)
+    {
+        bool culled = a_allowCulling && 
+                      m_useFrustumCulling && 
+                      !a_object->m_boundaryBoxEmpty &&
+                      isOutsideFrustum(modelView, a_object->m_boundaryBoxMin, a_object->m_boundaryBoxMax);
+
+        if (culled)
+        {
+            m_numObjectsCulled++;
+        }
+        else
+        {
+            // compute depth of object center in eye coordinates
+            cVector3d center(0.0, 0.0, 0.0);
+            if (!a_object->m_boundaryBoxEmpty)
+            {
+                center = a_object->getBoundaryCenter();
+            }
+            cVector3d centerEye;
+            modelView.mulr(center, centerEye);
+
+            cRenderQueueItem item;
+            item.m_object        = a_object;
+            item.m_modelView     = modelView;
+            item.m_depth         = centerEye(2);
+            item.m_transparent   = a_object->m_useTransparency;
+            item.m_shaderProgram = a_object->m_shaderProgram.get();
+            item.m_texture       = a_object->m_texture.get();
+            item.m_material      = a_object->m_material.get();
+            m_items.push_back(item);
+        }
+    }
+
+    // gather children
+    for (unsigned int i=0; i<a_object->m_children.size(); i++)
+    {
+        collect(a_object->m_children[i], modelView, a_options, true);
+    }
+}
+
+
+//==============================================================================
+/*!
+    This method returns __true__ if a boundary box lies entirely outside of
+    the view volume, that is if all its corners lie outside of the same 
+    clipping plane.
+
+    \param  a_modelView  Modelview matrix of the object.
+    \param  a_boxMin     Minimum corner of the boundary box.
+    \param  a_boxMax     Maximum corner of the boundary box.
+
+    \return __true__ if the box is outside of the view volume.
+*/
+//==============================================================================
+bool cRenderQueue::isOutsideFrustum(const cTransform& a_modelView, 
+                                    const cVector3d& a_boxMin, 
+                                    const cVector3d& a_boxMax) const
+{
+    cTransform clip;
+    m_projection.mulr(a_modelView, clip);
+
+    // clipping planes outside of which all corners tested so far lie
+    int outside = 0x3F;
+
+    for (int i=0; i<8; i++)
+    {
+        double x = (i & 1) ? a_boxMax(0) : a_boxMin(0);
+        double y = (i & 2) ? a_boxMax(1) : a_boxMin(1);
+        double z = (i & 4) ? a_boxMax(2) : a_boxMin(2);
+
+        double cx = clip(0,0) * x + clip(0,1) * y + clip(0,2) * z + clip(0,3);
+        double cy = clip(1,0) * x + clip(1,1) * y + clip(1,2) * z + clip(1,3);
+        double cz = clip(2,0) * x + clip(2,1) * y + clip(2,2) * z + clip(2,3);
+        double cw = clip(3,0) * x + clip(3,1) * y + clip(3,2) * z + clip(3,3);
+
+        int code = 0;
+        if (cx < -cw) { code |= 0x01; }
+        if (cx >  cw) { code |= 0x02; }
+        if (cy < -cw) { code |= 0x04; }
+        if (cy >  cw) { code |= 0x08; }
+        if (cz < -cw) { code |= 0x10; }
+        if (cz >  cw) { code |= 0x20; }
+
+        outside &= code;
+        if (outside == 0) { return (false); }
+    }
+
+    return (true);
+}
+
+
+//==============================================================================
+/*!
+    This method orders opaque objects by shader program, texture and 
+    material, then from front to back.
+
+    \param  a_item0  First object.
+    \param  a_item1  Second object.
+
+    \return __true__ if \p a_item0 is drawn before \p a_item1.
+*/
+//==============================================================================
+bool cRenderQueue::compareOpaque(const cRenderQueueItem* a_item0, const cRenderQueueItem* a_item1)
+{
+    if (a_item0->m_shaderProgram != a_item1->m_shaderProgram) { return (a_item0->m_shaderProgram < a_item1->m_shaderProgram); }
+    if (a_item0->m_texture != a_item1->m_texture) { return (a_item0->m_texture < a_item1->m_texture); }
+    if (a_item0->m_material != a_item1->m_material) { return (a_item0->m_material < a_item1->m_material); }
+    return (a_item0->m_depth > a_item1->m_depth);
+}
+
+
+//==============================================================================
+/*!
+    This method orders transparent objects from back to front. 
+
+    \param  a_item0  First object.
+    \param  a_item1  Second object.
+
+    \return __true__ if \p a_item0 is drawn before \p a_item1.
+*/
+//==============================================================================
+bool cRenderQueue::compareTransparent(const cRenderQueueItem* a_item0, const cRenderQueueItem* a_item1)
+{
+    return (a_item0->m_depth < a_item1->m_depth);
+}
+
+
+//------------------------------------------------------------------------------
+} // namespace chai3d
+//------------------------------------------------------------------------------
@@ -0,0 +1,219 @@
+//==============================================================================
+/*
+    Software License Agreement (BSD License)
+    Copyright (c) 2003-2016, CHAI3D.
+    (www.chai3d.org)
+
+    All rights reserved.
+
+    Redistribution and use in source and binary forms, with or without
+    modification, are permitted provided that the following conditions
+    are met:
+
+    * Redistributions of source code must retain the above copyright
+    notice, this list of conditions and the following disclaimer.
+
+    * Redistributions in binary form must reproduce the above
+    copyright notice, this list of conditions and the following
+    disclaimer in the documentation and/or other materials provided
+    with the distribution.
+
+    * Neither the name of CHAI3D nor the names of its contributors may
+    be used to endorse or promote products derived from this software
+    without specific prior written permission.
+
+    THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS
+    "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT
+    LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS
+    FOR A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE
+    COPYRIGHT OWNER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT,
+    INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING,
+    BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES;
+    LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER
+    CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT
+    LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN
+    ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE
+    POSSIBILITY OF SUCH DAMAGE. 
+
+
+    \author    <http://www.chai3d.org>
+    \version   3.1.1 $Rev: 1869 $
+*/
+//==============================================================================
+
+//------------------------------------------------------------------------------
+#ifndef CRenderQueueH
+#define CRenderQueueH
+//------------------------------------------------------------------------------
+#include "graphics/CRenderOptions.h"
+#include "math/CTransform.h"
+//------------------------------------------------------------------------------
+#include <vector>
+//------------------------------------------------------------------------------
+
+//------------------------------------------------------------------------------
+namespace chai3d {
+//------------------------------------------------------------------------------
+
+//------------------------------------------------------------------------------
+class cGenericObject;
+//------------------------------------------------------------------------------
+
+//==============================================================================
+/*!
+    \file       CRenderQueue.h
+
+    \brief
+    Implements a render queue with frustum culling and state sorting.
+*/
+//==============================================================================
+
+//==============================================================================
+/*!
+    \class      cRenderQueue
+    \ingroup    world
+
+    \brief
+    This class implements a render queue with frustum culling and state sorting.
+
+    \details
+    Instead of rendering a scene graph by traversing it in declaration order,
+    cRenderQueue first gathers all enabled objects of the scene graph together
+    with their modelview matrices. Objects whose boundary box lies outside of
+    the view volume of the current OpenGL projection are discarded. \n
+
+    Opaque objects are then sorted by shader program, texture and material
+    so that objects sharing the same rendering state are drawn one after the
+    other, and transparent objects are sorted from back to front. Each 
+    queued object is drawn once per rendering pass. \n
+
+    Objects with an empty boundary box are never culled. The boundary box 
+    of an object is not updated automatically when its geometry changes; 
+    \ref cGenericObject::computeBoundaryBox() must be called after 
+    deforming an object, otherwise it may be culled while still visible. \n
+
+    The render queue is enabled for a world by calling 
+    \ref cWorld::setUseRenderQueue().
+*/
+//==============================================================================
+class cRenderQueue
+{
+    //--------------------------------------------------------------------------
+    // CONSTRUCTOR & DESTRUCTOR:
+    //--------------------------------------------------------------------------
+
+public:
+
+    //! Constructor of cRenderQueue.
+    cRenderQueue();
+
+    //! Destructor of cRenderQueue.
+    virtual ~cRenderQueue() {};
+
+
+    //--------------------------------------------------------------------------
+    // PUBLIC METHODS:
+    //--------------------------------------------------------------------------
+
+public:
+
+    //! This method renders the scene graph below an object, using the current OpenGL modelview and projection matrices.
+    void render(cGenericObject* a_root, cRenderOptions& a_options);
+
+    //! This method enables or disables frustum culling.
+    void setUseFrustumCulling(const bool a_useFrustumCulling) { m_useFrustumCulling = a_useFrustumCulling; }
+
+    //! This method returns __true__ if frustum culling is enabled.
+    bool getUseFrustumCulling() const { return (m_useFrustumCulling); }
+
+    //! This method returns the number of objects drawn by the last call to \ref render().
+    unsigned int getNumObjectsRendered() const { return (m_numObjectsRendered); }
+
+    //! This method returns the number of objects culled by the last call to \ref render().
+    unsigned int getNumObjectsCulled() const { return (m_numObjectsCulled); }
+
+
+    //--------------------------------------------------------------------------
+    // PROTECTED TYPES:
+    //--------------------------------------------------------------------------
+
+#ifndef DOXYGEN_SHOULD_SKIP_THIS
+
+protected:
+
+    //! Object queued for rendering.
+    struct cRenderQueueItem
+    {
+        cGenericObject* m_object;
+        cTransform m_modelView;
+        double m_depth;
+        bool m_transparent;
+        const void* m_shaderProgram;
+        const void* m_texture;
+        const void* m_material;
+    };
+
+#endif  // DOXYGEN_SHOULD_SKIP_THIS
+
+
+    //--------------------------------------------------------------------------
+    // PROTECTED METHODS:
+    //--------------------------------------------------------------------------
+
+protected:
+
+    //! This method gathers an object and its children into the queue.
+    void collect(cGenericObject* a_object,
+                 const cTransform& a_parentModelView, 
+                 const cRenderOptions& a_options,
+                 const bool a_allowCulling);
+
+    //! This method returns __true__ if a boundary box lies entirely outside of the view volume.
+    bool isOutsideFrustum(const cTransform& a_modelView, 
+                          const cVector3d& a_boxMin, 
+                          const cVector3d& a_boxMax) const;
+
+    //! This method orders opaque objects by rendering state, then front to back.
+    static bool compareOpaque(const cRenderQueueItem* a_item0, const cRenderQueueItem* a_item1);
+
+    //! This method orders transparent objects from back to front.
+    static bool compareTransparent(const cRenderQueueItem* a_item0, const cRenderQueueItem* a_item1);
+
+
+    //--------------------------------------------------------------------------
+    // PROTECTED MEMBERS:
+    //--------------------------------------------------------------------------
+
+protected:
+
+    //! If __true__, then objects outside of the view volume are not rendered.
+    bool m_useFrustumCulling;
+
+    //! Projection matrix of the current pass.
+    cTransform m_projection;
+
+    //! Number of objects drawn by the last call to render().
+    unsigned int m_numObjectsRendered;
+
+    //! Number of objects culled by the last call to render().
+    unsigned int m_numObjectsCulled;
+
+#ifndef DOXYGEN_SHOULD_SKIP_THIS
+    //! Objects gathered during the current pass.
+    std::vector<cRenderQueueItem> m_items;
+
+    //! Opaque objects in drawing order.
+    std::vector<cRenderQueueItem*> m_opaque;
+
+    //! Transparent objects in drawing order.
+    std::vector<cRenderQueueItem*> m_transparent;
+#endif
+};
+
+//------------------------------------------------------------------------------
+} // namespace chai3d
+//------------------------------------------------------------------------------
+
+//------------------------------------------------------------------------------
+#endif
+//------------------------------------------------------------------------------
@@ -45,6 +45,7 @@
 #include <algorithm>
 //------------------------------------------------------------------------------
 #include "world/CShapeCylinder.h"
+#include "world/CPrimitiveBatch.h"
 //------------------------------------------------------------------------------
 
 //------------------------------------------------------------------------------
@@ -177,6 +178,12 @@ void cShapeCylinder::render(cRenderOptions& a_options)
     /////////////////////////////////////////////////////////////////////////
     if (SECTION_RENDER_PARTS_WITH_MATERIALS(a_options, m_useTransparency))
     {
+        // draw with other shapes by instanced rendering if possible
+        if ((a_options.m_primitiveBatch != NULL) && a_options.m_primitiveBatch->add(this, a_options))
+        {
+            return;
+        }
+
         // render material properties
         if (m_useMaterialProperty)
         {
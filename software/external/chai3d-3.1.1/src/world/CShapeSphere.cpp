@@ -43,6 +43,7 @@
 
 //------------------------------------------------------------------------------
 #include "world/CShapeSphere.h"
+#include "world/CPrimitiveBatch.h"
 //------------------------------------------------------------------------------
 #ifdef C_USE_OPENGL
 #ifdef MACOSX
@@ -185,6 +186,12 @@ void cShapeSphere::render(cRenderOptions& a_options)
     /////////////////////////////////////////////////////////////////////////
     if (SECTION_RENDER_PARTS_WITH_MATERIALS(a_options, m_useTransparency))
     {
+        // draw with other shapes by instanced rendering if possible
+        if ((a_options.m_primitiveBatch != NULL) && a_options.m_primitiveBatch->add(this, a_options))
+        {
+            return;
+        }
+
         // render material properties
         if (m_useMaterialProperty)
         {
@@ -137,6 +137,10 @@ cVoxelObject::cVoxelObject()
     
     // render only front faces
     setUseCulling(true);
+
+    // no sparse volume
+    m_sparseVolume = nullptr;
+    m_retiredSparseVolume = nullptr;
 }
 
 
@@ -147,6 +151,8 @@ cVoxelObject::cVoxelObject()
 //==============================================================================
 cVoxelObject::~cVoxelObject()
 {
+    delete m_sparseVolume.load();
+    delete m_retiredSparseVolume;
 }
 
 
@@ -305,6 +311,302 @@ void cVoxelObject::setRenderingModeCustom()
 }
 
 
+//==============================================================================
+/*!
+    This method builds a sparse volume (\ref cSparseVolume) from the voxels
+    of the texture located between the minimum and maximum texture 
+    coordinates. If requested, the signed distance field to the current
+    isosurface value is computed as well.\n\n
+
+    The texture image is kept in memory, and the sparse volume must be 
+    rebuilt after the voxels are modified and the texture is marked for 
+    update; until then collision detection scans voxels directly.\n\n
+
+    The new sparse volume is built completely before it replaces the 
+    current one, so that other threads never read a partially built 
+    volume. The replaced volume is deleted on the next call to this method
+    or to \ref deleteSparseVolume(). If the operation fails, the current 
+    sparse volume is left unchanged.
+
+    \param  a_useDistanceField  If __true__, then the signed distance field is computed.
+
+    \return __true__ if the operation succeeded, __false__ otherwise.
+*/
+//==============================================================================
+bool cVoxelObject::createSparseVolume(const bool a_useDistanceField)
+{
+    // get size of 3d texture and voxels
+    double texSize[3];
+    double st[3];
+    if (!computeVoxelSize(texSize, st))
+    {
+        return (false);
+    }
+
+    // compute range of texels covered by the object
+    int origin[3];
+    int size[3];
+    for (int i=0; i<3; i++)
+    {
+        origin[i] = cMax(0, (int)(m_minTextureCoord(i) * texSize[i]));
+        size[i] = cMin((int)(texSize[i]) - 1, (int)(m_maxTextureCoord(i) * texSize[i])) - origin[i] + 1;
+    }
+
+    // build sparse volume
+    cSparseVolumeState* state = new cSparseVolumeState();
+    if (!state->m_volume.build(m_texture->m_image.get(), origin[0], origin[1], origin[2], size[0], size[1], size[2]))
+    {
+        delete state;
+        return (false);
+    }
+
+    // compute signed distance field
+    if (a_useDistanceField)
+    {
+        state->m_volume.computeDistanceField(getIsosurfaceLevel(), cVector3d(st[0], st[1], st[2]));
+    }
+
+    // record the data the sparse volume was built from
+    state->m_texture = m_texture.get();
+    state->m_image = m_texture->m_image.get();
+    state->m_imageSize[0] = state->m_image->getWidth();
+    state->m_imageSize[1] = state->m_image->getHeight();
+    state->m_imageSize[2] = state->m_image->getImageCount();
+    state->m_updateCounter = m_texture->getUpdateCounter();
+    state->m_minCorner = m_minCorner;
+    state->m_maxCorner = m_maxCorner;
+    state->m_minTextureCoord = m_minTextureCoord;
+    state->m_maxTextureCoord = m_maxTextureCoord;
+
+    // replace current sparse volume, which is retired until the next rebuild
+    delete m_retiredSparseVolume;
+    m_retiredSparseVolume = m_sparseVolume.exchange(state);
+
+    return (true);
+}
+
+
+//==============================================================================
+/*!
+    This method deletes the sparse volume. Since the haptic thread may 
+    still be reading it, its memory is only released on the next rebuild 
+    or deletion, or when the object is deleted.
+*/
+//==============================================================================
+void cVoxelObject::deleteSparseVolume()
+{
+    delete m_retiredSparseVolume;
+    m_retiredSparseVolume = m_sparseVolume.exchange(nullptr);
+}
+
+
+//==============================================================================
+/*!
+    This method returns a pointer to the sparse volume, which may be stale
+    (see \ref isSparseVolumeValid()).
+
+    \return Pointer to the sparse volume, or __nullptr__ if none was built.
+*/
+//==============================================================================
+cSparseVolume* cVoxelObject::getSparseVolume()
+{
+    cSparseVolumeState* state = m_sparseVolume.load();
+    return ((state != nullptr) ? &(state->m_volume) : nullptr);
+}
+
+
+//==============================================================================
+/*!
+    This method returns __true__ if the sparse volume was built from the 
+    current texture, corners and texture coordinates. A sparse volume 
+    becomes stale when the texture or its image is replaced, when the 
+    texture is marked for update after its voxels are modified, or when 
+    the corners or texture coordinates change. A stale sparse volume is 
+    ignored until \ref createSparseVolume() is called again.
+
+    \return __true__ if the sparse volume is up to date, __false__ otherwise.
+*/
+//==============================================================================
+bool cVoxelObject::isSparseVolumeValid() const
+{
+    return (getValidSparseVolume() != nullptr);
+}
+
+
+//==============================================================================
+/*!
+    This method reads the current sparse volume once, and returns it if it
+    was built from the current texture, corners and texture coordinates 
+    (see \ref isSparseVolumeValid()).
+
+    \return Sparse volume, or __nullptr__ if there is none or if it is stale.
+*/
+//==============================================================================
+const cSparseVolume* cVoxelObject::getValidSparseVolume() const
+{
+    const cSparseVolumeState* state = m_sparseVolume.load();
+    if ((state == nullptr) || 
+        (m_texture == nullptr) || 
+        (m_texture.get() != state->m_texture) || 
+        (m_texture->m_image.get() != state->m_image))
+    {
+        return (nullptr);
+    }
+
+    bool valid = (m_texture->getUpdateCounter() == state->m_updateCounter) &&
+                 (state->m_image->getWidth() == state->m_imageSize[0]) &&
+                 (state->m_image->getHeight() == state->m_imageSize[1]) &&
+                 (state->m_image->getImageCount() == state->m_imageSize[2]) &&
+                 (m_minCorner.equals(state->m_minCorner)) &&
+                 (m_maxCorner.equals(state->m_maxCorner)) &&
+                 (m_minTextureCoord.equals(state->m_minTextureCoord)) &&
+                 (m_maxTextureCoord.equals(state->m_maxTextureCoord));
+
+    return (valid ? &(state->m_volume) : nullptr);
+}
+
+
+//==============================================================================
+/*!
+    This method recomputes the signed distance field of the sparse volume 
+    for the current isosurface value and voxel size. Until it is called 
+    after either of them changes, collision detection falls back to 
+    scanning voxels. The sparse volume is rebuilt with its new distance 
+    field, rather than modified while the haptic thread may be reading it.
+
+    \return __true__ if the operation succeeded, __false__ otherwise.
+*/
+//==============================================================================
+bool cVoxelObject::updateDistanceField()
+{
+    // sanity check
+    if (!isSparseVolumeValid())
+    {
+        return (false);
+    }
+
+    // rebuild sparse volume and compute signed distance field
+    return (createSparseVolume(true));
+}
+
+
+//==============================================================================
+/*!
+    This method computes the size of the 3D texture and the size of its 
+    voxels along each axis, in local coordinates.
+
+    \param  a_texSize    Returned size of texture, in voxels.
+    \param  a_voxelSize  Returned size of voxels.
+
+    \return __true__ if the texture is valid, __false__ otherwise.
+*/
+//==============================================================================
+bool cVoxelObject::computeVoxelSize(double a_texSize[3], double a_voxelSize[3])
+{
+    // sanity check
+    if ((m_texture == nullptr) || (m_texture->m_image == nullptr))
+    {
+        return (false);
+    }
+
+    // get size of 3d texture
+    a_texSize[0] = (double)(m_texture->m_image->getWidth());
+    a_texSize[1] = (double)(m_texture->m_image->getHeight());
+    a_texSize[2] = (double)(m_texture->m_image->getImageCount());
+
+    // sanity check
+    if ((a_texSize[0] == 0) || (a_texSize[1] == 0) || (a_texSize[2] == 0))
+    {
+        return (false);
+    }
+
+    // compute size of texels along each axis
+    for (int i=0; i<3; i++)
+    {
+        if (m_maxTextureCoord(i) == m_minTextureCoord(i))
+        {
+            a_voxelSize[i] = fabs(m_maxCorner(i) - m_minCorner(i));
+        }
+        else
+        {
+            double s = fabs(m_maxCorner(i) - m_minCorner(i));
+            a_voxelSize[i] = cMin(s, (s / ((m_maxTextureCoord(i) - m_minTextureCoord(i)) * a_texSize[i])));
+        }
+    }
+
+    return (true);
+}
+
+
+//==============================================================================
+/*!
+    This method returns the smallest voxel level (alpha value, from 0 to 255)
+    which is considered solid for the current isosurface value, or 256 if 
+    none is.
+
+    \return Voxel level.
+*/
+//==============================================================================
+int cVoxelObject::getIsosurfaceLevel() const
+{
+    const float CONVERSION_FACTOR = (1.0f / 255.0f);
+    for (int level=0; level<256; level++)
+    {
+        if (CONVERSION_FACTOR * (float)(level) >= m_isosurfaceValue)
+        {
+            return (level);
+        }
+    }
+    return (256);
+}
+
+
+//==============================================================================
+/*!
+    This method computes the box enclosing all voxels above the isosurface
+    value, with a margin of one voxel, using the sparse volume. If no sparse
+    volume was built, the corners of the object are returned.
+
+    \param  a_minCorner  Returned corner with minimum position coordinate.
+    \param  a_maxCorner  Returned corner with maximum position coordinate.
+
+    \return __false__ if the object contains no voxels above the isosurface value, __true__ otherwise.
+*/
+//==============================================================================
+bool cVoxelObject::computeOccupiedCorners(cVector3d& a_minCorner, cVector3d& a_maxCorner)
+{
+    a_minCorner = m_minCorner;
+    a_maxCorner = m_maxCorner;
+
+    // get size of texture and voxels
+    double texSize[3];
+    double st[3];
+    const cSparseVolume* sparseVolume = getValidSparseVolume();
+    if ((sparseVolume == nullptr) || (!computeVoxelSize(texSize, st)))
+    {
+        return (true);
+    }
+
+    // get occupied voxels
+    int voxelMin[3];
+    int voxelMax[3];
+    if (!sparseVolume->getOccupiedBounds(getIsosurfaceLevel(), voxelMin, voxelMax))
+    {
+        return (false);
+    }
+
+    // convert to local coordinates
+    for (int i=0; i<3; i++)
+    {
+        double offset = sparseVolume->getOrigin(i) - m_minTextureCoord(i) * texSize[i];
+        a_minCorner(i) = cMax(m_minCorner(i), m_minCorner(i) + (voxelMin[i] + offset - 1.0) * st[i]);
+        a_maxCorner(i) = cMin(m_maxCorner(i), m_minCorner(i) + (voxelMax[i] + offset + 2.0) * st[i]);
+    }
+
+    return (true);
+}
+
+
 //==============================================================================
 /*!
     This method renders the object using OpenGL
@@ -446,16 +748,6 @@ void cVoxelObject::update(cRenderOptions& a_options)
     m_boundaryBoxMin = v000;
     m_boundaryBoxMax = v111;
 
-    // setup corresponding texture coordinates at each corner
-    cVector3d t000(m_minTextureCoord(0), m_minTextureCoord(1), m_minTextureCoord(2));
-    cVector3d t001(m_minTextureCoord(0), m_minTextureCoord(1), m_maxTextureCoord(2));
-    cVector3d t010(m_minTextureCoord(0), m_maxTextureCoord(1), m_minTextureCoord(2));
-    cVector3d t011(m_minTextureCoord(0), m_maxTextureCoord(1), m_maxTextureCoord(2));
-    cVector3d t100(m_maxTextureCoord(0), m_minTextureCoord(1), m_minTextureCoord(2));
-    cVector3d t101(m_maxTextureCoord(0), m_minTextureCoord(1), m_maxTextureCoord(2));
-    cVector3d t110(m_maxTextureCoord(0), m_maxTextureCoord(1), m_minTextureCoord(2));
-    cVector3d t111(m_maxTextureCoord(0), m_maxTextureCoord(1), m_maxTextureCoord(2));
-
 
     ////////////////////////////////////////////////////////////////////////////
     // SETUP RENDERING WITH SHADERS
@@ -476,9 +768,29 @@ void cVoxelObject::update(cRenderOptions& a_options)
             setShaderProgram(m_programShaders[m_renderingMode]);
         }
 
-        // setup table of vertices and texture coordinates
-        cVector3d v[8] = { v111, v110, v101, v100, v011, v010, v001, v000 };
-        cVector3d t[8] = { t111, t110, t101, t100, t011, t010, t001, t000 };
+        // restrict ray casting of isosurfaces to the voxels above the isosurface value
+        cVector3d minCorner = m_minCorner;
+        cVector3d maxCorner = m_maxCorner;
+        if ((m_renderingMode >= C_RENDERING_MODE_ISOSURFACE_MATERIAL_L8) && 
+            (m_renderingMode <= C_RENDERING_MODE_ISOSURFACE_COLOR_RGBA8))
+        {
+            if (!computeOccupiedCorners(minCorner, maxCorner))
+            {
+                return;
+            }
+        }
+
+        // setup table of vertices and texture coordinates (v111, v110, ..., v000)
+        cVector3d v[8];
+        cVector3d t[8];
+        for (int i = 0; i < 8; ++i)
+        {
+            for (int j = 0; j < 3; ++j)
+            {
+                v[i](j) = (((7 - i) >> (2 - j)) & 1) ? maxCorner(j) : minCorner(j);
+                t[i](j) = m_minTextureCoord(j) + ((v[i](j) - m_minCorner(j)) / size(j)) * tsize(j);
+            }
+        }
 
         // setup table of normals
         const cVector3d norm[6] = {
@@ -520,8 +832,8 @@ void cVoxelObject::update(cRenderOptions& a_options)
         float opticalDensityFactor = (float)(0.001 * m_opticalDensity * (resolution / size.length()));
 
         // update the shader uniforms with the corner values
-        m_shaderProgram->setUniform("uMinCorner", m_minCorner);
-        m_shaderProgram->setUniform("uMaxCorner", m_maxCorner);
+        m_shaderProgram->setUniform("uMinCorner", minCorner);
+        m_shaderProgram->setUniform("uMaxCorner", maxCorner);
         m_shaderProgram->setUniform("uTextureScale", tscale);
         m_shaderProgram->setUniformi("uVolume", 0);
         m_shaderProgram->setUniformi("uColorLUT", 2);
@@ -530,7 +842,7 @@ void cVoxelObject::update(cRenderOptions& a_options)
         m_shaderProgram->setUniformf("uOpacity", m_voxelOpacity);
         m_shaderProgram->setUniformf("uOpacityThreshold", m_opacityThreshold);
         m_shaderProgram->setUniformf("uOpticalDensityFactor", opticalDensityFactor);
-        m_shaderProgram->setUniformf("uResolution", resolution);
+        m_shaderProgram->setUniformf("uResolution", (float)(resolution * cDistance(minCorner, maxCorner) / size.length()));
 
         return;
     }
@@ -990,31 +1302,12 @@ bool cVoxelObject::computeOtherCollisionDetection(cVector3d& a_segmentPointA,
     // COMPUTE INFORMATION ABOUT VOXEL OBJECT
     ////////////////////////////////////////////////////////////////////////////
 
-    // get size of 3d texture
+    // get size of 3d texture and size of texels along each axis
     double texSize[3];
-    texSize[0] = (double)(m_texture->m_image->getWidth());
-    texSize[1] = (double)(m_texture->m_image->getHeight());
-    texSize[2] = (double)(m_texture->m_image->getImageCount());
-
-    // sanity check
-    if ((texSize[0] == 0) || (texSize[1] == 0) || (texSize[2] == 0))
-    {
-        return (false);
-    }
-
-    // compute size of texels along each axis
     double st[3];
-    for (int i=0; i<3; i++)
+    if (!computeVoxelSize(texSize, st))
     {
-        if (m_maxTextureCoord(i) == m_minTextureCoord(i))
-        {
-            st[i] = fabs(m_maxCorner(i) - m_minCorner(i));
-        }
-        else
-        {
-            double s = fabs(m_maxCorner(i) - m_minCorner(i));
-            st[i] = cMin(s, (s / ((m_maxTextureCoord(i) - m_minTextureCoord(i)) * texSize[i])));
-        }
+        return (false);
     }
 
     // compute smallest voxel size
@@ -1111,97 +1404,145 @@ bool cVoxelObject::computeOtherCollisionDetection(cVector3d& a_segmentPointA,
     // distance counter
     double distance = 0.0;
 
-    // search for collision
-    while ((!hit) && (distance < distanceAB))
+    // check if the signed distance field of the sparse volume is up to date,
+    // and exact up to the collision radius
+    int isosurfaceLevel = getIsosurfaceLevel();
+    const cSparseVolume* sparseVolume = getValidSparseVolume();
+    bool useSparseVolume = (sparseVolume != nullptr);
+    bool useDistanceField = (useSparseVolume) &&
+                            (sparseVolume->getHasDistanceField()) &&
+                            (sparseVolume->getDistanceFieldLevel() == isosurfaceLevel) &&
+                            (sparseVolume->getDistanceFieldVoxelSize().equals(cVector3d(st[0], st[1], st[2]))) &&
+                            (radius <= sparseVolume->getDistanceFieldRange());
+
+    // search for collision along signed distance field
+    if (useDistanceField)
+    {
+        int voxelIndex[3];
+        hit = computeDistanceFieldCollision(sparseVolume,
+                                            a_segmentPointA, 
+                                            a_segmentPointB, 
+                                            radius,
+                                            texSize,
+                                            st,
+                                            collisionPoint,
+                                            collisionNormal,
+                                            voxelIndex);
+        if (hit)
+        {
+            collisionDistanceSq = cDistanceSq(a_segmentPointA, collisionPoint);
+            voxelIndexX = voxelIndex[0];
+            voxelIndexY = voxelIndex[1];
+            voxelIndexZ = voxelIndex[2];
+        }
+    }
+
+    // otherwise search for collision among voxels
+    else
     {
-        // increment step
-        distance = cMin((distance + 2.0 * voxelSize), distanceAB);
-
-        // compute next point
-        cVector3d pointB = a_segmentPointA + distance * dir;
-
-        // compute point in texels
-        int tv1[3];
-        tv1[0] =  (int)((m_minTextureCoord(0) + ((pointB(0) - m_minCorner(0)) / (objectRange(0))) * (texRange(0))) * texSize[0]);
-        tv1[1] =  (int)((m_minTextureCoord(1) + ((pointB(1) - m_minCorner(1)) / (objectRange(1))) * (texRange(1))) * texSize[1]);
-        tv1[2] =  (int)((m_minTextureCoord(2) + ((pointB(2) - m_minCorner(2)) / (objectRange(2))) * (texRange(2))) * texSize[2]);
-
-        // check the area covered by the radius
-        int tmin[3];
-        tmin[0] = tv1[0] - texRadius[0] - 1;
-        tmin[1] = tv1[1] - texRadius[1] - 1;
-        tmin[2] = tv1[2] - texRadius[2] - 1;
-
-        int tmax[3];
-        tmax[0] = tv1[0] + texRadius[0] + 1;
-        tmax[1] = tv1[1] + texRadius[1] + 1;
-        tmax[2] = tv1[2] + texRadius[2] + 1;
-
-        // check all voxels 
-        for (int t2=tmin[2]; t2<tmax[2]; t2++)
+        while ((!hit) && (distance < distanceAB))
         {
-            if ((t2 >= minTexel[2]) && (t2 <= maxTexel[2]))
-            for (int t1=tmin[1]; t1<tmax[1]; t1++)
+            // increment step
+            distance = cMin((distance + 2.0 * voxelSize), distanceAB);
+
+            // compute next point
+            cVector3d pointB = a_segmentPointA + distance * dir;
+
+            // compute point in texels
+            int tv1[3];
+            tv1[0] =  (int)((m_minTextureCoord(0) + ((pointB(0) - m_minCorner(0)) / (objectRange(0))) * (texRange(0))) * texSize[0]);
+            tv1[1] =  (int)((m_minTextureCoord(1) + ((pointB(1) - m_minCorner(1)) / (objectRange(1))) * (texRange(1))) * texSize[1]);
+            tv1[2] =  (int)((m_minTextureCoord(2) + ((pointB(2) - m_minCorner(2)) / (objectRange(2))) * (texRange(2))) * texSize[2]);
+
+            // check the area covered by the radius
+            int tmin[3];
+            tmin[0] = tv1[0] - texRadius[0] - 1;
+            tmin[1] = tv1[1] - texRadius[1] - 1;
+            tmin[2] = tv1[2] - texRadius[2] - 1;
+
+            int tmax[3];
+            tmax[0] = tv1[0] + texRadius[0] + 1;
+            tmax[1] = tv1[1] + texRadius[1] + 1;
+            tmax[2] = tv1[2] + texRadius[2] + 1;
+
+            // skip empty bricks of sparse volume
+            if ((useSparseVolume) &&
+                (sparseVolume->getMaxLevel(tmin[0] - sparseVolume->getOrigin(0), 
+                                           tmin[1] - sparseVolume->getOrigin(1), 
+                                           tmin[2] - sparseVolume->getOrigin(2),
+                                           tmax[0] - sparseVolume->getOrigin(0) - 1, 
+                                           tmax[1] - sparseVolume->getOrigin(1) - 1, 
+                                           tmax[2] - sparseVolume->getOrigin(2) - 1) < isosurfaceLevel))
             {
-                if ((t1 >= minTexel[1]) && (t1 <= maxTexel[1]))
-                for (int t0=tmin[0]; t0<tmax[0]; t0++)
+                continue;
+            }
+
+            // check all voxels 
+            for (int t2=tmin[2]; t2<tmax[2]; t2++)
+            {
+                if ((t2 >= minTexel[2]) && (t2 <= maxTexel[2]))
+                for (int t1=tmin[1]; t1<tmax[1]; t1++)
                 {
-                    if ((t0 >= minTexel[0]) && (t0 <= maxTexel[0]))
+                    if ((t1 >= minTexel[1]) && (t1 <= maxTexel[1]))
+                    for (int t0=tmin[0]; t0<tmax[0]; t0++)
                     {
-                        // get  voxel color
-                        cColorb color;
-                        bool result = m_texture->m_image->getVoxelColor(t0, t1, t2, color);
-
-                        if (result)
+                        if ((t0 >= minTexel[0]) && (t0 <= maxTexel[0]))
                         {
-                            const float CONVERSION_FACTOR = (1.0f / 255.0f);
-                            float level = CONVERSION_FACTOR * (float)(color.getA());
+                            // get  voxel color
+                            cColorb color;
+                            bool result = m_texture->m_image->getVoxelColor(t0, t1, t2, color);
 
-                            if (level >= m_isosurfaceValue)
+                            if (result)
                             {
-                                // compute position of texel in local space
-                                double tpos[3];
-                                tpos[0] = m_minCorner(0) + (((t0 / texSize[0]) - m_minTextureCoord(0)) / (texRange(0))) * (objectRange(0)) + 0.5 * st[0];
-                                tpos[1] = m_minCorner(1) + (((t1 / texSize[1]) - m_minTextureCoord(1)) / (texRange(1))) * (objectRange(1)) + 0.5 * st[1];
-                                tpos[2] = m_minCorner(2) + (((t2 / texSize[2]) - m_minTextureCoord(2)) / (texRange(2))) * (objectRange(2)) + 0.5 * st[2];
-
-                                // check if point is located outside of object
-                                double distanceSq = cDistanceSq(cVector3d(tpos[0], tpos[1], tpos[2]), pointB);
-                                if (distanceSq < r2)
+                                const float CONVERSION_FACTOR = (1.0f / 255.0f);
+                                float level = CONVERSION_FACTOR * (float)(color.getA());
+
+                                if (level >= m_isosurfaceValue)
                                 {
-                                    // check intersection with segment and voxel (approximated by sphere)
-                                    cVector3d t_p, t_n;
-                                    cVector3d t_collisionPoint, t_collisionNormal;
-                                    double t_collisionDistanceSq;
-
-                                    if (cIntersectionSegmentSphere(a_segmentPointA,
-                                        pointB,
-                                        cVector3d(tpos[0], tpos[1], tpos[2]),
-                                        r,
-                                        t_collisionPoint,
-                                        t_collisionNormal,
-                                        t_p,
-                                        t_n) > 0)
+                                    // compute position of texel in local space
+                                    double tpos[3];
+                                    tpos[0] = m_minCorner(0) + (((t0 / texSize[0]) - m_minTextureCoord(0)) / (texRange(0))) * (objectRange(0)) + 0.5 * st[0];
+                                    tpos[1] = m_minCorner(1) + (((t1 / texSize[1]) - m_minTextureCoord(1)) / (texRange(1))) * (objectRange(1)) + 0.5 * st[1];
+                                    tpos[2] = m_minCorner(2) + (((t2 / texSize[2]) - m_minTextureCoord(2)) / (texRange(2))) * (objectRange(2)) + 0.5 * st[2];
+
+                                    // check if point is located outside of object
+                                    double distanceSq = cDistanceSq(cVector3d(tpos[0], tpos[1], tpos[2]), pointB);
+                                    if (distanceSq < r2)
                                     {
-                                        // intersection occurred
-                                        hit = true;
-
-                                        counter++;
-
-                                        // compute distance from collision point
-                                        t_collisionDistanceSq = cDistanceSq(a_segmentPointA, t_collisionPoint);
-
-                                        // if nearest, then select and store data.
-                                        if (t_collisionDistanceSq <= collisionDistanceSq)
+                                        // check intersection with segment and voxel (approximated by sphere)
+                                        cVector3d t_p, t_n;
+                                        cVector3d t_collisionPoint, t_collisionNormal;
+                                        double t_collisionDistanceSq;
+
+                                        if (cIntersectionSegmentSphere(a_segmentPointA,
+                                            pointB,
+                                            cVector3d(tpos[0], tpos[1], tpos[2]),
+                                            r,
+                                            t_collisionPoint,
+                                            t_collisionNormal,
+                                            t_p,
+                                            t_n) > 0)
                                         {
-                                            collisionPoint = t_collisionPoint;
-                                            collisionNormal = t_collisionNormal;
-                                            collisionDistanceSq = t_collisionDistanceSq;
-                                            collisionPointV01 = 0.0;
-                                            collisionPointV02 = 0.0;
-                                            voxelIndexX = t0;
-                                            voxelIndexY = t1;
-                                            voxelIndexZ = t2;
+                                            // intersection occurred
+                                            hit = true;
+
+                                            counter++;
+
+                                            // compute distance from collision point
+                                            t_collisionDistanceSq = cDistanceSq(a_segmentPointA, t_collisionPoint);
+
+                                            // if nearest, then select and store data.
+                                            if (t_collisionDistanceSq <= collisionDistanceSq)
+                                            {
+                                                collisionPoint = t_collisionPoint;
+                                                collisionNormal = t_collisionNormal;
+                                                collisionDistanceSq = t_collisionDistanceSq;
+                                                collisionPointV01 = 0.0;
+                                                collisionPointV02 = 0.0;
+                                                voxelIndexX = t0;
+                                                voxelIndexY = t1;
+                                                voxelIndexZ = t2;
+                                            }
                                         }
                                     }
                                 }
@@ -1292,6 +1633,139 @@ bool cVoxelObject::computeOtherCollisionDetection(cVector3d& a_segmentPointA,
 }
 
 
+
+//==============================================================================
+/*!
+    This method computes the first collision between a segment and the 
+    isosurface, offset by the collision radius, by sphere tracing the signed
+    distance field of the sparse volume: the segment is followed in steps as
+    large as the distance to the surface, so that empty space is crossed in
+    a few steps. The contact is then refined by bisection, and the normal is
+    given by the gradient of the distance field.\n\n
+
+    If the segment starts inside the surface, a collision is reported at its
+    start point, unless the segment leaves the surface.
+
+    \param  a_sparseVolume     Sparse volume, read once by the caller.
+    \param  a_segmentPointA    Start point of segment (local coordinates).
+    \param  a_segmentPointB    End point of segment (local coordinates).
+    \param  a_radius           Collision radius.
+    \param  a_texSize          Size of texture.
+    \param  a_voxelSize        Size of voxels along each axis.
+    \param  a_collisionPoint   Returned collision point.
+    \param  a_collisionNormal  Returned surface normal at collision point.
+    \param  a_voxelIndex       Returned index of surface voxel nearest to collision point.
+
+    \return __true__ if a collision occurred, otherwise __false__.
+*/
+//==============================================================================
+bool cVoxelObject::computeDistanceFieldCollision(const cSparseVolume* a_sparseVolume,
+                                                 const cVector3d& a_segmentPointA,
+                                                 const cVector3d& a_segmentPointB,
+                                                 const double a_radius,
+                                                 const double a_texSize[3],
+                                                 const double a_voxelSize[3],
+                                                 cVector3d& a_collisionPoint,
+                                                 cVector3d& a_collisionNormal,
+                                                 int a_voxelIndex[3])
+{
+    // compute mapping from local coordinates to voxel coordinates of sparse volume
+    cVector3d scale;
+    cVector3d offset;
+    for (int i=0; i<3; i++)
+    {
+        scale(i) = 1.0 / a_voxelSize[i];
+        offset(i) = m_minTextureCoord(i) * a_texSize[i] - 0.5 - a_sparseVolume->getOrigin(i) - m_minCorner(i) * scale(i);
+    }
+    auto getDistance = [&](const cVector3d& a_pos, cVector3d& a_gradient)
+    {
+        cVector3d voxelPos(a_pos(0) * scale(0) + offset(0), 
+                           a_pos(1) * scale(1) + offset(1), 
+                           a_pos(2) * scale(2) + offset(2));
+        return (a_sparseVolume->getDistance(voxelPos, a_gradient) - a_radius);
+    };
+
+    // compute segment direction
+    double length = cDistance(a_segmentPointA, a_segmentPointB);
+    cVector3d dir = (1.0 / length) * (a_segmentPointB - a_segmentPointA);
+    double minStep = 0.25 * cMin(a_voxelSize[0], cMin(a_voxelSize[1], a_voxelSize[2]));
+
+    // check start point
+    cVector3d gradient;
+    double distance = getDistance(a_segmentPointA, gradient);
+    double t = 0.0;
+    if (distance <= 0.0)
+    {
+        // segment leaves the surface
+        if (cDot(gradient, dir) >= 0.0)
+        {
+            return (false);
+        }
+    }
+
+    // sphere trace along segment
+    else
+    {
+        while (true)
+        {
+            double tNext = cMin(t + cMax(distance, minStep), length);
+            double distanceNext = getDistance(a_segmentPointA + tNext * dir, gradient);
+
+            // surface crossed: refine contact by bisection, staying outside
+            if (distanceNext <= 0.0)
+            {
+                double t0 = t;
+                double t1 = tNext;
+                for (int i=0; i<16; i++)
+                {
+                    double tm = 0.5 * (t0 + t1);
+                    if (getDistance(a_segmentPointA + tm * dir, gradient) > 0.0)
+                    {
+                        t0 = tm;
+                    }
+                    else
+                    {
+                        t1 = tm;
+                    }
+                }
+                t = t0;
+                getDistance(a_segmentPointA + t * dir, gradient);
+                break;
+            }
+
+            // end of segment reached
+            if (tNext >= length)
+            {
+                return (false);
+            }
+
+            t = tNext;
+            distance = distanceNext;
+        }
+    }
+
+    // report collision point and normal
+    a_collisionPoint = a_segmentPointA + t * dir;
+    if (gradient.length() > C_SMALL)
+    {
+        a_collisionNormal = cNormalize(gradient);
+    }
+    else
+    {
+        a_collisionNormal = -dir;
+    }
+
+    // find surface voxel below collision point
+    cVector3d surfacePoint = a_collisionPoint - (a_radius + 0.5 * cMin(a_voxelSize[0], cMin(a_voxelSize[1], a_voxelSize[2]))) * a_collisionNormal;
+    for (int i=0; i<3; i++)
+    {
+        int index = (int)floor(surfacePoint(i) * scale(i) + offset(i) + 0.5);
+        a_voxelIndex[i] = cClamp(index, 0, a_sparseVolume->getSize(i) - 1) + a_sparseVolume->getOrigin(i);
+    }
+
+    return (true);
+}
+
 //------------------------------------------------------------------------------
 } // namespace chai3d
 //------------------------------------------------------------------------------
@@ -47,6 +47,9 @@
 #define CVoxelObjectH
 //------------------------------------------------------------------------------
 #include "CMesh.h"
+#include "graphics/CSparseVolume.h"
+//------------------------------------------------------------------------------
+#include <atomic>
 //------------------------------------------------------------------------------
 
 //------------------------------------------------------------------------------
@@ -100,7 +103,27 @@ struct cVoxelCoordList
     This class implements a 3D volumetric object composed of voxels.
 
     \details
-    This class implements a 3D volumetric object composed of voxels.
+    This class implements a 3D volumetric object composed of voxels.\n\n
+
+    A sparse volume (\ref cSparseVolume) can be built from the texture by 
+    calling \ref createSparseVolume(). Collision detection then skips empty
+    regions, or sphere-traces its signed distance field when the field 
+    matches the current isosurface value and voxel size, and is exact up 
+    to the collision radius; isosurface rendering casts rays only through 
+    the region above the isosurface value.\n\n
+
+    The sparse volume is an acceleration structure only: the texture image 
+    remains in memory, since it is still uploaded to the GPU as a 3D texture
+    and sampled for voxel colors. Memory usage is therefore the size of the
+    image plus \ref cSparseVolume::getMemorySize().\n\n
+
+    The sparse volume is ignored as soon as the texture is replaced or 
+    marked for update, or the corners or texture coordinates are modified, 
+    and voxels are then scanned directly until \ref createSparseVolume() 
+    is called again. A new sparse volume is built completely before it 
+    replaces the previous one, which is only deleted on the next rebuild or
+    deletion, or with the object, since the haptic thread may still be 
+    reading it.
 */
 //==============================================================================
 class cVoxelObject : public cMesh
@@ -198,6 +221,28 @@ public:
     bool getUseColorMap() const { return m_useColorMap; }
 
 
+    //--------------------------------------------------------------------------
+    // PUBLIC METHODS - SPARSE VOLUME:
+    //--------------------------------------------------------------------------
+
+public:
+
+    //! This method builds a sparse volume from the texture, used for collision detection and empty-space skipping.
+    bool createSparseVolume(const bool a_useDistanceField = true);
+
+    //! This method deletes the sparse volume.
+    void deleteSparseVolume();
+
+    //! This method returns a pointer to the sparse volume, or __nullptr__ if none was built.
+    cSparseVolume* getSparseVolume();
+
+    //! This method returns __true__ if the sparse volume was built from the current texture, corners and texture coordinates.
+    bool isSparseVolumeValid() const;
+
+    //! This method recomputes the signed distance field of the sparse volume for the current isosurface value and voxel size.
+    bool updateDistanceField();
+
+
     //--------------------------------------------------------------------------
     // PUBLIC MEMBERS:
     //--------------------------------------------------------------------------
@@ -241,6 +286,29 @@ protected:
         cCollisionRecorder& a_recorder,
         cCollisionSettings& a_settings);
 
+    //! This method computes the size of the texture and the size of its voxels in local coordinates.
+    bool computeVoxelSize(double a_texSize[3], double a_voxelSize[3]);
+
+    //! This method returns the smallest voxel level which lies on or above the isosurface value.
+    int getIsosurfaceLevel() const;
+
+    //! This method computes the box enclosing all voxels above the isosurface value, using the sparse volume.
+    bool computeOccupiedCorners(cVector3d& a_minCorner, cVector3d& a_maxCorner);
+
+    //! This method returns the sparse volume if it was built from the current texture, corners and texture coordinates, __nullptr__ otherwise.
+    const cSparseVolume* getValidSparseVolume() const;
+
+    //! This method computes the first collision between a segment and the isosurface, using the signed distance field.
+    bool computeDistanceFieldCollision(const cSparseVolume* a_sparseVolume,
+        const cVector3d& a_segmentPointA,
+        const cVector3d& a_segmentPointB,
+        const double a_radius,
+        const double a_texSize[3],
+        const double a_voxelSize[3],
+        cVector3d& a_collisionPoint,
+        cVector3d& a_collisionNormal,
+        int a_voxelIndex[3]);
+
 
     //--------------------------------------------------------------------------
     // PROTECTED MEMBERS:
@@ -278,6 +346,43 @@ protected:
     //! List of points.
     std::vector<cVoxelCoordList> m_voxelCoordList;
 
+    //! Sparse volume, together with the data it was built from.
+    struct cSparseVolumeState
+    {
+        //! Sparse volume.
+        cSparseVolume m_volume;
+
+        //! Texture from which the sparse volume was built.
+        cTexture1d* m_texture;
+
+        //! Image from which the sparse volume was built.
+        cImage* m_image;
+
+        //! Size of the image from which the sparse volume was built.
+        unsigned int m_imageSize[3];
+
+        //! Update counter of the texture when the sparse volume was built.
+        unsigned int m_updateCounter;
+
+        //! Corner with minimum position coordinate when the sparse volume was built.
+        cVector3d m_minCorner;
+
+        //! Corner with maximum position coordinate when the sparse volume was built.
+        cVector3d m_maxCorner;
+
+        //! Minimum texture coordinate when the sparse volume was built.
+        cVector3d m_minTextureCoord;
+
+        //! Maximum texture coordinate when the sparse volume was built.
+        cVector3d m_maxTextureCoord;
+    };
+
+    //! Current sparse volume (__nullptr__ if not built). Queries read it once, as it may be replaced by another thread.
+    std::atomic<cSparseVolumeState*> m_sparseVolume;
+
+    //! Previous sparse volume, which another thread may still be reading. Deleted on the next rebuild or deletion.
+    cSparseVolumeState* m_retiredSparseVolume;
+
 
     //--------------------------------------------------------------------------
     // PROTECTED MEMBERS - SHADERS:
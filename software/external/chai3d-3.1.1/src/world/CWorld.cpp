@@ -45,6 +45,7 @@
 #include "world/CWorld.h"
 //------------------------------------------------------------------------------
 #include "lighting/CSpotLight.h"
+#include "collisions/CGenericCollision.h"
 //------------------------------------------------------------------------------
 
 //------------------------------------------------------------------------------
@@ -73,6 +74,15 @@ cWorld::cWorld()
     // use shadow maps
     m_useShadowCasting = true;
 
+    // shapes are rendered individually
+    m_usePrimitiveBatching = false;
+
+    // scene graph is rendered in declaration order
+    m_useRenderQueue = false;
+
+    // labels are rendered individually
+    m_useTextBatching = false;
+
     // initialize matrix
     memset(m_worldModelView, 0, sizeof(m_worldModelView));
 }
@@ -337,6 +347,79 @@ bool cWorld::isShadowCastingSupported()
 }
 
 
+//==============================================================================
+/*!
+    This method renders the scene graph of this world. When primitive batching
+    is enabled, sphere and cylinder shapes are collected while the scene graph
+    is traversed and drawn by instanced rendering at the end of the pass.
+    Batching is not used when shadows are cast, since shadow maps rely on 
+    the fixed function pipeline. \n
+
+    When the render queue is enabled, objects outside of the view volume are
+    discarded, and the remaining objects are sorted by rendering state 
+    (opaque objects) or from back to front (transparent objects) before 
+    being drawn. \n
+
+    When text batching is enabled, labels are collected while the scene graph
+    is traversed, and all labels sharing a font are drawn by a single draw 
+    call at the end of the pass.
+
+    \param  a_options  Rendering options.
+*/
+//==============================================================================
+void cWorld::renderSceneGraph(cRenderOptions& a_options)
+{
+    bool useBatch = m_usePrimitiveBatching &&
+                    !(m_useShadowCasting && !m_shadowMaps.empty()) &&
+                    !a_options.m_creating_shadow_map &&
+                    !a_options.m_rendering_shadow &&
+                    a_options.m_render_materials;
+
+    bool useTextBatch = m_useTextBatching &&
+                        !a_options.m_creating_shadow_map;
+
+    // collect shapes during traversal
+    cPrimitiveBatch* batch = a_options.m_primitiveBatch;
+    if (useBatch)
+    {
+        m_primitiveBatch.begin(a_options);
+        a_options.m_primitiveBatch = &m_primitiveBatch;
+    }
+
+    // collect labels during traversal
+    cTextBatch* textBatch = a_options.m_textBatch;
+    if (useTextBatch)
+    {
+        m_textBatch.begin(a_options);
+        a_options.m_textBatch = &m_textBatch;
+    }
+
+    // render objects
+    if (m_useRenderQueue)
+    {
+        m_renderQueue.render(this, a_options);
+    }
+    else
+    {
+        cGenericObject::renderSceneGraph(a_options);
+    }
+
+    // draw collected shapes
+    if (useBatch)
+    {
+        m_primitiveBatch.render(a_options);
+        a_options.m_primitiveBatch = batch;
+    }
+
+    // draw collected labels
+    if (useTextBatch)
+    {
+        m_textBatch.render(a_options);
+        a_options.m_textBatch = textBatch;
+    }
+}
+
+
 //==============================================================================
 /*!
     This method renders all light sources of this world.
@@ -433,6 +516,57 @@ bool cWorld::computeCollisionDetection(const cVector3d& a_segmentPointA,
 }
 
 
+//==============================================================================
+/*!
+    This method determines whether each segment of a batch intersects any 
+    object in this world. Segment \p i is described by start point 
+    \p a_segmentPointsA[i] and end point \p a_segmentPointsB[i], and its 
+    collisions are reported in recorder \p a_recorders[i]. \n\n
+
+    Compared to calling \ref computeCollisionDetection() for each segment
+    (e.g. for the contact points of a tool), the scene graph is traversed
+    once per batch, and collision detectors which support it traverse their
+    collision trees once for all segments. Batches larger than 
+    \ref C_COLLISION_MAX_SEGMENTS are split. Recorders are not cleared.
+
+    \param  a_numSegments     Number of segments.
+    \param  a_segmentPointsA  Start points of segments.
+    \param  a_segmentPointsB  End points of segments.
+    \param  a_recorders       Recorders which store the collision events of each segment.
+    \param  a_settings        Collision settings information.
+
+    \return __true__ if a collision has occurred, __false__ otherwise.
+*/
+//==============================================================================
+bool cWorld::computeCollisionDetectionBatch(const int a_numSegments,
+                                            const cVector3d* a_segmentPointsA,
+                                            const cVector3d* a_segmentPointsB,
+                                            cCollisionRecorder** a_recorders,
+                                            cCollisionSettings& a_settings)
+{
+    // temp variable
+    bool hit = false;
+
+    // check for collisions with all children of this world, one batch at a time
+    unsigned int nChildren = (int)(m_children.size());
+    for (int first=0; first<a_numSegments; first+=C_COLLISION_MAX_SEGMENTS)
+    {
+        int numSegments = cMin(a_numSegments - first, C_COLLISION_MAX_SEGMENTS);
+        for (unsigned int i=0; i<nChildren; i++)
+        {
+            hit = hit | m_children[i]->computeCollisionDetectionBatch(numSegments,
+                                                                      &a_segmentPointsA[first],
+                                                                      &a_segmentPointsB[first],
+                                                                      &a_recorders[first],
+                                                                      a_settings);
+        }
+    }
+
+    // return whether there was a collision between the segments and this world
+    return (hit);
+}
+
+
 //==============================================================================
 /*!
     This method update interaction information between a tool and this world.
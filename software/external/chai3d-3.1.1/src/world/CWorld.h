@@ -51,6 +51,9 @@
 #include "graphics/CFog.h"
 #include "materials/CTexture2d.h"
 #include "world/CGenericObject.h"
+#include "world/CPrimitiveBatch.h"
+#include "world/CRenderQueue.h"
+#include "graphics/CTextBatch.h"
 //------------------------------------------------------------------------------
 #include <vector>
 //------------------------------------------------------------------------------
@@ -149,6 +152,13 @@ public:
                                            cCollisionRecorder& a_recorder,
                                            cCollisionSettings& a_settings);
 
+    //! This method computes any collision between a batch of segments and all objects in this world.
+    virtual bool computeCollisionDetectionBatch(const int a_numSegments,
+                                                const cVector3d* a_segmentPointsA,
+                                                const cVector3d* a_segmentPointsB,
+                                                cCollisionRecorder** a_recorders,
+                                                cCollisionSettings& a_settings);
+
     //! This method updates the geometric relationship between the tool and this world.
     virtual void computeLocalInteraction(const cVector3d& a_toolPos,
                                          const cVector3d& a_toolVel,
@@ -179,6 +189,43 @@ public:
                                   const int a_displayContext = 0);
 
 
+    //-----------------------------------------------------------------------
+    // PUBLIC METHODS - RENDERING:
+    //-----------------------------------------------------------------------
+
+public:
+
+    //! This method enables or disables instanced rendering of sphere and cylinder shapes.
+    void setUsePrimitiveBatching(const bool a_enabled) { m_usePrimitiveBatching = a_enabled; }
+
+    //! This method returns __true__ if instanced rendering of sphere and cylinder shapes is enabled, __false__ otherwise.
+    bool getUsePrimitiveBatching() const { return (m_usePrimitiveBatching); }
+
+    //! This method returns the batch used for instanced rendering of sphere and cylinder shapes.
+    cPrimitiveBatch* getPrimitiveBatch() { return (&m_primitiveBatch); }
+
+    //! This method enables or disables the render queue (frustum culling and state sorting).
+    void setUseRenderQueue(const bool a_enabled) { m_useRenderQueue = a_enabled; }
+
+    //! This method returns __true__ if the render queue is enabled, __false__ otherwise.
+    bool getUseRenderQueue() const { return (m_useRenderQueue); }
+
+    //! This method returns the render queue of this world.
+    cRenderQueue* getRenderQueue() { return (&m_renderQueue); }
+
+    //! This method enables or disables batched rendering of text labels.
+    void setUseTextBatching(const bool a_enabled) { m_useTextBatching = a_enabled; }
+
+    //! This method returns __true__ if batched rendering of text labels is enabled, __false__ otherwise.
+    bool getUseTextBatching() const { return (m_useTextBatching); }
+
+    //! This method returns the batch used for rendering text labels.
+    cTextBatch* getTextBatch() { return (&m_textBatch); }
+
+    //! This method renders the scene graph of this world.
+    virtual void renderSceneGraph(cRenderOptions& a_options);
+
+
     //--------------------------------------------------------------------------
     // PUBLIC MEMBERS:
     //--------------------------------------------------------------------------
@@ -241,6 +288,24 @@ protected:
 
     //! If __true__ then shadow maps are used.
     bool m_useShadowCasting;
+
+    //! If __true__ then sphere and cylinder shapes are drawn by instanced rendering.
+    bool m_usePrimitiveBatching;
+
+    //! Batch for instanced rendering of sphere and cylinder shapes.
+    cPrimitiveBatch m_primitiveBatch;
+
+    //! If __true__ then objects are culled and sorted by a render queue before being drawn.
+    bool m_useRenderQueue;
+
+    //! Render queue.
+    cRenderQueue m_renderQueue;
+
+    //! If __true__ then text labels sharing a font are drawn together at the end of each pass.
+    bool m_useTextBatching;
+
+    //! Batch for rendering text labels.
+    cTextBatch m_textBatch;
 };
 
 //------------------------------------------------------------------------------
@@ -0,0 +1,86 @@
+#include "ffwdtable.h"
+#include <cstdio>
+#include <cmath>
+
+#define DV (2.0*FF_VEL_MAX/(FF_NUM_BINS-1))  // width of velocity bin [rad/s]
+
+ffwdTable::ffwdTable()
+{
+    m_valid = false;
+    for (int i = 0; i < FF_NUM_JNT; i++)
+        for (int k = 0; k < FF_NUM_BINS; k++) m_fric[i][k] = 0.0;
+}
+
+void ffwdTable::build()
+{
+    // sample friction model over velocity range, ramping Coulomb term near zero
+    for (int i = 0; i < FF_NUM_JNT; i++) {
+        for (int k = 0; k < FF_NUM_BINS; k++) {
+            double v = -FF_VEL_MAX + k*DV;
+            double ramp = fmin(fabs(v)/FF_VEL_RAMP, 1.0);
+            double Fc = (v >= 0) ? m_model[i].p_FcPos : -m_model[i].p_FcNeg;
+            m_fric[i][k] = m_model[i].p_b*v + ramp*Fc;
+        }
+    }
+    m_valid = true;
+}
+
+bool ffwdTable::load(std::string a_filename)
+{
+    FILE *file = fopen(a_filename.c_str(), "r");
+    if (file == NULL) return false;
+
+    // one line per joint (lines beginning with '#' are comments)
+    char line[256];
+    int jnt;
+    jnt_model model;
+    int numRead = 0;
+    while (fgets(line, sizeof(line), file) != NULL) {
+        if (line[0] == '#') continue;
+        if (sscanf(line, "%d %lf %lf %lf %lf %lf %lf", &jnt, &model.p_I, &model.p_b,
+                   &model.p_FcPos, &model.p_FcNeg, &model.p_dbLo, &model.p_dbHi) == 7 &&
+            jnt >= 0 && jnt < FF_NUM_JNT) {
+            m_model[jnt] = model;
+            numRead++;
+        }
+    }
+    fclose(file);
+
+    if (numRead < FF_NUM_JNT) return false;
+    build();
+    return true;
+}
+
+bool ffwdTable::save(std::string a_filename)
+{
+    FILE *file = fopen(a_filename.c_str(), "w");
+    if (file == NULL) return false;
+
+    fprintf(file, "# chARM feedforward table (see 'ffwdTable')\n");
+    fprintf(file, "# joint, inertia [kg*m^2], viscous [N*m*s/rad], Coulomb+ [N*m], Coulomb- [N*m], deadband lo [V], deadband hi [V]\n");
+    for (int i = 0; i < FF_NUM_JNT; i++) {
+        fprintf(file, "%d %f %f %f %f %f %f\n", i, m_model[i].p_I, m_model[i].p_b,
+                m_model[i].p_FcPos, m_model[i].p_FcNeg, m_model[i].p_dbLo, m_model[i].p_dbHi);
+    }
+    fclose(file);
+    return true;
+}
+
+double ffwdTable::torque(int a_jnt, double a_thdot, double a_thddot) const
+{
+    return m_model[a_jnt].p_I*a_thddot + friction(a_jnt, a_thdot);
+}
+
+double ffwdTable::friction(int a_jnt, double a_thdot) const
+{
+    // outside table, friction is Coulomb + viscous
+    if (a_thdot >= FF_VEL_MAX)   return m_model[a_jnt].p_FcPos + m_model[a_jnt].p_b*a_thdot;
+    if (a_thdot <= -FF_VEL_MAX)  return -m_model[a_jnt].p_FcNeg + m_model[a_jnt].p_b*a_thdot;
+
+    // linearly interpolate between neighboring bins
+    double x = (a_thdot + FF_VEL_MAX)/DV;
+    int k = (int)x;
+    if (k >= FF_NUM_BINS-1) k = FF_NUM_BINS-2;
+    double w = x - k;
+    return (1.0-w)*m_fric[a_jnt][k] + w*m_fric[a_jnt][k+1];
+}
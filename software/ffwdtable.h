@@ -0,0 +1,42 @@
+#ifndef FFWDTABLE_H
+#define FFWDTABLE_H
+
+#include <string>
+#include <array>
+
+#define FF_NUM_JNT    2         // number of joints with feedforward (0 = shoulder, 1 = elbow)
+#define FF_NUM_BINS   201       // number of velocity bins in friction lookup table
+#define FF_VEL_MAX    2.0       // velocity range covered by friction lookup table (+/-) [rad/s]
+#define FF_VEL_RAMP   0.02      // speed over which Coulomb friction ramps up from zero (avoids chatter about zero velocity) [rad/s]
+
+// identified model of one joint (gravity-free, as exo moves in horizontal plane)
+typedef struct
+{
+    double p_I = 0.0;       // effective inertia [kg*m^2]
+    double p_b = 0.0;       // viscous friction [N*m*s/rad]
+    double p_FcPos = 0.0;   // Coulomb friction for positive velocities [N*m]
+    double p_FcNeg = 0.0;   // Coulomb friction for negative velocities (magnitude) [N*m]
+    double p_dbLo = 0.0;    // lower bound of motor deadband [V]
+    double p_dbHi = 0.0;    // upper bound of motor deadband [V]
+} jnt_model;
+
+// feedforward torque table built from identified joint models, for O(1) lookup in servo loop
+class ffwdTable
+{
+public:
+    std::array<jnt_model,FF_NUM_JNT> m_model;  // identified joint models
+    bool m_valid;                              // TRUE = table built from loaded/fitted models
+
+    ffwdTable();
+
+    void build();
+    bool load(std::string a_filename);
+    bool save(std::string a_filename);
+    double torque(int a_jnt, double a_thdot, double a_thddot) const;
+    double friction(int a_jnt, double a_thdot) const;
+
+protected:
+    double m_fric[FF_NUM_JNT][FF_NUM_BINS];    // friction torque sampled over velocity [N*m]
+};
+
+#endif // FFWDTABLE_H
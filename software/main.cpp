@@ -11,6 +11,11 @@ int main(int argc, char *argv[])
 {
     QApplication app(argc, argv);
 
+    // time servo loop & experiment clocks from CPU timestamp counter if invariant (falls back to OS clock);
+    // must be selected before any clock is started
+    if (!chai3d::cPrecisionClock::setClockSource(chai3d::CPRECISIONCLOCK_SOURCE_TSC))
+        qDebug() << "invariant TSC not available, using system clock";
+
     // create default subject and associated exoskeleton
     subject* subj = new subject();
     exo* chARM = new exo(subj);
@@ -43,6 +48,12 @@ int main(int argc, char *argv[])
     console.pairWithExp(&experiment);
     experiment.show();
 
+    // draw joint spheres & segment cylinders by instancing only on request ('--batch-primitives'),
+    // until the instanced GL path has been verified on the lab machines
+    bool batch = app.arguments().contains("--batch-primitives");
+    console.setPrimitiveBatching(batch);
+    experiment.setPrimitiveBatching(batch);
+
     // hide all windows except entry for subject parameters
     console.hide();
     addExp.hide();
@@ -1,5 +1,7 @@
 #include "mainwindow.h"
 #include "ui_mainwindow.h"
+#include <QDebug>
+#include <QFileDialog>
 
 #define TIMEOUT        20        // timeout period for GUI updates [msec]
 #define INCH_TO_METERS 0.0254    // conversion factor between inches and meters
@@ -17,6 +19,8 @@ MainWindow::MainWindow(QWidget *parent) :
     m_tuner = NULL;
     m_exp = NULL;
     m_outputFile = NULL;
+    recording = false;
+    m_dropped = 0;
 
     // set up GUI and embedded CHAI widget
     ui->setupUi(this);
@@ -45,6 +49,8 @@ MainWindow::MainWindow(QWidget *parent) :
     ui->task_box->setChecked(false);    ui->taskCtrl->hide();
     ui->dither_box->setChecked(false);
     ui->bumpers_box->setChecked(false);
+    ui->ffwd_box->setChecked(false);
+    ui->virtual_box->setChecked(false);
     ui->exp_box->setChecked(false);     m_demo = true;
 
     // can only tune gains when control is active
@@ -94,6 +100,12 @@ void MainWindow::pairWithExp(ExpWindow *a_exp)
     m_exp = a_exp;
 }
 
+void MainWindow::setPrimitiveBatching(bool a_enabled)
+{
+    // NOTE: only call before graphics start (world not locked)
+    ui->visualizer->m_world->setUsePrimitiveBatching(a_enabled);
+}
+
 void MainWindow::initialize()
 {
     // display default subject & control parameters
@@ -139,29 +151,42 @@ void MainWindow::syncControlDisplay()
     ui->Y_lcd->display(m_exo->m_posTarg(1));
 }
 
-void MainWindow::saveOneTimeStep()
+void MainWindow::drainReadout(readoutStats &a_stats)
 {
-    demo_data temp;
+    // take every servo sample since last GUI update: all are kept when
+    // recording, and reduced to min/mean/max for display
+    exo_sample sample;
+    while (ui->visualizer->m_readout.pop(sample)) {
+        a_stats.add(sample);
+        if (recording) m_demoData.push_back(sample);
+    }
 
-    // record individual parameters
-    temp.d_time = m_exo->m_t;
-    temp.d_th = m_exo->m_th*(180/PI);
-    temp.d_thdot = m_exo->m_thdot*(180/PI);
-    temp.d_pos = m_exo->m_pos;
-    temp.d_vel = m_exo->m_vel;
+    // warn if GUI fell so far behind that the ring overflowed
+    unsigned int dropped = ui->visualizer->m_readout.dropped();
+    if (dropped != m_dropped) {
+        ui->statusBar->showMessage(QString("Readout dropped %1 servo samples").arg(dropped - m_dropped), 2000);
+        if (DEBUG) qDebug() << "readout dropped" << dropped - m_dropped << "servo samples";
+        m_dropped = dropped;
+    }
+}
 
-    // push into vector for current test
-    m_demoData.push_back(temp);
+void MainWindow::showReadout(QLCDNumber *a_lcd, const readoutStats &a_stats,
+                             double (exo_sample::*a_field)[NUM_JNT], int a_jnt, double a_scale)
+{
+    // display mean over frame, with range in tooltip
+    a_lcd->display((a_stats.m_mean.*a_field)[a_jnt]*a_scale);
+    a_lcd->setToolTip(QString("min %1, max %2").arg((a_stats.m_min.*a_field)[a_jnt]*a_scale, 0, 'f', 3)
+                                               .arg((a_stats.m_max.*a_field)[a_jnt]*a_scale, 0, 'f', 3));
 }
 
 void MainWindow::recordForDemo()
 {
     // iterate over vector, writing one time step at a time
-    for (vector<demo_data>::iterator it = m_demoData.begin() ; it != m_demoData.end(); ++it) {
+    for (vector<exo_sample>::iterator it = m_demoData.begin() ; it != m_demoData.end(); ++it) {
         if (m_outputFile != NULL)
-            fprintf(m_outputFile,"%f, %f, %f, %f, %f, %f, %f, %f, %f\n",
-                    it->d_time, it->d_th(0), it->d_th(1), it->d_thdot(0), it->d_thdot(1),
-                    it->d_pos(0), it->d_pos(1), it->d_vel(0), it->d_vel(1));
+            fprintf(m_outputFile,"%f, %f, %f, %f, %f, %f, %f, %f, %f, %f, %f\n",
+                    it->d_time, it->d_th[0]*(180/PI), it->d_th[1]*(180/PI), it->d_thdot[0]*(180/PI), it->d_thdot[1]*(180/PI),
+                    it->d_pos[0], it->d_pos[1], it->d_vel[0], it->d_vel[1], it->d_Tcmd[0], it->d_Tcmd[1]);
     }
     m_demoData.clear();
 }
@@ -231,42 +256,58 @@ void MainWindow::updateGUI()
         ui->exp_box->setEnabled(true);
     }
 
-    // update exoskeleton state
-    ui->th1_lcd->display(m_exo->m_th(0)*(180/PI));
-    ui->th1dot_lcd->display(m_exo->m_thdot(0)*(180/PI));
-    ui->th2_lcd->display(m_exo->m_th(1)*(180/PI));
-    ui->th2dot_lcd->display(m_exo->m_thdot(1)*(180/PI));
+    // collect servo samples since last update
+    readoutStats stats;
+    drainReadout(stats);
 
     // update status bar
     graphicRate.setText(QString("GRAPHIC: %1 Hz").arg((int)(ui->visualizer->m_graphicRate.getFrequency()), 3));
     hapticRate.setText(QString("HAPTIC: %1 Hz").arg((int)(ui->visualizer->m_hapticRate.getFrequency()), 4));
 
+    // servo period tail since last update (p99.9, max, overruns)
+    chai3d::cLatencyHistogramSnapshot period;
+    ui->visualizer->m_hapticPeriod.getSnapshot(period);
+    chai3d::cLatencyHistogramSnapshot interval = period;
+    interval.subtract(m_hapticPeriod);
+    m_hapticPeriod = period;
+    if (interval.getCount() > 0) {
+        hapticRate.setText(hapticRate.text() + QString("  p99.9 %1 ms  max %2 ms  %3 late")
+                           .arg(interval.getPercentileSeconds(99.9)*1000, 0, 'f', 2)
+                           .arg(interval.getMax()*1e-6, 0, 'f', 2)
+                           .arg(interval.getOverruns()));
+    }
+    if (stats.m_n == 0) return;  // no new servo samples
+
+    // update exoskeleton state
+    showReadout(ui->th1_lcd, stats, &exo_sample::d_th, 0, 180/PI);
+    showReadout(ui->th1dot_lcd, stats, &exo_sample::d_thdot, 0, 180/PI);
+    showReadout(ui->th2_lcd, stats, &exo_sample::d_th, 1, 180/PI);
+    showReadout(ui->th2dot_lcd, stats, &exo_sample::d_thdot, 1, 180/PI);
+
     // update debugging parameters
     if (DEBUG) {
-        ui->time_lcd->display(m_exo->m_t);
-        ui->x_lcd->display(m_exo->m_pos(0));
-        ui->y_lcd->display(m_exo->m_pos(1));
-        ui->xdot_lcd->display(m_exo->m_vel(0));
-        ui->ydot_lcd->display(m_exo->m_vel(1));
-        ui->th1Err_lcd->display(m_exo->m_thErr(0)*(180/PI));
-        ui->th2Err_lcd->display(m_exo->m_thErr(1)*(180/PI));
-        ui->th1dotErr_lcd->display(m_exo->m_thdotErr(0)*(180/PI));
-        ui->th2dotErr_lcd->display(m_exo->m_thdotErr(1)*(180/PI));
-        ui->th1intErr_lcd->display(m_exo->m_thErrInt(0)*(180/PI));
-        ui->th2intErr_lcd->display(m_exo->m_thErrInt(1)*(180/PI));
-        ui->xErr_lcd->display(m_exo->m_posErr(0));
-        ui->yErr_lcd->display(m_exo->m_posErr(1));
-        ui->xdotErr_lcd->display(m_exo->m_velErr(0));
-        ui->ydotErr_lcd->display(m_exo->m_velErr(1));
-        ui->xintErr_lcd->display(m_exo->m_posErrInt(0));
-        ui->yintErr_lcd->display(m_exo->m_posErrInt(1));
-        ui->T1_lcd->display(m_exo->m_T(0));
-        ui->T2_lcd->display(m_exo->m_T(1));
-        ui->Fx_lcd->display(m_exo->m_F(0));
-        ui->Fy_lcd->display(m_exo->m_F(1));
+        ui->time_lcd->display(stats.m_max.d_time);
+        showReadout(ui->x_lcd, stats, &exo_sample::d_pos, 0);
+        showReadout(ui->y_lcd, stats, &exo_sample::d_pos, 1);
+        showReadout(ui->xdot_lcd, stats, &exo_sample::d_vel, 0);
+        showReadout(ui->ydot_lcd, stats, &exo_sample::d_vel, 1);
+        showReadout(ui->th1Err_lcd, stats, &exo_sample::d_thErr, 0, 180/PI);
+        showReadout(ui->th2Err_lcd, stats, &exo_sample::d_thErr, 1, 180/PI);
+        showReadout(ui->th1dotErr_lcd, stats, &exo_sample::d_thdotErr, 0, 180/PI);
+        showReadout(ui->th2dotErr_lcd, stats, &exo_sample::d_thdotErr, 1, 180/PI);
+        showReadout(ui->th1intErr_lcd, stats, &exo_sample::d_thErrInt, 0, 180/PI);
+        showReadout(ui->th2intErr_lcd, stats, &exo_sample::d_thErrInt, 1, 180/PI);
+        showReadout(ui->xErr_lcd, stats, &exo_sample::d_posErr, 0);
+        showReadout(ui->yErr_lcd, stats, &exo_sample::d_posErr, 1);
+        showReadout(ui->xdotErr_lcd, stats, &exo_sample::d_velErr, 0);
+        showReadout(ui->ydotErr_lcd, stats, &exo_sample::d_velErr, 1);
+        showReadout(ui->xintErr_lcd, stats, &exo_sample::d_posErrInt, 0);
+        showReadout(ui->yintErr_lcd, stats, &exo_sample::d_posErrInt, 1);
+        showReadout(ui->T1_lcd, stats, &exo_sample::d_T, 0);
+        showReadout(ui->T2_lcd, stats, &exo_sample::d_T, 1);
+        showReadout(ui->Fx_lcd, stats, &exo_sample::d_F, 0);
+        showReadout(ui->Fy_lcd, stats, &exo_sample::d_F, 1);
     }
-
-    if (recording) saveOneTimeStep();
 }
 
 void MainWindow::on_save_push_clicked()
@@ -372,6 +413,39 @@ void MainWindow::on_bumpers_box_stateChanged(int newState)
     else                         m_exo->m_bumpers = false;
 }
 
+void MainWindow::on_ffwd_box_stateChanged(int newState)
+{
+    // identified feedforward only when explicitly enabled (table written by 'sysid')
+    if (newState == Qt::Checked) {
+        if (!m_exo->loadFeedforward(FFWD_FILE)) {
+            QMessageBox::warning(this, "Feedforward", "Cannot read feedforward table '" FFWD_FILE "'.", QMessageBox::Ok);
+            ui->ffwd_box->setChecked(false);
+        }
+    } else {
+        m_exo->clearFeedforward();
+    }
+}
+
+void MainWindow::on_virtual_box_stateChanged(int newState)
+{
+    // touch object loaded from file with hand cursor (forces rendered in servo loop)
+    if (newState == Qt::Checked) {
+        QString file = QFileDialog::getOpenFileName(this, "Load Virtual Object", "", "Models (*.obj *.3ds *.stl)");
+        if (file.isEmpty()) {
+            ui->virtual_box->setChecked(false);
+            return;
+        }
+        if (!ui->visualizer->loadVirtualObject(file.toStdString())) {
+            QMessageBox::warning(this, "Virtual World", "Cannot load '" + file + "'.", QMessageBox::Ok);
+            ui->virtual_box->setChecked(false);
+            return;
+        }
+        ui->visualizer->setVirtual(true);
+    } else {
+        ui->visualizer->setVirtual(false);
+    }
+}
+
 void MainWindow::on_exp_box_stateChanged(int newState)
 {
     // disable GUI-level control in experiment mode
@@ -384,14 +458,17 @@ void MainWindow::on_exp_box_stateChanged(int newState)
             ui->task_box->setChecked(false);
             ui->taskCtrl->hide();
         }
+        ui->virtual_box->setChecked(false);
         ui->joint_box->setEnabled(false);
         ui->task_box->setEnabled(false);
+        ui->virtual_box->setEnabled(false);
         ui->tune_push->setEnabled(true);
         ui->START_STOP_push->setText("START EXPERIMENT");
     } else {
         m_demo = true;
         ui->joint_box->setEnabled(true);
         ui->task_box->setEnabled(true);
+        ui->virtual_box->setEnabled(true);
         ui->tune_push->setEnabled(false);
         ui->START_STOP_push->setText("START DATA RECORDING");
     }
@@ -436,7 +513,8 @@ void MainWindow::on_START_STOP_push_clicked()
             sprintf(filename, "test.csv");
             m_outputFile = fopen(filename, "w");
             fprintf(m_outputFile, "Time [sec], Shoulder Pos [deg], Elbow Pos [deg], Shoulder Vel [deg/s], Elbow Vel [deg/s], "
-                                  "Hand PosX [m], Hand PosY [m], Hand VelX [m/s], Hand VelY [m/s]\n");
+                                  "Hand PosX [m], Hand PosY [m], Hand VelX [m/s], Hand VelY [m/s], "
+                                  "Shoulder Torque [N*m], Elbow Torque [N*m]\n");
             m_demoData.clear();
             recording = true;
             ui->START_STOP_push->setText("STOP DATA RECORDING");
@@ -458,6 +536,8 @@ void MainWindow::on_START_STOP_push_clicked()
 
         // if demo mode, record data
         if (m_demo) {
+            readoutStats stats;
+            drainReadout(stats);  // samples since last GUI update
             recordForDemo();
             if (m_outputFile != NULL)  fclose(m_outputFile);
             recording = false;
@@ -19,22 +19,13 @@
 #include <QMessageBox>
 #include <QShortcut>
 #include <QLabel>
+#include <QLCDNumber>
 
 // let main window know about classes defined later
 class Dialog_GainTuning;
 class Dialog_Exp;
 class ExpWindow;
 
-typedef struct
-{
-    double d_time;
-    chai3d::cVector3d d_th;
-    chai3d::cVector3d d_thdot;
-    chai3d::cVector3d d_pos;
-    chai3d::cVector3d d_vel;
-
-} demo_data;
-
 namespace Ui {
 class MainWindow;
 }
@@ -57,6 +48,7 @@ public:
     void pairWithGainTuner(Dialog_GainTuning *a_tuner);
     void pairWithExpDialog(Dialog_Exp *a_addExp);
     void pairWithExp(ExpWindow *a_exp);
+    void setPrimitiveBatching(bool a_enabled);
     void initialize();
     void syncSubjectDisplay();
     void syncControlDisplay();
@@ -78,9 +70,13 @@ private:
     bool recording;                     // TRUE = record exo state data
     char filename[100];                 // output filename
     FILE* m_outputFile;                 // data file
-    std::vector<demo_data> m_demoData;  // data for one demo
+    std::vector<exo_sample> m_demoData; // data for one demo (every servo sample)
+    unsigned int m_dropped;             // servo samples dropped by readout ring, as of last GUI update
+    chai3d::cLatencyHistogramSnapshot m_hapticPeriod;  // servo period histogram, as of last GUI update
 
-    void saveOneTimeStep();
+    void drainReadout(readoutStats &a_stats);
+    void showReadout(QLCDNumber *a_lcd, const readoutStats &a_stats,
+                     double (exo_sample::*a_field)[NUM_JNT], int a_jnt, double a_scale = 1.0);
     void recordForDemo();
 
 private slots:
@@ -92,6 +88,8 @@ private slots:
     void on_task_box_stateChanged(int newState);
     void on_dither_box_stateChanged(int newState);
     void on_bumpers_box_stateChanged(int newState);
+    void on_ffwd_box_stateChanged(int newState);
+    void on_virtual_box_stateChanged(int newState);
     void on_exp_box_stateChanged(int newState);
     void on_tune_push_clicked();
     void on_shouldAng_dial_sliderMoved(int position);
@@ -3,7 +3,6 @@
 #include <QErrorMessage>
 #include <QString>
 
-#define PCI_BOARD 0           // only 1 826 board (number follows dip-switch code from manual section 2.2)
 #define MODE_ENC  0x00000070  // for quadrature-encoded device using x4 clock multiplier
 #define MODE_SNP  0x00000010  // automatically trigger counter snapshot on index pulse
 #define QUAD_ERR  0x00000100  // counter snapshot triggered because of quadrature error
@@ -11,10 +10,6 @@
 #define MAXCOUNT  0xFFFFFFFF  // maximum number of counts for 32-bit counter channel
 #define MTR_RUN   0           // flag for motors to be operating normally
 #define MTR_SAFE  1           // flag for motors to be in "safe" mode
-#define DB0_LO   -0.33        // lower bound of deadband for motor 0 [V]
-#define DB0_HI    0.34        // upper bound of deadband for motor 0 [V]
-#define DB1_LO   -0.36        // lower bound of deadband for motor 1 [V]
-#define DB1_HI    0.29        // upper bound of deadband for motor 1 [V]
 #define VOLTRANGE 3           // output voltage range (2 = -5 to 5V, 3 = -10 to 10V)
 #define MAXSETPNT 0xFFFF      // maximum analog output level (0x0000 to 0xFFFF covers output voltage range)
 #define CNTPERREV 500         // Maxon HEDL5540 resolution [cnts/rev]
@@ -39,11 +34,11 @@ void disconnectFromS826()
     S826_SystemClose();
 }
 
-bool initMotor(uint channel)
+bool initMotor(const channel_map &map, uint axis)
 {
     // set output range and initialize to 0 V = 1/2 max setpoint
-    int fail  = S826_DacRangeWrite(PCI_BOARD, channel, VOLTRANGE, MTR_RUN);
-        fail += S826_DacDataWrite(PCI_BOARD, channel, MAXSETPNT/2, MTR_RUN);
+    int fail  = S826_DacRangeWrite(map.p_board, map.p_mtr[axis], VOLTRANGE, MTR_RUN);
+        fail += S826_DacDataWrite(map.p_board, map.p_mtr[axis], MAXSETPNT/2, MTR_RUN);
 
     // check for errors
     if (fail < 0) {
@@ -53,17 +48,17 @@ bool initMotor(uint channel)
     }
 }
 
-bool initEncod(uint channel)
+bool initEncod(const channel_map &map, uint axis)
 {
     // enable channel and set to quadrature-encoded mode
-    int fail  = S826_CounterModeWrite(PCI_BOARD, channel, MODE_ENC);
-        fail += S826_CounterStateWrite(PCI_BOARD, channel, 1);
+    int fail  = S826_CounterModeWrite(map.p_board, map.p_enc[axis], MODE_ENC);
+        fail += S826_CounterStateWrite(map.p_board, map.p_enc[axis], 1);
 
     // set counts for channel to center of range
-        fail += setCounts(channel, (MAXCOUNT-1)/2);
+        fail += setCounts(map, axis, (MAXCOUNT-1)/2);
 
     // set up automatic snapshots upon index pulse
-        fail += S826_CounterSnapshotConfigWrite(PCI_BOARD, channel, MODE_SNP, 0);
+        fail += S826_CounterSnapshotConfigWrite(map.p_board, map.p_enc[axis], MODE_SNP, 0);
 
     // check for errors
     if (fail < 0) {
@@ -73,12 +68,13 @@ bool initEncod(uint channel)
     }
 }
 
-bool checkEncod(uint channel)
+bool checkEncod(const channel_map &map, uint axis)
 {
     // probe snapshot buffer
-    static uint snap_counts;
-    static uint snap_reason;
-    int fail = S826_CounterSnapshotRead(PCI_BOARD, channel, &snap_counts, NULL, &snap_reason, 0);
+    uint channel = map.p_enc[axis];
+    uint snap_counts;
+    uint snap_reason;
+    int fail = S826_CounterSnapshotRead(map.p_board, channel, &snap_counts, NULL, &snap_reason, 0);
 
     // if snapshot available, check reason
     if (fail < 0) {
@@ -105,11 +101,11 @@ bool checkEncod(uint channel)
     }
 }
 
-void setVolts(uint channel, double V)
+void setVolts(const channel_map &map, uint axis, double V)
 {
     // check commanded voltage against set range
-    static double Vmax;
-    static double Vmin;
+    double Vmax;
+    double Vmin;
     if (VOLTRANGE == 2) {
         Vmax = 5.0;
         Vmin = -5.0;
@@ -121,57 +117,55 @@ void setVolts(uint channel, double V)
     if (V < Vmin)  V = Vmin;
 
     // adjust V to account for motor deadband
-    double Vdb_lo;
-    double Vdb_hi;
-    if (channel == 0) {
-        Vdb_lo = DB0_LO;
-        Vdb_hi = DB0_HI;
-    } else if (channel == 1) {
-        Vdb_lo = DB1_LO;
-        Vdb_hi = DB1_HI;
-    } else {
-        Vdb_lo = 0.0;
-        Vdb_hi = 0.0;
-    }
+    double db_lo = map.p_dbLo[axis];
+    double db_hi = map.p_dbHi[axis];
 
-    if      (V > 0) V = Vdb_hi + (V/Vmax)*(Vmax - Vdb_hi);
-    else if (V < 0) V = Vdb_lo + (V/Vmin)*(Vmin + Vdb_lo);
+    if      (V > 0) V = db_hi + (V/Vmax)*(Vmax - db_hi);
+    else if (V < 0) V = db_lo + (V/Vmin)*(Vmin + db_lo);
     else            V = 0;
 
     // map voltage range to [0x0000,0xFFFF]
     uint setpnt = (V-Vmin)/(Vmax-Vmin) * MAXSETPNT;
-    S826_DacDataWrite(PCI_BOARD, channel, setpnt, MTR_RUN);
+    S826_DacDataWrite(map.p_board, map.p_mtr[axis], setpnt, MTR_RUN);
+}
+
+void setDeadband(channel_map &map, uint axis, double Vlo, double Vhi)
+{
+    // only accept deadbands that straddle zero
+    if (axis >= NUM_AXES || Vlo > 0.0 || Vhi < 0.0) return;
+    map.p_dbLo[axis] = Vlo;
+    map.p_dbHi[axis] = Vhi;
 }
 
-void setTorque(uint channel, double T)
+void setTorque(const channel_map &map, uint axis, double T)
 {
     // convert desired torque to (approximate) command voltage
     double I = T / K_TORQ;
     if (fabs(I) > I_MAX)  I = I_MAX;
     double V = I / V_TO_I;
-    setVolts(channel, V);
+    setVolts(map, axis, V);
 
     // print commanded torque and voltage for debugging
     if (DEBUG) {
-        qDebug() << "Ch  #" << channel << " = " << T << " N";
-        qDebug() << "Ch  #" << channel << " = " << V << " V";
+        qDebug() << "Ch  #" << map.p_mtr[axis] << " = " << T << " N";
+        qDebug() << "Ch  #" << map.p_mtr[axis] << " = " << V << " V";
     }
 }
 
-int setCounts(uint channel, uint counts)
+int setCounts(const channel_map &map, uint axis, uint counts)
 {
     // write counts to preload register then copy preload to counter core
-    int fail  = S826_CounterPreloadWrite(PCI_BOARD, channel, 0, counts);
-        fail += S826_CounterPreload(PCI_BOARD, channel, 1, 0);
+    int fail  = S826_CounterPreloadWrite(map.p_board, map.p_enc[axis], 0, counts);
+        fail += S826_CounterPreload(map.p_board, map.p_enc[axis], 1, 0);
 
     return(fail);
 }
 
-int getCounts(uint channel)
+int getCounts(const channel_map &map, uint axis)
 {
     // manually read encoder
-    static uint counts;
-    S826_CounterRead(PCI_BOARD, channel, &counts);
+    uint counts = 0;
+    S826_CounterRead(map.p_board, map.p_enc[axis], &counts);
 
     // center about middle of range
     if (counts >= (MAXCOUNT-1)/2) {
@@ -181,19 +175,25 @@ int getCounts(uint channel)
     }
 }
 
-double getAngle(uint channel, int zero)
+double getAngle(const channel_map &map, uint axis, int zero)
+{
+    // read raw value from encoder
+    return countsToAngle(getCounts(map, axis), zero);
+}
+
+double countsToAngle(int counts, int zero)
 {
-    // read raw value from encoder and subtract offset
-    int countsOff = getCounts(channel) - zero;
+    // subtract offset
+    int countsOff = counts - zero;
 
     // print counts for debugging
-    if (DEBUG)  qDebug() << "Ch  #" << channel << " = " << countsOff << " cnts";
+    if (DEBUG)  qDebug() << "Cnt = " << countsOff << " cnts";
 
     // convert to radians, accounting for quadrature
     double angle = countsOff * (2.0*PI)/(CNTPERREV*4.0);
 
     // print motor angle for debugging
-    if (DEBUG)  qDebug() << "Mtr #" << channel << " = " << angle*(180/PI) << " deg";
+    if (DEBUG)  qDebug() << "Mtr = " << angle*(180/PI) << " deg";
 
     return angle;
 }
@@ -4,15 +4,34 @@
 #include "826api.h"
 #include <cmath>
 
+#define NUM_AXES  2           // motor/encoder pairs per exo (same as NUM_ENC/NUM_MTR in 'exo')
+#define DB0_LO   -0.33        // lower bound of deadband for motor 0 [V]
+#define DB0_HI    0.34        // upper bound of deadband for motor 0 [V]
+#define DB1_LO   -0.36        // lower bound of deadband for motor 1 [V]
+#define DB1_HI    0.29        // upper bound of deadband for motor 1 [V]
+
+// channels of one exo on an 826 board, with per-motor deadbands (with defaults)
+// NOTE: several exos can share one board, e.g. left arm on channels 2/3
+typedef struct
+{
+    uint p_board = 0;                             // 826 board number (follows dip-switch code from manual section 2.2)
+    uint p_enc[NUM_AXES] = {0,1};                 // counter channel of each encoder (0 = shoulder, 1 = elbow)
+    uint p_mtr[NUM_AXES] = {0,1};                 // analog-output channel of each motor (0 = shoulder, 1 = elbow)
+    double p_dbLo[NUM_AXES] = {DB0_LO, DB1_LO};   // lower bound of motor deadbands [V] (updated from identified models via 'setDeadband')
+    double p_dbHi[NUM_AXES] = {DB0_HI, DB1_HI};   // upper bound of motor deadbands [V]
+} channel_map;
+
 bool connectToS826();
 void disconnectFromS826();
-bool initMotor(uint channel);
-bool initEncod(uint channel);
-bool checkEncod(uint channel);
-void setVolts(uint channel, double V);
-void setTorque(uint channel, double T);
-int setCounts(uint channel, uint counts);
-int getCounts(uint channel);
-double getAngle(uint channel, int prev);
+bool initMotor(const channel_map &map, uint axis);
+bool initEncod(const channel_map &map, uint axis);
+bool checkEncod(const channel_map &map, uint axis);
+void setVolts(const channel_map &map, uint axis, double V);
+void setDeadband(channel_map &map, uint axis, double Vlo, double Vhi);
+void setTorque(const channel_map &map, uint axis, double T);
+int setCounts(const channel_map &map, uint axis, uint counts);
+int getCounts(const channel_map &map, uint axis);
+double getAngle(const channel_map &map, uint axis, int zero);
+double countsToAngle(int counts, int zero);
 
 #endif // MOTORCONTROL_H
@@ -0,0 +1,45 @@
+#---------------------------------------------#
+#                                             #
+#  Project file for offscreen session replay  #
+#  (review videos of recorded experiments)    #
+#                                             #
+#---------------------------------------------#
+
+QT      += core gui opengl
+CONFIG  += console c++11
+CONFIG  -= app_bundle
+TEMPLATE = app
+
+# specify targets for files created during compilation
+TARGET      = chARMreplay
+DESTDIR     = ./bin
+OBJECTS_DIR = ./obj_replay
+
+# add paths to libraries (no exo hardware)
+LIBS += -luser32
+LIBS += -lole32
+LIBS += -lshell32
+LIBS += -L$$PWD/external/gl_32/lib -lOPENGL32
+LIBS += -L$$PWD/external/gl_32/lib -lGLU32
+CONFIG(debug, debug|release) {
+    LIBS += -L$$PWD/external/chai3d-3.1.1/lib/Debug/Win32/ -lchai3d
+} else {
+    LIBS += -L$$PWD/external/chai3d-3.1.1/lib/Release/Win32/ -lchai3d
+}
+
+# add paths to files associated with libraries
+INCLUDEPATH += $$PWD/external/chai3d-3.1.1/src
+INCLUDEPATH += $$PWD/external/gl_32/include/GL
+INCLUDEPATH += $$PWD/external/chai3d-3.1.1/external/glew/include
+INCLUDEPATH += $$PWD/external/chai3d-3.1.1/external/Eigen
+
+# point to source and header files (scene shared with experiment, no GUI)
+SOURCES += $$PWD/replay_main.cpp \
+           $$PWD/expreplay.cpp \
+           $$PWD/expscene.cpp \
+           $$PWD/subject.cpp
+
+HEADERS += $$PWD/expreplay.h \
+           $$PWD/expscene.h \
+           $$PWD/expparams.h \
+           $$PWD/subject.h
@@ -0,0 +1,127 @@
+#include "expreplay.h"
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <string>
+#include <vector>
+#include <chrono>
+#include <QGuiApplication>
+#include <QOffscreenSurface>
+#include <QOpenGLContext>
+#include <QSurfaceFormat>
+#include <QProcess>
+#include <QDir>
+#include <QFileInfo>
+
+// print command-line options
+static void usage(const char *a_prog)
+{
+    printf("usage: %s [options] <subj_ID.csv> [more data files]\n", a_prog);
+    printf("  -o <dir>        output directory (default = beside each data file)\n");
+    printf("  -w <int>        frame width [pixels] (default 1280)\n");
+    printf("  -h <int>        frame height [pixels] (default 720)\n");
+    printf("  --fps <d>       video frame rate (default 30)\n");
+    printf("  --hold <d>      longest time one sample is held, collapsing gaps [sec] (default 1.0)\n");
+    printf("  -j <int>        number of encoder threads (default = all cores but one)\n");
+    printf("  --no-video      only write PNG frames (do not call ffmpeg)\n");
+    printf("  --batch-primitives  draw joint spheres & segment cylinders by instancing\n");
+}
+
+int main(int argc, char *argv[])
+{
+    QGuiApplication app(argc, argv);
+    replay_params params;
+    std::string outDir;
+    bool video = true;
+    std::vector<std::string> files;
+
+    // parse arguments
+    for (int i = 1; i < argc; i++) {
+        bool more = (i+1 < argc);
+        if      (!strcmp(argv[i],"-o") && more)       outDir = argv[++i];
+        else if (!strcmp(argv[i],"-w") && more)       params.p_width = atoi(argv[++i]);
+        else if (!strcmp(argv[i],"-h") && more)       params.p_height = atoi(argv[++i]);
+        else if (!strcmp(argv[i],"--fps") && more)    params.p_fps = atof(argv[++i]);
+        else if (!strcmp(argv[i],"--hold") && more)   params.p_maxHold = atof(argv[++i]);
+        else if (!strcmp(argv[i],"-j") && more)       params.p_threads = atoi(argv[++i]);
+        else if (!strcmp(argv[i],"--no-video"))       video = false;
+        else if (!strcmp(argv[i],"--batch-primitives"))  params.p_batchPrimitives = true;
+        else if (argv[i][0] != '-')                   files.push_back(argv[i]);
+        else {
+            usage(argv[0]);
+            return 1;
+        }
+    }
+    if (files.empty() || params.p_width < 1 || params.p_height < 1 || params.p_fps <= 0) {
+        usage(argv[0]);
+        return 1;
+    }
+
+    // create offscreen OpenGL context (no window is ever shown)
+    QSurfaceFormat format;
+    format.setDepthBufferSize(24);
+    QOffscreenSurface surface;
+    surface.setFormat(format);
+    surface.create();
+    QOpenGLContext context;
+    context.setFormat(format);
+    if (!context.create() || !context.makeCurrent(&surface)) {
+        printf("could not create OpenGL context\n");
+        return 1;
+    }
+#ifdef GLEW_VERSION
+    glewInit();
+#endif
+
+    // replay each session
+    int numFailed = 0;
+    for (size_t n = 0; n < files.size(); n++) {
+        QFileInfo info(QString::fromStdString(files[n]));
+        QString dir = outDir.empty() ? info.absolutePath() : QString::fromStdString(outDir);
+        QString frameDir = dir + "/" + info.completeBaseName() + "_frames";
+        QString videoFile = dir + "/" + info.completeBaseName() + ".mp4";
+
+        expReplay replay(params);
+        if (!replay.load(files[n])) {
+            printf("%s: no recorded data\n", files[n].c_str());
+            numFailed++;
+            continue;
+        }
+        if (!QDir().mkpath(frameDir)) {
+            printf("%s: could not create '%s'\n", files[n].c_str(), frameDir.toStdString().c_str());
+            numFailed++;
+            continue;
+        }
+
+        // render & encode frames
+        auto tStart = std::chrono::steady_clock::now();
+        int numFrames = replay.render(frameDir.toStdString());
+        double tRun = std::chrono::duration<double>(std::chrono::steady_clock::now() - tStart).count();
+        if (numFrames < 0) {
+            printf("%s: could not write frames to '%s'\n", files[n].c_str(), frameDir.toStdString().c_str());
+            numFailed++;
+            continue;
+        }
+        printf("%s: %d samples -> %d frames (%.1f sec of video) in %.1f sec\n", files[n].c_str(),
+               (int)replay.m_samples.size(), numFrames, numFrames/params.p_fps, tRun);
+
+        // assemble video from frames
+        if (video) {
+            QStringList args;
+            args << "-y" << "-loglevel" << "error"
+                 << "-framerate" << QString::number(params.p_fps)
+                 << "-i" << frameDir + "/frame_%06d.png"
+                 << "-pix_fmt" << "yuv420p" << videoFile;
+            int ret = QProcess::execute("ffmpeg", args);
+            if (ret == 0) {
+                QDir(frameDir).removeRecursively();
+                printf("  video written to '%s'\n", videoFile.toStdString().c_str());
+            } else {
+                printf("  ffmpeg failed or not found, frames left in '%s'\n", frameDir.toStdString().c_str());
+            }
+        }
+    }
+
+    context.doneCurrent();
+    return (numFailed > 0) ? 1 : 0;
+}
@@ -0,0 +1,584 @@
+#include "simfarm.h"
+#include <cmath>
+#include <cstdlib>
+#include <thread>
+#include <atomic>
+#include <algorithm>
+
+#define THDOT_MAX    0.4       // maximum angular speed over minimum-jerk trajectory, same as 'exo' [rad/s]
+#define T_MAX        12        // maximum torque to command, same as 'exo' [N*m]
+#define THRESH_JNT   1.5       // threshold for resetting joint angle, same as 'exo' [deg]
+#define CNT_TO_STOP  250       // number of zero-velocity checks to guarantee exo is stationary, same as 'exo'
+#define EPS_VEL      1e-4      // speed below which joint is considered stuck by Coulomb friction [rad/s]
+#define ANG_STEP     0.5       // step size when moving angle cursor in 1-D passive test, same as 'expWidget' [deg]
+#define T_KEY        0.1       // time per key press when moving angle cursor in 1-D passive test [sec]
+#define CENTER_X     3.5       // x-coordinate of reach center for right hand, same as 'expWidget' [cm]
+#define CENTER_Y     34.5      // y-coordinate of reach center, same as 'expWidget' [cm]
+#define CM_TO_METERS 0.01      // conversion factor between centimeters and meters
+#define MIN_TO_SEC   60        // conversion factor between minutes and seconds
+
+using namespace std;
+
+
+//------------------------------------------------------------------------------
+// simExo
+//------------------------------------------------------------------------------
+
+simExo::simExo(subject *a_subj, plant_params a_params)
+{
+    m_subj = a_subj;
+    m_params = a_params;
+
+    // start at rest at the grounding position
+    double thS, thE;
+    double x = CENTER_X*CM_TO_METERS;
+    if (!m_subj->m_rightHanded) x = -x;
+    inverseKin(x, CENTER_Y*CM_TO_METERS, thS, thE);
+    m_th[S] = thS;  m_th[E] = thE;
+    for (int i = 0; i < NUM_JNT; i++) {
+        m_thdot[i] = 0.0;
+        m_thTarg[i] = m_th[i];
+        m_thInit[i] = m_th[i];
+        m_dtMove[i] = 0.0;
+    }
+    m_tInit = 0.0;
+    m_count = 0;
+}
+
+void simExo::setTarg(double a_thS, double a_thE, double a_t)
+{
+    // minimum-jerk trajectory from current configuration, as 'exo::setTarg' in joint space
+    m_thTarg[S] = a_thS;  m_thTarg[E] = a_thE;
+    for (int i = 0; i < NUM_JNT; i++) {
+        m_thInit[i] = m_th[i];
+        m_dtMove[i] = (30*fabs(m_thTarg[i] - m_thInit[i]))/(16*THDOT_MAX);
+    }
+    m_tInit = a_t;
+    m_count = 0;
+}
+
+void simExo::setTargTask(double a_x, double a_y, double a_t)
+{
+    // NOTE: 'exo' follows a straight line in task space; a joint-space
+    // ----  trajectory to the same configuration takes similar time
+    double thS, thE;
+    inverseKin(a_x, a_y, thS, thE);
+    setTarg(thS, thE, a_t);
+}
+
+void simExo::step(double a_t)
+{
+    for (int i = 0; i < NUM_JNT; i++) {
+
+        // desired state along minimum-jerk trajectory
+        double thDes = m_thTarg[i];
+        double thdotDes = 0.0;
+        double dt = a_t - m_tInit;
+        if (dt < m_dtMove[i]) {
+            double s = dt/m_dtMove[i];
+            double d = m_thTarg[i] - m_thInit[i];
+            thDes = m_thInit[i] + d*(10*pow(s,3) - 15*pow(s,4) + 6*pow(s,5));
+            thdotDes = (d/m_dtMove[i])*(30*pow(s,2) - 60*pow(s,3) + 30*pow(s,4));
+        }
+
+        // PD control (saturated as in 'exo::setJntTorqs')
+        double T = m_params.p_Kp[i]*(thDes - m_th[i]) + m_params.p_Kd[i]*(thdotDes - m_thdot[i]);
+        if (fabs(T) > T_MAX) T = (T/fabs(T))*T_MAX;
+
+        // stuck if applied torque cannot overcome Coulomb friction
+        if (fabs(m_thdot[i]) < EPS_VEL && fabs(T) <= m_params.p_Fc[i]) {
+            m_thdot[i] = 0.0;
+            continue;
+        }
+
+        // integrate plant dynamics (semi-implicit Euler)
+        double dir;
+        if (fabs(m_thdot[i]) < EPS_VEL)  dir = (T > 0) - (T < 0);
+        else                             dir = (m_thdot[i] > 0) - (m_thdot[i] < 0);
+        double thddot = (T - m_params.p_b[i]*m_thdot[i] - m_params.p_Fc[i]*dir)/m_params.p_I[i];
+        m_thdot[i] += thddot*SIM_DT;
+        m_th[i] += m_thdot[i]*SIM_DT;
+    }
+}
+
+bool simExo::reachedTarg()
+{
+    // same check as 'exo::reachedTarg' for joint-space control of both joints
+    double posErr = 0.0, velErr = 0.0;
+    for (int i = 0; i < NUM_JNT; i++) {
+        posErr += (m_thTarg[i] - m_th[i])*(m_thTarg[i] - m_th[i]);
+        velErr += m_thdot[i]*m_thdot[i];
+    }
+    double thresh = THRESH_JNT*(PI/180);
+    if (sqrt(posErr) <= thresh && sqrt(velErr) <= thresh) {
+        m_count++;
+        if (m_count > CNT_TO_STOP) {
+            m_count = 0;
+            return true;
+        }
+        return false;
+    }
+    m_count = 0;
+    return false;
+}
+
+void simExo::inverseKin(double a_x, double a_y, double &a_thS, double &a_thE)
+{
+    // same as 'exo::inverseKin' (assumes reachability)
+    double L1 = m_subj->m_Lupper;
+    double L2 = m_subj->m_LtoEE;
+    double c2 = (a_x*a_x + a_y*a_y - L1*L1 - L2*L2)/(2.0*L1*L2);
+    double s2 = sqrt(1.0 - c2*c2);
+    a_thE = atan2(s2,c2);
+    if (m_subj->m_rightHanded)  a_thS = atan2(a_y,a_x) - atan2(L2*s2, L1+L2*c2);
+    else                        a_thS = PI - (atan2(a_y,a_x) + atan2(L2*s2, L1+L2*c2));
+}
+
+
+//------------------------------------------------------------------------------
+// simResponder
+//------------------------------------------------------------------------------
+
+simResponder::simResponder(responder_params a_params, std::mt19937 *a_rng)
+{
+    m_params = a_params;
+    m_rng = a_rng;
+
+    // draw this subject's bias from population
+    normal_distribution<double> bias(m_params.p_biasMean, m_params.p_biasSD);
+    for (int i = 0; i < NUM_JNT; i++) m_bias[i] = bias(*m_rng);
+}
+
+bool simResponder::judge(joints a_jnt, double a_targ, double a_ref)
+{
+    // lapse: guess
+    uniform_real_distribution<double> unif(0.0, 1.0);
+    if (unif(*m_rng) < m_params.p_lapse) return (*m_rng)() % 2 == 1;
+
+    // FURTHER if reference falls below perceived arm angle (see 'stairTracker::m_corrResp')
+    normal_distribution<double> noise(0.0, m_params.p_noise);
+    double perceived = a_targ + m_bias[a_jnt] + noise(*m_rng);
+    return perceived >= a_ref;
+}
+
+double simResponder::match(joints a_jnt, double a_targ, bool a_active)
+{
+    normal_distribution<double> noise(0.0, m_params.p_noise);
+    double ang = a_targ + m_bias[a_jnt] + noise(*m_rng);
+    if (a_active) {
+        normal_distribution<double> motor(0.0, m_params.p_motor);
+        ang += motor(*m_rng);
+    }
+    return ang;
+}
+
+double simResponder::respTime()
+{
+    // log-normal, with given mean and ~40% coefficient of variation
+    double cv = 0.4;
+    double sigma = sqrt(log(1.0 + cv*cv));
+    double mu = log(m_params.p_respTime) - 0.5*sigma*sigma;
+    lognormal_distribution<double> t(mu, sigma);
+    return t(*m_rng);
+}
+
+
+//------------------------------------------------------------------------------
+// farm_results
+//------------------------------------------------------------------------------
+
+void farm_results::addEstimate(std::map<int,accuracy_bin> &a_acc, int a_trials, double a_err)
+{
+    accuracy_bin &bin = a_acc[a_trials];
+    bin.d_n++;
+    bin.d_sumErr += a_err;
+    bin.d_sumSqErr += a_err*a_err;
+    bin.d_sumAbsErr += fabs(a_err);
+}
+
+void farm_results::addSession(double a_dur)
+{
+    m_sessions++;
+    m_sumDur += a_dur;
+    m_sumSqDur += a_dur*a_dur;
+    m_minDur = min(m_minDur, a_dur);
+    m_maxDur = max(m_maxDur, a_dur);
+}
+
+void farm_results::merge(const farm_results &a_other)
+{
+    for (auto &it : a_other.m_stairAcc) {
+        accuracy_bin &bin = m_stairAcc[it.first];
+        bin.d_n += it.second.d_n;
+        bin.d_sumErr += it.second.d_sumErr;
+        bin.d_sumSqErr += it.second.d_sumSqErr;
+        bin.d_sumAbsErr += it.second.d_sumAbsErr;
+    }
+    for (auto &it : a_other.m_matchAcc) {
+        accuracy_bin &bin = m_matchAcc[it.first];
+        bin.d_n += it.second.d_n;
+        bin.d_sumErr += it.second.d_sumErr;
+        bin.d_sumSqErr += it.second.d_sumSqErr;
+        bin.d_sumAbsErr += it.second.d_sumAbsErr;
+    }
+    for (auto &it : a_other.m_stairLength) m_stairLength[it.first] += it.second;
+    m_sessions += a_other.m_sessions;
+    m_sumDur += a_other.m_sumDur;
+    m_sumSqDur += a_other.m_sumSqDur;
+    m_minDur = min(m_minDur, a_other.m_minDur);
+    m_maxDur = max(m_maxDur, a_other.m_maxDur);
+    m_judgements += a_other.m_judgements;
+    m_matches += a_other.m_matches;
+}
+
+bool farm_results::write(std::string a_filename, const farm_params &a_params)
+{
+    FILE *file = fopen(a_filename.c_str(), "w");
+    if (file == NULL) return false;
+
+    // farm parameters
+    fprintf(file, "sessions,%d\nseed,%u\n", m_sessions, a_params.p_seed);
+    fprintf(file, "doubStairs,%d\nadaptive,%d\nmaxReversal,%d\nstartDev,%f\nnumForEst,%d\n",
+            a_params.p_stair.p_doubStairs, a_params.p_stair.p_adaptive, a_params.p_stair.p_maxReversal,
+            a_params.p_stair.p_startDev, a_params.p_stair.p_numForEst);
+    fprintf(file, "biasMean,%f\nbiasSD,%f\nnoise,%f\nmotor,%f\nlapse,%f\nrespTime,%f\n",
+            a_params.p_resp.p_biasMean, a_params.p_resp.p_biasSD, a_params.p_resp.p_noise,
+            a_params.p_resp.p_motor, a_params.p_resp.p_lapse, a_params.p_resp.p_respTime);
+
+    // session length
+    double mean = 0.0, sd = 0.0;
+    if (m_sessions > 0) {
+        mean = m_sumDur/m_sessions;
+        sd = sqrt(max(0.0, m_sumSqDur/m_sessions - mean*mean));
+    }
+    fprintf(file, "\nduration mean [min],%f\nduration sd [min],%f\nduration min [min],%f\nduration max [min],%f\n",
+            mean/MIN_TO_SEC, sd/MIN_TO_SEC, m_minDur/MIN_TO_SEC, m_maxDur/MIN_TO_SEC);
+    fprintf(file, "judgements per session,%f\nmatches per session,%f\n",
+            m_sessions > 0 ? (double)m_judgements/m_sessions : 0.0,
+            m_sessions > 0 ? (double)m_matches/m_sessions : 0.0);
+
+    // estimator accuracy vs. trial count
+    fprintf(file, "\ntest,trials,n,bias [deg],rmse [deg],mae [deg]\n");
+    for (auto &it : m_stairAcc) {
+        const accuracy_bin &b = it.second;
+        fprintf(file, "staircase,%d,%d,%f,%f,%f\n", it.first, b.d_n,
+                b.d_sumErr/b.d_n, sqrt(b.d_sumSqErr/b.d_n), b.d_sumAbsErr/b.d_n);
+    }
+    for (auto &it : m_matchAcc) {
+        const accuracy_bin &b = it.second;
+        fprintf(file, "match1D,%d,%d,%f,%f,%f\n", it.first, b.d_n,
+                b.d_sumErr/b.d_n, sqrt(b.d_sumSqErr/b.d_n), b.d_sumAbsErr/b.d_n);
+    }
+
+    // histogram of staircase length
+    fprintf(file, "\njudgements per set,count\n");
+    for (auto &it : m_stairLength) fprintf(file, "%d,%d\n", it.first, it.second);
+
+    fclose(file);
+    return true;
+}
+
+
+//------------------------------------------------------------------------------
+// simSession
+//------------------------------------------------------------------------------
+
+simSession::simSession(const farm_params &a_params, unsigned int a_seed)
+{
+    m_params = a_params;
+    m_rng.seed(a_seed);
+    m_now = 0.0;
+
+    m_subj = new subject();
+    m_exo = new simExo(m_subj, m_params.p_plant);
+    m_resp = new simResponder(m_params.p_resp, &m_rng);
+    m_stair = stairTracker(m_params.p_stair, m_rng());
+    m_testQueue = &m_tests;
+    m_clk = new simClock(&m_now);
+    m_respClk = new simClock(&m_now);
+
+    m_moving = false;
+    m_subjAng = 0.0;
+    m_setJudgements = 0;
+    m_results = NULL;
+}
+
+simSession::~simSession()
+{
+    delete m_respClk;
+    delete m_clk;
+    delete m_resp;
+    delete m_exo;
+    delete m_subj;
+}
+
+double simSession::run(farm_results &a_results)
+{
+    m_results = &a_results;
+    createTests();
+    updateTrialParams();
+
+    // same finite state machine as 'expWidget', stepping virtual time whenever it waits
+    while (m_state != thanks) {
+        exp_states state = m_state;
+        step();
+        if (m_state == state) advance();
+    }
+
+    a_results.addSession(m_now);
+    return m_now;
+}
+
+void simSession::advance()
+{
+    // nothing moves while grounding, on a break, or while subject decides on a
+    // (non-moving) response, so jump straight to end of the relevant timer
+    switch (m_state) {
+    case grounding:
+    case breaking:
+        m_now = max(m_now, m_clk->timeoutTime());
+        return;
+    case waitingForResponse:
+        if (!m_moving) {
+            m_now = max(m_now, m_respClk->timeoutTime());
+            return;
+        }
+        break;
+    default:
+        break;
+    }
+
+    m_now += SIM_DT;
+    m_exo->step(m_now);
+}
+
+void simSession::createTests()
+{
+    // same test order as 'Dialog_Exp' (first joint first), with the same lock angles
+    joints order[NUM_JNT];
+    order[0] = m_subj->m_params.p_firstJnt;
+    order[1] = (order[0] == S) ? E : S;
+
+    test_params test;
+    test.p_vision = false;
+    if (m_params.p_staircase) {
+        test.p_type = staircase;
+        test.p_active = false;
+        test.p_time = 0;
+        for (int i = 0; i < NUM_JNT; i++) {
+            test.p_joint = order[i];
+            test.p_lock = m_subj->m_params.p_lockAngs[!order[i]];
+            m_tests.push(test);
+        }
+    }
+    if (m_params.p_match1D) {
+        test.p_type = match1D;
+        for (int a = 1; a >= 0; a--) {
+            test.p_active = a;
+            for (int i = 0; i < NUM_JNT; i++) {
+                test.p_joint = order[i];
+                test.p_lock = m_subj->m_params.p_lockAngs[!order[i]];
+                m_tests.push(test);
+            }
+        }
+    }
+}
+
+std::queue<trial_params> simSession::getTrials(const test_params &a_test)
+{
+    // build queue of trials, as in 'expWidget::createTests' (no-vision trials only)
+    int nAngs[NUM_ANG];  for (int i = 0; i < NUM_ANG; i++) nAngs[i] = i;
+    int j = a_test.p_joint;
+    queue<trial_params> trials;
+    shuffle(begin(nAngs), end(nAngs), m_rng);
+    if (a_test.p_type == staircase) {
+        trial_params practice;
+        practice.p_targ = m_targAngs[j][nAngs[m_rng() % NUM_ANG]];
+        practice.p_ref = practice.p_targ + randSign()*m_params.p_stair.p_startDev;
+        practice.p_isPractice = true;
+        trials.push(practice);
+        for (int k = 0; k < NUM_ANG; k++) {
+            trial_params trial;
+            trial.p_targ = m_targAngs[j][nAngs[k]];
+            trial.p_ref = trial.p_targ + randSign()*m_params.p_stair.p_startDev;
+            trials.push(trial);
+        }
+    } else {
+        for (int k = 0; k < NUM_ANG; k++) {
+            trial_params practice;
+            practice.p_targ = m_targAngs[j][nAngs[k]];
+            practice.p_ref = practice.p_targ + m_startOff[j][nAngs[k]][m_rng() % SIM_MATCH];
+            practice.p_isPractice = true;
+            trials.push(practice);
+        }
+        for (int m = 0; m < SIM_MATCH; m++) {
+            shuffle(begin(nAngs), end(nAngs), m_rng);
+            for (int k = 0; k < NUM_ANG; k++) {
+                trial_params trial;
+                trial.p_targ = m_targAngs[j][nAngs[k]];
+                trial.p_ref = trial.p_targ + m_startOff[j][nAngs[k]][m];
+                trials.push(trial);
+            }
+        }
+    }
+    return trials;
+}
+
+void simSession::prepForTest()
+{
+    expFsm::prepForTest();
+    if (m_test.p_type == staircase) {
+        m_stairRefs.clear();
+        m_stairsDone.clear();
+        m_setJudgements = 0;
+    } else {
+        m_matchErrs.clear();
+    }
+}
+
+void simSession::staircaseComplete(int a_staircase)
+{
+    m_stairsDone.push_back(a_staircase);
+    scoreStaircases();
+}
+
+void simSession::staircaseSetComplete()
+{
+    m_results->m_stairLength[m_setJudgements]++;
+    m_stairRefs.clear();
+    m_stairsDone.clear();
+    m_setJudgements = 0;
+}
+
+void simSession::matchesComplete()
+{
+    scoreMatches();
+}
+
+void simSession::sendToGround()
+{
+    double x = CENTER_X*CM_TO_METERS;
+    if (!m_subj->m_rightHanded) x = -x;
+    m_exo->setTargTask(x, CENTER_Y*CM_TO_METERS, m_now);
+}
+
+void simSession::sendToStart()
+{
+    double ang = m_trial.p_targ;
+    if (m_test.p_type == match1D && m_test.p_active) ang = m_trial.p_ref;
+    if (m_test.p_joint == S)  m_exo->setTarg(ang*(PI/180), m_test.p_lock*(PI/180), m_now);
+    else                      m_exo->setTarg(m_test.p_lock*(PI/180), ang*(PI/180), m_now);
+}
+
+void simSession::startTimer(double a_period)
+{
+    m_clk->setTimeoutPeriodSeconds(a_period);
+    m_clk->start(true);
+}
+
+void simSession::startResponse()
+{
+    // decide response now, and when it will be registered
+    double t = m_resp->respTime();
+    m_moving = false;
+    if (m_test.p_type == match1D) {
+        m_subjAng = m_resp->match(m_test.p_joint, m_trial.p_targ, m_test.p_active);
+        if (m_test.p_active) {
+
+            // subject moves tested joint to matched angle (untested joint held at lock angle)
+            if (m_test.p_joint == S)  m_exo->setTarg(m_subjAng*(PI/180), m_test.p_lock*(PI/180), m_now);
+            else                      m_exo->setTarg(m_test.p_lock*(PI/180), m_subjAng*(PI/180), m_now);
+            m_moving = true;
+        } else {
+
+            // subject steps cursor to matched angle
+            int steps = (int)round((m_subjAng - m_trial.p_ref)/ANG_STEP);
+            m_subjAng = m_trial.p_ref + steps*ANG_STEP;
+            t += abs(steps)*T_KEY;
+        }
+    }
+    m_respClk->setTimeoutPeriodSeconds(t);
+    m_respClk->start(true);
+}
+
+bool simSession::responded()
+{
+    // if subject is moving exo, also wait until arm settles
+    return m_respClk->timeoutOccurred() && (!m_moving || m_exo->reachedTarg());
+}
+
+void simSession::recordResponse()
+{
+    if (m_test.p_type == staircase) {
+        m_stairRefs[m_stair.m_currStaircase].push_back(m_trial.p_ref);
+        m_stair.respond(m_resp->judge(m_test.p_joint, m_trial.p_targ, m_trial.p_ref));
+        m_setJudgements++;
+        m_results->m_judgements++;
+    } else {
+        if (m_test.p_active)  m_subjAng = m_exo->m_th[m_test.p_joint]*(180/PI);
+        if (!m_trial.p_isPractice)
+            m_matchErrs[m_trial.p_targ].push_back(m_subjAng - m_trial.p_targ);
+        m_results->m_matches++;
+    }
+}
+
+void simSession::scoreStaircases()
+{
+    if (m_trial.p_isPractice) return;
+
+    // estimate boundary as in 'stairTracker::estimatePerceptParams', from completed staircases
+    double sum = 0.0;
+    int n = 0;
+    for (int sc : m_stairsDone) {
+        vector<double> &refs = m_stairRefs[sc];
+        int num = min((int)refs.size(), m_params.p_stair.p_numForEst);
+        for (int i = 0; i < num; i++) sum += refs[refs.size()-(i+1)];
+        n += num;
+    }
+    if (n == 0) return;
+
+    // point of subjective equality is test angle shifted by subject's bias
+    double pse = m_trial.p_targ + m_resp->m_bias[m_test.p_joint];
+    m_results->addEstimate(m_results->m_stairAcc, (m_setJudgements/SIM_BIN)*SIM_BIN, sum/n - pse);
+}
+
+void simSession::scoreMatches()
+{
+    // bias estimated as mean match error over first 'k' matches to each target angle
+    for (auto &it : m_matchErrs) {
+        double sum = 0.0;
+        for (size_t k = 0; k < it.second.size(); k++) {
+            sum += it.second[k];
+            m_results->addEstimate(m_results->m_matchAcc, k+1, sum/(k+1) - m_resp->m_bias[m_test.p_joint]);
+        }
+    }
+    m_matchErrs.clear();
+}
+
+
+//------------------------------------------------------------------------------
+// simFarm
+//------------------------------------------------------------------------------
+
+void simFarm::run()
+{
+    int numThreads = m_params.p_threads;
+    if (numThreads <= 0) numThreads = max(1, (int)thread::hardware_concurrency());
+
+    // each worker pulls sessions until all are done, accumulating its own results
+    atomic<int> next(0);
+    vector<farm_results> results(numThreads);
+    vector<thread> workers;
+    for (int t = 0; t < numThreads; t++) {
+        workers.push_back(thread([this, &next, &results, t]() {
+            int n;
+            while ((n = next++) < m_params.p_sessions) {
+                simSession session(m_params, m_params.p_seed + n);
+                session.run(results[t]);
+            }
+        }));
+    }
+    for (auto &w : workers) w.join();
+
+    for (auto &r : results) m_results.merge(r);
+}
@@ -0,0 +1,217 @@
+#ifndef SIMFARM_H
+#define SIMFARM_H
+
+#include "expfsm.h"
+#include "subject.h"
+#include <cstdio>
+#include <string>
+#include <vector>
+#include <queue>
+#include <map>
+#include <random>
+
+#define SIM_DT       0.001     // simulated servo period, same as haptic thread [sec]
+#define SIM_BIN      5         // width of trial-count bins for aggregating estimator accuracy [trials]
+#define SIM_MATCH    4         // number of matches per target joint angle, as NUM_MATCH in 'expWidget'
+
+// virtual clock, mirroring the subset of 'cPrecisionClock' used by the experiment FSM
+// NOTE: all clocks of a session share the same (simulated) time
+class simClock
+{
+public:
+    simClock(const double *a_now) { m_now = a_now; m_tStart = 0.0; m_period = 0.0; }
+
+    void setTimeoutPeriodSeconds(double a_period) { m_period = a_period; }
+    void start(bool /*a_reset*/ = false) { m_tStart = *m_now; }
+    bool timeoutOccurred() { return *m_now >= timeoutTime(); }  // same form as jumps to 'timeoutTime' (no rounding gap)
+    double getCurrentTimeSeconds() { return *m_now - m_tStart; }
+    double timeoutTime() { return m_tStart + m_period; }
+
+protected:
+    const double *m_now;  // pointer to session time [sec]
+    double m_tStart;      // time clock was started [sec]
+    double m_period;      // timeout period [sec]
+};
+
+// parameters of simulated (decoupled) exo + arm plant, per joint
+// NOTE: default gains are those of 'exo'; inertia & friction are rough estimates
+typedef struct
+{
+    double p_I[NUM_JNT] = {0.30, 0.10};   // inertia of linkage + arm [kg*m^2]
+    double p_b[NUM_JNT] = {0.20, 0.10};   // viscous friction [N*m*s/rad]
+    double p_Fc[NUM_JNT] = {0.05, 0.03};  // Coulomb friction [N*m]
+    double p_Kp[NUM_JNT] = {6.0, 3.0};    // proportional gains for joint-space control
+    double p_Kd[NUM_JNT] = {2.0, 2.0};    // derivative gains for joint-space control
+} plant_params;
+
+// simulated exo: min-jerk joint-space trajectories tracked by PD control
+class simExo
+{
+public:
+    plant_params m_params;  // plant parameters
+    subject *m_subj;        // pointer to subject wearing exo (for kinematics)
+    double m_th[NUM_JNT];     // current joint angles [rad]
+    double m_thdot[NUM_JNT];  // current joint velocities [rad/s]
+    double m_thTarg[NUM_JNT]; // target joint angles [rad]
+
+    simExo(subject *a_subj, plant_params a_params = plant_params());
+
+    void setTarg(double a_thS, double a_thE, double a_t);
+    void setTargTask(double a_x, double a_y, double a_t);
+    void step(double a_t);
+    bool reachedTarg();
+    void inverseKin(double a_x, double a_y, double &a_thS, double &a_thE);
+
+protected:
+    double m_thInit[NUM_JNT];  // joint angles at start of trajectory [rad]
+    double m_dtMove[NUM_JNT];  // time allotted for movement [sec]
+    double m_tInit;            // time target was set [sec]
+    int m_count;               // number of consecutive "stopped" checks
+};
+
+// parameters of simulated subject's proprioception
+typedef struct
+{
+    double p_biasMean = 0.0;  // population mean of proprioceptive bias [deg]
+    double p_biasSD = 3.0;    // population standard deviation of bias [deg]
+    double p_noise = 4.0;     // trial-to-trial perceptual noise (standard deviation) [deg]
+    double p_motor = 1.0;     // motor noise on active matches (standard deviation) [deg]
+    double p_lapse = 0.02;    // probability of random (guessed) 2AFC response
+    double p_respTime = 1.5;  // mean response time [sec]
+} responder_params;
+
+// simulated subject: biased, noisy estimate of arm angle
+class simResponder
+{
+public:
+    responder_params m_params;  // population parameters
+    double m_bias[NUM_JNT];     // this subject's proprioceptive bias [deg]
+
+    simResponder(responder_params a_params, std::mt19937 *a_rng);
+
+    bool judge(joints a_jnt, double a_targ, double a_ref);
+    double match(joints a_jnt, double a_targ, bool a_active);
+    double respTime();
+
+protected:
+    std::mt19937 *m_rng;  // pointer to session's random number generator
+};
+
+// parameters of a farm run
+typedef struct
+{
+    int p_sessions = 1000;                  // number of sessions to simulate
+    int p_threads = 0;                      // number of worker threads (0 = all cores)
+    unsigned int p_seed = 1;                // base seed (session 'n' uses seed + n)
+    bool p_staircase = true;                // simulate staircase tests
+    bool p_match1D = true;                  // simulate 1-D matching tests (active & passive, no vision)
+    bool p_skipBreaks = false;              // TRUE = breaks take no (simulated) time
+    stair_params p_stair;                   // staircase procedure
+    responder_params p_resp;                // subject population
+    plant_params p_plant;                   // exo + arm plant
+} farm_params;
+
+// accuracy of perceptual estimates for one trial-count bin
+typedef struct
+{
+    int d_n = 0;             // number of estimates
+    double d_sumErr = 0;     // sum of errors (estimate - truth) [deg]
+    double d_sumSqErr = 0;   // sum of squared errors [deg^2]
+    double d_sumAbsErr = 0;  // sum of absolute errors [deg]
+} accuracy_bin;
+
+// results of one session, or aggregate of many
+class farm_results
+{
+public:
+    std::map<int,accuracy_bin> m_stairAcc;   // staircase estimator accuracy vs. judgements for that test angle (binned)
+    std::map<int,accuracy_bin> m_matchAcc;   // 1-D matching bias-estimate accuracy vs. matches for that target angle
+    std::map<int,int> m_stairLength;         // histogram of judgements per (completed) set of staircases
+    int m_sessions = 0;                      // number of sessions
+    double m_sumDur = 0;                     // sum of session durations [sec]
+    double m_sumSqDur = 0;                   // sum of squared session durations [sec^2]
+    double m_minDur = 1e12;                  // shortest session [sec]
+    double m_maxDur = 0;                     // longest session [sec]
+    long m_judgements = 0;                   // total 2AFC judgements
+    long m_matches = 0;                      // total matches
+
+    void addEstimate(std::map<int,accuracy_bin> &a_acc, int a_trials, double a_err);
+    void addSession(double a_dur);
+    void merge(const farm_results &a_other);
+    bool write(std::string a_filename, const farm_params &a_params);
+};
+
+// one simulated experiment session, running the same FSM as 'expWidget' on virtual time
+class simSession : public expFsm
+{
+public:
+    simSession(const farm_params &a_params, unsigned int a_seed);
+    ~simSession();
+
+    double run(farm_results &a_results);
+
+protected:
+    farm_params m_params;
+    std::mt19937 m_rng;
+    subject *m_subj;
+    simExo *m_exo;
+    simResponder *m_resp;
+    double m_now;                            // simulated time [sec]
+    simClock *m_clk;                         // FSM timer (as 'expWidget::m_clk')
+    simClock *m_respClk;                     // time until simulated subject responds
+    std::queue<test_params> m_tests;         // FIFO list of tests (as 'ExpWindow::m_testQueue')
+    bool m_moving;                           // TRUE = simulated subject is actively moving the exo
+    double m_subjAng;                        // simulated subject's matched angle [deg]
+
+    // bookkeeping for estimator accuracy
+    std::map<int,std::vector<double>> m_stairRefs;  // reference angles tested, per staircase of current set [deg]
+    std::vector<int> m_stairsDone;                  // staircases completed in current set
+    int m_setJudgements;                            // judgements made in current set
+    std::map<double,std::vector<double>> m_matchErrs;  // match errors, per target angle of current test [deg]
+    farm_results *m_results;                        // results of this session
+
+    // same test definitions as 'expWidget'
+    double m_targAngs[NUM_JNT][NUM_ANG] = { {20, 30, 40}, {105, 115, 125} };
+    double m_startOff[NUM_JNT][NUM_ANG][SIM_MATCH] =
+        { { {-10, -5, 5, 10}, {-20, -10, 10, 20}, {-10, -5, 5, 10} },
+          { {-10, -5, 5, 10}, {-20, -10, 10, 20}, {-10, -5, 5, 10} } };
+
+    void createTests();
+    void advance();
+    void scoreStaircases();
+    void scoreMatches();
+    int randSign() { return (m_rng() % 2 == 1) ? 1 : -1; }
+
+    // protocol details for 'expFsm'
+    std::queue<trial_params> getTrials(const test_params &a_test);
+    void prepForTest();
+    void staircaseComplete(int a_staircase);
+    void staircaseSetComplete();
+    void matchesComplete();
+
+    // simulated exo, clocks & subject for 'expFsm'
+    bool reachedTarg() { return m_exo->reachedTarg(); }
+    void sendToGround();
+    void sendToStart();
+    void startResponse();
+    bool responded();
+    void recordResponse();
+    void startTimer(double a_period);
+    bool timerExpired() { return m_clk->timeoutOccurred(); }
+    bool proceedRequested() { return true; }  // nothing to (manually) lock, and no welcome screen to dismiss
+    bool skipRequested() { return m_state == breaking && m_params.p_skipBreaks; }
+};
+
+// runs many sessions in parallel and aggregates their results
+class simFarm
+{
+public:
+    farm_params m_params;
+    farm_results m_results;
+
+    simFarm(farm_params a_params) { m_params = a_params; }
+
+    void run();
+};
+
+#endif // SIMFARM_H
@@ -0,0 +1,30 @@
+#---------------------------------------------#
+#                                             #
+#  Project file for headless simulated-       #
+#  subject farm (experiment protocol design)  #
+#                                             #
+#---------------------------------------------#
+
+QT      += core
+QT      -= gui
+CONFIG  += console c++11
+CONFIG  -= app_bundle
+TEMPLATE = app
+
+# specify targets for files created during compilation
+TARGET      = chARMsimfarm
+DESTDIR     = ./bin
+OBJECTS_DIR = ./obj_simfarm
+
+# point to source and header files (no exo hardware, graphics, or GUI)
+SOURCES += $$PWD/simfarm_main.cpp \
+           $$PWD/simfarm.cpp \
+           $$PWD/expfsm.cpp \
+           $$PWD/stairtracker.cpp \
+           $$PWD/subject.cpp
+
+HEADERS += $$PWD/simfarm.h \
+           $$PWD/expfsm.h \
+           $$PWD/stairtracker.h \
+           $$PWD/expparams.h \
+           $$PWD/subject.h
@@ -0,0 +1,82 @@
+#include "simfarm.h"
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <chrono>
+
+// print command-line options
+static void usage(const char *a_prog)
+{
+    printf("usage: %s [options]\n", a_prog);
+    printf("  -n <int>        number of sessions (default 1000)\n");
+    printf("  -j <int>        number of worker threads (default = all cores)\n");
+    printf("  -s <int>        base random seed (default 1)\n");
+    printf("  -o <file>       output file (default simfarm.csv)\n");
+    printf("  --single        one staircase at a time (DOUB_STAIRS = 0)\n");
+    printf("  --adaptive      adaptive staircase (ADAPTIVE = 1)\n");
+    printf("  --reversals <n> reversals per staircase (MAX_REVERSAL, at least NUM_FOR_EST if adaptive)\n");
+    printf("  --startdev <d>  starting deviation of reference [deg]\n");
+    printf("  --bias <m> <sd> population bias mean & standard deviation [deg]\n");
+    printf("  --noise <sd>    perceptual noise [deg]\n");
+    printf("  --lapse <p>     lapse rate\n");
+    printf("  --no-stair      do not simulate staircase tests\n");
+    printf("  --no-match      do not simulate 1-D matching tests\n");
+    printf("  --skip-breaks   breaks take no time\n");
+}
+
+int main(int argc, char *argv[])
+{
+    farm_params params;
+    std::string filename = "simfarm.csv";
+
+    // parse arguments
+    for (int i = 1; i < argc; i++) {
+        bool more = (i+1 < argc);
+        if      (!strcmp(argv[i],"-n") && more)            params.p_sessions = atoi(argv[++i]);
+        else if (!strcmp(argv[i],"-j") && more)            params.p_threads = atoi(argv[++i]);
+        else if (!strcmp(argv[i],"-s") && more)            params.p_seed = (unsigned int)atol(argv[++i]);
+        else if (!strcmp(argv[i],"-o") && more)            filename = argv[++i];
+        else if (!strcmp(argv[i],"--single"))              params.p_stair.p_doubStairs = false;
+        else if (!strcmp(argv[i],"--adaptive"))            params.p_stair.p_adaptive = true;
+        else if (!strcmp(argv[i],"--reversals") && more)   params.p_stair.p_maxReversal = atoi(argv[++i]);
+        else if (!strcmp(argv[i],"--startdev") && more)    params.p_stair.p_startDev = atof(argv[++i]);
+        else if (!strcmp(argv[i],"--bias") && i+2 < argc) {
+            params.p_resp.p_biasMean = atof(argv[++i]);
+            params.p_resp.p_biasSD = atof(argv[++i]);
+        }
+        else if (!strcmp(argv[i],"--noise") && more)       params.p_resp.p_noise = atof(argv[++i]);
+        else if (!strcmp(argv[i],"--lapse") && more)       params.p_resp.p_lapse = atof(argv[++i]);
+        else if (!strcmp(argv[i],"--no-stair"))            params.p_staircase = false;
+        else if (!strcmp(argv[i],"--no-match"))            params.p_match1D = false;
+        else if (!strcmp(argv[i],"--skip-breaks"))         params.p_skipBreaks = true;
+        else {
+            usage(argv[0]);
+            return 1;
+        }
+    }
+
+    // need at least one session & one reversal per staircase (adaptive estimation needs 'p_numForEst' reversals)
+    int minReversal = params.p_stair.p_adaptive ? params.p_stair.p_numForEst : 1;
+    if (params.p_stair.p_maxReversal < minReversal || params.p_sessions < 1) {
+        usage(argv[0]);
+        return 1;
+    }
+
+    // run farm
+    auto tStart = std::chrono::steady_clock::now();
+    simFarm farm(params);
+    farm.run();
+    double tRun = std::chrono::duration<double>(std::chrono::steady_clock::now() - tStart).count();
+
+    // summarize & save results
+    const farm_results &r = farm.m_results;
+    printf("%d sessions in %.1f sec\n", r.m_sessions, tRun);
+    printf("mean session length = %.1f min, %.1f judgements, %.1f matches\n",
+           r.m_sumDur/r.m_sessions/60, (double)r.m_judgements/r.m_sessions, (double)r.m_matches/r.m_sessions);
+    if (!farm.m_results.write(filename, params)) {
+        printf("could not open '%s' for writing\n", filename.c_str());
+        return 1;
+    }
+    printf("results written to '%s'\n", filename.c_str());
+    return 0;
+}
@@ -0,0 +1,246 @@
+#include "stairtracker.h"
+#include <QDebug>
+
+#define DEBUG 0
+
+using namespace std;
+
+stairTracker::stairTracker(stair_params a_params, unsigned int a_seed)
+{
+    m_params = a_params;
+    m_rng.seed(a_seed);
+
+    // start as if beginning to test new angle/joint
+    m_stairStatus = 2;
+    m_numStaircases = 0;
+    m_currStaircase = 0;
+    m_maxStaircases = 0;
+    m_boundary = 0.0;
+    m_sensitiv = 0.0;
+    for (int i = 0; i < 2; i++) {
+        m_numJudgements[i] = 0;
+        m_numReversals[i] = 0;
+        m_refStartSide[i] = 0;
+        m_refStepDir[i] = 0;
+        m_refStep[i] = 0.0;
+        m_refAng[i] = 0.0;
+        m_corrResp[i] = false;
+        m_subjResp[i] = false;
+        m_subjRespPrev[i] = false;
+        m_oneCorrect[i] = true;
+    }
+}
+
+void stairTracker::reset(trial_params &a_trial)
+{
+    // reset parameters independent of staircase status
+    for (int i = 0; i < 2; i++) {
+        m_numJudgements[i] = 0;
+        m_oneCorrect[i] = true;
+    }
+
+    // reset parameters for new SET of staircases (i.e., beginning to test new angle/joint)
+    if (m_stairStatus == 2) {
+        m_numStaircases = 0;
+        if (m_params.p_adaptive) m_maxStaircases = 6;
+        else                     m_maxStaircases = 4;
+        for (int i = 0; i < 2; i++) m_refStep[i] = 10;
+        if (m_params.p_doubStairs) {
+            if (a_trial.p_isPractice) m_maxStaircases = 2;             // 2 = 1 double-staircase
+            m_currStaircase = (a_trial.p_ref < a_trial.p_targ);        // either 0 (starting CLOSER to body) or 1
+            m_refStartSide[CLOSER] = 1; m_refStartSide[FURTHER] = -1;  // always {starts CLOSER, starts FURTHER}
+            m_refAng[m_currStaircase] = a_trial.p_ref;
+            m_refAng[!m_currStaircase] = a_trial.p_targ + m_refStartSide[!m_currStaircase]*m_params.p_startDev;
+            for (int i = 0; i < 2; i++) {
+                m_numReversals[i] = 0;
+                m_refStepDir[i] = -1*m_refStartSide[i];
+                m_corrResp[i] = (a_trial.p_targ >= m_refAng[i]);
+            }
+        } else {
+            if (a_trial.p_isPractice) m_maxStaircases = 1;
+            m_currStaircase = 0;
+            m_numReversals[0] = 0; m_numReversals[1] = m_params.p_maxReversal;  // only want to work along first dimension of array
+            m_refStartSide[0] = (int)(a_trial.p_ref > a_trial.p_targ) - (int)(a_trial.p_ref < a_trial.p_targ);
+            m_refStepDir[0] = -1*m_refStartSide[0];
+            m_refAng[0] = a_trial.p_ref;
+            m_corrResp[0] = (a_trial.p_targ >= m_refAng[0]);
+        }
+    }
+
+    // reset parameters for next single or double staircase (within set for same joint angle)
+    else {
+        if (m_params.p_adaptive && m_numStaircases == 2)  estimatePerceptParams();
+        if (m_params.p_doubStairs) {
+            m_currStaircase = m_numStaircases + (int)randBool();
+            m_refStartSide[CLOSER] = 1; m_refStartSide[FURTHER] = -1;
+            for (int i = 0; i < 2; i++) {
+                m_numReversals[i] = 0;
+                m_refStepDir[i] = -1*m_refStartSide[i];
+            }
+            if (m_params.p_adaptive && m_numStaircases >= 2) {
+                for (int i = 0; i < 2; i++) {
+                    m_refStep[i] = 5;
+                    m_refAng[i] = m_boundary + m_refStartSide[i]*m_sensitiv;
+                    m_corrResp[i] = (a_trial.p_targ >= m_refAng[i]);  // arm position stays same
+
+                    // possibly correct start side & step direction because where reference falls
+                    // relative to target is dependent on estimated perceptual parameters
+                    if (m_corrResp[i] == CLOSER) {
+                        m_refStartSide[i] = 1;
+                        m_refStepDir[i] = -1;
+                    } else {
+                        m_refStartSide[i] = -1;
+                        m_refStepDir[i] = 1;
+                    }
+                }
+            } else {
+                for (int i = 0; i < 2; i++) {
+                    m_refStep[i] = 10;
+                    m_refAng[i] = a_trial.p_targ + m_refStartSide[i]*m_params.p_startDev;
+                    m_corrResp[i] = (a_trial.p_targ >= m_refAng[i]);
+                }
+            }
+        } else {
+            m_currStaircase = m_numStaircases;
+            m_numReversals[0] = 0; m_numReversals[1] = m_params.p_maxReversal;
+            m_refStartSide[0] = -1*m_refStartSide[0];  // flip relative to previous staircase
+            m_refStepDir[0] = -1*m_refStartSide[0];
+            if (m_params.p_adaptive && m_numStaircases >= 2) {
+                m_refStep[0] = 5;
+                m_refAng[0] = m_boundary + m_refStartSide[0]*m_sensitiv;
+                m_corrResp[0] = (a_trial.p_targ >= m_refAng[0]);
+                if (m_corrResp[0] == CLOSER) {
+                    m_refStartSide[0] = 1;
+                    m_refStepDir[0] = -1;
+                } else {
+                    m_refStartSide[0] = -1;
+                    m_refStepDir[0] = 1;
+                }
+            } else {
+                m_refStep[0] = 10;
+                m_refAng[0] = a_trial.p_targ + m_refStartSide[0]*m_params.p_startDev;
+                m_corrResp[0] = (a_trial.p_targ >= m_refAng[0]);
+            }
+        }
+
+        // set up for first trial of next single/double staircase
+        a_trial.p_ref = m_refAng[getStairIndex(m_currStaircase)];
+    }
+}
+
+void stairTracker::update(trial_params &a_trial)
+{
+    int i = getStairIndex(m_currStaircase);
+    m_numJudgements[i]++;
+    if (DEBUG)  qDebug() << "judgement #" << m_numJudgements[i];
+
+    // save tested reference angle if staircase is "adaptive"
+    if (m_params.p_adaptive && !a_trial.p_isPractice && m_numStaircases < 2)
+        m_refAngsForEstim[m_currStaircase].push_back(a_trial.p_ref);
+
+    // if judgement was first of current staircase (until one correct)
+    if (m_numJudgements[i] == 1 || !m_oneCorrect[i]) {
+        if (m_subjResp[i] != m_corrResp[i]) {
+            if (DEBUG)  qDebug() << "  WRONG, moving away from arm";
+            m_oneCorrect[i] = false;
+            m_refStepDir[i] = m_refStartSide[i];
+        } else {
+            if (DEBUG)  qDebug() << "  CORRECT, moving towards arm";
+            m_oneCorrect[i] = true;
+            m_refStepDir[i] = -1*m_refStartSide[i];
+        }
+        m_stairStatus = 0;
+    }
+
+    // once a correct judgement has been made
+    else {
+
+        // if reversed judgement
+        if (m_subjResp[i] != m_subjRespPrev[i]) {
+            m_numReversals[i]++;
+            if (DEBUG)  qDebug() << "  switched decision, reversing direction time #" << m_numReversals[i];
+            m_refStep[i] = 0.5*m_refStep[i];
+            m_refStepDir[i] = -1*m_refStepDir[i];
+            m_stairStatus = 0;
+
+            // if done with staircase
+            if (m_numReversals[i] == m_params.p_maxReversal) {
+                m_numStaircases++;
+                if (DEBUG)  qDebug() << "  finished staircase #" << m_numStaircases;
+
+                // if done with BOTH staircases in double-staircase paradigm
+                // NOTE: because of how test variables are initialized, this
+                // ----  check also works for single-staircase paradigm
+                if (m_numReversals[!i] == m_params.p_maxReversal) {
+                    m_stairStatus = 1;
+
+                    // if done with set of staircases
+                    if (m_numStaircases == m_maxStaircases) {
+                        m_stairStatus = 2;
+                    }
+                }
+            }
+        }
+    }
+
+    // if mid-staircase, update reference angle & trial params
+    if (!m_stairStatus) {
+        m_refAng[i] = m_refAng[i] + m_refStepDir[i]*m_refStep[i];
+        int i_next = randBool();
+        if (m_numReversals[i_next] == m_params.p_maxReversal) i_next = (int)(!i_next);
+        if (m_params.p_doubStairs) m_currStaircase = (int)floor(m_numStaircases/2)*2 + i_next;
+        else                       m_currStaircase = m_numStaircases + i_next;
+        a_trial.p_ref = m_refAng[i_next];
+    }
+}
+
+void stairTracker::respond(bool a_resp)
+{
+    // register subject's 2AFC response for current staircase
+    int i = getStairIndex(m_currStaircase);
+    m_subjRespPrev[i] = m_subjResp[i];
+    m_subjResp[i] = a_resp;
+}
+
+int stairTracker::getStairIndex(int currStaircase)
+{
+    if (m_params.p_doubStairs) {
+        return fmod(currStaircase,2);
+    } else {
+        return 0;  // don't really need array if only one staircase at a time
+    }
+}
+
+void stairTracker::estimatePerceptParams()
+{
+    // extract last 4 angles tested in staircases 1 & 2
+    // (a staircase may end with fewer judgements than 'p_numForEst')
+    vector<double> data;
+    for (int sc = 0; sc < 2; sc++) {
+        int numJudgements = m_refAngsForEstim[sc].size();
+        int num = min(numJudgements, m_params.p_numForEst);
+        for (int i = 0; i < num; i++) {
+            data.push_back(m_refAngsForEstim[sc][numJudgements-(i+1)]);
+        }
+        m_refAngsForEstim[sc].clear();
+    }
+    if (data.empty()) return;  // nothing to estimate from, keep previous estimates
+
+    // estimate perceptual boundary & sensitivity (mean/range of last 4 angles tested in staircases 1 & 2)
+    double max = -180;
+    double min = 180;
+    double sum = 0;
+    for(vector<double>::iterator it = data.begin(); it != data.end(); ++it) {
+        if (*it > max) max = *it;
+        if (*it < min) min = *it;
+        sum = sum + *it;
+    }
+    m_boundary = sum/data.size();
+    m_sensitiv = 0.75*(max-min);
+    if (DEBUG)  qDebug() << "** boundary = " << m_boundary << " / sensitivity = " << m_sensitiv << " **";
+}
+
+bool stairTracker::randBool()
+{
+    return m_rng() % 2 == 1;
+}
@@ -0,0 +1,69 @@
+#ifndef STAIRTRACKER_H
+#define STAIRTRACKER_H
+
+#include "expparams.h"
+#include <vector>
+#include <random>
+
+#define DOUB_STAIRS  1         // 1 = two staircases at a time (randomized), 0 = one staircase at a time
+#define ADAPTIVE     0         // 1 = adaptive test, 0 = standard test
+#define CLOSER       0         // reference is rotated closer to body than actual arm (test angle)
+#define FURTHER      1         // reference is rotated further from body than actual arm (test angle)
+#define FROM_CLOSER  0         // in double-staircase paradigm, staircase for which reference angle starts closer to body
+#define FROM_FURTHER 1         // in double-staircase paradigm, staircase for which reference angle starts further from body
+#define START_DEV    30        // starting deviation from test angle for staircases 1 & 2 [deg]
+#define MAX_REVERSAL 4         // number of reversals for each staircase
+#define NUM_FOR_EST  4         // in adaptive paradigm, number of reference angles (from each staircase) to use for estimation of perceptual boundary/sensitivity
+
+// parameters defining staircase procedure (defaults used in experiment)
+typedef struct
+{
+    bool p_doubStairs = DOUB_STAIRS;  // TRUE = two staircases at a time (randomized)
+    bool p_adaptive = ADAPTIVE;       // TRUE = adaptive test
+    int p_maxReversal = MAX_REVERSAL; // number of reversals for each staircase
+    double p_startDev = START_DEV;    // starting deviation from test angle for staircases 1 & 2 [deg]
+    int p_numForEst = NUM_FOR_EST;    // number of reference angles (from each staircase) used for adaptive estimation
+} stair_params;
+
+// state of (single or double) staircase for one joint & test angle,
+// independent of graphics and user input so that it can be run headless
+class stairTracker
+{
+public:
+    stair_params m_params;                     // parameters defining staircase procedure
+
+    int m_stairStatus;                         // status of staircase test: 2 = beginning new angle/joint, 1 = beginning new (double) staircase, 0 = mid-staircase
+    int m_numStaircases;                       // number of staircases completed for current joint & test angle
+    int m_currStaircase;                       // current staircase (only important if double staircase)
+    int m_maxStaircases;                       // 6 normally (if double-staircase, 3 sets of 2), 1 for practice (1 set of 2)
+    int m_numJudgements[2];                    // number of judgements made during current staircase (pair)
+    int m_numReversals[2];                     // number of judgement reversals during current staircase (pair)
+    int m_refStartSide[2];                     // 1 = visual reference starts CLOSER to body relative to test angle, -1 = FURTHER from body
+    int m_refStepDir[2];                       // (+/-)1 depending on where reference falls relative to test angles
+    double m_refStep[2];                       // step size for visual reference between judgements [deg]
+    double m_refAng[2];                        // angle of visual reference, for current judgement [deg]
+    bool m_corrResp[2];                        // correct response to 2AFC: TRUE = FURTHER, FALSE = CLOSER (reference relative to test angle)
+    bool m_subjResp[2];                        // subject's response to 2AFC: TRUE = FURTHER, FALSE = CLOSER (reference relative to test angle)
+    bool m_subjRespPrev[2];                    // subject response from previous judgement
+    bool m_oneCorrect[2];                      // TRUE = correctly answered one 2AFC
+    double m_boundary;                         // estimate of subject's proprioceptive boundary, used if adaptive [deg]
+    double m_sensitiv;                         // estimate of subject's proprioceptive sensitivity, used if adaptive [deg]
+    std::vector<double> m_refAngsForEstim[2];  // vectors for tracking visual reference angles over staircases 1-2 [deg]
+
+    stairTracker(stair_params a_params = stair_params(),
+                 unsigned int a_seed = std::random_device()());
+
+    void reset(trial_params &a_trial);
+    void update(trial_params &a_trial);
+    void respond(bool a_resp);
+    int getStairIndex(int currStaircase);
+    int getStairIndex() { return getStairIndex(m_currStaircase); }
+
+protected:
+    std::mt19937 m_rng;                        // random number generator (one per tracker, for parallel use)
+
+    void estimatePerceptParams();
+    bool randBool();
+};
+
+#endif // STAIRTRACKER_H
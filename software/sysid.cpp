@@ -0,0 +1,161 @@
+#include "sysid.h"
+#include <cstdio>
+#include <cmath>
+
+#define T_MAX        12        // maximum motor torque to command, same as 'exo' [N*m]
+#define RATIO_S      16.98     // gear ratio between shoulder motor and capstan, same as 'exo'
+#define RATIO_E      16.59     // gear ratio between elbow motor and capstan, same as 'exo'
+#define DEG_TO_RAD   (3.141592/180)
+
+using namespace std;
+
+sysIdentifier::sysIdentifier(bool a_rightHanded)
+{
+    m_rightHanded = a_rightHanded;
+    for (int i = 0; i < FF_NUM_JNT; i++) {
+        m_numSamples[i] = 0;
+        m_rms[i] = 0.0;
+        m_r2[i] = 0.0;
+        m_btb[i] = 0.0;
+        m_sumb[i] = 0.0;
+        for (int p = 0; p < SYSID_NUM_PARAM; p++) {
+            m_Atb[i][p] = 0.0;
+            for (int q = 0; q < SYSID_NUM_PARAM; q++) m_AtA[i][p][q] = 0.0;
+        }
+    }
+}
+
+bool sysIdentifier::addRun(std::string a_filename)
+{
+    FILE *file = fopen(a_filename.c_str(), "r");
+    if (file == NULL) return false;
+
+    // columns: time, angles (2), velocities (2), hand position (2), hand velocity (2), torques (2)
+    // NOTE: header line (and any line that does not parse) is skipped
+    vector<sysid_sample> run;
+    char line[512];
+    while (fgets(line, sizeof(line), file) != NULL) {
+        sysid_sample s;
+        double thdot[2], pos[2], vel[2];
+        double thS, thE;
+        if (sscanf(line, "%lf, %lf, %lf, %lf, %lf, %lf, %lf, %lf, %lf, %lf, %lf",
+                   &s.d_time, &thS, &thE, &thdot[0], &thdot[1], &pos[0], &pos[1],
+                   &vel[0], &vel[1], &s.d_T[0], &s.d_T[1]) == 11) {
+            s.d_th[0] = thS*DEG_TO_RAD;
+            s.d_th[1] = thE*DEG_TO_RAD;
+            run.push_back(s);
+        }
+    }
+    fclose(file);
+
+    if (run.size() < 3) return false;
+    addBatch(run);
+    return true;
+}
+
+void sysIdentifier::addBatch(const std::vector<sysid_sample> &a_run)
+{
+    // differentiate positions (central differences, allowing for uneven logging) & accumulate regressors
+    const double ratio[FF_NUM_JNT] = {RATIO_S, RATIO_E};
+    for (size_t k = 1; k+1 < a_run.size(); k++) {
+        double h1 = a_run[k].d_time - a_run[k-1].d_time;
+        double h2 = a_run[k+1].d_time - a_run[k].d_time;
+        if (h1 <= 0.0 || h2 <= 0.0) continue;  // new run appended or clock reset
+
+        for (int i = 0; i < FF_NUM_JNT; i++) {
+            // logged torques are in joint space, but exo saturates in motor space (after gearing)
+            double T = a_run[k].d_T[i];
+            if (fabs(T)/ratio[i] >= T_MAX) continue;  // saturated
+
+            double v1 = (a_run[k].d_th[i] - a_run[k-1].d_th[i])/h1;
+            double v2 = (a_run[k+1].d_th[i] - a_run[k].d_th[i])/h2;
+            double v = (v1*h2 + v2*h1)/(h1 + h2);
+            double a = 2.0*(v2 - v1)/(h1 + h2);
+
+            // T = I*a + b*v + Fc+ (v > 0) + Fc- (v < 0)
+            double row[SYSID_NUM_PARAM];
+            row[0] = a;
+            row[1] = v;
+            row[2] = (v > SYSID_MIN_VEL) ? 1.0 : 0.0;
+            row[3] = (v < -SYSID_MIN_VEL) ? -1.0 : 0.0;
+
+            for (int p = 0; p < SYSID_NUM_PARAM; p++) {
+                m_Atb[i][p] += row[p]*T;
+                for (int q = 0; q < SYSID_NUM_PARAM; q++) m_AtA[i][p][q] += row[p]*row[q];
+            }
+            m_btb[i] += T*T;
+            m_sumb[i] += T;
+            m_numSamples[i]++;
+        }
+    }
+}
+
+bool sysIdentifier::solve(ffwdTable &a_table, const ffwdTable &a_base)
+{
+    for (int i = 0; i < FF_NUM_JNT; i++) {
+        if (m_numSamples[i] < SYSID_NUM_PARAM) return false;
+
+        // regularize (poorly excited parameters are pulled toward zero)
+        double A[SYSID_NUM_PARAM][SYSID_NUM_PARAM];
+        double x[SYSID_NUM_PARAM];
+        double trace = 0.0;
+        for (int p = 0; p < SYSID_NUM_PARAM; p++) trace += m_AtA[i][p][p];
+        for (int p = 0; p < SYSID_NUM_PARAM; p++) {
+            for (int q = 0; q < SYSID_NUM_PARAM; q++) A[p][q] = m_AtA[i][p][q];
+            A[p][p] += SYSID_RIDGE*trace/SYSID_NUM_PARAM;
+            x[p] = m_Atb[i][p];
+        }
+        if (!solveLinear(A, x)) return false;
+
+        // residual from normal equations: r'r = b'b - 2x'A'b + x'A'Ax
+        double rr = m_btb[i];
+        for (int p = 0; p < SYSID_NUM_PARAM; p++) {
+            rr -= 2.0*x[p]*m_Atb[i][p];
+            for (int q = 0; q < SYSID_NUM_PARAM; q++) rr += x[p]*m_AtA[i][p][q]*x[q];
+        }
+        double n = (double)m_numSamples[i];
+        double var = m_btb[i]/n - (m_sumb[i]/n)*(m_sumb[i]/n);
+        m_rms[i] = sqrt(fmax(rr, 0.0)/n);
+        m_r2[i] = (var > 0.0) ? 1.0 - (fmax(rr, 0.0)/n)/var : 0.0;
+
+        // physical parameters cannot be negative
+        jnt_model model;
+        model.p_I = fmax(x[0], 0.0);
+        model.p_b = fmax(x[1], 0.0);
+        model.p_FcPos = fmax(x[2], 0.0);
+        model.p_FcNeg = fmax(x[3], 0.0);
+
+        // keep deadbands used during logging (their residual is already in the Coulomb terms)
+        model.p_dbLo = a_base.m_model[i].p_dbLo;
+        model.p_dbHi = a_base.m_model[i].p_dbHi;
+        a_table.m_model[i] = model;
+    }
+
+    a_table.build();
+    return true;
+}
+
+bool sysIdentifier::solveLinear(double a_A[SYSID_NUM_PARAM][SYSID_NUM_PARAM], double a_b[SYSID_NUM_PARAM])
+{
+    // Gaussian elimination with partial pivoting (solution returned in 'a_b')
+    const int n = SYSID_NUM_PARAM;
+    for (int c = 0; c < n; c++) {
+        int piv = c;
+        for (int r = c+1; r < n; r++) if (fabs(a_A[r][c]) > fabs(a_A[piv][c])) piv = r;
+        if (fabs(a_A[piv][c]) < 1e-12) return false;
+        if (piv != c) {
+            for (int k = 0; k < n; k++) { double t = a_A[c][k]; a_A[c][k] = a_A[piv][k]; a_A[piv][k] = t; }
+            double t = a_b[c]; a_b[c] = a_b[piv]; a_b[piv] = t;
+        }
+        for (int r = c+1; r < n; r++) {
+            double f = a_A[r][c]/a_A[c][c];
+            for (int k = c; k < n; k++) a_A[r][k] -= f*a_A[c][k];
+            a_b[r] -= f*a_b[c];
+        }
+    }
+    for (int r = n-1; r >= 0; r--) {
+        for (int k = r+1; k < n; k++) a_b[r] -= a_A[r][k]*a_b[k];
+        a_b[r] /= a_A[r][r];
+    }
+    return true;
+}
@@ -0,0 +1,48 @@
+#ifndef SYSID_H
+#define SYSID_H
+
+#include "ffwdtable.h"
+#include <string>
+#include <vector>
+
+#define SYSID_NUM_PARAM 4      // inertia, viscous, Coulomb (+/-)
+#define SYSID_MIN_VEL   0.01   // speed below which joint is treated as stationary (no Coulomb regressor) [rad/s]
+#define SYSID_RIDGE     1e-6   // ridge regularization, relative to mean diagonal of normal equations
+
+// one time step of a logged run (as recorded by 'MainWindow' in demo mode)
+typedef struct
+{
+    double d_time;                // [sec]
+    double d_th[FF_NUM_JNT];      // [rad]
+    double d_T[FF_NUM_JNT];       // commanded joint torque [N*m]
+} sysid_sample;
+
+// batched least-squares identification of per-joint inertia & friction
+// NOTE: only the normal equations are kept, so any number of runs can be added
+// NOTE: deadbands are not fit (a torque-sign regressor is nearly collinear with the
+// ----  Coulomb regressor in slow motion); those in use while logging are kept, so
+// ----  any remaining loss is absorbed by the Coulomb terms and counted only once
+class sysIdentifier
+{
+public:
+    bool m_rightHanded;                // handedness of exo during logged runs
+    long m_numSamples[FF_NUM_JNT];     // number of samples used, per joint
+    double m_rms[FF_NUM_JNT];          // RMS torque residual of fit [N*m]
+    double m_r2[FF_NUM_JNT];           // coefficient of determination of fit
+
+    sysIdentifier(bool a_rightHanded = true);
+
+    bool addRun(std::string a_filename);
+    void addBatch(const std::vector<sysid_sample> &a_run);
+    bool solve(ffwdTable &a_table, const ffwdTable &a_base);
+
+protected:
+    double m_AtA[FF_NUM_JNT][SYSID_NUM_PARAM][SYSID_NUM_PARAM];  // normal-equation matrix
+    double m_Atb[FF_NUM_JNT][SYSID_NUM_PARAM];                   // normal-equation right-hand side
+    double m_btb[FF_NUM_JNT];                                    // sum of squared torques
+    double m_sumb[FF_NUM_JNT];                                   // sum of torques
+
+    bool solveLinear(double a_A[SYSID_NUM_PARAM][SYSID_NUM_PARAM], double a_b[SYSID_NUM_PARAM]);
+};
+
+#endif // SYSID_H
@@ -0,0 +1,27 @@
+#---------------------------------------------#
+#                                             #
+#  Project file for offline system            #
+#  identification (feedforward tables)        #
+#                                             #
+#---------------------------------------------#
+
+QT      -= core gui
+CONFIG  += console c++11
+CONFIG  -= app_bundle qt
+TEMPLATE = app
+
+# specify targets for files created during compilation
+TARGET      = chARMsysid
+DESTDIR     = ./bin
+OBJECTS_DIR = ./obj_sysid
+
+# point to source and header files (no exo hardware, graphics, or GUI)
+SOURCES += $$PWD/sysid_main.cpp \
+           $$PWD/sysid.cpp \
+           $$PWD/ffwdtable.cpp
+
+HEADERS += $$PWD/sysid.h \
+           $$PWD/ffwdtable.h
+
+# channel map defaults only (no 826 library needed)
+INCLUDEPATH += $$PWD/external/s826_3.3.9/api
@@ -0,0 +1,76 @@
+#include "sysid.h"
+#include "motorcontrol.h"
+#include <cstdio>
+#include <cstring>
+
+// print command-line options
+static void usage(const char *a_prog)
+{
+    printf("usage: %s [options] run1.csv [run2.csv ...]\n", a_prog);
+    printf("  -o <file>   output feedforward table (default ffwd.txt, applied by exo when feedforward is enabled in the GUI)\n");
+    printf("  -b <file>   feedforward table in use while runs were logged (default = hand-tuned deadbands)\n");
+    printf("  --left      runs were logged with exo in left-handed configuration\n");
+}
+
+int main(int argc, char *argv[])
+{
+    std::string outFile = "ffwd.txt";
+    std::string baseFile = "";
+    bool rightHanded = true;
+    std::vector<std::string> runs;
+
+    // parse arguments
+    for (int i = 1; i < argc; i++) {
+        if      (!strcmp(argv[i],"-o") && i+1 < argc)  outFile = argv[++i];
+        else if (!strcmp(argv[i],"-b") && i+1 < argc)  baseFile = argv[++i];
+        else if (!strcmp(argv[i],"--left"))            rightHanded = false;
+        else if (argv[i][0] == '-') {
+            usage(argv[0]);
+            return 1;
+        }
+        else runs.push_back(argv[i]);
+    }
+    if (runs.empty()) {
+        usage(argv[0]);
+        return 1;
+    }
+
+    // deadbands in use during logging (kept in fitted table)
+    ffwdTable base;
+    if (baseFile.empty()) {
+        channel_map defaults;
+        for (int i = 0; i < FF_NUM_JNT; i++) {
+            base.m_model[i].p_dbLo = defaults.p_dbLo[i];
+            base.m_model[i].p_dbHi = defaults.p_dbHi[i];
+        }
+    } else if (!base.load(baseFile)) {
+        printf("could not read base table '%s'\n", baseFile.c_str());
+        return 1;
+    }
+
+    // accumulate runs one batch at a time
+    sysIdentifier sysid(rightHanded);
+    for (size_t i = 0; i < runs.size(); i++) {
+        if (!sysid.addRun(runs[i]))  printf("skipping '%s' (could not read, or no torque columns)\n", runs[i].c_str());
+    }
+
+    // fit & save
+    ffwdTable table;
+    if (!sysid.solve(table, base)) {
+        printf("not enough excitation to identify joint models\n");
+        return 1;
+    }
+    const char *names[FF_NUM_JNT] = {"shoulder", "elbow"};
+    for (int i = 0; i < FF_NUM_JNT; i++) {
+        const jnt_model &m = table.m_model[i];
+        printf("%-8s  n = %ld, rms = %.4f N*m, R^2 = %.3f\n", names[i], sysid.m_numSamples[i], sysid.m_rms[i], sysid.m_r2[i]);
+        printf("          I = %.4f kg*m^2, b = %.4f N*m*s/rad, Fc = +%.4f/-%.4f N*m, deadband = [%.3f, %.3f] V\n",
+               m.p_I, m.p_b, m.p_FcPos, m.p_FcNeg, m.p_dbLo, m.p_dbHi);
+    }
+    if (!table.save(outFile)) {
+        printf("could not open '%s' for writing\n", outFile.c_str());
+        return 1;
+    }
+    printf("feedforward table written to '%s'\n", outFile.c_str());
+    return 0;
+}